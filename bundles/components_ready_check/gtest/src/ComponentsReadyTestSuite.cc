@@ -95,3 +95,35 @@ TEST_F(ComponentsReadyTestSuite, ComponentsReadyWithInactiveComponentTest) {
             .build();
     EXPECT_EQ(0, count);
 }
+
+TEST_F(ComponentsReadyTestSuite, ComponentsReadyWhenInactiveComponentBecomesActiveTest) {
+    // Given a Celix framework
+    auto fw = celix::createFramework();
+    auto ctx = fw->getFrameworkBundleContext();
+
+    // When a test bundle with a not (yet) active-able component is installed
+    celix::installBundleSet(*fw, INACTIVE_CMP_TEST_BUNDLE_SET);
+
+    // And the components ready check bundle is installed
+    celix::installBundleSet(*fw, COMPONENTS_READY_CHECK_BUNDLE_SET);
+
+    // Then the "components.ready" condition is not available
+    auto count = ctx->useService<celix_condition>(CELIX_CONDITION_SERVICE_NAME)
+            .setFilter(componentsReadyFilter)
+            .setTimeout(std::chrono::milliseconds{USE_SERVICE_TIMEOUT_IN_MS})
+            .build();
+    EXPECT_EQ(0, count);
+
+    // When the required service of the inactive component is registered
+    celix_condition_t condition{};
+    auto reg = ctx->registerUnmanagedService<celix_condition>(&condition, CELIX_CONDITION_SERVICE_NAME)
+            .addProperty(CELIX_CONDITION_ID, "does-not-exists")
+            .build();
+
+    // Then the "components.ready" condition will become available, triggered by the last component transition
+    count = ctx->useService<celix_condition>(CELIX_CONDITION_SERVICE_NAME)
+            .setFilter(componentsReadyFilter)
+            .setTimeout(std::chrono::milliseconds{USE_SERVICE_TIMEOUT_IN_MS})
+            .build();
+    EXPECT_EQ(1, count);
+}
@@ -105,8 +105,8 @@ TEST_F(ComponentsReadyWithErrorInjectionTestSuite, ErrorSchedulingReadyCheckEven
     auto fw = celix::createFramework();
     auto ctx = fw->getFrameworkBundleContext();
 
-    // When an error injection for celix_bundleContext_scheduleEvent is primed when called from celix_componentReadyCheck_setFrameworkReadySvc
-    celix_ei_expect_celix_bundleContext_scheduleEvent((void*)celix_componentReadyCheck_setFrameworkReadySvc, 0, -1);
+    // When an error injection for celix_bundleContext_scheduleEvent is primed when called from celix_componentReadyCheck_scheduleCheck
+    celix_ei_expect_celix_bundleContext_scheduleEvent((void*)celix_componentReadyCheck_scheduleCheck, 0, -1);
 
     // And the components ready check is created
     auto* rdy = celix_componentsReadyCheck_create(ctx->getCBundleContext());
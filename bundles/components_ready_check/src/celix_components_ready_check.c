@@ -33,9 +33,12 @@ struct celix_components_ready_check {
     celix_condition_t conditionInstance;  /**< condition instance which can be used for multiple condition services.*/
     celix_thread_mutex_t mutex;           /**< mutex to protect the fields below. */
     long frameworkReadyTrackerId;         /**< tracker id for the framework ready condition service. */
-    long checkComponentsScheduledEventId; /**< event id of the scheduled event to check if the framework is ready. */
+    long allComponentsActiveListenerId;   /**< listener id for the dependency manager all components active listener. */
+    long checkComponentsScheduledEventId; /**< event id of the one-shot scheduled event to check if the components are
+                                            ready. */
     long componentsReadyConditionSvcId;   /**< service id of the condition service which is set when all components are
                                             ready. */
+    bool stopped;                         /**< whether the components ready check is being destroyed. */
 };
 
 celix_components_ready_check_t* celix_componentsReadyCheck_create(celix_bundle_context_t* ctx) {
@@ -44,6 +47,7 @@ celix_components_ready_check_t* celix_componentsReadyCheck_create(celix_bundle_c
     if (rdy) {
         rdy->ctx = ctx;
         rdy->frameworkReadyTrackerId = -1L;
+        rdy->allComponentsActiveListenerId = -1L;
         rdy->checkComponentsScheduledEventId = -1L;
         rdy->componentsReadyConditionSvcId = -1L;
 
@@ -88,6 +92,14 @@ void celix_componentsReadyCheck_destroy(celix_components_ready_check_t* rdy) {
     if (rdy) {
         celix_bundleContext_stopTracker(rdy->ctx, rdy->frameworkReadyTrackerId);
 
+        celixThreadMutex_lock(&rdy->mutex);
+        rdy->stopped = true;
+        long listenerId = rdy->allComponentsActiveListenerId;
+        rdy->allComponentsActiveListenerId = -1L;
+        celixThreadMutex_unlock(&rdy->mutex);
+        celix_dependencyManager_removeAllComponentsActiveListener(
+            celix_bundleContext_getDependencyManager(rdy->ctx), listenerId);
+
         celixThreadMutex_lock(&rdy->mutex);
         long schedId = rdy->checkComponentsScheduledEventId;
         rdy->checkComponentsScheduledEventId = -1L;
@@ -121,38 +133,70 @@ void celix_componentReadyCheck_registerCondition(celix_components_ready_check_t*
     }
 }
 
+static void celix_componentReadyCheck_check(void* data);
+
+void celix_componentReadyCheck_scheduleCheck(celix_components_ready_check_t* rdy) {
+    //precondition rdy->mutex is locked
+    if (rdy->stopped || rdy->checkComponentsScheduledEventId >= 0 || rdy->componentsReadyConditionSvcId >= 0) {
+        return;
+    }
+    //note a one-shot scheduled event is processed after the event queue is handled
+    celix_scheduled_event_options_t opts = CELIX_EMPTY_SCHEDULED_EVENT_OPTIONS;
+    opts.name = "celix_componentReady_check";
+    opts.callback = celix_componentReadyCheck_check;
+    opts.callbackData = rdy;
+    rdy->checkComponentsScheduledEventId = celix_bundleContext_scheduleEvent(rdy->ctx, &opts);
+    if (rdy->checkComponentsScheduledEventId < 0) {
+        celix_bundleContext_log(rdy->ctx,
+                                CELIX_LOG_LEVEL_ERROR,
+                                "Cannot schedule components ready check. Got event id %ld",
+                                rdy->checkComponentsScheduledEventId);
+    }
+}
+
 static void celix_componentReadyCheck_check(void* data) {
     celix_components_ready_check_t* rdy = data;
     celix_dependency_manager_t* mng = celix_bundleContext_getDependencyManager(rdy->ctx);
     celix_framework_t* fw = celix_bundleContext_getFramework(rdy->ctx);
-    bool ready = celix_dependencyManager_allComponentsActive(mng) && celix_framework_isEventQueueEmpty(fw);
-    if (ready) {
-        celixThreadMutex_lock(&rdy->mutex);
-        celix_bundleContext_removeScheduledEventAsync(rdy->ctx, rdy->checkComponentsScheduledEventId);
-        rdy->checkComponentsScheduledEventId = -1L;
-        celix_componentReadyCheck_registerCondition(rdy);
-        celixThreadMutex_unlock(&rdy->mutex);
+
+    celixThreadMutex_lock(&rdy->mutex);
+    rdy->checkComponentsScheduledEventId = -1L; //one-shot event is done
+    bool allActive = celix_dependencyManager_nrOfInactiveComponents(mng) == 0;
+    if (allActive && celix_framework_isEventQueueEmpty(fw)) {
+        if (rdy->componentsReadyConditionSvcId < 0 && !rdy->stopped) {
+            celix_componentReadyCheck_registerCondition(rdy);
+        }
+    } else if (allActive) {
+        //events pending, check again after the event queue is handled
+        celix_componentReadyCheck_scheduleCheck(rdy);
     }
+    //note if not all components are active, the all components active listener will schedule a new check
+    celixThreadMutex_unlock(&rdy->mutex);
+}
+
+static void celix_componentReadyCheck_allComponentsActive(void* data) {
+    celix_components_ready_check_t* rdy = data;
+    celixThreadMutex_lock(&rdy->mutex);
+    celix_componentReadyCheck_scheduleCheck(rdy);
+    celixThreadMutex_unlock(&rdy->mutex);
 }
 
 void celix_componentReadyCheck_setFrameworkReadySvc(void* handle, void* svc) {
     celix_components_ready_check_t* rdy = handle;
     celixThreadMutex_lock(&rdy->mutex);
-    if (svc && rdy->checkComponentsScheduledEventId < 0) {
-        // framework ready, now periodically check if all components are ready
-        celix_scheduled_event_options_t opts = CELIX_EMPTY_SCHEDULED_EVENT_OPTIONS;
-        opts.name = "celix_componentReady_check";
-        opts.callback = celix_componentReadyCheck_check;
-        opts.callbackData = rdy;
-        opts.initialDelayInSeconds = 0.1;
-        opts.intervalInSeconds = 0.1;
-        rdy->checkComponentsScheduledEventId = celix_bundleContext_scheduleEvent(rdy->ctx, &opts);
-        if (rdy->checkComponentsScheduledEventId < 0) {
+    if (svc && rdy->allComponentsActiveListenerId < 0 && !rdy->stopped) {
+        // framework ready, now check if all components are ready when the last inactive component becomes active
+        celix_dependency_manager_t* mng = celix_bundleContext_getDependencyManager(rdy->ctx);
+        rdy->allComponentsActiveListenerId = celix_dependencyManager_addAllComponentsActiveListener(
+            mng, rdy, celix_componentReadyCheck_allComponentsActive);
+        if (rdy->allComponentsActiveListenerId < 0) {
             celix_bundleContext_log(rdy->ctx,
                                     CELIX_LOG_LEVEL_ERROR,
-                                    "Cannot schedule components ready check. Got event id %ld",
-                                    rdy->checkComponentsScheduledEventId);
+                                    "Cannot add all components active listener. Got listener id %ld",
+                                    rdy->allComponentsActiveListenerId);
         }
+        // components can already be active
+        celix_componentReadyCheck_scheduleCheck(rdy);
     }
     celixThreadMutex_unlock(&rdy->mutex);
 }
@@ -51,6 +51,14 @@ void celix_componentReadyCheck_setFrameworkReadySvc(void* handle, void* svc);
  */
 void celix_componentReadyCheck_registerCondition(celix_components_ready_check_t* rdy);
 
+/**
+ * @brief Schedules a one-shot event to check if all components are ready, if no check is already scheduled and the
+ * components.ready condition is not yet registered.
+ * @note Should be called with the components ready check mutex locked.
+ * @note Part of the header for testing purposes.
+ */
+void celix_componentReadyCheck_scheduleCheck(celix_components_ready_check_t* rdy);
+
 #ifdef __cplusplus
 }
 #endif
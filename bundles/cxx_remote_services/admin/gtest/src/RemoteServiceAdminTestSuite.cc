@@ -19,6 +19,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+#include "RemoteServiceAdmin.h"
 #include "celix/FrameworkFactory.h"
 #include "celix/rsa/IExportServiceFactory.h"
 #include "celix/rsa/IExportedService.h"
@@ -373,4 +378,275 @@ TEST_F(RemoteServiceAdminTestSuite, importService) {
     count = ctx->useService<IDummyService>()
             .build();
     EXPECT_EQ(0, count);
-}
\ No newline at end of file
+}
+
+TEST_F(RemoteServiceAdminTestSuite, importManyEndpoints) {
+    auto bndId = ctx->installBundle(REMOTE_SERVICE_ADMIN_BUNDLE_LOCATION);
+    EXPECT_GE(bndId, 0);
+
+    /**
+     * When I register many endpoints, of which one with a mismatched config, before the import service factory is
+     * registered, all endpoints with a matching config will be imported (in a single batch) when the factory is added.
+     */
+    const int nrOfEndpoints = 100;
+    std::vector<std::shared_ptr<celix::ServiceRegistration>> endpointRegistrations{};
+    for (int i = 0; i < nrOfEndpoints; ++i) {
+        auto endpoint = std::make_shared<celix::rsa::EndpointDescription>(celix::Properties{
+            {celix::rsa::ENDPOINT_ID, "endpoint-id-" + std::to_string(i)},
+            {celix::SERVICE_NAME, celix::typeName<IDummyService>()},
+            {celix::rsa::SERVICE_IMPORTED_CONFIGS, "test,other"}});
+        endpointRegistrations.emplace_back(ctx->registerService<celix::rsa::EndpointDescription>(std::move(endpoint))
+            .build());
+    }
+    auto mismatchedEndpoint = std::make_shared<celix::rsa::EndpointDescription>(celix::Properties{
+        {celix::rsa::ENDPOINT_ID, "endpoint-id-mismatch"},
+        {celix::SERVICE_NAME, celix::typeName<IDummyService>()},
+        {celix::rsa::SERVICE_IMPORTED_CONFIGS, "other"}});
+    endpointRegistrations.emplace_back(ctx->registerService<celix::rsa::EndpointDescription>(std::move(mismatchedEndpoint))
+        .build());
+
+    auto count = ctx->useServices<IDummyService>()
+            .build();
+    EXPECT_EQ(0, count);
+
+    auto reg = ctx->registerService<celix::rsa::IImportServiceFactory>(std::make_shared<StubImportServiceFactory>(ctx))
+            .addProperty(celix::rsa::IImportServiceFactory::REMOTE_SERVICE_TYPE, celix::typeName<IDummyService>())
+            .build();
+    ctx->waitForEvents();
+
+    count = ctx->useServices<IDummyService>()
+            .build();
+    EXPECT_EQ(nrOfEndpoints, count);
+
+    /**
+     * When I remove the endpoints, the imported services will be removed.
+     */
+    endpointRegistrations.clear();
+    ctx->waitForEvents();
+
+    count = ctx->useServices<IDummyService>()
+            .build();
+    EXPECT_EQ(0, count);
+}
+
+
+/**
+ * The Hooked* factories call a hook during the creation of an import/export registration, so that the RemoteServiceAdmin
+ * can be tested with endpoints/services which are removed or re-added during the creation, or with a failing creation.
+ */
+
+class CountingRegistration : public celix::rsa::IImportRegistration, public celix::rsa::IExportRegistration {
+public:
+    explicit CountingRegistration(std::atomic<int>& _count) : count{_count} { ++count; }
+    ~CountingRegistration() noexcept override { --count; }
+private:
+    std::atomic<int>& count;
+};
+
+class HookedImportServiceFactory : public celix::rsa::IImportServiceFactory {
+public:
+    ~HookedImportServiceFactory() noexcept override = default;
+
+    [[nodiscard]] std::unique_ptr<celix::rsa::IImportRegistration> importService(const celix::rsa::EndpointDescription& endpoint) override {
+        int call = ++calls;
+        if (hook) {
+            hook(endpoint, call);
+        }
+        return std::make_unique<CountingRegistration>(liveRegistrations);
+    }
+
+    [[nodiscard]] const std::string &getRemoteServiceType() const override {
+        return serviceType;
+    }
+
+    [[nodiscard]] const std::vector<std::string> &getSupportedConfigs() const override {
+        return configs;
+    }
+
+    std::function<void(const celix::rsa::EndpointDescription&, int)> hook{};
+    std::atomic<int> calls{0};
+    std::atomic<int> liveRegistrations{0};
+private:
+    const std::string serviceType{celix::typeName<IDummyService>()};
+    const std::vector<std::string> configs{"test"};
+};
+
+class HookedExportServiceFactory : public celix::rsa::IExportServiceFactory {
+public:
+    ~HookedExportServiceFactory() noexcept override = default;
+
+    std::unique_ptr<celix::rsa::IExportRegistration> exportService(const celix::Properties& serviceProperties) override {
+        int call = ++calls;
+        if (hook) {
+            hook(serviceProperties, call);
+        }
+        return std::make_unique<CountingRegistration>(liveRegistrations);
+    }
+
+    [[nodiscard]] const std::string &getRemoteServiceType() const override {
+        return serviceType;
+    }
+
+    [[nodiscard]] const std::vector<std::string> &getSupportedIntents() const override {
+        return intents;
+    }
+
+    [[nodiscard]] const std::vector<std::string> &getSupportedConfigs() const override {
+        return configs;
+    }
+
+    std::function<void(const celix::Properties&, int)> hook{};
+    std::atomic<int> calls{0};
+    std::atomic<int> liveRegistrations{0};
+private:
+    const std::string serviceType = celix::typeName<IDummyService>();
+    const std::vector<std::string> configs = {"test"};
+    const std::vector<std::string> intents = {"osgi.basic"};
+};
+
+static std::shared_ptr<celix::rsa::EndpointDescription> createDummyEndpoint(const std::string& endpointId) {
+    return std::make_shared<celix::rsa::EndpointDescription>(celix::Properties{
+        {celix::rsa::ENDPOINT_ID, endpointId},
+        {celix::SERVICE_NAME, celix::typeName<IDummyService>()},
+        {celix::rsa::SERVICE_IMPORTED_CONFIGS, "test"}});
+}
+
+static std::shared_ptr<const celix::Properties> createFactoryProperties(const char* remoteServiceTypeKey) {
+    return std::make_shared<const celix::Properties>(celix::Properties{
+        {remoteServiceTypeKey, celix::typeName<IDummyService>()}});
+}
+
+TEST_F(RemoteServiceAdminTestSuite, endpointRemovedDuringImport) {
+    auto factory = std::make_shared<HookedImportServiceFactory>();
+    celix::rsa::RemoteServiceAdmin admin{celix::LogHelper{ctx, "RemoteServiceAdminTestSuite"}};
+    admin.addImportedServiceFactory(factory, createFactoryProperties(celix::rsa::IImportServiceFactory::REMOTE_SERVICE_TYPE));
+
+    /**
+     * When an endpoint is removed while its import service is being created, the created import service is discarded.
+     */
+    auto endpoint = createDummyEndpoint("endpoint-id-1");
+    factory->hook = [&admin, &endpoint](const celix::rsa::EndpointDescription& /*endpoint*/, int /*call*/) {
+        admin.removeEndpoint(endpoint);
+    };
+    admin.addEndpoint(endpoint);
+    EXPECT_EQ(1, factory->calls);
+    EXPECT_EQ(0, factory->liveRegistrations);
+
+    /**
+     * When the endpoint is added again, it is imported.
+     */
+    factory->hook = nullptr;
+    admin.addEndpoint(endpoint);
+    EXPECT_EQ(2, factory->calls);
+    EXPECT_EQ(1, factory->liveRegistrations);
+
+    admin.removeEndpoint(endpoint);
+    EXPECT_EQ(0, factory->liveRegistrations);
+}
+
+TEST_F(RemoteServiceAdminTestSuite, endpointReAddedDuringImport) {
+    auto factory = std::make_shared<HookedImportServiceFactory>();
+    celix::rsa::RemoteServiceAdmin admin{celix::LogHelper{ctx, "RemoteServiceAdminTestSuite"}};
+    admin.addImportedServiceFactory(factory, createFactoryProperties(celix::rsa::IImportServiceFactory::REMOTE_SERVICE_TYPE));
+
+    /**
+     * When an updated endpoint with the same id is added while the import service of the endpoint is being created,
+     * only the import service of the updated endpoint is kept.
+     */
+    auto endpoint = createDummyEndpoint("endpoint-id-1");
+    auto updatedEndpoint = createDummyEndpoint("endpoint-id-1");
+    const celix::rsa::EndpointDescription* importedEndpoint = nullptr;
+    factory->hook = [&](const celix::rsa::EndpointDescription& ep, int call) {
+        importedEndpoint = &ep;
+        if (call == 1) {
+            admin.addEndpoint(updatedEndpoint);
+        }
+    };
+    admin.addEndpoint(endpoint);
+    EXPECT_EQ(2, factory->calls);
+    EXPECT_EQ(updatedEndpoint.get(), importedEndpoint);
+    EXPECT_EQ(1, factory->liveRegistrations);
+
+    /**
+     * When the updated endpoint is removed, the kept import service is removed.
+     */
+    admin.removeEndpoint(updatedEndpoint);
+    EXPECT_EQ(0, factory->liveRegistrations);
+}
+
+TEST_F(RemoteServiceAdminTestSuite, failedImportIsRetried) {
+    auto factory = std::make_shared<HookedImportServiceFactory>();
+    celix::rsa::RemoteServiceAdmin admin{celix::LogHelper{ctx, "RemoteServiceAdminTestSuite"}};
+    admin.addImportedServiceFactory(factory, createFactoryProperties(celix::rsa::IImportServiceFactory::REMOTE_SERVICE_TYPE));
+
+    /**
+     * When the import service factory throws, the endpoint is not imported, but stays to be imported.
+     */
+    factory->hook = [](const celix::rsa::EndpointDescription& /*endpoint*/, int call) {
+        if (call == 1) {
+            throw std::runtime_error{"import failed"};
+        }
+    };
+    auto endpoint1 = createDummyEndpoint("endpoint-id-1");
+    admin.addEndpoint(endpoint1);
+    EXPECT_EQ(1, factory->calls);
+    EXPECT_EQ(0, factory->liveRegistrations);
+
+    /**
+     * When another endpoint for the same interface is added, the import of the failed endpoint is retried.
+     */
+    auto endpoint2 = createDummyEndpoint("endpoint-id-2");
+    admin.addEndpoint(endpoint2);
+    EXPECT_EQ(3, factory->calls);
+    EXPECT_EQ(2, factory->liveRegistrations);
+
+    admin.removeEndpoint(endpoint1);
+    EXPECT_EQ(1, factory->liveRegistrations);
+    admin.removeEndpoint(endpoint2);
+    EXPECT_EQ(0, factory->liveRegistrations);
+}
+
+TEST_F(RemoteServiceAdminTestSuite, serviceRemovedDuringExport) {
+    auto factory = std::make_shared<HookedExportServiceFactory>();
+    celix::rsa::RemoteServiceAdmin admin{celix::LogHelper{ctx, "RemoteServiceAdminTestSuite"}};
+    admin.addExportedServiceFactory(factory, createFactoryProperties(celix::rsa::IExportServiceFactory::REMOTE_SERVICE_TYPE));
+
+    /**
+     * When a service is removed while its export service is being created, the created export service is discarded.
+     */
+    auto svc = std::make_shared<DummyServiceImpl>();
+    auto props = std::make_shared<const celix::Properties>(celix::Properties{
+        {celix::SERVICE_NAME, celix::typeName<IDummyService>()},
+        {celix::SERVICE_ID, "42"},
+        {celix::rsa::SERVICE_EXPORTED_INTERFACES, "*"}});
+    factory->hook = [&admin, &svc, &props](const celix::Properties& /*serviceProperties*/, int /*call*/) {
+        admin.removeService(svc, props);
+    };
+    admin.addService(svc, props);
+    EXPECT_EQ(1, factory->calls);
+    EXPECT_EQ(0, factory->liveRegistrations);
+
+    /**
+     * When the export service factory throws, the service stays to be exported and the export is retried when another
+     * service with the same service name is added.
+     */
+    factory->hook = [](const celix::Properties& /*serviceProperties*/, int call) {
+        if (call == 2) {
+            throw std::runtime_error{"export failed"};
+        }
+    };
+    admin.addService(svc, props);
+    EXPECT_EQ(2, factory->calls);
+    EXPECT_EQ(0, factory->liveRegistrations);
+    auto props2 = std::make_shared<const celix::Properties>(celix::Properties{
+        {celix::SERVICE_NAME, celix::typeName<IDummyService>()},
+        {celix::SERVICE_ID, "43"},
+        {celix::rsa::SERVICE_EXPORTED_INTERFACES, "*"}});
+    admin.addService(svc, props2);
+    EXPECT_EQ(4, factory->calls);
+    EXPECT_EQ(2, factory->liveRegistrations);
+
+    admin.removeService(svc, props);
+    admin.removeService(svc, props2);
+    EXPECT_EQ(0, factory->liveRegistrations);
+}
@@ -19,6 +19,8 @@
 
 #include "RemoteServiceAdmin.h"
 
+#include <algorithm>
+
 #include "celix/BundleContext.h"
 #include "celix/rsa/RemoteConstants.h"
 
@@ -33,6 +35,38 @@
 #define L_ERROR(...) \
         logHelper.error(__VA_ARGS__);
 
+void celix::rsa::FeatureBits::set(std::size_t bit) {
+    auto index = bit / 64;
+    if (index >= words.size()) {
+        words.resize(index + 1, 0);
+    }
+    words[index] |= uint64_t{1} << (bit % 64);
+}
+
+bool celix::rsa::FeatureBits::empty() const {
+    return std::all_of(words.begin(), words.end(), [](uint64_t word) { return word == 0; });
+}
+
+bool celix::rsa::FeatureBits::isSubsetOf(const FeatureBits& other) const {
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        auto otherWord = i < other.words.size() ? other.words[i] : 0;
+        if ((words[i] & ~otherWord) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool celix::rsa::FeatureBits::intersects(const FeatureBits& other) const {
+    auto size = std::min(words.size(), other.words.size());
+    for (std::size_t i = 0; i < size; ++i) {
+        if ((words[i] & other.words[i]) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 celix::rsa::RemoteServiceAdmin::RemoteServiceAdmin(celix::LogHelper logHelper) : logHelper{std::move(logHelper)} {}
 
 void celix::rsa::RemoteServiceAdmin::addEndpoint(const std::shared_ptr<celix::rsa::EndpointDescription>& endpoint) {
@@ -50,9 +84,11 @@ void celix::rsa::RemoteServiceAdmin::addEndpoint(const std::shared_ptr<celix::rs
         return;
     }
 
-    std::lock_guard l(mutex);
-    toBeImportedServices.emplace_back(endpoint);
-    createImportServices();
+    {
+        std::lock_guard l(mutex);
+        toBeImportedServices[interface].emplace_back(ToBeImportedService{endpoint, toFeatureBits(endpoint->getConfigurationTypes())});
+    }
+    createImportServices(interface);
 }
 
 void celix::rsa::RemoteServiceAdmin::removeEndpoint(const std::shared_ptr<celix::rsa::EndpointDescription>& endpoint) {
@@ -68,9 +104,19 @@ void celix::rsa::RemoteServiceAdmin::removeEndpoint(const std::shared_ptr<celix:
     {
         std::lock_guard l(mutex);
 
-        toBeImportedServices.erase(std::remove_if(toBeImportedServices.begin(), toBeImportedServices.end(), [&id](auto const &endpoint){
-            return id == endpoint->getId();
-        }), toBeImportedServices.end());
+        auto toBeImportedIt = toBeImportedServices.find(endpoint->getInterface());
+        if (toBeImportedIt != toBeImportedServices.end()) {
+            auto& toBeImported = toBeImportedIt->second;
+            toBeImported.erase(std::remove_if(toBeImported.begin(), toBeImported.end(), [&id](auto const &entry){
+                return id == entry.endpoint->getId();
+            }), toBeImported.end());
+            if (toBeImported.empty()) {
+                toBeImportedServices.erase(toBeImportedIt);
+            }
+        }
+
+        //note if the import service is being created, it will be discarded when the creation is done
+        importsInProgress.erase(id);
 
         auto it = importedServices.find(id);
         if (it != importedServices.end()) {
@@ -90,16 +136,18 @@ void celix::rsa::RemoteServiceAdmin::addImportedServiceFactory(
     }
 
 
-    std::lock_guard l(mutex);
-    auto existingFactory = importServiceFactories.find(targetServiceName);
-    if (existingFactory != end(importServiceFactories)) {
-        L_WARN("Adding imported factory but factory already exists");
-        return;
-    }
+    {
+        std::lock_guard l(mutex);
+        auto existingFactory = importServiceFactories.find(targetServiceName);
+        if (existingFactory != end(importServiceFactories)) {
+            L_WARN("Adding imported factory but factory already exists");
+            return;
+        }
 
-    importServiceFactories.emplace(targetServiceName, factory);
+        importServiceFactories.emplace(targetServiceName, ImportServiceFactoryEntry{factory, toFeatureBits(factory->getSupportedConfigs())});
+    }
 
-    createImportServices();
+    createImportServices(targetServiceName);
 }
 
 void celix::rsa::RemoteServiceAdmin::removeImportedServiceFactory(
@@ -127,9 +175,13 @@ void celix::rsa::RemoteServiceAdmin::addExportedServiceFactory(
         return;
     }
 
-    std::lock_guard<std::mutex> lock{mutex};
-    exportServiceFactories.emplace(targetServiceName, factory);
-    createExportServices();
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        exportServiceFactories.emplace(targetServiceName, ExportServiceFactoryEntry{factory,
+                                                                                    toFeatureBits(factory->getSupportedConfigs()),
+                                                                                    toFeatureBits(factory->getSupportedIntents())});
+    }
+    createExportServices(targetServiceName);
 }
 
 void celix::rsa::RemoteServiceAdmin::removeExportedServiceFactory(
@@ -154,9 +206,13 @@ void celix::rsa::RemoteServiceAdmin::addService(const std::shared_ptr<void>& /*s
         return;
     }
 
-    std::lock_guard<std::mutex> lock{mutex};
-    toBeExportedServices.emplace_back(props);
-    createExportServices();
+    auto providedConfigs = celix::split(props->get(celix::rsa::SERVICE_IMPORTED_CONFIGS));
+    auto providedIntents = celix::split(props->get(celix::rsa::SERVICE_EXPORTED_INTENTS, "osgi.basic"));
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        toBeExportedServices[serviceName].emplace_back(ToBeExportedService{props, toFeatureBits(providedConfigs), toFeatureBits(providedIntents)});
+    }
+    createExportServices(serviceName);
 }
 
 void celix::rsa::RemoteServiceAdmin::removeService(const std::shared_ptr<void>& /*svc*/, const std::shared_ptr<const celix::Properties>& props) {
@@ -166,125 +222,211 @@ void celix::rsa::RemoteServiceAdmin::removeService(const std::shared_ptr<void>&
         return;
     }
 
-    std::lock_guard l(mutex);
+    std::unique_ptr<celix::rsa::IExportRegistration> tmpStore{}; //to ensure destruction outside of lock
+    {
+        std::lock_guard l(mutex);
 
-    auto instanceIt = exportedServices.find(svcId);
-    if (instanceIt != end(exportedServices)) {
-        exportedServices.erase(instanceIt);
-    }
+        auto instanceIt = exportedServices.find(svcId);
+        if (instanceIt != end(exportedServices)) {
+            tmpStore = std::move(instanceIt->second);
+            exportedServices.erase(instanceIt);
+        }
+
+        //note if the export service is being created, it will be discarded when the creation is done
+        exportsInProgress.erase(svcId);
 
-    //remove to be exported endpoint (if present)
-    for (auto it = toBeExportedServices.begin(); it != toBeExportedServices.end(); ++it) {
-        if ((*it)->getAsLong(celix::SERVICE_ID, -1) == svcId) {
-            toBeExportedServices.erase(it);
-            break;
+        //remove to be exported endpoint (if present)
+        auto toBeExportedIt = toBeExportedServices.find(props->get(celix::SERVICE_NAME, ""));
+        if (toBeExportedIt != toBeExportedServices.end()) {
+            auto& toBeExported = toBeExportedIt->second;
+            for (auto it = toBeExported.begin(); it != toBeExported.end(); ++it) {
+                if (it->properties->getAsLong(celix::SERVICE_ID, -1) == svcId) {
+                    toBeExported.erase(it);
+                    break;
+                }
+            }
+            if (toBeExported.empty()) {
+                toBeExportedServices.erase(toBeExportedIt);
+            }
         }
     }
 }
 
-bool celix::rsa::RemoteServiceAdmin::isEndpointMatch(const celix::rsa::EndpointDescription& endpoint, const celix::rsa::IImportServiceFactory& factory) const {
-    if (factory.getSupportedConfigs().empty()) {
+celix::rsa::FeatureBits celix::rsa::RemoteServiceAdmin::toFeatureBits(const std::vector<std::string>& features) {
+    //precondition mutex taken
+    FeatureBits bits{};
+    for (const auto& feature : features) {
+        auto it = featureBitIndices.try_emplace(feature, featureBitIndices.size()).first;
+        bits.set(it->second);
+    }
+    return bits;
+}
+
+bool celix::rsa::RemoteServiceAdmin::isEndpointMatch(const ToBeImportedService& endpoint, const ImportServiceFactoryEntry& factory) const {
+    if (factory.configs.empty()) {
         L_WARN("Matching endpoint with a import service factory with no supported configs, this will always fail");
         return false;
     }
-    if (endpoint.getConfigurationTypes().empty()) {
+    if (endpoint.configs.empty()) {
         L_WARN("Matching endpoint with empty configuration types (%s), this will always fail", celix::rsa::SERVICE_IMPORTED_CONFIGS);
         return false;
     }
-    size_t matchCount = 0;
-    for (const auto& config : endpoint.getConfigurationTypes()) {
-        for (const auto& factoryConfig : factory.getSupportedConfigs()) {
-            if (config == factoryConfig) {
-                ++matchCount;
-                break;
-            }
-        }
-    }
-    return matchCount == factory.getSupportedConfigs().size(); //note must match all requested configurations
+    return factory.configs.isSubsetOf(endpoint.configs); //note must match all requested configurations
 }
 
-bool celix::rsa::RemoteServiceAdmin::isExportServiceMatch(const celix::Properties& svcProperties, const celix::rsa::IExportServiceFactory& factory) const {
-    auto providedConfigs = celix::split(svcProperties.get(celix::rsa::SERVICE_IMPORTED_CONFIGS));
-    auto providedIntents = celix::split(svcProperties.get(celix::rsa::SERVICE_EXPORTED_INTENTS, "osgi.basic"));
-    if (providedConfigs.empty() && providedIntents.empty()) {
+bool celix::rsa::RemoteServiceAdmin::isExportServiceMatch(const ToBeExportedService& service, const ExportServiceFactoryEntry& factory) const {
+    if (service.configs.empty() && service.intents.empty()) {
         //note cannot match export service with no config or intent
         return false;
     }
-    if (factory.getSupportedIntents().empty() && factory.getSupportedConfigs().empty()) {
+    if (factory.intents.empty() && factory.configs.empty()) {
         L_WARN("Matching service marked for export with a export service factory with no supported intents or configs, this will always fail");
         return false;
     }
-    if (!providedConfigs.empty()) {
-        size_t matchCount = 0;
-        for (const auto& config : providedConfigs) {
-            for (const auto& factoryConfig : factory.getSupportedConfigs()) {
-                if (config == factoryConfig) {
-                    ++matchCount;
-                    break;
-                }
-            }
-        }
-        return matchCount == factory.getSupportedConfigs().size(); //note must match all requested configurations
+    if (!service.configs.empty()) {
+        return factory.configs.isSubsetOf(service.configs); //note must match all requested configurations
     } else /*match on intent*/ {
-        for (const auto& intent: providedIntents) {
-            for (const auto& factoryIntent: factory.getSupportedIntents()) {
-                if (intent == factoryIntent) {
-                    return true;
-                }
-            }
-        }
-        return false;
+        return service.intents.intersects(factory.intents);
     }
 }
 
-void celix::rsa::RemoteServiceAdmin::createImportServices() {
-    //precondition mutex taken
-    auto it = toBeImportedServices.begin();
-    while (it != toBeImportedServices.end()) {
-        auto interface = (*it)->getInterface();
-        bool match = false;
-        for (auto factoryIt = importServiceFactories.lower_bound(interface); factoryIt != importServiceFactories.end() && factoryIt->first == interface; ++factoryIt) {
-            if (isEndpointMatch(**it, *factoryIt->second)) {
-                match = true;
-                auto endpointId = (*it)->getId();
-                L_DEBUG("Adding endpoint %s, created export service for %s", endpointId.c_str(), (*it)->getInterface().c_str());
-                importedServices.emplace(endpointId, factoryIt->second->importService(**it));
-                break;
+void celix::rsa::RemoteServiceAdmin::createImportServices(const std::string& interface) {
+    //precondition mutex not taken
+    std::vector<std::pair<ToBeImportedService, std::shared_ptr<celix::rsa::IImportServiceFactory>>> batch{};
+    {
+        std::lock_guard l(mutex);
+        auto toBeImportedIt = toBeImportedServices.find(interface);
+        if (toBeImportedIt == toBeImportedServices.end()) {
+            return;
+        }
+        auto factories = importServiceFactories.equal_range(interface);
+        std::vector<ToBeImportedService> remaining{};
+        for (auto& toBeImported : toBeImportedIt->second) {
+            auto factoryIt = std::find_if(factories.first, factories.second, [&](const auto& entry) {
+                return isEndpointMatch(toBeImported, entry.second);
+            });
+            if (factoryIt != factories.second) {
+                importsInProgress[toBeImported.endpoint->getId()] = toBeImported.endpoint;
+                batch.emplace_back(std::move(toBeImported), factoryIt->second.factory);
             } else {
-                L_TRACE("Config mismatch.");
+                L_DEBUG("Adding endpoint to be imported but no matching factory available yet, delaying import");
+                remaining.emplace_back(std::move(toBeImported));
             }
         }
-        if (match) {
-            it = toBeImportedServices.erase(it);
+        if (remaining.empty()) {
+            toBeImportedServices.erase(toBeImportedIt);
         } else {
-            L_DEBUG("Adding endpoint to be imported but no matching factory available yet, delaying import");
-            ++it;
+            toBeImportedIt->second = std::move(remaining);
+        }
+    }
+
+    if (batch.empty()) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<celix::rsa::IImportRegistration>> registrations(batch.size());
+    std::vector<bool> failed(batch.size(), false);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        auto& [toBeImported, factory] = batch[i];
+        L_DEBUG("Adding endpoint %s, created import service for %s", toBeImported.endpoint->getId().c_str(), interface.c_str());
+        try {
+            registrations[i] = factory->importService(*toBeImported.endpoint);
+        } catch (const std::exception& e) {
+            L_ERROR("Failed to import endpoint %s: %s", toBeImported.endpoint->getId().c_str(), e.what());
+            failed[i] = true;
+        }
+    }
+
+    std::vector<std::unique_ptr<celix::rsa::IImportRegistration>> discarded{}; //to ensure destruction outside of lock
+    {
+        std::lock_guard l(mutex);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            auto& toBeImported = batch[i].first;
+            const auto& endpointId = toBeImported.endpoint->getId();
+            auto inProgressIt = importsInProgress.find(endpointId);
+            if (inProgressIt == importsInProgress.end() || inProgressIt->second != toBeImported.endpoint) {
+                //endpoint removed (or replaced) during the creation of the import service
+                discarded.emplace_back(std::move(registrations[i]));
+                continue;
+            }
+            importsInProgress.erase(inProgressIt);
+            if (failed[i]) {
+                //import failed, the endpoint stays to be imported
+                L_WARN("Import of endpoint %s delayed, the import is retried when an endpoint or import service factory for %s is added", endpointId.c_str(), interface.c_str());
+                toBeImportedServices[interface].emplace_back(std::move(toBeImported));
+            } else if (!importedServices.try_emplace(endpointId, std::move(registrations[i])).second) {
+                discarded.emplace_back(std::move(registrations[i]));
+            }
         }
     }
 }
 
-void celix::rsa::RemoteServiceAdmin::createExportServices() {
-    //precondition mutex taken
-    auto it = toBeExportedServices.begin();
-    while (it != toBeExportedServices.end()) {
-        const auto& svcProperties = **it;
-        auto serviceName = svcProperties.get(celix::SERVICE_NAME, "");
-        auto svcId = svcProperties.getAsLong(celix::SERVICE_ID, -1);
-        bool match = false;
-        for (auto factoryIt = exportServiceFactories.lower_bound(serviceName); factoryIt != exportServiceFactories.end() && factoryIt->first == serviceName; ++factoryIt) {
-            if (isExportServiceMatch(svcProperties, *factoryIt->second)) {
-                match = true;
-                exportedServices.emplace(svcId, factoryIt->second->exportService(svcProperties));
-                break;
+void celix::rsa::RemoteServiceAdmin::createExportServices(const std::string& serviceName) {
+    //precondition mutex not taken
+    std::vector<std::pair<ToBeExportedService, std::shared_ptr<celix::rsa::IExportServiceFactory>>> batch{};
+    {
+        std::lock_guard l(mutex);
+        auto toBeExportedIt = toBeExportedServices.find(serviceName);
+        if (toBeExportedIt == toBeExportedServices.end()) {
+            return;
+        }
+        auto factories = exportServiceFactories.equal_range(serviceName);
+        std::vector<ToBeExportedService> remaining{};
+        for (auto& toBeExported : toBeExportedIt->second) {
+            auto factoryIt = std::find_if(factories.first, factories.second, [&](const auto& entry) {
+                return isExportServiceMatch(toBeExported, entry.second);
+            });
+            if (factoryIt != factories.second) {
+                exportsInProgress[toBeExported.properties->getAsLong(celix::SERVICE_ID, -1)] = toBeExported.properties;
+                batch.emplace_back(std::move(toBeExported), factoryIt->second.factory);
             } else {
-                L_TRACE("Intent mismatch");
+                L_DEBUG("Adding endpoint to be imported but no matching factory available yet, delaying import");
+                remaining.emplace_back(std::move(toBeExported));
             }
         }
-        if (match) {
-            it = toBeExportedServices.erase(it);
+        if (remaining.empty()) {
+            toBeExportedServices.erase(toBeExportedIt);
         } else {
-            L_DEBUG("Adding endpoint to be imported but no matching factory available yet, delaying import");
-            ++it;
+            toBeExportedIt->second = std::move(remaining);
         }
     }
-}
\ No newline at end of file
+
+    if (batch.empty()) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<celix::rsa::IExportRegistration>> registrations(batch.size());
+    std::vector<bool> failed(batch.size(), false);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        auto& [toBeExported, factory] = batch[i];
+        try {
+            registrations[i] = factory->exportService(*toBeExported.properties);
+        } catch (const std::exception& e) {
+            L_ERROR("Failed to export service %li: %s", toBeExported.properties->getAsLong(celix::SERVICE_ID, -1), e.what());
+            failed[i] = true;
+        }
+    }
+
+    std::vector<std::unique_ptr<celix::rsa::IExportRegistration>> discarded{}; //to ensure destruction outside of lock
+    {
+        std::lock_guard l(mutex);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            auto& toBeExported = batch[i].first;
+            auto svcId = toBeExported.properties->getAsLong(celix::SERVICE_ID, -1);
+            auto inProgressIt = exportsInProgress.find(svcId);
+            if (inProgressIt == exportsInProgress.end() || inProgressIt->second != toBeExported.properties) {
+                //service removed during the creation of the export service
+                discarded.emplace_back(std::move(registrations[i]));
+                continue;
+            }
+            exportsInProgress.erase(inProgressIt);
+            if (failed[i]) {
+                //export failed, the service stays to be exported
+                L_WARN("Export of service %li delayed, the export is retried when a service or export service factory for %s is added", svcId, serviceName.c_str());
+                toBeExportedServices[serviceName].emplace_back(std::move(toBeExported));
+            } else if (!exportedServices.try_emplace(svcId, std::move(registrations[i])).second) {
+                discarded.emplace_back(std::move(registrations[i]));
+            }
+        }
+    }
+}
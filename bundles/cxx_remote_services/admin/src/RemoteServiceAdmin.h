@@ -17,7 +17,10 @@
  * under the License.
  */
 
+#include <cstdint>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "celix/LogHelper.h"
 #include "celix/rsa/EndpointDescription.h"
@@ -34,6 +37,32 @@
 
 namespace celix::rsa {
 
+    /**
+     * @brief A set of configuration types and/or intents.
+     *
+     * Every configuration type and intent is assigned a bit index by the RemoteServiceAdmin, so that checking whether
+     * a factory supports the configs/intents of an endpoint or service is a few word operations instead of nested
+     * loops of string comparisons.
+     */
+    class FeatureBits {
+    public:
+        void set(std::size_t bit);
+
+        [[nodiscard]] bool empty() const;
+
+        /**
+         * @brief Whether all bits of this set are also set in the other set.
+         */
+        [[nodiscard]] bool isSubsetOf(const FeatureBits& other) const;
+
+        /**
+         * @brief Whether at least one bit of this set is also set in the other set.
+         */
+        [[nodiscard]] bool intersects(const FeatureBits& other) const;
+    private:
+        std::vector<uint64_t> words{};
+    };
+
     /**
      * @brief Remote Service Admin based on endpoint/proxy factories.
      *
@@ -63,10 +92,47 @@ namespace celix::rsa {
         void addService(const std::shared_ptr<void>& svc, const std::shared_ptr<const celix::Properties>& properties);
         void removeService(const std::shared_ptr<void>& svc, const std::shared_ptr<const celix::Properties>& properties);
     private:
-        void createExportServices();
-        void createImportServices();
-        bool isEndpointMatch(const celix::rsa::EndpointDescription& endpoint, const celix::rsa::IImportServiceFactory& factory) const;
-        bool isExportServiceMatch(const celix::Properties& svcProperties, const celix::rsa::IExportServiceFactory& factory) const;
+        struct ImportServiceFactoryEntry {
+            std::shared_ptr<celix::rsa::IImportServiceFactory> factory;
+            FeatureBits configs;
+        };
+
+        struct ExportServiceFactoryEntry {
+            std::shared_ptr<celix::rsa::IExportServiceFactory> factory;
+            FeatureBits configs;
+            FeatureBits intents;
+        };
+
+        struct ToBeImportedService {
+            std::shared_ptr<celix::rsa::EndpointDescription> endpoint;
+            FeatureBits configs;
+        };
+
+        struct ToBeExportedService {
+            std::shared_ptr<const celix::Properties> properties;
+            FeatureBits configs;
+            FeatureBits intents;
+        };
+
+        /**
+         * @brief Creates the import services for the to be imported endpoints with the provided interface.
+         *
+         * The matching is done under the mutex, but the import services are created in a batch outside the mutex.
+         * Precondition: mutex not taken.
+         */
+        void createImportServices(const std::string& interface);
+
+        /**
+         * @brief Creates the export services for the to be exported services with the provided service name.
+         *
+         * The matching is done under the mutex, but the export services are created in a batch outside the mutex.
+         * Precondition: mutex not taken.
+         */
+        void createExportServices(const std::string& serviceName);
+
+        FeatureBits toFeatureBits(const std::vector<std::string>& features);
+        bool isEndpointMatch(const ToBeImportedService& endpoint, const ImportServiceFactoryEntry& factory) const;
+        bool isExportServiceMatch(const ToBeExportedService& service, const ExportServiceFactoryEntry& factory) const;
 
         celix::LogHelper logHelper;
         std::mutex mutex{}; // protects below
@@ -74,17 +140,20 @@ namespace celix::rsa {
 #if __cpp_lib_memory_resource
         std::pmr::unsynchronized_pool_resource memResource{};
 
-        std::pmr::multimap<std::string, std::shared_ptr<celix::rsa::IExportServiceFactory>> exportServiceFactories{&memResource}; //key = service name
-        std::pmr::multimap<std::string, std::shared_ptr<celix::rsa::IImportServiceFactory>> importServiceFactories{&memResource}; //key = service name
+        std::pmr::multimap<std::string, ExportServiceFactoryEntry> exportServiceFactories{&memResource}; //key = service name
+        std::pmr::multimap<std::string, ImportServiceFactoryEntry> importServiceFactories{&memResource}; //key = service name
         std::pmr::unordered_map<std::string, std::unique_ptr<celix::rsa::IImportRegistration>> importedServices{&memResource}; //key = endpoint id
         std::pmr::unordered_map<long, std::unique_ptr<celix::rsa::IExportRegistration>> exportedServices{&memResource}; //key = service id
 #else
-        std::multimap<std::string, std::shared_ptr<celix::rsa::IExportServiceFactory>> exportServiceFactories{}; //key = service name
-        std::multimap<std::string, std::shared_ptr<celix::rsa::IImportServiceFactory>> importServiceFactories{}; //key = service name
+        std::multimap<std::string, ExportServiceFactoryEntry> exportServiceFactories{}; //key = service name
+        std::multimap<std::string, ImportServiceFactoryEntry> importServiceFactories{}; //key = service name
         std::unordered_map<std::string, std::unique_ptr<celix::rsa::IImportRegistration>> importedServices{}; //key = endpoint id
         std::unordered_map<long, std::unique_ptr<celix::rsa::IExportRegistration>> exportedServices{}; //key = service id
 #endif
-        std::vector<std::shared_ptr<celix::rsa::EndpointDescription>> toBeImportedServices{};
-        std::vector<std::shared_ptr<const celix::Properties>> toBeExportedServices{};
+        std::unordered_map<std::string, std::vector<ToBeImportedService>> toBeImportedServices{}; //key = interface
+        std::unordered_map<std::string, std::vector<ToBeExportedService>> toBeExportedServices{}; //key = service name
+        std::unordered_map<std::string, std::shared_ptr<celix::rsa::EndpointDescription>> importsInProgress{}; //key = endpoint id, import services being created outside the mutex
+        std::unordered_map<long, std::shared_ptr<const celix::Properties>> exportsInProgress{}; //key = service id, export services being created outside the mutex
+        std::unordered_map<std::string, std::size_t> featureBitIndices{}; //key = config type or intent, value = bit index
     };
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "http_admin/api.h"
+#include "http_router.h"
+extern "C" {
+#include "service_tree.h"
+}
+
+class HttpRouterBenchmark {
+public:
+    explicit HttpRouterBenchmark(int64_t nrOfServices) : services(static_cast<size_t>(nrOfServices)) {
+        uriMap = celix_stringHashMap_create();
+        for (int64_t i = 0; i < nrOfServices; ++i) {
+            //note spread the URIs over a few levels: /api/<group>/device<i>
+            auto uri = std::string{"/api/group"} + std::to_string(i % 16) + "/device" + std::to_string(i);
+            celix_stringHashMap_put(uriMap, uri.c_str(), &services[i]);
+            addServiceNode(&tree, uri.c_str(), &services[i]);
+            if (i == nrOfServices / 2) {
+                midUri = uri;
+                midSvc = &services[i];
+            }
+        }
+        celix_stringHashMap_put(uriMap, "/api/wildcard/*/status", &wildcardSvc);
+        router = httpRouter_create(uriMap);
+        httpRouter_initPublisher(&publisher);
+        httpRouter_publish(&publisher, httpRouter_create(uriMap));
+    }
+
+    ~HttpRouterBenchmark() {
+        httpRouter_deinitPublisher(&publisher);
+        httpRouter_destroy(router);
+        destroyServiceTree(&tree);
+        celix_stringHashMap_destroy(uriMap);
+    }
+
+    HttpRouterBenchmark(HttpRouterBenchmark&&) = delete;
+    HttpRouterBenchmark& operator=(HttpRouterBenchmark&&) = delete;
+    HttpRouterBenchmark(const HttpRouterBenchmark&) = delete;
+    HttpRouterBenchmark& operator=(const HttpRouterBenchmark&) = delete;
+
+    std::vector<celix_http_service_t> services;
+    celix_http_service_t wildcardSvc{};
+    celix_string_hash_map_t* uriMap{nullptr};
+    service_tree_t tree{};
+    http_router_t* router{nullptr};
+    http_router_publisher_t publisher{};
+    std::string midUri{};
+    celix_http_service_t* midSvc{nullptr};
+};
+
+static void HttpRouterBenchmark_findExactInServiceTree(benchmark::State& state) {
+    HttpRouterBenchmark benchmark{state.range(0)};
+    for (auto _ : state) {
+        service_tree_node_t* node = findServiceNodeInTree(&benchmark.tree, benchmark.midUri.c_str());
+        if (node == nullptr || node->svc_data->service != benchmark.midSvc) {
+            std::cerr << "Cannot find service for " << benchmark.midUri << std::endl;
+            abort();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void HttpRouterBenchmark_findExactInRouter(benchmark::State& state) {
+    HttpRouterBenchmark benchmark{state.range(0)};
+    for (auto _ : state) {
+        void* svc = httpRouter_findService(benchmark.router, benchmark.midUri.c_str());
+        if (svc != benchmark.midSvc) {
+            std::cerr << "Cannot find service for " << benchmark.midUri << std::endl;
+            abort();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["nodeCount"] = (double)httpRouter_nodeCount(benchmark.router);
+}
+
+static void HttpRouterBenchmark_findLongestPrefixInServiceTree(benchmark::State& state) {
+    HttpRouterBenchmark benchmark{state.range(0)};
+    auto uri = benchmark.midUri + "/sub/resource/index.html";
+    for (auto _ : state) {
+        service_tree_node_t* node = findServiceNodeInTree(&benchmark.tree, uri.c_str());
+        if (node == nullptr || node->svc_data->service != benchmark.midSvc) {
+            std::cerr << "Cannot find service for " << uri << std::endl;
+            abort();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void HttpRouterBenchmark_findLongestPrefixInRouter(benchmark::State& state) {
+    HttpRouterBenchmark benchmark{state.range(0)};
+    auto uri = benchmark.midUri + "/sub/resource/index.html";
+    for (auto _ : state) {
+        void* svc = httpRouter_findService(benchmark.router, uri.c_str());
+        if (svc != benchmark.midSvc) {
+            std::cerr << "Cannot find service for " << uri << std::endl;
+            abort();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void HttpRouterBenchmark_findWildcardInRouter(benchmark::State& state) {
+    HttpRouterBenchmark benchmark{state.range(0)};
+    for (auto _ : state) {
+        void* svc = httpRouter_findService(benchmark.router, "/api/wildcard/device42/status");
+        if (svc != &benchmark.wildcardSvc) {
+            std::cerr << "Cannot find wildcard service" << std::endl;
+            abort();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void HttpRouterBenchmark_findInPublishedRouter(benchmark::State& state) {
+    static HttpRouterBenchmark* benchmark = nullptr;
+    if (state.thread_index() == 0) {
+        benchmark = new HttpRouterBenchmark{state.range(0)};
+    }
+    for (auto _ : state) {
+        unsigned int phase;
+        const http_router_t* router = httpRouter_readBegin(&benchmark->publisher, &phase);
+        void* svc = httpRouter_findService(router, benchmark->midUri.c_str());
+        httpRouter_readEnd(&benchmark->publisher, phase);
+        if (svc != benchmark->midSvc) {
+            std::cerr << "Cannot find service for " << benchmark->midUri << std::endl;
+            abort();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        delete benchmark;
+        benchmark = nullptr;
+    }
+}
+
+static void HttpRouterBenchmark_createRouter(benchmark::State& state) {
+    HttpRouterBenchmark benchmark{state.range(0)};
+    for (auto _ : state) {
+        http_router_t* router = httpRouter_create(benchmark.uriMap);
+        benchmark::DoNotOptimize(router);
+        httpRouter_destroy(router);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kNanosecond) \
+        ->RangeMultiplier(10)->Range(10, 10000)
+
+CELIX_BENCHMARK(HttpRouterBenchmark_findExactInServiceTree); //reference
+CELIX_BENCHMARK(HttpRouterBenchmark_findExactInRouter);
+CELIX_BENCHMARK(HttpRouterBenchmark_findLongestPrefixInServiceTree); //reference
+CELIX_BENCHMARK(HttpRouterBenchmark_findLongestPrefixInRouter);
+CELIX_BENCHMARK(HttpRouterBenchmark_findWildcardInRouter);
+CELIX_BENCHMARK(HttpRouterBenchmark_createRouter)->Unit(benchmark::kMicrosecond);
+BENCHMARK(HttpRouterBenchmark_findInPublishedRouter)->UseRealTime()->Unit(benchmark::kNanosecond)
+    ->Arg(5000)->ThreadRange(1, 8);
@@ -0,0 +1,208 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "http_router.h"
+
+class HttpRouterTestSuite : public ::testing::Test {
+public:
+    HttpRouterTestSuite() {
+        services = celix_stringHashMap_create();
+    }
+
+    ~HttpRouterTestSuite() override {
+        celix_stringHashMap_destroy(services);
+    }
+
+    celix_string_hash_map_t* services{nullptr};
+    int svc1{1};
+    int svc2{2};
+    int svc3{3};
+    int rootSvc{0};
+};
+
+TEST_F(HttpRouterTestSuite, EmptyRouterTest) {
+    http_router_t* router = httpRouter_create(services);
+    ASSERT_NE(nullptr, router);
+    EXPECT_EQ(1, httpRouter_nodeCount(router));
+    EXPECT_EQ(nullptr, httpRouter_findService(router, "/"));
+    EXPECT_EQ(nullptr, httpRouter_findService(router, "/foo"));
+    EXPECT_EQ(nullptr, httpRouter_findService(nullptr, "/foo"));
+    httpRouter_destroy(router);
+}
+
+TEST_F(HttpRouterTestSuite, ExactAndLongestPrefixMatchTest) {
+    celix_stringHashMap_put(services, "/foo", &svc1);
+    celix_stringHashMap_put(services, "/foo/bar", &svc2);
+    celix_stringHashMap_put(services, "/foo/baz/qux", &svc3);
+    http_router_t* router = httpRouter_create(services);
+    ASSERT_NE(nullptr, router);
+
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/foo"));
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/foo/"));
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "//foo"));
+    EXPECT_EQ(&svc2, httpRouter_findService(router, "/foo/bar"));
+    EXPECT_EQ(&svc2, httpRouter_findService(router, "/foo/bar/index.html"));
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/foo/baz")); //no service on /foo/baz, so /foo is the longest prefix
+    EXPECT_EQ(&svc3, httpRouter_findService(router, "/foo/baz/qux/1"));
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/foo/ba"));
+    EXPECT_EQ(nullptr, httpRouter_findService(router, "/fo"));
+    EXPECT_EQ(nullptr, httpRouter_findService(router, "/foobar"));
+    EXPECT_EQ(nullptr, httpRouter_findService(router, "/"));
+    httpRouter_destroy(router);
+}
+
+TEST_F(HttpRouterTestSuite, RootServiceTest) {
+    celix_stringHashMap_put(services, "/", &rootSvc);
+    celix_stringHashMap_put(services, "/foo", &svc1);
+    http_router_t* router = httpRouter_create(services);
+    ASSERT_NE(nullptr, router);
+
+    EXPECT_EQ(&rootSvc, httpRouter_findService(router, "/"));
+    EXPECT_EQ(&rootSvc, httpRouter_findService(router, "/bar"));
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/foo/bar"));
+    httpRouter_destroy(router);
+}
+
+TEST_F(HttpRouterTestSuite, NonNormalizedUrisTest) {
+    celix_stringHashMap_put(services, "/x//a/1", &svc1);
+    celix_stringHashMap_put(services, "/x/a/2/", &svc2);
+    celix_stringHashMap_put(services, "/x//z", &svc3);
+    http_router_t* router = httpRouter_create(services);
+    ASSERT_NE(nullptr, router);
+
+    EXPECT_EQ(1 + 1 + 2 + 2, httpRouter_nodeCount(router)); //root, x, a, z, 1, 2
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/x/a/1"));
+    EXPECT_EQ(&svc2, httpRouter_findService(router, "/x/a/2"));
+    EXPECT_EQ(&svc3, httpRouter_findService(router, "/x/z"));
+    httpRouter_destroy(router);
+}
+
+TEST_F(HttpRouterTestSuite, WildcardMatchTest) {
+    celix_stringHashMap_put(services, "/devices/*/status", &svc1);
+    celix_stringHashMap_put(services, "/devices/special/status", &svc2);
+    celix_stringHashMap_put(services, "/devices/*", &svc3);
+    http_router_t* router = httpRouter_create(services);
+    ASSERT_NE(nullptr, router);
+
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/devices/dev1/status"));
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/devices/dev2/status/history"));
+    EXPECT_EQ(&svc2, httpRouter_findService(router, "/devices/special/status"));
+    EXPECT_EQ(&svc3, httpRouter_findService(router, "/devices/dev1"));
+    EXPECT_EQ(&svc3, httpRouter_findService(router, "/devices/dev1/config"));
+    EXPECT_EQ(nullptr, httpRouter_findService(router, "/devices"));
+    httpRouter_destroy(router);
+}
+
+TEST_F(HttpRouterTestSuite, ManyServicesTest) {
+    std::vector<std::string> uris{};
+    std::vector<int> svcs(2000);
+    for (int i = 0; i < 2000; ++i) {
+        uris.emplace_back(std::string{"/api/group"} + std::to_string(i % 8) + "/device" + std::to_string(i));
+        celix_stringHashMap_put(services, uris.back().c_str(), &svcs[i]);
+    }
+    http_router_t* router = httpRouter_create(services);
+    ASSERT_NE(nullptr, router);
+    EXPECT_EQ(1 + 1 + 8 + 2000, httpRouter_nodeCount(router));
+    for (int i = 0; i < 2000; ++i) {
+        EXPECT_EQ(&svcs[i], httpRouter_findService(router, uris[i].c_str()));
+    }
+    EXPECT_EQ(nullptr, httpRouter_findService(router, "/api/group1/device2000"));
+    httpRouter_destroy(router);
+}
+
+TEST_F(HttpRouterTestSuite, PublishWhileReadingTest) {
+    celix_stringHashMap_put(services, "/foo", &svc1);
+    http_router_publisher_t publisher{};
+    ASSERT_EQ(CELIX_SUCCESS, httpRouter_initPublisher(&publisher));
+    httpRouter_publish(&publisher, httpRouter_create(services));
+
+    std::atomic<bool> stop{false};
+    std::atomic<long> lookups{0};
+    std::vector<std::thread> readers{};
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]{
+            while (!stop) {
+                unsigned int phase;
+                const http_router_t* router = httpRouter_readBegin(&publisher, &phase);
+                void* svc = httpRouter_findService(router, "/foo");
+                EXPECT_TRUE(svc == &svc1 || svc == &svc2);
+                httpRouter_readEnd(&publisher, phase);
+                lookups++;
+            }
+        });
+    }
+
+    while (lookups.load() == 0) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 100; ++i) {
+        celix_stringHashMap_put(services, "/foo", i % 2 == 0 ? &svc2 : &svc1);
+        httpRouter_publish(&publisher, httpRouter_create(services));
+    }
+    stop = true;
+    for (auto& t : readers) {
+        t.join();
+    }
+    httpRouter_deinitPublisher(&publisher);
+}
+
+TEST_F(HttpRouterTestSuite, PublishDoesNotWaitForReadersTest) {
+    celix_stringHashMap_put(services, "/foo", &svc1);
+    http_router_publisher_t publisher{};
+    ASSERT_EQ(CELIX_SUCCESS, httpRouter_initPublisher(&publisher));
+    httpRouter_publish(&publisher, httpRouter_create(services));
+
+    unsigned int phase;
+    const http_router_t* router = httpRouter_readBegin(&publisher, &phase);
+
+    //When a new router is published and a removed service entry is retired during an active read
+    int* entry = (int*)malloc(sizeof(int));
+    *entry = 42;
+    celix_stringHashMap_put(services, "/foo", &svc2);
+    httpRouter_publish(&publisher, httpRouter_create(services));
+    httpRouter_retire(&publisher, entry, free);
+
+    //Then the reader can still use the old router and the retired entry
+    EXPECT_EQ(&svc1, httpRouter_findService(router, "/foo"));
+    EXPECT_EQ(42, *entry);
+
+    //And a synchronize waits until the read ends
+    std::atomic<bool> synchronized{false};
+    std::thread syncThread{[&]{
+        httpRouter_synchronize(&publisher);
+        synchronized = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    EXPECT_FALSE(synchronized.load());
+    httpRouter_readEnd(&publisher, phase);
+    syncThread.join();
+    EXPECT_TRUE(synchronized.load());
+
+    //And new readers see the new router
+    router = httpRouter_readBegin(&publisher, &phase);
+    EXPECT_EQ(&svc2, httpRouter_findService(router, "/foo"));
+    httpRouter_readEnd(&publisher, phase);
+    httpRouter_deinitPublisher(&publisher);
+}
@@ -23,10 +23,13 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <string>
+#include <atomic>
 
 #include "celix_compiler.h"
 #include "celix/FrameworkFactory.h"
 #include "civetweb.h"
+#include "http_admin/api.h"
 
 #define HTTP_PORT 45111
 
@@ -140,6 +143,35 @@ TEST_F(HttpAndWebsocketTestSuite, http_put_echo_alias_test) {
     mg_close_connection(connection);
 }
 
+TEST_F(HttpAndWebsocketTestSuite, http_put_streaming_test) {
+    char err_buf[100] = {0};
+    char rcv_buf[100] = {0};
+    const size_t bodySize = 1024 * 1024;
+    std::string chunk(4096, 'x');
+
+    auto* connection = mg_connect_client("localhost", HTTP_PORT /*port*/, 0 /*no ssl*/, err_buf, sizeof(err_buf));
+    ASSERT_TRUE(connection != nullptr);
+
+    //Send a large body in chunks, the streaming service counts the received bytes.
+    mg_printf(connection, "PUT /stream HTTP/1.1\r\n"
+                          "Content-Type: application/octet-stream\r\n"
+                          "Content-Length: %zu\r\n\r\n", bodySize);
+    for (size_t sent = 0; sent < bodySize; sent += chunk.size()) {
+        EXPECT_EQ((int)chunk.size(), mg_write(connection, chunk.c_str(), chunk.size()));
+    }
+
+    auto response = mg_get_response(connection, err_buf, sizeof(err_buf), 5000);
+    EXPECT_TRUE(response > 0);
+    auto response_info = mg_get_response_info(connection);
+    ASSERT_TRUE(response_info != nullptr);
+    EXPECT_EQ(200, response_info->status_code);
+    int read_bytes = mg_read(connection, rcv_buf, sizeof(rcv_buf) - 1);
+    EXPECT_GT(read_bytes, 0);
+    EXPECT_EQ(std::to_string(bodySize), std::string{rcv_buf});
+
+    mg_close_connection(connection);
+}
+
 TEST_F(HttpAndWebsocketTestSuite, websocket_echo_test) {
     char err_buf[100] = {0};
     const char *data_str = "Example data string used for testing";
@@ -169,6 +201,67 @@ TEST_F(HttpAndWebsocketTestSuite, websocket_echo_test) {
     mg_close_connection(connection);
 }
 
+static int
+websocket_client_count_handler(struct mg_connection *conn CELIX_UNUSED,
+                               int flags CELIX_UNUSED,
+                               char *data,
+                               size_t data_len,
+                               void *user_data) {
+    auto *count = static_cast<std::atomic<int>*>(user_data);
+    if (data_len == strlen("broadcast") && strncmp(data, "broadcast", data_len) == 0) {
+        count->fetch_add(1);
+    }
+    return 1; //keep connection open
+}
+
+TEST_F(HttpAndWebsocketTestSuite, websocket_broadcast_test) {
+    char err_buf[100] = {0};
+    std::atomic<int> received1{0};
+    std::atomic<int> received2{0};
+
+    auto *connection1 = mg_connect_websocket_client("127.0.0.1", HTTP_PORT, 0, err_buf, sizeof(err_buf),
+            "/", "websocket_test", websocket_client_count_handler, nullptr, &received1);
+    ASSERT_TRUE(connection1 != nullptr);
+    auto *connection2 = mg_connect_websocket_client("127.0.0.1", HTTP_PORT, 0, err_buf, sizeof(err_buf),
+            "/", "websocket_test", websocket_client_count_handler, nullptr, &received2);
+    ASSERT_TRUE(connection2 != nullptr);
+    usleep(100000); //Sleep to let Civetweb handle the ready callbacks
+
+    auto count = ctx->useService<celix_websocket_broadcast_service_t>(WEBSOCKET_BROADCAST_SERVICE_NAME)
+            .addUseCallback([](celix_websocket_broadcast_service_t& svc) {
+                for (int i = 0; i < 10; ++i) {
+                    EXPECT_EQ(2, svc.broadcast(svc.handle, "/", MG_WEBSOCKET_OPCODE_TEXT, "broadcast", strlen("broadcast")));
+                }
+                EXPECT_EQ(-1, svc.broadcast(svc.handle, "/unknown_ws", MG_WEBSOCKET_OPCODE_TEXT, "x", 1));
+            })
+            .build();
+    EXPECT_EQ(1, count);
+
+    for (int i = 0; i < 100 && (received1 < 10 || received2 < 10); ++i) {
+        usleep(10000);
+    }
+    EXPECT_EQ(10, received1.load());
+    EXPECT_EQ(10, received2.load());
+
+    count = ctx->useService<celix_websocket_broadcast_service_t>(WEBSOCKET_BROADCAST_SERVICE_NAME)
+            .addUseCallback([](celix_websocket_broadcast_service_t& svc) {
+                celix_websocket_broadcast_statistics_t stats;
+                EXPECT_EQ(0, svc.getStatistics(svc.handle, "/", &stats));
+                EXPECT_EQ(2u, stats.nrOfConnections);
+                EXPECT_EQ(0u, stats.nrOfSlowConsumers);
+                EXPECT_EQ(0u, stats.nrOfEvictedConnections);
+                EXPECT_EQ(20ul, stats.framesQueued);
+                EXPECT_EQ(20ul, stats.framesSent);
+                EXPECT_EQ(0ul, stats.framesDropped);
+                EXPECT_EQ(0ul, stats.writeErrors);
+            })
+            .build();
+    EXPECT_EQ(1, count);
+
+    mg_close_connection(connection1);
+    mg_close_connection(connection2);
+}
+
 static int
 websocket_client_data_handler(struct mg_connection *conn CELIX_UNUSED,
                               int flags CELIX_UNUSED,
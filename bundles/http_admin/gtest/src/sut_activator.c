@@ -17,6 +17,7 @@
  * under the License.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "celix_bundle_activator.h"
@@ -35,11 +36,15 @@ struct activator {
 
     celix_websocket_service_t sockSvc;
     long sockSvcId;
+
+    celix_http_streaming_service_t streamingSvc;
+    long streamingSvcId;
 };
 
 //Local function prototypes
 int alias_test_put(void *handle, struct mg_connection *connection, const char *path, const char *data, size_t length);
 int websocket_data_echo(struct mg_connection *connection, int op_code, char *data, size_t length, void *handle);
+int stream_test_put(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
 
 celix_status_t bnd_start(struct activator *act, celix_bundle_context_t *ctx) {
     celix_properties_t *props = celix_properties_create();
@@ -64,6 +69,12 @@ celix_status_t bnd_start(struct activator *act, celix_bundle_context_t *ctx) {
     act->sockSvc.data = websocket_data_echo;
     act->sockSvcId = celix_bundleContext_registerService(ctx, &act->sockSvc, WEBSOCKET_ADMIN_SERVICE_NAME, props4);
 
+    celix_properties_t *props5 = celix_properties_create();
+    celix_properties_set(props5, HTTP_ADMIN_URI, "/stream");
+    act->streamingSvc.handle = act;
+    act->streamingSvc.doPut = stream_test_put;
+    act->streamingSvcId = celix_bundleContext_registerService(ctx, &act->streamingSvc, HTTP_ADMIN_STREAMING_SERVICE_NAME, props5);
+
     return CELIX_SUCCESS;
 }
 
@@ -72,10 +83,28 @@ celix_status_t bnd_stop(struct activator *act, celix_bundle_context_t *ctx) {
     celix_bundleContext_unregisterService(ctx, act->httpSvcId2);
     celix_bundleContext_unregisterService(ctx, act->httpSvcId3);
     celix_bundleContext_unregisterService(ctx, act->sockSvcId);
+    celix_bundleContext_unregisterService(ctx, act->streamingSvcId);
 
     return CELIX_SUCCESS;
 }
 
+static int stream_test_countChunk(void *callbackData, const char *chunk CELIX_UNUSED, size_t length) {
+    size_t *count = callbackData;
+    *count += length;
+    return 0;
+}
+
+int stream_test_put(void *handle CELIX_UNUSED, struct mg_connection *connection, const char *path CELIX_UNUSED, celix_http_request_body_t *body) {
+    //Respond with the number of received body bytes for the test case
+    size_t count = 0;
+    if (body->readChunks(body->handle, &count, stream_test_countChunk) != 0) {
+        mg_send_http_error(connection, 400, "%s", "Bad request");
+        return 400;
+    }
+    mg_printf(connection, "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n%zu", count);
+    return 200;
+}
+
 CELIX_GEN_BUNDLE_ACTIVATOR(struct activator, bnd_start, bnd_stop);
 
 int alias_test_put(void *handle CELIX_UNUSED, struct mg_connection *connection, const char *path CELIX_UNUSED, const char *data, size_t length) {
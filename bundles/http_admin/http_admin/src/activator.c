@@ -34,6 +34,7 @@ typedef struct http_admin_activator {
     websocket_admin_manager_t *sockManager;
 
     long httpAdminSvcId;
+    long httpAdminStreamingSvcId;
     long sockAdminSvcId;
 
     bool useWebsockets;
@@ -112,6 +113,14 @@ static int http_admin_start(http_admin_activator_t *act, celix_bundle_context_t
             opts.filter.serviceName = HTTP_ADMIN_SERVICE_NAME;
             act->httpAdminSvcId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
         }
+        {
+            celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
+            opts.callbackHandle = act->httpManager;
+            opts.addWithProperties = http_admin_addHttpStreamingService;
+            opts.removeWithProperties = http_admin_removeHttpStreamingService;
+            opts.filter.serviceName = HTTP_ADMIN_STREAMING_SERVICE_NAME;
+            act->httpAdminStreamingSvcId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+        }
         {
             celix_bundle_tracking_options_t opts = CELIX_EMPTY_BUNDLE_TRACKING_OPTIONS;
             opts.callbackHandle = act->httpManager;
@@ -141,6 +150,7 @@ static int http_admin_start(http_admin_activator_t *act, celix_bundle_context_t
 
 static int http_admin_stop(http_admin_activator_t *act, celix_bundle_context_t *ctx) {
     celix_bundleContext_stopTracker(ctx, act->httpAdminSvcId);
+    celix_bundleContext_stopTracker(ctx, act->httpAdminStreamingSvcId);
     celix_bundleContext_stopTracker(ctx, act->sockAdminSvcId);
     celix_bundleContext_stopTracker(ctx, act->bundleTrackerId);
     httpAdmin_destroy(act->httpManager);
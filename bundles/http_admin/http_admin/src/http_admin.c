@@ -17,6 +17,7 @@
  * under the License.
  */
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <limits.h>
@@ -24,7 +25,7 @@
 
 #include "http_admin.h"
 #include "http_admin/api.h"
-#include "service_tree.h"
+#include "http_router.h"
 
 #include "civetweb.h"
 
@@ -42,9 +43,26 @@ struct http_admin_manager {
     celix_http_info_service_t infoSvc;
     long infoSvcId;
     celix_array_list_t *aliasList;      //Array list of http_alias_t
-    service_tree_t http_svc_tree;
+    celix_string_hash_map_t *services;  //URI -> http_admin_service_entry_t*
+
+    http_router_publisher_t router;     //router for the services, read lock-free by the request handler
 };
 
+/**
+ * The services registered for a single URI. Entries are immutable once added to the router, an update
+ * replaces the entry.
+ */
+typedef struct http_admin_service_entry {
+    celix_http_service_t *httpSvc;
+    celix_http_streaming_service_t *streamingSvc;
+} http_admin_service_entry_t;
+
+typedef struct http_admin_request_body {
+    struct mg_connection *connection;
+} http_admin_request_body_t;
+
+#define HTTP_ADMIN_STREAMING_CHUNK_SIZE 8192
+
 
 typedef struct http_alias {
     char *url;
@@ -58,6 +76,9 @@ static int http_request_handle(struct mg_connection *connection);
 static void httpAdmin_updateInfoSvc(http_admin_manager_t *admin);
 static void createAliasesSymlink(const char *aliases, const char *admin_root, const char *bundle_root, long bundle_id, celix_array_list_t *alias_list);
 static bool aliasList_containsAlias(celix_array_list_t *alias_list, const char *alias);
+static void httpAdmin_updateRouter(http_admin_manager_t *admin);
+static void httpAdmin_replaceServiceEntry(http_admin_manager_t *admin, const char *uri, const http_admin_service_entry_t *update);
+static bool httpAdmin_handleStreamingRequest(celix_http_streaming_service_t *svc, struct mg_connection *connection, const struct mg_request_info *ri, int *status);
 
 
 http_admin_manager_t *httpAdmin_create(celix_bundle_context_t *context, char *root, const char **svr_opts) {
@@ -71,7 +92,14 @@ http_admin_manager_t *httpAdmin_create(celix_bundle_context_t *context, char *ro
     admin->infoSvcId = -1L;
 
     status = celixThreadRwlock_create(&admin->admin_lock, NULL);
+    if (status == CELIX_SUCCESS) {
+        status = httpRouter_initPublisher(&admin->router);
+        if (status != CELIX_SUCCESS) {
+            celixThreadRwlock_destroy(&admin->admin_lock);
+        }
+    }
     admin->aliasList = celix_arrayList_create();
+    admin->services = celix_stringHashMap_create();
 
     if (status == CELIX_SUCCESS) {
         //Use only begin_request callback
@@ -93,9 +121,13 @@ http_admin_manager_t *httpAdmin_create(celix_bundle_context_t *context, char *ro
         if (admin->mgCtx != NULL) {
             mg_stop(admin->mgCtx);
         }
-        celixThreadRwlock_destroy(&admin->admin_lock);
+        if (admin->router.gracePeriod != NULL) {
+            httpRouter_deinitPublisher(&admin->router);
+            celixThreadRwlock_destroy(&admin->admin_lock);
+        }
 
         celix_arrayList_destroy(admin->aliasList);
+        celix_stringHashMap_destroy(admin->services);
         free(admin);
         admin = NULL;
     }
@@ -110,7 +142,12 @@ void httpAdmin_destroy(http_admin_manager_t *admin) {
 
     celixThreadRwlock_writeLock(&(admin->admin_lock));
     celix_bundleContext_unregisterService(admin->context, admin->infoSvcId);
-    destroyServiceTree(&admin->http_svc_tree);
+    //note the webserver is stopped, so no request handler uses the router or the service entries anymore
+    httpRouter_deinitPublisher(&admin->router);
+    CELIX_STRING_HASH_MAP_ITERATE(admin->services, iter) {
+        free(iter.value.ptrValue);
+    }
+    celix_stringHashMap_destroy(admin->services);
 
     //Destroy alias map by removing symbolic links first.
     unsigned int size = celix_arrayList_size(admin->aliasList);
@@ -147,8 +184,12 @@ void http_admin_addHttpService(void *handle, void *svc, const celix_properties_t
 
     if(uri != NULL) {
         celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
-        if(!addServiceNode(&admin->http_svc_tree, uri, httpSvc)) {
+        http_admin_service_entry_t *entry = celix_stringHashMap_get(admin->services, uri);
+        if(entry != NULL && entry->httpSvc != NULL) {
             printf("HTTP service with URI %s already exists!\n", uri);
+        } else {
+            http_admin_service_entry_t update = {.httpSvc = httpSvc, .streamingSvc = entry != NULL ? entry->streamingSvc : NULL};
+            httpAdmin_replaceServiceEntry(admin, uri, &update);
         }
     }
 }
@@ -159,39 +200,161 @@ void http_admin_removeHttpService(void *handle, void *svc CELIX_UNUSED, const ce
     const char *uri = celix_properties_get(props, HTTP_ADMIN_URI, NULL);
 
     if(uri != NULL) {
-        celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
-        service_tree_node_t *node = NULL;
+        bool removed = false;
+        {
+            celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
+            http_admin_service_entry_t *entry = celix_stringHashMap_get(admin->services, uri);
+            if(entry != NULL && entry->httpSvc != NULL) {
+                http_admin_service_entry_t update = {.httpSvc = NULL, .streamingSvc = entry->streamingSvc};
+                httpAdmin_replaceServiceEntry(admin, uri, &update);
+                removed = true;
+            } else {
+                printf("Couldn't remove HTTP service with URI: %s, it doesn't exist\n", uri);
+            }
+        }
+        if (removed) {
+            //note wait outside the admin lock until no request handler uses the removed service anymore
+            httpRouter_synchronize(&admin->router);
+        }
+    }
+}
+
+void http_admin_addHttpStreamingService(void *handle, void *svc, const celix_properties_t *props) {
+    http_admin_manager_t *admin = (http_admin_manager_t *) handle;
+    celix_http_streaming_service_t *streamingSvc = (celix_http_streaming_service_t *) svc;
 
-        node = findServiceNodeInTree(&admin->http_svc_tree, uri);
+    const char *uri = celix_properties_get(props, HTTP_ADMIN_URI, NULL);
 
-        if(node != NULL){
-            destroyServiceNode(&admin->http_svc_tree, node, &admin->http_svc_tree.tree_node_count, &admin->http_svc_tree.tree_svc_count);
+    if(uri != NULL) {
+        celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
+        http_admin_service_entry_t *entry = celix_stringHashMap_get(admin->services, uri);
+        if(entry != NULL && entry->streamingSvc != NULL) {
+            printf("HTTP streaming service with URI %s already exists!\n", uri);
         } else {
-            printf("Couldn't remove HTTP service with URI: %s, it doesn't exist\n", uri);
+            http_admin_service_entry_t update = {.httpSvc = entry != NULL ? entry->httpSvc : NULL, .streamingSvc = streamingSvc};
+            httpAdmin_replaceServiceEntry(admin, uri, &update);
         }
     }
 }
 
+void http_admin_removeHttpStreamingService(void *handle, void *svc CELIX_UNUSED, const celix_properties_t *props) {
+    http_admin_manager_t *admin = (http_admin_manager_t *) handle;
+
+    const char *uri = celix_properties_get(props, HTTP_ADMIN_URI, NULL);
+
+    if(uri != NULL) {
+        bool removed = false;
+        {
+            celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
+            http_admin_service_entry_t *entry = celix_stringHashMap_get(admin->services, uri);
+            if(entry != NULL && entry->streamingSvc != NULL) {
+                http_admin_service_entry_t update = {.httpSvc = entry->httpSvc, .streamingSvc = NULL};
+                httpAdmin_replaceServiceEntry(admin, uri, &update);
+                removed = true;
+            } else {
+                printf("Couldn't remove HTTP streaming service with URI: %s, it doesn't exist\n", uri);
+            }
+        }
+        if (removed) {
+            //note wait outside the admin lock until no request handler uses the removed service anymore
+            httpRouter_synchronize(&admin->router);
+        }
+    }
+}
+
+/**
+ * Replace (or remove if the update has no services) the service entry for the URI and update the router.
+ * Should be called with the admin_lock write locked.
+ */
+static void httpAdmin_replaceServiceEntry(http_admin_manager_t *admin, const char *uri, const http_admin_service_entry_t *update) {
+    http_admin_service_entry_t *old = celix_stringHashMap_get(admin->services, uri);
+    if (update->httpSvc != NULL || update->streamingSvc != NULL) {
+        http_admin_service_entry_t *entry = malloc(sizeof(*entry));
+        if (entry == NULL || celix_stringHashMap_put(admin->services, uri, entry) != CELIX_SUCCESS) {
+            celix_bundleContext_log(admin->context, CELIX_LOG_LEVEL_ERROR, "Cannot update HTTP services for URI %s.", uri);
+            free(entry);
+            return;
+        }
+        *entry = *update;
+    } else {
+        celix_stringHashMap_remove(admin->services, uri);
+    }
+    httpAdmin_updateRouter(admin);
+    //note the old entry is freed when no request handler can use it anymore.
+    httpRouter_retire(&admin->router, old, free);
+}
+
+static int httpAdmin_readRequestBody(void *handle, void *buffer, size_t length) {
+    http_admin_request_body_t *body = handle;
+    return mg_read(body->connection, buffer, length > INT_MAX ? INT_MAX : length);
+}
+
+static int httpAdmin_readRequestBodyChunks(void *handle, void *callbackData, int (*chunkCallback)(void *callbackData, const char *chunk, size_t length)) {
+    http_admin_request_body_t *body = handle;
+    char chunk[HTTP_ADMIN_STREAMING_CHUNK_SIZE];
+    int bytesRead = mg_read(body->connection, chunk, sizeof(chunk));
+    while (bytesRead > 0) {
+        int rc = chunkCallback(callbackData, chunk, (size_t) bytesRead);
+        if (rc != 0) {
+            return rc;
+        }
+        bytesRead = mg_read(body->connection, chunk, sizeof(chunk));
+    }
+    return bytesRead;
+}
+
+/**
+ * Handle the request with the streaming service if the streaming service implements the request method.
+ * @return true if the request is handled.
+ */
+static bool httpAdmin_handleStreamingRequest(celix_http_streaming_service_t *svc, struct mg_connection *connection, const struct mg_request_info *ri, int *status) {
+    int (*doRequest)(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body) = NULL;
+    if (svc == NULL) {
+        return false;
+    } else if (strcmp("POST", ri->request_method) == 0) {
+        doRequest = svc->doPost;
+    } else if (strcmp("PUT", ri->request_method) == 0) {
+        doRequest = svc->doPut;
+    } else if (strcmp("PATCH", ri->request_method) == 0) {
+        doRequest = svc->doPatch;
+    }
+    if (doRequest == NULL) {
+        return false;
+    }
+
+    http_admin_request_body_t bodyHandle = {.connection = connection};
+    celix_http_request_body_t body = {
+            .handle = &bodyHandle,
+            .contentLength = ri->content_length,
+            .read = httpAdmin_readRequestBody,
+            .readChunks = httpAdmin_readRequestBodyChunks
+    };
+    *status = doRequest(svc->handle, connection, ri->request_uri, &body);
+    return true;
+}
+
 int http_request_handle(struct mg_connection *connection) {
     int ret_status = 400; //Default bad request
 
     if (connection != NULL) {
         const struct mg_request_info *ri = mg_get_request_info(connection);
         http_admin_manager_t *admin = (http_admin_manager_t *) ri->user_data;
-        service_tree_node_t *node = NULL;
 
         if (mg_get_header(connection, "Upgrade") != NULL) {
             //Assume this is a websocket request...
             ret_status = 0; //... so return zero to let the civetweb server handle the request.
         }
         else {
-            celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
+            unsigned int routerPhase;
+            const http_router_t *router = httpRouter_readBegin(&admin->router, &routerPhase);
             const char *req_uri = ri->request_uri;
-            node = findServiceNodeInTree(&admin->http_svc_tree, req_uri);
+            const http_admin_service_entry_t *entry = httpRouter_findService(router, req_uri);
+            celix_http_service_t *httpSvc = entry != NULL ? entry->httpSvc : NULL;
 
-            if (node != NULL) {
-                //Requested URI with node exists, now obtain the http service and call the requested function.
-                celix_http_service_t *httpSvc = (celix_http_service_t *) node->svc_data->service;
+            if (entry != NULL && httpAdmin_handleStreamingRequest(entry->streamingSvc, connection, ri, &ret_status)) {
+                //Request (body) streamed to the streaming service
+            } else if (httpSvc != NULL) {
+                //Requested URI has a service, now call the requested function.
 
                 if (strcmp("GET", ri->request_method) == 0) {
                     if (httpSvc->doGet != NULL) {
@@ -339,6 +502,7 @@ int http_request_handle(struct mg_connection *connection) {
             } else {
                 ret_status = 0; //Not found requested URI, let civetweb handle this situation
             }
+            httpRouter_readEnd(&admin->router, routerPhase);
         }
     } else {
         mg_send_http_error(connection, 400, "%s", "Bad request");
@@ -348,6 +512,20 @@ int http_request_handle(struct mg_connection *connection) {
     return ret_status;
 }
 
+/**
+ * Rebuild the router for the current set of HTTP services and publish it for the request handlers.
+ * Should be called with the admin_lock write locked.
+ */
+static void httpAdmin_updateRouter(http_admin_manager_t *admin) {
+    http_router_t *router = httpRouter_create(admin->services);
+    if (router == NULL) {
+        celix_bundleContext_log(admin->context, CELIX_LOG_LEVEL_ERROR, "Cannot create HTTP router for %zu services.",
+                                celix_stringHashMap_size(admin->services));
+        //note publishing NULL ensures that no removed service is used anymore
+    }
+    httpRouter_publish(&admin->router, router);
+}
+
 static void httpAdmin_updateInfoSvc(http_admin_manager_t *admin) {
     const char *ports = mg_get_option(admin->mgCtx, "listening_ports");
 
@@ -39,5 +39,14 @@
 #define HTTP_ADMIN_NUM_THREADS_KEY              "CELIX_HTTP_ADMIN_NUM_THREADS"
 #define HTTP_ADMIN_NUM_THREADS_DFT              1L
 
+#define HTTP_ADMIN_WEBSOCKET_SEND_QUEUE_SIZE_KEY        "CELIX_HTTP_ADMIN_WEBSOCKET_SEND_QUEUE_SIZE"
+#define HTTP_ADMIN_WEBSOCKET_SEND_QUEUE_SIZE_DFT        256L
+
+#define HTTP_ADMIN_WEBSOCKET_NUM_SENDER_THREADS_KEY     "CELIX_HTTP_ADMIN_WEBSOCKET_NUM_SENDER_THREADS"
+#define HTTP_ADMIN_WEBSOCKET_NUM_SENDER_THREADS_DFT     4L
+
+#define HTTP_ADMIN_WEBSOCKET_MAX_WRITE_TIME_MS_KEY      "CELIX_HTTP_ADMIN_WEBSOCKET_MAX_WRITE_TIME_MS"
+#define HTTP_ADMIN_WEBSOCKET_MAX_WRITE_TIME_MS_DFT      1000L
+
 
 #endif //CELIX_HTTP_ADMIN_CONSTANTS_H
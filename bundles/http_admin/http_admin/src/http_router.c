@@ -0,0 +1,322 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "http_router.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HTTP_ROUTER_WILDCARD_SEGMENT "*"
+#define HTTP_ROUTER_NO_WILDCARD 0 //root node (index 0) is never a child node
+
+/**
+ * Mutable trie node, only used while building a router.
+ */
+typedef struct http_router_build_node {
+    const char* segment; //not NUL terminated, points into the registered URI
+    size_t segmentLen;
+    void* svc;
+    size_t childCount;
+    struct http_router_build_node* children; //single linked list of (non wildcard) children
+    struct http_router_build_node* next;
+    struct http_router_build_node* wildcard;
+} http_router_build_node_t;
+
+/**
+ * Immutable trie node. The children of a node are stored consecutively and sorted on segment, so that
+ * a child can be found using a binary search.
+ */
+typedef struct http_router_node {
+    const char* segment; //NUL terminated, points into the router string pool
+    size_t segmentLen;
+    void* svc;
+    unsigned int firstChild;
+    unsigned int childCount;
+    unsigned int wildcard; //index of the wildcard child or HTTP_ROUTER_NO_WILDCARD
+} http_router_node_t;
+
+struct http_router {
+    size_t nodeCount;
+    http_router_node_t* nodes; //nodes[0] is the root ("/") node, nodes are stored in breadth-first order
+    char* strings;             //string pool for all node segments
+};
+
+static const char* httpRouter_nextSegment(const char* uri, size_t* segmentLen) {
+    while (*uri == '/') {
+        uri++;
+    }
+    *segmentLen = strcspn(uri, "/");
+    return uri;
+}
+
+static int httpRouter_compareSegment(const char* seg1, size_t len1, const char* seg2, size_t len2) {
+    int cmp = memcmp(seg1, seg2, len1 < len2 ? len1 : len2);
+    if (cmp == 0) {
+        cmp = len1 < len2 ? -1 : (len1 > len2 ? 1 : 0);
+    }
+    return cmp;
+}
+
+static int httpRouter_compareBuildNodes(const void* a, const void* b) {
+    const http_router_build_node_t* n1 = *(http_router_build_node_t* const*)a;
+    const http_router_build_node_t* n2 = *(http_router_build_node_t* const*)b;
+    return httpRouter_compareSegment(n1->segment, n1->segmentLen, n2->segment, n2->segmentLen);
+}
+
+static http_router_build_node_t* httpRouter_createBuildNode(const char* segment, size_t segmentLen, size_t* nodeCount, size_t* stringsSize) {
+    http_router_build_node_t* node = calloc(1, sizeof(*node));
+    if (node != NULL) {
+        node->segment = segment;
+        node->segmentLen = segmentLen;
+        *nodeCount += 1;
+        *stringsSize += segmentLen + 1;
+    }
+    return node;
+}
+
+static void httpRouter_destroyBuildNode(http_router_build_node_t* node) {
+    if (node != NULL) {
+        http_router_build_node_t* child = node->children;
+        while (child != NULL) {
+            http_router_build_node_t* next = child->next;
+            httpRouter_destroyBuildNode(child);
+            child = next;
+        }
+        httpRouter_destroyBuildNode(node->wildcard);
+        free(node);
+    }
+}
+
+/**
+ * Inserts the URI in the build trie. URIs must be inserted in httpRouter_compareUris order.
+ */
+static bool httpRouter_insert(http_router_build_node_t* root, const char* uri, void* svc, size_t* nodeCount, size_t* stringsSize) {
+    http_router_build_node_t* current = root;
+    size_t len;
+    const char* seg = httpRouter_nextSegment(uri, &len);
+    while (len > 0) {
+        http_router_build_node_t* child = NULL;
+        if (len == 1 && *seg == HTTP_ROUTER_WILDCARD_SEGMENT[0]) {
+            if (current->wildcard == NULL) {
+                current->wildcard = httpRouter_createBuildNode(seg, len, nodeCount, stringsSize);
+            }
+            child = current->wildcard;
+        } else {
+            //note URIs are inserted sorted, so an existing child for this segment can only be the last inserted child.
+            child = current->children;
+            if (child == NULL || httpRouter_compareSegment(child->segment, child->segmentLen, seg, len) != 0) {
+                child = httpRouter_createBuildNode(seg, len, nodeCount, stringsSize);
+                if (child != NULL) {
+                    child->next = current->children;
+                    current->children = child;
+                    current->childCount += 1;
+                }
+            }
+        }
+        if (child == NULL) {
+            return false;
+        }
+        current = child;
+        seg = httpRouter_nextSegment(seg + len, &len);
+    }
+    if (current->svc == NULL) {
+        //note if multiple URIs normalize to the same path (e.g. "/foo" and "/foo/"), the first one is used.
+        current->svc = svc;
+    }
+    return true;
+}
+
+static http_router_t* httpRouter_flatten(http_router_build_node_t* root, size_t nodeCount, size_t stringsSize) {
+    http_router_t* router = malloc(sizeof(*router) + nodeCount * sizeof(http_router_node_t) + stringsSize);
+    http_router_build_node_t** queue = malloc(nodeCount * sizeof(*queue));
+    if (router == NULL || queue == NULL) {
+        free(router);
+        free(queue);
+        return NULL;
+    }
+    router->nodeCount = nodeCount;
+    router->nodes = (http_router_node_t*)(router + 1);
+    router->strings = (char*)(router->nodes + nodeCount);
+
+    //breadth-first, so that all children of a node are stored consecutively
+    char* str = router->strings;
+    size_t tail = 0;
+    queue[tail++] = root;
+    for (size_t i = 0; i < nodeCount; ++i) {
+        http_router_build_node_t* bNode = queue[i];
+        http_router_node_t* node = &router->nodes[i];
+
+        memcpy(str, bNode->segment, bNode->segmentLen);
+        str[bNode->segmentLen] = '\0';
+        node->segment = str;
+        node->segmentLen = bNode->segmentLen;
+        node->svc = bNode->svc;
+        str += bNode->segmentLen + 1;
+
+        node->firstChild = (unsigned int)tail;
+        node->childCount = (unsigned int)bNode->childCount;
+        for (http_router_build_node_t* child = bNode->children; child != NULL; child = child->next) {
+            queue[tail++] = child;
+        }
+        qsort(&queue[node->firstChild], bNode->childCount, sizeof(*queue), httpRouter_compareBuildNodes);
+
+        node->wildcard = HTTP_ROUTER_NO_WILDCARD;
+        if (bNode->wildcard != NULL) {
+            node->wildcard = (unsigned int)tail;
+            queue[tail++] = bNode->wildcard;
+        }
+    }
+    free(queue);
+    return router;
+}
+
+/**
+ * Compares URIs segment by segment, so that sorted URIs with common leading segments are adjacent.
+ */
+static int httpRouter_compareUris(const void* a, const void* b) {
+    size_t len1;
+    size_t len2;
+    const char* seg1 = httpRouter_nextSegment(((const celix_string_hash_map_iterator_t*)a)->key, &len1);
+    const char* seg2 = httpRouter_nextSegment(((const celix_string_hash_map_iterator_t*)b)->key, &len2);
+    while (len1 > 0 && len2 > 0) {
+        int cmp = httpRouter_compareSegment(seg1, len1, seg2, len2);
+        if (cmp != 0) {
+            return cmp;
+        }
+        seg1 = httpRouter_nextSegment(seg1 + len1, &len1);
+        seg2 = httpRouter_nextSegment(seg2 + len2, &len2);
+    }
+    return len1 > 0 ? 1 : (len2 > 0 ? -1 : 0);
+}
+
+http_router_t* httpRouter_create(const celix_string_hash_map_t* services) {
+    size_t nodeCount = 0;
+    size_t stringsSize = 0;
+    size_t nrOfServices = celix_stringHashMap_size(services);
+    celix_string_hash_map_iterator_t* entries = malloc((nrOfServices + 1) * sizeof(*entries));
+    http_router_build_node_t* root = httpRouter_createBuildNode("", 0, &nodeCount, &stringsSize);
+    if (entries == NULL || root == NULL) {
+        free(entries);
+        free(root);
+        return NULL;
+    }
+
+    //note inserting sorted URIs ensures that a matching child is always at the head of the children list.
+    size_t i = 0;
+    CELIX_STRING_HASH_MAP_ITERATE(services, iter) {
+        entries[i++] = iter;
+    }
+    qsort(entries, nrOfServices, sizeof(*entries), httpRouter_compareUris);
+
+    bool ok = true;
+    for (i = 0; ok && i < nrOfServices; ++i) {
+        ok = httpRouter_insert(root, entries[i].key, entries[i].value.ptrValue, &nodeCount, &stringsSize);
+    }
+
+    http_router_t* router = ok ? httpRouter_flatten(root, nodeCount, stringsSize) : NULL;
+    httpRouter_destroyBuildNode(root);
+    free(entries);
+    return router;
+}
+
+void httpRouter_destroy(http_router_t* router) {
+    free(router); //note router nodes and strings are part of the router allocation
+}
+
+size_t httpRouter_nodeCount(const http_router_t* router) {
+    return router == NULL ? 0 : router->nodeCount;
+}
+
+static const http_router_node_t* httpRouter_findChild(const http_router_t* router, const http_router_node_t* parent, const char* seg, size_t len) {
+    size_t low = parent->firstChild;
+    size_t high = parent->firstChild + parent->childCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const http_router_node_t* child = &router->nodes[mid];
+        int cmp = httpRouter_compareSegment(child->segment, child->segmentLen, seg, len);
+        if (cmp == 0) {
+            return child;
+        } else if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return parent->wildcard == HTTP_ROUTER_NO_WILDCARD ? NULL : &router->nodes[parent->wildcard];
+}
+
+void* httpRouter_findService(const http_router_t* router, const char* uri) {
+    if (router == NULL || uri == NULL) {
+        return NULL;
+    }
+    const http_router_node_t* current = &router->nodes[0];
+    void* found = current->svc;
+    size_t len;
+    const char* seg = httpRouter_nextSegment(uri, &len);
+    while (len > 0) {
+        current = httpRouter_findChild(router, current, seg, len);
+        if (current == NULL) {
+            break;
+        }
+        if (current->svc != NULL) {
+            found = current->svc;
+        }
+        seg = httpRouter_nextSegment(seg + len, &len);
+    }
+    return found;
+}
+
+celix_status_t httpRouter_initPublisher(http_router_publisher_t* publisher) {
+    publisher->router = NULL;
+    publisher->gracePeriod = celix_gracePeriod_create();
+    return publisher->gracePeriod != NULL ? CELIX_SUCCESS : CELIX_ENOMEM;
+}
+
+void httpRouter_deinitPublisher(http_router_publisher_t* publisher) {
+    httpRouter_destroy(__atomic_exchange_n(&publisher->router, NULL, __ATOMIC_SEQ_CST));
+    celix_gracePeriod_destroy(publisher->gracePeriod);
+    publisher->gracePeriod = NULL;
+}
+
+const http_router_t* httpRouter_readBegin(http_router_publisher_t* publisher, unsigned int* phase) {
+    *phase = celix_gracePeriod_readBegin(publisher->gracePeriod);
+    return __atomic_load_n(&publisher->router, __ATOMIC_SEQ_CST);
+}
+
+void httpRouter_readEnd(http_router_publisher_t* publisher, unsigned int phase) {
+    celix_gracePeriod_readEnd(publisher->gracePeriod, phase);
+}
+
+static void httpRouter_destroyRetired(void* router) {
+    httpRouter_destroy(router);
+}
+
+void httpRouter_publish(http_router_publisher_t* publisher, http_router_t* router) {
+    http_router_t* old = __atomic_exchange_n(&publisher->router, router, __ATOMIC_SEQ_CST);
+    celix_gracePeriod_retire(publisher->gracePeriod, old, httpRouter_destroyRetired);
+}
+
+void httpRouter_retire(http_router_publisher_t* publisher, void* obj, void (*destroy)(void* obj)) {
+    celix_gracePeriod_retire(publisher->gracePeriod, obj, destroy);
+}
+
+void httpRouter_synchronize(http_router_publisher_t* publisher) {
+    celix_gracePeriod_synchronize(publisher->gracePeriod);
+}
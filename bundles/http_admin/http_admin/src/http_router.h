@@ -0,0 +1,150 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_HTTP_ROUTER_H
+#define CELIX_HTTP_ROUTER_H
+
+#include <stddef.h>
+
+#include "celix_errno.h"
+#include "celix_grace_period.h"
+#include "celix_string_hash_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Immutable prefix trie which maps request URIs to registered services.
+ *
+ * A router is built once from the complete set of registered URIs and is never modified afterwards.
+ * URIs are matched per path segment (empty segments are ignored) and the service of the deepest matching node is
+ * returned (longest-prefix match, as required by the OSGi Http Whiteboard specification).
+ * A "*" segment in a registered URI matches exactly one arbitrary path segment; exact segments take precedence over
+ * a wildcard segment on the same level.
+ */
+typedef struct http_router http_router_t;
+
+/**
+ * @brief Publication point for a router, which allows lock-free and allocation-free lookups.
+ *
+ * Readers enter a read-side section with httpRouter_readBegin and leave it with httpRouter_readEnd.
+ * A new router is published with httpRouter_publish, the previous router is destroyed after a grace period: when all
+ * readers that could still observe the previous router have left their read-side section (read-copy-update).
+ * Publishing never waits for readers. Publishers must be serialized by the caller.
+ */
+typedef struct http_router_publisher {
+    http_router_t* router;              //current router, only accessed using atomics
+    celix_grace_period_t* gracePeriod;  //grace period for the replaced routers and retired objects
+} http_router_publisher_t;
+
+/**
+ * @brief Creates a router for the provided URI -> service map.
+ * @param[in] services The registered services, keyed by URI. Values are the service pointers.
+ * @return The new router or NULL if the router could not be allocated.
+ */
+http_router_t* httpRouter_create(const celix_string_hash_map_t* services);
+
+/**
+ * @brief Destroys the router. Registered services are not touched.
+ */
+void httpRouter_destroy(http_router_t* router);
+
+/**
+ * @brief Finds the service registered for the longest matching prefix of the provided URI.
+ *
+ * Does not allocate memory and does not modify the router; safe to call concurrently.
+ *
+ * @param[in] router The router, can be NULL.
+ * @param[in] uri The request URI.
+ * @return The found service or NULL if no registered URI matches.
+ */
+void* httpRouter_findService(const http_router_t* router, const char* uri);
+
+/**
+ * @brief Returns the number of trie nodes of the router (incl. the root node).
+ */
+size_t httpRouter_nodeCount(const http_router_t* router);
+
+/**
+ * @brief Initializes a router publication point without a router.
+ * @return CELIX_SUCCESS or CELIX_ENOMEM if the publication point could not be initialized.
+ */
+celix_status_t httpRouter_initPublisher(http_router_publisher_t* publisher);
+
+/**
+ * @brief Deinitializes the router publication point and destroys the published and retired routers and objects.
+ *
+ * Must not be called while read-side sections are active.
+ */
+void httpRouter_deinitPublisher(http_router_publisher_t* publisher);
+
+/**
+ * @brief Enters a read-side section and returns the current router.
+ *
+ * The returned router (and the services registered in it) stays valid until httpRouter_readEnd is called with the
+ * returned phase.
+ *
+ * @param[in] publisher The router publication point.
+ * @param[out] phase The phase which must be provided to httpRouter_readEnd.
+ * @return The current router, can be NULL.
+ */
+const http_router_t* httpRouter_readBegin(http_router_publisher_t* publisher, unsigned int* phase);
+
+/**
+ * @brief Leaves a read-side section started with httpRouter_readBegin.
+ */
+void httpRouter_readEnd(http_router_publisher_t* publisher, unsigned int phase);
+
+/**
+ * @brief Publishes a new router and destroys the previous router once no reader can observe it anymore.
+ *
+ * Does not wait for read-side sections, the previous router is destroyed by the publishing thread or by the last
+ * reader which could observe it.
+ *
+ * @param[in] publisher The router publication point.
+ * @param[in] router The new router, ownership is transferred to the publisher. Can be NULL.
+ */
+void httpRouter_publish(http_router_publisher_t* publisher, http_router_t* router);
+
+/**
+ * @brief Destroys an object, which is referred to by a replaced router, once no reader can observe it anymore.
+ *
+ * Should be called after publishing the router which no longer refers to the object. Does not wait for read-side
+ * sections.
+ *
+ * @param[in] publisher The router publication point.
+ * @param[in] obj The object, can be NULL.
+ * @param[in] destroy The destroy function for the object.
+ */
+void httpRouter_retire(http_router_publisher_t* publisher, void* obj, void (*destroy)(void* obj));
+
+/**
+ * @brief Waits until all read-side sections which started before this call have ended.
+ *
+ * Can be used to ensure a service, which is no longer referred to by the published router, is no longer used by
+ * readers. Waits on a condition and does not spin. Must not be called from within a read-side section.
+ */
+void httpRouter_synchronize(http_router_publisher_t* publisher);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_HTTP_ROUTER_H
@@ -19,16 +19,53 @@
 
 #include <memory.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "civetweb.h"
 #include "http_admin.h"
 #include "http_admin/api.h"
+#include "http_admin_constants.h"
 #include "service_tree.h"
 #include "websocket_admin.h"
 
 #include "celix_compiler.h"
+#include "celix_long_hash_map.h"
+#include "celix_ref.h"
+#include "celix_utils.h"
 #include "celix_utils_api.h"
 
+#define WEBSOCKET_ADMIN_MAX_SENDER_THREADS 16
+#define WEBSOCKET_ADMIN_MAX_FRAMES_PER_TURN 8
+
+/**
+ * A encoded (server, so unmasked) websocket frame, shared by all connections it is queued for.
+ */
+typedef struct websocket_frame {
+    struct celix_ref ref;
+    size_t size;
+    char data[];
+} websocket_frame_t;
+
+typedef struct websocket_connection {
+    struct mg_connection *connection;
+    celix_websocket_service_t *svc;     //the websocket service handling the connection
+
+    websocket_frame_t **queue;          //ring buffer with sendQueueSize entries
+    size_t queueHead;
+    size_t queueCount;
+
+    bool scheduled;                     //whether the connection is in the pending list
+    bool writing;                       //whether a sender thread is writing to the connection
+    bool closed;
+    bool evicted;                       //whether broadcasting stopped, because a write failed or was too slow
+    struct websocket_connection *nextPending;
+
+    unsigned long framesQueued;
+    unsigned long framesSent;
+    unsigned long framesDropped;
+    unsigned long writeErrors;
+} websocket_connection_t;
+
 struct websocket_admin_manager {
     bundle_context_pt context;
 
@@ -36,8 +73,29 @@ struct websocket_admin_manager {
 
     service_tree_t sock_svc_tree;
     celix_thread_rwlock_t admin_lock;
+
+    celix_websocket_broadcast_service_t broadcastSvc;
+    long broadcastSvcId;
+
+    size_t sendQueueSize;
+    size_t nrOfSenderThreads;
+    double maxWriteTime;                //in seconds, a connection with a slower write is evicted
+    celix_thread_t senderThreads[WEBSOCKET_ADMIN_MAX_SENDER_THREADS];
+
+    celix_thread_mutex_t sendMutex;     //protects below
+    celix_thread_cond_t sendCond;       //signals pending connections, finished writes and stop
+    bool stopSenders;
+    celix_long_hash_map_t *connections; //key = struct mg_connection*, value = websocket_connection_t*
+    websocket_connection_t *pendingHead; //FIFO of connections with queued frames, served round-robin
+    websocket_connection_t *pendingTail;
 };
 
+static void *websocketAdmin_sender(void *data);
+static int websocketAdmin_broadcast(void *handle, const char *uri, int opCode, const void *data, size_t length);
+static int websocketAdmin_getStatistics(void *handle, const char *uri, celix_websocket_broadcast_statistics_t *stats);
+static void websocketAdmin_addConnection(websocket_admin_manager_t *admin, struct mg_connection *connection, celix_websocket_service_t *svc);
+static void websocketAdmin_removeConnection(websocket_admin_manager_t *admin, const struct mg_connection *connection);
+
 websocket_admin_manager_t *websocketAdmin_create(celix_bundle_context_t *context, struct mg_context *svr_ctx) {
     celix_status_t status;
 
@@ -49,17 +107,76 @@ websocket_admin_manager_t *websocketAdmin_create(celix_bundle_context_t *context
 
     admin->context = context;
     admin->mg_ctx = svr_ctx;
-    status = celixThreadRwlock_create(&admin->admin_lock, NULL);
+    admin->broadcastSvcId = -1L;
+    long queueSize = celix_bundleContext_getPropertyAsLong(context, HTTP_ADMIN_WEBSOCKET_SEND_QUEUE_SIZE_KEY, HTTP_ADMIN_WEBSOCKET_SEND_QUEUE_SIZE_DFT);
+    long nrOfThreads = celix_bundleContext_getPropertyAsLong(context, HTTP_ADMIN_WEBSOCKET_NUM_SENDER_THREADS_KEY, HTTP_ADMIN_WEBSOCKET_NUM_SENDER_THREADS_DFT);
+    admin->sendQueueSize = queueSize > 0 ? (size_t) queueSize : (size_t) HTTP_ADMIN_WEBSOCKET_SEND_QUEUE_SIZE_DFT;
+    admin->nrOfSenderThreads = nrOfThreads > 0 ? (size_t) nrOfThreads : (size_t) HTTP_ADMIN_WEBSOCKET_NUM_SENDER_THREADS_DFT;
+    if (admin->nrOfSenderThreads > WEBSOCKET_ADMIN_MAX_SENDER_THREADS) {
+        admin->nrOfSenderThreads = WEBSOCKET_ADMIN_MAX_SENDER_THREADS;
+    }
+    long maxWriteTimeMs = celix_bundleContext_getPropertyAsLong(context, HTTP_ADMIN_WEBSOCKET_MAX_WRITE_TIME_MS_KEY, HTTP_ADMIN_WEBSOCKET_MAX_WRITE_TIME_MS_DFT);
+    admin->maxWriteTime = (double) (maxWriteTimeMs > 0 ? maxWriteTimeMs : HTTP_ADMIN_WEBSOCKET_MAX_WRITE_TIME_MS_DFT) / 1000.0;
 
+    status = celixThreadRwlock_create(&admin->admin_lock, NULL);
     if(status != CELIX_SUCCESS) {
         //No need to destroy other things
         free(admin);
+        return NULL;
+    }
+
+    admin->connections = celix_longHashMap_create();
+    status = celixThreadMutex_create(&admin->sendMutex, NULL);
+    if (status == CELIX_SUCCESS) {
+        status = celixThreadCondition_init(&admin->sendCond, NULL);
+        if (status != CELIX_SUCCESS) {
+            celixThreadMutex_destroy(&admin->sendMutex);
+        }
+    }
+    if (status != CELIX_SUCCESS || admin->connections == NULL) {
+        celix_longHashMap_destroy(admin->connections);
+        celixThreadRwlock_destroy(&admin->admin_lock);
+        free(admin);
+        return NULL;
     }
 
+    for (size_t i = 0; i < admin->nrOfSenderThreads; ++i) {
+        celixThread_create(&admin->senderThreads[i], NULL, websocketAdmin_sender, admin);
+        celixThread_setName(&admin->senderThreads[i], "WebsocketSender");
+    }
+
+    admin->broadcastSvc.handle = admin;
+    admin->broadcastSvc.broadcast = websocketAdmin_broadcast;
+    admin->broadcastSvc.getStatistics = websocketAdmin_getStatistics;
+    admin->broadcastSvcId = celix_bundleContext_registerService(context, &admin->broadcastSvc, WEBSOCKET_BROADCAST_SERVICE_NAME, NULL);
+
     return admin;
 }
 
 void websocketAdmin_destroy(websocket_admin_manager_t *admin) {
+    celix_bundleContext_unregisterService(admin->context, admin->broadcastSvcId);
+
+    celixThreadMutex_lock(&admin->sendMutex);
+    admin->stopSenders = true;
+    celixThreadCondition_broadcast(&admin->sendCond);
+    celixThreadMutex_unlock(&admin->sendMutex);
+    for (size_t i = 0; i < admin->nrOfSenderThreads; ++i) {
+        celixThread_join(admin->senderThreads[i], NULL);
+    }
+
+    //note the http server is already stopped, so all connections are closed
+    CELIX_LONG_HASH_MAP_ITERATE(admin->connections, iter) {
+        websocket_connection_t *conn = iter.value.ptrValue;
+        conn->closed = true;
+    }
+    while (celix_longHashMap_size(admin->connections) > 0) {
+        celix_long_hash_map_iterator_t iter = celix_longHashMap_begin(admin->connections);
+        websocketAdmin_removeConnection(admin, (const struct mg_connection *) iter.key);
+    }
+    celix_longHashMap_destroy(admin->connections);
+    celixThreadCondition_destroy(&admin->sendCond);
+    celixThreadMutex_destroy(&admin->sendMutex);
+
     celixThreadRwlock_writeLock(&(admin->admin_lock));
 
     //Destroy tree with services
@@ -156,6 +273,7 @@ void websocket_ready_handler(struct mg_connection *connection, void *handle) {
             if(sockSvc->ready != NULL) {
                 sockSvc->ready(connection, sockSvc->handle);
             }
+            websocketAdmin_addConnection(admin, connection, sockSvc);
         }
     }
 }
@@ -193,6 +311,9 @@ void websocket_close_handler(const struct mg_connection *connection, void *handl
         const char *req_uri = ri->request_uri;
         service_tree_node_t *node = NULL;
 
+        //Stop broadcasting to the connection before the connection is closed
+        websocketAdmin_removeConnection(admin, connection);
+
         celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
         node = findServiceNodeInTree(&admin->sock_svc_tree, req_uri);
 
@@ -206,3 +327,260 @@ void websocket_close_handler(const struct mg_connection *connection, void *handl
         }
     }
 }
+
+static bool websocketAdmin_releaseFrame(struct celix_ref *ref) {
+    websocket_frame_t *frame = (websocket_frame_t *) ref;
+    free(frame);
+    return true;
+}
+
+/**
+ * Encode a single (FIN) server websocket frame. Server frames are not masked (RFC 6455), so the encoded frame can be
+ * written as-is to every connection.
+ */
+static websocket_frame_t *websocketAdmin_createFrame(int opCode, const void *data, size_t length) {
+    unsigned char header[10];
+    size_t headerSize;
+    header[0] = (unsigned char) (0x80 | (opCode & 0x0f));
+    if (length < 126) {
+        header[1] = (unsigned char) length;
+        headerSize = 2;
+    } else if (length <= 0xFFFF) {
+        header[1] = 126;
+        header[2] = (unsigned char) (length >> 8);
+        header[3] = (unsigned char) length;
+        headerSize = 4;
+    } else {
+        header[1] = 127;
+        for (int i = 0; i < 8; ++i) {
+            header[2 + i] = (unsigned char) ((uint64_t) length >> (56 - 8 * i));
+        }
+        headerSize = 10;
+    }
+
+    websocket_frame_t *frame = malloc(sizeof(*frame) + headerSize + length);
+    if (frame != NULL) {
+        celix_ref_init(&frame->ref);
+        frame->size = headerSize + length;
+        memcpy(frame->data, header, headerSize);
+        if (length > 0) {
+            memcpy(frame->data + headerSize, data, length);
+        }
+    }
+    return frame;
+}
+
+static void websocketAdmin_addConnection(websocket_admin_manager_t *admin, struct mg_connection *connection, celix_websocket_service_t *svc) {
+    websocket_connection_t *conn = calloc(1, sizeof(*conn));
+    websocket_frame_t **queue = calloc(admin->sendQueueSize, sizeof(*queue));
+    if (conn == NULL || queue == NULL) {
+        celix_bundleContext_log(admin->context, CELIX_LOG_LEVEL_ERROR, "Cannot track websocket connection for broadcasting");
+        free(conn);
+        free(queue);
+        return;
+    }
+    conn->connection = connection;
+    conn->svc = svc;
+    conn->queue = queue;
+
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&admin->sendMutex);
+    if (celix_longHashMap_put(admin->connections, (long) connection, conn) != CELIX_SUCCESS) {
+        celix_bundleContext_log(admin->context, CELIX_LOG_LEVEL_ERROR, "Cannot track websocket connection for broadcasting");
+        free(conn->queue);
+        free(conn);
+    }
+}
+
+/**
+ * Remove the connection from the broadcast administration. Waits until no sender thread is writing to the connection.
+ */
+static void websocketAdmin_removeConnection(websocket_admin_manager_t *admin, const struct mg_connection *connection) {
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&admin->sendMutex);
+    websocket_connection_t *conn = celix_longHashMap_get(admin->connections, (long) connection);
+    if (conn == NULL) {
+        return;
+    }
+    celix_longHashMap_remove(admin->connections, (long) connection);
+    conn->closed = true;
+
+    if (conn->scheduled) {
+        websocket_connection_t *prev = NULL;
+        for (websocket_connection_t *it = admin->pendingHead; it != NULL; prev = it, it = it->nextPending) {
+            if (it == conn) {
+                if (prev == NULL) {
+                    admin->pendingHead = conn->nextPending;
+                } else {
+                    prev->nextPending = conn->nextPending;
+                }
+                if (admin->pendingTail == conn) {
+                    admin->pendingTail = prev;
+                }
+                break;
+            }
+        }
+    }
+    while (conn->writing) {
+        celixThreadCondition_wait(&admin->sendCond, &admin->sendMutex);
+    }
+
+    for (size_t i = 0; i < conn->queueCount; ++i) {
+        websocket_frame_t *frame = conn->queue[(conn->queueHead + i) % admin->sendQueueSize];
+        celix_ref_put(&frame->ref, websocketAdmin_releaseFrame);
+    }
+    free(conn->queue);
+    free(conn);
+}
+
+/**
+ * Add the connection to the tail of the pending connections. Should be called with the sendMutex locked.
+ */
+static void websocketAdmin_scheduleConnection(websocket_admin_manager_t *admin, websocket_connection_t *conn) {
+    conn->scheduled = true;
+    if (admin->pendingTail == NULL) {
+        admin->pendingHead = conn;
+    } else {
+        admin->pendingTail->nextPending = conn;
+    }
+    admin->pendingTail = conn;
+}
+
+/**
+ * Stop broadcasting to the connection and drop its queued frames. Should be called with the sendMutex locked.
+ */
+static void websocketAdmin_evictConnection(websocket_admin_manager_t *admin, websocket_connection_t *conn, double writeTime) {
+    conn->evicted = true;
+    for (size_t i = 0; i < conn->queueCount; ++i) {
+        websocket_frame_t *frame = conn->queue[(conn->queueHead + i) % admin->sendQueueSize];
+        celix_ref_put(&frame->ref, websocketAdmin_releaseFrame);
+    }
+    conn->framesDropped += conn->queueCount;
+    conn->queueCount = 0;
+    celix_bundleContext_log(admin->context, CELIX_LOG_LEVEL_WARNING,
+                            "Evicted websocket connection from broadcasting, write %s after %.3f seconds",
+                            writeTime > admin->maxWriteTime ? "too slow" : "failed", writeTime);
+}
+
+static void *websocketAdmin_sender(void *data) {
+    websocket_admin_manager_t *admin = data;
+    celixThreadMutex_lock(&admin->sendMutex);
+    while (!admin->stopSenders) {
+        websocket_connection_t *conn = admin->pendingHead;
+        if (conn == NULL) {
+            celixThreadCondition_wait(&admin->sendCond, &admin->sendMutex);
+            continue;
+        }
+        admin->pendingHead = conn->nextPending;
+        if (admin->pendingHead == NULL) {
+            admin->pendingTail = NULL;
+        }
+        conn->nextPending = NULL;
+        conn->scheduled = false;
+        conn->writing = true;
+
+        //write a bounded number of frames per turn, so connections with many queued frames are served round-robin.
+        //note mg_write blocks, a slow client occupies a sender thread at most until its write exceeds the max write
+        //time (or fails), after which the connection is evicted.
+        for (int i = 0; i < WEBSOCKET_ADMIN_MAX_FRAMES_PER_TURN && conn->queueCount > 0 && !conn->closed && !conn->evicted && !admin->stopSenders; ++i) {
+            websocket_frame_t *frame = conn->queue[conn->queueHead];
+            conn->queueHead = (conn->queueHead + 1) % admin->sendQueueSize;
+            conn->queueCount -= 1;
+            celixThreadMutex_unlock(&admin->sendMutex);
+
+            struct timespec start = celix_gettime(CLOCK_MONOTONIC);
+            mg_lock_connection(conn->connection);
+            int written = mg_write(conn->connection, frame->data, frame->size);
+            mg_unlock_connection(conn->connection);
+            double writeTime = celix_elapsedtime(CLOCK_MONOTONIC, start);
+            celix_ref_put(&frame->ref, websocketAdmin_releaseFrame);
+
+            celixThreadMutex_lock(&admin->sendMutex);
+            if (written == (int) frame->size) {
+                conn->framesSent += 1;
+            } else {
+                conn->writeErrors += 1;
+            }
+            if (written != (int) frame->size || writeTime > admin->maxWriteTime) {
+                websocketAdmin_evictConnection(admin, conn, writeTime);
+            }
+        }
+        conn->writing = false;
+        if (conn->queueCount > 0 && !conn->closed && !conn->evicted && !admin->stopSenders) {
+            websocketAdmin_scheduleConnection(admin, conn);
+        }
+        celixThreadCondition_broadcast(&admin->sendCond);
+    }
+    celixThreadMutex_unlock(&admin->sendMutex);
+    return NULL;
+}
+
+static celix_websocket_service_t *websocketAdmin_findService(websocket_admin_manager_t *admin, const char *uri) {
+    celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
+    service_tree_node_t *node = findServiceNodeInTree(&admin->sock_svc_tree, uri);
+    return node != NULL ? node->svc_data->service : NULL;
+}
+
+static int websocketAdmin_broadcast(void *handle, const char *uri, int opCode, const void *data, size_t length) {
+    websocket_admin_manager_t *admin = handle;
+    celix_websocket_service_t *svc = websocketAdmin_findService(admin, uri);
+    if (svc == NULL) {
+        return -1;
+    }
+    websocket_frame_t *frame = websocketAdmin_createFrame(opCode, data, length);
+    if (frame == NULL) {
+        celix_bundleContext_log(admin->context, CELIX_LOG_LEVEL_ERROR, "Cannot create websocket frame of %zu bytes", length);
+        return -1;
+    }
+
+    int queued = 0;
+    celixThreadMutex_lock(&admin->sendMutex);
+    CELIX_LONG_HASH_MAP_ITERATE(admin->connections, iter) {
+        websocket_connection_t *conn = iter.value.ptrValue;
+        if (conn->svc != svc || conn->closed || conn->evicted) {
+            continue;
+        }
+        if (conn->queueCount == admin->sendQueueSize) {
+            conn->framesDropped += 1;
+            continue;
+        }
+        celix_ref_get(&frame->ref);
+        conn->queue[(conn->queueHead + conn->queueCount) % admin->sendQueueSize] = frame;
+        conn->queueCount += 1;
+        conn->framesQueued += 1;
+        queued += 1;
+        if (!conn->scheduled && !conn->writing) {
+            websocketAdmin_scheduleConnection(admin, conn);
+        }
+    }
+    if (queued > 0) {
+        celixThreadCondition_broadcast(&admin->sendCond);
+    }
+    celixThreadMutex_unlock(&admin->sendMutex);
+
+    celix_ref_put(&frame->ref, websocketAdmin_releaseFrame);
+    return queued;
+}
+
+static int websocketAdmin_getStatistics(void *handle, const char *uri, celix_websocket_broadcast_statistics_t *stats) {
+    websocket_admin_manager_t *admin = handle;
+    celix_websocket_service_t *svc = websocketAdmin_findService(admin, uri);
+    if (svc == NULL) {
+        return -1;
+    }
+    memset(stats, 0, sizeof(*stats));
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&admin->sendMutex);
+    CELIX_LONG_HASH_MAP_ITERATE(admin->connections, iter) {
+        websocket_connection_t *conn = iter.value.ptrValue;
+        if (conn->svc != svc) {
+            continue;
+        }
+        stats->nrOfConnections += 1;
+        stats->nrOfSlowConsumers += conn->framesDropped > 0 ? 1 : 0;
+        stats->nrOfEvictedConnections += conn->evicted ? 1 : 0;
+        stats->maxQueuedFrames = conn->queueCount > stats->maxQueuedFrames ? conn->queueCount : stats->maxQueuedFrames;
+        stats->framesQueued += conn->framesQueued;
+        stats->framesSent += conn->framesSent;
+        stats->framesDropped += conn->framesDropped;
+        stats->writeErrors += conn->writeErrors;
+    }
+    return 0;
+}
@@ -29,6 +29,8 @@
 
 #include "http_admin_service.h"
 #include "http_admin_info_service.h"
+#include "http_admin_streaming_service.h"
 #include "websocket_admin_service.h"
+#include "websocket_broadcast_service.h"
 
 #endif //HTTP_ADMIN_API_H
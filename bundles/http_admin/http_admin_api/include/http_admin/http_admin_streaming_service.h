@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_HTTP_ADMIN_STREAMING_SERVICE_H
+#define CELIX_HTTP_ADMIN_STREAMING_SERVICE_H
+
+#include <stdlib.h>
+#include "civetweb.h"
+
+/**
+ * @brief Name of the streaming HTTP service.
+ *
+ * A streaming HTTP service is registered with the same "uri" property (HTTP_ADMIN_URI) as a celix_http_service_t.
+ * A celix_http_service_t and a celix_http_streaming_service_t can be registered for the same URI; for POST, PUT and
+ * PATCH requests the streaming service is used if it implements the request method.
+ */
+#define HTTP_ADMIN_STREAMING_SERVICE_NAME "http_admin_streaming_service"
+
+/**
+ * @brief The body of a HTTP request, which can be consumed incrementally.
+ *
+ * The request body is not buffered by the HTTP admin, so the memory usage is independent of the body size.
+ * The body can only be consumed once and is only valid during the service call.
+ */
+typedef struct celix_http_request_body {
+    void *handle;
+
+    /**
+     * The Content-Length of the request or -1 if the length is unknown (e.g. for chunked transfer encoding).
+     */
+    long long contentLength;
+
+    /*
+     * Reads up to length bytes of the request body into the provided buffer.
+     *
+     * Returns the number of bytes read, 0 if the complete body is read or a negative value on error.
+     */
+    int (*read)(void *handle, void *buffer, size_t length);
+
+    /*
+     * Reads the remaining request body in chunks and calls the provided callback for every chunk.
+     * The chunk pointer is only valid during the callback call.
+     * If the callback returns a non-zero value, reading is stopped and the callback return value is returned.
+     *
+     * Returns 0 if the complete body is read, a negative value on read error or the non-zero callback return value.
+     */
+    int (*readChunks)(void *handle, void *callbackData, int (*chunkCallback)(void *callbackData, const char *chunk, size_t length));
+} celix_http_request_body_t;
+
+struct celix_http_streaming_service {
+    void *handle;
+
+    /*
+     * Implementation of POST HTTP request with a streamed request body.
+     * The response can be written incrementally on the connection (e.g. using mg_send_chunk).
+     *
+     * Returns HTTP status code.
+     */
+    int (*doPost)(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
+
+    /*
+     * Implementation of PUT HTTP request with a streamed request body.
+     * The response can be written incrementally on the connection (e.g. using mg_send_chunk).
+     *
+     * Returns HTTP status code.
+     */
+    int (*doPut)(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
+
+    /*
+     * Implementation of PATCH HTTP request with a streamed request body.
+     * The response can be written incrementally on the connection (e.g. using mg_send_chunk).
+     *
+     * Returns HTTP status code.
+     */
+    int (*doPatch)(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
+};
+
+typedef struct celix_http_streaming_service celix_http_streaming_service_t;
+
+#endif //CELIX_HTTP_ADMIN_STREAMING_SERVICE_H
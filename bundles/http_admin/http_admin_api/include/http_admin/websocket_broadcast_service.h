@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_WEBSOCKET_BROADCAST_SERVICE_H
+#define CELIX_WEBSOCKET_BROADCAST_SERVICE_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Name of the websocket broadcast service, provided by the HTTP admin if websockets are enabled.
+ */
+#define WEBSOCKET_BROADCAST_SERVICE_NAME "websocket_broadcast_service"
+
+/**
+ * @brief Statistics of the websocket connections of a single websocket service.
+ *
+ * Counters are accumulated over the currently open connections.
+ */
+typedef struct celix_websocket_broadcast_statistics {
+    size_t nrOfConnections;         //number of open connections
+    size_t nrOfSlowConsumers;       //number of open connections for which frames have been dropped
+    size_t nrOfEvictedConnections;  //number of open connections no longer broadcast to, because a write failed or was too slow
+    size_t maxQueuedFrames;         //the highest number of frames currently queued for a single connection
+    unsigned long framesQueued;     //number of frames queued for sending
+    unsigned long framesSent;       //number of frames written to the connections
+    unsigned long framesDropped;    //number of frames dropped because the send queue of a connection was full or the connection was evicted
+    unsigned long writeErrors;      //number of frames for which writing to the connection failed
+} celix_websocket_broadcast_statistics_t;
+
+struct celix_websocket_broadcast_service {
+    void *handle;
+
+    /*
+     * Broadcast a websocket message to all open connections of the websocket service registered for the given URI.
+     *
+     * The websocket frame is encoded once and queued (by reference) in the bounded send queue of every connection.
+     * Frames are written to the connections by the websocket admin sender threads, so this call does not block on
+     * slow clients. If the send queue of a connection is full, the frame is dropped for that connection.
+     * A connection for which a write fails or takes longer than the configured max write time is evicted: its queued
+     * frames are dropped and no broadcast messages are sent to it anymore.
+     *
+     * Returns the number of connections the frame is queued for, or -1 if no websocket service is registered for the
+     * URI or the frame could not be created.
+     */
+    int (*broadcast)(void *handle, const char *uri, int opCode, const void *data, size_t length);
+
+    /*
+     * Get the broadcast statistics for the websocket service registered for the given URI.
+     *
+     * Returns 0 on success or -1 if no websocket service is registered for the URI.
+     */
+    int (*getStatistics)(void *handle, const char *uri, celix_websocket_broadcast_statistics_t *stats);
+};
+
+typedef struct celix_websocket_broadcast_service celix_websocket_broadcast_service_t;
+
+#endif //CELIX_WEBSOCKET_BROADCAST_SERVICE_H
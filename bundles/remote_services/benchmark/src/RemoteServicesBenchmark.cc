@@ -0,0 +1,382 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+#include "celix/FrameworkFactory.h"
+#include "celix_constants.h"
+#include "calculator_service.h"
+#include "calculator_json_rpc_stub.h"
+#include "remote_example.h"
+#include "remote_constants.h"
+#include "remote_service_admin.h"
+#include "endpoint_description.h"
+
+namespace {
+    std::atomic<size_t> allocationCount{0};
+}
+
+#ifdef RSA_BENCHMARK_COUNT_ALLOCATIONS
+/*
+ * Counts the allocations of the whole process by replacing the glibc malloc entry points.
+ * Note that the server and client framework run in the same process, so the allocations of both sides of a
+ * remote call are counted.
+ */
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t nmemb, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+
+    void* malloc(size_t size) noexcept {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t nmemb, size_t size) noexcept {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        return __libc_calloc(nmemb, size);
+    }
+
+    void* realloc(void* ptr, size_t size) noexcept {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        return __libc_realloc(ptr, size);
+    }
+}
+#endif
+
+enum class RsaTransport {
+    SHM, //rsa_shm + rsa_json_rpc
+    DFI, //remote_service_admin_dfi, http over loopback
+};
+
+/**
+ * Benchmark to measure remote service calls between two in-process Celix frameworks.
+ *
+ * The server framework exports the calculator and remote example services and the client framework imports them,
+ * using the remote service admin services directly (i.e. without discovery and topology manager).
+ *
+ * The calculator service is registered by the server framework bundle, so that the JSON-RPC stubs of the calculator
+ * can be registered on both sides (see rsaJsonRpcStub_register) to compare the generated stubs with the libffi path.
+ */
+class RemoteServicesBenchmark {
+public:
+    explicit RemoteServicesBenchmark(RsaTransport transport, bool jsonRpcStubs = false) :
+            serverFw{createFw(transport, true)},
+            clientFw{createFw(transport, false)} {
+        auto serverCtx = serverFw->getFrameworkBundleContext();
+        auto clientCtx = clientFw->getFrameworkBundleContext();
+        if (jsonRpcStubs) {
+            if (rsaJsonRpcStub_register(serverCtx->getCBundleContext(), &calculator_jsonRpcStubDefinition, &serverStub) != CELIX_SUCCESS ||
+                rsaJsonRpcStub_register(clientCtx->getCBundleContext(), &calculator_jsonRpcStubDefinition, &clientStub) != CELIX_SUCCESS) {
+                error = "cannot register calculator stubs";
+            }
+        }
+        calcSvc.handle = nullptr;
+        calcSvc.add = [](void*, double a, double b, double* result) -> int { *result = a + b; return CELIX_SUCCESS; };
+        calcSvc.sub = [](void*, double a, double b, double* result) -> int { *result = a - b; return CELIX_SUCCESS; };
+        calcSvc.sqrt = [](void*, double a, double* result) -> int { *result = std::sqrt(a); return CELIX_SUCCESS; };
+        calcRegistration = serverCtx->registerUnmanagedService<calculator_service_t>(&calcSvc, CALCULATOR_SERVICE)
+                .setVersion(CALCULATOR_SERVICE_VERSION)
+                .addProperty(OSGI_RSA_SERVICE_EXPORTED_INTERFACES, CALCULATOR_SERVICE)
+                .addProperty(OSGI_RSA_SERVICE_EXPORTED_CONFIGS, CALCULATOR_CONFIGURATION_TYPE)
+                .build();
+        serverCtx->installBundle(REMOTE_EXAMPLE_BUNDLE);
+        serverCtx->waitForEvents();
+
+        calcTracker = clientCtx->trackServices<calculator_service_t>(CALCULATOR_SERVICE).build();
+        remoteExampleTracker = clientCtx->trackServices<remote_example_t>(REMOTE_EXAMPLE_NAME).build();
+
+        importService(exportService(CALCULATOR_SERVICE));
+        importService(exportService(REMOTE_EXAMPLE_NAME));
+
+        calc = waitForService(calcTracker);
+        remoteExample = waitForService(remoteExampleTracker);
+        if (error.empty() && (!calc || !remoteExample)) {
+            error = "imported services not available";
+        }
+    }
+
+    ~RemoteServicesBenchmark() {
+        calc = nullptr;
+        remoteExample = nullptr;
+        calcTracker->close();
+        remoteExampleTracker->close();
+        useRsa(clientFw, [this](remote_service_admin_service_t& rsa) {
+            for (auto* reg : importRegistrations) {
+                rsa.importRegistration_close(rsa.admin, reg);
+            }
+        });
+        clientFw->getFrameworkBundleContext()->waitForEvents();
+        for (auto* endpoint : endpoints) {
+            endpointDescription_destroy(endpoint);
+        }
+        useRsa(serverFw, [this](remote_service_admin_service_t& rsa) {
+            for (auto* reg : exportRegistrations) {
+                rsa.exportRegistration_close(rsa.admin, reg);
+            }
+        });
+        calcRegistration->unregister();
+        rsaJsonRpcStub_unregister(clientStub);
+        rsaJsonRpcStub_unregister(serverStub);
+    }
+
+    RemoteServicesBenchmark(const RemoteServicesBenchmark&) = delete;
+    RemoteServicesBenchmark& operator=(const RemoteServicesBenchmark&) = delete;
+
+    static std::shared_ptr<celix::Framework> createFw(RsaTransport transport, bool server) {
+        celix::Properties config{};
+        config.set(CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, true);
+        config.set(CELIX_FRAMEWORK_CACHE_DIR, server ? ".rsa_benchmark_server_cache" : ".rsa_benchmark_client_cache");
+        config.set("CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "error");
+        //note the client framework is the requesting bundle of the proxies, so it needs the interface descriptors
+        config.set("CELIX_FRAMEWORK_EXTENDER_PATH", RSA_BENCHMARK_DESCRIPTOR_DIR);
+        config.set("RSA_PORT", server ? 50893L : 50894L);
+        config.set("CELIX_RSA_BIND_ON_ALL_INTERFACES", false);
+        config.set("rsaShmPoolSize", 16L * 1024L * 1024L); //room for the 1 MB payloads (and replies) in flight
+        auto fw = celix::createFramework(config);
+        auto ctx = fw->getFrameworkBundleContext();
+        if (transport == RsaTransport::SHM) {
+            ctx->installBundle(RSA_JSON_RPC_BUNDLE);
+            ctx->installBundle(RSA_SHM_BUNDLE);
+        } else {
+            ctx->installBundle(RSA_DFI_BUNDLE);
+        }
+        ctx->waitForEvents();
+        return fw;
+    }
+
+    const std::shared_ptr<celix::Framework> serverFw;
+    const std::shared_ptr<celix::Framework> clientFw;
+    std::string error{};
+    std::shared_ptr<calculator_service_t> calc{};
+    std::shared_ptr<remote_example_t> remoteExample{};
+
+private:
+    static void useRsa(const std::shared_ptr<celix::Framework>& fw, const std::function<void(remote_service_admin_service_t&)>& cb) {
+        fw->getFrameworkBundleContext()->useService<remote_service_admin_service_t>(OSGI_RSA_REMOTE_SERVICE_ADMIN)
+                .setTimeout(std::chrono::seconds{5})
+                .addUseCallback(cb)
+                .build();
+    }
+
+    endpoint_description_t* exportService(const char* serviceName) {
+        long svcId = serverFw->getFrameworkBundleContext()->findServiceWithName(serviceName);
+        if (svcId < 0) {
+            error = std::string{"service "} + serviceName + " not found";
+            return nullptr;
+        }
+        std::string strSvcId = std::to_string(svcId);
+        endpoint_description_t* endpoint = nullptr;
+        useRsa(serverFw, [&](remote_service_admin_service_t& rsa) {
+            celix_array_list_t* registrations = nullptr;
+            celix_status_t status = rsa.exportService(rsa.admin, strSvcId.data(), nullptr, &registrations);
+            if (status != CELIX_SUCCESS || celix_arrayList_size(registrations) == 0) {
+                celix_arrayList_destroy(registrations);
+                return;
+            }
+            auto* reg = static_cast<export_registration_t*>(celix_arrayList_get(registrations, 0));
+            celix_arrayList_destroy(registrations);
+            exportRegistrations.push_back(reg);
+
+            export_reference_t* ref = nullptr;
+            endpoint_description_t* exported = nullptr;
+            status = rsa.exportRegistration_getExportReference(reg, &ref);
+            if (status == CELIX_SUCCESS) {
+                status = rsa.exportReference_getExportedEndpoint(ref, &exported);
+            }
+            free(ref);
+            if (status == CELIX_SUCCESS) {
+                endpoint = endpointDescription_clone(exported);
+            }
+        });
+        if (endpoint == nullptr) {
+            error = std::string{"cannot export "} + serviceName;
+            return nullptr;
+        }
+        endpoints.push_back(endpoint);
+        return endpoint;
+    }
+
+    void importService(endpoint_description_t* endpoint) {
+        if (endpoint == nullptr) {
+            return;
+        }
+        useRsa(clientFw, [&](remote_service_admin_service_t& rsa) {
+            import_registration_t* reg = nullptr;
+            celix_status_t status = rsa.importService(rsa.admin, endpoint, &reg);
+            if (status == CELIX_SUCCESS && reg != nullptr) {
+                importRegistrations.push_back(reg);
+            } else {
+                error = std::string{"cannot import "} + endpoint->serviceName;
+            }
+        });
+    }
+
+    template<typename I>
+    std::shared_ptr<I> waitForService(const std::shared_ptr<celix::ServiceTracker<I>>& tracker) {
+        auto ctx = clientFw->getFrameworkBundleContext();
+        auto svc = tracker->getHighestRankingService();
+        for (int retries = 0; !svc && error.empty() && retries < 50; ++retries) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            ctx->waitForEvents();
+            svc = tracker->getHighestRankingService();
+        }
+        return svc;
+    }
+
+    calculator_service_t calcSvc{};
+    std::shared_ptr<celix::ServiceRegistration> calcRegistration{};
+    rsa_json_rpc_stub_t* serverStub{nullptr};
+    rsa_json_rpc_stub_t* clientStub{nullptr};
+    std::shared_ptr<celix::ServiceTracker<calculator_service_t>> calcTracker{};
+    std::shared_ptr<celix::ServiceTracker<remote_example_t>> remoteExampleTracker{};
+    std::vector<export_registration_t*> exportRegistrations{};
+    std::vector<import_registration_t*> importRegistrations{};
+    std::vector<endpoint_description_t*> endpoints{};
+};
+
+/**
+ * Times a single remote call and records its latency (in us).
+ */
+template<typename Call>
+static bool timedCall(std::vector<double>& latencies, Call&& call) {
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = call();
+    auto end = std::chrono::steady_clock::now();
+    latencies.push_back(std::chrono::duration<double, std::micro>{end - begin}.count());
+    return ok;
+}
+
+static void reportCallStatistics(benchmark::State& state, std::vector<double>& latencies, size_t allocations) {
+    state.SetItemsProcessed(state.iterations()); //items_per_second is the number of calls per second
+    if (latencies.empty()) {
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        auto index = std::min(latencies.size() - 1, static_cast<size_t>(p * static_cast<double>(latencies.size())));
+        return latencies[index];
+    };
+    state.counters["p50_us"] = percentile(0.50);
+    state.counters["p99_us"] = percentile(0.99);
+#ifdef RSA_BENCHMARK_COUNT_ALLOCATIONS
+    state.counters["allocs_per_call"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+#else
+    (void)allocations;
+#endif
+}
+
+static void callCalculator(benchmark::State& state, RsaTransport transport, bool jsonRpcStubs = false) {
+    RemoteServicesBenchmark benchmark{transport, jsonRpcStubs};
+    if (!benchmark.error.empty()) {
+        state.SkipWithError(benchmark.error.c_str());
+        return;
+    }
+    auto* calc = benchmark.calc.get();
+    std::vector<double> latencies{};
+    latencies.reserve(state.max_iterations);
+
+    size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        // This code gets timed
+        double result = 0.0;
+        bool ok = timedCall(latencies, [&]() {
+            return calc->add(calc->handle, 1.0, 2.0, &result) == CELIX_SUCCESS && result == 3.0;
+        });
+        if (!ok) {
+            state.SkipWithError("calculator add failed");
+            break;
+        }
+    }
+    size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    reportCallStatistics(state, latencies, allocations);
+}
+
+static void callRemoteExampleWithPayload(benchmark::State& state, RsaTransport transport) {
+    RemoteServicesBenchmark benchmark{transport};
+    if (!benchmark.error.empty()) {
+        state.SkipWithError(benchmark.error.c_str());
+        return;
+    }
+    auto* remoteExample = benchmark.remoteExample.get();
+    auto payloadSize = static_cast<size_t>(state.range(0));
+    std::string payload(payloadSize, 'A');
+    std::vector<double> latencies{};
+    latencies.reserve(state.max_iterations);
+
+    size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        // This code gets timed
+        bool ok = timedCall(latencies, [&]() {
+            char* result = nullptr;
+            int rc = remoteExample->setName2(remoteExample->handle, payload.c_str(), &result);
+            bool echoed = rc == CELIX_SUCCESS && result != nullptr && strlen(result) == payloadSize;
+            free(result);
+            return echoed;
+        });
+        if (!ok) {
+            state.SkipWithError("remote example setName2 failed");
+            break;
+        }
+    }
+    size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(payloadSize) * 2); //payload is send and returned
+    reportCallStatistics(state, latencies, allocations);
+}
+
+static void RemoteServicesBenchmark_shmCalculatorAdd(benchmark::State& state) {
+    callCalculator(state, RsaTransport::SHM);
+}
+
+static void RemoteServicesBenchmark_shmStubsCalculatorAdd(benchmark::State& state) {
+    callCalculator(state, RsaTransport::SHM, true);
+}
+
+static void RemoteServicesBenchmark_dfiCalculatorAdd(benchmark::State& state) {
+    callCalculator(state, RsaTransport::DFI);
+}
+
+static void RemoteServicesBenchmark_shmStringPayload(benchmark::State& state) {
+    callRemoteExampleWithPayload(state, RsaTransport::SHM);
+}
+
+static void RemoteServicesBenchmark_dfiStringPayload(benchmark::State& state) {
+    callRemoteExampleWithPayload(state, RsaTransport::DFI);
+}
+
+#define CELIX_RSA_BENCHMARK(name) \
+    BENCHMARK(name)->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_RSA_BENCHMARK(RemoteServicesBenchmark_shmCalculatorAdd);
+CELIX_RSA_BENCHMARK(RemoteServicesBenchmark_shmStubsCalculatorAdd);
+CELIX_RSA_BENCHMARK(RemoteServicesBenchmark_dfiCalculatorAdd);
+
+CELIX_RSA_BENCHMARK(RemoteServicesBenchmark_shmStringPayload)->RangeMultiplier(32)->Range(1, 1024 * 1024);
+CELIX_RSA_BENCHMARK(RemoteServicesBenchmark_dfiStringPayload)->RangeMultiplier(32)->Range(1, 1024 * 1024);
@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 
 #include <curl/curl.h>
@@ -47,9 +48,19 @@
 #define DISCOVERY_POLL_TIMEOUT "DISCOVERY_CFG_POLL_TIMEOUT"
 #define DEFAULT_POLL_TIMEOUT "10" // seconds
 
+#define HTTP_STATUS_NOT_MODIFIED 304L
+
+/**
+ * The state of a polled discovery url.
+ */
+typedef struct endpoint_discovery_poller_entry {
+	array_list_pt endpoints; // the endpoints discovered at the url
+	char *etag; // the ETag of the last successfully processed endpoints document or NULL
+} endpoint_discovery_poller_entry_t;
+
 static void *endpointDiscoveryPoller_performPeriodicPoll(void *data);
-celix_status_t endpointDiscoveryPoller_poll(endpoint_discovery_poller_t *poller, char *url, array_list_pt currentEndpoints);
-static celix_status_t endpointDiscoveryPoller_getEndpoints(endpoint_discovery_poller_t *poller, char *url, array_list_pt *updatedEndpoints);
+celix_status_t endpointDiscoveryPoller_poll(endpoint_discovery_poller_t *poller, char *url, endpoint_discovery_poller_entry_t *entry);
+static celix_status_t endpointDiscoveryPoller_getEndpoints(endpoint_discovery_poller_t *poller, char *url, const char *etag, bool *notModified, char **updatedETag, array_list_pt *updatedEndpoints);
 static celix_status_t endpointDiscoveryPoller_endpointDescriptionEquals(const void *endpointPtr, const void *comparePtr, bool *equals);
 
 /**
@@ -192,14 +203,20 @@ celix_status_t endpointDiscoveryPoller_addDiscoveryEndpoint(endpoint_discovery_p
 	}
 
 	// Avoid memory leaks when adding an already existing URL...
-	array_list_pt endpoints = hashMap_get(poller->entries, url);
-	if (endpoints == NULL) {
-		status = arrayList_createWithEquals(endpointDiscoveryPoller_endpointDescriptionEquals, &endpoints);
+	endpoint_discovery_poller_entry_t *entry = hashMap_get(poller->entries, url);
+	if (entry == NULL) {
+		entry = calloc(1, sizeof(*entry));
+		status = entry != NULL ? CELIX_SUCCESS : CELIX_ENOMEM;
+		if (status == CELIX_SUCCESS) {
+			status = arrayList_createWithEquals(endpointDiscoveryPoller_endpointDescriptionEquals, &entry->endpoints);
+		}
 
 		if (status == CELIX_SUCCESS) {
             celix_logHelper_debug(*poller->loghelper, "ENDPOINT_POLLER: add new discovery endpoint with url %s", url);
-			hashMap_put(poller->entries, strdup(url), endpoints);
-			endpointDiscoveryPoller_poll(poller, url, endpoints);
+			hashMap_put(poller->entries, strdup(url), entry);
+			endpointDiscoveryPoller_poll(poller, url, entry);
+		} else {
+			free(entry);
 		}
 	}
 
@@ -226,9 +243,10 @@ celix_status_t endpointDiscoveryPoller_removeDiscoveryEndpoint(endpoint_discover
 
             celix_logHelper_debug(*poller->loghelper, "ENDPOINT_POLLER: remove discovery endpoint with url %s", url);
 
-			array_list_pt entries = hashMap_remove(poller->entries, url);
+			endpoint_discovery_poller_entry_t *pollerEntry = hashMap_remove(poller->entries, url);
 
-			if (entries != NULL) {
+			if (pollerEntry != NULL) {
+				array_list_pt entries = pollerEntry->endpoints;
 				for (unsigned int i = arrayList_size(entries); i > 0; i--) {
 					endpoint_description_t *endpoint = arrayList_get(entries, i - 1);
 					discovery_removeDiscoveredEndpoint(poller->discovery, endpoint);
@@ -236,6 +254,8 @@ celix_status_t endpointDiscoveryPoller_removeDiscoveryEndpoint(endpoint_discover
 					endpointDescription_destroy(endpoint);
 				}
 				arrayList_destroy(entries);
+				free(pollerEntry->etag);
+				free(pollerEntry);
 			}
 
 			free(origKey);
@@ -249,15 +269,23 @@ celix_status_t endpointDiscoveryPoller_removeDiscoveryEndpoint(endpoint_discover
 
 
 
-celix_status_t endpointDiscoveryPoller_poll(endpoint_discovery_poller_t *poller, char *url, array_list_pt currentEndpoints) {
+celix_status_t endpointDiscoveryPoller_poll(endpoint_discovery_poller_t *poller, char *url, endpoint_discovery_poller_entry_t *entry) {
 	celix_status_t status;
+	array_list_pt currentEndpoints = entry->endpoints;
 	array_list_pt updatedEndpoints = NULL;
+	bool notModified = false;
+	char *updatedETag = NULL;
 
 	// create an arraylist with a custom equality test to ensure we can find endpoints properly...
 	arrayList_createWithEquals(endpointDiscoveryPoller_endpointDescriptionEquals, &updatedEndpoints);
-	status = endpointDiscoveryPoller_getEndpoints(poller, url, &updatedEndpoints);
+	status = endpointDiscoveryPoller_getEndpoints(poller, url, entry->etag, &notModified, &updatedETag, &updatedEndpoints);
+
+	if (status == CELIX_SUCCESS && !notModified) {
+		// remember the ETag, so that the next poll only gets the endpoints document if it changed
+		free(entry->etag);
+		entry->etag = updatedETag;
+		updatedETag = NULL;
 
-	if (status == CELIX_SUCCESS) {
 		if (updatedEndpoints != NULL) {
 			for (unsigned int i = arrayList_size(currentEndpoints); i > 0; i--) {
 				endpoint_description_t *endpoint = arrayList_get(currentEndpoints, i - 1);
@@ -286,6 +314,7 @@ celix_status_t endpointDiscoveryPoller_poll(endpoint_discovery_poller_t *poller,
 	if (updatedEndpoints != NULL) {
 		arrayList_destroy(updatedEndpoints);
 	}
+	free(updatedETag);
 
 	return status;
 }
@@ -308,9 +337,9 @@ static void *endpointDiscoveryPoller_performPeriodicPoll(void *data) {
 				hash_map_entry_pt entry = hashMapIterator_nextEntry(iterator);
 
 				char *url = hashMapEntry_getKey(entry);
-				array_list_pt currentEndpoints = hashMapEntry_getValue(entry);
+				endpoint_discovery_poller_entry_t *pollerEntry = hashMapEntry_getValue(entry);
 
-				endpointDiscoveryPoller_poll(poller, url, currentEndpoints);
+				endpointDiscoveryPoller_poll(poller, url, pollerEntry);
 			}
 
 			hashMapIterator_destroy(iterator);
@@ -349,34 +378,82 @@ static size_t endpointDiscoveryPoller_writeMemory(void *contents, size_t size, s
 	return realsize;
 }
 
-static celix_status_t endpointDiscoveryPoller_getEndpoints(endpoint_discovery_poller_t *poller, char *url, array_list_pt *updatedEndpoints) {
+/**
+ * Stores the value of the ETag response header (if present) in etagPtr.
+ */
+static size_t endpointDiscoveryPoller_writeHeader(char *header, size_t size, size_t nmemb, void *etagPtr) {
+	size_t realsize = size * nmemb;
+	char **etag = etagPtr;
+	const char etagHeader[] = "ETag:";
+	size_t etagHeaderLen = sizeof(etagHeader) - 1;
+
+	if (realsize > etagHeaderLen && strncasecmp(header, etagHeader, etagHeaderLen) == 0) {
+		size_t begin = etagHeaderLen;
+		size_t end = realsize;
+		while (begin < end && (header[begin] == ' ' || header[begin] == '\t')) {
+			begin++;
+		}
+		while (end > begin && (header[end - 1] == '\r' || header[end - 1] == '\n' || header[end - 1] == ' ')) {
+			end--;
+		}
+		free(*etag);
+		*etag = strndup(header + begin, end - begin);
+	}
+
+	return realsize;
+}
+
+static celix_status_t endpointDiscoveryPoller_getEndpoints(endpoint_discovery_poller_t *poller, char *url, const char *etag, bool *notModified, char **updatedETag, array_list_pt *updatedEndpoints) {
 	celix_status_t status = CELIX_SUCCESS;
 
 
 	CURL *curl = NULL;
 	CURLcode res = CURLE_OK;
+	long responseCode = 0;
+	struct curl_slist *headers = NULL;
 
 	struct MemoryStruct chunk;
 	chunk.memory = malloc(1);
 	chunk.size = 0;
 
+	*notModified = false;
+	*updatedETag = NULL;
+
 	curl = curl_easy_init();
 	if (!curl) {
 		status = CELIX_ILLEGAL_STATE;
 	} else {
+		if (etag != NULL) {
+			char *ifNoneMatch = NULL;
+			if (asprintf(&ifNoneMatch, "If-None-Match: %s", etag) >= 0) {
+				headers = curl_slist_append(headers, ifNoneMatch);
+				free(ifNoneMatch);
+			}
+		}
+
 		curl_easy_setopt(curl, CURLOPT_URL, url);
 		curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
 		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, endpointDiscoveryPoller_writeMemory);
 		curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&chunk);
+		curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, endpointDiscoveryPoller_writeHeader);
+		curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void *)updatedETag);
+		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 		curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
 		curl_easy_setopt(curl, CURLOPT_TIMEOUT, poller->poll_timeout);
 		res = curl_easy_perform(curl);
+		if (res == CURLE_OK) {
+			curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+		}
 
 		curl_easy_cleanup(curl);
+		curl_slist_free_all(headers);
 	}
 
 	// process endpoints file
-	if (res == CURLE_OK) {
+	if (res == CURLE_OK && responseCode == HTTP_STATUS_NOT_MODIFIED) {
+		// endpoints did not change since the last processed endpoints document
+		*notModified = true;
+	} else if (res == CURLE_OK) {
 		endpoint_descriptor_reader_t *reader = NULL;
 
 		status = endpointDescriptorReader_create(poller, &reader);
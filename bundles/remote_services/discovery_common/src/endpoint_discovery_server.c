@@ -25,6 +25,7 @@
 #include <ifaddrs.h>
 #endif
 #include "civetweb.h"
+#include "celix_constants.h"
 #include "celix_errno.h"
 #include "celix_utils.h"
 #include "utils.h"
@@ -39,18 +40,41 @@
 #define CIVETWEB_REQUEST_NOT_HANDLED 0
 #define CIVETWEB_REQUEST_HANDLED 1
 
+#define MAX_ETAG_LENGTH 128
+
+// process-wide counter of created servers, so that a server restarted in the same framework gets a new ETag
+static unsigned long endpointDiscoveryServer_instanceCounter = 0;
+
 static const char *response_headers =
         "HTTP/1.1 200 OK\r\n"
         "Cache: no-cache\r\n"
         "Content-Type: application/xml;charset=utf-8\r\n"
         "\r\n";
 
+static const char *all_endpoints_response_headers_format =
+        "HTTP/1.1 200 OK\r\n"
+        "Cache: no-cache\r\n"
+        "Content-Type: application/xml;charset=utf-8\r\n"
+        "Content-Length: %zu\r\n"
+        "ETag: %s\r\n"
+        "\r\n";
+
+static const char *not_modified_response_headers_format =
+        "HTTP/1.1 304 Not Modified\r\n"
+        "ETag: %s\r\n"
+        "\r\n";
+
 struct endpoint_discovery_server {
     celix_log_helper_t **loghelper;
     hash_map_pt entries; // key = endpointId, value = endpoint_descriptor_pt
 
     celix_thread_mutex_t serverLock;
 
+    char *instanceId; // framework uuid + instance counter, used in the ETag to differentiate between restarted servers
+    unsigned long version; // incremented when the exposed endpoints change, protected by serverLock
+    unsigned long cachedDocumentVersion; // protected by serverLock
+    char *cachedDocument; // the XML document with all exposed endpoints, protected by serverLock
+
     const char *path;
     const char *port;
     const char *ip;
@@ -87,6 +111,16 @@ celix_status_t endpointDiscoveryServer_create(discovery_t *discovery,
     }
 
     (*server)->loghelper = &discovery->loghelper;
+    (*server)->version = 1;
+    (*server)->cachedDocumentVersion = 0;
+    (*server)->cachedDocument = NULL;
+
+    const char *fwUuid = celix_bundleContext_getProperty(context, CELIX_FRAMEWORK_UUID, "");
+    unsigned long instanceNr = __atomic_add_fetch(&endpointDiscoveryServer_instanceCounter, 1, __ATOMIC_RELAXED);
+    if (asprintf(&(*server)->instanceId, "%s-%lu", fwUuid, instanceNr) < 0) {
+        return CELIX_ENOMEM;
+    }
+
     (*server)->entries = hashMap_create(&utils_stringHash, NULL, &utils_stringEquals, NULL);
     if (!(*server)->entries) {
         return CELIX_ENOMEM;
@@ -227,6 +261,7 @@ celix_status_t endpointDiscoveryServer_destroy(endpoint_discovery_server_t *serv
     status = celixThreadMutex_lock(&server->serverLock);
 
     hashMap_destroy(server->entries, true /* freeKeys */, false /* freeValues */);
+    free(server->cachedDocument);
 
     status = celixThreadMutex_unlock(&server->serverLock);
     status = celixThreadMutex_destroy(&server->serverLock);
@@ -234,6 +269,7 @@ celix_status_t endpointDiscoveryServer_destroy(endpoint_discovery_server_t *serv
     free((void*) server->path);
     free((void*) server->port);
     free((void*) server->ip);
+    free(server->instanceId);
 
     free(server);
 
@@ -255,6 +291,9 @@ celix_status_t endpointDiscoveryServer_addEndpoint(endpoint_discovery_server_t *
         celix_logHelper_info(*server->loghelper, "exposing new endpoint \"%s\"...", endpointId);
 
         hashMap_put(server->entries, endpointId, endpoint);
+        server->version += 1;
+    } else {
+        free(endpointId);
     }
 
     status = celixThreadMutex_unlock(&server->serverLock);
@@ -280,6 +319,7 @@ celix_status_t endpointDiscoveryServer_removeEndpoint(endpoint_discovery_server_
         celix_logHelper_info(*server->loghelper, "removing endpoint \"%s\"...\n", key);
 
         hashMap_remove(server->entries, key);
+        server->version += 1;
 
         // we've made this key, see _addEndpoint above...
         free((void*) key);
@@ -356,20 +396,70 @@ static int endpointDiscoveryServer_writeEndpoints(struct mg_connection* conn, ar
     return rv;
 }
 
-// returns all endpoints as XML...
-static int endpointDiscoveryServer_returnAllEndpoints(endpoint_discovery_server_t *server, struct mg_connection* conn) {
-    int status = CIVETWEB_REQUEST_NOT_HANDLED;
+static void endpointDiscoveryServer_getETag(endpoint_discovery_server_t *server, char *etag, size_t maxLenETag) {
+    snprintf(etag, maxLenETag, "\"%s-%lu\"", server->instanceId, server->version);
+}
+
+// (re)creates the cached XML document with all endpoints, if the endpoints changed since the last request...
+static celix_status_t endpointDiscoveryServer_updateCachedDocument(endpoint_discovery_server_t *server) {
+    if (server->cachedDocument != NULL && server->cachedDocumentVersion == server->version) {
+        return CELIX_SUCCESS;
+    }
 
     array_list_pt endpoints = NULL;
+    celix_status_t status = endpointDiscoveryServer_getEndpoints(server, NULL, &endpoints);
+    endpoint_descriptor_writer_t *writer = NULL;
+    if (status == CELIX_SUCCESS) {
+        status = endpointDescriptorWriter_create(&writer);
+    }
 
-    if (celixThreadMutex_lock(&server->serverLock) == CELIX_SUCCESS) {
-        endpointDiscoveryServer_getEndpoints(server, NULL, &endpoints);
-        if (endpoints) {
-            status = endpointDiscoveryServer_writeEndpoints(conn, endpoints);
+    char *buffer = NULL;
+    if (status == CELIX_SUCCESS) {
+        status = endpointDescriptorWriter_writeDocument(writer, endpoints, &buffer);
+    }
 
-            arrayList_destroy(endpoints);
+    if (status == CELIX_SUCCESS && buffer != NULL) {
+        char *document = strdup(buffer);
+        if (document != NULL) {
+            free(server->cachedDocument);
+            server->cachedDocument = document;
+            server->cachedDocumentVersion = server->version;
+        } else {
+            status = CELIX_ENOMEM;
         }
+    } else if (status == CELIX_SUCCESS) {
+        status = CELIX_BUNDLE_EXCEPTION;
+    }
+
+    if (writer != NULL) {
+        endpointDescriptorWriter_destroy(writer);
+    }
+    if (endpoints != NULL) {
+        arrayList_destroy(endpoints);
+    }
+    return status;
+}
 
+// returns all endpoints as XML, or 304 Not Modified if the requester already has the current version...
+static int endpointDiscoveryServer_returnAllEndpoints(endpoint_discovery_server_t *server, struct mg_connection* conn) {
+    int status = CIVETWEB_REQUEST_NOT_HANDLED;
+
+    if (celixThreadMutex_lock(&server->serverLock) == CELIX_SUCCESS) {
+        char etag[MAX_ETAG_LENGTH];
+        endpointDiscoveryServer_getETag(server, etag, sizeof(etag));
+
+        const char *ifNoneMatch = mg_get_header(conn, "If-None-Match");
+        if (ifNoneMatch != NULL && strcmp(ifNoneMatch, etag) == 0) {
+            mg_printf(conn, not_modified_response_headers_format, etag);
+            status = CIVETWEB_REQUEST_HANDLED;
+        } else if (endpointDiscoveryServer_updateCachedDocument(server) == CELIX_SUCCESS) {
+            size_t len = strlen(server->cachedDocument);
+            mg_printf(conn, all_endpoints_response_headers_format, len, etag);
+            mg_write(conn, server->cachedDocument, len);
+            status = CIVETWEB_REQUEST_HANDLED;
+        } else {
+            celix_logHelper_warning(*server->loghelper, "Cannot create endpoints document");
+        }
 
         celixThreadMutex_unlock(&server->serverLock);
     }
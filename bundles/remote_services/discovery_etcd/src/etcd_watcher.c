@@ -43,6 +43,7 @@ struct etcd_watcher {
 
     celix_thread_mutex_t watcherLock;
     celix_thread_t watcherThread;
+    etcdlib_watch_loop_t *watchLoop; // created and run by the watcher thread, protected by watcherLock
 
     volatile bool running;
 };
@@ -130,6 +131,12 @@ static celix_status_t etcdWatcher_addAlreadyExistingWatchpoints(etcd_watcher_t *
 }
 
 
+static void etcdWatcher_getOwnFrameworkUrl(etcd_watcher_t *watcher, char* url) {
+	if (endpointDiscoveryServer_getUrl(watcher->discovery->server, url, MAX_VALUE_LENGTH) != CELIX_SUCCESS) {
+		snprintf(url, MAX_VALUE_LENGTH, "http://%s:%s/%s", DEFAULT_SERVER_IP, DEFAULT_SERVER_PORT, DEFAULT_SERVER_PATH);
+	}
+}
+
 static celix_status_t etcdWatcher_addOwnFramework(etcd_watcher_t *watcher)
 {
     char localNodePath[MAX_LOCALNODE_LENGTH];
@@ -139,7 +146,6 @@ static celix_status_t etcdWatcher_addOwnFramework(etcd_watcher_t *watcher)
     char* endpoints = NULL;
 
 	celix_bundle_context_t *context = watcher->discovery->context;
-	endpoint_discovery_server_t *server = watcher->discovery->server;
 
     // register own framework
     celix_status_t status;
@@ -147,9 +153,7 @@ static celix_status_t etcdWatcher_addOwnFramework(etcd_watcher_t *watcher)
         return status;
     }
 
-	if (endpointDiscoveryServer_getUrl(server, url, MAX_VALUE_LENGTH) != CELIX_SUCCESS) {
-		snprintf(url, MAX_VALUE_LENGTH, "http://%s:%s/%s", DEFAULT_SERVER_IP, DEFAULT_SERVER_PORT, DEFAULT_SERVER_PATH);
-	}
+	etcdWatcher_getOwnFrameworkUrl(watcher, url);
 
 	endpoints = url;
 
@@ -169,12 +173,12 @@ static celix_status_t etcdWatcher_addOwnFramework(etcd_watcher_t *watcher)
 
 
 
-static celix_status_t etcdWatcher_addEntry(etcd_watcher_t *watcher, char* key, char* value) {
+static celix_status_t etcdWatcher_addEntry(etcd_watcher_t *watcher, const char* key, const char* value) {
 	celix_status_t status = CELIX_BUNDLE_EXCEPTION;
 	endpoint_discovery_poller_t *poller = watcher->discovery->poller;
 
 	if (!hashMap_containsKey(watcher->entries, key)) {
-		status = endpointDiscoveryPoller_addDiscoveryEndpoint(poller, value);
+		status = endpointDiscoveryPoller_addDiscoveryEndpoint(poller, (char *) value);
 
 		if (status == CELIX_SUCCESS) {
 			hashMap_put(watcher->entries, strdup(key), strdup(value));
@@ -184,7 +188,7 @@ static celix_status_t etcdWatcher_addEntry(etcd_watcher_t *watcher, char* key, c
 	return status;
 }
 
-static celix_status_t etcdWatcher_removeEntry(etcd_watcher_t *watcher, char* key, char* value) {
+static celix_status_t etcdWatcher_removeEntry(etcd_watcher_t *watcher, const char* key) {
 	celix_status_t status = CELIX_BUNDLE_EXCEPTION;
 	endpoint_discovery_poller_t *poller = watcher->discovery->poller;
 
@@ -219,14 +223,33 @@ static celix_status_t etcdWatcher_removeEntry(etcd_watcher_t *watcher, char* key
 }
 
 
+static void etcdWatcher_handleChange(const char *action, const char *key, const char *value, const char *prevValue,
+									 long long modifiedIndex, void *arg) {
+	etcd_watcher_t *watcher = (etcd_watcher_t *) arg;
+
+	if (key == NULL) {
+		return;
+	}
+	if (strcmp(action, "set") == 0 || strcmp(action, "update") == 0) {
+		if (value != NULL) {
+			etcdWatcher_addEntry(watcher, key, value);
+		}
+	} else if (strcmp(action, "delete") == 0 || strcmp(action, "expire") == 0) {
+		etcdWatcher_removeEntry(watcher, key);
+	} else {
+		celix_logHelper_log(*watcher->loghelper, CELIX_LOG_LEVEL_INFO, "Unexpected action: %s", action);
+	}
+}
+
 /*
- * performs (blocking) etcd_watch calls to check for
- * changing discovery endpoint information within etcd.
+ * runs an etcdlib watch loop, which streams the changing discovery endpoint
+ * information within etcd and refreshes the ttl of the own framework.
  */
 static void* etcdWatcher_run(void* data) {
 	etcd_watcher_t *watcher = (etcd_watcher_t *) data;
-	time_t timeBeforeWatch = time(NULL);
 	char rootPath[MAX_ROOTNODE_LENGTH];
+	char localNodePath[MAX_LOCALNODE_LENGTH];
+	char url[MAX_VALUE_LENGTH];
 	long long highestModified = 0;
 
 	celix_bundle_context_t *context = watcher->discovery->context;
@@ -234,44 +257,33 @@ static void* etcdWatcher_run(void* data) {
 	etcdWatcher_addAlreadyExistingWatchpoints(watcher, watcher->discovery, &highestModified);
 	etcdWatcher_getRootPath(context, rootPath);
 
-	while (watcher->running) {
-
-		char *rkey = NULL;
-		char *value = NULL;
-		char *preValue = NULL;
-		char *action = NULL;
-		long long modIndex;
-
-        if (etcdlib_watch(watcher->etcdlib, rootPath, highestModified + 1, &action, &preValue, &value, &rkey, &modIndex) == 0 && action != NULL) {
-			if (strcmp(action, "set") == 0) {
-				etcdWatcher_addEntry(watcher, rkey, value);
-			} else if (strcmp(action, "delete") == 0) {
-				etcdWatcher_removeEntry(watcher, rkey, value);
-			} else if (strcmp(action, "expire") == 0) {
-				etcdWatcher_removeEntry(watcher, rkey, value);
-			} else if (strcmp(action, "update") == 0) {
-				etcdWatcher_addEntry(watcher, rkey, value);
-			} else {
-				celix_logHelper_log(*watcher->loghelper, CELIX_LOG_LEVEL_INFO, "Unexpected action: %s", action);
-			}
-
-			highestModified = modIndex;
-        } else if (time(NULL) - timeBeforeWatch <= (watcher->ttl / 4)) {
-			sleep(watcher->ttl / 4);
-        }
+	celixThreadMutex_lock(&watcher->watcherLock);
+	if (watcher->running) {
+		watcher->watchLoop = etcdlib_watch_loop_create(watcher->etcdlib, rootPath, highestModified + 1,
+													   etcdWatcher_handleChange, watcher);
+		if (watcher->watchLoop == NULL) {
+			celix_logHelper_log(*watcher->loghelper, CELIX_LOG_LEVEL_ERROR, "Cannot create etcd watch loop");
+		}
+	}
+	etcdlib_watch_loop_t *loop = watcher->watchLoop;
+	celixThreadMutex_unlock(&watcher->watcherLock);
 
-        FREE_MEM(action);
-        FREE_MEM(value);
-        FREE_MEM(preValue);
-        FREE_MEM(rkey);
+	if (loop == NULL) {
+		return NULL;
+	}
 
-		// update own framework uuid
-		if (time(NULL) - timeBeforeWatch > (watcher->ttl / 4)) {
-			etcdWatcher_addOwnFramework(watcher);
-			timeBeforeWatch = time(NULL);
+	if (etcdWatcher_getLocalNodePath(context, localNodePath) == CELIX_SUCCESS) {
+		etcdWatcher_getOwnFrameworkUrl(watcher, url);
+		int interval = watcher->ttl / 4 > 0 ? watcher->ttl / 4 : 1;
+		if (etcdlib_watch_loop_set_refresh(loop, localNodePath, url, watcher->ttl, interval) != ETCDLIB_RC_OK) {
+			celix_logHelper_log(*watcher->loghelper, CELIX_LOG_LEVEL_WARNING, "Cannot refresh local discovery");
 		}
 	}
 
+	if (etcdlib_watch_loop_run(loop) != ETCDLIB_RC_OK) {
+		celix_logHelper_log(*watcher->loghelper, CELIX_LOG_LEVEL_ERROR, "Etcd watch loop stopped with an error");
+	}
+
 	return NULL;
 }
 
@@ -330,9 +342,13 @@ celix_status_t etcdWatcher_destroy(etcd_watcher_t *watcher) {
 
 	celixThreadMutex_lock(&watcher->watcherLock);
 	watcher->running = false;
+	if (watcher->watchLoop != NULL) {
+		etcdlib_watch_loop_stop(watcher->watchLoop);
+	}
 	celixThreadMutex_unlock(&watcher->watcherLock);
 
 	celixThread_join(watcher->watcherThread, NULL);
+	etcdlib_watch_loop_destroy(watcher->watchLoop);
 
 	// register own framework
 	status = etcdWatcher_getLocalNodePath(watcher->discovery->context, localNodePath);
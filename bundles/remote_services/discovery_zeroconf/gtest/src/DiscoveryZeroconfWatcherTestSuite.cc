@@ -34,6 +34,12 @@
 #include <netinet/in.h>
 #include <semaphore.h>
 #include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <stdlib.h>
 #include <gtest/gtest.h>
 
@@ -398,4 +404,108 @@ TEST_F(DiscoveryZeroconfWatcherTestSuite, AddAndRemoveEndpointListener) {
 
     DNSServiceRefDeallocate(dsRef);
     discoveryZeroconfWatcher_destroy(watcher);
-}
\ No newline at end of file
+}
+
+struct EndpointChanges {
+    std::mutex mutex{};
+    std::condition_variable cond{};
+    std::vector<std::string> added{};
+    std::vector<std::string> removed{};
+};
+
+static celix_status_t endpointChanges_endpointAdded(void *handle, endpoint_description_t *endpoint, char *matchedFilter) {
+    (void)matchedFilter;
+    auto* changes = static_cast<EndpointChanges*>(handle);
+    std::lock_guard<std::mutex> lock{changes->mutex};
+    changes->added.emplace_back(endpoint->id);
+    changes->cond.notify_all();
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t endpointChanges_endpointRemoved(void *handle, endpoint_description_t *endpoint, char *matchedFilter) {
+    (void)matchedFilter;
+    auto* changes = static_cast<EndpointChanges*>(handle);
+    std::lock_guard<std::mutex> lock{changes->mutex};
+    changes->removed.emplace_back(endpoint->id);
+    changes->cond.notify_all();
+    return CELIX_SUCCESS;
+}
+
+static long countOf(const std::vector<std::string>& ids, const char* id) {
+    return std::count(ids.begin(), ids.end(), id);
+}
+
+static void createTestServiceTxtRecord(TXTRecordRef* txtRecord, char* txtBuf, uint16_t txtBufLen, const char* endpointId) {
+    TXTRecordCreate(txtRecord, txtBufLen, txtBuf);
+    TXTRecordSetValue(txtRecord, OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, strlen(DZC_TEST_ENDPOINT_FW_UUID), DZC_TEST_ENDPOINT_FW_UUID);
+    TXTRecordSetValue(txtRecord, CELIX_FRAMEWORK_SERVICE_NAME, strlen("dzc_test_service"), "dzc_test_service");
+    TXTRecordSetValue(txtRecord, OSGI_RSA_ENDPOINT_ID, strlen(endpointId), endpointId);
+    TXTRecordSetValue(txtRecord, OSGI_RSA_ENDPOINT_SERVICE_ID, strlen("100"), "100");
+    TXTRecordSetValue(txtRecord, OSGI_RSA_SERVICE_IMPORTED, strlen("true"), "true");
+    TXTRecordSetValue(txtRecord, OSGI_RSA_SERVICE_IMPORTED_CONFIGS, strlen("dzc_test_config_type"), "dzc_test_config_type");
+    char propSizeStr[16]= {0};
+    sprintf(propSizeStr, "%d", TXTRecordGetCount(TXTRecordGetLength(txtRecord), TXTRecordGetBytesPtr(txtRecord)) + 1);
+    TXTRecordSetValue(txtRecord, DZC_SERVICE_PROPERTIES_SIZE_KEY, strlen(propSizeStr), propSizeStr);
+}
+
+static void updateTestServiceTxtRecord(DNSServiceRef dsRef, const char* endpointId) {
+    char txtBuf[1300] = {0};
+    TXTRecordRef txtRecord;
+    createTestServiceTxtRecord(&txtRecord, txtBuf, sizeof(txtBuf), endpointId);
+    DNSServiceErrorType dnsErr = DNSServiceUpdateRecord(dsRef, nullptr, 0, TXTRecordGetLength(&txtRecord), TXTRecordGetBytesPtr(&txtRecord), 0);
+    EXPECT_EQ(dnsErr, kDNSServiceErr_NoError);
+    TXTRecordDeallocate(&txtRecord);
+}
+
+TEST_F(DiscoveryZeroconfWatcherTestSuite, ChangeEndpointIdOfResolvedService) {
+    //The fixture endpoint listener only accepts the default test endpoint id, so use a dedicated listener.
+    celix_bundleContext_unregisterService(ctx.get(), eplId);
+    eplId = -1;
+    EndpointChanges changes{};
+    endpoint_listener_t changesListener{&changes, endpointChanges_endpointAdded, endpointChanges_endpointRemoved};
+    long listenerId = celix_bundleContext_registerService(ctx.get(), &changesListener, OSGI_ENDPOINT_LISTENER_SERVICE, nullptr);
+    EXPECT_LE(0, listenerId);
+
+    discovery_zeroconf_watcher_t *watcher;
+    celix_status_t status = discoveryZeroconfWatcher_create(ctx.get(), logHelper.get(), &watcher);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    const char* firstId = "60f49d89-d105-430c-b12b-93fbb54b1d19";
+    const char* secondId = "7c1b5ae2-3b53-4f0e-9d2a-1f4c4b7a0c6e";
+    char txtBuf[1300] = {0};
+    TXTRecordRef txtRecord;
+    createTestServiceTxtRecord(&txtRecord, txtBuf, sizeof(txtBuf), firstId);
+    DNSServiceRef dsRef{};
+    DNSServiceErrorType dnsErr = DNSServiceRegister(&dsRef, 0, kDNSServiceInterfaceIndexLocalOnly, "dzc_test_service", DZC_SERVICE_PRIMARY_TYPE, "local", DZC_HOST_DEFAULT, htons(DZC_PORT_DEFAULT), TXTRecordGetLength(&txtRecord), TXTRecordGetBytesPtr(&txtRecord), OnDNSServiceRegisterCallback,nullptr);
+    EXPECT_EQ(dnsErr, kDNSServiceErr_NoError);
+    DNSServiceProcessResult(dsRef);
+    TXTRecordDeallocate(&txtRecord);
+
+    std::unique_lock<std::mutex> lock{changes.mutex};
+    EXPECT_TRUE(changes.cond.wait_for(lock, std::chrono::seconds{30}, [&]{ return countOf(changes.added, firstId) == 1; }));
+    lock.unlock();
+
+    //A new txt record of a resolved service changes the endpoint id: the new endpoint is added and the old one expires
+    updateTestServiceTxtRecord(dsRef, secondId);
+    lock.lock();
+    EXPECT_TRUE(changes.cond.wait_for(lock, std::chrono::seconds{30}, [&]{ return countOf(changes.added, secondId) == 1; }));
+    EXPECT_TRUE(changes.cond.wait_for(lock, std::chrono::seconds{30}, [&]{ return countOf(changes.removed, firstId) == 1; }));
+    lock.unlock();
+
+    //An unchanged txt record is skipped by the parsed txt record cache and does not add the endpoint again
+    updateTestServiceTxtRecord(dsRef, secondId);
+    lock.lock();
+    EXPECT_FALSE(changes.cond.wait_for(lock, std::chrono::seconds{3}, [&]{ return countOf(changes.added, secondId) > 1; }));
+    lock.unlock();
+
+    //A txt record that was parsed before the endpoint id changed is parsed again
+    updateTestServiceTxtRecord(dsRef, firstId);
+    lock.lock();
+    EXPECT_TRUE(changes.cond.wait_for(lock, std::chrono::seconds{30}, [&]{ return countOf(changes.added, firstId) == 2; }));
+    EXPECT_TRUE(changes.cond.wait_for(lock, std::chrono::seconds{30}, [&]{ return countOf(changes.removed, secondId) == 1; }));
+    lock.unlock();
+
+    DNSServiceRefDeallocate(dsRef);
+    discoveryZeroconfWatcher_destroy(watcher);
+    celix_bundleContext_unregisterService(ctx.get(), listenerId);
+}
@@ -56,6 +56,11 @@ struct discovery_zeroconf_watcher {
     int eventFd;
     celix_thread_t watchEPThread;
     celix_string_hash_map_t *watchedServices;//key:instanceName+interfaceId, val:watched_service_entry_t*
+    celix_string_hash_map_t *unresolvedServices;//key:instanceName+interfaceId, val:watched_service_entry_t*, the watched services that still need to be resolved
+    celix_string_hash_map_t *dirtyServices;//key:instanceName+interfaceId, val:watched_service_entry_t*, the watched services that are resolved since the last refresh
+    celix_string_hash_map_t *endpointRefCnts;//key:endpoint id, val:number of watched services for the endpoint
+    celix_string_hash_map_t *dirtyEndpointIds;//key:endpoint id, the endpoints for which the number of watched services changed from or to 0 since the last refresh
+    celix_string_hash_map_t *expiringEndpoints;//key:endpoint id, val:watched_endpoint_entry_t*, the endpoints without watched services
     celix_thread_mutex_t mutex;//projects below
     bool running;
     celix_string_hash_map_t *watchedEndpoints;//key:endpoint id, val:watched_endpoint_entry_t*
@@ -68,8 +73,11 @@ typedef struct watched_endpoint_entry {
 }watched_endpoint_entry_t;
 
 typedef struct watched_service_entry {
+    discovery_zeroconf_watcher_t *watcher;
+    char key[128];//key in the watched services maps
     celix_properties_t *txtRecord;
-    const char *endpointId;
+    celix_long_hash_map_t *parsedTxtRecords;//key:hash and length of the txt records parsed into txtRecord, used to skip re-parsing unchanged txt records
+    char *endpointId;
     int ifIndex;
     char instanceName[64];//The instanceName must be 1-63 bytes
     bool resolved;
@@ -129,6 +137,21 @@ celix_status_t discoveryZeroconfWatcher_create(celix_bundle_context_t *ctx, celi
     celix_autoptr(celix_string_hash_map_t) watchedServices =
         watcher->watchedServices = celix_stringHashMap_createWithOptions(&svcOpts);
     assert(watcher->watchedServices != NULL);
+    celix_autoptr(celix_string_hash_map_t) unresolvedServices =
+        watcher->unresolvedServices = celix_stringHashMap_createWithOptions(&epOpts);
+    assert(watcher->unresolvedServices != NULL);
+    celix_autoptr(celix_string_hash_map_t) dirtyServices =
+        watcher->dirtyServices = celix_stringHashMap_createWithOptions(&epOpts);
+    assert(watcher->dirtyServices != NULL);
+    celix_autoptr(celix_string_hash_map_t) endpointRefCnts =
+        watcher->endpointRefCnts = celix_stringHashMap_create();
+    assert(watcher->endpointRefCnts != NULL);
+    celix_autoptr(celix_string_hash_map_t) dirtyEndpointIds =
+        watcher->dirtyEndpointIds = celix_stringHashMap_create();
+    assert(watcher->dirtyEndpointIds != NULL);
+    celix_autoptr(celix_string_hash_map_t) expiringEndpoints =
+        watcher->expiringEndpoints = celix_stringHashMap_createWithOptions(&epOpts);
+    assert(watcher->expiringEndpoints != NULL);
 
     celix_autoptr(celix_long_hash_map_t) epls =
         watcher->epls = celix_longHashMap_create();
@@ -155,6 +178,11 @@ celix_status_t discoveryZeroconfWatcher_create(celix_bundle_context_t *ctx, celi
     celixThread_setName(&watcher->watchEPThread, "DiscWatcher");
 
     celix_steal_ptr(epls);
+    celix_steal_ptr(expiringEndpoints);
+    celix_steal_ptr(dirtyEndpointIds);
+    celix_steal_ptr(endpointRefCnts);
+    celix_steal_ptr(dirtyServices);
+    celix_steal_ptr(unresolvedServices);
     celix_steal_ptr(watchedServices);
     celix_steal_ptr(watchedEndpoints);
     celix_steal_ptr(mutex);
@@ -173,6 +201,16 @@ void discoveryZeroconfWatcher_destroy(discovery_zeroconf_watcher_t *watcher) {
     celix_bundleContext_stopTrackerAsync(watcher->ctx, watcher->epListenerTrkId, NULL, NULL);
     celix_bundleContext_waitForAsyncStopTracker(watcher->ctx, watcher->epListenerTrkId);
     celix_longHashMap_destroy(watcher->epls);
+    assert(celix_stringHashMap_size(watcher->expiringEndpoints) == 0);
+    celix_stringHashMap_destroy(watcher->expiringEndpoints);
+    assert(celix_stringHashMap_size(watcher->dirtyEndpointIds) == 0);
+    celix_stringHashMap_destroy(watcher->dirtyEndpointIds);
+    assert(celix_stringHashMap_size(watcher->endpointRefCnts) == 0);
+    celix_stringHashMap_destroy(watcher->endpointRefCnts);
+    assert(celix_stringHashMap_size(watcher->dirtyServices) == 0);
+    celix_stringHashMap_destroy(watcher->dirtyServices);
+    assert(celix_stringHashMap_size(watcher->unresolvedServices) == 0);
+    celix_stringHashMap_destroy(watcher->unresolvedServices);
     assert(celix_stringHashMap_size(watcher->watchedServices) == 0);
     celix_stringHashMap_destroy(watcher->watchedServices);
     assert(celix_stringHashMap_size(watcher->watchedEndpoints) == 0);
@@ -249,6 +287,65 @@ static void discoveryZeroconfWatcher_removeEPL(void *handle, void *svc, const ce
     return;
 }
 
+static long discoveryZeroconfWatcher_txtRecordKey(uint16_t txtLen, const unsigned char *txtRecord) {
+    //FNV-1a hash of the txt record, combined with the txt record length
+    uint32_t hash = 2166136261u;
+    for (uint16_t i = 0; i < txtLen; ++i) {
+        hash ^= txtRecord[i];
+        hash *= 16777619u;
+    }
+    return (long)(((uint64_t)txtLen << 32) | hash);
+}
+
+static bool discoveryZeroconfWatcher_setServiceEndpointId(discovery_zeroconf_watcher_t *watcher, watched_service_entry_t *svcEntry, const char *endpointId) {
+    if (celix_utils_stringEquals(svcEntry->endpointId, endpointId)) {
+        return false;
+    }
+    if (svcEntry->endpointId != NULL) {
+        long refCnt = celix_stringHashMap_getLong(watcher->endpointRefCnts, svcEntry->endpointId, 0) - 1;
+        if (refCnt > 0) {
+            celix_stringHashMap_putLong(watcher->endpointRefCnts, svcEntry->endpointId, refCnt);
+        } else {
+            celix_stringHashMap_remove(watcher->endpointRefCnts, svcEntry->endpointId);
+            celix_stringHashMap_put(watcher->dirtyEndpointIds, svcEntry->endpointId, NULL);
+        }
+        free(svcEntry->endpointId);
+        svcEntry->endpointId = NULL;
+    }
+    if (endpointId != NULL) {
+        svcEntry->endpointId = celix_utils_strdup(endpointId);
+        if (svcEntry->endpointId == NULL) {
+            celix_logHelper_error(watcher->logHelper, "Watcher: Failed to dup endpoint id for %s.", svcEntry->instanceName);
+            return true;
+        }
+        long refCnt = celix_stringHashMap_getLong(watcher->endpointRefCnts, endpointId, 0) + 1;
+        celix_stringHashMap_putLong(watcher->endpointRefCnts, endpointId, refCnt);
+        if (refCnt == 1) {
+            celix_stringHashMap_put(watcher->dirtyEndpointIds, endpointId, NULL);
+        }
+    }
+    return true;
+}
+
+static void discoveryZeroconfWatcher_destroyServiceEntry(discovery_zeroconf_watcher_t *watcher, watched_service_entry_t *svcEntry) {
+    discoveryZeroconfWatcher_setServiceEndpointId(watcher, svcEntry, NULL);
+    celix_longHashMap_destroy(svcEntry->parsedTxtRecords);
+    celix_properties_destroy(svcEntry->txtRecord);
+    free(svcEntry);
+    return;
+}
+
+static void discoveryZeroconfWatcher_removeServiceEntry(discovery_zeroconf_watcher_t *watcher, watched_service_entry_t *svcEntry) {
+    celix_stringHashMap_remove(watcher->unresolvedServices, svcEntry->key);
+    celix_stringHashMap_remove(watcher->dirtyServices, svcEntry->key);
+    celix_stringHashMap_remove(watcher->watchedServices, svcEntry->key);
+    if (svcEntry->resolveRef) {
+        DNSServiceRefDeallocate(svcEntry->resolveRef);
+    }
+    discoveryZeroconfWatcher_destroyServiceEntry(watcher, svcEntry);
+    return;
+}
+
 static void OnServiceResolveCallback(DNSServiceRef sdRef, DNSServiceFlags flags, uint32_t interfaceIndex, DNSServiceErrorType errorCode, const char *fullname, const char *host, uint16_t port, uint16_t txtLen, const unsigned char *txtRecord, void *context) {
     (void)sdRef;//unused
     (void)flags;//unused
@@ -261,6 +358,12 @@ static void OnServiceResolveCallback(DNSServiceRef sdRef, DNSServiceFlags flags,
     }
     watched_service_entry_t *svcEntry = (watched_service_entry_t *)context;
     assert(svcEntry != NULL);
+    discovery_zeroconf_watcher_t *watcher = svcEntry->watcher;
+    long txtRecordKey = discoveryZeroconfWatcher_txtRecordKey(txtLen, txtRecord);
+    if (celix_longHashMap_hasKey(svcEntry->parsedTxtRecords, txtRecordKey)) {
+        //The txt record is unchanged and already parsed, e.g. a repeated mDNS answer.
+        return;
+    }
     celix_properties_t *properties = svcEntry->txtRecord;
     int cnt = TXTRecordGetCount(txtLen, txtRecord);
     for (int i = 0; i < cnt; ++i) {
@@ -276,12 +379,25 @@ static void OnServiceResolveCallback(DNSServiceRef sdRef, DNSServiceFlags flags,
         memcpy(val, valPtr, valLen);
         celix_properties_set(properties, key, val);
     }
-    svcEntry->endpointId = celix_properties_get(properties, OSGI_RSA_ENDPOINT_ID, NULL);
+    bool endpointIdChanged = discoveryZeroconfWatcher_setServiceEndpointId(watcher, svcEntry, celix_properties_get(properties, OSGI_RSA_ENDPOINT_ID, NULL));
+    if (endpointIdChanged) {
+        //The txt records parsed before describe the previous endpoint, they must be parsed again if they come back.
+        celix_longHashMap_clear(svcEntry->parsedTxtRecords);
+    }
+    celix_longHashMap_put(svcEntry->parsedTxtRecords, txtRecordKey, NULL);
 
     long propSize = celix_properties_getAsLong(properties, DZC_SERVICE_PROPERTIES_SIZE_KEY, 0);
     if (propSize == celix_properties_size(properties)) {
         celix_properties_unset(properties, DZC_SERVICE_PROPERTIES_SIZE_KEY);//Service endpoint do not need it
-        svcEntry->resolved = true;
+        if (!svcEntry->resolved) {
+            svcEntry->resolved = true;
+            celix_stringHashMap_remove(watcher->unresolvedServices, svcEntry->key);
+            celix_stringHashMap_put(watcher->dirtyServices, svcEntry->key, svcEntry);
+        }
+    }
+    if (svcEntry->resolved && endpointIdChanged) {
+        //A resolved service that now describes another endpoint, the endpoint for the new id must be added.
+        celix_stringHashMap_put(watcher->dirtyServices, svcEntry->key, svcEntry);
     }
     return;
 }
@@ -305,7 +421,7 @@ static void OnServiceBrowseCallback(DNSServiceRef sdRef, DNSServiceFlags flags,
 
     celix_logHelper_info(watcher->logHelper, "Watcher: %s  %s on interface %d.", (flags & kDNSServiceFlagsAdd) ? "Add" : "Remove", instanceName, interfaceIndex);
 
-    char key[128]={0};
+    char key[sizeof(svcEntry->key)]={0};
     (void)snprintf(key, sizeof(key), "%s%d", instanceName, (int)interfaceIndex);
     if (flags & kDNSServiceFlagsAdd) {
         if (celix_stringHashMap_hasKey(watcher->watchedServices, key)) {
@@ -317,6 +433,14 @@ static void OnServiceBrowseCallback(DNSServiceRef sdRef, DNSServiceFlags flags,
             celix_logHelper_error(watcher->logHelper, "Watcher: Failed service entry.");
             return;
         }
+        svcEntry->parsedTxtRecords = celix_longHashMap_create();
+        if (svcEntry->parsedTxtRecords == NULL) {
+            celix_logHelper_error(watcher->logHelper, "Watcher: Failed service entry.");
+            free(svcEntry);
+            return;
+        }
+        svcEntry->watcher = watcher;
+        strcpy(svcEntry->key, key);
         svcEntry->resolveRef = NULL;
         svcEntry->txtRecord = celix_properties_create();
         svcEntry->endpointId = NULL;
@@ -325,23 +449,21 @@ static void OnServiceBrowseCallback(DNSServiceRef sdRef, DNSServiceFlags flags,
         svcEntry->ifIndex = (int)interfaceIndex;
         svcEntry->resolvedStartTime.tv_sec = INT_MAX;
         svcEntry->resolvedCnt = 0;
-        celix_stringHashMap_put(watcher->watchedServices, key, svcEntry);
+        celix_stringHashMap_put(watcher->watchedServices, svcEntry->key, svcEntry);
+        celix_stringHashMap_put(watcher->unresolvedServices, svcEntry->key, svcEntry);
     } else {
         svcEntry = (watched_service_entry_t *)celix_stringHashMap_get(watcher->watchedServices, key);
         if (svcEntry) {
-            celix_stringHashMap_remove(watcher->watchedServices, key);
-            if (svcEntry->resolveRef) {
-                DNSServiceRefDeallocate(svcEntry->resolveRef);
-            }
-            celix_properties_destroy(svcEntry->txtRecord);
-            free(svcEntry);
+            discoveryZeroconfWatcher_removeServiceEntry(watcher, svcEntry);
         }
     }
     return;
 }
 
 static void discoveryZeroconfWatcher_resolveServices(discovery_zeroconf_watcher_t *watcher) {
-    CELIX_STRING_HASH_MAP_ITERATE(watcher->watchedServices, iter) {
+    //Only the unresolved services are visited, resolved services are kept up to date by their (still open) resolve.
+    celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(watcher->unresolvedServices);
+    while (!celix_stringHashMapIterator_isEnd(&iter)) {
         watched_service_entry_t *svcEntry = (watched_service_entry_t *)iter.value.ptrValue;
         //If resolving is not completed for a long time，then close it, and try again later.
         if (svcEntry->resolved == false && svcEntry->resolveRef != NULL && celix_elapsedtime(CLOCK_MONOTONIC, svcEntry->resolvedStartTime) > DZC_MAX_RESOLVED_TIMEOUT) {
@@ -361,6 +483,12 @@ static void discoveryZeroconfWatcher_resolveServices(discovery_zeroconf_watcher_
             svcEntry->resolvedStartTime = celix_gettime(CLOCK_MONOTONIC);
             svcEntry->resolvedCnt ++;
         }
+        if (svcEntry->resolveRef == NULL && svcEntry->resolvedCnt >= DZC_MAX_RESOLVED_CNT) {
+            //Give up, the service will not be resolved again until it is browsed again.
+            celix_stringHashMapIterator_remove(&iter);
+            continue;
+        }
+        celix_stringHashMapIterator_next(&iter);
     }
     return;
 }
@@ -381,36 +509,23 @@ static void discoveryZeroConfWatcher_informEPLs(discovery_zeroconf_watcher_t *wa
     return;
 }
 
-static bool discoveryZeroconfWatcher_hasWatchedServiceForEndpoint(discovery_zeroconf_watcher_t *watcher, const char *endpointId) {
-    CELIX_STRING_HASH_MAP_ITERATE(watcher->watchedServices, iter) {
-        watched_service_entry_t *svcEntry = (watched_service_entry_t *)iter.value.ptrValue;
-        if (svcEntry->endpointId != NULL && strcmp(svcEntry->endpointId, endpointId) == 0) {
-            return true;
-        }
-    }
-    return false;
-}
-
 static void discoveryZeroconfWatcher_refreshEndpoints(discovery_zeroconf_watcher_t *watcher) {
     watched_endpoint_entry_t *epEntry = NULL;
     watched_service_entry_t *svcEntry = NULL;
 
+    //Only the services resolved since the last refresh and the endpoints for which the number of watched services
+    //changed from or to 0 are visited, so the cost of a refresh does not depend on the number of watched services.
+
     //remove self endpoints
-    celix_string_hash_map_iterator_t svcIter = celix_stringHashMap_begin(watcher->watchedServices);
+    celix_string_hash_map_iterator_t svcIter = celix_stringHashMap_begin(watcher->dirtyServices);
     while (!celix_stringHashMapIterator_isEnd(&svcIter)) {
         svcEntry = (watched_service_entry_t *)svcIter.value.ptrValue;
-        if (svcEntry->resolved) {
-            const char *epFwUuid = celix_properties_get(svcEntry->txtRecord, OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, NULL);
-            if (epFwUuid != NULL && strcmp(epFwUuid, watcher->fwUuid) == 0) {
-                celix_logHelper_debug(watcher->logHelper, "Watcher: Ignore self endpoint for %s.", celix_properties_get(svcEntry->txtRecord, CELIX_FRAMEWORK_SERVICE_NAME, "unknown"));
-                celix_stringHashMapIterator_remove(&svcIter);
-                if (svcEntry->resolveRef) {
-                    DNSServiceRefDeallocate(svcEntry->resolveRef);
-                }
-                celix_properties_destroy(svcEntry->txtRecord);
-                free(svcEntry);
-                continue;
-            }
+        const char *epFwUuid = celix_properties_get(svcEntry->txtRecord, OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, NULL);
+        if (epFwUuid != NULL && strcmp(epFwUuid, watcher->fwUuid) == 0) {
+            celix_logHelper_debug(watcher->logHelper, "Watcher: Ignore self endpoint for %s.", celix_properties_get(svcEntry->txtRecord, CELIX_FRAMEWORK_SERVICE_NAME, "unknown"));
+            celix_stringHashMapIterator_remove(&svcIter);
+            discoveryZeroconfWatcher_removeServiceEntry(watcher, svcEntry);
+            continue;
         }
         celix_stringHashMapIterator_next(&svcIter);
     }
@@ -418,7 +533,7 @@ static void discoveryZeroconfWatcher_refreshEndpoints(discovery_zeroconf_watcher
     celixThreadMutex_lock(&watcher->mutex);
 
     //add new endpoint
-    CELIX_STRING_HASH_MAP_ITERATE(watcher->watchedServices, iter) {
+    CELIX_STRING_HASH_MAP_ITERATE(watcher->dirtyServices, iter) {
         svcEntry = (watched_service_entry_t *)iter.value.ptrValue;
         if (svcEntry->endpointId != NULL && svcEntry->resolved) {
             epEntry = (watched_endpoint_entry_t *)celix_stringHashMap_get(watcher->watchedEndpoints, svcEntry->endpointId);
@@ -431,6 +546,7 @@ static void discoveryZeroconfWatcher_refreshEndpoints(discovery_zeroconf_watcher
                     // If properties invalid,endpointDescription_create will return error.
                     // Avoid endpointDescription_create again, set svcEntry->resolved false.
                     svcEntry->resolved = false;
+                    celix_stringHashMap_put(watcher->unresolvedServices, svcEntry->key, svcEntry);
                     continue;
                 }
                 celix_logHelper_debug(watcher->logHelper, "Watcher: Add endpoint for %s on %s.", ep->serviceName,ep->frameworkUUID);
@@ -442,29 +558,42 @@ static void discoveryZeroconfWatcher_refreshEndpoints(discovery_zeroconf_watcher
                     continue;
                 }
                 epEntry->endpoint = ep;
+                epEntry->expiredTime.tv_sec = INT_MAX;
                 discoveryZeroConfWatcher_informEPLs(watcher, ep, true);
                 celix_stringHashMap_put(watcher->watchedEndpoints, epEntry->endpoint->id, epEntry);
             }
+        }
+    }
+    celix_stringHashMap_clear(watcher->dirtyServices);
+
+    //start or stop the expiration of endpoints for which the number of watched services changed from or to 0
+    CELIX_STRING_HASH_MAP_ITERATE(watcher->dirtyEndpointIds, iter) {
+        epEntry = (watched_endpoint_entry_t *)celix_stringHashMap_get(watcher->watchedEndpoints, iter.key);
+        if (epEntry == NULL) {
+            continue;
+        }
+        if (celix_stringHashMap_hasKey(watcher->endpointRefCnts, iter.key)) {
             epEntry->expiredTime.tv_sec = INT_MAX;
+            celix_stringHashMap_remove(watcher->expiringEndpoints, epEntry->endpoint->id);
+        } else if (epEntry->expiredTime.tv_sec == INT_MAX) {
+            epEntry->expiredTime = celix_gettime(CLOCK_MONOTONIC);
+            celix_stringHashMap_put(watcher->expiringEndpoints, epEntry->endpoint->id, epEntry);
         }
     }
+    celix_stringHashMap_clear(watcher->dirtyEndpointIds);
 
     //remove expired endpoint
-    celix_string_hash_map_iterator_t epIter = celix_stringHashMap_begin(watcher->watchedEndpoints);
+    celix_string_hash_map_iterator_t epIter = celix_stringHashMap_begin(watcher->expiringEndpoints);
     while (!celix_stringHashMapIterator_isEnd(&epIter)) {
         epEntry = (watched_endpoint_entry_t *)epIter.value.ptrValue;
-        const char *endpointId = epIter.key;
-        if (!discoveryZeroconfWatcher_hasWatchedServiceForEndpoint(watcher, endpointId)) {
-            if (epEntry->expiredTime.tv_sec == INT_MAX) {
-                epEntry->expiredTime = celix_gettime(CLOCK_MONOTONIC);
-            } else if (celix_elapsedtime(CLOCK_MONOTONIC, epEntry->expiredTime) >= DZC_EP_JITTER_INTERVAL) {
-                celix_logHelper_debug(watcher->logHelper, "Watcher: Remove endpoint for %s on %s.", epEntry->endpoint->serviceName, epEntry->endpoint->frameworkUUID);
-                celix_stringHashMapIterator_remove(&epIter);
-                discoveryZeroConfWatcher_informEPLs(watcher, epEntry->endpoint, false);
-                endpointDescription_destroy(epEntry->endpoint);
-                free(epEntry);
-                continue;
-            }
+        if (celix_elapsedtime(CLOCK_MONOTONIC, epEntry->expiredTime) >= DZC_EP_JITTER_INTERVAL) {
+            celix_logHelper_debug(watcher->logHelper, "Watcher: Remove endpoint for %s on %s.", epEntry->endpoint->serviceName, epEntry->endpoint->frameworkUUID);
+            celix_stringHashMapIterator_remove(&epIter);
+            celix_stringHashMap_remove(watcher->watchedEndpoints, epEntry->endpoint->id);
+            discoveryZeroConfWatcher_informEPLs(watcher, epEntry->endpoint, false);
+            endpointDescription_destroy(epEntry->endpoint);
+            free(epEntry);
+            continue;
         }
         celix_stringHashMapIterator_next(&epIter);
     }
@@ -483,6 +612,8 @@ static void discoveryZeroconfWatcher_clearEndpoints(discovery_zeroconf_watcher_t
         free(epEntry);
     }
     celix_stringHashMap_clear(watcher->watchedEndpoints);
+    celix_stringHashMap_clear(watcher->expiringEndpoints);
+    celix_stringHashMap_clear(watcher->dirtyEndpointIds);
     celixThreadMutex_unlock(&watcher->mutex);
     return;
 }
@@ -493,11 +624,12 @@ static void discoveryZeroconfWatcher_closeMDNSConnection(discovery_zeroconf_watc
         watcher->sharedRef = NULL;
         watcher->browseRef = NULL;//no need free entry->browseRef, 'DNSServiceRefDeallocate(watcher->sharedRef)' has do it.
     }
+    celix_stringHashMap_clear(watcher->unresolvedServices);
+    celix_stringHashMap_clear(watcher->dirtyServices);
     CELIX_STRING_HASH_MAP_ITERATE(watcher->watchedServices, iter) {
         watched_service_entry_t *svcEntry = (watched_service_entry_t *) iter.value.ptrValue;
         //no need free svcEntry->resolveRef, 'DNSServiceRefDeallocate(watcher->sharedRef)' has do it.
-        celix_properties_destroy(svcEntry->txtRecord);
-        free(svcEntry);
+        discoveryZeroconfWatcher_destroyServiceEntry(watcher, svcEntry);
     }
     celix_stringHashMap_clear(watcher->watchedServices);
     return;
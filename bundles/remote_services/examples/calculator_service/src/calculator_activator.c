@@ -21,6 +21,7 @@
 
 #include "celix_bundle_activator.h"
 #include "calculator_impl.h"
+#include "calculator_json_rpc_stub.h"
 #include "remote_constants.h"
 #include "celix_constants.h"
 
@@ -28,10 +29,14 @@ struct activator {
     calculator_t *calculator;
     calculator_service_t service;
     long svcId;
+    rsa_json_rpc_stub_t *stub;
 };
 
 celix_status_t calculatorBndStart(struct activator *act, celix_bundle_context_t *ctx) {
     act->svcId = -1L;
+    //note the JSON-RPC remote service admin uses the generated stubs instead of libffi, if registered
+    act->stub = NULL;
+    (void)rsaJsonRpcStub_register(ctx, &calculator_jsonRpcStubDefinition, &act->stub);
     act->calculator = calculator_create();
     if (act->calculator != NULL) {
         act->service.handle = act->calculator;
@@ -54,6 +59,7 @@ celix_status_t calculatorBndStop(struct activator *act, celix_bundle_context_t *
     if (act->calculator != NULL) {
         calculator_destroy(act->calculator);
     }
+    rsaJsonRpcStub_unregister(act->stub);
     return CELIX_SUCCESS;
 }
 
@@ -27,6 +27,7 @@
 #include "add_command.h"
 #include "sub_command.h"
 #include "sqrt_command.h"
+#include "calculator_json_rpc_stub.h"
 
 typedef struct calc_shell_activator {
     long addCmdSvcId;
@@ -35,9 +36,14 @@ typedef struct calc_shell_activator {
     celix_shell_command_t subCmd;
     long sqrtCmdSvcId;
     celix_shell_command_t sqrtCmd;
+    rsa_json_rpc_stub_t *stub;
 } calc_shell_activator_t;
 
 static celix_status_t calcShell_start(calc_shell_activator_t *activator, celix_bundle_context_t *ctx) {
+    //note the JSON-RPC remote service admin uses the generated stubs for the calculator proxy, if registered
+    activator->stub = NULL;
+    (void)rsaJsonRpcStub_register(ctx, &calculator_jsonRpcStubDefinition, &activator->stub);
+
     activator->addCmd.handle = ctx;
     activator->addCmd.executeCommand = addCommand_execute;
     celix_properties_t *props = celix_properties_create();
@@ -63,6 +69,7 @@ static celix_status_t calcShell_stop(calc_shell_activator_t *activator, celix_bu
     celix_bundleContext_unregisterService(ctx, activator->addCmdSvcId);
     celix_bundleContext_unregisterService(ctx, activator->subCmdSvcId);
     celix_bundleContext_unregisterService(ctx, activator->sqrtCmdSvcId);
+    rsaJsonRpcStub_unregister(activator->stub);
     return CELIX_SUCCESS;
 }
 
@@ -18,6 +18,8 @@
  */
 
 #include "gtest/gtest.h"
+#include <curl/curl.h>
+#include <string>
 #include <remote_constants.h>
 #include <tst_service.h>
 #include "celix_api.h"
@@ -291,6 +293,84 @@ typedef struct rsa_dfi_exception_test_service {
     }
 }
 
+#define SERVER_DISCOVERY_URL "http://localhost:50992/org.apache.celix.discovery.configured"
+
+static size_t discoveryResponseHeaderCallback(char *buffer, size_t size, size_t nitems, void *userdata) {
+    auto* etag = static_cast<std::string*>(userdata);
+    std::string header{buffer, size * nitems};
+    if (strncasecmp(header.c_str(), "ETag:", 5) == 0) {
+        auto begin = header.find('"');
+        auto end = header.rfind('"');
+        if (begin != std::string::npos && end > begin) {
+            *etag = header.substr(begin, end - begin + 1);
+        }
+    }
+    return size * nitems;
+}
+
+static size_t discoveryResponseBodyCallback(char *, size_t size, size_t nmemb, void *) {
+    return size * nmemb;
+}
+
+/**
+ * GETs all endpoints of the server discovery, optionally with an If-None-Match header.
+ * Returns the HTTP response code (0 if the request failed) and sets the received ETag.
+ */
+static long getAllServerEndpoints(const std::string& ifNoneMatch, std::string& etag) {
+    etag.clear();
+    CURL *curl = curl_easy_init();
+    if (curl == nullptr) {
+        return 0;
+    }
+    struct curl_slist *headers = nullptr;
+    if (!ifNoneMatch.empty()) {
+        headers = curl_slist_append(headers, ("If-None-Match: " + ifNoneMatch).c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, SERVER_DISCOVERY_URL);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, discoveryResponseHeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &etag);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discoveryResponseBodyCallback);
+    long responseCode = 0;
+    if (curl_easy_perform(curl) == CURLE_OK) {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+    }
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+    return responseCode;
+}
+
+/**
+ * Waits (max 5s) until the server discovery returns a full document for the provided ETag, i.e. until the endpoints
+ * of the server discovery differ from the endpoints for the provided ETag. Returns the new ETag.
+ */
+static std::string waitForChangedServerEndpoints(const std::string& ifNoneMatch) {
+    std::string etag{};
+    for (int i = 0; i < 500; ++i) {
+        if (getAllServerEndpoints(ifNoneMatch, etag) == 200) {
+            return etag;
+        }
+        usleep(10000);
+    }
+    return etag;
+}
+
+static long findServerBundle(const char* symbolicName) {
+    long result = -1L;
+    celix_array_list_t* bundleIds = celix_bundleContext_listBundles(serverContext);
+    for (int i = 0; i < celix_arrayList_size(bundleIds) && result < 0; ++i) {
+        long bndId = celix_arrayList_getLong(bundleIds, i);
+        char* name = celix_bundleContext_getBundleSymbolicName(serverContext, bndId);
+        if (name != nullptr && strcmp(name, symbolicName) == 0) {
+            result = bndId;
+        }
+        free(name);
+    }
+    celix_arrayList_destroy(bundleIds);
+    return result;
+}
+
 template<typename F>
 static void test(F&& f) {
     celix_service_use_options_t opts{};
@@ -402,3 +482,43 @@ TEST_F(RsaDfiClientServerInterceptorTests,TestInterceptorPreProxyCallReturnFalse
 TEST_F(RsaDfiClientServerExceptionTests,TestExceptionService) {
     testExceptionService();
 }
+
+TEST_F(RsaDfiClientServerTests, DiscoveryETagTest) {
+    //Given a client that imported the remote calculator, so that the server discovery serves its endpoints
+    test(testCalculator);
+
+    //When all endpoints are requested with the current ETag, then the server answers with 304 Not Modified
+    std::string etag{};
+    std::string receivedETag{};
+    long responseCode = 0;
+    for (int i = 0; i < 500 && responseCode != 304; ++i) { //note endpoints can still be added, so retry
+        etag = waitForChangedServerEndpoints("");
+        ASSERT_FALSE(etag.empty());
+        responseCode = getAllServerEndpoints(etag, receivedETag);
+    }
+    EXPECT_EQ(304, responseCode);
+    EXPECT_EQ(etag, receivedETag);
+
+    //And an unknown ETag results in the full document
+    EXPECT_EQ(200, getAllServerEndpoints("\"unknown\"", receivedETag));
+
+    //When a new service is exported, then the ETag changes
+    registerExceptionTestServer();
+    std::string etagAfterExport = waitForChangedServerEndpoints(etag);
+    EXPECT_FALSE(etagAfterExport.empty());
+    EXPECT_NE(etag, etagAfterExport);
+    unregisterExceptionTestServer();
+    std::string etagAfterUnexport = waitForChangedServerEndpoints(etagAfterExport);
+    EXPECT_NE(etagAfterExport, etagAfterUnexport);
+
+    //When the discovery bundle is restarted, then the ETag of the restarted server differs from the old ETags,
+    //even if it exposes the same endpoints with the same version
+    long discoveryBndId = findServerBundle("apache_celix_rsa_discovery");
+    ASSERT_GE(discoveryBndId, 0);
+    EXPECT_TRUE(celix_bundleContext_stopBundle(serverContext, discoveryBndId));
+    EXPECT_TRUE(celix_bundleContext_startBundle(serverContext, discoveryBndId));
+    std::string etagAfterRestart = waitForChangedServerEndpoints(etagAfterUnexport);
+    EXPECT_FALSE(etagAfterRestart.empty());
+    EXPECT_NE(etag, etagAfterRestart);
+    EXPECT_NE(etagAfterUnexport, etagAfterRestart);
+}
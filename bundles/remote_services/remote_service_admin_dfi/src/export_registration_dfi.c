@@ -207,22 +207,11 @@ celix_status_t exportRegistration_call(export_registration_t *export, char *data
 }
 
 static celix_status_t exportRegistration_findAndParseInterfaceDescriptor(celix_log_helper_t *helper, celix_bundle_context_t * const context, celix_bundle_t * const bundle, char const * const name, dyn_interface_type **out) {
-    FILE* descriptor = NULL;
-
-    celix_status_t status = dfi_findDescriptor(context, bundle, name, &descriptor);
-    if (status == CELIX_SUCCESS && descriptor != NULL) {
-        int rc = dynInterface_parse(descriptor, out);
-        fclose(descriptor);
-        if (rc != 0) {
-            celix_logHelper_logTssErrors(helper, CELIX_LOG_LEVEL_WARNING);
-            celix_logHelper_warning(helper, "RSA_DFI: Error parsing service descriptor for \"%s\", return code is %d.", name, rc);
-            status = CELIX_BUNDLE_EXCEPTION;
-        }
-        return status;
+    celix_status_t status = dfi_acquireInterfaceDescriptor(helper, context, bundle, name, NULL, out);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_log(helper, CELIX_LOG_LEVEL_WARNING, "RSA: Error finding/parsing service descriptor for '%s'", name);
     }
-
-    celix_logHelper_log(helper, CELIX_LOG_LEVEL_WARNING, "RSA: Error finding service descriptor for '%s'", name);
-    return CELIX_BUNDLE_EXCEPTION;
+    return status;
 }
 
 static void exportRegistration_destroyCallback(void* data) {
@@ -230,7 +219,7 @@ static void exportRegistration_destroyCallback(void* data) {
     if (reg->intf != NULL) {
         dyn_interface_type *intf = reg->intf;
         reg->intf = NULL;
-        dynInterface_destroy(intf);
+        dfi_releaseInterfaceDescriptor(intf);
     }
 
     if (reg->exportReference.endpoint != NULL) {
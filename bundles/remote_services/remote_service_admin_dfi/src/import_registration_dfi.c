@@ -204,21 +204,12 @@ void importRegistration_ungetService(void *handle, const celix_bundle_t *request
 }
 
 static celix_status_t importRegistration_findAndParseInterfaceDescriptor(celix_bundle_context_t * const context, celix_bundle_t * const bundle, char const * const name, dyn_interface_type **out) {
-    celix_status_t status = CELIX_SUCCESS;
-    FILE* descriptor = NULL;
-    status = dfi_findDescriptor(context, bundle, name, &descriptor);
-    if (status == CELIX_SUCCESS && descriptor != NULL) {
-        int rc = dynInterface_parse(descriptor, out);
-        fclose(descriptor);
-        if (rc != 0) {
-            fprintf(stderr, "RSA_DFI: Cannot parse dfi descriptor for '%s'", name);
-            status = CELIX_BUNDLE_EXCEPTION;
-        }
-        return status;
+    //note the (cached) interface is shared between proxies, including the closures for the proxy functions
+    celix_status_t status = dfi_acquireInterfaceDescriptor(NULL, context, bundle, name, importRegistration_proxyFunc, out);
+    if (status != CELIX_SUCCESS) {
+        fprintf(stderr, "RSA_DFI: Cannot find/parse dfi descriptor for '%s'", name);
     }
-
-    fprintf(stdout, "RSA: Cannot find/open any valid descriptor files for '%s'", name);
-    return CELIX_BUNDLE_EXCEPTION;
+    return status;
 }
 
 static celix_status_t importRegistration_createProxy(import_registration_t *import, celix_bundle_t *bundle, struct service_proxy **out) {
@@ -241,7 +232,7 @@ static celix_status_t importRegistration_createProxy(import_registration_t *impo
     	version_toString(consumerVersion,&cVerString);
     	version_toString(import->version,&pVerString);
     	printf("Service version mismatch: consumer has %s, provider has %s. NOT creating proxy.\n",cVerString,pVerString);
-    	dynInterface_destroy(intf);
+    	dfi_releaseInterfaceDescriptor(intf);
     	free(cVerString);
     	free(pVerString);
     	status = CELIX_SERVICE_EXCEPTION;
@@ -274,7 +265,7 @@ static celix_status_t importRegistration_createProxy(import_registration_t *impo
         void (*fn)(void) = NULL;
         int index = 0;
         TAILQ_FOREACH(entry, list, entries) {
-            int rc = dynFunction_createClosure(entry->dynFunc, importRegistration_proxyFunc, entry, &fn);
+            int rc = dynFunction_getFnPointer(entry->dynFunc, &fn);
             serv[index + 1] = fn;
             index += 1;
 
@@ -289,7 +280,7 @@ static celix_status_t importRegistration_createProxy(import_registration_t *impo
         *out = proxy;
     } else if (proxy != NULL) {
         if (proxy->intf != NULL) {
-            dynInterface_destroy(proxy->intf);
+            dfi_releaseInterfaceDescriptor(proxy->intf);
             proxy->intf = NULL;
         }
         free(proxy->service);
@@ -375,7 +366,7 @@ static void importRegistration_proxyFunc(void *userData, void *args[], void *ret
 static void importRegistration_destroyProxy(struct service_proxy *proxy) {
     if (proxy != NULL) {
         if (proxy->intf != NULL) {
-            dynInterface_destroy(proxy->intf);
+            dfi_releaseInterfaceDescriptor(proxy->intf);
         }
         if (proxy->service != NULL) {
             free(proxy->service);
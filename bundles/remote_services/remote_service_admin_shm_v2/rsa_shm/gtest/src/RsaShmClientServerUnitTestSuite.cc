@@ -21,6 +21,7 @@
 #include "shm_pool.h"
 #include "shm_cache.h"
 #include "rsa_shm_constants.h"
+#include "rsa_shm_worker_pool.h"
 #include "celix_log_helper.h"
 #include "celix_framework.h"
 #include "celix_bundle_context.h"
@@ -35,10 +36,11 @@
 #include "socket_ei.h"
 #include "stdio_ei.h"
 #include "pthread_ei.h"
-#include "thpool_ei.h"
 #include "celix_errno.h"
 #include <errno.h>
 #include <unistd.h>
+#include <future>
+#include <vector>
 #include <gtest/gtest.h>
 
 class RsaShmClientServerUnitTestSuite : public ::testing::Test {
@@ -62,6 +64,7 @@ public:
         celix_ei_expect_celix_longHashMap_create(nullptr, 0, nullptr);
         celix_ei_expect_shmPool_malloc(nullptr, 0, nullptr);
         celix_ei_expect_malloc(nullptr, 0, nullptr);
+        celix_ei_expect_calloc(nullptr, 0, nullptr);
         celix_ei_expect_celixThreadMutex_create(nullptr, 0, 0);
         celix_ei_expect_celixThread_create(nullptr, 0, 0);
         celix_ei_expect_celix_utils_strdup(nullptr, 0, nullptr);
@@ -78,8 +81,6 @@ public:
         celix_ei_expect_pthread_condattr_setpshared(nullptr, 1, 0);
         celix_ei_expect_pthread_cond_init(nullptr, 1, 0);
         celix_ei_expect_pthread_cond_timedwait(nullptr, 1, 0);
-        celix_ei_expect_thpool_init(nullptr, 0, nullptr);
-        celix_ei_expect_thpool_add_work(nullptr, 0, 0);
     }
 
 
@@ -132,6 +133,13 @@ TEST_F(RsaShmClientServerUnitTestSuite, SendMsg) {
     free(response.iov_base);
     celix_properties_destroy(metadata);
 
+    rsa_shm_server_metrics_t metrics{};
+    rsaShmServer_getMetrics(server, &metrics);
+    EXPECT_EQ(1, metrics.receivedMsgs);
+    EXPECT_EQ(0, metrics.pendingMsgs);
+    EXPECT_EQ(0, metrics.droppedMsgs);
+    EXPECT_EQ(0, metrics.invalidMsgs);
+
     rsaShmClientManager_destroyOrDetachClient(clientManager, "shm_test_server", serverId);
 
     rsaShmClientManager_destroy(clientManager);
@@ -745,11 +753,28 @@ TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateShmCache) {
     EXPECT_EQ(CELIX_ENOMEM, status);
 }
 
-TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateThpool) {
-    celix_ei_expect_thpool_init((void*)&rsaShmServer_create, 0, nullptr);
+TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateWorkerPool) {
+    celix_ei_expect_calloc((void*)&rsaShmWorkerPool_create, 0, nullptr);
     rsa_shm_server_t *server = nullptr;
     auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallbackWithBigResponse, nullptr, &server);
-    EXPECT_EQ(CELIX_ILLEGAL_STATE, status);
+    EXPECT_EQ(CELIX_ENOMEM, status);
+}
+
+TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateWorkerThread) {
+    //The worker threads are created before the receive threads
+    celix_ei_expect_celixThread_create(CELIX_EI_UNKNOWN_CALLER, 0, CELIX_ENOMEM);
+    rsa_shm_server_t *server = nullptr;
+    auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallbackWithBigResponse, nullptr, &server);
+    EXPECT_EQ(CELIX_ENOMEM, status);
+}
+
+TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateSecondWorkerThread) {
+    setenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY, "2", 1);
+    celix_ei_expect_celixThread_create(CELIX_EI_UNKNOWN_CALLER, 0, CELIX_ENOMEM, 2);
+    rsa_shm_server_t *server = nullptr;
+    auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallbackWithBigResponse, nullptr, &server);
+    unsetenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY);
+    EXPECT_EQ(CELIX_ENOMEM, status);
 }
 
 TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateReceiveThread) {
@@ -759,9 +784,52 @@ TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateReceiveThread) {
     EXPECT_EQ(CELIX_ENOMEM, status);
 }
 
-TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToAddWorkToThpool) {
+TEST_F(RsaShmClientServerUnitTestSuite, CreateShmServerWithInvalidThreadsConfig) {
+    rsa_shm_server_t *server = nullptr;
+    setenv(RSA_SHM_SERVER_RECEIVE_THREADS_NUM_KEY, "0", 1);
+    auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+    unsetenv(RSA_SHM_SERVER_RECEIVE_THREADS_NUM_KEY);
+
+    setenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY, "0", 1);
+    status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+    unsetenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY);
+
+    setenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY, "4", 1);
+    setenv(RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY, "2", 1);
+    status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+    unsetenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY);
+    unsetenv(RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY);
+
+    setenv(RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_KEY, "0", 1);
+    status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+    unsetenv(RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_KEY);
+
+    setenv(RSA_SHM_SERVER_MAX_PENDING_MSGS_KEY, "0", 1);
+    status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+    unsetenv(RSA_SHM_SERVER_MAX_PENDING_MSGS_KEY);
+}
+
+TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateSecondReceiveThread) {
+    celix_ei_expect_celixThread_create((void*)&rsaShmServer_create, 0, CELIX_ENOMEM, 2);
+    rsa_shm_server_t *server = nullptr;
+    auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_ENOMEM, status);
+}
+
+TEST_F(RsaShmClientServerUnitTestSuite, DropMsgWhenTooManyMsgsArePending) {
+    setenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY, "1", 1);
+    setenv(RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY, "1", 1);
+    setenv(RSA_SHM_SERVER_MAX_PENDING_MSGS_KEY, "1", 1);
     rsa_shm_server_t *server = nullptr;
     auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    unsetenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY);
+    unsetenv(RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY);
+    unsetenv(RSA_SHM_SERVER_MAX_PENDING_MSGS_KEY);
     EXPECT_EQ(CELIX_SUCCESS, status);
     EXPECT_NE(nullptr, server);
 
@@ -774,12 +842,117 @@ TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToAddWorkToThpool) {
     status = rsaShmClientManager_createOrAttachClient(clientManager, "shm_test_server", serverId);
     EXPECT_EQ(CELIX_SUCCESS, status);
 
+    expect_ReceiveMsgCallback_blocked = true;
+    auto sendMsg = [clientManager, serverId]() {
+        struct iovec request = {.iov_base = (void*)"request", .iov_len = strlen("request")};
+        struct iovec response = {.iov_base = nullptr, .iov_len = 0};
+        auto ret = rsaShmClientManager_sendMsgTo(clientManager, "shm_test_server", serverId, nullptr, &request, &response);
+        free(response.iov_base);
+        return ret;
+    };
+    //The first message occupies the worker thread, the second message is pending
+    std::vector<std::future<celix_status_t>> results{};
+    rsa_shm_server_metrics_t metrics{};
+    results.emplace_back(std::async(std::launch::async, sendMsg));
+    while (metrics.handlingMsgs != 1) {
+        usleep(1000);
+        rsaShmServer_getMetrics(server, &metrics);
+    }
+    results.emplace_back(std::async(std::launch::async, sendMsg));
+    while (metrics.pendingMsgs != 1) {
+        usleep(1000);
+        rsaShmServer_getMetrics(server, &metrics);
+    }
 
-    celix_ei_expect_thpool_add_work(CELIX_EI_UNKNOWN_CALLER, 0, -1);
-    struct iovec request = {.iov_base = (void*)"request", .iov_len = strlen("request")};
-    struct iovec response = {.iov_base = nullptr, .iov_len = 0};
-    status = rsaShmClientManager_sendMsgTo(clientManager, "shm_test_server", serverId, nullptr, &request, &response);
+    status = sendMsg();
     EXPECT_EQ(CELIX_ILLEGAL_STATE, status);
+    rsaShmServer_getMetrics(server, &metrics);
+    EXPECT_EQ(3, metrics.receivedMsgs);
+    EXPECT_EQ(1, metrics.droppedMsgs);
+
+    expect_ReceiveMsgCallback_blocked = false;
+    for (auto& result : results) {
+        EXPECT_EQ(CELIX_SUCCESS, result.get());
+    }
+
+    rsaShmClientManager_destroyOrDetachClient(clientManager, "shm_test_server", serverId);
+
+    rsaShmClientManager_destroy(clientManager);
+
+    rsaShmServer_destroy(server);
+}
+
+TEST_F(RsaShmClientServerUnitTestSuite, WorkerThreadsGrowAndShrinkWithLoad) {
+    setenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY, "1", 1);
+    setenv(RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY, "3", 1);
+    setenv(RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_KEY, "10", 1);
+    rsa_shm_server_t *server = nullptr;
+    auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    unsetenv(RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY);
+    unsetenv(RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY);
+    unsetenv(RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_KEY);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_NE(nullptr, server);
+
+    rsa_shm_server_metrics_t metrics{};
+    rsaShmServer_getMetrics(server, &metrics);
+    EXPECT_EQ(1, metrics.workerThreads);
+
+    rsa_shm_client_manager_t *clientManager = nullptr;
+    status = rsaShmClientManager_create(ctx.get(), logHelper.get(), &clientManager);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_NE(nullptr, clientManager);
+
+    long serverId = 100;//dummy id
+    status = rsaShmClientManager_createOrAttachClient(clientManager, "shm_test_server", serverId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    expect_ReceiveMsgCallback_blocked = true;
+    auto sendMsg = [clientManager, serverId]() {
+        struct iovec request = {.iov_base = (void*)"request", .iov_len = strlen("request")};
+        struct iovec response = {.iov_base = nullptr, .iov_len = 0};
+        auto ret = rsaShmClientManager_sendMsgTo(clientManager, "shm_test_server", serverId, nullptr, &request, &response);
+        free(response.iov_base);
+        return ret;
+    };
+    //Every blocked message occupies a worker thread, so the pool grows to the max worker threads
+    std::vector<std::future<celix_status_t>> results{};
+    for (int i = 0; i < 3; ++i) {
+        results.emplace_back(std::async(std::launch::async, sendMsg));
+    }
+    while (metrics.handlingMsgs != 3) {
+        usleep(1000);
+        rsaShmServer_getMetrics(server, &metrics);
+    }
+    EXPECT_EQ(3, metrics.workerThreads);
+    EXPECT_EQ(0, metrics.idleWorkerThreads);
+
+    expect_ReceiveMsgCallback_blocked = false;
+    for (auto& result : results) {
+        EXPECT_EQ(CELIX_SUCCESS, result.get());
+    }
+
+    //The idle worker threads exit after the idle timeout, until the min worker threads are left
+    while (metrics.workerThreads != 1) {
+        usleep(1000);
+        rsaShmServer_getMetrics(server, &metrics);
+    }
+
+    //The pool grows again when needed
+    expect_ReceiveMsgCallback_blocked = true;
+    results.clear();
+    for (int i = 0; i < 2; ++i) {
+        results.emplace_back(std::async(std::launch::async, sendMsg));
+    }
+    while (metrics.handlingMsgs != 2) {
+        usleep(1000);
+        rsaShmServer_getMetrics(server, &metrics);
+    }
+    EXPECT_EQ(2, metrics.workerThreads);
+    expect_ReceiveMsgCallback_blocked = false;
+    for (auto& result : results) {
+        EXPECT_EQ(CELIX_SUCCESS, result.get());
+    }
 
     rsaShmClientManager_destroyOrDetachClient(clientManager, "shm_test_server", serverId);
 
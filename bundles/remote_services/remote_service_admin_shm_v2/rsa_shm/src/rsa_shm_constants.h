@@ -77,6 +77,65 @@ extern "C" {
  */
 #define RSA_SHM_MAX_SVC_BREAKED_TIME_IN_S 60
 
+/**
+ * @brief A property of RsaShm bundle that indicates the number of threads receiving messages for the shm server.
+ * The receive threads share the server socket. Its value should be in the range [1, 16].
+ *
+ */
+#define RSA_SHM_SERVER_RECEIVE_THREADS_NUM_KEY "rsaShmServerRevThreadsNum"
+/**
+ * @brief The default number of shm server receive threads.
+ *
+ */
+#define RSA_SHM_SERVER_RECEIVE_THREADS_NUM_DEFAULT 2
+
+/**
+ * @brief A property of RsaShm bundle that indicates the minimum number of worker threads handling the messages of the shm server.
+ *
+ */
+#define RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY "rsaShmServerMinWorkerThreadsNum"
+/**
+ * @brief The default minimum number of shm server worker threads.
+ *
+ */
+#define RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_DEFAULT 2
+
+/**
+ * @brief A property of RsaShm bundle that indicates the maximum number of worker threads handling the messages of the shm server.
+ * Worker threads are added when there are more pending messages than idle worker threads.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY "rsaShmServerMaxWorkerThreadsNum"
+/**
+ * @brief The default maximum number of shm server worker threads.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_DEFAULT 16
+
+/**
+ * @brief A property of RsaShm bundle that indicates the time (in milliseconds) after which an idle worker thread is stopped,
+ * if there are more worker threads than the minimum number of worker threads.
+ *
+ */
+#define RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_KEY "rsaShmServerWorkerIdleTimeout"
+/**
+ * @brief The default idle timeout of shm server worker threads.
+ *
+ */
+#define RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_DEFAULT_IN_MS 10000
+
+/**
+ * @brief A property of RsaShm bundle that indicates the maximum number of received messages waiting for a worker thread.
+ * If there are more pending messages than its value, the new messages are rejected immediately.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_PENDING_MSGS_KEY "rsaShmServerMaxPendingMsgs"
+/**
+ * @brief The default maximum number of pending messages of the shm server.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_PENDING_MSGS_DEFAULT 1024
+
 /**
  * @brief Estimated remote service response default size
  *
@@ -17,6 +17,7 @@
  * under the License.
  */
 #include "rsa_shm_server.h"
+#include "rsa_shm_worker_pool.h"
 #include "rsa_shm_msg.h"
 #include "rsa_shm_constants.h"
 #include "shm_cache.h"
@@ -25,7 +26,6 @@
 #include "celix_build_assert.h"
 #include "celix_api.h"
 #include "celix_unistd_cleanup.h"
-#include <thpool.h>
 #include <sys/un.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -37,11 +37,11 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <errno.h>
+#include <inttypes.h>
 
-#define MAX_RSA_SHM_SERVER_HANDLE_MSG_THREADS_NUM 5
+#define MAX_RSA_SHM_SERVER_RECEIVE_THREADS_NUM 16
 
-// move to thpool.h once it is reused in other places
-CELIX_DEFINE_AUTO_CLEANUP_FREE_FUNC(threadpool, thpool_destroy, NULL)
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(rsa_shm_worker_pool_t, rsaShmWorkerPool_destroy)
 
 struct rsa_shm_server {
     celix_bundle_context_t *ctx;
@@ -49,15 +49,21 @@ struct rsa_shm_server {
     celix_log_helper_t *loghelper;
     int sfd;
     shm_cache_t *shmCache;
-    threadpool threadPool;
-    celix_thread_t revMsgThread;
+    rsa_shm_worker_pool_t *workerPool;
+    size_t revMsgThreadsNum;
+    celix_thread_t revMsgThreads[MAX_RSA_SHM_SERVER_RECEIVE_THREADS_NUM];
     bool revMsgThreadActive;
     rsaShmServer_receiveMsgCB revCB;
     void *revCBHandle;
     long msgTimeOutInSec;
+    //metrics, updated with atomic operations
+    size_t handlingMsgs;
+    uint64_t receivedMsgs;
+    uint64_t droppedMsgs;
+    uint64_t invalidMsgs;
 };
 
-struct rsa_shm_server_thpool_work_data {
+struct rsa_shm_server_work_data {
     rsa_shm_server_t *server;
     rsa_shm_msg_control_t *msgCtrl;
     void *msgBody;
@@ -67,6 +73,7 @@ struct rsa_shm_server_thpool_work_data {
 };
 
 static void *rsaShmServer_receiveMsgThread(void *data);
+static void rsaShmServer_stopReceiveMsgThreads(rsa_shm_server_t *server, size_t threadsNum);
 
 celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name, celix_log_helper_t *loghelper,
         rsaShmServer_receiveMsgCB receiveCB, void *revHandle, rsa_shm_server_t **shmServerOut) {
@@ -114,21 +121,44 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
     }
     server->shmCache = shmCache;
 
-    server->threadPool = thpool_init(MAX_RSA_SHM_SERVER_HANDLE_MSG_THREADS_NUM);
-    if (server->threadPool == NULL) {
-        celix_logHelper_error(loghelper, "RsaShmServer: create thread pool err.");
-        return CELIX_ILLEGAL_STATE;
+    long minWorkerThreadsNum = celix_bundleContext_getPropertyAsLong(ctx, RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_KEY,
+            RSA_SHM_SERVER_MIN_WORKER_THREADS_NUM_DEFAULT);
+    long maxWorkerThreadsNum = celix_bundleContext_getPropertyAsLong(ctx, RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_KEY,
+            RSA_SHM_SERVER_MAX_WORKER_THREADS_NUM_DEFAULT);
+    long workerIdleTimeout = celix_bundleContext_getPropertyAsLong(ctx, RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_KEY,
+            RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_DEFAULT_IN_MS);
+    long revMsgThreadsNum = celix_bundleContext_getPropertyAsLong(ctx, RSA_SHM_SERVER_RECEIVE_THREADS_NUM_KEY,
+            RSA_SHM_SERVER_RECEIVE_THREADS_NUM_DEFAULT);
+    long maxPendingMsgs = celix_bundleContext_getPropertyAsLong(ctx, RSA_SHM_SERVER_MAX_PENDING_MSGS_KEY,
+            RSA_SHM_SERVER_MAX_PENDING_MSGS_DEFAULT);
+    if (minWorkerThreadsNum <= 0 || maxWorkerThreadsNum < minWorkerThreadsNum || workerIdleTimeout <= 0
+            || revMsgThreadsNum <= 0 || revMsgThreadsNum > MAX_RSA_SHM_SERVER_RECEIVE_THREADS_NUM || maxPendingMsgs <= 0) {
+        celix_logHelper_error(loghelper, "RsaShmServer: Invalid threads configuration. %ld, %ld, %ld, %ld, %ld.",
+                minWorkerThreadsNum, maxWorkerThreadsNum, workerIdleTimeout, revMsgThreadsNum, maxPendingMsgs);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    status = rsaShmWorkerPool_create(loghelper, (size_t)minWorkerThreadsNum, (size_t)maxWorkerThreadsNum,
+            (size_t)maxPendingMsgs, workerIdleTimeout, &server->workerPool);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(loghelper, "RsaShmServer: create worker pool err. %d.", status);
+        return status;
     }
-    celix_auto(threadpool) thpool = server->threadPool;
+    celix_autoptr(rsa_shm_worker_pool_t) workerPool = server->workerPool;
     server->revCB = receiveCB;
     server->revCBHandle = revHandle;
     server->revMsgThreadActive = true;
-    status = celixThread_create(&server->revMsgThread, NULL, rsaShmServer_receiveMsgThread, server);
-    if (status != CELIX_SUCCESS) {
-        celix_logHelper_error(loghelper, "RsaShmServer: create receive msg thread err.");
-        return status;
+    //The datagram socket is shared by the receive threads, every message is received by one of them.
+    for (size_t i = 0; i < (size_t)revMsgThreadsNum; ++i) {
+        status = celixThread_create(&server->revMsgThreads[i], NULL, rsaShmServer_receiveMsgThread, server);
+        if (status != CELIX_SUCCESS) {
+            celix_logHelper_error(loghelper, "RsaShmServer: create receive msg thread err.");
+            rsaShmServer_stopReceiveMsgThreads(server, i);
+            return status;
+        }
     }
-    celix_steal_ptr(thpool);
+    server->revMsgThreadsNum = (size_t)revMsgThreadsNum;
+    celix_steal_ptr(workerPool);
     celix_steal_ptr(shmCache);
     celix_steal_fd(&sfd);
     celix_steal_ptr(serverName);
@@ -138,11 +168,11 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
 
 void rsaShmServer_destroy(rsa_shm_server_t *server) {
     if (server != NULL) {
-        server->revMsgThreadActive = false;
-        shutdown(server->sfd,SHUT_RD);
-        celixThread_join(server->revMsgThread, NULL);
-        thpool_wait(server->threadPool);
-        thpool_destroy(server->threadPool);
+        rsaShmServer_stopReceiveMsgThreads(server, server->revMsgThreadsNum);
+        rsaShmWorkerPool_destroy(server->workerPool);
+        celix_logHelper_info(server->loghelper, "RsaShmServer: %s received %" PRIu64 " messages, dropped %" PRIu64
+                " messages and %" PRIu64 " messages were invalid.", server->name, server->receivedMsgs,
+                server->droppedMsgs, server->invalidMsgs);
         shmCache_destroy(server->shmCache);
         close(server->sfd);
         free(server->name);
@@ -152,6 +182,30 @@ void rsaShmServer_destroy(rsa_shm_server_t *server) {
 }
 
 
+static void rsaShmServer_stopReceiveMsgThreads(rsa_shm_server_t *server, size_t threadsNum) {
+    __atomic_store_n(&server->revMsgThreadActive, false, __ATOMIC_RELEASE);
+    //wake up all receive threads
+    shutdown(server->sfd,SHUT_RD);
+    for (size_t i = 0; i < threadsNum; ++i) {
+        celixThread_join(server->revMsgThreads[i], NULL);
+    }
+}
+
+void rsaShmServer_getMetrics(rsa_shm_server_t *server, rsa_shm_server_metrics_t *metrics) {
+    assert(server != NULL);
+    assert(metrics != NULL);
+    rsa_shm_worker_pool_metrics_t poolMetrics;
+    rsaShmWorkerPool_getMetrics(server->workerPool, &poolMetrics);
+    metrics->pendingMsgs = poolMetrics.queuedWorks;
+    metrics->handlingMsgs = __atomic_load_n(&server->handlingMsgs, __ATOMIC_RELAXED);
+    metrics->workerThreads = poolMetrics.workers;
+    metrics->idleWorkerThreads = poolMetrics.idleWorkers;
+    metrics->receivedMsgs = __atomic_load_n(&server->receivedMsgs, __ATOMIC_RELAXED);
+    metrics->droppedMsgs = __atomic_load_n(&server->droppedMsgs, __ATOMIC_RELAXED);
+    metrics->invalidMsgs = __atomic_load_n(&server->invalidMsgs, __ATOMIC_RELAXED);
+    return;
+}
+
 static void rsaShmServer_terminateMsgHandling(rsa_shm_msg_control_t *ctrl) {
     assert(ctrl != NULL);
 
@@ -168,9 +222,10 @@ static void rsaShmServer_terminateMsgHandling(rsa_shm_msg_control_t *ctrl) {
 static void rsaShmServer_msgHandlingWork(void *data) {
     assert(data != NULL);
     int status =  CELIX_SUCCESS;
-    struct rsa_shm_server_thpool_work_data *workData = data;
+    struct rsa_shm_server_work_data *workData = data;
     rsa_shm_server_t *server = workData->server;
     assert(server != NULL);
+    __atomic_add_fetch(&server->handlingMsgs, 1, __ATOMIC_RELAXED);
 
     rsa_shm_msg_control_t *msgCtrl = (rsa_shm_msg_control_t *)workData->msgCtrl;
     char *msgBuffer = (char*)workData->msgBody;
@@ -239,6 +294,7 @@ static void rsaShmServer_msgHandlingWork(void *data) {
     shmCache_releaseMemoryPtr(server->shmCache, msgBuffer);
     shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
     free(data);
+    __atomic_sub_fetch(&server->handlingMsgs, 1, __ATOMIC_RELAXED);
     return;
 
 reply_err:
@@ -251,6 +307,7 @@ call_receive_cb_failed:
     shmCache_releaseMemoryPtr(server->shmCache, msgBuffer);
     shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
     free(data);
+    __atomic_sub_fetch(&server->handlingMsgs, 1, __ATOMIC_RELAXED);
     return;
 }
 
@@ -288,19 +345,24 @@ static void *rsaShmServer_receiveMsgThread(void *data) {
     ssize_t revBytes = 0;
     rsa_shm_msg_t msgInfo;
 
-    while (server->revMsgThreadActive) {
+    while (__atomic_load_n(&server->revMsgThreadActive, __ATOMIC_ACQUIRE)) {
         revBytes = recvfrom(server->sfd, &msgInfo, sizeof(msgInfo), 0, NULL, NULL);
         if (revBytes <= 0) {
-            celix_logHelper_error(server->loghelper, "RsaShmServer: recv msg err(%d) or recv zero-length datagrams.", errno);
+            if (__atomic_load_n(&server->revMsgThreadActive, __ATOMIC_ACQUIRE)) {
+                celix_logHelper_error(server->loghelper, "RsaShmServer: recv msg err(%d) or recv zero-length datagrams.", errno);
+            }
             continue;
         }
+        __atomic_add_fetch(&server->receivedMsgs, 1, __ATOMIC_RELAXED);
         if (revBytes <= sizeof(msgInfo.size) || rsaShmServer_msgInvalid(server, &msgInfo)) {
+            __atomic_add_fetch(&server->invalidMsgs, 1, __ATOMIC_RELAXED);
             celix_logHelper_error(server->loghelper,"RsaShmServer: Shm message info is invalid. It maybe cause memory leak!");
             continue;
         }
         rsa_shm_msg_control_t *msgCtrl = shmCache_getMemoryPtr(server->shmCache,
                 msgInfo.shmId, msgInfo.ctrlDataOffset);
         if (rsaShmServer_msgCtrlInvalid(server, msgCtrl)) {
+            __atomic_add_fetch(&server->invalidMsgs, 1, __ATOMIC_RELAXED);
             celix_logHelper_logTssErrors(server->loghelper, CELIX_LOG_LEVEL_ERROR);
             celix_logHelper_error(server->loghelper, "RsaShmServer: Get msg ctrl cache failed. It maybe cause memory leak!");
             continue;
@@ -308,12 +370,13 @@ static void *rsaShmServer_receiveMsgThread(void *data) {
         char *msgBody = shmCache_getMemoryPtr(server->shmCache, msgInfo.shmId,
                 msgInfo.msgBodyOffset);
         if (msgBody == NULL) {
+            __atomic_add_fetch(&server->invalidMsgs, 1, __ATOMIC_RELAXED);
             celix_logHelper_error(server->loghelper,"RsaShmServer: Get msg data buffer cache failed.");
             rsaShmServer_terminateMsgHandling(msgCtrl);
             shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
             continue;
         }
-        struct rsa_shm_server_thpool_work_data *workData = ( struct rsa_shm_server_thpool_work_data *)malloc(sizeof(*workData));
+        struct rsa_shm_server_work_data *workData = ( struct rsa_shm_server_work_data *)malloc(sizeof(*workData));
         assert(workData != NULL);
         workData->server = server;
         workData->msgCtrl = msgCtrl;
@@ -321,9 +384,16 @@ static void *rsaShmServer_receiveMsgThread(void *data) {
         workData->msgBodyTotalSize = msgInfo.msgBodyTotalSize;
         workData->metadataSize = msgInfo.metadataSize;
         workData->requestSize = msgInfo.requestSize;
-        int retVal = thpool_add_work(server->threadPool, (void *)rsaShmServer_msgHandlingWork, (void*)workData);
-        if (retVal != 0) {
-            celix_logHelper_error(server->loghelper, "RsaShmServer: maybe pool thread is full, error code is %d.", retVal);
+        celix_status_t status = rsaShmWorkerPool_addWork(server->workerPool, rsaShmServer_msgHandlingWork, workData);
+        if (status != CELIX_SUCCESS) {
+            //Reject the message immediately instead of letting the client wait for its timeout
+            uint64_t droppedMsgs = __atomic_add_fetch(&server->droppedMsgs, 1, __ATOMIC_RELAXED);
+            rsa_shm_server_metrics_t metrics;
+            rsaShmServer_getMetrics(server, &metrics);
+            celix_logHelper_warning(server->loghelper, "RsaShmServer: Too many pending messages(%zu), drop the message. "
+                    "%" PRIu64 " messages dropped.", metrics.pendingMsgs, droppedMsgs);
+            celix_logHelper_debug(server->loghelper, "RsaShmServer: %zu messages handling, %zu worker threads, %zu idle.",
+                    metrics.handlingMsgs, metrics.workerThreads, metrics.idleWorkerThreads);
             rsaShmServer_terminateMsgHandling(msgCtrl);
             shmCache_releaseMemoryPtr(server->shmCache, msgBody);
             shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
@@ -26,9 +26,23 @@ extern "C" {
 #include "shm_pool.h"
 #include "celix_log_helper.h"
 #include <sys/uio.h>
+#include <stdint.h>
 
 typedef struct rsa_shm_server rsa_shm_server_t;
 
+/**
+ * @brief The runtime metrics of a shm server.
+ */
+typedef struct rsa_shm_server_metrics {
+    size_t pendingMsgs;/// The number of received messages waiting for a worker thread (queue depth)
+    size_t handlingMsgs;/// The number of messages being handled by the worker threads
+    size_t workerThreads;/// The number of worker threads
+    size_t idleWorkerThreads;/// The number of idle worker threads
+    uint64_t receivedMsgs;/// The total number of received messages
+    uint64_t droppedMsgs;/// The total number of messages dropped, because too many messages were pending or the message could not be queued
+    uint64_t invalidMsgs;/// The total number of invalid messages
+} rsa_shm_server_metrics_t;
+
 typedef celix_status_t (*rsaShmServer_receiveMsgCB)(void *handle, rsa_shm_server_t *server,
         celix_properties_t *metadata, const struct iovec *request, struct iovec *response);
 
@@ -38,6 +52,12 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
 
 void rsaShmServer_destroy(rsa_shm_server_t *server);
 
+/**
+ * @brief Get a snapshot of the runtime metrics of the shm server.
+ * @note The metrics are also logged when the server is destroyed and, at debug level, when messages are dropped.
+ */
+void rsaShmServer_getMetrics(rsa_shm_server_t *server, rsa_shm_server_metrics_t *metrics);
+
 #ifdef __cplusplus
 }
 #endif
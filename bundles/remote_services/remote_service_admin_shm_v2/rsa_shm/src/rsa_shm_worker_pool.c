@@ -0,0 +1,310 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "rsa_shm_worker_pool.h"
+#include "celix_threads.h"
+#include "celix_utils.h"
+#include "celix_stdlib_cleanup.h"
+#include <semaphore.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+
+/**
+ * A cell of the bounded multi-producer multi-consumer queue. The sequence number of a cell tells whether the cell
+ * is free for the enqueue position (sequence == pos) or filled for the dequeue position (sequence == pos + 1).
+ */
+typedef struct rsa_shm_worker_pool_cell {
+    size_t sequence;//atomic
+    rsaShmWorkerPool_workFn work;
+    void *data;
+} rsa_shm_worker_pool_cell_t;
+
+typedef enum rsa_shm_worker_state {
+    RSA_SHM_WORKER_FREE,
+    RSA_SHM_WORKER_RUNNING,
+    RSA_SHM_WORKER_EXITED,//the thread is exiting and should be joined
+} rsa_shm_worker_state_e;
+
+typedef struct rsa_shm_worker {
+    rsa_shm_worker_pool_t *pool;
+    celix_thread_t thread;
+    rsa_shm_worker_state_e state;//protected by pool->mutex
+} rsa_shm_worker_t;
+
+struct rsa_shm_worker_pool {
+    celix_log_helper_t *logHelper;
+    size_t minWorkers;
+    size_t maxWorkers;
+    long idleTimeoutInMs;
+    size_t capacity;
+    rsa_shm_worker_pool_cell_t *cells;
+    size_t enqueuePos;//atomic
+    size_t dequeuePos;//atomic
+    sem_t workSem;//posted once per queued work item, idle worker threads wait on it
+    bool active;//atomic
+    size_t idleWorkers;//atomic
+    celix_thread_mutex_t mutex; //projects below
+    size_t workers;//updated with the mutex, can be read atomically
+    rsa_shm_worker_t *workerSlots;//maxWorkers slots
+};
+
+static celix_status_t rsaShmWorkerPool_addWorker(rsa_shm_worker_pool_t *pool);
+
+celix_status_t rsaShmWorkerPool_create(celix_log_helper_t *logHelper, size_t minWorkers, size_t maxWorkers,
+        size_t queueCapacity, long idleTimeoutInMs, rsa_shm_worker_pool_t **poolOut) {
+    if (logHelper == NULL || minWorkers == 0 || maxWorkers < minWorkers || queueCapacity == 0
+            || idleTimeoutInMs <= 0 || poolOut == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_autofree rsa_shm_worker_pool_t *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return CELIX_ENOMEM;
+    }
+    pool->logHelper = logHelper;
+    pool->minWorkers = minWorkers;
+    pool->maxWorkers = maxWorkers;
+    pool->idleTimeoutInMs = idleTimeoutInMs;
+    pool->capacity = queueCapacity;
+    celix_autofree rsa_shm_worker_pool_cell_t *cells = pool->cells = calloc(queueCapacity, sizeof(*cells));
+    if (cells == NULL) {
+        return CELIX_ENOMEM;
+    }
+    for (size_t i = 0; i < queueCapacity; ++i) {
+        cells[i].sequence = i;
+    }
+    celix_autofree rsa_shm_worker_t *workerSlots = pool->workerSlots = calloc(maxWorkers, sizeof(*workerSlots));
+    if (workerSlots == NULL) {
+        return CELIX_ENOMEM;
+    }
+    for (size_t i = 0; i < maxWorkers; ++i) {
+        workerSlots[i].pool = pool;
+        workerSlots[i].state = RSA_SHM_WORKER_FREE;
+    }
+    if (sem_init(&pool->workSem, 0, 0) != 0) {
+        celix_logHelper_error(logHelper, "RsaShmWorkerPool: Failed to create semaphore. %d.", errno);
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    celix_status_t status = celixThreadMutex_create(&pool->mutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "RsaShmWorkerPool: Failed to create mutex. %d.", status);
+        sem_destroy(&pool->workSem);
+        return status;
+    }
+    pool->active = true;
+    celix_steal_ptr(cells);
+    celix_steal_ptr(workerSlots);
+    for (size_t i = 0; i < minWorkers; ++i) {
+        status = rsaShmWorkerPool_addWorker(pool);
+        if (status != CELIX_SUCCESS) {
+            rsaShmWorkerPool_destroy(celix_steal_ptr(pool));
+            return status;
+        }
+    }
+    *poolOut = celix_steal_ptr(pool);
+    return CELIX_SUCCESS;
+}
+
+void rsaShmWorkerPool_destroy(rsa_shm_worker_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    __atomic_store_n(&pool->active, false, __ATOMIC_RELEASE);
+    //wake up all worker threads, they handle the queued work and then exit
+    for (size_t i = 0; i < pool->maxWorkers; ++i) {
+        sem_post(&pool->workSem);
+    }
+    //note no worker threads are added anymore, because no work is added anymore
+    for (size_t i = 0; i < pool->maxWorkers; ++i) {
+        rsa_shm_worker_t *worker = &pool->workerSlots[i];
+        celixThreadMutex_lock(&pool->mutex);
+        rsa_shm_worker_state_e state = worker->state;
+        celixThreadMutex_unlock(&pool->mutex);
+        if (state != RSA_SHM_WORKER_FREE) {
+            celixThread_join(worker->thread, NULL);
+        }
+    }
+    assert(pool->workers == 0);
+    celixThreadMutex_destroy(&pool->mutex);
+    sem_destroy(&pool->workSem);
+    free(pool->workerSlots);
+    free(pool->cells);
+    free(pool);
+}
+
+static bool rsaShmWorkerPool_enqueue(rsa_shm_worker_pool_t *pool, rsaShmWorkerPool_workFn work, void *data) {
+    rsa_shm_worker_pool_cell_t *cell = NULL;
+    size_t pos = __atomic_load_n(&pool->enqueuePos, __ATOMIC_RELAXED);
+    while (true) {
+        cell = &pool->cells[pos % pool->capacity];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&pool->enqueuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;//the queue is full
+        } else {
+            pos = __atomic_load_n(&pool->enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+    cell->work = work;
+    cell->data = data;
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool rsaShmWorkerPool_dequeue(rsa_shm_worker_pool_t *pool, rsaShmWorkerPool_workFn *work, void **data) {
+    rsa_shm_worker_pool_cell_t *cell = NULL;
+    size_t pos = __atomic_load_n(&pool->dequeuePos, __ATOMIC_RELAXED);
+    while (true) {
+        cell = &pool->cells[pos % pool->capacity];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&pool->dequeuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;//the queue is empty
+        } else {
+            pos = __atomic_load_n(&pool->dequeuePos, __ATOMIC_RELAXED);
+        }
+    }
+    *work = cell->work;
+    *data = cell->data;
+    __atomic_store_n(&cell->sequence, pos + pool->capacity, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Wait for work or the idle timeout.
+ * @return true if the idle timeout expired.
+ */
+static bool rsaShmWorkerPool_waitForWork(rsa_shm_worker_pool_t *pool) {
+    struct timespec now = celix_gettime(CLOCK_REALTIME);//sem_timedwait uses CLOCK_REALTIME
+    struct timespec timeout = celix_delayedTimespec(&now, (double)pool->idleTimeoutInMs / 1000.0);
+    while (sem_timedwait(&pool->workSem, &timeout) != 0) {
+        if (errno != EINTR) {
+            return errno == ETIMEDOUT;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Stop the worker thread if there are more than minWorkers worker threads.
+ * @return true if the worker thread should exit.
+ */
+static bool rsaShmWorkerPool_retireWorker(rsa_shm_worker_t *worker, bool force) {
+    rsa_shm_worker_pool_t *pool = worker->pool;
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&pool->mutex);
+    if (!force && pool->workers <= pool->minWorkers) {
+        return false;
+    }
+    worker->state = RSA_SHM_WORKER_EXITED;
+    __atomic_store_n(&pool->workers, pool->workers - 1, __ATOMIC_RELAXED);
+    if (!force) {
+        celix_logHelper_debug(pool->logHelper, "RsaShmWorkerPool: Idle worker thread stopped, %zu worker threads left.",
+                pool->workers);
+    }
+    return true;
+}
+
+static void* rsaShmWorkerPool_workerThread(void *data) {
+    rsa_shm_worker_t *worker = data;
+    rsa_shm_worker_pool_t *pool = worker->pool;
+    while (true) {
+        rsaShmWorkerPool_workFn work = NULL;
+        void *workData = NULL;
+        if (rsaShmWorkerPool_dequeue(pool, &work, &workData)) {
+            work(workData);
+            continue;
+        }
+        if (!__atomic_load_n(&pool->active, __ATOMIC_ACQUIRE)) {
+            (void)rsaShmWorkerPool_retireWorker(worker, true);
+            break;
+        }
+        __atomic_add_fetch(&pool->idleWorkers, 1, __ATOMIC_RELAXED);
+        bool timedOut = rsaShmWorkerPool_waitForWork(pool);
+        __atomic_sub_fetch(&pool->idleWorkers, 1, __ATOMIC_RELAXED);
+        if (timedOut && rsaShmWorkerPool_retireWorker(worker, false)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static celix_status_t rsaShmWorkerPool_addWorker(rsa_shm_worker_pool_t *pool) {
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&pool->mutex);
+    if (pool->workers >= pool->maxWorkers) {
+        return CELIX_SUCCESS;
+    }
+    rsa_shm_worker_t *worker = NULL;
+    for (size_t i = 0; i < pool->maxWorkers; ++i) {
+        if (pool->workerSlots[i].state != RSA_SHM_WORKER_RUNNING) {
+            worker = &pool->workerSlots[i];
+            break;
+        }
+    }
+    assert(worker != NULL);
+    if (worker->state == RSA_SHM_WORKER_EXITED) {
+        celixThread_join(worker->thread, NULL);
+        worker->state = RSA_SHM_WORKER_FREE;
+    }
+    celix_status_t status = celixThread_create(&worker->thread, NULL, rsaShmWorkerPool_workerThread, worker);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(pool->logHelper, "RsaShmWorkerPool: Failed to create worker thread. %d.", status);
+        return status;
+    }
+    worker->state = RSA_SHM_WORKER_RUNNING;
+    __atomic_store_n(&pool->workers, pool->workers + 1, __ATOMIC_RELAXED);
+    celix_logHelper_debug(pool->logHelper, "RsaShmWorkerPool: Worker thread added, %zu worker threads.", pool->workers);
+    return CELIX_SUCCESS;
+}
+
+celix_status_t rsaShmWorkerPool_addWork(rsa_shm_worker_pool_t *pool, rsaShmWorkerPool_workFn work, void *data) {
+    assert(pool != NULL);
+    assert(work != NULL);
+    if (!rsaShmWorkerPool_enqueue(pool, work, data)) {
+        return CELIX_ILLEGAL_STATE;
+    }
+    sem_post(&pool->workSem);
+    rsa_shm_worker_pool_metrics_t metrics;
+    rsaShmWorkerPool_getMetrics(pool, &metrics);
+    if (metrics.queuedWorks > metrics.idleWorkers && metrics.workers < pool->maxWorkers) {
+        //note the queued work is handled by the existing worker threads, also if adding a worker thread fails
+        (void)rsaShmWorkerPool_addWorker(pool);
+    }
+    return CELIX_SUCCESS;
+}
+
+void rsaShmWorkerPool_getMetrics(rsa_shm_worker_pool_t *pool, rsa_shm_worker_pool_metrics_t *metrics) {
+    assert(pool != NULL);
+    assert(metrics != NULL);
+    //note load the dequeue position first, the enqueue position is always >= the dequeue position
+    size_t dequeuePos = __atomic_load_n(&pool->dequeuePos, __ATOMIC_ACQUIRE);
+    size_t enqueuePos = __atomic_load_n(&pool->enqueuePos, __ATOMIC_ACQUIRE);
+    metrics->queuedWorks = enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    metrics->workers = __atomic_load_n(&pool->workers, __ATOMIC_RELAXED);
+    metrics->idleWorkers = __atomic_load_n(&pool->idleWorkers, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _RSA_SHM_WORKER_POOL_H_
+#define _RSA_SHM_WORKER_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "celix_log_helper.h"
+#include "celix_errno.h"
+#include <stddef.h>
+
+/**
+ * @brief An elastic worker thread pool for the shm server.
+ *
+ * The work is queued in a lock-free bounded queue. The pool keeps at least minWorkers threads. When work is added and
+ * there are more queued work items than idle worker threads, the pool adds a worker thread, up to maxWorkers threads.
+ * Worker threads which are idle for longer than the idle timeout are stopped, down to minWorkers threads.
+ */
+typedef struct rsa_shm_worker_pool rsa_shm_worker_pool_t;
+
+typedef void (*rsaShmWorkerPool_workFn)(void *data);
+
+/**
+ * @brief The runtime metrics of a worker pool.
+ */
+typedef struct rsa_shm_worker_pool_metrics {
+    size_t queuedWorks;/// The number of work items waiting for a worker thread (queue depth)
+    size_t workers;/// The number of worker threads
+    size_t idleWorkers;/// The number of idle worker threads
+} rsa_shm_worker_pool_metrics_t;
+
+/**
+ * @brief Create a worker pool and start minWorkers worker threads.
+ * @param[in] logHelper The log helper.
+ * @param[in] minWorkers The minimum number of worker threads, should be > 0.
+ * @param[in] maxWorkers The maximum number of worker threads, should be >= minWorkers.
+ * @param[in] queueCapacity The maximum number of queued work items, should be > 0.
+ * @param[in] idleTimeoutInMs The time after which an idle worker thread is stopped, if there are more than minWorkers threads.
+ * @param[out] poolOut The created worker pool.
+ * @return CELIX_SUCCESS, CELIX_ILLEGAL_ARGUMENT, CELIX_ENOMEM or the error of creating a worker thread.
+ */
+celix_status_t rsaShmWorkerPool_create(celix_log_helper_t *logHelper, size_t minWorkers, size_t maxWorkers,
+        size_t queueCapacity, long idleTimeoutInMs, rsa_shm_worker_pool_t **poolOut);
+
+/**
+ * @brief Destroy the worker pool. The queued work items are handled before the worker threads are stopped.
+ * @note No work should be added during or after the destroy.
+ */
+void rsaShmWorkerPool_destroy(rsa_shm_worker_pool_t *pool);
+
+/**
+ * @brief Queue a work item and add a worker thread if there are not enough idle worker threads.
+ * Can be called concurrently.
+ * @return CELIX_SUCCESS or CELIX_ILLEGAL_STATE if the queue is full.
+ */
+celix_status_t rsaShmWorkerPool_addWork(rsa_shm_worker_pool_t *pool, rsaShmWorkerPool_workFn work, void *data);
+
+/**
+ * @brief Get a snapshot of the runtime metrics of the worker pool.
+ */
+void rsaShmWorkerPool_getMetrics(rsa_shm_worker_pool_t *pool, rsa_shm_worker_pool_metrics_t *metrics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RSA_SHM_WORKER_POOL_H_ */
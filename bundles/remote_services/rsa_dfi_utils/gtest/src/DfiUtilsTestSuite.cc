@@ -18,6 +18,7 @@
  */
 
 #include <dfi_utils.h>
+#include <dyn_function.h>
 #include <celix_log_helper.h>
 #include <gtest/gtest.h>
 #include <memory>
@@ -83,4 +84,76 @@ TEST_F(DfiUtilsTestSuite, DescriptorFileNoExist) {
     curTestDescFile = "nonexistent-file";
     bool found = celix_bundleContext_useBundle(ctx.get(), descBundleId, this, useBundleCallbackForPasreNonexistentFile);
     EXPECT_TRUE(found);
-}
\ No newline at end of file
+}
+static void testClosureBind(void*, void**, void*) {
+    //nop
+}
+
+static void testClosureBind2(void*, void**, void*) {
+    //nop
+}
+
+static void useBundleCallbackForCachedDescriptor(void *handle, const celix_bundle_t *bundle) {
+    DfiUtilsTestSuite *testSuite = static_cast<DfiUtilsTestSuite *>(handle);
+    dyn_interface_type *intf1{nullptr};
+    auto status = dfi_acquireInterfaceDescriptor(testSuite->logHelper.get(), testSuite->ctx.get(), bundle,
+                                                 testSuite->curTestDescFile.c_str(), nullptr, &intf1);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_TRUE(intf1 != nullptr);
+
+    //same bundle and descriptor -> same (cached) interface, closures are created once
+    dyn_interface_type *intf2{nullptr};
+    status = dfi_acquireInterfaceDescriptor(testSuite->logHelper.get(), testSuite->ctx.get(), bundle,
+                                            testSuite->curTestDescFile.c_str(), testClosureBind, &intf2);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_EQ(intf1, intf2);
+    struct methods_head *list = nullptr;
+    dynInterface_methods(intf2, &list);
+    struct method_entry *entry = nullptr;
+    TAILQ_FOREACH(entry, list, entries) {
+        void (*fn)(void) = nullptr;
+        EXPECT_EQ(0, dynFunction_getFnPointer(entry->dynFunc, &fn));
+        EXPECT_TRUE(fn != nullptr);
+    }
+
+    //closures for another bind function are not supported for a shared interface
+    dyn_interface_type *intf3{nullptr};
+    status = dfi_acquireInterfaceDescriptor(testSuite->logHelper.get(), testSuite->ctx.get(), bundle,
+                                            testSuite->curTestDescFile.c_str(), testClosureBind2, &intf3);
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, status);
+    EXPECT_TRUE(intf3 == nullptr);
+
+    dfi_releaseInterfaceDescriptor(intf1);
+    dfi_releaseInterfaceDescriptor(intf2);
+
+    //all users released -> interface is parsed again
+    dyn_interface_type *intf4{nullptr};
+    status = dfi_acquireInterfaceDescriptor(testSuite->logHelper.get(), testSuite->ctx.get(), bundle,
+                                            testSuite->curTestDescFile.c_str(), testClosureBind2, &intf4);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_TRUE(intf4 != nullptr);
+    dfi_releaseInterfaceDescriptor(intf4);
+}
+
+TEST_F(DfiUtilsTestSuite, AcquireCachedDescriptor) {
+    curTestDescFile = "rsa_dfi_utils_test";
+    bool found = celix_bundleContext_useBundle(ctx.get(), descBundleId, this, useBundleCallbackForCachedDescriptor);
+    EXPECT_TRUE(found);
+    found = celix_bundleContext_useBundle(ctx.get(), 0, this, useBundleCallbackForCachedDescriptor);
+    EXPECT_TRUE(found);
+}
+
+static void useBundleCallbackForAcquireNonexistentFile(void *handle, const celix_bundle_t *bundle) {
+    DfiUtilsTestSuite *testSuite = static_cast<DfiUtilsTestSuite *>(handle);
+    dyn_interface_type *intfOut{nullptr};
+    auto status = dfi_acquireInterfaceDescriptor(testSuite->logHelper.get(), testSuite->ctx.get(), bundle,
+                                                 testSuite->curTestDescFile.c_str(), nullptr, &intfOut);
+    EXPECT_EQ(CELIX_BUNDLE_EXCEPTION, status);
+    EXPECT_TRUE(intfOut == nullptr);
+}
+
+TEST_F(DfiUtilsTestSuite, AcquireDescriptorFileNoExist) {
+    curTestDescFile = "nonexistent-file";
+    bool found = celix_bundleContext_useBundle(ctx.get(), descBundleId, this, useBundleCallbackForAcquireNonexistentFile);
+    EXPECT_TRUE(found);
+}
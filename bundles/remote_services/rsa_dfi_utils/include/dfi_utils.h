@@ -38,6 +38,36 @@ celix_status_t dfi_findAndParseInterfaceDescriptor(celix_log_helper_t *logHelper
         celix_bundle_context_t *ctx, const celix_bundle_t *svcOwner, const char *name,
         dyn_interface_type **intfOut);
 
+/**
+ * @brief Find and parse the interface descriptor for the provided service owner using a reference counted
+ * descriptor cache.
+ *
+ * Interface descriptors are cached per (service owner bundle, descriptor name, descriptor content), so importing or
+ * exporting many endpoints of the same interface parses the descriptor - and prepares the ffi cifs - only once.
+ * The returned interface is shared and should be treated as read-only. It must be released with
+ * dfi_releaseInterfaceDescriptor.
+ *
+ * @param logHelper The optional log helper used to log errors.
+ * @param closureBind If not NULL, ffi closures are created (once) for all interface methods, using closureBind as
+ *                    bind function and the method entry as user data. The closure function pointers can be retrieved
+ *                    with dynFunction_getFnPointer. Note that a closure is shared between all users of the interface,
+ *                    so the bind function should use the first (handle) argument to find the target.
+ * @param intfOut The cached interface.
+ * @return CELIX_SUCCESS if the interface descriptor is found and parsed, CELIX_ILLEGAL_ARGUMENT for invalid arguments,
+ * CELIX_ILLEGAL_STATE if the cached interface already has closures for another bind function or
+ * CELIX_BUNDLE_EXCEPTION if the descriptor cannot be found, parsed or no closures can be created.
+ */
+celix_status_t dfi_acquireInterfaceDescriptor(celix_log_helper_t *logHelper,
+        celix_bundle_context_t *ctx, const celix_bundle_t *svcOwner, const char *name,
+        void (*closureBind)(void *userData, void *args[], void *ret), dyn_interface_type **intfOut);
+
+/**
+ * @brief Release an interface acquired with dfi_acquireInterfaceDescriptor.
+ *
+ * The interface is destroyed when it is released by all its users.
+ */
+void dfi_releaseInterfaceDescriptor(dyn_interface_type *intf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,9 +18,29 @@
  */
 
 #include "dfi_utils.h"
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include "celix_bundle_context.h"
+#include "celix_long_hash_map.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_string_hash_map.h"
+#include "celix_threads.h"
+#include "dyn_function.h"
+
+typedef struct dfi_interface_cache_entry {
+    char* key; //"<bnd id>/<name>/<descriptor content>", also used as (weakly stored) key in the entries map
+    dyn_interface_type* intf;
+    size_t useCount;
+    void (*closureBind)(void *userData, void *args[], void *ret);
+} dfi_interface_cache_entry_t;
+
+static struct {
+    celix_thread_mutex_t mutex; //protects below
+    celix_string_hash_map_t* entries; //key = "<bnd id>/<name>/<descriptor content>", value = dfi_interface_cache_entry_t*
+    celix_long_hash_map_t* entriesByIntf; //key = dyn_interface_type* as long, value = dfi_interface_cache_entry_t*
+} g_dfiInterfaceCache = {CELIX_THREAD_MUTEX_INITIALIZER, NULL, NULL};
 
 static celix_status_t dfi_findFileForFramework(celix_bundle_context_t *context, const char *fileName, FILE **out) {
     celix_status_t  status = CELIX_SUCCESS;
@@ -123,3 +143,169 @@ celix_status_t dfi_findAndParseInterfaceDescriptor(celix_log_helper_t *logHelper
     return CELIX_BUNDLE_EXCEPTION;
 }
 
+static char* dfi_readDescriptor(FILE* descriptor) {
+    if (fseek(descriptor, 0, SEEK_END) != 0) {
+        return NULL;
+    }
+    long size = ftell(descriptor);
+    if (size < 0 || fseek(descriptor, 0, SEEK_SET) != 0) {
+        return NULL;
+    }
+    celix_autofree char* content = malloc((size_t)size + 1);
+    if (content == NULL || fread(content, 1, (size_t)size, descriptor) != (size_t)size) {
+        return NULL;
+    }
+    content[size] = '\0';
+    return celix_steal_ptr(content);
+}
+
+static void dfi_destroyInterfaceCacheEntry(dfi_interface_cache_entry_t* entry) {
+    dynInterface_destroy(entry->intf);
+    free(entry->key);
+    free(entry);
+}
+
+static celix_status_t dfi_createClosures(dfi_interface_cache_entry_t* entry,
+                                         void (*closureBind)(void *userData, void *args[], void *ret)) {
+    //precondition g_dfiInterfaceCache.mutex locked
+    if (entry->closureBind == closureBind) {
+        return CELIX_SUCCESS;
+    } else if (entry->closureBind != NULL) {
+        return CELIX_ILLEGAL_STATE;
+    }
+    struct methods_head* list = NULL;
+    dynInterface_methods(entry->intf, &list);
+    struct method_entry* mEntry = NULL;
+    TAILQ_FOREACH(mEntry, list, entries) {
+        void (*fn)(void) = NULL;
+        if (dynFunction_getFnPointer(mEntry->dynFunc, &fn) == 0) {
+            continue; //closure created in an earlier (partially failed) attempt
+        }
+        if (dynFunction_createClosure(mEntry->dynFunc, closureBind, mEntry, &fn) != 0) {
+            return CELIX_BUNDLE_EXCEPTION;
+        }
+    }
+    entry->closureBind = closureBind;
+    return CELIX_SUCCESS;
+}
+
+celix_status_t dfi_acquireInterfaceDescriptor(celix_log_helper_t *logHelper,
+        celix_bundle_context_t *ctx, const celix_bundle_t *svcOwner, const char *name,
+        void (*closureBind)(void *userData, void *args[], void *ret), dyn_interface_type **intfOut) {
+    if (ctx == NULL || svcOwner == NULL || name == NULL || intfOut == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    FILE* descriptor = NULL;
+    celix_status_t status = dfi_findDescriptor(ctx, svcOwner, name, &descriptor);
+    if (status != CELIX_SUCCESS || descriptor == NULL) {
+        if (logHelper != NULL) {
+            celix_logHelper_error(logHelper, "Cannot find/open any valid descriptor files for '%s'", name);
+        }
+        return CELIX_BUNDLE_EXCEPTION;
+    }
+    celix_autofree char* content = dfi_readDescriptor(descriptor);
+    fclose(descriptor);
+    if (content == NULL) {
+        if (logHelper != NULL) {
+            celix_logHelper_error(logHelper, "Cannot read dfi descriptor for '%s'", name);
+        }
+        return CELIX_BUNDLE_EXCEPTION;
+    }
+    //note keyed on the full descriptor content, so that a cache hit is always the same descriptor
+    celix_autofree char* key = NULL;
+    if (asprintf(&key, "%li/%s/%s", celix_bundle_getId(svcOwner), name, content) < 0) {
+        return CELIX_ENOMEM;
+    }
+
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&g_dfiInterfaceCache.mutex);
+    if (g_dfiInterfaceCache.entries == NULL) {
+        celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+        opts.storeKeysWeakly = true; //note the key is owned by the entry
+        g_dfiInterfaceCache.entries = celix_stringHashMap_createWithOptions(&opts);
+        g_dfiInterfaceCache.entriesByIntf = celix_longHashMap_create();
+        if (g_dfiInterfaceCache.entries == NULL || g_dfiInterfaceCache.entriesByIntf == NULL) {
+            celix_stringHashMap_destroy(g_dfiInterfaceCache.entries);
+            celix_longHashMap_destroy(g_dfiInterfaceCache.entriesByIntf);
+            g_dfiInterfaceCache.entries = NULL;
+            g_dfiInterfaceCache.entriesByIntf = NULL;
+            return CELIX_ENOMEM;
+        }
+    }
+    dfi_interface_cache_entry_t* entry = celix_stringHashMap_get(g_dfiInterfaceCache.entries, key);
+    bool created = false;
+    if (entry == NULL) {
+        entry = calloc(1, sizeof(*entry));
+        if (entry == NULL) {
+            return CELIX_ENOMEM;
+        }
+        FILE* stream = fmemopen(content, strlen(content), "r");
+        int rc = stream == NULL ? 1 : dynInterface_parse(stream, &entry->intf);
+        if (stream != NULL) {
+            fclose(stream);
+        }
+        if (rc != 0) {
+            if (logHelper != NULL) {
+                celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
+                celix_logHelper_error(logHelper, "Cannot parse dfi descriptor for '%s'", name);
+            }
+            free(entry);
+            return CELIX_BUNDLE_EXCEPTION;
+        }
+        entry->key = celix_steal_ptr(key);
+        if (celix_stringHashMap_put(g_dfiInterfaceCache.entries, entry->key, entry) != CELIX_SUCCESS) {
+            dfi_destroyInterfaceCacheEntry(entry);
+            return CELIX_ENOMEM;
+        }
+        if (celix_longHashMap_put(g_dfiInterfaceCache.entriesByIntf, (long)(uintptr_t)entry->intf, entry) != CELIX_SUCCESS) {
+            celix_stringHashMap_remove(g_dfiInterfaceCache.entries, entry->key);
+            dfi_destroyInterfaceCacheEntry(entry);
+            return CELIX_ENOMEM;
+        }
+        created = true;
+    }
+
+    if (closureBind != NULL) {
+        status = dfi_createClosures(entry, closureBind);
+        if (status != CELIX_SUCCESS) {
+            if (logHelper != NULL) {
+                celix_logHelper_error(logHelper, "Cannot create closures for dfi interface '%s'", name);
+            }
+            if (created) {
+                celix_longHashMap_remove(g_dfiInterfaceCache.entriesByIntf, (long)(uintptr_t)entry->intf);
+                celix_stringHashMap_remove(g_dfiInterfaceCache.entries, entry->key);
+                dfi_destroyInterfaceCacheEntry(entry);
+            }
+            return status;
+        }
+    }
+    entry->useCount += 1;
+    *intfOut = entry->intf;
+    return CELIX_SUCCESS;
+}
+
+void dfi_releaseInterfaceDescriptor(dyn_interface_type *intf) {
+    if (intf == NULL) {
+        return;
+    }
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&g_dfiInterfaceCache.mutex);
+    if (g_dfiInterfaceCache.entries == NULL) {
+        return;
+    }
+    dfi_interface_cache_entry_t* entry = celix_longHashMap_get(g_dfiInterfaceCache.entriesByIntf, (long)(uintptr_t)intf);
+    if (entry == NULL) {
+        return;
+    }
+    entry->useCount -= 1;
+    if (entry->useCount == 0) {
+        celix_longHashMap_remove(g_dfiInterfaceCache.entriesByIntf, (long)(uintptr_t)intf);
+        celix_stringHashMap_remove(g_dfiInterfaceCache.entries, entry->key);
+        dfi_destroyInterfaceCacheEntry(entry);
+    }
+    if (celix_stringHashMap_size(g_dfiInterfaceCache.entries) == 0) {
+        celix_stringHashMap_destroy(g_dfiInterfaceCache.entries);
+        celix_longHashMap_destroy(g_dfiInterfaceCache.entriesByIntf);
+        g_dfiInterfaceCache.entries = NULL;
+        g_dfiInterfaceCache.entriesByIntf = NULL;
+    }
+}
@@ -0,0 +1,330 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "rsa_json_rpc_stub_test_json_rpc_stub.h"
+#include "rsa_json_rpc_stub.h"
+#include "rsa_json_rpc_stub_service.h"
+#include "json_rpc.h"
+#include "dyn_interface.h"
+#include "celix_constants.h"
+#include "celix_err.h"
+#include "celix_framework_factory.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+typedef enum test_enum {
+    TEST_ENUM_VAL1 = 2,
+    TEST_ENUM_VAL2 = 4,
+} test_enum_e;
+
+typedef struct test_struct {
+    double d;
+    int32_t i;
+    char *name;
+    test_enum_e e;
+} test_struct_t;
+
+typedef struct rsa_json_rpc_stub_test_service {
+    void *handle;
+    int (*add)(void *handle, double a, double b, double *result);
+    int (*fib)(void *handle, int32_t n, int32_t *result);
+    int (*setName)(void *handle, char *name, char **result);
+    int (*echoName)(void *handle, const char *name, char **result);
+    int (*setEnum)(void *handle, test_enum_e e, test_enum_e *result);
+    int (*action)(void *handle);
+    int (*setStruct)(void *handle, test_struct_t *input, test_struct_t **result);
+    int (*getStruct)(void *handle, test_struct_t *result);
+} rsa_json_rpc_stub_test_service_t;
+
+class RsaJsonRpcStubTestSuite : public ::testing::Test {
+public:
+    RsaJsonRpcStubTestSuite() {
+        testSvc.handle = this;
+        testSvc.add = [](void *, double a, double b, double *result) {
+            *result = a + b;
+            return 0;
+        };
+        testSvc.fib = [](void *, int32_t n, int32_t *result) {
+            if (n < 0) {
+                return CELIX_ILLEGAL_ARGUMENT;
+            }
+            int32_t prev = 0;
+            int32_t cur = 1;
+            for (int32_t i = 0; i < n; ++i) {
+                int32_t next = prev + cur;
+                prev = cur;
+                cur = next;
+            }
+            *result = prev;
+            return CELIX_SUCCESS;
+        };
+        testSvc.setName = [](void *handle, char *name, char **result) {
+            auto *suite = static_cast<RsaJsonRpcStubTestSuite *>(handle);
+            suite->lastName = name;
+            free(name); //callee is owner of a non-const string
+            *result = strdup(suite->lastName.c_str());
+            return 0;
+        };
+        testSvc.echoName = [](void *, const char *name, char **result) {
+            *result = strdup(name);
+            return 0;
+        };
+        testSvc.setEnum = [](void *, test_enum_e e, test_enum_e *result) {
+            *result = e == TEST_ENUM_VAL1 ? TEST_ENUM_VAL2 : TEST_ENUM_VAL1;
+            return 0;
+        };
+        testSvc.action = [](void *handle) {
+            static_cast<RsaJsonRpcStubTestSuite *>(handle)->actionCount += 1;
+            return 0;
+        };
+        testSvc.setStruct = [](void *, test_struct_t *input, test_struct_t **result) {
+            auto *output = static_cast<test_struct_t *>(calloc(1, sizeof(test_struct_t)));
+            output->d = input->d * 2;
+            output->i = input->i * 2;
+            output->name = strdup(input->name);
+            output->e = input->e;
+            *result = output;
+            return 0;
+        };
+        testSvc.getStruct = [](void *, test_struct_t *result) {
+            result->d = 1.5;
+            result->i = 42;
+            result->name = strdup("struct");
+            result->e = TEST_ENUM_VAL2;
+            return 0;
+        };
+
+        celix_status_t status = rsaJsonRpcStub_create(&rsa_json_rpc_stub_test_jsonRpcStubDefinition, &stub);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        stubSvc = rsaJsonRpcStub_getService(stub);
+
+        transport.handle = this;
+        transport.sendRequest = [](void *handle, const char *, const char *request, char **reply) -> celix_status_t {
+            auto *suite = static_cast<RsaJsonRpcStubTestSuite *>(handle);
+            suite->lastRequest = request;
+            int rc;
+            if (suite->dynamicEndpoint != nullptr) {
+                rc = jsonRpc_call(suite->dynamicEndpoint, &suite->testSvc, request, reply);
+            } else {
+                rc = suite->stubSvc->call(suite->stubSvc->handle, &suite->testSvc, request, reply);
+            }
+            return rc == 0 ? CELIX_SUCCESS : CELIX_SERVICE_EXCEPTION;
+        };
+        void *svc = nullptr;
+        status = stubSvc->createProxy(stubSvc->handle, &transport, &svc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        proxy = static_cast<rsa_json_rpc_stub_test_service_t *>(svc);
+    }
+
+    RsaJsonRpcStubTestSuite(const RsaJsonRpcStubTestSuite&) = delete;
+    RsaJsonRpcStubTestSuite& operator=(const RsaJsonRpcStubTestSuite&) = delete;
+
+    ~RsaJsonRpcStubTestSuite() override {
+        stubSvc->destroyProxy(stubSvc->handle, proxy);
+        if (dynamicEndpoint != nullptr) {
+            dynInterface_destroy(dynamicEndpoint);
+        }
+        rsaJsonRpcStub_destroy(stub);
+        celix_err_resetErrors();
+    }
+
+    void useDynamicEndpoint() {
+        const char *descriptor = rsa_json_rpc_stub_test_jsonRpcStubDefinition.descriptor;
+        FILE *stream = fmemopen((void *)descriptor, strlen(descriptor), "r");
+        ASSERT_NE(nullptr, stream);
+        int rc = dynInterface_parse(stream, &dynamicEndpoint);
+        fclose(stream);
+        ASSERT_EQ(0, rc);
+    }
+
+    void testAllMethods() {
+        double sum = 0;
+        EXPECT_EQ(CELIX_SUCCESS, proxy->add(proxy->handle, 1.5, 2.25, &sum));
+        EXPECT_EQ(3.75, sum);
+
+        int32_t fib = 0;
+        EXPECT_EQ(CELIX_SUCCESS, proxy->fib(proxy->handle, 10, &fib));
+        EXPECT_EQ(55, fib);
+
+        char *name = nullptr;
+        EXPECT_EQ(CELIX_SUCCESS, proxy->setName(proxy->handle, strdup("hello"), &name));
+        EXPECT_STREQ("hello", name);
+        EXPECT_EQ("hello", lastName);
+        free(name);
+
+        name = nullptr;
+        EXPECT_EQ(CELIX_SUCCESS, proxy->echoName(proxy->handle, "world", &name));
+        EXPECT_STREQ("world", name);
+        free(name);
+
+        test_enum_e e = TEST_ENUM_VAL1;
+        EXPECT_EQ(CELIX_SUCCESS, proxy->setEnum(proxy->handle, TEST_ENUM_VAL1, &e));
+        EXPECT_EQ(TEST_ENUM_VAL2, e);
+
+        EXPECT_EQ(CELIX_SUCCESS, proxy->action(proxy->handle));
+        EXPECT_EQ(1, actionCount);
+
+        char structName[] = "input";
+        test_struct_t input{1.25, 21, structName, TEST_ENUM_VAL2};
+        test_struct_t *output = nullptr;
+        EXPECT_EQ(CELIX_SUCCESS, proxy->setStruct(proxy->handle, &input, &output));
+        ASSERT_NE(nullptr, output);
+        EXPECT_EQ(2.5, output->d);
+        EXPECT_EQ(42, output->i);
+        EXPECT_STREQ("input", output->name);
+        EXPECT_EQ(TEST_ENUM_VAL2, output->e);
+        free(output->name);
+        free(output);
+
+        test_struct_t preAllocated{};
+        EXPECT_EQ(CELIX_SUCCESS, proxy->getStruct(proxy->handle, &preAllocated));
+        EXPECT_EQ(1.5, preAllocated.d);
+        EXPECT_EQ(42, preAllocated.i);
+        EXPECT_STREQ("struct", preAllocated.name);
+        EXPECT_EQ(TEST_ENUM_VAL2, preAllocated.e);
+        free(preAllocated.name);
+    }
+
+    rsa_json_rpc_stub_test_service_t testSvc{};
+    rsa_json_rpc_stub_t *stub{nullptr};
+    const rsa_json_rpc_stub_service_t *stubSvc{nullptr};
+    rsa_json_rpc_stub_transport_t transport{};
+    rsa_json_rpc_stub_test_service_t *proxy{nullptr};
+    dyn_interface_type *dynamicEndpoint{nullptr};
+    std::string lastRequest{};
+    std::string lastName{};
+    int actionCount{0};
+};
+
+TEST_F(RsaJsonRpcStubTestSuite, CallMethodsWithStubs) {
+    testAllMethods();
+    EXPECT_STREQ("{\"m\":\"getStruct\",\"a\":[]}", lastRequest.c_str());
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, CallStubProxyWithDynamicEndpoint) {
+    useDynamicEndpoint();
+    testAllMethods();
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, CallStubEndpointWithDynamicRequest) {
+    useDynamicEndpoint();
+    struct methods_head *methods = nullptr;
+    dynInterface_methods(dynamicEndpoint, &methods);
+    struct method_entry *add = TAILQ_FIRST(methods);
+    ASSERT_STREQ("add", add->id);
+
+    void *handle = proxy;
+    double a = 2.0;
+    double b = 3.5;
+    double result = 0;
+    double *resultPtr = &result;
+    void *args[] = {&handle, &a, &b, &resultPtr};
+    char *request = nullptr;
+    ASSERT_EQ(0, jsonRpc_prepareInvokeRequest(add->dynFunc, add->id, args, &request));
+
+    char *reply = nullptr;
+    EXPECT_EQ(0, stubSvc->call(stubSvc->handle, &testSvc, request, &reply));
+    int rsErrno = -1;
+    EXPECT_EQ(0, jsonRpc_handleReply(add->dynFunc, reply, args, &rsErrno));
+    EXPECT_EQ(0, rsErrno);
+    EXPECT_EQ(5.5, result);
+    free(request);
+    free(reply);
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, ReturnRemoteError) {
+    int32_t fib = 0;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, proxy->fib(proxy->handle, -1, &fib));
+    EXPECT_EQ(0, fib);
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, CallProxyWithoutHandle) {
+    double sum = 0;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, proxy->add(nullptr, 1.0, 2.0, &sum));
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, CallWithInvalidRequest) {
+    char *reply = nullptr;
+    EXPECT_NE(0, stubSvc->call(stubSvc->handle, &testSvc, "invalid", &reply));
+    EXPECT_NE(0, stubSvc->call(stubSvc->handle, &testSvc, "{\"a\":[]}", &reply));
+    EXPECT_NE(0, stubSvc->call(stubSvc->handle, &testSvc, "{\"m\":\"unknown\",\"a\":[]}", &reply));
+    EXPECT_NE(0, stubSvc->call(stubSvc->handle, &testSvc, "{\"m\":\"add\",\"a\":[1.0]}", &reply));
+    EXPECT_NE(0, stubSvc->call(stubSvc->handle, &testSvc, "{\"m\":\"echoName\",\"a\":[1]}", &reply));
+    EXPECT_EQ(nullptr, reply);
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, ReplyWithoutExpectedResult) {
+    transport.sendRequest = [](void *, const char *, const char *, char **reply) -> celix_status_t {
+        *reply = strdup("{}");
+        return CELIX_SUCCESS;
+    };
+    double sum = 0;
+    EXPECT_EQ(CELIX_SERVICE_EXCEPTION, proxy->add(proxy->handle, 1.0, 2.0, &sum));
+    EXPECT_EQ(CELIX_SUCCESS, proxy->action(proxy->handle));
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, FailedToSendRequest) {
+    transport.sendRequest = [](void *, const char *, const char *, char **) -> celix_status_t {
+        return CELIX_ENOMEM;
+    };
+    double sum = 0;
+    EXPECT_EQ(CELIX_ENOMEM, proxy->add(proxy->handle, 1.0, 2.0, &sum));
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, CreateStubWithMismatchingDefinition) {
+    rsa_json_rpc_stub_definition_t definition = rsa_json_rpc_stub_test_jsonRpcStubDefinition;
+    definition.interfaceVersion = "2.0.0";
+    rsa_json_rpc_stub_t *invalidStub = nullptr;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaJsonRpcStub_create(&definition, &invalidStub));
+
+    definition = rsa_json_rpc_stub_test_jsonRpcStubDefinition;
+    definition.nrOfMethods -= 1;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaJsonRpcStub_create(&definition, &invalidStub));
+
+    definition = rsa_json_rpc_stub_test_jsonRpcStubDefinition;
+    definition.descriptor = "invalid";
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaJsonRpcStub_create(&definition, &invalidStub));
+    EXPECT_EQ(nullptr, invalidStub);
+}
+
+TEST_F(RsaJsonRpcStubTestSuite, RegisterStubService) {
+    auto *props = celix_properties_create();
+    celix_properties_set(props, CELIX_FRAMEWORK_CACHE_DIR, ".rsa_json_rpc_stub_cache");
+    std::shared_ptr<celix_framework_t> fw{celix_frameworkFactory_createFramework(props),
+                                          [](auto *f) { celix_frameworkFactory_destroyFramework(f); }};
+    auto *ctx = celix_framework_getFrameworkContext(fw.get());
+
+    rsa_json_rpc_stub_t *registeredStub = nullptr;
+    celix_status_t status = rsaJsonRpcStub_register(ctx, &rsa_json_rpc_stub_test_jsonRpcStubDefinition,
+                                                    &registeredStub);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    celix_service_filter_options_t opts{};
+    opts.serviceName = RSA_JSON_RPC_STUB_SERVICE_NAME;
+    opts.filter = "(&(" RSA_JSON_RPC_STUB_INTERFACE_NAME "=rsa_json_rpc_stub_test)("
+                  RSA_JSON_RPC_STUB_INTERFACE_VERSION "=1.0.0))";
+    EXPECT_GE(celix_bundleContext_findServiceWithOptions(ctx, &opts), 0);
+
+    rsaJsonRpcStub_unregister(registeredStub);
+    EXPECT_LT(celix_bundleContext_findServiceWithOptions(ctx, &opts), 0);
+}
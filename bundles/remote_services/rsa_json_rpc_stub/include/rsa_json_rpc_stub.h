@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef RSA_JSON_RPC_STUB_H_
+#define RSA_JSON_RPC_STUB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <jansson.h>
+#include <celix_bundle_context.h>
+#include <celix_cleanup.h>
+#include <celix_errno.h>
+#include <dyn_type.h>
+#include "rsa_json_rpc_stub_service.h"
+
+/**
+ * @brief Runtime support for the JSON-RPC stubs generated by rsa_json_rpc_stubgen
+ * (see the celix_target_json_rpc_stubs CMake function).
+ *
+ * The generated code provides a rsa_json_rpc_stub_definition_t with per method an endpoint function, which
+ * (de)serializes the arguments and calls the service method directly, and a proxy function, which serializes the
+ * arguments, sends the request using the proxy transport and deserializes the output argument.
+ * Simple types and strings are (de)serialized directly, other types use the json serializer of libdfi with the
+ * dyn types of the (embedded) interface descriptor.
+ */
+typedef struct rsa_json_rpc_stub rsa_json_rpc_stub_t;
+
+/**
+ * @brief The memory layout of a service struct: a handle followed by the method function pointers.
+ */
+typedef struct rsa_json_rpc_stub_service_layout {
+    void *handle;
+    void (*methods[])(void);
+} rsa_json_rpc_stub_service_layout_t;
+
+/**
+ * @brief Generated endpoint function: deserialize the arguments, call the service method and serialize the output.
+ * @param[in] stub The stub.
+ * @param[in] methodIndex The method index.
+ * @param[in] svc The service to call.
+ * @param[in] arguments The JSON-RPC arguments array, can be NULL if the request has no arguments.
+ * @param[out] callStatus The return value of the service method.
+ * @param[out] result The serialized output argument or NULL if there is no output.
+ * @return 0 if successful, otherwise 1.
+ */
+typedef int (*rsa_json_rpc_stub_invoke_fn)(rsa_json_rpc_stub_t *stub, unsigned int methodIndex, void *svc,
+        json_t *arguments, int *callStatus, json_t **result);
+
+typedef struct rsa_json_rpc_stub_method {
+    const char *id;/// The method id (signature)
+    const char *name;/// The method name
+    bool hasOutput;/// Whether the method has an output argument
+    rsa_json_rpc_stub_invoke_fn invoke;/// The generated endpoint function
+    void (*proxyFn)(void);/// The generated proxy function
+} rsa_json_rpc_stub_method_t;
+
+typedef struct rsa_json_rpc_stub_definition {
+    const char *interfaceName;
+    const char *interfaceVersion;
+    const char *descriptor;/// The interface descriptor the stubs are generated from
+    size_t nrOfMethods;
+    const rsa_json_rpc_stub_method_t *methods;/// The methods, in the order of the interface descriptor
+} rsa_json_rpc_stub_definition_t;
+
+/**
+ * @brief Create a stub for the provided (generated) definition.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @return CELIX_SUCCESS, CELIX_ENOMEM or CELIX_ILLEGAL_ARGUMENT if the embedded descriptor cannot be parsed or does
+ * not match the definition.
+ */
+celix_status_t rsaJsonRpcStub_create(const rsa_json_rpc_stub_definition_t *definition, rsa_json_rpc_stub_t **stubOut);
+
+/**
+ * @brief Destroy the stub. The proxies created by the stub keep the stub (and its service) alive until they are
+ * destroyed.
+ */
+void rsaJsonRpcStub_destroy(rsa_json_rpc_stub_t *stub);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(rsa_json_rpc_stub_t, rsaJsonRpcStub_destroy);
+
+/**
+ * @brief Returns the stub service (not registered) of the stub.
+ */
+const rsa_json_rpc_stub_service_t* rsaJsonRpcStub_getService(rsa_json_rpc_stub_t *stub);
+
+/**
+ * @brief Create a stub for the provided (generated) definition and register it as rsa_json_rpc_stub_service.
+ *
+ * Should be called by the bundle activator before the bundle registers or uses the remote service.
+ */
+celix_status_t rsaJsonRpcStub_register(celix_bundle_context_t *ctx, const rsa_json_rpc_stub_definition_t *definition,
+        rsa_json_rpc_stub_t **stubOut);
+
+/**
+ * @brief Unregister the stub service and destroy the stub.
+ *
+ * The JSON-RPC RPC bundle tracks the stub services: endpoints fall back to the dynamic function interface and
+ * proxies created by the stub stay usable until they are destroyed.
+ */
+void rsaJsonRpcStub_unregister(rsa_json_rpc_stub_t *stub);
+
+/**
+ * @brief Returns the dyn type of an argument of a method.
+ */
+dyn_type* rsaJsonRpcStub_argumentType(rsa_json_rpc_stub_t *stub, unsigned int methodIndex, int argumentIndex);
+
+/**
+ * @brief Returns the dyn type of the value of an output argument of a method (T for '#am=pre;*T' and '#am=out;**T'
+ * and t for '#am=out;*t') or NULL if the argument is not an output argument.
+ */
+dyn_type* rsaJsonRpcStub_outputType(rsa_json_rpc_stub_t *stub, unsigned int methodIndex, int argumentIndex);
+
+/**
+ * @brief Returns the JSON-RPC argument for the provided index or NULL (and an error in celix_err) if the argument
+ * is missing. Used by the generated endpoint functions.
+ */
+json_t* rsaJsonRpcStub_getArgument(json_t *arguments, size_t index);
+
+/**
+ * @brief Returns the stub of a proxy service handle. Used by the generated proxy functions.
+ */
+rsa_json_rpc_stub_t* rsaJsonRpcStub_fromProxy(void *proxyHandle);
+
+/**
+ * @brief Append a serialized argument to the arguments array. Used by the generated proxy functions.
+ * @param[in] arguments The arguments array.
+ * @param[in] value The serialized argument, the arguments array takes ownership. Can be NULL if serializing failed.
+ * @return CELIX_SUCCESS or CELIX_SERVICE_EXCEPTION if the value is NULL or cannot be appended.
+ */
+celix_status_t rsaJsonRpcStub_appendArgument(json_t *arguments, json_t *value);
+
+/**
+ * @brief Serialize an argument using the json serializer and append it to the arguments array. Used by the generated
+ * proxy functions.
+ * @param[in] arguments The arguments array.
+ * @param[in] type The dyn type of the argument.
+ * @param[in] arg Pointer to the argument.
+ * @return CELIX_SUCCESS or CELIX_SERVICE_EXCEPTION if the argument cannot be serialized.
+ */
+celix_status_t rsaJsonRpcStub_appendSerializedArgument(json_t *arguments, dyn_type *type, void *arg);
+
+/**
+ * @brief Send a method call as JSON-RPC request using the proxy transport. Used by the generated proxy functions.
+ * @param[in] proxyHandle The handle of the proxy service.
+ * @param[in] methodIndex The method index.
+ * @param[in] arguments The serialized arguments. The function takes ownership.
+ * @param[out] result The result of the reply, or NULL if the reply has no result. The caller should use json_decref
+ * to release the result.
+ * @return CELIX_SUCCESS, the error code of the remote service method or a celix error if the request failed.
+ */
+celix_status_t rsaJsonRpcStub_proxyInvoke(void *proxyHandle, unsigned int methodIndex, json_t *arguments,
+        json_t **result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RSA_JSON_RPC_STUB_H_ */
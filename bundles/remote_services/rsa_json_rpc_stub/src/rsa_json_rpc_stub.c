@@ -0,0 +1,369 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "rsa_json_rpc_stub.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "celix_constants.h"
+#include "celix_err.h"
+#include "celix_properties.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_version.h"
+#include "dyn_function.h"
+#include "dyn_interface.h"
+#include "json_serializer.h"
+
+struct rsa_json_rpc_stub {
+    const rsa_json_rpc_stub_definition_t *definition;
+    dyn_interface_type *intfType;
+    dyn_function_type **functions;// the dyn functions, indexed by method index
+    rsa_json_rpc_stub_service_t service;
+    celix_bundle_context_t *ctx;
+    long svcId;
+    size_t refCount;//atomic, one for the stub owner and one per created proxy
+};
+
+typedef struct rsa_json_rpc_stub_proxy {
+    rsa_json_rpc_stub_t *stub;
+    const rsa_json_rpc_stub_transport_t *transport;
+    rsa_json_rpc_stub_service_layout_t service;// must be the last member, the method pointers follow
+} rsa_json_rpc_stub_proxy_t;
+
+static int rsaJsonRpcStub_call(void *handle, void *svc, const char *request, char **response);
+static celix_status_t rsaJsonRpcStub_createProxy(void *handle, const rsa_json_rpc_stub_transport_t *transport,
+        void **proxySvc);
+static void rsaJsonRpcStub_destroyProxy(void *handle, void *proxySvc);
+
+static celix_status_t rsaJsonRpcStub_parseDescriptor(rsa_json_rpc_stub_t *stub) {
+    const rsa_json_rpc_stub_definition_t *def = stub->definition;
+    FILE *stream = fmemopen((void *)def->descriptor, strlen(def->descriptor), "r");
+    if (stream == NULL) {
+        celix_err_pushf("Error opening descriptor of interface %s.", def->interfaceName);
+        return CELIX_ENOMEM;
+    }
+    int rc = dynInterface_parse(stream, &stub->intfType);
+    fclose(stream);
+    if (rc != 0) {
+        celix_err_pushf("Error parsing descriptor of interface %s.", def->interfaceName);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    char *name = NULL;
+    char *version = NULL;
+    if (dynInterface_getName(stub->intfType, &name) != 0 || strcmp(name, def->interfaceName) != 0 ||
+        dynInterface_getVersionString(stub->intfType, &version) != 0 || strcmp(version, def->interfaceVersion) != 0) {
+        celix_err_pushf("Descriptor does not match stubs of interface %s %s.", def->interfaceName, def->interfaceVersion);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    if (dynInterface_nrOfMethods(stub->intfType) != (int)def->nrOfMethods) {
+        celix_err_pushf("Descriptor of interface %s has %d methods, expected %zu.", def->interfaceName,
+                        dynInterface_nrOfMethods(stub->intfType), def->nrOfMethods);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    stub->functions = calloc(def->nrOfMethods, sizeof(*stub->functions));
+    if (stub->functions == NULL) {
+        celix_err_push("Error allocating memory for stub functions.");
+        return CELIX_ENOMEM;
+    }
+    struct methods_head *methods = NULL;
+    dynInterface_methods(stub->intfType, &methods);
+    struct method_entry *entry = NULL;
+    TAILQ_FOREACH(entry, methods, entries) {
+        if (entry->index < 0 || (size_t)entry->index >= def->nrOfMethods ||
+            strcmp(entry->id, def->methods[entry->index].id) != 0) {
+            celix_err_pushf("Method %s of interface %s does not match the stubs.", entry->id, def->interfaceName);
+            return CELIX_ILLEGAL_ARGUMENT;
+        }
+        stub->functions[entry->index] = entry->dynFunc;
+    }
+    return CELIX_SUCCESS;
+}
+
+celix_status_t rsaJsonRpcStub_create(const rsa_json_rpc_stub_definition_t *definition, rsa_json_rpc_stub_t **stubOut) {
+    if (definition == NULL || definition->descriptor == NULL || stubOut == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_autoptr(rsa_json_rpc_stub_t) stub = calloc(1, sizeof(*stub));
+    if (stub == NULL) {
+        celix_err_push("Error allocating memory for stub.");
+        return CELIX_ENOMEM;
+    }
+    stub->definition = definition;
+    stub->svcId = -1;
+    stub->refCount = 1;
+    stub->service.handle = stub;
+    stub->service.call = rsaJsonRpcStub_call;
+    stub->service.createProxy = rsaJsonRpcStub_createProxy;
+    stub->service.destroyProxy = rsaJsonRpcStub_destroyProxy;
+    celix_status_t status = rsaJsonRpcStub_parseDescriptor(stub);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    *stubOut = celix_steal_ptr(stub);
+    return CELIX_SUCCESS;
+}
+
+void rsaJsonRpcStub_destroy(rsa_json_rpc_stub_t *stub) {
+    if (stub != NULL && __atomic_sub_fetch(&stub->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(stub->functions);
+        dynInterface_destroy(stub->intfType);
+        free(stub);
+    }
+}
+
+const rsa_json_rpc_stub_service_t* rsaJsonRpcStub_getService(rsa_json_rpc_stub_t *stub) {
+    return &stub->service;
+}
+
+celix_status_t rsaJsonRpcStub_register(celix_bundle_context_t *ctx, const rsa_json_rpc_stub_definition_t *definition,
+        rsa_json_rpc_stub_t **stubOut) {
+    if (ctx == NULL || stubOut == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_autoptr(rsa_json_rpc_stub_t) stub = NULL;
+    celix_status_t status = rsaJsonRpcStub_create(definition, &stub);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    if (props == NULL) {
+        return CELIX_ENOMEM;
+    }
+    status = celix_properties_set(props, RSA_JSON_RPC_STUB_INTERFACE_NAME, definition->interfaceName);
+    status = CELIX_DO_IF(status, celix_properties_set(props, RSA_JSON_RPC_STUB_INTERFACE_VERSION,
+                                                      definition->interfaceVersion));
+    status = CELIX_DO_IF(status, celix_properties_set(props, CELIX_FRAMEWORK_SERVICE_VERSION,
+                                                      RSA_JSON_RPC_STUB_SERVICE_VERSION));
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+    opts.svc = &stub->service;
+    opts.serviceName = RSA_JSON_RPC_STUB_SERVICE_NAME;
+    opts.serviceVersion = RSA_JSON_RPC_STUB_SERVICE_VERSION;
+    opts.properties = celix_steal_ptr(props);
+    stub->svcId = celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+    if (stub->svcId < 0) {
+        celix_err_pushf("Error registering stubs of interface %s.", definition->interfaceName);
+        return CELIX_BUNDLE_EXCEPTION;
+    }
+    stub->ctx = ctx;
+    *stubOut = celix_steal_ptr(stub);
+    return CELIX_SUCCESS;
+}
+
+void rsaJsonRpcStub_unregister(rsa_json_rpc_stub_t *stub) {
+    if (stub != NULL) {
+        if (stub->ctx != NULL) {
+            celix_bundleContext_unregisterService(stub->ctx, stub->svcId);
+        }
+        rsaJsonRpcStub_destroy(stub);
+    }
+}
+
+dyn_type* rsaJsonRpcStub_argumentType(rsa_json_rpc_stub_t *stub, unsigned int methodIndex, int argumentIndex) {
+    return dynFunction_argumentTypeForIndex(stub->functions[methodIndex], argumentIndex);
+}
+
+dyn_type* rsaJsonRpcStub_outputType(rsa_json_rpc_stub_t *stub, unsigned int methodIndex, int argumentIndex) {
+    dyn_function_type *func = stub->functions[methodIndex];
+    enum dyn_function_argument_meta meta = dynFunction_argumentMetaForIndex(func, argumentIndex);
+    if (meta != DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT && meta != DYN_FUNCTION_ARGUMENT_META__OUTPUT) {
+        return NULL;
+    }
+    dyn_type *type = NULL;
+    dynType_typedPointer_getTypedType(dynFunction_argumentTypeForIndex(func, argumentIndex), &type);
+    if (meta == DYN_FUNCTION_ARGUMENT_META__OUTPUT && dynType_descriptorType(type) != 't') {
+        dynType_typedPointer_getTypedType(type, &type);
+    }
+    return type;
+}
+
+json_t* rsaJsonRpcStub_getArgument(json_t *arguments, size_t index) {
+    json_t *value = json_array_get(arguments, index);
+    if (value == NULL) {
+        celix_err_pushf("Missing JSON-RPC argument %zu.", index);
+    }
+    return value;
+}
+
+static int rsaJsonRpcStub_call(void *handle, void *svc, const char *request, char **response) {
+    rsa_json_rpc_stub_t *stub = handle;
+    json_error_t error;
+    json_t *jsRequest = json_loads(request, 0, &error);
+    if (jsRequest == NULL) {
+        celix_err_pushf("Got json error '%s' for '%s'.", error.text, request);
+        return 1;
+    }
+    const char *sig = NULL;
+    if (json_unpack(jsRequest, "{s:s}", "m", &sig) != 0) {
+        celix_err_push("Missing method id in JSON-RPC request.");
+        json_decref(jsRequest);
+        return 1;
+    }
+    json_t *arguments = json_object_get(jsRequest, "a");
+
+    const rsa_json_rpc_stub_definition_t *def = stub->definition;
+    size_t methodIndex = 0;
+    while (methodIndex < def->nrOfMethods && strcmp(sig, def->methods[methodIndex].id) != 0) {
+        ++methodIndex;
+    }
+    if (methodIndex == def->nrOfMethods) {
+        celix_err_pushf("Cannot find method with sig '%s'.", sig);
+        json_decref(jsRequest);
+        return 1;
+    }
+
+    int callStatus = 1;
+    json_t *result = NULL;
+    int rc = def->methods[methodIndex].invoke(stub, (unsigned int)methodIndex, svc, arguments, &callStatus, &result);
+    json_decref(jsRequest);
+    if (rc != 0) {
+        return 1;
+    }
+
+    json_t *payload = json_object();
+    if (payload == NULL) {
+        json_decref(result);
+        return 1;
+    }
+    if (callStatus == 0) {
+        if (result != NULL) {
+            json_object_set_new_nocheck(payload, "r", result);
+        }
+    } else {
+        json_decref(result);
+        json_object_set_new_nocheck(payload, "e", json_integer(callStatus));
+    }
+    *response = json_dumps(payload, JSON_COMPACT | JSON_ENCODE_ANY);
+    json_decref(payload);
+    return *response != NULL ? 0 : 1;
+}
+
+static celix_status_t rsaJsonRpcStub_createProxy(void *handle, const rsa_json_rpc_stub_transport_t *transport,
+        void **proxySvc) {
+    rsa_json_rpc_stub_t *stub = handle;
+    if (transport == NULL || proxySvc == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    const rsa_json_rpc_stub_definition_t *def = stub->definition;
+    rsa_json_rpc_stub_proxy_t *proxy = calloc(1, sizeof(*proxy) + def->nrOfMethods * sizeof(proxy->service.methods[0]));
+    if (proxy == NULL) {
+        celix_err_push("Error allocating memory for stub proxy.");
+        return CELIX_ENOMEM;
+    }
+    __atomic_add_fetch(&stub->refCount, 1, __ATOMIC_RELAXED);
+    proxy->stub = stub;
+    proxy->transport = transport;
+    proxy->service.handle = proxy;
+    for (size_t i = 0; i < def->nrOfMethods; ++i) {
+        proxy->service.methods[i] = def->methods[i].proxyFn;
+    }
+    *proxySvc = &proxy->service;
+    return CELIX_SUCCESS;
+}
+
+static void rsaJsonRpcStub_destroyProxy(void *handle CELIX_UNUSED, void *proxySvc) {
+    if (proxySvc != NULL) {
+        rsa_json_rpc_stub_service_layout_t *service = proxySvc;
+        rsa_json_rpc_stub_proxy_t *proxy = service->handle;
+        rsa_json_rpc_stub_t *stub = proxy->stub;
+        free(proxy);
+        rsaJsonRpcStub_destroy(stub);
+    }
+}
+
+rsa_json_rpc_stub_t* rsaJsonRpcStub_fromProxy(void *proxyHandle) {
+    rsa_json_rpc_stub_proxy_t *proxy = proxyHandle;
+    return proxy->stub;
+}
+
+celix_status_t rsaJsonRpcStub_appendArgument(json_t *arguments, json_t *value) {
+    if (value == NULL) {
+        celix_err_push("Failed to serialize JSON-RPC argument.");
+        return CELIX_SERVICE_EXCEPTION;
+    }
+    return json_array_append_new(arguments, value) == 0 ? CELIX_SUCCESS : CELIX_SERVICE_EXCEPTION;
+}
+
+celix_status_t rsaJsonRpcStub_appendSerializedArgument(json_t *arguments, dyn_type *type, void *arg) {
+    json_t *value = NULL;
+    if (jsonSerializer_serializeJson(type, arg, &value) != 0) {
+        celix_err_push("Failed to serialize JSON-RPC argument.");
+        return CELIX_SERVICE_EXCEPTION;
+    }
+    return rsaJsonRpcStub_appendArgument(arguments, value);
+}
+
+celix_status_t rsaJsonRpcStub_proxyInvoke(void *proxyHandle, unsigned int methodIndex, json_t *arguments,
+        json_t **result) {
+    *result = NULL;
+    if (proxyHandle == NULL || arguments == NULL) {
+        json_decref(arguments);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    rsa_json_rpc_stub_proxy_t *proxy = proxyHandle;
+    const rsa_json_rpc_stub_method_t *method = &proxy->stub->definition->methods[methodIndex];
+
+    json_t *invoke = json_object();
+    if (invoke == NULL) {
+        json_decref(arguments);
+        return CELIX_ENOMEM;
+    }
+    json_object_set_new_nocheck(invoke, "m", json_string(method->id));
+    json_object_set_new_nocheck(invoke, "a", arguments);
+    celix_autofree char *request = json_dumps(invoke, JSON_COMPACT | JSON_ENCODE_ANY);
+    json_decref(invoke);
+    if (request == NULL) {
+        return CELIX_ENOMEM;
+    }
+
+    celix_autofree char *reply = NULL;
+    celix_status_t status = proxy->transport->sendRequest(proxy->transport->handle, method->name, request, &reply);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    if (reply == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    json_error_t error;
+    json_t *replyJson = json_loads(reply, JSON_DECODE_ANY, &error);
+    if (replyJson == NULL) {
+        celix_err_pushf("Error parsing json '%s', got error '%s'.", reply, error.text);
+        return CELIX_SERVICE_EXCEPTION;
+    }
+    json_t *rsResult = json_object_get(replyJson, "r");
+    if (rsResult != NULL) {
+        *result = json_incref(rsResult);
+    } else {
+        json_t *rsError = json_object_get(replyJson, "e");
+        if (rsError != NULL) {
+            //the invocation error of the remote service method
+            status = (celix_status_t)json_integer_value(rsError);
+        } else if (method->hasOutput) {
+            celix_err_pushf("Expected result in reply. got '%s'.", reply);
+            status = CELIX_SERVICE_EXCEPTION;
+        }
+    }
+    json_decref(replyJson);
+    return status;
+}
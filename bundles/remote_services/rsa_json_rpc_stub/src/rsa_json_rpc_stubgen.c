@@ -0,0 +1,690 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * rsa_json_rpc_stubgen generates JSON-RPC endpoint and proxy stubs for a remote service interface descriptor.
+ *
+ * Usage: rsa_json_rpc_stubgen <descriptor> <output dir> <prefix>
+ *
+ * The generated <prefix>_json_rpc_stub.h and <prefix>_json_rpc_stub.c files provide the
+ * rsa_json_rpc_stub_definition_t <prefix>_jsonRpcStubDefinition, which can be registered with rsaJsonRpcStub_register.
+ *
+ * Supported are methods with a native int ('N') return type, an optional handle as first argument, simple, text,
+ * enum and typed pointer input arguments and at most one output argument. Other descriptors result in an error.
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "celix_err.h"
+#include "celix_stdio_cleanup.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_utils.h"
+#include "dyn_function.h"
+#include "dyn_interface.h"
+#include "dyn_type.h"
+
+typedef enum stubgen_arg_kind {
+    STUBGEN_ARG_HANDLE,
+    STUBGEN_ARG_SIMPLE,
+    STUBGEN_ARG_TEXT,
+    STUBGEN_ARG_CONST_TEXT,
+    STUBGEN_ARG_GENERIC,
+    STUBGEN_ARG_PRE_SIMPLE,
+    STUBGEN_ARG_PRE_GENERIC,
+    STUBGEN_ARG_OUT_TEXT,
+    STUBGEN_ARG_OUT_GENERIC,
+} stubgen_arg_kind_e;
+
+typedef struct stubgen_simple_type {
+    char descriptor;
+    const char *cType;
+    const char *toJson;// json constructor
+    const char *toJsonCast;// cast of the value for the json constructor
+    const char *fromJson;// json getter
+} stubgen_simple_type_t;
+
+//note the conversions match the conversions of the json serializer
+static const stubgen_simple_type_t stubgen_simpleTypes[] = {
+        {'B', "char", "json_integer", "json_int_t", "json_integer_value"},
+        {'D', "double", "json_real", "double", "json_real_value"},
+        {'F', "float", "json_real", "double", "json_real_value"},
+        {'I', "int32_t", "json_integer", "json_int_t", "json_integer_value"},
+        {'J', "int64_t", "json_integer", "json_int_t", "json_integer_value"},
+        {'S', "int16_t", "json_integer", "json_int_t", "json_integer_value"},
+        {'N', "int", "json_integer", "json_int_t", "json_integer_value"},
+        {'Z', "bool", "json_boolean", "bool", "json_is_true"},
+        {'b', "uint8_t", "json_integer", "json_int_t", "json_integer_value"},
+        {'i', "uint32_t", "json_integer", "json_int_t", "json_integer_value"},
+        {'j', "uint64_t", "json_integer", "json_int_t", "json_integer_value"},
+        {'s', "uint16_t", "json_integer", "json_int_t", "json_integer_value"},
+};
+
+typedef struct stubgen_arg {
+    stubgen_arg_kind_e kind;
+    const stubgen_simple_type_t *simple;// for simple and pre-allocated simple arguments
+    char paramType[32];// the C type of the parameter
+    const char *genericCast;// for generic input arguments, the type of the value of a deserialized argument
+} stubgen_arg_t;
+
+typedef struct stubgen_method {
+    int index;
+    const char *id;
+    const char *name;
+    int nrOfArgs;
+    stubgen_arg_t *args;
+    bool hasOutput;
+} stubgen_method_t;
+
+static const stubgen_simple_type_t* stubgen_findSimpleType(char descriptor) {
+    for (size_t i = 0; i < sizeof(stubgen_simpleTypes) / sizeof(stubgen_simpleTypes[0]); ++i) {
+        if (stubgen_simpleTypes[i].descriptor == descriptor) {
+            return &stubgen_simpleTypes[i];
+        }
+    }
+    return NULL;
+}
+
+static bool stubgen_isConstText(dyn_type *type) {
+    const char *isConst = dynType_getMetaInfo(type, "const");
+    return isConst != NULL && strncmp("true", isConst, 5) == 0;
+}
+
+static int stubgen_classifyArgument(const char *methodId, dyn_function_type *func, int index, stubgen_arg_t *arg) {
+    dyn_type *type = dynFunction_argumentTypeForIndex(func, index);
+    enum dyn_function_argument_meta meta = dynFunction_argumentMetaForIndex(func, index);
+    dyn_type *subType = NULL;
+    char descriptor;
+    switch (meta) {
+        case DYN_FUNCTION_ARGUMENT_META__HANDLE:
+            if (index != 0) {
+                fprintf(stderr, "Method %s: the handle should be the first argument.\n", methodId);
+                return 1;
+            }
+            arg->kind = STUBGEN_ARG_HANDLE;
+            snprintf(arg->paramType, sizeof(arg->paramType), "void *");
+            return 0;
+        case DYN_FUNCTION_ARGUMENT_META__STD:
+            type = dynType_realType(type);
+            descriptor = dynType_descriptorType(type);
+            arg->simple = stubgen_findSimpleType(descriptor);
+            if (arg->simple != NULL) {
+                arg->kind = STUBGEN_ARG_SIMPLE;
+                snprintf(arg->paramType, sizeof(arg->paramType), "%s", arg->simple->cType);
+            } else if (descriptor == 't') {
+                arg->kind = stubgen_isConstText(type) ? STUBGEN_ARG_CONST_TEXT : STUBGEN_ARG_TEXT;
+                snprintf(arg->paramType, sizeof(arg->paramType), "%s",
+                         arg->kind == STUBGEN_ARG_CONST_TEXT ? "const char *" : "char *");
+            } else if (descriptor == '*') {
+                arg->kind = STUBGEN_ARG_GENERIC;
+                arg->genericCast = "void *";
+                snprintf(arg->paramType, sizeof(arg->paramType), "void *");
+            } else if (descriptor == 'E') {
+                arg->kind = STUBGEN_ARG_GENERIC;
+                arg->genericCast = "int32_t ";
+                snprintf(arg->paramType, sizeof(arg->paramType), "int32_t");
+            } else {
+                fprintf(stderr, "Method %s: unsupported type '%c' for argument %d.\n", methodId, descriptor, index);
+                return 1;
+            }
+            return 0;
+        case DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT:
+            dynType_typedPointer_getTypedType(type, &subType);
+            descriptor = dynType_descriptorType(subType);
+            arg->simple = stubgen_findSimpleType(descriptor);
+            if (arg->simple != NULL) {
+                arg->kind = STUBGEN_ARG_PRE_SIMPLE;
+                snprintf(arg->paramType, sizeof(arg->paramType), "%s *", arg->simple->cType);
+            } else if (descriptor == 't') {
+                fprintf(stderr, "Method %s: unsupported pre-allocated text output argument %d.\n", methodId, index);
+                return 1;
+            } else {
+                arg->kind = STUBGEN_ARG_PRE_GENERIC;
+                snprintf(arg->paramType, sizeof(arg->paramType), "void *");
+            }
+            return 0;
+        case DYN_FUNCTION_ARGUMENT_META__OUTPUT:
+            dynType_typedPointer_getTypedType(type, &subType);
+            if (dynType_descriptorType(subType) == 't') {
+                arg->kind = STUBGEN_ARG_OUT_TEXT;
+                snprintf(arg->paramType, sizeof(arg->paramType), "char **");
+            } else {
+                arg->kind = STUBGEN_ARG_OUT_GENERIC;
+                snprintf(arg->paramType, sizeof(arg->paramType), "void **");
+            }
+            return 0;
+        default:
+            fprintf(stderr, "Method %s: unsupported argument meta %d for argument %d.\n", methodId, (int)meta, index);
+            return 1;
+    }
+}
+
+static int stubgen_createMethod(struct method_entry *entry, stubgen_method_t *method) {
+    method->index = entry->index;
+    method->id = entry->id;
+    method->name = entry->name;
+    dyn_type *returnType = dynFunction_returnType(entry->dynFunc);
+    if (dynType_descriptorType(returnType) != 'N') {
+        //NOTE To be able to handle exception only N as returnType is supported
+        fprintf(stderr, "Method %s: only methods with a native int return type are supported.\n", entry->id);
+        return 1;
+    }
+    method->nrOfArgs = dynFunction_nrOfArguments(entry->dynFunc);
+    method->args = calloc(method->nrOfArgs > 0 ? method->nrOfArgs : 1, sizeof(*method->args));
+    if (method->args == NULL) {
+        fprintf(stderr, "Error allocating memory for arguments of method %s.\n", entry->id);
+        return 1;
+    }
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        if (stubgen_classifyArgument(entry->id, entry->dynFunc, i, &method->args[i]) != 0) {
+            return 1;
+        }
+        enum dyn_function_argument_meta meta = dynFunction_argumentMetaForIndex(entry->dynFunc, i);
+        if (meta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT || meta == DYN_FUNCTION_ARGUMENT_META__OUTPUT) {
+            if (method->hasOutput) {
+                fprintf(stderr, "Method %s: only one output argument is supported.\n", entry->id);
+                return 1;
+            }
+            method->hasOutput = true;
+        }
+    }
+    if (method->nrOfArgs == 0 || method->args[0].kind != STUBGEN_ARG_HANDLE) {
+        fprintf(stderr, "Method %s: the first argument should be the handle.\n", entry->id);
+        return 1;
+    }
+    return 0;
+}
+
+static bool stubgen_hasKind(const stubgen_method_t *method, stubgen_arg_kind_e kind) {
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        if (method->args[i].kind == kind) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void stubgen_writeParams(FILE *out, const stubgen_method_t *method, bool withNames) {
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const char *paramType = method->args[i].paramType;
+        fprintf(out, "%s%s", i > 0 ? ", " : "", paramType);
+        if (withNames) {
+            fprintf(out, "%sarg%d", paramType[strlen(paramType) - 1] == '*' ? "" : " ", i);
+        }
+    }
+    if (method->nrOfArgs == 0) {
+        fprintf(out, "void");
+    }
+}
+
+static void stubgen_writeFnType(FILE *out, const stubgen_method_t *method) {
+    fprintf(out, "int (*)(");
+    stubgen_writeParams(out, method, false);
+    fprintf(out, ")");
+}
+
+static void stubgen_writeReadArgument(FILE *out, int jsonIndex) {
+    fprintf(out, "    if (status == 0 && (value = rsaJsonRpcStub_getArgument(arguments, %d)) != NULL", jsonIndex);
+}
+
+static void stubgen_writeInvoke(FILE *out, const char *prefix, const stubgen_method_t *method) {
+    fprintf(out, "//%s\n", method->id);
+    fprintf(out, "static int %s_invoke%d(rsa_json_rpc_stub_t *stub, unsigned int methodIndex, void *svc, "
+                 "json_t *arguments,\n        int *callStatus, json_t **result) {\n", prefix, method->index);
+    fprintf(out, "    rsa_json_rpc_stub_service_layout_t *service = svc;\n");
+    fprintf(out, "    int (*fn)(");
+    stubgen_writeParams(out, method, false);
+    fprintf(out, ") = (");
+    stubgen_writeFnType(out, method);
+    fprintf(out, ")service->methods[%d];\n", method->index);
+    fprintf(out, "    int status = 0;\n");
+    bool hasText = stubgen_hasKind(method, STUBGEN_ARG_TEXT);
+    if (hasText) {
+        fprintf(out, "    bool called = false;\n");
+    }
+    int nrOfInputs = 0;
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const stubgen_arg_t *arg = &method->args[i];
+        switch (arg->kind) {
+            case STUBGEN_ARG_SIMPLE:
+            case STUBGEN_ARG_PRE_SIMPLE:
+                fprintf(out, "    %s arg%d = 0;\n", arg->simple->cType, i);
+                break;
+            case STUBGEN_ARG_TEXT:
+            case STUBGEN_ARG_OUT_TEXT:
+                fprintf(out, "    char *arg%d = NULL;\n", i);
+                break;
+            case STUBGEN_ARG_CONST_TEXT:
+                fprintf(out, "    const char *arg%d = NULL;\n", i);
+                break;
+            case STUBGEN_ARG_GENERIC:
+                fprintf(out, "    void *arg%d = NULL;\n", i);
+                break;
+            case STUBGEN_ARG_PRE_GENERIC:
+            case STUBGEN_ARG_OUT_GENERIC:
+                fprintf(out, "    void *arg%d = NULL;\n", i);
+                fprintf(out, "    dyn_type *arg%dType = rsaJsonRpcStub_outputType(stub, methodIndex, %d);\n", i, i);
+                break;
+            default:
+                break;
+        }
+        if (arg->kind == STUBGEN_ARG_SIMPLE || arg->kind == STUBGEN_ARG_TEXT || arg->kind == STUBGEN_ARG_CONST_TEXT ||
+            arg->kind == STUBGEN_ARG_GENERIC) {
+            nrOfInputs += 1;
+        }
+    }
+    if (nrOfInputs > 0) {
+        fprintf(out, "    json_t *value = NULL;\n");
+    }
+    fprintf(out, "\n");
+
+    //deserialize the input arguments
+    int jsonIndex = 0;
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const stubgen_arg_t *arg = &method->args[i];
+        switch (arg->kind) {
+            case STUBGEN_ARG_SIMPLE:
+                stubgen_writeReadArgument(out, jsonIndex++);
+                fprintf(out, ") {\n        arg%d = (%s)%s(value);\n", i, arg->simple->cType, arg->simple->fromJson);
+                fprintf(out, "    } else {\n        status = 1;\n    }\n");
+                break;
+            case STUBGEN_ARG_TEXT:
+                stubgen_writeReadArgument(out, jsonIndex++);
+                fprintf(out, " && json_is_string(value)) {\n");
+                fprintf(out, "        //char * -> callee is owner\n");
+                fprintf(out, "        arg%d = strdup(json_string_value(value));\n", i);
+                fprintf(out, "        status = arg%d != NULL ? 0 : 1;\n", i);
+                fprintf(out, "    } else {\n        status = 1;\n    }\n");
+                break;
+            case STUBGEN_ARG_CONST_TEXT:
+                stubgen_writeReadArgument(out, jsonIndex++);
+                fprintf(out, " && json_is_string(value)) {\n");
+                fprintf(out, "        arg%d = json_string_value(value);\n", i);
+                fprintf(out, "    } else {\n        status = 1;\n    }\n");
+                break;
+            case STUBGEN_ARG_GENERIC:
+                stubgen_writeReadArgument(out, jsonIndex++);
+                fprintf(out, ") {\n        status = jsonSerializer_deserializeJson("
+                             "rsaJsonRpcStub_argumentType(stub, methodIndex, %d), value, &arg%d);\n", i, i);
+                fprintf(out, "    } else {\n        status = 1;\n    }\n");
+                break;
+            case STUBGEN_ARG_PRE_GENERIC:
+                fprintf(out, "    if (status == 0) {\n");
+                fprintf(out, "        status = dynType_alloc(arg%dType, &arg%d);\n", i, i);
+                fprintf(out, "    }\n");
+                break;
+            default:
+                break;
+        }
+    }
+
+    //call the service method
+    fprintf(out, "\n    if (status == 0) {\n        *callStatus = fn(");
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const stubgen_arg_t *arg = &method->args[i];
+        fprintf(out, "%s", i > 0 ? ", " : "");
+        switch (arg->kind) {
+            case STUBGEN_ARG_HANDLE:
+                fprintf(out, "service->handle");
+                break;
+            case STUBGEN_ARG_GENERIC:
+                fprintf(out, "*(%s*)arg%d", arg->genericCast, i);
+                break;
+            case STUBGEN_ARG_PRE_SIMPLE:
+            case STUBGEN_ARG_OUT_TEXT:
+            case STUBGEN_ARG_OUT_GENERIC:
+                fprintf(out, "&arg%d", i);
+                break;
+            default:
+                fprintf(out, "arg%d", i);
+                break;
+        }
+    }
+    fprintf(out, ");\n");
+    if (hasText) {
+        fprintf(out, "        called = true;\n");
+    }
+    fprintf(out, "    }\n\n");
+
+    //free the input arguments
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const stubgen_arg_t *arg = &method->args[i];
+        if (arg->kind == STUBGEN_ARG_TEXT) {
+            fprintf(out, "    if (!called) {\n        free(arg%d);\n    }\n", i);
+        } else if (arg->kind == STUBGEN_ARG_GENERIC) {
+            fprintf(out, "    if (arg%d != NULL) {\n", i);
+            fprintf(out, "        dynType_free(rsaJsonRpcStub_argumentType(stub, methodIndex, %d), arg%d);\n", i, i);
+            fprintf(out, "    }\n");
+        }
+    }
+
+    //serialize and free the output argument
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const stubgen_arg_t *arg = &method->args[i];
+        switch (arg->kind) {
+            case STUBGEN_ARG_PRE_SIMPLE:
+                fprintf(out, "    if (status == 0 && *callStatus == 0) {\n");
+                fprintf(out, "        *result = %s((%s)arg%d);\n", arg->simple->toJson, arg->simple->toJsonCast, i);
+                fprintf(out, "        status = *result != NULL ? 0 : 1;\n");
+                fprintf(out, "    }\n");
+                break;
+            case STUBGEN_ARG_PRE_GENERIC:
+                fprintf(out, "    if (status == 0 && *callStatus == 0) {\n");
+                fprintf(out, "        status = jsonSerializer_serializeJson(arg%dType, arg%d, result);\n", i, i);
+                fprintf(out, "    }\n");
+                fprintf(out, "    if (arg%d != NULL) {\n        dynType_free(arg%dType, arg%d);\n    }\n", i, i, i);
+                break;
+            case STUBGEN_ARG_OUT_TEXT:
+                fprintf(out, "    if (status == 0 && *callStatus == 0 && arg%d != NULL) {\n", i);
+                fprintf(out, "        *result = json_string(arg%d);\n", i);
+                fprintf(out, "        status = *result != NULL ? 0 : 1;\n");
+                fprintf(out, "    }\n");
+                fprintf(out, "    free(arg%d);\n", i);
+                break;
+            case STUBGEN_ARG_OUT_GENERIC:
+                fprintf(out, "    if (status == 0 && *callStatus == 0 && arg%d != NULL) {\n", i);
+                fprintf(out, "        status = jsonSerializer_serializeJson(arg%dType, arg%d, result);\n", i, i);
+                fprintf(out, "    }\n");
+                fprintf(out, "    if (arg%d != NULL) {\n        dynType_free(arg%dType, arg%d);\n    }\n", i, i, i);
+                break;
+            default:
+                break;
+        }
+    }
+    fprintf(out, "    return status;\n}\n\n");
+}
+
+static void stubgen_writeProxy(FILE *out, const char *prefix, const stubgen_method_t *method) {
+    fprintf(out, "//%s\n", method->id);
+    fprintf(out, "static int %s_proxy%d(", prefix, method->index);
+    stubgen_writeParams(out, method, true);
+    fprintf(out, ") {\n");
+    fprintf(out, "    if (arg0 == NULL) {\n        return CELIX_ILLEGAL_ARGUMENT;\n    }\n");
+    bool usesStub = stubgen_hasKind(method, STUBGEN_ARG_GENERIC) || stubgen_hasKind(method, STUBGEN_ARG_PRE_GENERIC) ||
+                    stubgen_hasKind(method, STUBGEN_ARG_OUT_GENERIC);
+    if (usesStub) {
+        fprintf(out, "    rsa_json_rpc_stub_t *stub = rsaJsonRpcStub_fromProxy(arg0);\n");
+    }
+    fprintf(out, "    json_t *arguments = json_array();\n");
+    fprintf(out, "    celix_status_t status = arguments != NULL ? CELIX_SUCCESS : CELIX_ENOMEM;\n");
+
+    //serialize the input arguments
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const stubgen_arg_t *arg = &method->args[i];
+        switch (arg->kind) {
+            case STUBGEN_ARG_SIMPLE:
+                fprintf(out, "    status = CELIX_DO_IF(status, rsaJsonRpcStub_appendArgument(arguments, %s((%s)arg%d)));\n",
+                        arg->simple->toJson, arg->simple->toJsonCast, i);
+                break;
+            case STUBGEN_ARG_TEXT:
+            case STUBGEN_ARG_CONST_TEXT:
+                fprintf(out, "    status = CELIX_DO_IF(status, rsaJsonRpcStub_appendArgument(arguments, json_string(arg%d)));\n",
+                        i);
+                break;
+            case STUBGEN_ARG_GENERIC:
+                fprintf(out, "    status = CELIX_DO_IF(status, rsaJsonRpcStub_appendSerializedArgument(arguments,\n"
+                             "            rsaJsonRpcStub_argumentType(stub, %d, %d), &arg%d));\n", method->index, i, i);
+                break;
+            default:
+                break;
+        }
+    }
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        if (method->args[i].kind == STUBGEN_ARG_TEXT) {
+            fprintf(out, "    free(arg%d); //char * as input -> got ownership -> free it.\n", i);
+        }
+    }
+
+    //send the request
+    fprintf(out, "\n    json_t *result = NULL;\n");
+    fprintf(out, "    status = CELIX_DO_IF(status, rsaJsonRpcStub_proxyInvoke(arg0, %d, celix_steal_ptr(arguments), &result));\n",
+            method->index);
+    fprintf(out, "    json_decref(arguments);\n\n");
+
+    //deserialize the output argument
+    for (int i = 0; i < method->nrOfArgs; ++i) {
+        const stubgen_arg_t *arg = &method->args[i];
+        switch (arg->kind) {
+            case STUBGEN_ARG_PRE_SIMPLE:
+                fprintf(out, "    if (status == CELIX_SUCCESS) {\n");
+                fprintf(out, "        *arg%d = (%s)%s(result);\n", i, arg->simple->cType, arg->simple->fromJson);
+                fprintf(out, "    }\n");
+                break;
+            case STUBGEN_ARG_PRE_GENERIC:
+                fprintf(out, "    if (status == CELIX_SUCCESS) {\n");
+                fprintf(out, "        dyn_type *type = rsaJsonRpcStub_outputType(stub, %d, %d);\n", method->index, i);
+                fprintf(out, "        void *tmp = NULL;\n");
+                fprintf(out, "        if (jsonSerializer_deserializeJson(type, result, &tmp) == 0) {\n");
+                fprintf(out, "            //note the pre-allocated output takes over the memory referenced by tmp\n");
+                fprintf(out, "            memcpy(arg%d, tmp, dynType_size(type));\n", i);
+                fprintf(out, "            free(tmp);\n");
+                fprintf(out, "        } else {\n            status = CELIX_SERVICE_EXCEPTION;\n        }\n");
+                fprintf(out, "    }\n");
+                break;
+            case STUBGEN_ARG_OUT_TEXT:
+                fprintf(out, "    if (status == CELIX_SUCCESS) {\n");
+                fprintf(out, "        if (json_is_string(result)) {\n");
+                fprintf(out, "            *arg%d = strdup(json_string_value(result));\n", i);
+                fprintf(out, "            status = *arg%d != NULL ? CELIX_SUCCESS : CELIX_ENOMEM;\n", i);
+                fprintf(out, "        } else {\n            status = CELIX_SERVICE_EXCEPTION;\n        }\n");
+                fprintf(out, "    }\n");
+                break;
+            case STUBGEN_ARG_OUT_GENERIC:
+                fprintf(out, "    if (status == CELIX_SUCCESS) {\n");
+                fprintf(out, "        dyn_type *type = rsaJsonRpcStub_outputType(stub, %d, %d);\n", method->index, i);
+                fprintf(out, "        if (jsonSerializer_deserializeJson(type, result, arg%d) != 0) {\n", i);
+                fprintf(out, "            status = CELIX_SERVICE_EXCEPTION;\n");
+                fprintf(out, "        }\n");
+                fprintf(out, "    }\n");
+                break;
+            default:
+                break;
+        }
+    }
+    fprintf(out, "    json_decref(result);\n");
+    fprintf(out, "    return status;\n}\n\n");
+}
+
+static void stubgen_writeDescriptor(FILE *out, const char *prefix, const char *descriptor) {
+    fprintf(out, "static const char %s_descriptor[] =\n        \"", prefix);
+    for (const char *c = descriptor; *c != '\0'; ++c) {
+        switch (*c) {
+            case '\\':
+                fprintf(out, "\\\\");
+                break;
+            case '"':
+                fprintf(out, "\\\"");
+                break;
+            case '\n':
+                fprintf(out, "\\n\"%s", c[1] != '\0' ? "\n        \"" : "");
+                break;
+            case '\r':
+                break;
+            default:
+                fputc(*c, out);
+                break;
+        }
+    }
+    if (descriptor[0] == '\0' || descriptor[strlen(descriptor) - 1] != '\n') {
+        fputc('"', out);
+    }
+    fprintf(out, ";\n\n");
+}
+
+static int stubgen_writeHeader(const char *path, const char *prefix) {
+    celix_autoptr(FILE) out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Cannot open %s for writing.\n", path);
+        return 1;
+    }
+    celix_autofree char *guard = celix_utils_strdup(prefix);
+    if (guard == NULL) {
+        return 1;
+    }
+    for (char *c = guard; *c != '\0'; ++c) {
+        *c = (char)toupper((unsigned char)*c);
+    }
+    fprintf(out, "/* Generated by rsa_json_rpc_stubgen. Do not edit. */\n\n");
+    fprintf(out, "#ifndef %s_JSON_RPC_STUB_H_\n#define %s_JSON_RPC_STUB_H_\n\n", guard, guard);
+    fprintf(out, "#include \"rsa_json_rpc_stub.h\"\n\n");
+    fprintf(out, "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n");
+    fprintf(out, "extern const rsa_json_rpc_stub_definition_t %s_jsonRpcStubDefinition;\n\n", prefix);
+    fprintf(out, "#ifdef __cplusplus\n}\n#endif\n\n");
+    fprintf(out, "#endif /* %s_JSON_RPC_STUB_H_ */\n", guard);
+    return ferror(out) ? 1 : 0;
+}
+
+static int stubgen_writeSource(const char *path, const char *prefix, const char *descriptor, const char *intfName,
+        const char *intfVersion, const stubgen_method_t *methods, int nrOfMethods) {
+    celix_autoptr(FILE) out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Cannot open %s for writing.\n", path);
+        return 1;
+    }
+    fprintf(out, "/* Generated by rsa_json_rpc_stubgen. Do not edit. */\n\n");
+    fprintf(out, "#include \"%s_json_rpc_stub.h\"\n\n", prefix);
+    fprintf(out, "#include <stdbool.h>\n#include <stdint.h>\n#include <stdlib.h>\n#include <string.h>\n\n");
+    fprintf(out, "#include \"dyn_type.h\"\n#include \"json_serializer.h\"\n\n");
+    stubgen_writeDescriptor(out, prefix, descriptor);
+    for (int i = 0; i < nrOfMethods; ++i) {
+        stubgen_writeInvoke(out, prefix, &methods[i]);
+        stubgen_writeProxy(out, prefix, &methods[i]);
+    }
+    fprintf(out, "static const rsa_json_rpc_stub_method_t %s_methods[] = {\n", prefix);
+    for (int i = 0; i < nrOfMethods; ++i) {
+        fprintf(out, "        {\"%s\", \"%s\", %s, %s_invoke%d, (void (*)(void))%s_proxy%d},\n", methods[i].id,
+                methods[i].name, methods[i].hasOutput ? "true" : "false", prefix, i, prefix, i);
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "const rsa_json_rpc_stub_definition_t %s_jsonRpcStubDefinition = {\n", prefix);
+    fprintf(out, "        .interfaceName = \"%s\",\n", intfName);
+    fprintf(out, "        .interfaceVersion = \"%s\",\n", intfVersion);
+    fprintf(out, "        .descriptor = %s_descriptor,\n", prefix);
+    fprintf(out, "        .nrOfMethods = %d,\n", nrOfMethods);
+    fprintf(out, "        .methods = %s_methods,\n", prefix);
+    fprintf(out, "};\n");
+    return ferror(out) ? 1 : 0;
+}
+
+static bool stubgen_isIdentifier(const char *str) {
+    if (str[0] == '\0' || isdigit((unsigned char)str[0])) {
+        return false;
+    }
+    for (const char *c = str; *c != '\0'; ++c) {
+        if (!isalnum((unsigned char)*c) && *c != '_') {
+            return false;
+        }
+    }
+    return true;
+}
+
+static char* stubgen_readFile(const char *path) {
+    celix_autoptr(FILE) in = fopen(path, "r");
+    if (in == NULL) {
+        fprintf(stderr, "Cannot open descriptor %s.\n", path);
+        return NULL;
+    }
+    char *content = NULL;
+    size_t size = 0;
+    celix_autoptr(FILE) stream = open_memstream(&content, &size);
+    if (stream == NULL) {
+        return NULL;
+    }
+    char buf[512];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), in)) > 0) {
+        fwrite(buf, 1, len, stream);
+    }
+    if (fclose(celix_steal_ptr(stream)) != 0 || ferror(in)) {
+        free(content);
+        return NULL;
+    }
+    return content;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 4 || !stubgen_isIdentifier(argv[3])) {
+        fprintf(stderr, "Usage: %s <descriptor> <output dir> <prefix>\n", argv[0]);
+        return 1;
+    }
+    const char *descriptorPath = argv[1];
+    const char *outDir = argv[2];
+    const char *prefix = argv[3];
+
+    celix_autofree char *descriptor = stubgen_readFile(descriptorPath);
+    if (descriptor == NULL) {
+        return 1;
+    }
+    FILE *stream = fmemopen(descriptor, strlen(descriptor), "r");
+    if (stream == NULL) {
+        return 1;
+    }
+    celix_autoptr(dyn_interface_type) intf = NULL;
+    int rc = dynInterface_parse(stream, &intf);
+    fclose(stream);
+    if (rc != 0) {
+        celix_err_printErrors(stderr, NULL, NULL);
+        fprintf(stderr, "Cannot parse descriptor %s.\n", descriptorPath);
+        return 1;
+    }
+    char *intfName = NULL;
+    char *intfVersion = NULL;
+    dynInterface_getName(intf, &intfName);
+    dynInterface_getVersionString(intf, &intfVersion);
+
+    int nrOfMethods = dynInterface_nrOfMethods(intf);
+    celix_autofree stubgen_method_t *methods = calloc(nrOfMethods > 0 ? nrOfMethods : 1, sizeof(*methods));
+    if (methods == NULL) {
+        return 1;
+    }
+    struct methods_head *list = NULL;
+    dynInterface_methods(intf, &list);
+    struct method_entry *entry = NULL;
+    rc = 0;
+    TAILQ_FOREACH(entry, list, entries) {
+        if (rc == 0) {
+            rc = stubgen_createMethod(entry, &methods[entry->index]);
+        }
+    }
+
+    if (rc == 0) {
+        celix_autofree char *headerPath = NULL;
+        celix_autofree char *sourcePath = NULL;
+        if (asprintf(&headerPath, "%s/%s_json_rpc_stub.h", outDir, prefix) < 0 ||
+            asprintf(&sourcePath, "%s/%s_json_rpc_stub.c", outDir, prefix) < 0) {
+            rc = 1;
+        } else {
+            rc = stubgen_writeHeader(headerPath, prefix);
+            if (rc == 0) {
+                rc = stubgen_writeSource(sourcePath, prefix, descriptor, intfName, intfVersion, methods, nrOfMethods);
+            }
+        }
+    }
+
+    for (int i = 0; i < nrOfMethods; ++i) {
+        free(methods[i].args);
+    }
+    if (rc != 0) {
+        fprintf(stderr, "Cannot generate JSON-RPC stubs for descriptor %s.\n", descriptorPath);
+    }
+    return rc;
+}
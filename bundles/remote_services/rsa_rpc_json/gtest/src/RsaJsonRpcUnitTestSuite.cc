@@ -436,6 +436,16 @@ TEST_F(RsaJsonRpcProxyUnitTestSuite, FailedToCloneEndpointDescription) {
     endpointDescription_destroy(endpoint);
 }
 
+TEST_F(RsaJsonRpcProxyUnitTestSuite, FailedToTrackStubServices) {
+    auto endpoint = CreateEndpointDescription();
+    long svcId = -1L;
+    celix_ei_expect_celix_bundleContext_trackServicesWithOptionsAsync((void*)&rsaJsonRpcProxy_factoryCreate, 0, -1);
+    auto status = rsaJsonRpc_createProxy(jsonRpc.get(), endpoint, reqSenderSvcId, &svcId);
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, status);
+
+    endpointDescription_destroy(endpoint);
+}
+
 TEST_F(RsaJsonRpcProxyUnitTestSuite, FailedToRegisterProxyService) {
     auto endpoint = CreateEndpointDescription();
     long svcId = -1L;
@@ -704,7 +714,7 @@ TEST_F(RsaJsonRpcEndPointUnitTestSuite, FailedToCloneEndpointDescription) {
     endpointDescription_destroy(endpoint);
 }
 
-TEST_F(RsaJsonRpcEndPointUnitTestSuite, FailedToTrackEndpointService) {
+TEST_F(RsaJsonRpcEndPointUnitTestSuite, FailedToTrackStubServices) {
     auto endpoint = CreateEndpointDescription(rpcTestSvcId);
 
     celix_ei_expect_celix_bundleContext_trackServicesWithOptionsAsync((void*)&rsaJsonRpcEndpoint_create, 0, -1);
@@ -715,6 +725,17 @@ TEST_F(RsaJsonRpcEndPointUnitTestSuite, FailedToTrackEndpointService) {
     endpointDescription_destroy(endpoint);
 }
 
+TEST_F(RsaJsonRpcEndPointUnitTestSuite, FailedToTrackEndpointService) {
+    auto endpoint = CreateEndpointDescription(rpcTestSvcId);
+
+    celix_ei_expect_celix_bundleContext_trackServicesWithOptionsAsync((void*)&rsaJsonRpcEndpoint_create, 0, -1, 2);
+    long svcId = -1L;
+    auto status = rsaJsonRpc_createEndpoint(jsonRpc.get(), endpoint, &svcId);
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, status);
+
+    endpointDescription_destroy(endpoint);
+}
+
 TEST_F(RsaJsonRpcEndPointUnitTestSuite, FailedToRegisterRequestHandler) {
     auto endpoint = CreateEndpointDescription(rpcTestSvcId);
 
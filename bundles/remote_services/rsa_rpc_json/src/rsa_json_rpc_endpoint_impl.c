@@ -19,6 +19,7 @@
 
 #include "rsa_json_rpc_endpoint_impl.h"
 #include "rsa_request_handler_service.h"
+#include "rsa_json_rpc_stub_service.h"
 #include "remote_interceptors_handler.h"
 #include "endpoint_description.h"
 #include "dfi_utils.h"
@@ -26,6 +27,8 @@
 #include "celix_stdlib_cleanup.h"
 #include "celix_threads.h"
 #include "celix_constants.h"
+#include "celix_array_list.h"
+#include "celix_utils.h"
 #include <sys/uio.h>
 #include <jansson.h>
 #include <assert.h>
@@ -40,18 +43,34 @@ struct rsa_json_rpc_endpoint {
     rsa_request_handler_service_t reqHandlerSvc;
     long reqHandlerSvcId;
     long svcTrackerId;
+    long stubTrackerId;
     celix_thread_rwlock_t lock; //projects below
     void *service;
+    long svcOwnerId;
+    const char *intfVersion;//owned by intfType
     dyn_interface_type *intfType;
+    celix_array_list_t *stubs;//Type: rsa_json_rpc_endpoint_stub_t*, the tracked stub services for the interface
+    const rsa_json_rpc_stub_service_t *stubSvc;//NULL if the endpoint uses the dynamic function interface
 };
 
+typedef struct rsa_json_rpc_endpoint_stub {
+    const rsa_json_rpc_stub_service_t *stubSvc;
+    long svcId;
+    long bundleId;
+    const char *intfVersion;//owned by the stub service properties
+} rsa_json_rpc_endpoint_stub_t;
+
 static void rsaJsonRpcEndpoint_stopSvcTrackerDone(void *data);
+static void rsaJsonRpcEndpoint_stopStubTrackerDone(void *data);
+static void rsaJsonRpcEndpoint_addStubSvc(void *handle, void *svc, const celix_properties_t *props);
+static void rsaJsonRpcEndpoint_removeStubSvc(void *handle, void *svc, const celix_properties_t *props);
 static void rsaJsonRpcEndpoint_addSvcWithOwner(void *handle, void *service,
         const celix_properties_t *props, const celix_bundle_t *svcOwner);
 static void rsaJsonRpcEndpoint_removeSvcWithOwner(void *handle, void *service,
         const celix_properties_t *props, const celix_bundle_t *svcOwner);
 static celix_status_t rsaJsonRpcEndpoint_handleRequest(void *handle, celix_properties_t *metadata,
         const struct iovec *request, struct iovec *responseOut);
+static void rsaJsonRpcEndpoint_selectStubService(rsa_json_rpc_endpoint_t *endpoint);
 
 celix_status_t rsaJsonRpcEndpoint_create(celix_bundle_context_t* ctx, celix_log_helper_t *logHelper,
         FILE *logFile, remote_interceptors_handler_t *interceptorsHandler,
@@ -81,6 +100,13 @@ celix_status_t rsaJsonRpcEndpoint_create(celix_bundle_context_t* ctx, celix_log_
     endpoint->interceptorsHandler = interceptorsHandler;
     endpoint->service = NULL;
     endpoint->intfType = NULL;
+    endpoint->stubSvc = NULL;
+    celix_autoptr(celix_array_list_t) stubs = endpoint->stubs = celix_arrayList_create();
+    if (stubs == NULL) {
+        celix_logHelper_error(logHelper, "RSA json rpc endpoint: Error creating stubs list for %s.",
+                endpointDesc->serviceName);
+        return CELIX_ENOMEM;
+    }
     status = celixThreadRwlock_create(&endpoint->lock, NULL);
     if (status != CELIX_SUCCESS) {
         celix_logHelper_error(logHelper, "RSA json rpc endpoint: Error initilizing lock for %s. %d.",
@@ -89,6 +115,25 @@ celix_status_t rsaJsonRpcEndpoint_create(celix_bundle_context_t* ctx, celix_log_
     }
     celix_autoptr(celix_thread_rwlock_t) lock = &endpoint->lock;
 
+    celix_autofree char *stubFilter = NULL;
+    if (asprintf(&stubFilter, "(%s=%s)", RSA_JSON_RPC_STUB_INTERFACE_NAME, endpointDesc->serviceName) < 0) {
+        celix_logHelper_error(logHelper, "RSA json rpc endpoint: Error creating stubs filter for %s.",
+                endpointDesc->serviceName);
+        return CELIX_ENOMEM;
+    }
+    celix_service_tracking_options_t stubOpts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
+    stubOpts.filter.serviceName = RSA_JSON_RPC_STUB_SERVICE_NAME;
+    stubOpts.filter.versionRange = RSA_JSON_RPC_STUB_SERVICE_USE_RANGE;
+    stubOpts.filter.filter = stubFilter;
+    stubOpts.callbackHandle = endpoint;
+    stubOpts.addWithProperties = rsaJsonRpcEndpoint_addStubSvc;
+    stubOpts.removeWithProperties = rsaJsonRpcEndpoint_removeStubSvc;
+    endpoint->stubTrackerId = celix_bundleContext_trackServicesWithOptionsAsync(endpoint->ctx, &stubOpts);
+    if (endpoint->stubTrackerId < 0) {
+        celix_logHelper_error(logHelper, "RSA json rpc endpoint: Error Registering %s stubs tracker.", endpointDesc->serviceName);
+        return CELIX_ILLEGAL_STATE;
+    }
+
     char filter[32] = {0};// It is longer than the size of "service.id" + serviceId
     (void)snprintf(filter, sizeof(filter), "(%s=%ld)", CELIX_FRAMEWORK_SERVICE_ID, endpointDesc->serviceId);
     celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
@@ -99,6 +144,12 @@ celix_status_t rsaJsonRpcEndpoint_create(celix_bundle_context_t* ctx, celix_log_
     endpoint->svcTrackerId = celix_bundleContext_trackServicesWithOptionsAsync(endpoint->ctx, &opts);
     if (endpoint->svcTrackerId < 0) {
         celix_logHelper_error(logHelper, "RSA json rpc endpoint: Error Registering %s tracker.", endpointDesc->serviceName);
+        celix_steal_ptr(lock);
+        celix_steal_ptr(endpointDescCopy);
+        celix_steal_ptr(stubs);
+        celix_bundleContext_stopTrackerAsync(endpoint->ctx, endpoint->stubTrackerId,
+                                             endpoint, rsaJsonRpcEndpoint_stopStubTrackerDone);
+        celix_steal_ptr(endpoint); // endpoint is freed in stopStubTrackerDone
         return CELIX_ILLEGAL_STATE;
     }
 
@@ -110,6 +161,7 @@ celix_status_t rsaJsonRpcEndpoint_create(celix_bundle_context_t* ctx, celix_log_
     opts1.svc = &endpoint->reqHandlerSvc;
     celix_steal_ptr(lock);
     celix_steal_ptr(endpointDescCopy);
+    celix_steal_ptr(stubs);
     endpoint->reqHandlerSvcId = celix_bundleContext_registerServiceWithOptionsAsync(endpoint->ctx, &opts1);
     if (endpoint->reqHandlerSvcId< 0) {
         celix_logHelper_error(logHelper, "Error Registering endpoint request handler service for %s.", endpointDesc->serviceName);
@@ -125,6 +177,16 @@ celix_status_t rsaJsonRpcEndpoint_create(celix_bundle_context_t* ctx, celix_log_
 static void rsaJsonRpcEndpoint_stopSvcTrackerDone(void *data) {
     assert(data != NULL);
     rsa_json_rpc_endpoint_t *endpoint = (rsa_json_rpc_endpoint_t *)data;
+    celix_bundleContext_stopTrackerAsync(endpoint->ctx, endpoint->stubTrackerId,
+            endpoint, rsaJsonRpcEndpoint_stopStubTrackerDone);
+    return;
+}
+
+static void rsaJsonRpcEndpoint_stopStubTrackerDone(void *data) {
+    assert(data != NULL);
+    rsa_json_rpc_endpoint_t *endpoint = (rsa_json_rpc_endpoint_t *)data;
+    assert(celix_arrayList_size(endpoint->stubs) == 0);
+    celix_arrayList_destroy(endpoint->stubs);
     (void)celixThreadRwlock_destroy(&endpoint->lock);
     endpointDescription_destroy(endpoint->endpointDesc);
     free(endpoint);
@@ -159,13 +221,13 @@ static void rsaJsonRpcEndpoint_addSvcWithOwner(void *handle, void *service,
     assert(svcOwner != NULL);
     celix_status_t status = CELIX_SUCCESS;
     rsa_json_rpc_endpoint_t *endpoint = (rsa_json_rpc_endpoint_t *)handle;
-    celix_autoptr(dyn_interface_type) intfType = NULL;
+    dyn_interface_type* intfType = NULL;
     const char *serviceName = celix_properties_get(endpoint->endpointDesc->properties, CELIX_FRAMEWORK_SERVICE_NAME, "unknown-service");
 
     celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&endpoint->lock);
 
-    status = dfi_findAndParseInterfaceDescriptor(endpoint->logHelper,endpoint->ctx,
-            svcOwner, endpoint->endpointDesc->serviceName, &intfType);
+    status = dfi_acquireInterfaceDescriptor(endpoint->logHelper, endpoint->ctx, svcOwner,
+            endpoint->endpointDesc->serviceName, NULL, &intfType);
     if (status != CELIX_SUCCESS) {
         celix_logHelper_error(endpoint->logHelper, "Endpoint: Error Parsing service descriptor for %s.", serviceName);
         return;
@@ -177,23 +239,89 @@ static void rsaJsonRpcEndpoint_addSvcWithOwner(void *handle, void *service,
     if (ret != 0) {
         celix_logHelper_logTssErrors(endpoint->logHelper, CELIX_LOG_LEVEL_ERROR);
         celix_logHelper_error(endpoint->logHelper, "Endpoint: Error getting interface version from the descriptor for %s.", serviceName);
+        dfi_releaseInterfaceDescriptor(intfType);
         return;
     }
     const char *serviceVersion = celix_properties_get(endpoint->endpointDesc->properties,CELIX_FRAMEWORK_SERVICE_VERSION, NULL);
     if (serviceVersion == NULL) {
         celix_logHelper_error(endpoint->logHelper, "Endpoint: Error getting service version for %s.", serviceName);
+        dfi_releaseInterfaceDescriptor(intfType);
         return;
     }
     if(strcmp(serviceVersion, intfVersion)!=0){
         celix_logHelper_error(endpoint->logHelper, "Endpoint: %s version (%s) and interface version from the descriptor (%s) are not the same!", serviceName, serviceVersion,intfVersion);
+        dfi_releaseInterfaceDescriptor(intfType);
         return;
     }
 
     endpoint->service = service;
-    endpoint->intfType = celix_steal_ptr(intfType);
+    endpoint->svcOwnerId = celix_bundle_getId(svcOwner);
+    endpoint->intfVersion = intfVersion;
+    endpoint->intfType = intfType;
+    rsaJsonRpcEndpoint_selectStubService(endpoint);
     return;
 }
 
+/**
+ * @brief Select the code-generated stubs registered by the service owner for the interface version of the service
+ * descriptor, if tracked. Should be called with the write lock.
+ */
+static void rsaJsonRpcEndpoint_selectStubService(rsa_json_rpc_endpoint_t *endpoint) {
+    endpoint->stubSvc = NULL;
+    if (endpoint->service == NULL) {
+        return;
+    }
+    for (int i = 0; i < celix_arrayList_size(endpoint->stubs); ++i) {
+        rsa_json_rpc_endpoint_stub_t *stub = celix_arrayList_get(endpoint->stubs, i);
+        if (stub->bundleId == endpoint->svcOwnerId && celix_utils_stringEquals(stub->intfVersion, endpoint->intfVersion)) {
+            endpoint->stubSvc = stub->stubSvc;
+            return;
+        }
+    }
+}
+
+static void rsaJsonRpcEndpoint_addStubSvc(void *handle, void *svc, const celix_properties_t *props) {
+    assert(handle != NULL);
+    rsa_json_rpc_endpoint_t *endpoint = (rsa_json_rpc_endpoint_t *)handle;
+    rsa_json_rpc_endpoint_stub_t *stub = calloc(1, sizeof(*stub));
+    if (stub == NULL) {
+        celix_logHelper_error(endpoint->logHelper, "Endpoint: Error allocating stub entry for %s.",
+                endpoint->endpointDesc->serviceName);
+        return;// fall back to the dynamic function interface
+    }
+    stub->stubSvc = svc;
+    stub->svcId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_ID, -1);
+    stub->bundleId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_BUNDLE_ID, -1);
+    stub->intfVersion = celix_properties_get(props, RSA_JSON_RPC_STUB_INTERFACE_VERSION, "");
+
+    celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&endpoint->lock);
+    if (celix_arrayList_add(endpoint->stubs, stub) != CELIX_SUCCESS) {
+        celix_logHelper_error(endpoint->logHelper, "Endpoint: Error adding stub entry for %s.",
+                endpoint->endpointDesc->serviceName);
+        free(stub);
+        return;
+    }
+    rsaJsonRpcEndpoint_selectStubService(endpoint);
+}
+
+static void rsaJsonRpcEndpoint_removeStubSvc(void *handle, void *svc, const celix_properties_t *props) {
+    assert(handle != NULL);
+    (void)svc;
+    rsa_json_rpc_endpoint_t *endpoint = (rsa_json_rpc_endpoint_t *)handle;
+    long svcId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_ID, -1);
+    //note the write lock ensures that no request is using the stubs anymore
+    celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&endpoint->lock);
+    for (int i = 0; i < celix_arrayList_size(endpoint->stubs); ++i) {
+        rsa_json_rpc_endpoint_stub_t *stub = celix_arrayList_get(endpoint->stubs, i);
+        if (stub->svcId == svcId) {
+            celix_arrayList_removeAt(endpoint->stubs, i);
+            free(stub);
+            break;
+        }
+    }
+    rsaJsonRpcEndpoint_selectStubService(endpoint);
+}
+
 static void rsaJsonRpcEndpoint_removeSvcWithOwner(void *handle, void *service,
         const celix_properties_t *props, const celix_bundle_t *svcOwner) {
     assert(handle != NULL);
@@ -203,7 +331,9 @@ static void rsaJsonRpcEndpoint_removeSvcWithOwner(void *handle, void *service,
     celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&endpoint->lock);
     if (endpoint->service == service) {
         endpoint->service = NULL;
-        dynInterface_destroy(endpoint->intfType);
+        endpoint->stubSvc = NULL;
+        endpoint->intfVersion = NULL;
+        dfi_releaseInterfaceDescriptor(endpoint->intfType);
         endpoint->intfType = NULL;
     }
     return;
@@ -245,7 +375,10 @@ static celix_status_t rsaJsonRpcEndpoint_handleRequest(void *handle, celix_prope
     if (cont) {
         celixThreadRwlock_readLock(&endpoint->lock);
         if (endpoint->service != NULL) {
-            int rc1 = jsonRpc_call(endpoint->intfType, endpoint->service, (char *)request->iov_base, &szResponse);
+            const rsa_json_rpc_stub_service_t *stubSvc = endpoint->stubSvc;
+            int rc1 = (stubSvc != NULL) ?
+                    stubSvc->call(stubSvc->handle, endpoint->service, (const char *)request->iov_base, &szResponse) :
+                    jsonRpc_call(endpoint->intfType, endpoint->service, (char *)request->iov_base, &szResponse);
             status = (rc1 != 0) ? CELIX_SERVICE_EXCEPTION : CELIX_SUCCESS;
             if (rc1 != 0) {
                 celix_logHelper_logTssErrors(endpoint->logHelper, CELIX_LOG_LEVEL_ERROR);
@@ -19,6 +19,7 @@
 
 #include "rsa_json_rpc_proxy_impl.h"
 #include "rsa_request_sender_tracker.h"
+#include "rsa_json_rpc_stub_service.h"
 #include "json_rpc.h"
 #include "endpoint_description.h"
 #include "celix_stdlib_cleanup.h"
@@ -28,6 +29,8 @@
 #include "celix_constants.h"
 #include "celix_build_assert.h"
 #include "celix_long_hash_map.h"
+#include "celix_array_list.h"
+#include "celix_threads.h"
 #include <sys/queue.h>
 #include <stdbool.h>
 #include <assert.h>
@@ -44,13 +47,25 @@ struct rsa_json_rpc_proxy_factory {
     remote_interceptors_handler_t *interceptorsHandler;
     rsa_request_sender_tracker_t *reqSenderTracker;
     long reqSenderSvcId;
+    long stubTrackerId;
+    celix_thread_mutex_t mutex; //projects below
+    celix_array_list_t *stubs;//Type: rsa_json_rpc_proxy_stub_t*, the tracked stub services for the interface
 };
 
+typedef struct rsa_json_rpc_proxy_stub {
+    const rsa_json_rpc_stub_service_t *stubSvc;
+    long svcId;
+    long bundleId;
+    celix_version_t *intfVersion;
+} rsa_json_rpc_proxy_stub_t;
+
 typedef struct rsa_json_rpc_proxy {
     rsa_json_rpc_proxy_factory_t *proxyFactory;
     dyn_interface_type *intfType;
     void *service;
     unsigned int useCnt;
+    const rsa_json_rpc_stub_service_t *stubSvc;//NULL if the proxy uses the dynamic function interface
+    rsa_json_rpc_stub_transport_t transport;
 }rsa_json_rpc_proxy_t;
 
 struct rsa_request_sender_callback_data {
@@ -66,8 +81,14 @@ static void rsaJsonRpcProxy_ungetService(void *handle, const celix_bundle_t *req
         const celix_properties_t *svcProperties);
 static celix_status_t rsaJsonRpcProxy_create(rsa_json_rpc_proxy_factory_t *proxyFactory,
         const celix_bundle_t *requestingBundle, rsa_json_rpc_proxy_t **proxyOut);
+static celix_status_t rsaJsonRpcProxy_initService(rsa_json_rpc_proxy_factory_t *proxyFactory, rsa_json_rpc_proxy_t *proxy);
 static void rsaJsonRpcProxy_destroy(rsa_json_rpc_proxy_t *proxy);
 static void rsaJsonRpcProxy_unregisterFacSvcDone(void *data);
+static void rsaJsonRpcProxy_stopStubTrackerDone(void *data);
+static celix_status_t rsaJsonRpcProxy_initStubService(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        rsa_json_rpc_proxy_t *proxy, const rsa_json_rpc_stub_service_t *stubSvc, const celix_version_t *intfVersion);
+static void rsaJsonRpcProxy_addStubSvc(void *handle, void *svc, const celix_properties_t *props);
+static void rsaJsonRpcProxy_removeStubSvc(void *handle, void *svc, const celix_properties_t *props);
 
 celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx, celix_log_helper_t *logHelper,
         FILE *logFile, remote_interceptors_handler_t *interceptorsHandler,
@@ -107,6 +128,36 @@ celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx, celix_
         return CELIX_ENOMEM;
     }
 
+    celix_autoptr(celix_array_list_t) stubs = proxyFactory->stubs = celix_arrayList_create();
+    if (stubs == NULL) {
+        celix_logHelper_error(logHelper, "Proxy: Error creating stubs list.");
+        return CELIX_ENOMEM;
+    }
+    celix_status_t status = celixThreadMutex_create(&proxyFactory->mutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Proxy: Error creating mutex. %d.", status);
+        return status;
+    }
+    celix_autoptr(celix_thread_mutex_t) mutex = &proxyFactory->mutex;
+
+    celix_autofree char *stubFilter = NULL;
+    if (asprintf(&stubFilter, "(%s=%s)", RSA_JSON_RPC_STUB_INTERFACE_NAME, endpointDesc->serviceName) < 0) {
+        celix_logHelper_error(logHelper, "Proxy: Error creating stubs filter for %s.", endpointDesc->serviceName);
+        return CELIX_ENOMEM;
+    }
+    celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
+    opts.filter.serviceName = RSA_JSON_RPC_STUB_SERVICE_NAME;
+    opts.filter.versionRange = RSA_JSON_RPC_STUB_SERVICE_USE_RANGE;
+    opts.filter.filter = stubFilter;
+    opts.callbackHandle = proxyFactory;
+    opts.addWithProperties = rsaJsonRpcProxy_addStubSvc;
+    opts.removeWithProperties = rsaJsonRpcProxy_removeStubSvc;
+    proxyFactory->stubTrackerId = celix_bundleContext_trackServicesWithOptionsAsync(ctx, &opts);
+    if (proxyFactory->stubTrackerId < 0) {
+        celix_logHelper_error(logHelper, "Proxy: Error tracking %s stubs.", endpointDesc->serviceName);
+        return CELIX_ILLEGAL_STATE;
+    }
+
     proxyFactory->factory.handle = proxyFactory;
     proxyFactory->factory.getService = rsaJsonRpcProxy_getService;
     proxyFactory->factory.ungetService = rsaJsonRpcProxy_ungetService;
@@ -116,11 +167,20 @@ celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx, celix_
             ctx, &proxyFactory->factory, endpointDesc->serviceName, props);
     if (proxyFactory->factorySvcId  < 0) {
         celix_logHelper_error(logHelper, "Proxy: Error Registering proxy service.");
+        celix_steal_ptr(endpointDescCopy);
+        celix_steal_ptr(proxies);
+        celix_steal_ptr(stubs);
+        celix_steal_ptr(mutex);
+        celix_bundleContext_stopTrackerAsync(ctx, proxyFactory->stubTrackerId,
+                proxyFactory, rsaJsonRpcProxy_stopStubTrackerDone);
+        celix_steal_ptr(proxyFactory); // proxyFactory is freed in stopStubTrackerDone
         return CELIX_SERVICE_EXCEPTION;
     }
 
     celix_steal_ptr(endpointDescCopy);
     celix_steal_ptr(proxies);
+    celix_steal_ptr(stubs);
+    celix_steal_ptr(mutex);
     *proxyFactoryOut = celix_steal_ptr(proxyFactory);
     return CELIX_SUCCESS;
 }
@@ -138,6 +198,17 @@ long rsaJsonRpcProxy_factorySvcId(rsa_json_rpc_proxy_factory_t *proxyFactory) {
 static void rsaJsonRpcProxy_unregisterFacSvcDone(void *data) {
     assert(data);
     rsa_json_rpc_proxy_factory_t *proxyFactory = (rsa_json_rpc_proxy_factory_t *)data;
+    celix_bundleContext_stopTrackerAsync(proxyFactory->ctx, proxyFactory->stubTrackerId,
+            proxyFactory, rsaJsonRpcProxy_stopStubTrackerDone);
+    return;
+}
+
+static void rsaJsonRpcProxy_stopStubTrackerDone(void *data) {
+    assert(data);
+    rsa_json_rpc_proxy_factory_t *proxyFactory = (rsa_json_rpc_proxy_factory_t *)data;
+    assert(celix_arrayList_size(proxyFactory->stubs) == 0);
+    celix_arrayList_destroy(proxyFactory->stubs);
+    (void)celixThreadMutex_destroy(&proxyFactory->mutex);
     endpointDescription_destroy(proxyFactory->endpointDesc);
     assert(celix_longHashMap_size(proxyFactory->proxies) == 0);
     celix_longHashMap_destroy(proxyFactory->proxies);
@@ -145,6 +216,53 @@ static void rsaJsonRpcProxy_unregisterFacSvcDone(void *data) {
     return;
 }
 
+static void rsaJsonRpcProxy_addStubSvc(void *handle, void *svc, const celix_properties_t *props) {
+    assert(handle != NULL);
+    rsa_json_rpc_proxy_factory_t *proxyFactory = (rsa_json_rpc_proxy_factory_t *)handle;
+    celix_autofree rsa_json_rpc_proxy_stub_t *stub = calloc(1, sizeof(*stub));
+    if (stub == NULL) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error allocating stub entry for %s.",
+                proxyFactory->endpointDesc->serviceName);
+        return;// fall back to the dynamic function interface
+    }
+    stub->intfVersion = celix_properties_getAsVersion(props, RSA_JSON_RPC_STUB_INTERFACE_VERSION, NULL);
+    if (stub->intfVersion == NULL) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Stubs for %s have no valid interface version.",
+                proxyFactory->endpointDesc->serviceName);
+        return;
+    }
+    stub->stubSvc = svc;
+    stub->svcId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_ID, -1);
+    stub->bundleId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_BUNDLE_ID, -1);
+
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&proxyFactory->mutex);
+    if (celix_arrayList_add(proxyFactory->stubs, stub) != CELIX_SUCCESS) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error adding stub entry for %s.",
+                proxyFactory->endpointDesc->serviceName);
+        celix_version_destroy(stub->intfVersion);
+        return;
+    }
+    celix_steal_ptr(stub);
+}
+
+static void rsaJsonRpcProxy_removeStubSvc(void *handle, void *svc, const celix_properties_t *props) {
+    assert(handle != NULL);
+    (void)svc;
+    rsa_json_rpc_proxy_factory_t *proxyFactory = (rsa_json_rpc_proxy_factory_t *)handle;
+    long svcId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_ID, -1);
+    //note existing proxies keep using the stubs, the stubs stay valid until their proxies are destroyed
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&proxyFactory->mutex);
+    for (int i = 0; i < celix_arrayList_size(proxyFactory->stubs); ++i) {
+        rsa_json_rpc_proxy_stub_t *stub = celix_arrayList_get(proxyFactory->stubs, i);
+        if (stub->svcId == svcId) {
+            celix_arrayList_removeAt(proxyFactory->stubs, i);
+            celix_version_destroy(stub->intfVersion);
+            free(stub);
+            break;
+        }
+    }
+}
+
 static void* rsaJsonRpcProxy_getService(void *handle, const celix_bundle_t *requestingBundle,
         const celix_properties_t *svcProperties) {
     assert(handle != NULL);
@@ -193,73 +311,56 @@ static celix_status_t rsaJsonRpcProxy_useReqSenderSvcCallback(void *handle, rsa_
             data->request, data->response);
 }
 
-static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *returnVal) {
-    celix_status_t  status = CELIX_SUCCESS;
-    if (returnVal == NULL) {
-        return;
+static celix_status_t rsaJsonRpcProxy_checkVersion(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        const celix_version_t *consumerVersion) {
+    celix_status_t status = CELIX_SUCCESS;
+    const char *providerVerStr = celix_properties_get(proxyFactory->endpointDesc->properties,CELIX_FRAMEWORK_SERVICE_VERSION, NULL);
+    if (providerVerStr == NULL) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error getting provider service version.");
+        return CELIX_ILLEGAL_ARGUMENT;
     }
-    if ((args == NULL) || (*((void **)args[0]) == NULL)) {
-        *(celix_status_t *)returnVal = CELIX_ILLEGAL_ARGUMENT;
-        return;
+    celix_autoptr(celix_version_t) providerVersion = celix_version_createVersionFromString(providerVerStr);
+    if (providerVersion == NULL) {
+        status = CELIX_ENOMEM;
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error converting service version type. %d.", status);
+        return status;
     }
-    assert(userData != NULL);
-    struct method_entry *entry = userData;
-    rsa_json_rpc_proxy_t *proxy = *((void **)args[0]);
-    rsa_json_rpc_proxy_factory_t *proxyFactory = proxy->proxyFactory;
-    assert(proxyFactory != NULL);
-
-    char *invokeRequest = NULL;
-    int rc = jsonRpc_prepareInvokeRequest(entry->dynFunc, entry->id, args, &invokeRequest);
-    if (rc != 0) {
-        celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(proxyFactory->logHelper, "Error preparing invoke request for %s", entry->name);
-        *(celix_status_t *)returnVal = CELIX_SERVICE_EXCEPTION;
-        return;
+    bool isCompatible = celix_version_isCompatible(consumerVersion, providerVersion);
+    if(!isCompatible){
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Service version mismatch, consumer has %d.%d.%d, provider has %s.",
+                              celix_version_getMajor(consumerVersion), celix_version_getMinor(consumerVersion),
+                              celix_version_getMicro(consumerVersion) , providerVerStr);
+        return CELIX_SERVICE_EXCEPTION;
     }
+    return CELIX_SUCCESS;
+}
 
-    struct iovec replyIovec = {NULL,0};
+static celix_status_t rsaJsonRpcProxy_sendRequest(rsa_json_rpc_proxy_factory_t *proxyFactory, const char *methodName,
+        const char *request, struct iovec *replyIovec) {
+    celix_status_t  status = CELIX_SUCCESS;
     celix_properties_t *metadata = celix_properties_create();
     if (metadata == NULL) {
-        celix_logHelper_error(proxyFactory->logHelper,"Error creating metadata for %s", entry->name);
-        free(invokeRequest);
-        *(celix_status_t *)returnVal = CELIX_ENOMEM;
-        return;
+        celix_logHelper_error(proxyFactory->logHelper,"Error creating metadata for %s", methodName);
+        return CELIX_ENOMEM;
     }
     celix_properties_setLong(metadata, "SerialProtocolId", proxyFactory->serialProtoId);
     bool cont = remoteInterceptorHandler_invokePreProxyCall(proxyFactory->interceptorsHandler,
-            proxyFactory->endpointDesc->properties, entry->name, &metadata);
+            proxyFactory->endpointDesc->properties, methodName, &metadata);
     if (cont) {
-        struct iovec requestIovec = {invokeRequest,strlen(invokeRequest) + 1};
+        struct iovec requestIovec = {(void *)request,strlen(request) + 1};
         struct rsa_request_sender_callback_data data= {
                 .endpointDesc = proxyFactory->endpointDesc,
                 .metadata = metadata,
                 .request = &requestIovec,
-                .response = &replyIovec
+                .response = replyIovec
         };
         status = rsaRequestSenderTracker_useService(proxyFactory->reqSenderTracker, proxyFactory->reqSenderSvcId,
                 &data, rsaJsonRpcProxy_useReqSenderSvcCallback);
-        if (status == CELIX_SUCCESS && dynFunction_hasReturn(entry->dynFunc)) {
-            if (replyIovec.iov_base != NULL) {
-                int rsErrno = CELIX_SUCCESS;
-                int retVal = jsonRpc_handleReply(entry->dynFunc,
-                        (const char *)replyIovec.iov_base , args, &rsErrno);
-                if(retVal != 0) {
-                    status = CELIX_SERVICE_EXCEPTION;
-                    celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
-                    celix_logHelper_error(proxyFactory->logHelper, "Error handling reply for %s", entry->name);
-                } else if (rsErrno != CELIX_SUCCESS) {
-                    //return the invocation error of remote service function
-                    status = rsErrno;
-                }
-            } else {
-                celix_logHelper_error(proxyFactory->logHelper,"Expect service proxy has return, but reply is empty.");
-                status = CELIX_ILLEGAL_ARGUMENT;
-            }
-        } else if (status != CELIX_SUCCESS) {
+        if (status != CELIX_SUCCESS) {
             celix_logHelper_error(proxyFactory->logHelper,"Service proxy send request failed. %d", status);
         }
         remoteInterceptorHandler_invokePostProxyCall(proxyFactory->interceptorsHandler,
-                proxyFactory->endpointDesc->properties, entry->name, metadata);
+                proxyFactory->endpointDesc->properties, methodName, metadata);
     } else {
         celix_logHelper_error(proxyFactory->logHelper, "%s has been intercepted.", proxyFactory->endpointDesc->serviceName);
         status = CELIX_INTERCEPTOR_EXCEPTION;
@@ -272,10 +373,56 @@ static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *retu
 
     if (proxyFactory->callsLogFile != NULL) {
         fprintf(proxyFactory->callsLogFile, "PROXY REMOTE CALL:\n\tservice=%s\n\tservice_id=%lu\n\trequest_payload=%s\n\trequest_response=%s\n\tstatus=%i\n",
-                proxyFactory->endpointDesc->serviceName, proxyFactory->endpointDesc->serviceId, invokeRequest, (char *)replyIovec.iov_base, status);
+                proxyFactory->endpointDesc->serviceName, proxyFactory->endpointDesc->serviceId, request, (char *)replyIovec->iov_base, status);
         fflush(proxyFactory->callsLogFile);
     }
+    return status;
+}
+
+static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *returnVal) {
+    celix_status_t  status = CELIX_SUCCESS;
+    if (returnVal == NULL) {
+        return;
+    }
+    if ((args == NULL) || (*((void **)args[0]) == NULL)) {
+        *(celix_status_t *)returnVal = CELIX_ILLEGAL_ARGUMENT;
+        return;
+    }
+    assert(userData != NULL);
+    struct method_entry *entry = userData;
+    rsa_json_rpc_proxy_t *proxy = *((void **)args[0]);
+    rsa_json_rpc_proxy_factory_t *proxyFactory = proxy->proxyFactory;
+    assert(proxyFactory != NULL);
+
+    char *invokeRequest = NULL;
+    int rc = jsonRpc_prepareInvokeRequest(entry->dynFunc, entry->id, args, &invokeRequest);
+    if (rc != 0) {
+        celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(proxyFactory->logHelper, "Error preparing invoke request for %s", entry->name);
+        *(celix_status_t *)returnVal = CELIX_SERVICE_EXCEPTION;
+        return;
+    }
 
+    struct iovec replyIovec = {NULL,0};
+    status = rsaJsonRpcProxy_sendRequest(proxyFactory, entry->name, invokeRequest, &replyIovec);
+    if (status == CELIX_SUCCESS && dynFunction_hasReturn(entry->dynFunc)) {
+        if (replyIovec.iov_base != NULL) {
+            int rsErrno = CELIX_SUCCESS;
+            int retVal = jsonRpc_handleReply(entry->dynFunc,
+                    (const char *)replyIovec.iov_base , args, &rsErrno);
+            if(retVal != 0) {
+                status = CELIX_SERVICE_EXCEPTION;
+                celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
+                celix_logHelper_error(proxyFactory->logHelper, "Error handling reply for %s", entry->name);
+            } else if (rsErrno != CELIX_SUCCESS) {
+                //return the invocation error of remote service function
+                status = rsErrno;
+            }
+        } else {
+            celix_logHelper_error(proxyFactory->logHelper,"Expect service proxy has return, but reply is empty.");
+            status = CELIX_ILLEGAL_ARGUMENT;
+        }
+    }
 
     free(invokeRequest); //Allocated by json_dumps in jsonRpc_prepareInvokeRequest
     if (replyIovec.iov_base) {
@@ -287,6 +434,57 @@ static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *retu
     return;
 }
 
+static celix_status_t rsaJsonRpcProxy_sendStubRequest(void *handle, const char *methodName, const char *request,
+        char **reply) {
+    assert(handle != NULL);
+    rsa_json_rpc_proxy_t *proxy = (rsa_json_rpc_proxy_t *)handle;
+    struct iovec replyIovec = {NULL,0};
+    celix_status_t status = rsaJsonRpcProxy_sendRequest(proxy->proxyFactory, methodName, request, &replyIovec);
+    if (status != CELIX_SUCCESS) {
+        free(replyIovec.iov_base);
+        return status;
+    }
+    *reply = replyIovec.iov_base;
+    return CELIX_SUCCESS;
+}
+
+/**
+ * @brief Create the proxy service using the tracked code-generated stubs registered by the requesting bundle, if any.
+ * @return CELIX_SUCCESS with a NULL stubSvc if there are no stubs for the requesting bundle.
+ */
+static celix_status_t rsaJsonRpcProxy_initTrackedStubService(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        rsa_json_rpc_proxy_t *proxy, const celix_bundle_t *requestingBundle) {
+    long bundleId = celix_bundle_getId(requestingBundle);
+    //note the lock keeps the stubs service registered while the stub proxy is created
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&proxyFactory->mutex);
+    for (int i = 0; i < celix_arrayList_size(proxyFactory->stubs); ++i) {
+        rsa_json_rpc_proxy_stub_t *stub = celix_arrayList_get(proxyFactory->stubs, i);
+        if (stub->bundleId == bundleId) {
+            return rsaJsonRpcProxy_initStubService(proxyFactory, proxy, stub->stubSvc, stub->intfVersion);
+        }
+    }
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t rsaJsonRpcProxy_initStubService(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        rsa_json_rpc_proxy_t *proxy, const rsa_json_rpc_stub_service_t *stubSvc, const celix_version_t *intfVersion) {
+    celix_status_t status = rsaJsonRpcProxy_checkVersion(proxyFactory, intfVersion);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    proxy->transport.handle = proxy;
+    proxy->transport.sendRequest = rsaJsonRpcProxy_sendStubRequest;
+    status = stubSvc->createProxy(stubSvc->handle, &proxy->transport, &proxy->service);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Failed to create stub proxy for %s.",
+                proxyFactory->endpointDesc->serviceName);
+        return status;
+    }
+    proxy->stubSvc = stubSvc;
+    return CELIX_SUCCESS;
+}
+
 static celix_status_t rsaJsonRpcProxy_create(rsa_json_rpc_proxy_factory_t *proxyFactory,
         const celix_bundle_t *requestingBundle, rsa_json_rpc_proxy_t **proxyOut) {
     celix_status_t status = CELIX_SUCCESS;
@@ -297,35 +495,40 @@ static celix_status_t rsaJsonRpcProxy_create(rsa_json_rpc_proxy_factory_t *proxy
     proxy->proxyFactory = proxyFactory;
     proxy->useCnt = 0;
 
-    celix_autoptr(dyn_interface_type) intfType = NULL;
-    status = dfi_findAndParseInterfaceDescriptor(proxyFactory->logHelper,
-            proxyFactory->ctx, requestingBundle, proxyFactory->endpointDesc->serviceName, &intfType);
+    status = rsaJsonRpcProxy_initTrackedStubService(proxyFactory, proxy, requestingBundle);
     if (status != CELIX_SUCCESS) {
         return status;
     }
-    proxy->intfType = intfType;
+    if (proxy->stubSvc != NULL) {
+        *proxyOut = celix_steal_ptr(proxy);
+        return CELIX_SUCCESS;
+    }
 
-    //Check service version
-    const char *providerVerStr = celix_properties_get(proxyFactory->endpointDesc->properties,CELIX_FRAMEWORK_SERVICE_VERSION, NULL);
-    if (providerVerStr == NULL) {
-        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error getting provider service version.");
-        return CELIX_ILLEGAL_ARGUMENT;
+    dyn_interface_type* intfType = NULL;
+    status = dfi_acquireInterfaceDescriptor(proxyFactory->logHelper, proxyFactory->ctx, requestingBundle,
+            proxyFactory->endpointDesc->serviceName, rsaJsonRpcProxy_serviceFunc, &intfType);
+    if (status != CELIX_SUCCESS) {
+        return status;
     }
-    celix_autoptr(celix_version_t) providerVersion = celix_version_createVersionFromString(providerVerStr);
-    if (providerVersion == NULL) {
-        status = CELIX_ENOMEM;
-        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error converting service version type. %d.", status);
+    proxy->intfType = intfType;
+    status = rsaJsonRpcProxy_initService(proxyFactory, proxy);
+    if (status != CELIX_SUCCESS) {
+        dfi_releaseInterfaceDescriptor(intfType);
         return status;
     }
+    *proxyOut = celix_steal_ptr(proxy);
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t rsaJsonRpcProxy_initService(rsa_json_rpc_proxy_factory_t *proxyFactory, rsa_json_rpc_proxy_t *proxy) {
+    celix_status_t status = CELIX_SUCCESS;
+    dyn_interface_type* intfType = proxy->intfType;
+
     celix_version_t *consumerVersion = NULL;
-    bool isCompatible = false;
     dynInterface_getVersion(intfType,&consumerVersion);
-    isCompatible = celix_version_isCompatible(consumerVersion, providerVersion);
-    if(!isCompatible){
-        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Service version mismatch, consumer has %d.%d.%d, provider has %s.",
-                              celix_version_getMajor(consumerVersion), celix_version_getMinor(consumerVersion),
-                              celix_version_getMicro(consumerVersion) , providerVerStr);
-        return CELIX_SERVICE_EXCEPTION;
+    status = rsaJsonRpcProxy_checkVersion(proxyFactory, consumerVersion);
+    if (status != CELIX_SUCCESS) {
+        return status;
     }
 
     size_t intfMethodNb = dynInterface_nrOfMethods(intfType);
@@ -342,24 +545,27 @@ static celix_status_t rsaJsonRpcProxy_create(rsa_json_rpc_proxy_factory_t *proxy
     void (*fn)(void) = NULL;
     int index = 0;
     TAILQ_FOREACH(entry, list, entries) {
-        int rc = dynFunction_createClosure(entry->dynFunc, rsaJsonRpcProxy_serviceFunc, entry, &fn);
+        //note the closures are created (once) by the dfi interface cache and shared between proxies
+        int rc = dynFunction_getFnPointer(entry->dynFunc, &fn);
         if (rc != 0) {
-            celix_logHelper_error(proxyFactory->logHelper, "Proxy: Failed to create closure for service function %s.", entry->name);
+            celix_logHelper_error(proxyFactory->logHelper, "Proxy: Failed to get closure for service function %s.", entry->name);
             return CELIX_SERVICE_EXCEPTION;
         }
         service[++index] = fn;
     }
 
     celix_steal_ptr(service);
-    celix_steal_ptr(intfType);
-    *proxyOut = celix_steal_ptr(proxy);
-
     return CELIX_SUCCESS;
-};
+}
 
 static void rsaJsonRpcProxy_destroy(rsa_json_rpc_proxy_t *proxy) {
+    if (proxy->stubSvc != NULL) {
+        proxy->stubSvc->destroyProxy(proxy->stubSvc->handle, proxy->service);
+        free(proxy);
+        return;
+    }
     free(proxy->service);
-    dynInterface_destroy(proxy->intfType);
+    dfi_releaseInterfaceDescriptor(proxy->intfType);
     free(proxy);
     return;
 }
@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _RSA_JSON_RPC_STUB_SERVICE_H_
+#define _RSA_JSON_RPC_STUB_SERVICE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <celix_errno.h>
+
+#define RSA_JSON_RPC_STUB_SERVICE_NAME "rsa_json_rpc_stub_service"
+#define RSA_JSON_RPC_STUB_SERVICE_VERSION "1.0.0"
+#define RSA_JSON_RPC_STUB_SERVICE_USE_RANGE "[1.0.0,2)"
+
+/**
+ * @brief Service property with the name of the remote service interface the stubs are generated for.
+ */
+#define RSA_JSON_RPC_STUB_INTERFACE_NAME "rsa.json_rpc.stub.interface.name"
+
+/**
+ * @brief Service property with the version of the remote service interface the stubs are generated for.
+ */
+#define RSA_JSON_RPC_STUB_INTERFACE_VERSION "rsa.json_rpc.stub.interface.version"
+
+/**
+ * @brief The transport used by a generated service proxy to send its JSON-RPC requests.
+ * @note It is implemented by the RPC bundle.
+ */
+typedef struct rsa_json_rpc_stub_transport {
+    void *handle;/// The transport handle
+    /**
+     * @brief Send a JSON-RPC request and wait for the reply.
+     * @param[in] handle The transport handle
+     * @param[in] methodName The name of the called method
+     * @param[in] request The JSON-RPC request
+     * @param[out] reply The JSON-RPC reply. The caller should use free function to free the reply.
+     * @return @see celix_errno.h
+     */
+    celix_status_t (*sendRequest)(void *handle, const char *methodName, const char *request, char **reply);
+} rsa_json_rpc_stub_transport_t;
+
+/**
+ * @brief The service with code-generated JSON-RPC stubs for a remote service interface.
+ *
+ * The stubs call the service methods and (de)serialize the arguments directly, without using libffi.
+ * A bundle can provide this service (see the celix_target_json_rpc_stubs CMake function) for the remote service
+ * interfaces of its descriptors. If the stubs are registered by the bundle providing the exported service (endpoint)
+ * or by the bundle using the imported service (proxy), the JSON-RPC RPC bundle uses the stubs instead of the dynamic
+ * function interface.
+ *
+ * @note The stubs service is tracked. An endpoint uses the stubs while they are registered and otherwise the dynamic
+ * function interface. A proxy uses the stubs registered when the proxy is created and calls destroyProxy when the
+ * imported service is released, also if the stubs service is unregistered by then, so the stubs service
+ * implementation should stay valid until its proxies are destroyed.
+ */
+typedef struct rsa_json_rpc_stub_service {
+    void *handle;/// The Service handle
+    /**
+     * @brief Call a service method for a JSON-RPC request.
+     * @param[in] handle Service handle
+     * @param[in] svc The service to call
+     * @param[in] request The JSON-RPC request
+     * @param[out] response The JSON-RPC response. The caller should use free function to free the response.
+     * @return 0 if successful, otherwise 1.
+     */
+    int (*call)(void *handle, void *svc, const char *request, char **response);
+    /**
+     * @brief Create a service proxy, which sends its method calls as JSON-RPC requests using the provided transport.
+     * @param[in] handle Service handle
+     * @param[in] transport The transport to use. Should be valid until the proxy is destroyed.
+     * @param[out] proxySvc The service proxy (a service struct for the remote service interface).
+     * @return @see celix_errno.h
+     */
+    celix_status_t (*createProxy)(void *handle, const rsa_json_rpc_stub_transport_t *transport, void **proxySvc);
+    /**
+     * @brief Destroy a service proxy created with createProxy.
+     */
+    void (*destroyProxy)(void *handle, void *proxySvc);
+} rsa_json_rpc_stub_service_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RSA_JSON_RPC_STUB_SERVICE_H_ */
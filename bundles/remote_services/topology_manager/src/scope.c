@@ -25,11 +25,15 @@
 #include "topology_manager.h"
 #include "utils.h"
 #include "filter.h"
+#include "celix_utils.h"
 
 struct scope_item {
+    celix_filter_t *filter;     // parsed filter, so that the filter is not parsed for every exported service
     celix_properties_t *props;
 };
 
+static void scope_destroyItem(struct scope_item *item);
+
 struct scope {
     void *manager;	// owner of the scope datastructure
     celix_thread_mutex_t exportScopeLock;
@@ -56,6 +60,12 @@ celix_status_t tm_addExportScope(void *handle, char *filter, celix_properties_t
     if (handle == NULL)
         return CELIX_ILLEGAL_ARGUMENT;
 
+    celix_autoptr(celix_filter_t) parsed = celix_filter_create(filter);
+    if (parsed == NULL) {
+        celix_properties_destroy(props);
+        return CELIX_ILLEGAL_ARGUMENT; // filter not parsable
+    }
+
     if (celixThreadMutex_lock(&scope->exportScopeLock) == CELIX_SUCCESS) {
         // For now we just don't allow two exactly the same filters
         // TODO: What we actually need is the following
@@ -66,8 +76,10 @@ celix_status_t tm_addExportScope(void *handle, char *filter, celix_properties_t
         if (present == NULL) {
             struct scope_item *item = calloc(1, sizeof(*item));
             if (item == NULL) {
+                celix_properties_destroy(props);
                 status = CELIX_ENOMEM;
             } else {
+                item->filter = celix_steal_ptr(parsed);
                 item->props = props;
                 hashMap_put(scope->exportScopes, (void*) strdup(filter), (void*) item);
             }
@@ -93,19 +105,25 @@ celix_status_t tm_removeExportScope(void *handle, char *filter) {
     if (handle == NULL)
         return CELIX_ILLEGAL_ARGUMENT;
 
+    struct scope_item *removed = NULL;
     if (celixThreadMutex_lock(&scope->exportScopeLock) == CELIX_SUCCESS) {
-        struct scope_item *present = (struct scope_item *) hashMap_get(scope->exportScopes, filter);
-        if (present == NULL) {
+        hash_map_entry_pt entry = hashMap_getEntry(scope->exportScopes, filter);
+        if (entry == NULL) {
             status = CELIX_ILLEGAL_ARGUMENT;
         } else {
-            celix_properties_destroy(present->props);
-            hashMap_remove(scope->exportScopes, filter); // frees also the item!
+            char *key = hashMapEntry_getKey(entry);
+            removed = hashMap_remove(scope->exportScopes, filter);
+            free(key);
         }
         celixThreadMutex_unlock(&scope->exportScopeLock);
     }
     if (scope->exportScopeChangedHandler != NULL) {
         status = CELIX_DO_IF(status, scope->exportScopeChangedHandler(scope->manager, filter));
     }
+    // the scope properties can still be in use by the exported services, until the manager handled the removal
+    if (removed != NULL) {
+        scope_destroyItem(removed);
+    }
     return status;
 }
 
@@ -207,10 +225,10 @@ celix_status_t scope_scopeDestroy(scope_pt scope) {
         while (hashMapIterator_hasNext(iter)) {
             hash_map_entry_pt scopedEntry = hashMapIterator_nextEntry(iter);
             struct scope_item *item = (struct scope_item*) hashMapEntry_getValue(scopedEntry);
-            celix_properties_destroy(item->props);
+            scope_destroyItem(item);
         }
         hashMapIterator_destroy(iter);
-        hashMap_destroy(scope->exportScopes, true, true); // free keys, free values
+        hashMap_destroy(scope->exportScopes, true, false); // free keys, values are already freed
         celixThreadMutex_unlock(&scope->exportScopeLock);
     }
 
@@ -235,6 +253,12 @@ celix_status_t scope_scopeDestroy(scope_pt scope) {
 /*****************************************************************************
  * STATIC FUNCTIONS
  *****************************************************************************/
+static void scope_destroyItem(struct scope_item *item) {
+    celix_filter_destroy(item->filter);
+    celix_properties_destroy(item->props);
+    free(item);
+}
+
 static celix_status_t import_equal(const void *src, const void *dest, bool *equals) {
     celix_status_t status;
 
@@ -264,13 +288,25 @@ bool scope_allowImport(scope_pt scope, endpoint_description_t *endpoint) {
     return allowImport;
 }
 
-celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt reference, celix_properties_t **props) {
+int scope_getImportScopeCount(scope_pt scope) {
+    int count = 0;
+    if (celixThreadMutex_lock(&(scope->importScopeLock)) == CELIX_SUCCESS) {
+        count = arrayList_size(scope->importScopes);
+        celixThreadMutex_unlock(&scope->importScopeLock);
+    }
+    return count;
+}
+
+celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt reference, celix_properties_t **props, char **matchedFilter) {
     celix_status_t status = CELIX_SUCCESS;
     unsigned int size = 0;
     char **keys;
     bool found = false;
 
     *props = NULL;
+    if (matchedFilter != NULL) {
+        *matchedFilter = NULL;
+    }
     celix_properties_t *serviceProperties = celix_properties_create();  // GB: not sure if a copy is needed
                                                                         // or serviceReference_getProperties() is
                                                                         // is acceptable
@@ -296,14 +332,13 @@ celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt re
         //       the additional output properties for each filter that matches?
         while ((!found) && hashMapIterator_hasNext(scopedPropIter)) {
             hash_map_entry_pt scopedEntry = hashMapIterator_nextEntry(scopedPropIter);
-            char *filterStr = (char *) hashMapEntry_getKey(scopedEntry);
-            celix_autoptr(celix_filter_t) filter = celix_filter_create(filterStr);
-            if (filter != NULL) {
-                // test if the scope filter matches the exported service properties
-                status = filter_match(filter, serviceProperties, &found);
-                if (found) {
-                    struct scope_item *item = (struct scope_item *) hashMapEntry_getValue(scopedEntry);
-                    *props = item->props;
+            struct scope_item *item = (struct scope_item *) hashMapEntry_getValue(scopedEntry);
+            // test if the scope filter matches the exported service properties
+            found = celix_filter_match(item->filter, serviceProperties);
+            if (found) {
+                *props = item->props;
+                if (matchedFilter != NULL) {
+                    *matchedFilter = celix_utils_strdup(hashMapEntry_getKey(scopedEntry));
                 }
             }
         }
@@ -88,17 +88,27 @@ void scope_setImportScopeChangedCallback(scope_pt scope, celix_status_t (*change
  */
 bool scope_allowImport(scope_pt scope, endpoint_description_t *endpoint);
 
+/* \brief  Get the number of import scopes
+ *
+ * \param  scope containing import rules
+ *
+ * \return the number of import scopes, 0 if all imports are allowed
+ */
+int scope_getImportScopeCount(scope_pt scope);
+
 /* \brief  Test if scope allows import of service
  *
  * \param  scope containing export rules
  * \param  reference to service
  * \param  props, additional properties defining restrictions for the exported service
  *                NULL if no additional restrictions found
+ * \param  matchedFilter, if not NULL, a copy of the export scope filter which matched the service
+ *                NULL if no export scope filter matched. The caller is responsible for freeing the string.
  *
  * \return CELIX_SUCCESS
  *
  */
-celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt reference, celix_properties_t **props);
+celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt reference, celix_properties_t **props, char **matchedFilter);
 
 /* \brief  add restricted scope for specified exported service
  *
@@ -46,6 +46,35 @@
 #include "scope.h"
 #include "hash_map.h"
 #include "celix_array_list.h"
+#include "celix_long_hash_map.h"
+#include "celix_string_hash_map.h"
+#include "celix_utils.h"
+
+/**
+ * An exported service and its export registrations.
+ * The exported services are indexed on service id and on service name, so that a scope change only needs to
+ * re-evaluate the exported services with a service name which can match the changed scope filter.
+ */
+typedef struct topology_manager_exported_service {
+	service_reference_pt reference;
+	long serviceId;
+	char *serviceName;
+	celix_properties_t *scopeProperties; //owned by the scope, NULL if no export scope matched
+	char *scopeFilter; //the matched export scope filter, NULL if no export scope matched
+	hash_map_pt exports; //key is rsa, value is array list of export registrations
+} topology_manager_exported_service_t;
+
+/**
+ * An imported (discovered) endpoint and its import registrations.
+ * The imported services are indexed on endpoint id and on service name, so that a scope change only needs to
+ * re-evaluate the imported services with a service name which can match the changed scope filter.
+ */
+typedef struct topology_manager_imported_service {
+	endpoint_description_t *endpoint;
+	char *serviceName;
+	bool allowed; //whether the import scope allows the import of the endpoint
+	hash_map_pt imports; //key is rsa, value is import registration
+} topology_manager_imported_service_t;
 
 struct topology_manager {
 	celix_bundle_context_t *context;
@@ -54,13 +83,17 @@ struct topology_manager {
 
 	hash_map_pt listenerList;
 
-	hash_map_pt exportedServices;
+	celix_long_hash_map_t *exportedServices; //key is service id, value is topology_manager_exported_service_t*
 
-	hash_map_pt importedServices;
+	celix_string_hash_map_t *exportedServicesByName; //key is service name, value is array list of topology_manager_exported_service_t*
+
+	celix_string_hash_map_t *importedServices; //key is endpoint id, value is topology_manager_imported_service_t*
+
+	celix_string_hash_map_t *importedServicesByName; //key is service name, value is array list of topology_manager_imported_service_t*
 
 	bool closed;
 
-	//The mutex is used to protect rsaList,listenerList,exportedServices,importedServices,closed,and their related operations.
+	//The mutex is used to protect rsaList,listenerList,exportedServices,importedServices,their indexes,closed,and their related operations.
 	celix_thread_mutex_t lock;
 
 	scope_pt scope;
@@ -78,6 +111,9 @@ static celix_status_t topologyManager_removeImportedService_nolock(void *handle,
 static celix_status_t topologyManager_addExportedService_nolock(void * handle, service_reference_pt reference, void * service);
 static celix_status_t topologyManager_removeExportedService_nolock(void * handle, service_reference_pt reference, void * service);
 
+static void topologyManager_destroyExportedService(topology_manager_exported_service_t *exportedService);
+static void topologyManager_destroyImportedService(topology_manager_imported_service_t *importedService);
+
 celix_status_t topologyManager_create(celix_bundle_context_t *context, celix_log_helper_t *logHelper, topology_manager_pt *manager, void **scope) {
 	celix_status_t status = CELIX_SUCCESS;
 
@@ -94,8 +130,10 @@ celix_status_t topologyManager_create(celix_bundle_context_t *context, celix_log
 
 	(*manager)->rsaList = celix_arrayList_create();
 	(*manager)->listenerList = hashMap_create(serviceReference_hashCode, NULL, serviceReference_equals2, NULL);
-	(*manager)->exportedServices = hashMap_create(serviceReference_hashCode, NULL, serviceReference_equals2, NULL);
-	(*manager)->importedServices = hashMap_create(NULL, NULL, NULL, NULL);
+	(*manager)->exportedServices = celix_longHashMap_create();
+	(*manager)->exportedServicesByName = celix_stringHashMap_create();
+	(*manager)->importedServices = celix_stringHashMap_create();
+	(*manager)->importedServicesByName = celix_stringHashMap_create();
 
 	(*manager)->closed = false;
 
@@ -118,8 +156,22 @@ celix_status_t topologyManager_destroy(topology_manager_pt manager) {
 
 	celixThreadMutex_lock(&manager->lock);
 
-	hashMap_destroy(manager->importedServices, false, false);
-	hashMap_destroy(manager->exportedServices, false, false);
+	CELIX_STRING_HASH_MAP_ITERATE(manager->importedServices, iter) {
+		topologyManager_destroyImportedService(iter.value.ptrValue);
+	}
+	celix_stringHashMap_destroy(manager->importedServices);
+	CELIX_STRING_HASH_MAP_ITERATE(manager->importedServicesByName, iter) {
+		celix_arrayList_destroy(iter.value.ptrValue);
+	}
+	celix_stringHashMap_destroy(manager->importedServicesByName);
+	CELIX_LONG_HASH_MAP_ITERATE(manager->exportedServices, iter) {
+		topologyManager_destroyExportedService(iter.value.ptrValue);
+	}
+	celix_longHashMap_destroy(manager->exportedServices);
+	CELIX_STRING_HASH_MAP_ITERATE(manager->exportedServicesByName, iter) {
+		celix_arrayList_destroy(iter.value.ptrValue);
+	}
+	celix_stringHashMap_destroy(manager->exportedServicesByName);
 	hashMap_destroy(manager->listenerList, false, false);
 	celix_arrayList_destroy(manager->rsaList);
 
@@ -131,43 +183,190 @@ celix_status_t topologyManager_destroy(topology_manager_pt manager) {
 	return status;
 }
 
-celix_status_t topologyManager_closeImports(topology_manager_pt manager) {
-	celix_status_t status;
+static void topologyManager_destroyExportedService(topology_manager_exported_service_t *exportedService) {
+	hash_map_iterator_pt iter = hashMapIterator_create(exportedService->exports);
+	while (hashMapIterator_hasNext(iter)) {
+		celix_array_list_t *exportRegistrations = hashMapIterator_nextValue(iter);
+		celix_arrayList_destroy(exportRegistrations);
+	}
+	hashMapIterator_destroy(iter);
+	hashMap_destroy(exportedService->exports, false, false);
+	free(exportedService->scopeFilter);
+	free(exportedService->serviceName);
+	free(exportedService);
+}
 
-	status = celixThreadMutex_lock(&manager->lock);
+static void topologyManager_destroyImportedService(topology_manager_imported_service_t *importedService) {
+	hashMap_destroy(importedService->imports, false, false);
+	free(importedService->serviceName);
+	free(importedService);
+}
 
-	manager->closed = true;
+static celix_status_t topologyManager_addToIndex(celix_string_hash_map_t *index, const char *serviceName, void *entry) {
+	celix_array_list_t *entries = celix_stringHashMap_get(index, serviceName);
+	if (entries == NULL) {
+		entries = celix_arrayList_create();
+		if (entries == NULL) {
+			return CELIX_ENOMEM;
+		}
+		celix_stringHashMap_put(index, serviceName, entries);
+	}
+	return celix_arrayList_add(entries, entry);
+}
 
-	hash_map_iterator_pt iter = hashMapIterator_create(manager->importedServices);
+static void topologyManager_removeFromIndex(celix_string_hash_map_t *index, const char *serviceName, void *entry) {
+	celix_array_list_t *entries = celix_stringHashMap_get(index, serviceName);
+	if (entries != NULL) {
+		celix_arrayList_remove(entries, entry);
+		if (celix_arrayList_size(entries) == 0) {
+			celix_stringHashMap_remove(index, serviceName);
+			celix_arrayList_destroy(entries);
+		}
+	}
+}
 
-	while (hashMapIterator_hasNext(iter)) {
-		hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
-		endpoint_description_t *ep = hashMapEntry_getKey(entry);
-		hash_map_pt imports = hashMapEntry_getValue(entry);
+/**
+ * Returns whether the (scope) filter can match a service with the service name in serviceNameProps,
+ * i.e. returns false only if the filter restricts the service name (objectClass) to another service name.
+ */
+static bool topologyManager_filterCanMatchServiceName(const celix_filter_t *filter, const celix_properties_t *serviceNameProps) {
+	int size = filter->children == NULL ? 0 : celix_arrayList_size(filter->children);
+	switch (filter->operand) {
+	case CELIX_FILTER_OPERAND_AND:
+		for (int i = 0; i < size; i++) {
+			if (!topologyManager_filterCanMatchServiceName(celix_arrayList_get(filter->children, i), serviceNameProps)) {
+				return false;
+			}
+		}
+		return true;
+	case CELIX_FILTER_OPERAND_OR:
+		for (int i = 0; i < size; i++) {
+			if (topologyManager_filterCanMatchServiceName(celix_arrayList_get(filter->children, i), serviceNameProps)) {
+				return true;
+			}
+		}
+		return size == 0;
+	case CELIX_FILTER_OPERAND_NOT:
+		return true;
+	default:
+		if (filter->attribute != NULL && strcmp(filter->attribute, CELIX_FRAMEWORK_SERVICE_NAME) == 0) {
+			return celix_filter_match(filter, serviceNameProps);
+		}
+		return true;
+	}
+}
 
-		if (imports != NULL) {
-			celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_INFO, "TOPOLOGY_MANAGER: Remove imported service (%s; %s).", ep->serviceName, ep->id);
-			hash_map_iterator_pt importsIter = hashMapIterator_create(imports);
+static celix_status_t topologyManager_importServiceWithRsa_nolock(topology_manager_pt manager CELIX_UNUSED, topology_manager_imported_service_t *importedService, remote_service_admin_service_t *rsa) {
+	import_registration_t *import = NULL;
+	celix_status_t status = rsa->importService(rsa->admin, importedService->endpoint, &import);
+	if (status == CELIX_SUCCESS) {
+		hashMap_put(importedService->imports, rsa, import);
+	}
+	return status;
+}
 
-			while (hashMapIterator_hasNext(importsIter)) {
-				hash_map_entry_pt entry = hashMapIterator_nextEntry(importsIter);
+static celix_status_t topologyManager_importService_nolock(topology_manager_pt manager, topology_manager_imported_service_t *importedService) {
+	celix_status_t status = CELIX_SUCCESS;
+	int size = celix_arrayList_size(manager->rsaList);
+	for (int iter = 0; iter < size; iter++) {
+		remote_service_admin_service_t *rsa = celix_arrayList_get(manager->rsaList, iter);
+		celix_status_t substatus = topologyManager_importServiceWithRsa_nolock(manager, importedService, rsa);
+		if (substatus != CELIX_SUCCESS) {
+			status = substatus;
+		}
+	}
+	return status;
+}
 
-				remote_service_admin_service_t *rsa = hashMapEntry_getKey(entry);
-				import_registration_t *import = hashMapEntry_getValue(entry);
+static celix_status_t topologyManager_closeImports_nolock(topology_manager_pt manager CELIX_UNUSED, topology_manager_imported_service_t *importedService) {
+	celix_status_t status = CELIX_SUCCESS;
+	hash_map_iterator_pt importsIter = hashMapIterator_create(importedService->imports);
+	while (hashMapIterator_hasNext(importsIter)) {
+		hash_map_entry_pt entry = hashMapIterator_nextEntry(importsIter);
+		remote_service_admin_service_t *rsa = hashMapEntry_getKey(entry);
+		import_registration_t *import = hashMapEntry_getValue(entry);
+		celix_status_t substatus = rsa->importRegistration_close(rsa->admin, import);
+		if (substatus == CELIX_SUCCESS) {
+			hashMapIterator_remove(importsIter);
+		} else {
+			status = substatus;
+		}
+	}
+	hashMapIterator_destroy(importsIter);
+	return status;
+}
 
-				status = rsa->importRegistration_close(rsa->admin, import);
-				if (status == CELIX_SUCCESS) {
-					hashMapIterator_remove(importsIter);
-				}
-			}
-			hashMapIterator_destroy(importsIter);
+static celix_status_t topologyManager_exportServiceWithRsa_nolock(topology_manager_pt manager, topology_manager_exported_service_t *exportedService, remote_service_admin_service_t *rsa) {
+	char serviceIdStr[64];
+	snprintf(serviceIdStr, 64, "%li", exportedService->serviceId);
 
-			hashMapIterator_remove(iter);
+	celix_array_list_t *endpoints = NULL;
+	celix_status_t status = rsa->exportService(rsa->admin, serviceIdStr, exportedService->scopeProperties, &endpoints);
+	if (status == CELIX_SUCCESS) {
+		hashMap_put(exportedService->exports, rsa, endpoints);
+		topologyManager_notifyListenersEndpointAdded(manager, rsa, endpoints);
+	}
+	return status;
+}
 
-			hashMap_destroy(imports, false, false);
+static celix_status_t topologyManager_exportService_nolock(topology_manager_pt manager, topology_manager_exported_service_t *exportedService) {
+	celix_status_t status = CELIX_SUCCESS;
+	int size = celix_arrayList_size(manager->rsaList);
+
+	if (size == 0) {
+		celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_WARNING, "TOPOLOGY_MANAGER: No RSA available yet.");
+	}
+
+	for (int iter = 0; iter < size; iter++) {
+		remote_service_admin_service_t *rsa = celix_arrayList_get(manager->rsaList, iter);
+		celix_status_t substatus = topologyManager_exportServiceWithRsa_nolock(manager, exportedService, rsa);
+		if (substatus != CELIX_SUCCESS) {
+			status = substatus;
 		}
 	}
-	hashMapIterator_destroy(iter);
+	return status;
+}
+
+static void topologyManager_closeExportsWithRsa_nolock(topology_manager_pt manager, topology_manager_exported_service_t *exportedService, remote_service_admin_service_t *rsa) {
+	celix_array_list_t *exportRegistrations = hashMap_remove(exportedService->exports, rsa);
+	if (exportRegistrations != NULL) {
+		int size = celix_arrayList_size(exportRegistrations);
+		for (int exportsIter = 0; exportsIter < size; exportsIter++) {
+			export_registration_t *export = celix_arrayList_get(exportRegistrations, exportsIter);
+			topologyManager_notifyListenersEndpointRemoved(manager, rsa, export);
+			rsa->exportRegistration_close(rsa->admin, export);
+		}
+		celix_arrayList_destroy(exportRegistrations);
+	}
+}
+
+static void topologyManager_closeExports_nolock(topology_manager_pt manager, topology_manager_exported_service_t *exportedService) {
+	int size = celix_arrayList_size(manager->rsaList);
+	for (int iter = 0; iter < size; iter++) {
+		remote_service_admin_service_t *rsa = celix_arrayList_get(manager->rsaList, iter);
+		topologyManager_closeExportsWithRsa_nolock(manager, exportedService, rsa);
+	}
+}
+
+celix_status_t topologyManager_closeImports(topology_manager_pt manager) {
+	celix_status_t status;
+
+	status = celixThreadMutex_lock(&manager->lock);
+
+	manager->closed = true;
+
+	CELIX_STRING_HASH_MAP_ITERATE(manager->importedServices, iter) {
+		topology_manager_imported_service_t *importedService = iter.value.ptrValue;
+		endpoint_description_t *ep = importedService->endpoint;
+		celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_INFO, "TOPOLOGY_MANAGER: Remove imported service (%s; %s).", ep->serviceName, ep->id);
+		status = topologyManager_closeImports_nolock(manager, importedService);
+		topologyManager_destroyImportedService(importedService);
+	}
+	celix_stringHashMap_clear(manager->importedServices);
+	CELIX_STRING_HASH_MAP_ITERATE(manager->importedServicesByName, iter) {
+		celix_arrayList_destroy(iter.value.ptrValue);
+	}
+	celix_stringHashMap_clear(manager->importedServicesByName);
 
 	status = celixThreadMutex_unlock(&manager->lock);
 
@@ -185,7 +384,6 @@ celix_status_t topologyManager_rsaAdding(void * handle, service_reference_pt ref
 
 celix_status_t topologyManager_rsaAdded(void * handle, service_reference_pt unusedRef CELIX_UNUSED, void * service) {
 	topology_manager_pt manager = (topology_manager_pt) handle;
-	celix_properties_t *serviceProperties = NULL;
 	remote_service_admin_service_t *rsa = (remote_service_admin_service_t *) service;
 	celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_INFO, "TOPOLOGY_MANAGER: Added RSA");
 
@@ -194,55 +392,19 @@ celix_status_t topologyManager_rsaAdded(void * handle, service_reference_pt unus
 
     celix_arrayList_add(manager->rsaList, rsa);
 
-    // add already imported services to new rsa
-    hash_map_iterator_pt importedServicesIterator = hashMapIterator_create(manager->importedServices);
-
-    while (hashMapIterator_hasNext(importedServicesIterator)) {
-        hash_map_entry_pt entry = hashMapIterator_nextEntry(importedServicesIterator);
-        endpoint_description_t *endpoint = hashMapEntry_getKey(entry);
-        if (scope_allowImport(manager->scope, endpoint)) {
-            import_registration_t *import = NULL;
-            celix_status_t status = rsa->importService(rsa->admin, endpoint, &import);
-
-            if (status == CELIX_SUCCESS) {
-                hash_map_pt imports = hashMapEntry_getValue(entry);
-
-                if (imports == NULL) {
-                    imports = hashMap_create(NULL, NULL, NULL, NULL);
-                    hashMap_put(manager->importedServices, endpoint, imports);
-                }
-
-                hashMap_put(imports, service, import);
-            }
+    // add already imported services, which are allowed by the import scope, to new rsa
+    CELIX_STRING_HASH_MAP_ITERATE(manager->importedServices, iter) {
+        topology_manager_imported_service_t *importedService = iter.value.ptrValue;
+        if (importedService->allowed) {
+            topologyManager_importServiceWithRsa_nolock(manager, importedService, rsa);
         }
     }
 
-    hashMapIterator_destroy(importedServicesIterator);
-
-	// add already exported services to new rsa
-    hash_map_iterator_pt exportedServicesIterator = hashMapIterator_create(manager->exportedServices);
-
-    while (hashMapIterator_hasNext(exportedServicesIterator)) {
-        hash_map_entry_pt entry = hashMapIterator_nextEntry(exportedServicesIterator);
-        service_reference_pt reference = hashMapEntry_getKey(entry);
-        const char* serviceId = NULL;
-
-        serviceReference_getProperty(reference, CELIX_FRAMEWORK_SERVICE_ID, &serviceId);
-
-        scope_getExportProperties(manager->scope, reference, &serviceProperties);
-
-        celix_array_list_t *endpoints = NULL;
-        celix_status_t status = rsa->exportService(rsa->admin, (char*)serviceId, serviceProperties, &endpoints);
-
-        if (status == CELIX_SUCCESS) {
-            hash_map_pt exports = hashMapEntry_getValue(entry);
-            assert(exports != NULL);// It must not be NULL, It has been created in function topologyManager_addExportedService_nolock
-            hashMap_put(exports, rsa, endpoints);
-            topologyManager_notifyListenersEndpointAdded(manager, rsa, endpoints);
-        }
+	// add already exported services to new rsa, the export scope properties are already resolved
+    CELIX_LONG_HASH_MAP_ITERATE(manager->exportedServices, iter) {
+        topologyManager_exportServiceWithRsa_nolock(manager, iter.value.ptrValue, rsa);
     }
 
-    hashMapIterator_destroy(exportedServicesIterator);
     celixThreadMutex_unlock(&manager->lock);
 
 	return CELIX_SUCCESS;
@@ -263,34 +425,13 @@ celix_status_t topologyManager_rsaRemoved(void * handle, service_reference_pt re
 
 	celixThreadMutex_lock(&manager->lock);
 
-	hash_map_iterator_pt exportedSvcIter = hashMapIterator_create(manager->exportedServices);
-
-	while (hashMapIterator_hasNext(exportedSvcIter)) {
-
-		hash_map_entry_pt entry = hashMapIterator_nextEntry(exportedSvcIter);
-		hash_map_pt exports = hashMapEntry_getValue(entry);
-
-		celix_array_list_t *exports_list = (celix_array_list_t *)hashMap_remove(exports, rsa);
-		if (exports_list != NULL) {
-			int exportsIter = 0;
-			int exportListSize = celix_arrayList_size(exports_list);
-			for (exportsIter = 0; exports_list != NULL && exportsIter < exportListSize; exportsIter++) {
-				export_registration_t *export = celix_arrayList_get(exports_list, exportsIter);
-				topologyManager_notifyListenersEndpointRemoved(manager, rsa, export);
-				rsa->exportRegistration_close(rsa->admin, export);
-			}
-			celix_arrayList_destroy(exports_list);
-		}
+	CELIX_LONG_HASH_MAP_ITERATE(manager->exportedServices, iter) {
+		topologyManager_closeExportsWithRsa_nolock(manager, iter.value.ptrValue, rsa);
 	}
-	hashMapIterator_destroy(exportedSvcIter);
-
-	hash_map_iterator_pt importedSvcIter = hashMapIterator_create(manager->importedServices);
-
-	while (hashMapIterator_hasNext(importedSvcIter)) {
-		hash_map_entry_pt entry = hashMapIterator_nextEntry(importedSvcIter);
-		hash_map_pt imports = hashMapEntry_getValue(entry);
 
-		import_registration_t *import = (import_registration_t *)hashMap_remove(imports, rsa);
+	CELIX_STRING_HASH_MAP_ITERATE(manager->importedServices, iter) {
+		topology_manager_imported_service_t *importedService = iter.value.ptrValue;
+		import_registration_t *import = (import_registration_t *)hashMap_remove(importedService->imports, rsa);
 
 		if (import != NULL) {
 			celix_status_t subStatus = rsa->importRegistration_close(rsa->admin, import);
@@ -299,7 +440,6 @@ celix_status_t topologyManager_rsaRemoved(void * handle, service_reference_pt re
 			}
 		}
 	}
-	hashMapIterator_destroy(importedSvcIter);
 
 	celix_arrayList_remove(manager->rsaList, rsa);
 
@@ -310,114 +450,119 @@ celix_status_t topologyManager_rsaRemoved(void * handle, service_reference_pt re
 	return status;
 }
 
+/**
+ * Re-resolves the export scope of an exported service and only re-exports the service if the matched export scope
+ * changed.
+ */
+static celix_status_t topologyManager_updateExportScope_nolock(topology_manager_pt manager, topology_manager_exported_service_t *exportedService) {
+	celix_properties_t *scopeProperties = NULL;
+	char *scopeFilter = NULL;
+	scope_getExportProperties(manager->scope, exportedService->reference, &scopeProperties, &scopeFilter);
+	if (celix_utils_stringEquals(scopeFilter, exportedService->scopeFilter)) {
+		free(scopeFilter);
+		return CELIX_SUCCESS;
+	}
+
+	celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG, "TOPOLOGY_MANAGER: Export scope of exported service (%li) changed.", exportedService->serviceId);
+	topologyManager_closeExports_nolock(manager, exportedService);
+	free(exportedService->scopeFilter);
+	exportedService->scopeFilter = scopeFilter;
+	exportedService->scopeProperties = scopeProperties;
+	return topologyManager_exportService_nolock(manager, exportedService);
+}
+
 celix_status_t topologyManager_exportScopeChanged(void *handle, char *filterStr) {
 	celix_status_t status = CELIX_SUCCESS;
 	topology_manager_pt manager = (topology_manager_pt) handle;
-	service_registration_t *reg = NULL;
-	const char* serviceId = NULL;
-	bool found;
-	celix_properties_t *props;
 	celix_autoptr(celix_filter_t) filter = celix_filter_create(filterStr);
 
 	if (filter == NULL) {
-		printf("filter creating failed\n");
+		celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_ERROR, "TOPOLOGY_MANAGER: Failed to create scope filter %s.", filterStr);
+		return CELIX_ENOMEM;
+	}
+	celix_autoptr(celix_properties_t) serviceNameProps = celix_properties_create();
+	if (serviceNameProps == NULL) {
 		return CELIX_ENOMEM;
 	}
 
-	// add already exported services to new rsa
 	celixThreadMutex_lock(&manager->lock);
 
-	hash_map_iterator_pt exportedServicesIterator = hashMapIterator_create(manager->exportedServices);
-	int size = hashMap_size(manager->exportedServices);
-	service_reference_pt *srvRefs = (service_reference_pt *) calloc(size, sizeof(service_reference_pt));
-	char **srvIds = (char **) calloc(size, sizeof(char*));
-	int nrFound = 0;
-
-	found = false;
-
-	while (hashMapIterator_hasNext(exportedServicesIterator)) {
-		hash_map_entry_pt entry = hashMapIterator_nextEntry(exportedServicesIterator);
-		service_reference_pt reference = hashMapEntry_getKey(entry);
-		reg = NULL;
-		serviceReference_getServiceRegistration(reference, &reg);
-		if (reg != NULL) {
-			props = NULL;
-			serviceRegistration_getProperties(reg, &props);
-			status = filter_match(filter, props, &found);
-			if (found) {
-				srvRefs[nrFound] = reference;
-				serviceReference_getProperty(reference, CELIX_FRAMEWORK_SERVICE_ID, &serviceId);
-				srvIds[nrFound++] = (char*)serviceId;
-			}
+	// only the exported services with a service name which can match the changed scope filter are affected
+	CELIX_STRING_HASH_MAP_ITERATE(manager->exportedServicesByName, iter) {
+		celix_properties_set(serviceNameProps, CELIX_FRAMEWORK_SERVICE_NAME, iter.key);
+		if (!topologyManager_filterCanMatchServiceName(filter, serviceNameProps)) {
+			continue;
 		}
-	}
-
-	hashMapIterator_destroy(exportedServicesIterator);
-
-	if (nrFound > 0) {
-		for (int i = 0; i < nrFound; i++) {
-			// Question: can srvRefs become invalid meanwhile??
-			const char* export = NULL;
-			serviceReference_getProperty(srvRefs[i], (char *) OSGI_RSA_SERVICE_EXPORTED_INTERFACES, &export);
-
-			if (export) {
-				celix_status_t substatus = topologyManager_removeExportedService_nolock(manager, srvRefs[i], srvIds[i]);
-
-				if (substatus != CELIX_SUCCESS) {
-					celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_ERROR, "TOPOLOGY_MANAGER: Removal of exported service (%s) failed.", srvIds[i]);
-				} else {
-					substatus = topologyManager_addExportedService_nolock(manager, srvRefs[i], srvIds[i]);
-				}
-
-				if (substatus != CELIX_SUCCESS) {
-					status = substatus;
-				}
+		celix_array_list_t *exportedServices = iter.value.ptrValue;
+		int size = celix_arrayList_size(exportedServices);
+		for (int i = 0; i < size; i++) {
+			topology_manager_exported_service_t *exportedService = celix_arrayList_get(exportedServices, i);
+			celix_status_t substatus = topologyManager_updateExportScope_nolock(manager, exportedService);
+			if (substatus != CELIX_SUCCESS) {
+				celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_ERROR, "TOPOLOGY_MANAGER: Re-export of exported service (%li) failed.", exportedService->serviceId);
+				status = substatus;
 			}
 		}
 	}
 
-	free(srvRefs);
-	free(srvIds);
-
-	// should unlock until here ?, avoid srvRefs[i] is released during topologyManager_removeExportedService
 	celixThreadMutex_unlock(&manager->lock);
 
 	return status;
 }
 
-celix_status_t topologyManager_importScopeChanged(void *handle, char *service_name) {
-	celix_status_t status = CELIX_SUCCESS;
-	endpoint_description_t *endpoint;
-	topology_manager_pt manager = (topology_manager_pt) handle;
-	bool found = false;
+/**
+ * Re-evaluates the import scope for an imported service and only imports or closes the imports if the outcome changed.
+ */
+static celix_status_t topologyManager_updateImportScope_nolock(topology_manager_pt manager, topology_manager_imported_service_t *importedService) {
+	bool allowed = scope_allowImport(manager->scope, importedService->endpoint);
+	if (allowed == importedService->allowed) {
+		return CELIX_SUCCESS;
+	}
 
-	// add already imported services to new rsa
-	celixThreadMutex_lock(&manager->lock);
+	endpoint_description_t *endpoint = importedService->endpoint;
+	celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG, "TOPOLOGY_MANAGER: Import scope of imported service (%s; %s) changed.", endpoint->serviceName, endpoint->id);
+	importedService->allowed = allowed;
+	return allowed ? topologyManager_importService_nolock(manager, importedService) : topologyManager_closeImports_nolock(manager, importedService);
+}
 
-	hash_map_iterator_pt importedServicesIterator = hashMapIterator_create(manager->importedServices);
-	while (!found && hashMapIterator_hasNext(importedServicesIterator)) {
-		hash_map_entry_pt entry = hashMapIterator_nextEntry(importedServicesIterator);
-		endpoint = hashMapEntry_getKey(entry);
+celix_status_t topologyManager_importScopeChanged(void *handle, char *filterStr) {
+	celix_status_t status = CELIX_SUCCESS;
+	topology_manager_pt manager = (topology_manager_pt) handle;
+	celix_autoptr(celix_filter_t) filter = celix_filter_create(filterStr);
 
-        const char* name = celix_properties_get(endpoint->properties, CELIX_FRAMEWORK_SERVICE_NAME, "");
-		// Test if a service with the same name is imported
-		if (strcmp(name, service_name) == 0) {
-			found = true;
-		}
+	if (filter == NULL) {
+		celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_ERROR, "TOPOLOGY_MANAGER: Failed to create scope filter %s.", filterStr);
+		return CELIX_ENOMEM;
+	}
+	celix_autoptr(celix_properties_t) serviceNameProps = celix_properties_create();
+	if (serviceNameProps == NULL) {
+		return CELIX_ENOMEM;
 	}
-	hashMapIterator_destroy(importedServicesIterator);
 
-	if (found) {
-		status = topologyManager_removeImportedService_nolock(manager, endpoint, NULL);
+	celixThreadMutex_lock(&manager->lock);
 
-		if (status != CELIX_SUCCESS) {
-			celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_ERROR, "TOPOLOGY_MANAGER: Removal of imported service (%s; %s) failed.", endpoint->serviceName, endpoint->id);
-		} else {
-			status = topologyManager_addImportedService_nolock(manager, endpoint, NULL);
+	// no import scopes means that all imports are allowed, so if the changed scope is the first or last import scope
+	// all imported services are affected. Otherwise only the imported services with a service name which can match
+	// the changed scope filter are affected.
+	bool allAffected = scope_getImportScopeCount(manager->scope) <= 1;
+	CELIX_STRING_HASH_MAP_ITERATE(manager->importedServicesByName, iter) {
+		celix_properties_set(serviceNameProps, CELIX_FRAMEWORK_SERVICE_NAME, iter.key);
+		if (!allAffected && !topologyManager_filterCanMatchServiceName(filter, serviceNameProps)) {
+			continue;
+		}
+		celix_array_list_t *importedServices = iter.value.ptrValue;
+		int size = celix_arrayList_size(importedServices);
+		for (int i = 0; i < size; i++) {
+			topology_manager_imported_service_t *importedService = celix_arrayList_get(importedServices, i);
+			celix_status_t substatus = topologyManager_updateImportScope_nolock(manager, importedService);
+			if (substatus != CELIX_SUCCESS) {
+				endpoint_description_t *endpoint = importedService->endpoint;
+				celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_ERROR, "TOPOLOGY_MANAGER: Update of imported service (%s; %s) failed.", endpoint->serviceName, endpoint->id);
+				status = substatus;
+			}
 		}
 	}
 
-	//should unlock until here ?, avoid endpoint is released during topologyManager_removeImportedService
 	celixThreadMutex_unlock(&manager->lock);
 
 	return status;
@@ -435,22 +580,37 @@ static celix_status_t topologyManager_addImportedService_nolock(void *handle, en
 		return CELIX_SUCCESS;
 	}
 
-	hash_map_pt imports = hashMap_create(NULL, NULL, NULL, NULL);
-	hashMap_put(manager->importedServices, endpoint, imports);
+	if (celix_stringHashMap_hasKey(manager->importedServices, endpoint->id)) {
+		// an updated endpoint (or the same endpoint from another discovery) replaces the current imported service
+		topologyManager_removeImportedService_nolock(manager, endpoint, matchedFilter);
+	}
 
-	if (scope_allowImport(manager->scope, endpoint)) {
-		int size = celix_arrayList_size(manager->rsaList);
+	topology_manager_imported_service_t *importedService = calloc(1, sizeof(*importedService));
+	if (importedService == NULL) {
+		return CELIX_ENOMEM;
+	}
+	importedService->endpoint = endpoint;
+	importedService->serviceName = celix_utils_strdup(celix_properties_get(endpoint->properties, CELIX_FRAMEWORK_SERVICE_NAME, ""));
+	importedService->imports = hashMap_create(NULL, NULL, NULL, NULL);
+	if (importedService->serviceName == NULL || importedService->imports == NULL) {
+		topologyManager_destroyImportedService(importedService);
+		return CELIX_ENOMEM;
+	}
+	status = celix_stringHashMap_put(manager->importedServices, endpoint->id, importedService);
+	if (status != CELIX_SUCCESS) {
+		topologyManager_destroyImportedService(importedService);
+		return status;
+	}
+	status = topologyManager_addToIndex(manager->importedServicesByName, importedService->serviceName, importedService);
+	if (status != CELIX_SUCCESS) {
+		celix_stringHashMap_remove(manager->importedServices, endpoint->id);
+		topologyManager_destroyImportedService(importedService);
+		return status;
+	}
 
-		for (int iter = 0; iter < size; iter++) {
-			import_registration_t *import = NULL;
-			remote_service_admin_service_t *rsa = celix_arrayList_get(manager->rsaList, iter);
-			celix_status_t substatus = rsa->importService(rsa->admin, endpoint, &import);
-			if (substatus == CELIX_SUCCESS) {
-				hashMap_put(imports, rsa, import);
-			} else {
-				status = substatus;
-			}
-		}
+	importedService->allowed = scope_allowImport(manager->scope, endpoint);
+	if (importedService->allowed) {
+		status = topologyManager_importService_nolock(manager, importedService);
 	}
 
 	return status;
@@ -477,33 +637,13 @@ static celix_status_t topologyManager_removeImportedService_nolock(void *handle,
 
 	celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG, "TOPOLOGY_MANAGER: Remove imported service (%s; %s).", endpoint->serviceName, endpoint->id);
 
-	hash_map_iterator_pt iter = hashMapIterator_create(manager->importedServices);
-	while (hashMapIterator_hasNext(iter)) {
-		hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
-		endpoint_description_t *ep = hashMapEntry_getKey(entry);
-		hash_map_pt imports = hashMapEntry_getValue(entry);
-
-		if (imports != NULL && strcmp(endpoint->id, ep->id) == 0) {
-			hash_map_iterator_pt importsIter = hashMapIterator_create(imports);
-
-			while (hashMapIterator_hasNext(importsIter)) {
-				hash_map_entry_pt entry = hashMapIterator_nextEntry(importsIter);
-				remote_service_admin_service_t *rsa = hashMapEntry_getKey(entry);
-				import_registration_t *import = hashMapEntry_getValue(entry);
-				celix_status_t substatus = rsa->importRegistration_close(rsa->admin, import);
-				if (substatus == CELIX_SUCCESS) {
-					hashMapIterator_remove(importsIter);
-				} else {
-					status = substatus;
-				}
-			}
-			hashMapIterator_destroy(importsIter);
-			hashMapIterator_remove(iter);
-
-			hashMap_destroy(imports, false, false);
-		}
+	topology_manager_imported_service_t *importedService = celix_stringHashMap_get(manager->importedServices, endpoint->id);
+	if (importedService != NULL) {
+		status = topologyManager_closeImports_nolock(manager, importedService);
+		topologyManager_removeFromIndex(manager->importedServicesByName, importedService->serviceName, importedService);
+		celix_stringHashMap_remove(manager->importedServices, endpoint->id);
+		topologyManager_destroyImportedService(importedService);
 	}
-	hashMapIterator_destroy(iter);
 
 	return status;
 }
@@ -527,9 +667,6 @@ static celix_status_t topologyManager_addExportedService_nolock(void * handle, s
     topology_manager_pt manager = handle;
 	celix_status_t status = CELIX_SUCCESS;
     long serviceId = serviceReference_getServiceId(reference);
-    char serviceIdStr[64];
-    snprintf(serviceIdStr, 64, "%li", serviceId);
-	celix_properties_t *serviceProperties = NULL;
 
 	const char *export = NULL;
     serviceReference_getProperty(reference, OSGI_RSA_SERVICE_EXPORTED_INTERFACES, &export);
@@ -537,33 +674,40 @@ static celix_status_t topologyManager_addExportedService_nolock(void * handle, s
 
 	celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG, "TOPOLOGY_MANAGER: Add exported service (%li).", serviceId);
 
-
-	scope_getExportProperties(manager->scope, reference, &serviceProperties);
-	hash_map_pt exports = hashMap_create(NULL, NULL, NULL, NULL);
-	assert(exports != NULL);
-	hashMap_put(manager->exportedServices, reference, exports);
-
-	int size = celix_arrayList_size(manager->rsaList);
-
-	if (size == 0) {
-		celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_WARNING, "TOPOLOGY_MANAGER: No RSA available yet.");
+	if (celix_longHashMap_hasKey(manager->exportedServices, serviceId)) {
+		topologyManager_removeExportedService_nolock(manager, reference, service);
 	}
 
-	for (int iter = 0; iter < size; iter++) {
-		remote_service_admin_service_t *rsa = celix_arrayList_get(manager->rsaList, iter);
-
-		celix_array_list_t *endpoints = NULL;
-		celix_status_t substatus = rsa->exportService(rsa->admin, serviceIdStr, serviceProperties, &endpoints);
+	const char *serviceName = NULL;
+	serviceReference_getProperty(reference, CELIX_FRAMEWORK_SERVICE_NAME, &serviceName);
 
-		if (substatus == CELIX_SUCCESS) {
-			hashMap_put(exports, rsa, endpoints);
-			topologyManager_notifyListenersEndpointAdded(manager, rsa, endpoints);
-		} else {
-			status = substatus;
-		}
+	topology_manager_exported_service_t *exportedService = calloc(1, sizeof(*exportedService));
+	if (exportedService == NULL) {
+		return CELIX_ENOMEM;
+	}
+	exportedService->reference = reference;
+	exportedService->serviceId = serviceId;
+	exportedService->serviceName = celix_utils_strdup(serviceName != NULL ? serviceName : "");
+	exportedService->exports = hashMap_create(NULL, NULL, NULL, NULL);
+	if (exportedService->serviceName == NULL || exportedService->exports == NULL) {
+		topologyManager_destroyExportedService(exportedService);
+		return CELIX_ENOMEM;
+	}
+	status = celix_longHashMap_put(manager->exportedServices, serviceId, exportedService);
+	if (status != CELIX_SUCCESS) {
+		topologyManager_destroyExportedService(exportedService);
+		return status;
+	}
+	status = topologyManager_addToIndex(manager->exportedServicesByName, exportedService->serviceName, exportedService);
+	if (status != CELIX_SUCCESS) {
+		celix_longHashMap_remove(manager->exportedServices, serviceId);
+		topologyManager_destroyExportedService(exportedService);
+		return status;
 	}
 
-	return status;
+	scope_getExportProperties(manager->scope, reference, &exportedService->scopeProperties, &exportedService->scopeFilter);
+
+	return topologyManager_exportService_nolock(manager, exportedService);
 }
 
 celix_status_t topologyManager_addExportedService(void * handle, service_reference_pt reference, void * service) {
@@ -588,33 +732,12 @@ static celix_status_t topologyManager_removeExportedService_nolock(void * handle
 
 	celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG, "TOPOLOGY_MANAGER: Remove exported service (%li).", serviceId);
 
-	hash_map_pt exports = hashMap_get(manager->exportedServices, reference);
-	if (exports) {
-		hash_map_iterator_pt iter = hashMapIterator_create(exports);
-		while (hashMapIterator_hasNext(iter)) {
-			hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
-			remote_service_admin_service_t *rsa = hashMapEntry_getKey(entry);
-			celix_array_list_t *exportRegistrations = hashMap_remove(exports, rsa);
-			if (exportRegistrations != NULL) {
-				int size = celix_arrayList_size(exportRegistrations);
-				for (int exportsIter = 0; exportsIter < size; exportsIter++) {
-					export_registration_t *export = celix_arrayList_get(exportRegistrations, exportsIter);
-					topologyManager_notifyListenersEndpointRemoved(manager, rsa, export);
-					rsa->exportRegistration_close(rsa->admin, export);
-				}
-				celix_arrayList_destroy(exportRegistrations);
-			}
-
-			hashMapIterator_destroy(iter);
-			iter = hashMapIterator_create(exports);
-
-		}
-		hashMapIterator_destroy(iter);
-	}
-	exports = hashMap_remove(manager->exportedServices, reference);
-
-	if (exports != NULL) {
-		hashMap_destroy(exports, false, false);
+	topology_manager_exported_service_t *exportedService = celix_longHashMap_get(manager->exportedServices, serviceId);
+	if (exportedService != NULL) {
+		topologyManager_closeExports_nolock(manager, exportedService);
+		topologyManager_removeFromIndex(manager->exportedServicesByName, exportedService->serviceName, exportedService);
+		celix_longHashMap_remove(manager->exportedServices, serviceId);
+		topologyManager_destroyExportedService(exportedService);
 	}
 
 	return status;
@@ -681,11 +804,9 @@ celix_status_t topologyManager_endpointListenerAdded(void* handle, service_refer
 
 	celix_autoptr(celix_filter_t) filter = celix_filter_create(scope);
 
-	hash_map_iterator_pt refIter = hashMapIterator_create(manager->exportedServices);
-
-	while (hashMapIterator_hasNext(refIter)) {
-		hash_map_pt rsaExports = hashMapIterator_nextValue(refIter);
-		hash_map_iterator_pt rsaIter = hashMapIterator_create(rsaExports);
+	CELIX_LONG_HASH_MAP_ITERATE(manager->exportedServices, refIter) {
+		topology_manager_exported_service_t *exportedService = refIter.value.ptrValue;
+		hash_map_iterator_pt rsaIter = hashMapIterator_create(exportedService->exports);
 
 		while (hashMapIterator_hasNext(rsaIter)) {
 			hash_map_entry_pt entry = hashMapIterator_nextEntry(rsaIter);
@@ -712,7 +833,6 @@ celix_status_t topologyManager_endpointListenerAdded(void* handle, service_refer
 		}
 		hashMapIterator_destroy(rsaIter);
 	}
-	hashMapIterator_destroy(refIter);
 
 	celixThreadMutex_unlock(&manager->lock);
 
@@ -663,6 +663,139 @@ extern "C" {
 
         printf("End: %s\n", __func__);
     }
+
+    static char* getExportedEndpointId(void) {
+        array_list_pt epList = NULL;
+        discMock->getEPDescriptors(discMock->handle, &epList);
+        EXPECT_EQ(1, arrayList_size(epList));
+        if (arrayList_size(epList) != 1) {
+            return NULL;
+        }
+        endpoint_description_t *ep = (endpoint_description_t *) arrayList_get(epList, 0);
+        return strdup(ep->id);
+    }
+
+    static const char* getExportedEndpointProperty(const char* key) {
+        array_list_pt epList = NULL;
+        discMock->getEPDescriptors(discMock->handle, &epList);
+        if (arrayList_size(epList) != 1) {
+            return NULL;
+        }
+        endpoint_description_t *ep = (endpoint_description_t *) arrayList_get(epList, 0);
+        return celix_properties_get(ep->properties, key, NULL);
+    }
+
+    /// \TEST_CASE_ID{10}
+    /// \TEST_CASE_TITLE{Test export scope change}
+    /// \TEST_CASE_REQ{REQ-2}
+    /// \TEST_CASE_DESC Checks if an export scope change only re-exports the services whose matched export scope changed
+    static void testExportScopeChange(void) {
+        printf("\nBegin: %s\n", __func__);
+
+        //Given an exported calculator without export scope
+        char *initialId = getExportedEndpointId();
+        ASSERT_TRUE(initialId != NULL);
+        EXPECT_TRUE(getExportedEndpointProperty("key2") == NULL);
+
+        //When an export scope for another service is added, then the calculator is not re-exported
+        celix_properties_t *props = celix_properties_create();
+        celix_properties_set(props, "key2", "other");
+        int rc = tmScopeService->addExportScope(tmScopeService->handle, (char*)"(objectClass=org.example.Other)", props);
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        char *id = getExportedEndpointId();
+        EXPECT_STREQ(initialId, id);
+        free(id);
+
+        //When an export scope for the calculator is added, then the calculator is re-exported with the scope properties
+        props = celix_properties_create();
+        celix_properties_set(props, "key2", "inaetics");
+        rc = tmScopeService->addExportScope(tmScopeService->handle, (char*)"(objectClass=org.apache.celix.calc.*)", props);
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        char *scopedId = getExportedEndpointId();
+        EXPECT_STRNE(initialId, scopedId);
+        EXPECT_STREQ("inaetics", getExportedEndpointProperty("key2"));
+
+        //When the export scope for the other service is removed, then the calculator is not re-exported
+        rc = tmScopeService->removeExportScope(tmScopeService->handle, (char*)"(objectClass=org.example.Other)");
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        id = getExportedEndpointId();
+        EXPECT_STREQ(scopedId, id);
+        free(id);
+
+        //When the export scope for the calculator is removed, then the calculator is re-exported without scope properties
+        rc = tmScopeService->removeExportScope(tmScopeService->handle, (char*)"(objectClass=org.apache.celix.calc.*)");
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        id = getExportedEndpointId();
+        EXPECT_STRNE(scopedId, id);
+        EXPECT_TRUE(getExportedEndpointProperty("key2") == NULL);
+        free(id);
+
+        free(scopedId);
+        free(initialId);
+        printf("End: %s\n", __func__);
+    }
+
+    static bool waitForImported(bool expected) {
+        bool imported;
+        int iteration = 0;
+        do {
+            imported = testImport->IsImported(testImport);
+            usleep(1000);
+        } while (imported != expected && iteration++ < 1000);
+        return imported;
+    }
+
+    /// \TEST_CASE_ID{11}
+    /// \TEST_CASE_TITLE{Test first and last import scope}
+    /// \TEST_CASE_REQ{REQ-3}
+    /// \TEST_CASE_DESC Checks if adding the first or removing the last import scope re-evaluates all imports, also
+    /// the imports with a service name which cannot match the import scope
+    static void testFirstAndLastImportScope(void) {
+        printf("\nBegin: %s\n", __func__);
+        int rc = 0;
+
+        //Given an imported endpoint without import scopes
+        endpoint_description_t *endpoint = NULL;
+        celix_properties_t *props = celix_properties_create();
+        celix_properties_set(props, OSGI_RSA_ENDPOINT_SERVICE_ID, "42");
+        celix_properties_set(props, OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, "eec5404d-51d0-47ef-8d86-c825a8beda42");
+        celix_properties_set(props, OSGI_RSA_ENDPOINT_ID, "eec5404d-51d0-47ef-8d86-c825a8beda42-42");
+        celix_properties_set(props, OSGI_RSA_SERVICE_IMPORTED_CONFIGS, TST_CONFIGURATION_TYPE);
+        celix_properties_set(props, CELIX_FRAMEWORK_SERVICE_NAME, "org.apache.celix.test.MyBundle");
+        celix_properties_set(props, "service.version", "1.0.0");
+        celix_properties_set(props, "zone", "a_zone");
+
+        rc = endpointDescription_create(props, &endpoint);
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+
+        rc = eplService->endpointAdded(eplService->handle, endpoint, NULL);
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        celix_framework_waitForEmptyEventQueue(framework);
+        EXPECT_TRUE(waitForImported(true));
+
+        //When a first import scope for another service is added, then the import is closed, because only the
+        //services matching an import scope are allowed
+        rc = tmScopeService->addImportScope(tmScopeService->handle, (char*)"(objectClass=org.example.Other)");
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        celix_framework_waitForEmptyEventQueue(framework);
+        EXPECT_FALSE(waitForImported(false));
+
+        //When the last import scope is removed, then the endpoint is imported again
+        rc = tmScopeService->removeImportScope(tmScopeService->handle, (char*)"(objectClass=org.example.Other)");
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        celix_framework_waitForEmptyEventQueue(framework);
+        EXPECT_TRUE(waitForImported(true));
+
+        rc = eplService->endpointRemoved(eplService->handle, endpoint, NULL);
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+
+        celix_framework_waitForEmptyEventQueue(framework);
+
+        rc = endpointDescription_destroy(endpoint);
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+
+        printf("End: %s\n", __func__);
+    }
 }
 
 class RemoteServiceTopologyAdminExportTestSuite : public ::testing::Test {
@@ -687,6 +820,10 @@ public:
 
 };
 
+TEST_F(RemoteServiceTopologyAdminImportTestSuite, scope_import_first_and_last) {
+    testFirstAndLastImportScope();
+}
+
 TEST_F(RemoteServiceTopologyAdminImportTestSuite, scope_import_multiple) {
     testImportScopeMultiple();
 }
@@ -703,6 +840,10 @@ TEST_F(RemoteServiceTopologyAdminImportTestSuite, scope_import) {
     testImportScope();
 }
 
+TEST_F(RemoteServiceTopologyAdminExportTestSuite, scope_export_change) {
+    testExportScopeChange();
+}
+
 TEST_F(RemoteServiceTopologyAdminExportTestSuite, scope_init3) {
     testScope3();
 }
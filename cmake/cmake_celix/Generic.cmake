@@ -305,3 +305,77 @@ function(celix_target_hide_symbols)
                 VISIBILITY_INLINES_HIDDEN ON)
     endif ()
 endfunction()
+
+#[[
+Generates JSON-RPC endpoint and proxy stubs for a remote service interface descriptor and adds them to a CMake target.
+
+```CMake
+celix_target_json_rpc_stubs(<cmake_target>
+    DESCRIPTOR <descriptor_file>
+    [PREFIX <prefix>]
+)
+```
+
+Example:
+```CMake
+celix_target_json_rpc_stubs(calculator
+    DESCRIPTOR ${CMAKE_CURRENT_SOURCE_DIR}/org.apache.celix.calc.api.Calculator.descriptor
+    PREFIX calculator
+)
+# results in the generated header `calculator_json_rpc_stub.h`, which declares the stub definition
+# `calculator_jsonRpcStubDefinition`, to be added to the `calculator` target.
+```
+
+The stubs call the service methods and (de)serialize the arguments directly, so that the JSON-RPC remote service admin
+does not need to use libffi for the remote service interface. To be used by the JSON-RPC remote service admin, the
+bundle should register the stubs with `rsaJsonRpcStub_register` and unregister them with `rsaJsonRpcStub_unregister`
+when the bundle is stopped. The stubs are tracked: endpoints switch between the stubs and libffi when the stubs come
+and go, proxies use the stubs registered by the requesting bundle when the proxy is created. See the calculator remote
+services example.
+
+The stubs are generated with the `Celix::rsa_json_rpc_stubgen` tool, which fails for descriptors with methods which
+are not supported by the stubs (e.g. by value complex arguments). Remote services without stubs use libffi.
+
+Mandatory Arguments:
+- DESCRIPTOR: The remote service interface descriptor file.
+
+Optional Arguments:
+- PREFIX: The prefix of the generated files and symbols. Must be a valid C identifier. Default is the descriptor
+  filename without extension as C identifier.
+]]
+function(celix_target_json_rpc_stubs)
+    list(GET ARGN 0 TARGET_NAME)
+    list(REMOVE_AT ARGN 0)
+
+    set(OPTIONS)
+    set(ONE_VAL_ARGS DESCRIPTOR PREFIX)
+    set(MULTI_VAL_ARGS)
+    cmake_parse_arguments(JSON_RPC_STUBS "${OPTIONS}" "${ONE_VAL_ARGS}" "${MULTI_VAL_ARGS}" ${ARGN})
+
+    if (NOT JSON_RPC_STUBS_DESCRIPTOR)
+        message(FATAL_ERROR "Missing required DESCRIPTOR argument")
+    endif ()
+    if (NOT TARGET Celix::rsa_json_rpc_stubgen)
+        message(FATAL_ERROR "Cannot generate JSON-RPC stubs for target ${TARGET_NAME}, Celix::rsa_json_rpc_stubgen is not available.")
+    endif ()
+
+    get_filename_component(DESCRIPTOR_FILE ${JSON_RPC_STUBS_DESCRIPTOR} ABSOLUTE)
+    if (NOT JSON_RPC_STUBS_PREFIX)
+        get_filename_component(RAW_NAME ${DESCRIPTOR_FILE} NAME_WLE)
+        string(MAKE_C_IDENTIFIER ${RAW_NAME} JSON_RPC_STUBS_PREFIX)
+    endif ()
+
+    set(STUBS_DIR ${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}_json_rpc_stubs)
+    set(STUBS_SOURCE ${STUBS_DIR}/${JSON_RPC_STUBS_PREFIX}_json_rpc_stub.c)
+    set(STUBS_HEADER ${STUBS_DIR}/${JSON_RPC_STUBS_PREFIX}_json_rpc_stub.h)
+    add_custom_command(OUTPUT ${STUBS_SOURCE} ${STUBS_HEADER}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${STUBS_DIR}
+            COMMAND Celix::rsa_json_rpc_stubgen ${DESCRIPTOR_FILE} ${STUBS_DIR} ${JSON_RPC_STUBS_PREFIX}
+            DEPENDS $<TARGET_FILE:Celix::rsa_json_rpc_stubgen> ${DESCRIPTOR_FILE}
+            COMMENT "Generating JSON-RPC stubs for ${DESCRIPTOR_FILE}"
+            VERBATIM
+    )
+    target_sources(${TARGET_NAME} PRIVATE ${STUBS_SOURCE})
+    target_include_directories(${TARGET_NAME} PRIVATE ${STUBS_DIR})
+    target_link_libraries(${TARGET_NAME} PRIVATE Celix::rsa_json_rpc_stub)
+endfunction()
@@ -88,6 +88,7 @@ class CelixConan(ConanFile):
         "framework_curlinit": True,
         "enable_ccache": False,
         "enable_deprecated_warnings": False,
+        "celix_utils_string_interning": False,
     }
     options = {
         "celix_err_buffer_size": ["ANY"],
@@ -0,0 +1,227 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include "dyn_type.h"
+#include "json_serializer.h"
+
+namespace {
+    /**
+     * Creates a complex type descriptor with nrOfMembers nested structs, each with 8 int members and a text member.
+     */
+    std::string createNestedStructDescriptor(int64_t nrOfMembers) {
+        std::string types;
+        std::string names;
+        for (int64_t i = 0; i < nrOfMembers; ++i) {
+            types += "{IIIIIIIIt a b c d e f g h name}";
+            names += " m" + std::to_string(i);
+        }
+        return "{" + types + names + "}";
+    }
+
+    /**
+     * Creates a complex type descriptor with nrOfMembers nested structs, each with 8 int members (trivial type).
+     */
+    std::string createNestedTrivialStructDescriptor(int64_t nrOfMembers) {
+        std::string types;
+        std::string names;
+        for (int64_t i = 0; i < nrOfMembers; ++i) {
+            types += "{IIIIIIII a b c d e f g h}";
+            names += " m" + std::to_string(i);
+        }
+        return "{" + types + names + "}";
+    }
+
+    dyn_type* parseType(benchmark::State& state, const std::string& descriptor) {
+        dyn_type* type = nullptr;
+        if (dynType_parseWithStr(descriptor.c_str(), nullptr, nullptr, &type) != 0) {
+            state.SkipWithError("Cannot parse dyn type descriptor");
+        }
+        return type;
+    }
+
+    /**
+     * Creates an instance for a nested struct descriptor and - if the nested structs have a text member - sets the
+     * text members.
+     */
+    void* createNestedStruct(dyn_type* type, bool withText) {
+        void* inst = nullptr;
+        dynType_alloc(type, &inst);
+        for (size_t i = 0; withText && i < dynType_complex_nrOfEntries(type); ++i) {
+            void* nestedLoc = nullptr;
+            dyn_type* nestedType = nullptr;
+            dynType_complex_valLocAt(type, (int)i, inst, &nestedLoc);
+            dynType_complex_dynTypeAt(type, (int)i, &nestedType);
+            void* textLoc = nullptr;
+            dyn_type* textType = nullptr;
+            dynType_complex_valLocAt(nestedType, 8, nestedLoc, &textLoc);
+            dynType_complex_dynTypeAt(nestedType, 8, &textType);
+            dynType_text_allocAndInit(textType, textLoc, "name");
+        }
+        return inst;
+    }
+
+    void* createDoubleSequence(dyn_type* type, int64_t nrOfItems) {
+        void* inst = nullptr;
+        dynType_alloc(type, &inst);
+        dynType_sequence_alloc(type, inst, (uint32_t)nrOfItems);
+        for (int64_t i = 0; i < nrOfItems; ++i) {
+            void* loc = nullptr;
+            dynType_sequence_increaseLengthAndReturnLastLoc(type, inst, &loc);
+            *static_cast<double*>(loc) = (double)i;
+        }
+        return inst;
+    }
+}
+
+static void DynType_allocAndFreeNestedStruct(benchmark::State& state, bool trivial) {
+    auto descriptor = trivial ? createNestedTrivialStructDescriptor(state.range(0)) : createNestedStructDescriptor(state.range(0));
+    dyn_type* type = parseType(state, descriptor);
+    if (type == nullptr) {
+        return;
+    }
+    for (auto _ : state) {
+        void* inst = createNestedStruct(type, !trivial);
+        dynType_free(type, inst);
+    }
+    state.SetItemsProcessed(state.iterations());
+    dynType_destroy(type);
+}
+
+static void DynType_allocAndFreeDoubleSequence(benchmark::State& state) {
+    dyn_type* type = parseType(state, "[D");
+    if (type == nullptr) {
+        return;
+    }
+    for (auto _ : state) {
+        void* inst = createDoubleSequence(type, state.range(0));
+        dynType_free(type, inst);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    dynType_destroy(type);
+}
+
+static void JsonSerializer_serializeNestedStruct(benchmark::State& state) {
+    dyn_type* type = parseType(state, createNestedStructDescriptor(state.range(0)));
+    if (type == nullptr) {
+        return;
+    }
+    void* inst = createNestedStruct(type, true);
+    for (auto _ : state) {
+        char* json = nullptr;
+        jsonSerializer_serialize(type, inst, &json);
+        free(json);
+    }
+    state.SetItemsProcessed(state.iterations());
+    dynType_free(type, inst);
+    dynType_destroy(type);
+}
+
+static void JsonSerializer_deserializeNestedStruct(benchmark::State& state) {
+    dyn_type* type = parseType(state, createNestedStructDescriptor(state.range(0)));
+    if (type == nullptr) {
+        return;
+    }
+    void* inst = createNestedStruct(type, true);
+    char* json = nullptr;
+    jsonSerializer_serialize(type, inst, &json);
+    dynType_free(type, inst);
+    size_t len = strlen(json);
+    for (auto _ : state) {
+        void* result = nullptr;
+        jsonSerializer_deserialize(type, json, len, &result);
+        dynType_free(type, result);
+    }
+    state.SetItemsProcessed(state.iterations());
+    free(json);
+    dynType_destroy(type);
+}
+
+static void JsonSerializer_deserializeNestedStructInArena(benchmark::State& state) {
+    dyn_type* type = parseType(state, createNestedStructDescriptor(state.range(0)));
+    if (type == nullptr) {
+        return;
+    }
+    void* inst = createNestedStruct(type, true);
+    char* json = nullptr;
+    jsonSerializer_serialize(type, inst, &json);
+    dynType_free(type, inst);
+    size_t len = strlen(json);
+    dyn_arena_t* arena = dynArena_create(0);
+    for (auto _ : state) {
+        json_t* root = json_loadb(json, len, JSON_DECODE_ANY, nullptr);
+        void* result = nullptr;
+        jsonSerializer_deserializeJsonInArena(type, root, arena, &result);
+        json_decref(root);
+        dynArena_reset(arena);
+    }
+    state.SetItemsProcessed(state.iterations());
+    dynArena_destroy(arena);
+    free(json);
+    dynType_destroy(type);
+}
+
+static void JsonSerializer_serializeDoubleSequence(benchmark::State& state) {
+    dyn_type* type = parseType(state, "[D");
+    if (type == nullptr) {
+        return;
+    }
+    void* inst = createDoubleSequence(type, state.range(0));
+    for (auto _ : state) {
+        char* json = nullptr;
+        jsonSerializer_serialize(type, inst, &json);
+        free(json);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    dynType_free(type, inst);
+    dynType_destroy(type);
+}
+
+static void JsonSerializer_deserializeDoubleSequence(benchmark::State& state) {
+    dyn_type* type = parseType(state, "[D");
+    if (type == nullptr) {
+        return;
+    }
+    void* inst = createDoubleSequence(type, state.range(0));
+    char* json = nullptr;
+    jsonSerializer_serialize(type, inst, &json);
+    dynType_free(type, inst);
+    size_t len = strlen(json);
+    for (auto _ : state) {
+        void* result = nullptr;
+        jsonSerializer_deserialize(type, json, len, &result);
+        dynType_free(type, result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    free(json);
+    dynType_destroy(type);
+}
+
+BENCHMARK_CAPTURE(DynType_allocAndFreeNestedStruct, trivial, true)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK_CAPTURE(DynType_allocAndFreeNestedStruct, withText, false)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(DynType_allocAndFreeDoubleSequence)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(JsonSerializer_serializeNestedStruct)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(JsonSerializer_deserializeNestedStruct)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(JsonSerializer_deserializeNestedStructInArena)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(JsonSerializer_serializeDoubleSequence)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(JsonSerializer_deserializeDoubleSequence)->RangeMultiplier(10)->Range(10, 100000);
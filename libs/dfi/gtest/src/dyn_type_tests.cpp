@@ -326,6 +326,63 @@ TEST_F(DynTypeTests, NrOfEntriesTest) {
     dynType_destroy(type);
 }
 
+TEST_F(DynTypeTests, TrivialTypeTest) {
+    struct {
+        char c;
+        double d;
+        struct {
+            int32_t i;
+            char c;
+        } s;
+        int64_t j;
+    } example;
+
+    dyn_type *type = NULL;
+    int rc = dynType_parseWithStr("{BD{IB i c}J c d s j}", NULL, NULL, &type);
+    ASSERT_EQ(0, rc);
+    EXPECT_TRUE(dynType_isTrivial(type));
+    EXPECT_EQ(sizeof(example), dynType_size(type));
+    void* loc = nullptr;
+    void* expected[] = {&example.c, &example.d, &example.s, &example.j};
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(0, dynType_complex_valLocAt(type, i, &example, &loc));
+        EXPECT_EQ(expected[i], loc);
+    }
+    dynType_destroy(type);
+
+    rc = dynType_parseWithStr("{Dt d name}", NULL, NULL, &type);
+    ASSERT_EQ(0, rc);
+    EXPECT_FALSE(dynType_isTrivial(type));
+    dynType_destroy(type);
+
+    rc = dynType_parseWithStr("{D[D d seq}", NULL, NULL, &type);
+    ASSERT_EQ(0, rc);
+    EXPECT_FALSE(dynType_isTrivial(type));
+    dynType_destroy(type);
+
+    rc = dynType_parseWithStr("Ttriv={DD a b};{ltriv;D t d}", NULL, NULL, &type);
+    ASSERT_EQ(0, rc);
+    EXPECT_TRUE(dynType_isTrivial(type));
+    dynType_destroy(type);
+}
+
+TEST_F(DynTypeTests, RealTypeTest) {
+    dyn_type *type = NULL;
+    int rc = dynType_parseWithStr("Ttriv={DD a b};{ltriv;D t d}", NULL, NULL, &type);
+    ASSERT_EQ(0, rc);
+    EXPECT_EQ(type, dynType_realType(type));
+    dyn_type *member = NULL;
+    dynType_complex_dynTypeAt(type, 0, &member);
+    EXPECT_EQ('{', dynType_descriptorType(dynType_realType(member)));
+    dynType_destroy(type);
+
+    rc = dynType_parseWithStr("Tnum=D;lnum;", NULL, NULL, &type);
+    ASSERT_EQ(0, rc);
+    EXPECT_EQ('l', dynType_descriptorType(type));
+    EXPECT_EQ('D', dynType_descriptorType(dynType_realType(type)));
+    dynType_destroy(type);
+}
+
 TEST_F(DynTypeTests, ComplexHasEmptyName) {
     dyn_type *type = NULL;
     auto rc = dynType_parseWithStr(R"({II a })", nullptr, nullptr, &type);
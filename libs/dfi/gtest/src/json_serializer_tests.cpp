@@ -826,3 +826,53 @@ TEST_F(JsonSerializerTests, WriteComplexFailed) {
 TEST_F(JsonSerializerTests, WriteEnumFailed) {
     writeEnumFailed();
 }
+
+TEST_F(JsonSerializerTests, ParseInArena) {
+    dyn_arena_t* arena = dynArena_create(64); //small block size, so that multiple blocks are needed
+    ASSERT_TRUE(arena != nullptr);
+
+    dyn_type* type = nullptr;
+    int rc = dynType_parseWithStr(example5_descriptor, nullptr, nullptr, &type);
+    ASSERT_EQ(0, rc);
+    json_t* input = json_loads(example5_input, 0, nullptr);
+    ASSERT_TRUE(input != nullptr);
+    for (int i = 0; i < 3; ++i) {
+        void* inst = nullptr;
+        rc = jsonSerializer_deserializeJsonInArena(type, input, arena, &inst);
+        ASSERT_EQ(0, rc);
+        check_example5(inst);
+        EXPECT_GT(dynArena_usedSize(arena), 0);
+        dynArena_reset(arena);
+        EXPECT_EQ(0, dynArena_usedSize(arena));
+    }
+    json_decref(input);
+    dynType_destroy(type);
+
+    rc = dynType_parseWithStr(example3_descriptor, nullptr, nullptr, &type);
+    ASSERT_EQ(0, rc);
+    input = json_loads(example3_input, 0, nullptr);
+    ASSERT_TRUE(input != nullptr);
+    void* inst = nullptr;
+    rc = jsonSerializer_deserializeJsonInArena(type, input, arena, &inst);
+    ASSERT_EQ(0, rc);
+    check_example3(inst);
+    json_decref(input);
+    dynType_destroy(type);
+
+    dynArena_destroy(arena);
+}
+
+TEST_F(JsonSerializerTests, ParseInArenaFailed) {
+    celix_autoptr(dyn_arena_t) arena = dynArena_create(0);
+    ASSERT_TRUE(arena != nullptr);
+    dyn_type* type = nullptr;
+    int rc = dynType_parseWithStr(example7_descriptor, nullptr, nullptr, &type);
+    ASSERT_EQ(0, rc);
+    json_t* input = json_loads(R"({"a":1})", 0, nullptr);
+    void* inst = nullptr;
+    rc = jsonSerializer_deserializeJsonInArena(type, input, arena, &inst);
+    EXPECT_NE(0, rc);
+    EXPECT_EQ(nullptr, inst);
+    json_decref(input);
+    dynType_destroy(type);
+}
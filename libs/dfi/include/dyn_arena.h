@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _DYN_ARENA_H_
+#define _DYN_ARENA_H_
+
+#include <stddef.h>
+
+#include "celix_cleanup.h"
+#include "celix_dfi_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A dyn arena is a simple bump allocator which can be used to allocate the memory for dyn type instances.
+ *
+ * Memory allocated from an arena cannot be freed individually, instead all memory is released at once with
+ * dynArena_reset or dynArena_destroy. After a reset the arena keeps (up to a limit) the memory of its blocks, so an
+ * arena can be reused for similar sized allocations without calling malloc again.
+ *
+ * A dyn arena is not thread safe.
+ */
+typedef struct dyn_arena dyn_arena_t;
+
+/**
+ * @brief Creates a dyn arena.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @param[in] blockSize The size of the memory blocks the arena allocates from. If 0 a default block size is used.
+ * @return The new arena or NULL if memory could not be allocated.
+ */
+CELIX_DFI_EXPORT dyn_arena_t* dynArena_create(size_t blockSize);
+
+/**
+ * @brief Destroys a dyn arena and releases all memory allocated from it.
+ */
+CELIX_DFI_EXPORT void dynArena_destroy(dyn_arena_t* arena);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(dyn_arena_t, dynArena_destroy);
+
+/**
+ * @brief Allocates zero-initialized memory, suitably aligned for any type, from the arena.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @param[in] arena The arena.
+ * @param[in] size The size of the memory to allocate.
+ * @return The allocated memory or NULL if memory could not be allocated.
+ */
+CELIX_DFI_EXPORT void* dynArena_calloc(dyn_arena_t* arena, size_t size);
+
+/**
+ * @brief Copies a string to memory allocated from the arena.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @return The copied string or NULL if memory could not be allocated.
+ */
+CELIX_DFI_EXPORT char* dynArena_strdup(dyn_arena_t* arena, const char* str);
+
+/**
+ * @brief Releases all memory allocated from the arena in one step.
+ *
+ * If the previous allocations did not fit in a single block, the blocks are replaced by a single block large enough
+ * to hold all previous allocations, so that the next use of the arena does not need to allocate additional blocks.
+ */
+CELIX_DFI_EXPORT void dynArena_reset(dyn_arena_t* arena);
+
+/**
+ * @brief Returns the number of bytes currently allocated from the arena (including alignment padding).
+ */
+CELIX_DFI_EXPORT size_t dynArena_usedSize(const dyn_arena_t* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_DYN_ARENA_H_
@@ -210,6 +210,24 @@ CELIX_DFI_EXPORT void dynType_print(dyn_type *type, FILE *stream);
  */
 CELIX_DFI_EXPORT size_t dynType_size(dyn_type *type);
 
+/**
+ * Returns whether the dyn type is trivial: an instance contains no owned memory (no text, sequences or typed
+ * pointers), so an instance can be copied with memcpy and does not need a deep free.
+ * Simple types (including untyped pointers) are trivial and a complex type is trivial if all its members are trivial.
+ *
+ * @param type  The dyn type.
+ * @return      Whether the dyn type is trivial.
+ */
+CELIX_DFI_EXPORT bool dynType_isTrivial(dyn_type *type);
+
+/**
+ * Returns the referenced dyn type if the dyn type is a reference by value (e.g. 'lname;'), otherwise the dyn type itself.
+ *
+ * @param type  The dyn type.
+ * @return      The referenced dyn type or the dyn type itself.
+ */
+CELIX_DFI_EXPORT dyn_type* dynType_realType(dyn_type *type);
+
 /**
  * The type of the dyn type
  * E.g. DYN_TYPE_SIMPLE, DYN_TYPE_COMPLEX, etc
@@ -25,6 +25,7 @@
 #include "dyn_type.h"
 #include "dyn_function.h"
 #include "dyn_interface.h"
+#include "dyn_arena.h"
 #include "celix_dfi_export.h"
 
 #ifdef __cplusplus
@@ -64,6 +65,23 @@ CELIX_DFI_EXPORT int jsonSerializer_deserialize(dyn_type *type, const char *inpu
  */
 CELIX_DFI_EXPORT int jsonSerializer_deserializeJson(dyn_type *type, json_t *input, void **result);
 
+/**
+ * @brief Deserialize a JSON object to a given type, using an arena for all memory of the result.
+ *
+ * The result, including nested structs, sequence buffers and strings, is allocated from the provided arena and
+ * is released with the arena (dynArena_reset or dynArena_destroy). The result should not be freed with dynType_free.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @param[in] type The type to deserialize to.
+ * @param[in] input The JSON object to deserialize.
+ * @param[in] arena The arena to allocate the result from.
+ * @param[out] out The deserialized result.
+ * @return 0 if successful, otherwise 1.
+ *
+ */
+CELIX_DFI_EXPORT int jsonSerializer_deserializeJsonInArena(dyn_type *type, json_t *input, dyn_arena_t *arena, void **result);
+
 /**
  * @brief Serialize a given type to a JSON string.
  *
@@ -0,0 +1,153 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "dyn_arena.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "celix_err.h"
+
+#define DYN_ARENA_DEFAULT_BLOCK_SIZE 4096
+//the max size of the single block kept after a reset, larger blocks are released.
+#define DYN_ARENA_MAX_RETAINED_SIZE (1024 * 1024)
+
+//note gnu99 has no max_align_t, so use an union of the types with the largest alignment requirements.
+typedef union dyn_arena_max_align {
+    long double ld;
+    long long ll;
+    void* ptr;
+    void (*fp)(void);
+} dyn_arena_max_align_t;
+
+#define DYN_ARENA_ALIGNMENT __alignof__(dyn_arena_max_align_t)
+#define DYN_ARENA_ALIGN(size) (((size) + DYN_ARENA_ALIGNMENT - 1) & ~(DYN_ARENA_ALIGNMENT - 1))
+
+struct dyn_arena_block {
+    struct dyn_arena_block* next;
+    size_t size;
+    size_t used;
+    dyn_arena_max_align_t data[];
+};
+
+struct dyn_arena {
+    size_t blockSize;
+    struct dyn_arena_block* blocks; //the current block is the head of the list
+};
+
+static struct dyn_arena_block* dynArena_createBlock(size_t size) {
+    struct dyn_arena_block* block = malloc(sizeof(*block) + size);
+    if (block == NULL) {
+        celix_err_pushf("Error allocating arena block of %zu bytes", size);
+        return NULL;
+    }
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+static void dynArena_freeBlocks(struct dyn_arena_block* block) {
+    while (block != NULL) {
+        struct dyn_arena_block* next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+dyn_arena_t* dynArena_create(size_t blockSize) {
+    dyn_arena_t* arena = calloc(1, sizeof(*arena));
+    if (arena == NULL) {
+        celix_err_push("Error allocating memory for arena");
+        return NULL;
+    }
+    arena->blockSize = DYN_ARENA_ALIGN(blockSize == 0 ? DYN_ARENA_DEFAULT_BLOCK_SIZE : blockSize);
+    return arena;
+}
+
+void dynArena_destroy(dyn_arena_t* arena) {
+    if (arena != NULL) {
+        dynArena_freeBlocks(arena->blocks);
+        free(arena);
+    }
+}
+
+void* dynArena_calloc(dyn_arena_t* arena, size_t size) {
+    size_t alignedSize = DYN_ARENA_ALIGN(size == 0 ? 1 : size);
+    if (alignedSize < size) {
+        celix_err_pushf("Cannot allocate %zu bytes from arena", size);
+        return NULL;
+    }
+    struct dyn_arena_block* block = arena->blocks;
+    if (block == NULL || block->size - block->used < alignedSize) {
+        block = dynArena_createBlock(alignedSize > arena->blockSize ? alignedSize : arena->blockSize);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = arena->blocks;
+        arena->blocks = block;
+    }
+    void* mem = (char*)block->data + block->used;
+    block->used += alignedSize;
+    memset(mem, 0, size);
+    return mem;
+}
+
+char* dynArena_strdup(dyn_arena_t* arena, const char* str) {
+    size_t len = strlen(str);
+    char* copy = dynArena_calloc(arena, len + 1);
+    if (copy != NULL) {
+        memcpy(copy, str, len);
+    }
+    return copy;
+}
+
+void dynArena_reset(dyn_arena_t* arena) {
+    struct dyn_arena_block* blocks = arena->blocks;
+    if (blocks == NULL) {
+        return;
+    }
+    if (blocks->next == NULL && blocks->size <= DYN_ARENA_MAX_RETAINED_SIZE) {
+        blocks->used = 0;
+        return;
+    }
+
+    //replace the blocks with a single block which can hold all previous allocations
+    size_t totalSize = 0;
+    for (struct dyn_arena_block* block = blocks; block != NULL; block = block->next) {
+        totalSize += block->size;
+    }
+    dynArena_freeBlocks(blocks);
+    arena->blocks = NULL;
+    if (totalSize > DYN_ARENA_MAX_RETAINED_SIZE) {
+        totalSize = arena->blockSize;
+    }
+    //note if the block cannot be created, the arena starts empty and will allocate a block when needed
+    arena->blocks = dynArena_createBlock(totalSize);
+}
+
+size_t dynArena_usedSize(const dyn_arena_t* arena) {
+    size_t used = 0;
+    for (struct dyn_arena_block* block = arena->blocks; block != NULL; block = block->next) {
+        used += block->used;
+    }
+    return used;
+}
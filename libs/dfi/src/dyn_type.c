@@ -54,7 +54,8 @@ static int dynType_parseRefByValue(FILE *stream, dyn_type *type);
 static int dynType_parseSequence(FILE *stream, dyn_type *type);
 static int dynType_parseSimple(int c, dyn_type *type);
 static int dynType_parseTypedPointer(FILE *stream, dyn_type *type);
-static unsigned short dynType_getOffset(dyn_type *type, int index);
+static size_t dynType_getOffset(dyn_type *type, int index);
+static void dynType_finalizeComplexLayout(dyn_type *type);
 
 static void dynType_printAny(char *name, dyn_type *type, int depth, FILE *stream);
 static void dynType_printComplex(char *name, dyn_type *type, int depth, FILE *stream);
@@ -76,12 +77,6 @@ void dynType_freeSequenceType(dyn_type *type, void *seqLoc);
 
 static int dynType_parseMetaInfo(FILE *stream, dyn_type *type);
 
-struct generic_sequence {
-    uint32_t cap;
-    uint32_t len;
-    void *buf;
-};
-
 int dynType_parse(FILE *descriptorStream, const char *name, struct types_head *refTypes, dyn_type **type) {
     return dynType_parseWithStream(descriptorStream, name, NULL, refTypes, type);
 }
@@ -229,6 +224,7 @@ static int dynType_parseText(FILE *stream, dyn_type *type) {
     int status = OK;
     type->type = DYN_TYPE_TEXT;
     type->descriptor = 't';
+    type->trivial = false;
     type->ffiType = &ffi_type_pointer;
     return status;
 }
@@ -238,6 +234,7 @@ static int dynType_parseEnum(FILE *stream, dyn_type *type) {
     type->ffiType = &ffi_type_sint32;
     type->descriptor = 'E';
     type->type = DYN_TYPE_SIMPLE;
+    type->trivial = true;
     return status;
 }
 
@@ -316,11 +313,13 @@ static int dynType_parseComplex(FILE *stream, dyn_type *type) {
 
     if (status == OK) {
         type->complex.types = calloc(count, sizeof(dyn_type *));
-        if (type->complex.types != NULL) {
+        type->complex.offsets = calloc(count, sizeof(size_t));
+        if (type->complex.types != NULL && type->complex.offsets != NULL) {
             int index = 0;
             TAILQ_FOREACH(entry, &type->complex.entriesHead, entries) {
                 type->complex.types[index++] = entry->type;
             }
+            type->complex.nrOfEntries = count;
         } else {
             status = MEM_ERROR;
             LOG_ERROR("Error allocating memory for type");
@@ -329,6 +328,7 @@ static int dynType_parseComplex(FILE *stream, dyn_type *type) {
 
     if (status == OK) {
         dynType_prepCif(type->ffiType);
+        dynType_finalizeComplexLayout(type);
     }
 
 
@@ -469,6 +469,7 @@ static int dynType_parseSimple(int c, dyn_type *type) {
         type->type = DYN_TYPE_SIMPLE;
         type->descriptor = c;
         type->ffiType = ffiType;
+        type->trivial = true; //note untyped pointers ('P') are not owned
     } else {
         status = PARSE_ERROR;
         LOG_ERROR("Error unsupported type '%c'", c);
@@ -553,6 +554,7 @@ static void dynType_clearComplex(dyn_type *type) {
     if (type->complex.types != NULL) {
         free(type->complex.types);
     }
+    free(type->complex.offsets);
     if (type->complex.structType.elements != NULL) {
         free(type->complex.structType.elements);
     }
@@ -637,12 +639,8 @@ int dynType_complex_valLocAt(dyn_type *type, int index, void *inst, void **resul
 }
 
 size_t dynType_complex_nrOfEntries(dyn_type *type) {
-    size_t count = 0;
-    struct complex_type_entry *entry = NULL;
-    TAILQ_FOREACH(entry, &type->complex.entriesHead, entries) {
-        ++count;
-    }
-    return count;
+    assert(type->type == DYN_TYPE_COMPLEX);
+    return type->complex.nrOfEntries;
 }
 
 int dynType_complex_entries(dyn_type *type, struct complex_type_entries_head **entries) {
@@ -710,7 +708,12 @@ void dynType_free(dyn_type *type, void *loc) {
 }
 
 void dynType_deepFree(dyn_type *type, void *loc, bool alsoDeleteSelf) {
-    if (loc != NULL) {
+    if (loc != NULL && dynType_isTrivial(type)) {
+        //nothing owned, no need to walk the type
+        if (alsoDeleteSelf) {
+            free(loc);
+        }
+    } else if (loc != NULL) {
         dyn_type *subType = NULL;
         char *text = NULL;
         switch (type->type) {
@@ -750,22 +753,22 @@ void dynType_deepFree(dyn_type *type, void *loc, bool alsoDeleteSelf) {
 void dynType_freeSequenceType(dyn_type *type, void *seqLoc) {
     struct generic_sequence *seq = seqLoc;
     dyn_type *itemType = dynType_sequence_itemType(type);
-    void *itemLoc = NULL;
-    int i;
-    for (i = 0; i < seq->len; ++i) {
-        dynType_sequence_locForIndex(type, seqLoc, i, &itemLoc);
-        dynType_deepFree(itemType, itemLoc, false);
+    if (!dynType_isTrivial(itemType) && seq->buf != NULL) {
+        size_t itemSize = dynType_size(itemType);
+        char *itemLoc = seq->buf;
+        for (uint32_t i = 0; i < seq->len; ++i, itemLoc += itemSize) {
+            dynType_deepFree(itemType, itemLoc, false);
+        }
     }
     free(seq->buf);
 }
 
 void dynType_freeComplexType(dyn_type *type, void *loc) {
-    struct complex_type_entry *entry = NULL;
-    int index = 0;
-    void *entryLoc = NULL;
-    TAILQ_FOREACH(entry, &type->complex.entriesHead, entries) {
-        dynType_complex_valLocAt(type, index++, loc, &entryLoc);
-        dynType_deepFree(entry->type, entryLoc, false);
+    for (size_t i = 0; i < type->complex.nrOfEntries; ++i) {
+        dyn_type *entryType = type->complex.types[i];
+        if (!dynType_isTrivial(entryType)) {
+            dynType_deepFree(entryType, (char *)loc + type->complex.offsets[i], false);
+        }
     }
 }
 
@@ -909,25 +912,43 @@ static ffi_type * dynType_ffiTypeFor(int c) {
     return type;
 }
 
-static unsigned short dynType_getOffset(dyn_type *type, int index) {
+static size_t dynType_getOffset(dyn_type *type, int index) {
     assert(type->type == DYN_TYPE_COMPLEX);
-    unsigned short offset = 0;
+    assert(index >= 0 && (size_t)index < type->complex.nrOfEntries);
+    return type->complex.offsets[index];
+}
 
+/**
+ * Finalize the layout of a complex type: calculate the member offsets and whether the complex type is trivial.
+ * Should be called after the ffi struct type is prepared (sizes and alignments are known).
+ */
+static void dynType_finalizeComplexLayout(dyn_type *type) {
+    assert(type->type == DYN_TYPE_COMPLEX);
     ffi_type *ffiType = &type->complex.structType;
-    int i;
-    for (i = 0;  i <= index && ffiType->elements[i] != NULL; i += 1) {
-        size_t size = ffiType->elements[i]->size;
-        unsigned short alignment = ffiType->elements[i]->alignment;
-        int alignment_diff = offset % alignment;
-        if (alignment_diff > 0) {
-            offset += (alignment - alignment_diff);
-        }
-        if (i < index) {
-            offset += size;
+    size_t offset = 0;
+    bool trivial = true;
+    for (size_t i = 0; i < type->complex.nrOfEntries; ++i) {
+        size_t alignment = ffiType->elements[i]->alignment;
+        size_t alignmentDiff = alignment > 0 ? offset % alignment : 0;
+        if (alignmentDiff > 0) {
+            offset += (alignment - alignmentDiff);
         }
+        type->complex.offsets[i] = offset;
+        offset += ffiType->elements[i]->size;
+        trivial = trivial && dynType_isTrivial(type->complex.types[i]);
     }
+    type->trivial = trivial;
+}
+
+bool dynType_isTrivial(dyn_type *type) {
+    if (type->type == DYN_TYPE_REF) {
+        return type->ref.ref->trivial;
+    }
+    return type->trivial;
+}
 
-    return offset;
+dyn_type* dynType_realType(dyn_type *type) {
+    return type->type == DYN_TYPE_REF ? type->ref.ref : type;
 }
 
 size_t dynType_size(dyn_type *type) {
@@ -42,11 +42,14 @@ struct _dyn_type {
     struct types_head *referenceTypes; //NOTE: not owned
     struct types_head nestedTypesHead;
     struct meta_properties_head metaProperties;
+    bool trivial; //see dynType_isTrivial, finalized during parsing
     union {
         struct {
             struct complex_type_entries_head entriesHead;
             ffi_type structType; //dyn_type.ffiType points to this
             dyn_type **types; //based on entriesHead for fast access
+            size_t *offsets; //the member offsets, finalized during parsing
+            size_t nrOfEntries;
         } complex;
         struct {
             ffi_type seqType; //dyn_type.ffiType points to this
@@ -61,6 +64,12 @@ struct _dyn_type {
     };
 };
 
+struct generic_sequence {
+    uint32_t cap;
+    uint32_t len;
+    void *buf;
+};
+
 dyn_type * dynType_findType(dyn_type *type, char *name);
 ffi_type * dynType_ffiType(dyn_type * type);
 void dynType_prepCif(ffi_type *type);
@@ -27,6 +27,8 @@
 #include <string.h>
 #include <ffi.h>
 #include "celix_compiler.h"
+#include "celix_threads.h"
+#include "dyn_arena.h"
 #include "dyn_type_common.h"
 
 static int OK = 0;
@@ -41,6 +43,112 @@ struct generic_service_layout {
 	gen_func_type methods[];
 };
 
+/**
+ * Per thread arena used for the input arguments of jsonRpc_call.
+ */
+typedef struct json_rpc_call_arena {
+    dyn_arena_t *arena;
+    bool inUse; //true if a jsonRpc_call on this thread is using the arena
+    struct json_rpc_call_arena *prev; //protected by g_callArenasMutex
+    struct json_rpc_call_arena *next; //protected by g_callArenasMutex
+} json_rpc_call_arena_t;
+
+static celix_tss_key_t g_callArenaKey;
+static bool g_callArenaKeyInitialized = false;
+
+/**
+ * All thread arenas, so that the arenas of still running threads can be destroyed when the TSS key is deleted.
+ */
+static celix_thread_mutex_t g_callArenasMutex = CELIX_THREAD_MUTEX_INITIALIZER;
+static json_rpc_call_arena_t *g_callArenas = NULL; //protected by g_callArenasMutex
+
+static void jsonRpc_freeCallArena(json_rpc_call_arena_t *callArena) {
+    dynArena_destroy(callArena->arena);
+    free(callArena);
+}
+
+/**
+ * TSS destructor, called when a thread with a call arena exits.
+ */
+static void jsonRpc_destroyCallArena(void *data) {
+    json_rpc_call_arena_t *callArena = data;
+    if (callArena != NULL) {
+        celixThreadMutex_lock(&g_callArenasMutex);
+        if (callArena->prev != NULL) {
+            callArena->prev->next = callArena->next;
+        } else {
+            g_callArenas = callArena->next;
+        }
+        if (callArena->next != NULL) {
+            callArena->next->prev = callArena->prev;
+        }
+        celixThreadMutex_unlock(&g_callArenasMutex);
+        jsonRpc_freeCallArena(callArena);
+    }
+}
+
+__attribute__((constructor)) static void jsonRpc_initCallArenaKey(void) {
+    g_callArenaKeyInitialized = celix_tss_create(&g_callArenaKey, jsonRpc_destroyCallArena) == CELIX_SUCCESS;
+}
+
+__attribute__((destructor)) static void jsonRpc_deinitCallArenaKey(void) {
+    if (g_callArenaKeyInitialized) {
+        //note deleting the key does not call the TSS destructor for the threads still running, so destroy all arenas
+        (void)celix_tss_delete(g_callArenaKey);
+        g_callArenaKeyInitialized = false;
+        celixThreadMutex_lock(&g_callArenasMutex);
+        json_rpc_call_arena_t *callArena = g_callArenas;
+        g_callArenas = NULL;
+        celixThreadMutex_unlock(&g_callArenasMutex);
+        while (callArena != NULL) {
+            json_rpc_call_arena_t *next = callArena->next;
+            jsonRpc_freeCallArena(callArena);
+            callArena = next;
+        }
+    }
+}
+
+/**
+ * Returns the arena of the calling thread or NULL if no arena is available, in which case the input arguments are
+ * heap allocated. The latter is also the case for a nested jsonRpc_call on the same thread.
+ */
+static json_rpc_call_arena_t* jsonRpc_acquireCallArena(void) {
+    if (!g_callArenaKeyInitialized) {
+        return NULL;
+    }
+    json_rpc_call_arena_t *callArena = celix_tss_get(g_callArenaKey);
+    if (callArena == NULL) {
+        callArena = calloc(1, sizeof(*callArena));
+        if (callArena == NULL) {
+            return NULL;
+        }
+        callArena->arena = dynArena_create(0);
+        if (callArena->arena == NULL || celix_tss_set(g_callArenaKey, callArena) != CELIX_SUCCESS) {
+            jsonRpc_freeCallArena(callArena);
+            return NULL;
+        }
+        celixThreadMutex_lock(&g_callArenasMutex);
+        callArena->next = g_callArenas;
+        if (g_callArenas != NULL) {
+            g_callArenas->prev = callArena;
+        }
+        g_callArenas = callArena;
+        celixThreadMutex_unlock(&g_callArenasMutex);
+    }
+    if (callArena->inUse) {
+        return NULL;
+    }
+    callArena->inUse = true;
+    return callArena;
+}
+
+static void jsonRpc_releaseCallArena(json_rpc_call_arena_t *callArena) {
+    if (callArena != NULL) {
+        dynArena_reset(callArena->arena);
+        callArena->inUse = false;
+    }
+}
+
 int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, char **out) {
 	int status = OK;
 
@@ -107,6 +215,11 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 	void *ptr = NULL;
 	void *ptrToPtr = &ptr;
 
+	//input arguments are only used during the call, so (except for strings handed over to the callee) these
+	//are allocated from the call arena and released in one step after the call.
+	json_rpc_call_arena_t *callArena = jsonRpc_acquireCallArena();
+	dyn_arena_t *arena = callArena != NULL ? callArena->arena : NULL;
+
 	//setup and deserialize input
 	for (i = 0; i < nrOfArgs; ++i) {
 		dyn_type *argType = dynFunction_argumentTypeForIndex(func, i);
@@ -114,7 +227,11 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 		if (meta == DYN_FUNCTION_ARGUMENT_META__STD) {
 			value = json_array_get(arguments, index++);
 			void *outPtr = NULL;
-            status = jsonSerializer_deserializeJson(argType, value, &outPtr);
+			if (arena != NULL && dynType_descriptorType(argType) != 't') {
+				status = jsonSerializer_deserializeJsonInArena(argType, value, arena, &outPtr);
+			} else {
+				status = jsonSerializer_deserializeJson(argType, value, &outPtr);
+			}
             args[i] = outPtr;
 		} else if (meta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT) {
 		    void **instPtr = calloc(1, sizeof(void*));
@@ -167,11 +284,12 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
                     //will free the actual pointer
                     free(args[i]);
 		        }
-		    } else {
+		    } else if (arena == NULL) {
                 dynType_free(argType, args[i]);
-            }
+            } //else allocated from the call arena
 		}
 	}
+	jsonRpc_releaseCallArena(callArena);
 
 	//serialize and free output
 	for (i = 0; i < nrOfArgs; i += 1) {
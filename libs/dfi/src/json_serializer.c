@@ -27,11 +27,13 @@
 #include <stdint.h>
 #include <string.h>
 
-static int jsonSerializer_createType(dyn_type *type, json_t *object, void **result);
-static int jsonSerializer_parseObject(dyn_type *type, json_t *object, void *inst);
-static int jsonSerializer_parseObjectMember(dyn_type *type, const char *name, json_t *val, void *inst);
-static int jsonSerializer_parseSequence(dyn_type *seq, json_t *array, void *seqLoc);
-static int jsonSerializer_parseAny(dyn_type *type, void *input, json_t *val);
+static int jsonSerializer_createType(dyn_type *type, json_t *object, dyn_arena_t *arena, void **result);
+static int jsonSerializer_parseObject(dyn_type *type, json_t *object, dyn_arena_t *arena, void *inst);
+static int jsonSerializer_parseObjectMember(dyn_type *type, const char *name, json_t *val, dyn_arena_t *arena, void *inst);
+static int jsonSerializer_parseSequence(dyn_type *seq, json_t *array, dyn_arena_t *arena, void *seqLoc);
+static int jsonSerializer_parseAny(dyn_type *type, void *input, json_t *val, dyn_arena_t *arena);
+static int jsonSerializer_allocSequence(dyn_type *seq, void *seqLoc, size_t cap, dyn_arena_t *arena);
+static int jsonSerializer_allocText(dyn_type *type, void *textLoc, const char *value, dyn_arena_t *arena);
 static int jsonSerializer_parseEnum(dyn_type *type, const char* enum_name, int32_t *out);
 
 static int jsonSerializer_writeAny(dyn_type *type, void *input, json_t **val);
@@ -67,10 +69,15 @@ int jsonSerializer_deserialize(dyn_type *type, const char *input, size_t length,
 }
 
 int jsonSerializer_deserializeJson(dyn_type *type, json_t *input, void **out) {
-    return jsonSerializer_createType(type, input, out);
+    return jsonSerializer_createType(type, input, NULL, out);
 }
 
-static int jsonSerializer_createType(dyn_type *type, json_t *val, void **result) {
+int jsonSerializer_deserializeJsonInArena(dyn_type *type, json_t *input, dyn_arena_t *arena, void **out) {
+    assert(arena != NULL);
+    return jsonSerializer_createType(type, input, arena, out);
+}
+
+static int jsonSerializer_createType(dyn_type *type, json_t *val, dyn_arena_t *arena, void **result) {
     assert(val != NULL);
     int status = OK;
     void *inst = NULL;
@@ -79,40 +86,84 @@ static int jsonSerializer_createType(dyn_type *type, json_t *val, void **result)
         if (json_typeof(val) == JSON_STRING) {
             //note a deserialized C string is a sequence of memory for the actual string and a
             //pointer to that sequence. That pointer also needs to reside in the memory (heap).
-            const char *s = json_string_value(val);
-            inst = calloc(1, sizeof(char*));
-            *((char**)inst) = strdup(s);
+            inst = arena == NULL ? calloc(1, sizeof(char*)) : dynArena_calloc(arena, sizeof(char*));
+            if (inst != NULL) {
+                status = jsonSerializer_allocText(type, inst, json_string_value(val), arena);
+            } else {
+                status = ERROR;
+                LOG_ERROR("Error allocating memory for text pointer");
+            }
         } else {
             status = ERROR;
             LOG_ERROR("Expected json_string type got %i\n", json_typeof(val));
         }
+    } else if (arena != NULL) {
+        inst = dynArena_calloc(arena, dynType_size(type));
+        status = inst != NULL ? OK : ERROR;
     } else {
         status = dynType_alloc(type, &inst);
+    }
 
-        if (status == OK) {
-            assert(inst != NULL);
-            status = jsonSerializer_parseAny(type, inst, val);
-        }
+    if (status == OK && dynType_descriptorType(type) != 't') {
+        assert(inst != NULL);
+        status = jsonSerializer_parseAny(type, inst, val, arena);
     }
 
     if (status == OK) {
         *result = inst;
     } else {
         *result = NULL;
-    	dynType_free(type, inst);
+        if (arena == NULL) {
+            dynType_free(type, inst);
+        }
     }
 
     return status;
 }
 
-static int jsonSerializer_parseObject(dyn_type *type, json_t *object, void *inst) {
+static int jsonSerializer_allocSequence(dyn_type *seq, void *seqLoc, size_t cap, dyn_arena_t *arena) {
+    //note cap is the size of a received json array, so guard the sequence cap and buffer size against overflow
+    size_t itemSize = dynType_size(dynType_sequence_itemType(seq));
+    if (cap > UINT32_MAX || (itemSize != 0 && cap > SIZE_MAX / itemSize)) {
+        LOG_ERROR("Cannot allocate sequence with %zu items of size %zu", cap, itemSize);
+        return ERROR;
+    }
+    if (arena == NULL) {
+        return dynType_sequence_alloc(seq, seqLoc, (uint32_t) cap);
+    }
+    struct generic_sequence *genSeq = seqLoc;
+    genSeq->len = 0;
+    genSeq->cap = 0;
+    genSeq->buf = dynArena_calloc(arena, cap * itemSize);
+    if (genSeq->buf == NULL) {
+        LOG_ERROR("Error allocating memory for sequence buffer");
+        return ERROR;
+    }
+    genSeq->cap = (uint32_t) cap;
+    return OK;
+}
+
+static int jsonSerializer_allocText(dyn_type *type, void *textLoc, const char *value, dyn_arena_t *arena) {
+    if (arena == NULL) {
+        return dynType_text_allocAndInit(type, textLoc, value);
+    }
+    char *str = dynArena_strdup(arena, value);
+    if (str == NULL) {
+        LOG_ERROR("Cannot allocate memory for string");
+        return ERROR;
+    }
+    *(char **) textLoc = str;
+    return OK;
+}
+
+static int jsonSerializer_parseObject(dyn_type *type, json_t *object, dyn_arena_t *arena, void *inst) {
     assert(object != NULL);
     int status = 0;
     json_t *value;
     const char *key;
 
     json_object_foreach(object, key, value) {
-        status = jsonSerializer_parseObjectMember(type, key, value, inst);
+        status = jsonSerializer_parseObjectMember(type, key, value, arena, inst);
         if (status != OK) {
             break;
         }
@@ -121,7 +172,7 @@ static int jsonSerializer_parseObject(dyn_type *type, json_t *object, void *inst
     return status;
 }
 
-static int jsonSerializer_parseObjectMember(dyn_type *type, const char *name, json_t *val, void *inst) {
+static int jsonSerializer_parseObjectMember(dyn_type *type, const char *name, json_t *val, dyn_arena_t *arena, void *inst) {
     int status = OK;
     void *valp = NULL;
     dyn_type *valType = NULL;
@@ -140,13 +191,13 @@ static int jsonSerializer_parseObjectMember(dyn_type *type, const char *name, js
     }
 
     if (status == OK) {
-        status = jsonSerializer_parseAny(valType, valp, val);
+        status = jsonSerializer_parseAny(valType, valp, val, arena);
     }
 
     return status;
 }
 
-static int jsonSerializer_parseAny(dyn_type *type, void *loc, json_t *val) {
+static int jsonSerializer_parseAny(dyn_type *type, void *loc, json_t *val, dyn_arena_t *arena) {
     int status = OK;
 
     dyn_type *subType = NULL;
@@ -236,7 +287,7 @@ static int jsonSerializer_parseAny(dyn_type *type, void *loc, json_t *val) {
             if (json_is_null(val)) {
                 //nop
             } else if (json_is_string(val)) {
-                dynType_text_allocAndInit(type, loc, json_string_value(val));
+                status = jsonSerializer_allocText(type, loc, json_string_value(val), arena);
             } else {
                 status = ERROR;
                 LOG_ERROR("Expected json string type got %i", json_typeof(val));
@@ -244,7 +295,7 @@ static int jsonSerializer_parseAny(dyn_type *type, void *loc, json_t *val) {
             break;
         case '[' :
             if (json_is_array(val)) {
-                status = jsonSerializer_parseSequence(type, val, loc);
+                status = jsonSerializer_parseSequence(type, val, arena, loc);
             } else {
                 status = ERROR;
                 LOG_ERROR("Expected json array type got '%i'", json_typeof(val));
@@ -252,13 +303,13 @@ static int jsonSerializer_parseAny(dyn_type *type, void *loc, json_t *val) {
             break;
         case '{' :
             if (status == OK) {
-                status = jsonSerializer_parseObject(type, val, loc);
+                status = jsonSerializer_parseObject(type, val, arena, loc);
             }
             break;
         case '*' :
             status = dynType_typedPointer_getTypedType(type, &subType);
             if (status == OK) {
-                status = jsonSerializer_createType(subType, val, (void **) loc);
+                status = jsonSerializer_createType(subType, val, arena, (void **) loc);
             }
             break;
         case 'P' :
@@ -266,7 +317,7 @@ static int jsonSerializer_parseAny(dyn_type *type, void *loc, json_t *val) {
             LOG_ERROR("Untyped pointer are not supported for serialization");
             break;
         case 'l':
-            status = jsonSerializer_parseAny(type->ref.ref, loc, val);
+            status = jsonSerializer_parseAny(type->ref.ref, loc, val, arena);
             break;
         default :
             status = ERROR;
@@ -277,12 +328,12 @@ static int jsonSerializer_parseAny(dyn_type *type, void *loc, json_t *val) {
     return status;
 }
 
-static int jsonSerializer_parseSequence(dyn_type *seq, json_t *array, void *seqLoc) {
+static int jsonSerializer_parseSequence(dyn_type *seq, json_t *array, dyn_arena_t *arena, void *seqLoc) {
     assert(dynType_type(seq) == DYN_TYPE_SEQUENCE);
     int status = OK;
 
     size_t size = json_array_size(array);
-    status = dynType_sequence_alloc(seq, seqLoc, (int) size);
+    status = jsonSerializer_allocSequence(seq, seqLoc, size, arena);
 
     if (status == OK) {
         dyn_type *itemType = dynType_sequence_itemType(seq);
@@ -292,7 +343,7 @@ static int jsonSerializer_parseSequence(dyn_type *seq, json_t *array, void *seqL
             void *valLoc = NULL;
             status = dynType_sequence_increaseLengthAndReturnLastLoc(seq, seqLoc, &valLoc);
             if (status == OK) {
-                status = jsonSerializer_parseAny(itemType, valLoc, val);
+                status = jsonSerializer_parseAny(itemType, valLoc, val, arena);
                 if (status != OK) {
                     break;
                 }
@@ -488,7 +539,7 @@ static int jsonSerializer_writeComplex(dyn_type *type, void *input, json_t **out
     json_t *val = json_object();
     struct complex_type_entry *entry = NULL;
     struct complex_type_entries_head *entries = NULL;
-    int index = -1;
+    int index = 0;
 
     status = dynType_complex_entries(type, &entries);
     if (status == OK) {
@@ -496,9 +547,8 @@ static int jsonSerializer_writeComplex(dyn_type *type, void *input, json_t **out
             void *subLoc = NULL;
             json_t *subVal = NULL;
             dyn_type *subType = NULL;
-            index = dynType_complex_indexForName(type, entry->name);
-            if (index < 0) {
-                LOG_ERROR("Cannot find index for member '%s'", entry->name);
+            if (entry->name == NULL) {
+                LOG_ERROR("Cannot find name for member at index %i", index);
                 status = ERROR;
             }
             if(status == OK){
@@ -518,6 +568,7 @@ static int jsonSerializer_writeComplex(dyn_type *type, void *input, json_t **out
             if (status != OK) {
                 break;
             }
+            index += 1;
         }
     }
 
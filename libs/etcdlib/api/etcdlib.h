@@ -51,6 +51,14 @@ typedef struct etcdlib_struct etcdlib_t; //opaque struct
 
 typedef void (*etcdlib_key_value_callback) (const char *key, const char *value, void* arg);
 
+typedef struct etcdlib_watch_loop etcdlib_watch_loop_t; //opaque struct
+
+/**
+ * @desc Callback for the changes received by a watch loop.
+ * The strings are only valid during the callback. key, value and prevValue can be NULL (e.g. value for a delete).
+ */
+typedef void (*etcdlib_watch_callback) (const char *action, const char *key, const char *value, const char *prevValue, long long modifiedIndex, void* arg);
+
 /**
  * @desc Creates the ETCD-LIB  with the server/port where Etcd can be reached.
  * @param const char* server. String containing the IP-number of the server.
@@ -150,6 +158,55 @@ ETCDLIB_EXPORT int etcdlib_del(etcdlib_t *etcdlib, const char* key);
  */
 ETCDLIB_EXPORT int etcdlib_watch(etcdlib_t *etcdlib, const char* key, long long index, char** action, char** prevValue, char** value, char** rkey, long long* modifiedIndex);
 
+/**
+ * @desc Creates a watch loop for an etcd directory.
+ * The watch loop uses a single long-lived streaming watch (wait=true&recursive=true&stream=true) instead of a
+ * request per change. If the stream ends, the watch is re-issued on the same (reused) connection, starting at the
+ * index after the last received change. Optionally the ttl of a key can be refreshed from the same loop,
+ * see etcdlib_watch_loop_set_refresh.
+ * The watch loop is driven by etcdlib_watch_loop_run and uses its own connections, not the shared etcdlib connection.
+ * @param etcdlib_t* etcdlib. The ETCD-LIB instance (contains hostname and port info).
+ * @param const char* key. The Etcd-directory to watch (Note: a leading '/' should be avoided).
+ * @param long long index. The Etcd-index which the watch has to be started on, 0 to start at the current index.
+ * @param etcdlib_watch_callback callback. Callback function which is called, on the thread running the loop, for every change.
+ * @param void* arg. Argument is passed to the callback function.
+ * @return The watch loop or NULL if the watch loop could not be created.
+ */
+ETCDLIB_EXPORT etcdlib_watch_loop_t* etcdlib_watch_loop_create(etcdlib_t *etcdlib, const char* key, long long index, etcdlib_watch_callback callback, void* arg);
+
+/**
+ * @desc Destroys the watch loop. The watch loop should not be running.
+ * @param etcdlib_watch_loop_t* loop. The watch loop.
+ */
+ETCDLIB_EXPORT void etcdlib_watch_loop_destroy(etcdlib_watch_loop_t *loop);
+
+/**
+ * @desc Periodically refresh the ttl of a key from the watch loop. The first refresh is done when the loop is run.
+ * If the key does not exist (anymore), e.g. because it expired, the key is (re)created with the provided value.
+ * Should be called before etcdlib_watch_loop_run.
+ * @param etcdlib_watch_loop_t* loop. The watch loop.
+ * @param const char* key. The Etcd-key to refresh.
+ * @param const char* value. The Etcd-value used if the key needs to be (re)created.
+ * @param int ttl. The ttl value to use.
+ * @param int interval. The refresh interval in seconds, should be (a fair bit) smaller than the ttl.
+ * @return 0 on success, non zero otherwise.
+ */
+ETCDLIB_EXPORT int etcdlib_watch_loop_set_refresh(etcdlib_watch_loop_t *loop, const char* key, const char* value, int ttl, int interval);
+
+/**
+ * @desc Runs the watch loop on the calling thread until etcdlib_watch_loop_stop is called.
+ * Failed watches are retried, so connection errors do not stop the loop.
+ * @param etcdlib_watch_loop_t* loop. The watch loop.
+ * @return ETCDLIB_RC_OK (0) if the loop is stopped, non zero otherwise.
+ */
+ETCDLIB_EXPORT int etcdlib_watch_loop_run(etcdlib_watch_loop_t *loop);
+
+/**
+ * @desc Stops the watch loop. Can be called from any thread, including before etcdlib_watch_loop_run is called.
+ * @param etcdlib_watch_loop_t* loop. The watch loop.
+ */
+ETCDLIB_EXPORT void etcdlib_watch_loop_stop(etcdlib_watch_loop_t *loop);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,8 +18,10 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
 #include <curl/curl.h>
 #include <jansson.h>
 #include <pthread.h>
@@ -39,10 +41,17 @@
 
 #define ETCD_HEADER_INDEX               "X-Etcd-Index: "
 
+#define ETCD_ERRORCODE_KEY_NOT_FOUND   100
+#define ETCD_ERRORCODE_INDEX_CLEARED   401
+
 #define MAX_OVERHEAD_LENGTH           64
 #define DEFAULT_CURL_TIMEOUT          10
 #define DEFAULT_CURL_CONNECT_TIMEOUT  10
 
+#define WATCH_LOOP_RETRY_INTERVAL_MS  1000
+#define WATCH_LOOP_MAX_POLL_MS        1000
+#define WATCH_LOOP_KEEPALIVE_SECONDS  10
+
 struct etcdlib_struct {
     char *host;
     int port;
@@ -65,12 +74,42 @@ struct MemoryStruct {
     size_t headerSize;
 };
 
+struct etcdlib_watch_loop {
+    etcdlib_t *etcdlib;
+    char *key;
+    long long index; //the index to (re)start the watch on
+    etcdlib_watch_callback callback;
+    void *arg;
+
+    CURLM *multi;
+
+    CURL *watchCurl;
+    bool watchActive;
+    long long watchStartTime; //monotonic time in ms
+    char *stream; //received, but not yet handled (incomplete), watch stream data
+    size_t streamSize;
+
+    char *refreshKey;
+    char *refreshValue;
+    int ttl;
+    int interval;
+    CURL *refreshCurl;
+    bool refreshActive;
+    bool refreshIsSet; //whether the active refresh request (re)creates the key
+    long long refreshTime; //monotonic time in ms
+    char *refreshRequest;
+    struct MemoryStruct refreshReply;
+
+    bool stopped; //atomic
+};
+
 /**
  * Static function declarations
  */
 static int
 performRequest(CURL **curl, pthread_mutex_t *mutex, char *url, request_t request, void *reqData, void *repData);
 static size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp);
+static size_t WriteStreamCallback(void *contents, size_t size, size_t nmemb, void *userp);
 /**
  * External function definition
  */
@@ -632,6 +671,354 @@ int etcdlib_del(etcdlib_t *etcdlib, const char *key) {
     return retVal;
 }
 
+static long long etcdlib_watch_loop_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+etcdlib_watch_loop_t *etcdlib_watch_loop_create(etcdlib_t *etcdlib, const char *key, long long index,
+                                                 etcdlib_watch_callback callback, void *arg) {
+    etcdlib_watch_loop_t *loop = calloc(1, sizeof(*loop));
+    if (loop == NULL) {
+        return NULL;
+    }
+    loop->etcdlib = etcdlib;
+    loop->key = strdup(key);
+    loop->index = index;
+    loop->callback = callback;
+    loop->arg = arg;
+    loop->multi = curl_multi_init();
+    loop->watchCurl = curl_easy_init();
+    loop->refreshCurl = curl_easy_init();
+    if (loop->key == NULL || loop->multi == NULL || loop->watchCurl == NULL || loop->refreshCurl == NULL) {
+        fprintf(stderr, "[ETCDLIB] Error: cannot create watch loop\n");
+        etcdlib_watch_loop_destroy(loop);
+        return NULL;
+    }
+
+    // The watch is a long-lived stream, so no transfer timeout; tcp keepalive is used to detect a dead connection.
+    curl_easy_setopt(loop->watchCurl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(loop->watchCurl, CURLOPT_CONNECTTIMEOUT, DEFAULT_CURL_CONNECT_TIMEOUT);
+    curl_easy_setopt(loop->watchCurl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(loop->watchCurl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(loop->watchCurl, CURLOPT_TCP_KEEPIDLE, (long) WATCH_LOOP_KEEPALIVE_SECONDS);
+    curl_easy_setopt(loop->watchCurl, CURLOPT_TCP_KEEPINTVL, (long) WATCH_LOOP_KEEPALIVE_SECONDS);
+    curl_easy_setopt(loop->watchCurl, CURLOPT_WRITEFUNCTION, WriteStreamCallback);
+    curl_easy_setopt(loop->watchCurl, CURLOPT_WRITEDATA, loop);
+
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_TIMEOUT, DEFAULT_CURL_TIMEOUT);
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_CONNECTTIMEOUT, DEFAULT_CURL_CONNECT_TIMEOUT);
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_CUSTOMREQUEST, "PUT");
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_POST, 1L);
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_WRITEDATA, &loop->refreshReply);
+
+    return loop;
+}
+
+void etcdlib_watch_loop_destroy(etcdlib_watch_loop_t *loop) {
+    if (loop != NULL) {
+        if (loop->watchActive) {
+            curl_multi_remove_handle(loop->multi, loop->watchCurl);
+        }
+        if (loop->refreshActive) {
+            curl_multi_remove_handle(loop->multi, loop->refreshCurl);
+        }
+        if (loop->watchCurl != NULL) {
+            curl_easy_cleanup(loop->watchCurl);
+        }
+        if (loop->refreshCurl != NULL) {
+            curl_easy_cleanup(loop->refreshCurl);
+        }
+        if (loop->multi != NULL) {
+            curl_multi_cleanup(loop->multi);
+        }
+        free(loop->key);
+        free(loop->stream);
+        free(loop->refreshKey);
+        free(loop->refreshValue);
+        free(loop->refreshRequest);
+        free(loop->refreshReply.memory);
+    }
+    free(loop);
+}
+
+int etcdlib_watch_loop_set_refresh(etcdlib_watch_loop_t *loop, const char *key, const char *value, int ttl,
+                                   int interval) {
+    if (ttl <= 0 || interval <= 0) {
+        fprintf(stderr, "[ETCDLIB] Error: invalid ttl (%i) or refresh interval (%i)\n", ttl, interval);
+        return ETCDLIB_RC_ERROR;
+    }
+
+    /* Skip leading '/', etcd cannot handle this. */
+    while (*key == '/') {
+        key++;
+    }
+    char *refreshKey = strdup(key);
+    char *refreshValue = strdup(value);
+    if (refreshKey == NULL || refreshValue == NULL) {
+        free(refreshKey);
+        free(refreshValue);
+        return ETCDLIB_RC_ERROR;
+    }
+
+    free(loop->refreshKey);
+    free(loop->refreshValue);
+    loop->refreshKey = refreshKey;
+    loop->refreshValue = refreshValue;
+    loop->ttl = ttl;
+    loop->interval = interval;
+    loop->refreshTime = 0;
+    return ETCDLIB_RC_OK;
+}
+
+static void etcdlib_watch_loop_handleEvent(etcdlib_watch_loop_t *loop, const char *data, size_t size) {
+    while (size > 0 && (data[size - 1] == '\r' || data[size - 1] == ' ')) {
+        size--;
+    }
+    if (size == 0) {
+        return;
+    }
+
+    json_error_t error;
+    json_t *js_root = json_loadb(data, size, 0, &error);
+    if (js_root == NULL) {
+        fprintf(stderr, "[ETCDLIB] Error: cannot parse watch event: %s\n", error.text);
+        return;
+    }
+
+    json_t *js_errorCode = json_object_get(js_root, ETCD_JSON_ERRORCODE);
+    if (js_errorCode != NULL) {
+        json_t *js_index = json_object_get(js_root, ETCD_JSON_INDEX);
+        if (json_integer_value(js_errorCode) == ETCD_ERRORCODE_INDEX_CLEARED && json_is_integer(js_index)) {
+            // the watch index is outside of the etcd event history, continue at the current etcd index
+            fprintf(stderr, "[ETCDLIB] Warning: watch index %lli cleared, continuing at index %lli\n", loop->index,
+                    json_integer_value(js_index) + 1);
+            loop->index = json_integer_value(js_index) + 1;
+        } else {
+            fprintf(stderr, "[ETCDLIB] errorcode %lli\n", json_integer_value(js_errorCode));
+        }
+        json_decref(js_root);
+        return;
+    }
+
+    json_t *js_action = json_object_get(js_root, ETCD_JSON_ACTION);
+    json_t *js_node = json_object_get(js_root, ETCD_JSON_NODE);
+    json_t *js_prevNode = json_object_get(js_root, ETCD_JSON_PREVNODE);
+    json_t *js_modIndex = json_object_get(js_node, ETCD_JSON_MODIFIEDINDEX);
+    if (json_is_string(js_action) && json_is_integer(js_modIndex)) {
+        long long modifiedIndex = json_integer_value(js_modIndex);
+        if (modifiedIndex >= loop->index) {
+            loop->index = modifiedIndex + 1;
+        }
+        loop->callback(json_string_value(js_action),
+                       json_string_value(json_object_get(js_node, ETCD_JSON_KEY)),
+                       json_string_value(json_object_get(js_node, ETCD_JSON_VALUE)),
+                       json_string_value(json_object_get(js_prevNode, ETCD_JSON_VALUE)),
+                       modifiedIndex, loop->arg);
+    } else {
+        fprintf(stderr, "[ETCDLIB] Error: watch event without %s or %s\n", ETCD_JSON_ACTION, ETCD_JSON_MODIFIEDINDEX);
+    }
+    json_decref(js_root);
+}
+
+/**
+ * Handles the watch stream. Every change is streamed as a newline terminated json object.
+ */
+static size_t WriteStreamCallback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    etcdlib_watch_loop_t *loop = (etcdlib_watch_loop_t *) userp;
+
+    char *stream = realloc(loop->stream, loop->streamSize + realsize);
+    if (stream == NULL) {
+        /* out of memory! */
+        fprintf(stderr, "[ETCDLIB] Error: not enough memory (realloc returned NULL)\n");
+        return 0;
+    }
+    loop->stream = stream;
+    memcpy(&(loop->stream[loop->streamSize]), contents, realsize);
+    loop->streamSize += realsize;
+
+    char *start = loop->stream;
+    char *end = loop->stream + loop->streamSize;
+    char *eol;
+    while ((eol = memchr(start, '\n', end - start)) != NULL) {
+        etcdlib_watch_loop_handleEvent(loop, start, eol - start);
+        start = eol + 1;
+    }
+    loop->streamSize = end - start;
+    memmove(loop->stream, start, loop->streamSize);
+
+    return realsize;
+}
+
+static int etcdlib_watch_loop_startWatch(etcdlib_watch_loop_t *loop) {
+    char *url = NULL;
+    int rc;
+    if (loop->index > 0) {
+        rc = asprintf(&url, "http://%s:%d/v2/keys/%s?wait=true&recursive=true&stream=true&waitIndex=%lld",
+                      loop->etcdlib->host, loop->etcdlib->port, loop->key, loop->index);
+    } else {
+        rc = asprintf(&url, "http://%s:%d/v2/keys/%s?wait=true&recursive=true&stream=true", loop->etcdlib->host,
+                      loop->etcdlib->port, loop->key);
+    }
+    if (rc < 0) {
+        return ETCDLIB_RC_ERROR;
+    }
+
+    loop->streamSize = 0;
+    curl_easy_setopt(loop->watchCurl, CURLOPT_URL, url);
+    free(url);
+    if (curl_multi_add_handle(loop->multi, loop->watchCurl) != CURLM_OK) {
+        return ETCDLIB_RC_ERROR;
+    }
+    loop->watchActive = true;
+    return ETCDLIB_RC_OK;
+}
+
+static void etcdlib_watch_loop_watchDone(etcdlib_watch_loop_t *loop, CURLcode res) {
+    long httpCode = 0;
+    curl_easy_getinfo(loop->watchCurl, CURLINFO_RESPONSE_CODE, &httpCode);
+    if (res == CURLE_OK && loop->streamSize > 0) {
+        //last event (or error) without a newline
+        etcdlib_watch_loop_handleEvent(loop, loop->stream, loop->streamSize);
+    }
+    loop->streamSize = 0;
+
+    if (res == CURLE_OK && httpCode == 200) {
+        //stream ended by etcd, directly restart the watch
+        loop->watchStartTime = 0;
+    } else {
+        if (res != CURLE_OK) {
+            fprintf(stderr, "[ETCDLIB] Watch error for %s: %s\n", loop->key, curl_easy_strerror(res));
+        }
+        loop->watchStartTime = etcdlib_watch_loop_now() + WATCH_LOOP_RETRY_INTERVAL_MS;
+    }
+}
+
+static int etcdlib_watch_loop_startRefresh(etcdlib_watch_loop_t *loop, bool set) {
+    char *url = NULL;
+    char *request = NULL;
+    int rc;
+    if (set) {
+        char *value = curl_easy_escape(loop->refreshCurl, loop->refreshValue, 0);
+        rc = value != NULL ? asprintf(&request, "value=%s&ttl=%d", value, loop->ttl) : -1;
+        curl_free(value);
+    } else {
+        rc = asprintf(&request, "ttl=%d&prevExist=true&refresh=true", loop->ttl);
+    }
+    if (rc < 0) {
+        return ETCDLIB_RC_ERROR;
+    }
+    if (asprintf(&url, "http://%s:%d/v2/keys/%s", loop->etcdlib->host, loop->etcdlib->port, loop->refreshKey) < 0) {
+        free(request);
+        return ETCDLIB_RC_ERROR;
+    }
+
+    //note that curl does not copy the post fields
+    free(loop->refreshRequest);
+    loop->refreshRequest = request;
+    loop->refreshReply.memorySize = 0;
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_URL, url);
+    curl_easy_setopt(loop->refreshCurl, CURLOPT_POSTFIELDS, loop->refreshRequest);
+    free(url);
+    if (curl_multi_add_handle(loop->multi, loop->refreshCurl) != CURLM_OK) {
+        return ETCDLIB_RC_ERROR;
+    }
+    loop->refreshActive = true;
+    loop->refreshIsSet = set;
+    return ETCDLIB_RC_OK;
+}
+
+static void etcdlib_watch_loop_refreshDone(etcdlib_watch_loop_t *loop, CURLcode res) {
+    bool keyNotFound = false;
+    if (res == CURLE_OK && loop->refreshReply.memorySize > 0) {
+        json_error_t error;
+        json_t *root = json_loadb(loop->refreshReply.memory, loop->refreshReply.memorySize, 0, &error);
+        if (root != NULL) {
+            json_t *errorCode = json_object_get(root, ETCD_JSON_ERRORCODE);
+            if (errorCode != NULL && !loop->refreshIsSet &&
+                json_integer_value(errorCode) == ETCD_ERRORCODE_KEY_NOT_FOUND) {
+                keyNotFound = true;
+            } else if (errorCode != NULL) {
+                fprintf(stderr, "[ETCDLIB] errorcode %lli\n", json_integer_value(errorCode));
+            }
+            json_decref(root);
+        } else {
+            fprintf(stderr, "[ETCDLIB] Error: refresh reply for %s is not json\n", loop->refreshKey);
+        }
+    } else if (res != CURLE_OK) {
+        fprintf(stderr, "[ETCDLIB] Refresh error for %s: %s\n", loop->refreshKey, curl_easy_strerror(res));
+    }
+
+    if (!keyNotFound || etcdlib_watch_loop_startRefresh(loop, true) != ETCDLIB_RC_OK) {
+        loop->refreshTime = etcdlib_watch_loop_now() + loop->interval * 1000LL;
+    }
+}
+
+static int etcdlib_watch_loop_pollTimeout(etcdlib_watch_loop_t *loop, long long now) {
+    long long timeout = WATCH_LOOP_MAX_POLL_MS;
+    if (!loop->watchActive && loop->watchStartTime - now < timeout) {
+        timeout = loop->watchStartTime - now;
+    }
+    if (loop->refreshKey != NULL && !loop->refreshActive && loop->refreshTime - now < timeout) {
+        timeout = loop->refreshTime - now;
+    }
+    return timeout > 0 ? (int) timeout : 0;
+}
+
+int etcdlib_watch_loop_run(etcdlib_watch_loop_t *loop) {
+    int retVal = ETCDLIB_RC_OK;
+    while (!__atomic_load_n(&loop->stopped, __ATOMIC_ACQUIRE)) {
+        long long now = etcdlib_watch_loop_now();
+        if (!loop->watchActive && now >= loop->watchStartTime &&
+            etcdlib_watch_loop_startWatch(loop) != ETCDLIB_RC_OK) {
+            loop->watchStartTime = now + WATCH_LOOP_RETRY_INTERVAL_MS;
+        }
+        if (loop->refreshKey != NULL && !loop->refreshActive && now >= loop->refreshTime &&
+            etcdlib_watch_loop_startRefresh(loop, false) != ETCDLIB_RC_OK) {
+            loop->refreshTime = now + loop->interval * 1000LL;
+        }
+
+        int running = 0;
+        CURLMcode mc = curl_multi_perform(loop->multi, &running);
+        if (mc == CURLM_OK) {
+            int msgsLeft;
+            CURLMsg *msg;
+            while ((msg = curl_multi_info_read(loop->multi, &msgsLeft)) != NULL) {
+                if (msg->msg == CURLMSG_DONE) {
+                    CURL *curl = msg->easy_handle;
+                    CURLcode res = msg->data.result;
+                    curl_multi_remove_handle(loop->multi, curl);
+                    if (curl == loop->watchCurl) {
+                        loop->watchActive = false;
+                        etcdlib_watch_loop_watchDone(loop, res);
+                    } else {
+                        loop->refreshActive = false;
+                        etcdlib_watch_loop_refreshDone(loop, res);
+                    }
+                }
+            }
+            mc = curl_multi_poll(loop->multi, NULL, 0, etcdlib_watch_loop_pollTimeout(loop, etcdlib_watch_loop_now()),
+                                 NULL);
+        }
+        if (mc != CURLM_OK) {
+            fprintf(stderr, "[ETCDLIB] Error: watch loop error: %s\n", curl_multi_strerror(mc));
+            retVal = ETCDLIB_RC_ERROR;
+            break;
+        }
+    }
+    return retVal;
+}
+
+void etcdlib_watch_loop_stop(etcdlib_watch_loop_t *loop) {
+    __atomic_store_n(&loop->stopped, true, __ATOMIC_RELEASE);
+    curl_multi_wakeup(loop->multi);
+}
+
 
 static size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp) {
     size_t realsize = size * nmemb;
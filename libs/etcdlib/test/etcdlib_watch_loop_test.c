@@ -0,0 +1,390 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * Test program for the etcdlib watch loop.
+ * Uses a fake etcd (v2 api) http server, so no running etcd is needed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "etcdlib.h"
+
+#define MAX_CONNECTIONS 8
+#define MAX_EVENTS 8
+#define WATCH_KEY "discovery"
+#define REFRESH_KEY "discovery/self"
+#define REFRESH_VALUE "http://127.0.0.1:8888/org.apache.celix.discovery.configured"
+#define EXPECTED_SET_REQUEST "value=http%3A%2F%2F127.0.0.1%3A8888%2Forg.apache.celix.discovery.configured&ttl=10"
+
+typedef struct fake_etcd {
+	int serverSocket;
+	int port;
+	pthread_t acceptThread;
+	pthread_t connectionThreads[MAX_CONNECTIONS];
+	int connectionSockets[MAX_CONNECTIONS];
+	int nrOfConnections;
+
+	pthread_mutex_t mutex;
+	int watchRequests;
+	int watchConnections[MAX_EVENTS];
+	long long watchIndices[MAX_EVENTS];
+	int refreshRequests;
+	int setRequests;
+	char setRequest[256];
+} fake_etcd_t;
+
+typedef struct fake_etcd_connection {
+	fake_etcd_t *etcd;
+	int socket;
+	int id;
+} fake_etcd_connection_t;
+
+typedef struct watch_event {
+	char action[32];
+	char key[64];
+	char value[64];
+	char prevValue[64];
+	long long modifiedIndex;
+} watch_event_t;
+
+static pthread_mutex_t eventsMutex = PTHREAD_MUTEX_INITIALIZER;
+static watch_event_t events[MAX_EVENTS];
+static int nrOfEvents = 0;
+
+static void sendAll(int sock, const char *data, size_t size) {
+	while (size > 0) {
+		ssize_t n = send(sock, data, size, MSG_NOSIGNAL);
+		if (n <= 0) {
+			return;
+		}
+		data += n;
+		size -= n;
+	}
+}
+
+static void sendChunk(int sock, const char *data) {
+	char header[32];
+	snprintf(header, sizeof(header), "%zx\r\n", strlen(data));
+	sendAll(sock, header, strlen(header));
+	sendAll(sock, data, strlen(data));
+	sendAll(sock, "\r\n", 2);
+}
+
+static void sendResponse(int sock, const char *status, const char *body) {
+	char header[256];
+	snprintf(header, sizeof(header), "HTTP/1.1 %s\r\nContent-Type: application/json\r\nX-Etcd-Index: 8\r\n"
+			"Content-Length: %zu\r\n\r\n", status, strlen(body));
+	sendAll(sock, header, strlen(header));
+	sendAll(sock, body, strlen(body));
+}
+
+/**
+ * Reads a single http request. Returns false if the connection is closed.
+ */
+static bool readRequest(int sock, char *request, size_t size, char **body) {
+	size_t len = 0;
+	char *endOfHeader = NULL;
+	while (endOfHeader == NULL) {
+		if (len == size - 1) {
+			return false;
+		}
+		ssize_t n = recv(sock, request + len, size - 1 - len, 0);
+		if (n <= 0) {
+			return false;
+		}
+		len += n;
+		request[len] = '\0';
+		endOfHeader = strstr(request, "\r\n\r\n");
+	}
+	*body = endOfHeader + 4;
+
+	size_t contentLength = 0;
+	char *cl = strcasestr(request, "Content-Length:");
+	if (cl != NULL && cl < endOfHeader) {
+		contentLength = strtoul(cl + strlen("Content-Length:"), NULL, 10);
+	}
+	while (strlen(*body) < contentLength) {
+		ssize_t n = recv(sock, request + len, size - 1 - len, 0);
+		if (n <= 0) {
+			return false;
+		}
+		len += n;
+		request[len] = '\0';
+	}
+	return true;
+}
+
+static void handleWatch(fake_etcd_connection_t *con, const char *url) {
+	fake_etcd_t *etcd = con->etcd;
+	const char *waitIndex = strstr(url, "waitIndex=");
+	pthread_mutex_lock(&etcd->mutex);
+	int watchRequest = etcd->watchRequests++;
+	if (watchRequest < MAX_EVENTS) {
+		etcd->watchConnections[watchRequest] = con->id;
+		etcd->watchIndices[watchRequest] = waitIndex == NULL ? 0 : strtoll(waitIndex + strlen("waitIndex="), NULL, 10);
+	}
+	pthread_mutex_unlock(&etcd->mutex);
+
+	const char *header = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nX-Etcd-Index: 4\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n";
+	sendAll(con->socket, header, strlen(header));
+	if (watchRequest == 0) {
+		//two events in one chunk, followed by an event split over two chunks and the end of the stream
+		sendChunk(con->socket,
+				"{\"action\":\"set\",\"node\":{\"key\":\"/discovery/a\",\"value\":\"valueA\",\"modifiedIndex\":5,\"createdIndex\":5}}\n"
+				"{\"action\":\"set\",\"node\":{\"key\":\"/discovery/b\",\"value\":\"valueB\",\"modifiedIndex\":6,\"createdIndex\":6}}\n");
+		sendChunk(con->socket, "{\"action\":\"update\",\"node\":{\"key\":\"/discovery/a\",\"value\":\"valueA2\",");
+		usleep(50000);
+		sendChunk(con->socket, "\"modifiedIndex\":7,\"createdIndex\":5},"
+				"\"prevNode\":{\"key\":\"/discovery/a\",\"value\":\"valueA\",\"modifiedIndex\":5,\"createdIndex\":5}}\n");
+		sendAll(con->socket, "0\r\n\r\n", 5);
+	} else {
+		sendChunk(con->socket, "{\"action\":\"delete\",\"node\":{\"key\":\"/discovery/b\",\"modifiedIndex\":8,\"createdIndex\":6},"
+				"\"prevNode\":{\"key\":\"/discovery/b\",\"value\":\"valueB\",\"modifiedIndex\":6,\"createdIndex\":6}}\n");
+		//keep the stream open until the client closes the connection
+		char buf[64];
+		while (recv(con->socket, buf, sizeof(buf), 0) > 0) {
+		}
+		shutdown(con->socket, SHUT_RDWR);
+	}
+}
+
+static void handleRefresh(fake_etcd_connection_t *con, const char *body) {
+	fake_etcd_t *etcd = con->etcd;
+	pthread_mutex_lock(&etcd->mutex);
+	bool refresh = strstr(body, "refresh=true") != NULL;
+	int count;
+	if (refresh) {
+		count = etcd->refreshRequests++;
+	} else {
+		count = etcd->setRequests++;
+		snprintf(etcd->setRequest, sizeof(etcd->setRequest), "%s", body);
+	}
+	pthread_mutex_unlock(&etcd->mutex);
+
+	if (refresh && count == 0) {
+		//first refresh: key does not exist yet
+		sendResponse(con->socket, "404 Not Found",
+				"{\"errorCode\":100,\"message\":\"Key not found\",\"cause\":\"/discovery/self\",\"index\":8}\n");
+	} else if (refresh) {
+		sendResponse(con->socket, "200 OK",
+				"{\"action\":\"update\",\"node\":{\"key\":\"/discovery/self\",\"value\":\"" REFRESH_VALUE "\",\"ttl\":10,"
+				"\"modifiedIndex\":9,\"createdIndex\":9}}\n");
+	} else {
+		sendResponse(con->socket, "201 Created",
+				"{\"action\":\"set\",\"node\":{\"key\":\"/discovery/self\",\"value\":\"" REFRESH_VALUE "\",\"ttl\":10,"
+				"\"modifiedIndex\":9,\"createdIndex\":9}}\n");
+	}
+}
+
+static void* fakeEtcd_handleConnection(void *data) {
+	fake_etcd_connection_t *con = data;
+	char request[4096];
+	char *body = NULL;
+	while (readRequest(con->socket, request, sizeof(request), &body)) {
+		char method[16];
+		char url[1024];
+		if (sscanf(request, "%15s %1023s", method, url) != 2) {
+			break;
+		}
+		if (strcmp(method, "GET") == 0 && strncmp(url, "/v2/keys/" WATCH_KEY "?", strlen("/v2/keys/" WATCH_KEY "?")) == 0
+				&& strstr(url, "stream=true") != NULL) {
+			handleWatch(con, url);
+		} else if (strcmp(method, "PUT") == 0 && strcmp(url, "/v2/keys/" REFRESH_KEY) == 0) {
+			handleRefresh(con, body);
+		} else {
+			sendResponse(con->socket, "400 Bad Request", "{\"errorCode\":209,\"message\":\"unexpected request\"}\n");
+		}
+	}
+	free(con);
+	return NULL;
+}
+
+static void* fakeEtcd_accept(void *data) {
+	fake_etcd_t *etcd = data;
+	while (etcd->nrOfConnections < MAX_CONNECTIONS) {
+		int sock = accept(etcd->serverSocket, NULL, NULL);
+		if (sock < 0) {
+			break;
+		}
+		fake_etcd_connection_t *con = calloc(1, sizeof(*con));
+		con->etcd = etcd;
+		con->socket = sock;
+		con->id = etcd->nrOfConnections;
+		etcd->connectionSockets[con->id] = sock;
+		pthread_create(&etcd->connectionThreads[con->id], NULL, fakeEtcd_handleConnection, con);
+		etcd->nrOfConnections++;
+	}
+	return NULL;
+}
+
+static int fakeEtcd_start(fake_etcd_t *etcd) {
+	memset(etcd, 0, sizeof(*etcd));
+	pthread_mutex_init(&etcd->mutex, NULL);
+	etcd->serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	socklen_t addrLen = sizeof(addr);
+	if (etcd->serverSocket < 0 || bind(etcd->serverSocket, (struct sockaddr *) &addr, sizeof(addr)) != 0 ||
+			listen(etcd->serverSocket, MAX_CONNECTIONS) != 0 ||
+			getsockname(etcd->serverSocket, (struct sockaddr *) &addr, &addrLen) != 0) {
+		perror("fake etcd");
+		return -1;
+	}
+	etcd->port = ntohs(addr.sin_port);
+	pthread_create(&etcd->acceptThread, NULL, fakeEtcd_accept, etcd);
+	return 0;
+}
+
+static void fakeEtcd_stop(fake_etcd_t *etcd) {
+	shutdown(etcd->serverSocket, SHUT_RDWR);
+	close(etcd->serverSocket);
+	pthread_join(etcd->acceptThread, NULL);
+	for (int i = 0; i < etcd->nrOfConnections; ++i) {
+		shutdown(etcd->connectionSockets[i], SHUT_RDWR);
+		pthread_join(etcd->connectionThreads[i], NULL);
+		close(etcd->connectionSockets[i]);
+	}
+	pthread_mutex_destroy(&etcd->mutex);
+}
+
+static void watchCallback(const char *action, const char *key, const char *value, const char *prevValue,
+		long long modifiedIndex, void *arg) {
+	pthread_mutex_lock(&eventsMutex);
+	if (nrOfEvents < MAX_EVENTS) {
+		watch_event_t *event = &events[nrOfEvents++];
+		snprintf(event->action, sizeof(event->action), "%s", action);
+		snprintf(event->key, sizeof(event->key), "%s", key != NULL ? key : "(null)");
+		snprintf(event->value, sizeof(event->value), "%s", value != NULL ? value : "(null)");
+		snprintf(event->prevValue, sizeof(event->prevValue), "%s", prevValue != NULL ? prevValue : "(null)");
+		event->modifiedIndex = modifiedIndex;
+	}
+	pthread_mutex_unlock(&eventsMutex);
+}
+
+static void* runLoop(void *data) {
+	etcdlib_watch_loop_t *loop = data;
+	return (void *) (long) etcdlib_watch_loop_run(loop);
+}
+
+static int checkEvent(int i, const char *action, const char *key, const char *value, const char *prevValue,
+		long long modifiedIndex) {
+	watch_event_t *event = &events[i];
+	if (strcmp(event->action, action) != 0 || strcmp(event->key, key) != 0 || strcmp(event->value, value) != 0 ||
+			strcmp(event->prevValue, prevValue) != 0 || event->modifiedIndex != modifiedIndex) {
+		printf("etcdlib watch loop test error: event %i expected %s %s %s %s %lli, got %s %s %s %s %lli\n", i,
+				action, key, value, prevValue, modifiedIndex, event->action, event->key, event->value,
+				event->prevValue, event->modifiedIndex);
+		return -1;
+	}
+	return 0;
+}
+
+static int watchlooptest(void) {
+	int res = 0;
+	fake_etcd_t etcd;
+	if (fakeEtcd_start(&etcd) != 0) {
+		return -1;
+	}
+
+	etcdlib_t *etcdlib = etcdlib_create("127.0.0.1", etcd.port, 0);
+	etcdlib_watch_loop_t *loop = etcdlib_watch_loop_create(etcdlib, WATCH_KEY, 5, watchCallback, NULL);
+	if (loop == NULL || etcdlib_watch_loop_set_refresh(loop, "/" REFRESH_KEY, REFRESH_VALUE, 10, 1) != ETCDLIB_RC_OK) {
+		printf("etcdlib watch loop test error: cannot create watch loop\n");
+		return -1;
+	}
+
+	pthread_t loopThread;
+	pthread_create(&loopThread, NULL, runLoop, loop);
+	bool done = false;
+	for (int i = 0; i < 100 && !done; ++i) {
+		usleep(50000);
+		pthread_mutex_lock(&eventsMutex);
+		pthread_mutex_lock(&etcd.mutex);
+		done = nrOfEvents >= 4 && etcd.refreshRequests >= 2;
+		pthread_mutex_unlock(&etcd.mutex);
+		pthread_mutex_unlock(&eventsMutex);
+	}
+	etcdlib_watch_loop_stop(loop);
+	void *rc = NULL;
+	pthread_join(loopThread, &rc);
+	etcdlib_watch_loop_destroy(loop);
+	fakeEtcd_stop(&etcd);
+	etcdlib_destroy(etcdlib);
+
+	if ((long) rc != ETCDLIB_RC_OK) {
+		printf("etcdlib watch loop test error: watch loop returned %li\n", (long) rc);
+		res = -1;
+	}
+	if (nrOfEvents != 4) {
+		printf("etcdlib watch loop test error: expected 4 events, got %i\n", nrOfEvents);
+		return -1;
+	}
+	res |= checkEvent(0, "set", "/discovery/a", "valueA", "(null)", 5);
+	res |= checkEvent(1, "set", "/discovery/b", "valueB", "(null)", 6);
+	res |= checkEvent(2, "update", "/discovery/a", "valueA2", "valueA", 7);
+	res |= checkEvent(3, "delete", "/discovery/b", "(null)", "valueB", 8);
+
+	//the watch is re-issued after the last received event, on the same connection
+	if (etcd.watchRequests != 2 || etcd.watchIndices[0] != 5 || etcd.watchIndices[1] != 8 ||
+			etcd.watchConnections[0] != etcd.watchConnections[1]) {
+		printf("etcdlib watch loop test error: unexpected watch requests (%i)\n", etcd.watchRequests);
+		res = -1;
+	}
+
+	//the first refresh fails, because the key does not exist, so the key is set
+	if (etcd.refreshRequests < 2 || etcd.setRequests != 1 || strcmp(etcd.setRequest, EXPECTED_SET_REQUEST) != 0) {
+		printf("etcdlib watch loop test error: unexpected refresh requests (%i) / set requests (%i, '%s')\n",
+				etcd.refreshRequests, etcd.setRequests, etcd.setRequest);
+		res = -1;
+	}
+	return res;
+}
+
+static int stopbeforeruntest(void) {
+	etcdlib_t *etcdlib = etcdlib_create("127.0.0.1", 1, 0);
+	etcdlib_watch_loop_t *loop = etcdlib_watch_loop_create(etcdlib, WATCH_KEY, 0, watchCallback, NULL);
+	etcdlib_watch_loop_stop(loop);
+	int rc = etcdlib_watch_loop_run(loop);
+	etcdlib_watch_loop_destroy(loop);
+	etcdlib_destroy(etcdlib);
+	if (rc != ETCDLIB_RC_OK) {
+		printf("etcdlib watch loop test error: expected a stopped loop to return OK, got %i\n", rc);
+		return -1;
+	}
+	return 0;
+}
+
+int main(void) {
+	int res = watchlooptest(); if(res) return res; else printf("watch loop test success\n");
+	res = stopbeforeruntest(); if(res) return res; else printf("stop before run test success\n");
+	return 0;
+}
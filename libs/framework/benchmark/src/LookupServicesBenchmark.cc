@@ -139,6 +139,53 @@ static void createDestroyServiceTracker(benchmark::State& state, bool cTest) {
     state.SetItemsProcessed(state.iterations());
 }
 
+/**
+ * Benchmark to measure concurrent access to the highest ranking service of a C++ service tracker,
+ * with and without lock-free service access.
+ */
+static void useHighestRankingServiceFromTracker(benchmark::State& state, bool lockFree, bool useCallback) {
+    static LookupServicesBenchmark* benchmark = nullptr;
+    static std::shared_ptr<celix::ServiceTracker<IService>> tracker{};
+    if (state.thread_index() == 0) {
+        benchmark = new LookupServicesBenchmark{state.range(0)};
+        auto ctx = benchmark->fw->getFrameworkBundleContext();
+        if (lockFree) {
+            tracker = ctx->trackServices<IService>(IService::NAME).enableLockFreeServiceAccess().build();
+        } else {
+            tracker = ctx->trackServices<IService>(IService::NAME).build();
+        }
+        tracker->wait();
+    }
+
+    if (useCallback) {
+        for (auto _ : state) {
+            // This code gets timed
+            bool called = tracker->useHighestRankingService([](IService& svc) {
+                benchmark::DoNotOptimize(&svc);
+            });
+            if (!called) {
+                state.SkipWithError("no service");
+            }
+        }
+    } else {
+        for (auto _ : state) {
+            // This code gets timed
+            auto svc = tracker->getHighestRankingService();
+            if (!svc) {
+                state.SkipWithError("no service");
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        tracker->close();
+        tracker = nullptr;
+        delete benchmark;
+        benchmark = nullptr;
+    }
+}
+
 static void LookupServicesBenchmark_cFindSingleService(benchmark::State& state) {
     findSingleService(state, true, false);
 }
@@ -163,6 +210,22 @@ static void LookupServicesBenchmark_cxxCreateDestroyTracker(benchmark::State& st
     createDestroyServiceTracker(state, false);
 }
 
+static void LookupServicesBenchmark_cxxGetHighestRankingServiceFromTracker(benchmark::State& state) {
+    useHighestRankingServiceFromTracker(state, false, false);
+}
+
+static void LookupServicesBenchmark_cxxGetHighestRankingServiceFromLockFreeTracker(benchmark::State& state) {
+    useHighestRankingServiceFromTracker(state, true, false);
+}
+
+static void LookupServicesBenchmark_cxxUseHighestRankingServiceFromTracker(benchmark::State& state) {
+    useHighestRankingServiceFromTracker(state, false, true);
+}
+
+static void LookupServicesBenchmark_cxxUseHighestRankingServiceFromLockFreeTracker(benchmark::State& state) {
+    useHighestRankingServiceFromTracker(state, true, true);
+}
+
 #define CELIX_BENCHMARK(name) \
     BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMillisecond)
 
@@ -174,3 +237,11 @@ CELIX_BENCHMARK(LookupServicesBenchmark_cxxFindServiceWithFilter)->RangeMultipli
 
 CELIX_BENCHMARK(LookupServicesBenchmark_cCreateDestroyTracker)->RangeMultiplier(10)->Range(1, 1000);
 CELIX_BENCHMARK(LookupServicesBenchmark_cxxCreateDestroyTracker)->RangeMultiplier(10)->Range(1, 1000);
+
+#define CELIX_TRACKER_READ_BENCHMARK(name) \
+    BENCHMARK(name)->UseRealTime()->Unit(benchmark::kNanosecond)->Arg(10)->ThreadRange(1, 64)
+
+CELIX_TRACKER_READ_BENCHMARK(LookupServicesBenchmark_cxxGetHighestRankingServiceFromTracker);
+CELIX_TRACKER_READ_BENCHMARK(LookupServicesBenchmark_cxxGetHighestRankingServiceFromLockFreeTracker);
+CELIX_TRACKER_READ_BENCHMARK(LookupServicesBenchmark_cxxUseHighestRankingServiceFromTracker);
+CELIX_TRACKER_READ_BENCHMARK(LookupServicesBenchmark_cxxUseHighestRankingServiceFromLockFreeTracker);
@@ -123,6 +123,78 @@ static void registrationTest(benchmark::State& state, bool cTest) {
     state.SetItemsProcessed(state.iterations());
 }
 
+/**
+ * Registers and unregisters a burst of state.range(0) services, either one by one or as a single batch.
+ */
+static void burstRegistrationAndUnregistrationTest(benchmark::State& state, bool batch, int nrOfTrackers) {
+    RegisterServicesBenchmark benchmark{0, nrOfTrackers};
+    auto* cCtx = benchmark.fw->getFrameworkBundleContext()->getCBundleContext();
+    auto svc = std::make_shared<ServiceImpl>();
+    auto burstSize = static_cast<size_t>(state.range(0));
+    std::vector<long> svcIds(burstSize, -1L);
+    std::vector<celix_service_registration_options_t> opts{burstSize};
+    for (auto& opt : opts) {
+        opt.svc = svc.get();
+        opt.serviceName = IService::NAME;
+    }
+
+    for (auto _ : state) {
+        // This code gets timed
+        if (batch) {
+            celix_bundleContext_registerServicesBatch(cCtx, opts.data(), opts.size(), svcIds.data());
+            celix_bundleContext_unregisterServicesBatch(cCtx, svcIds.data(), svcIds.size());
+        } else {
+            for (size_t i = 0; i < burstSize; ++i) {
+                svcIds[i] = celix_bundleContext_registerServiceWithOptions(cCtx, &opts[i]);
+            }
+            for (auto svcId : svcIds) {
+                celix_bundleContext_unregisterService(cCtx, svcId);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Registers and unregisters a service with state.range(0) properties, while 100 trackers keep a copy of the
+ * service properties of the tracked services (as e.g. done by components storing the properties of their
+ * dependencies).
+ */
+static void registrationWithPropertiesTest(benchmark::State& state) {
+    RegisterServicesBenchmark benchmark{0};
+    auto ctx = benchmark.fw->getFrameworkBundleContext();
+    auto svc = std::make_shared<ServiceImpl>();
+    std::vector<std::shared_ptr<celix::GenericServiceTracker>> trackers{};
+    for (int i = 0; i < 100; ++i) {
+        trackers.emplace_back(
+                ctx->trackServices<IService>(IService::NAME)
+                        .addAddWithPropertiesCallback([](const std::shared_ptr<IService>&, const std::shared_ptr<const celix::Properties>& props) {
+                            celix::Properties copy{*props};
+                            benchmark::DoNotOptimize(copy.size());
+                        })
+                        .build());
+    }
+    ctx->waitForEvents();
+
+    celix::Properties props{};
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        props.set("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+
+    for (auto _ : state) {
+        // This code gets timed
+        auto reg = ctx->registerService<IService>(svc, IService::NAME)
+                .setProperties(props)
+                .setRegisterAsync(false)
+                .setUnregisterAsync(false)
+                .build();
+        reg->unregister();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
 static void RegisterServicesBenchmark_cRegistrationAndUnregistration(benchmark::State& state) {
     registrationAndUnregistrationTest(state, true, 0);
 }
@@ -140,6 +212,10 @@ static void RegisterServicesBenchmark_cxxRegistrationAndUnregistrationWith100Tra
     registrationAndUnregistrationTest(state, false, 100);
 }
 
+static void RegisterServicesBenchmark_cxxRegistrationWithPropertiesAnd100CopyingTrackers(benchmark::State& state) {
+    registrationWithPropertiesTest(state);
+}
+
 static void RegisterServicesBenchmark_cRegistration(benchmark::State& state) {
     registrationTest(state, true);
 }
@@ -148,6 +224,14 @@ static void RegisterServicesBenchmark_cxxRegistration(benchmark::State& state) {
     registrationTest(state, false);
 }
 
+static void RegisterServicesBenchmark_cBurstRegistrationAndUnregistration(benchmark::State& state) {
+    burstRegistrationAndUnregistrationTest(state, false, 10);
+}
+
+static void RegisterServicesBenchmark_cBatchRegistrationAndUnregistration(benchmark::State& state) {
+    burstRegistrationAndUnregistrationTest(state, true, 10);
+}
+
 #define CELIX_BENCHMARK(name) \
     BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMillisecond)
 
@@ -158,4 +242,9 @@ CELIX_BENCHMARK(RegisterServicesBenchmark_cRegistrationAndUnregistrationWith100T
 CELIX_BENCHMARK(RegisterServicesBenchmark_cxxRegistrationAndUnregistrationWith100Trackers)->RangeMultiplier(10)->Range(1, 1000);
 
 CELIX_BENCHMARK(RegisterServicesBenchmark_cRegistration)->RangeMultiplier(10)->Range(1, 1000);
-CELIX_BENCHMARK(RegisterServicesBenchmark_cxxRegistration)->RangeMultiplier(10)->Range(1, 1000);
\ No newline at end of file
+CELIX_BENCHMARK(RegisterServicesBenchmark_cxxRegistration)->RangeMultiplier(10)->Range(1, 1000);
+
+CELIX_BENCHMARK(RegisterServicesBenchmark_cBurstRegistrationAndUnregistration)->RangeMultiplier(10)->Range(10, 10000);
+CELIX_BENCHMARK(RegisterServicesBenchmark_cBatchRegistrationAndUnregistration)->RangeMultiplier(10)->Range(10, 10000);
+
+CELIX_BENCHMARK(RegisterServicesBenchmark_cxxRegistrationWithPropertiesAnd100CopyingTrackers)->RangeMultiplier(10)->Range(1, 100);
@@ -22,6 +22,7 @@
 #include "celix/FrameworkFactory.h"
 #include "celix_constants.h"
 #include "celix_file_utils.h"
+#include "celix_bundle_context.h"
 #include "celix_framework_utils.h"
 #include "framework.h"
 #include "bundle_archive.h"
@@ -271,3 +272,55 @@ TEST_F(CxxBundleArchiveTestSuite, BundleArchivesCreatedBeforeStarting) {
     //Then the bundle id will be 1, because the bundle archive is already created
     EXPECT_EQ(bndId, 1); // <-- note whitebox knowledge of the bundle id
 }
+
+TEST_F(CxxBundleArchiveTestSuite, BundleArchivesCreatedConcurrentlyForAutoStartBundles) {
+    //Given a config with multiple bundles configured for start (incl. a duplicate) and install and 4 install threads
+    auto fw = celix::createFramework({
+        {CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true"},
+        {CELIX_AUTO_INSTALL_NR_OF_THREADS, "4"},
+        {CELIX_AUTO_START_0, SIMPLE_TEST_BUNDLE1_LOCATION " " SIMPLE_TEST_BUNDLE2_LOCATION},
+        {CELIX_AUTO_START_1, SIMPLE_TEST_BUNDLE3_LOCATION " " SIMPLE_TEST_BUNDLE1_LOCATION},
+        {CELIX_AUTO_INSTALL, SIMPLE_CXX_BUNDLE_LOC}
+    });
+    auto* ctx = fw->getFrameworkBundleContext()->getCBundleContext();
+
+    //Then the bundle ids are assigned in configured order, the same as when installing bundles one by one
+    EXPECT_EQ(4u, fw->getFrameworkBundleContext()->listBundleIds().size());
+    const char* expectedNames[] = {"simple_test_bundle1", "simple_test_bundle2", "simple_test_bundle3"};
+    for (long bndId = 1; bndId <= 3; ++bndId) {
+        char* name = celix_bundleContext_getBundleSymbolicName(ctx, bndId);
+        EXPECT_STREQ(expectedNames[bndId - 1], name);
+        free(name);
+        //And the auto start bundles are started
+        EXPECT_TRUE(celix_bundleContext_isBundleActive(ctx, bndId));
+    }
+    //And the auto install bundle is installed, but not started
+    EXPECT_FALSE(celix_bundleContext_isBundleActive(ctx, 4));
+    EXPECT_TRUE(celix_bundleContext_isBundleInstalled(ctx, 4));
+}
+
+TEST_F(CxxBundleArchiveTestSuite, BundleIdsInConfiguredOrderIfConcurrentArchiveCreationFails) {
+    //Given a bundle dir without a manifest, so that creating a bundle archive for it fails
+    const char* invalidBundleDir = "bundle_dir_without_manifest";
+    ASSERT_EQ(CELIX_SUCCESS, celix_utils_createDirectory(invalidBundleDir, false, nullptr));
+
+    //When the invalid bundle is configured between other auto start bundles and 4 install threads are used
+    auto fw = celix::createFramework({
+        {CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true"},
+        {CELIX_AUTO_INSTALL_NR_OF_THREADS, "4"},
+        {CELIX_AUTO_START_0, SIMPLE_TEST_BUNDLE1_LOCATION " bundle_dir_without_manifest " SIMPLE_TEST_BUNDLE2_LOCATION
+                             " " SIMPLE_TEST_BUNDLE3_LOCATION}
+    });
+    auto* ctx = fw->getFrameworkBundleContext()->getCBundleContext();
+
+    //Then the bundle ids are the same as when installing bundles one by one, incl. the id used by the failed install
+    EXPECT_EQ(3u, fw->getFrameworkBundleContext()->listBundleIds().size());
+    EXPECT_FALSE(celix_bundleContext_isBundleInstalled(ctx, 2));
+    const char* expectedNames[] = {"simple_test_bundle1", nullptr, "simple_test_bundle2", "simple_test_bundle3"};
+    for (long bndId : {1L, 3L, 4L}) {
+        char* name = celix_bundleContext_getBundleSymbolicName(ctx, bndId);
+        EXPECT_STREQ(expectedNames[bndId - 1], name);
+        free(name);
+    }
+    celix_utils_deleteDirectory(invalidBundleDir, nullptr);
+}
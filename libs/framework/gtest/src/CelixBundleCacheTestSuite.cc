@@ -98,4 +98,43 @@ TEST_F(CelixBundleCacheTestSuite, CreateBundleArchivesCacheTest) {
     EXPECT_TRUE(celix_bundleCache_isBundleIdAlreadyUsed(fw.cache, 1));
     EXPECT_EQ(2, celix_bundleCache_findBundleIdForLocation(fw.cache, SIMPLE_TEST_BUNDLE2_LOCATION));
     EXPECT_TRUE(celix_bundleCache_isBundleIdAlreadyUsed(fw.cache, 2));
-}
\ No newline at end of file
+}
+
+TEST_F(CelixBundleCacheTestSuite, CreateArchivesConcurrentlyTest) {
+    const long ids[] = {1, 2, 3};
+    const char* locations[] = {SIMPLE_TEST_BUNDLE1_LOCATION, SIMPLE_TEST_BUNDLE2_LOCATION, "non-existing.zip"};
+    bundle_archive_t* archives[3] = {nullptr, nullptr, nullptr};
+    EXPECT_NE(CELIX_SUCCESS, celix_bundleCache_createArchives(fw.cache, 3, ids, locations, 3, archives));
+    ASSERT_NE(nullptr, archives[0]);
+    ASSERT_NE(nullptr, archives[1]);
+    EXPECT_EQ(nullptr, archives[2]);
+    EXPECT_EQ(1, celix_bundleArchive_getId(archives[0]));
+    EXPECT_EQ(2, celix_bundleArchive_getId(archives[1]));
+    EXPECT_EQ(1, celix_bundleCache_findBundleIdForLocation(fw.cache, SIMPLE_TEST_BUNDLE1_LOCATION));
+    EXPECT_EQ(2, celix_bundleCache_findBundleIdForLocation(fw.cache, SIMPLE_TEST_BUNDLE2_LOCATION));
+    EXPECT_FALSE(celix_bundleCache_isBundleIdAlreadyUsed(fw.cache, 3));
+    celix_bundleCache_destroyArchive(fw.cache, archives[0]);
+    celix_bundleCache_destroyArchive(fw.cache, archives[1]);
+}
+
+TEST_F(CelixBundleCacheTestSuite, CreateBundleArchivesCacheWithDuplicateLocationsTest) {
+    std::string autoStart = std::string{SIMPLE_TEST_BUNDLE1_LOCATION} + " " + SIMPLE_TEST_BUNDLE2_LOCATION;
+    celix_properties_set(fw.configurationMap, CELIX_AUTO_START_1, autoStart.c_str());
+    celix_properties_set(fw.configurationMap, CELIX_AUTO_START_2, SIMPLE_TEST_BUNDLE1_LOCATION);
+    celix_properties_set(fw.configurationMap, CELIX_AUTO_INSTALL, SIMPLE_TEST_BUNDLE2_LOCATION);
+    EXPECT_EQ(CELIX_SUCCESS, celix_bundleCache_createBundleArchivesCache(&fw, true));
+    EXPECT_EQ(1, celix_bundleCache_findBundleIdForLocation(fw.cache, SIMPLE_TEST_BUNDLE1_LOCATION));
+    EXPECT_EQ(2, celix_bundleCache_findBundleIdForLocation(fw.cache, SIMPLE_TEST_BUNDLE2_LOCATION));
+    EXPECT_FALSE(celix_bundleCache_isBundleIdAlreadyUsed(fw.cache, 3));
+    EXPECT_FALSE(celix_bundleCache_isBundleIdAlreadyUsed(fw.cache, 4));
+}
+
+TEST_F(CelixBundleCacheTestSuite, CreateBundleArchivesCacheWithFailingArchiveTest) {
+    std::string autoStart = std::string{SIMPLE_TEST_BUNDLE1_LOCATION} + " non-existing.zip " + SIMPLE_TEST_BUNDLE2_LOCATION;
+    celix_properties_set(fw.configurationMap, CELIX_AUTO_START_1, autoStart.c_str());
+    EXPECT_NE(CELIX_SUCCESS, celix_bundleCache_createBundleArchivesCache(&fw, true));
+    EXPECT_EQ(1, celix_bundleCache_findBundleIdForLocation(fw.cache, SIMPLE_TEST_BUNDLE1_LOCATION));
+    //note archives after the failed archive are removed again, so no bundle id gaps in the cache
+    EXPECT_EQ(-1, celix_bundleCache_findBundleIdForLocation(fw.cache, SIMPLE_TEST_BUNDLE2_LOCATION));
+    EXPECT_FALSE(celix_bundleCache_isBundleIdAlreadyUsed(fw.cache, 3));
+}
@@ -1741,3 +1741,171 @@ TEST_F(CelixBundleContextServicesTestSuite, SetServicesWithTrackerWhenMultipleRe
     celix_bundleContext_unregisterService(ctx, svcId2);
     celix_bundleContext_unregisterService(ctx, svcId3);
 }
+
+TEST_F(CelixBundleContextServicesTestSuite, RegisterAndUnregisterServicesBatchTest) {
+    std::atomic<int> count{0};
+    celix_service_tracking_options_t trkOpts{};
+    trkOpts.filter.serviceName = "TestService";
+    trkOpts.callbackHandle = &count;
+    trkOpts.add = [](void *handle, void* /*svc*/) {
+        auto* c = static_cast<std::atomic<int>*>(handle);
+        (*c)++;
+    };
+    trkOpts.remove = [](void *handle, void* /*svc*/) {
+        auto* c = static_cast<std::atomic<int>*>(handle);
+        (*c)--;
+    };
+    long trkId = celix_bundleContext_trackServicesWithOptions(ctx, &trkOpts);
+    ASSERT_GE(trkId, 0);
+
+    const size_t nrOfServices = 100;
+    void* dummySvc = (void*)0x42;
+    std::vector<celix_service_registration_options_t> opts{nrOfServices};
+    for (size_t i = 0; i < nrOfServices; ++i) {
+        opts[i].svc = dummySvc;
+        opts[i].serviceName = "TestService";
+        opts[i].properties = celix_properties_create();
+        celix_properties_setLong(opts[i].properties, "index", (long)i);
+    }
+    opts[nrOfServices - 1].svc = nullptr; //invalid registration option
+    celix_properties_destroy(opts[nrOfServices - 1].properties);
+    opts[nrOfServices - 1].properties = nullptr;
+
+    std::vector<long> svcIds(nrOfServices);
+    auto status = celix_bundleContext_registerServicesBatch(ctx, opts.data(), nrOfServices, svcIds.data());
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+    for (size_t i = 0; i + 1 < nrOfServices; ++i) {
+        EXPECT_GE(svcIds[i], 0);
+        EXPECT_TRUE(celix_bundleContext_isServiceRegistered(ctx, svcIds[i]));
+    }
+    EXPECT_EQ(-1, svcIds[nrOfServices - 1]);
+    EXPECT_EQ((int)nrOfServices - 1, count.load());
+
+    //services of a batch are still individually available
+    celix_service_filter_options_t filterOpts{};
+    filterOpts.serviceName = "TestService";
+    filterOpts.filter = "(index=42)";
+    EXPECT_EQ(svcIds[42], celix_bundleContext_findServiceWithOptions(ctx, &filterOpts));
+    celix_bundleContext_unregisterService(ctx, svcIds[42]);
+    EXPECT_EQ((int)nrOfServices - 2, count.load());
+
+    celix_bundleContext_unregisterServicesBatch(ctx, svcIds.data(), nrOfServices); //note svcIds[42] and -1 are ignored
+    EXPECT_EQ(0, count.load());
+    for (size_t i = 0; i + 1 < nrOfServices; ++i) {
+        EXPECT_FALSE(celix_bundleContext_isServiceRegistered(ctx, svcIds[i]));
+    }
+
+    celix_bundleContext_stopTracker(ctx, trkId);
+}
+
+TEST_F(CelixBundleContextServicesTestSuite, ConcurrentUseOfTrackerWhileTrackingTest) {
+    int highestSvc = 1;
+    int otherSvc = 2;
+    celix_service_registration_options_t regOpts{};
+    regOpts.serviceName = "TestService";
+    regOpts.svc = &highestSvc;
+    regOpts.properties = celix_properties_create();
+    celix_properties_setLong(regOpts.properties, CELIX_FRAMEWORK_SERVICE_RANKING, 100);
+    long highestSvcId = celix_bundleContext_registerServiceWithOptions(ctx, &regOpts);
+    ASSERT_GE(highestSvcId, 0);
+
+    celix_service_tracker_t* tracker = celix_serviceTracker_create(ctx, "TestService", nullptr, nullptr);
+    ASSERT_NE(nullptr, tracker);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> wrongHighest{0};
+    std::vector<std::thread> readers{};
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!stop) {
+                bool called = celix_serviceTracker_useHighestRankingService(tracker, "TestService", 0, &wrongHighest, [](void* handle, void* svc) {
+                    if (*static_cast<int*>(svc) != 1) {
+                        static_cast<std::atomic<int>*>(handle)->fetch_add(1);
+                    }
+                }, nullptr, nullptr);
+                EXPECT_TRUE(called);
+                size_t count = celix_serviceTracker_useServices(tracker, "TestService", nullptr, [](void*, void* svc) {
+                    EXPECT_NE(nullptr, svc);
+                }, nullptr, nullptr);
+                EXPECT_GE(count, 1u);
+            }
+        });
+    }
+
+    //register and unregister (lower ranking) services while the tracker is concurrently used.
+    for (int i = 0; i < 100; ++i) {
+        long svcId = celix_bundleContext_registerService(ctx, &otherSvc, "TestService", nullptr);
+        EXPECT_GE(svcId, 0);
+        celix_bundleContext_unregisterService(ctx, svcId);
+    }
+
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(0, wrongHighest.load());
+
+    bool called = celix_serviceTracker_useHighestRankingService(tracker, "OtherServiceName", 0, nullptr, [](void*, void*) {
+        FAIL() << "Service name does not match";
+    }, nullptr, nullptr);
+    EXPECT_FALSE(called);
+
+    celix_serviceTracker_destroy(tracker);
+    celix_bundleContext_unregisterService(ctx, highestSvcId);
+}
+
+TEST_F(CelixBundleContextServicesTestSuite, ConcurrentAddRemoveAndCloseWhileUsingTrackerTest) {
+    //note concurrent adds and removes each replace the tracked services snapshot, so this checks (under ASan/TSan)
+    //that overlapping grace periods never free a snapshot which is still used by a reader.
+    static constexpr int MAGIC = 42;
+    int svcs[8] = {MAGIC, MAGIC, MAGIC, MAGIC, MAGIC, MAGIC, MAGIC, MAGIC};
+    for (int round = 0; round < 10; ++round) {
+        celix_service_tracker_t* tracker = celix_serviceTracker_create(ctx, "TestService", nullptr, nullptr);
+        ASSERT_NE(nullptr, tracker);
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> wrongSvc{0};
+        std::vector<std::thread> readers{};
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&] {
+                while (!stop) {
+                    celix_serviceTracker_useServices(tracker, "TestService", &wrongSvc, [](void* handle, void* svc) {
+                        if (*static_cast<int*>(svc) != MAGIC) {
+                            static_cast<std::atomic<int>*>(handle)->fetch_add(1);
+                        }
+                    }, nullptr, nullptr);
+                    celix_serviceTracker_useHighestRankingService(tracker, "TestService", 0, &wrongSvc, [](void* handle, void* svc) {
+                        if (*static_cast<int*>(svc) != MAGIC) {
+                            static_cast<std::atomic<int>*>(handle)->fetch_add(1);
+                        }
+                    }, nullptr, nullptr);
+                }
+            });
+        }
+
+        std::vector<std::thread> writers{};
+        for (auto& svc : svcs) {
+            writers.emplace_back([&] {
+                for (int i = 0; i < 50; ++i) {
+                    long svcId = celix_bundleContext_registerService(ctx, &svc, "TestService", nullptr);
+                    EXPECT_GE(svcId, 0);
+                    celix_bundleContext_unregisterService(ctx, svcId);
+                }
+            });
+        }
+
+        //close the tracker while services are concurrently added, removed and used
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        serviceTracker_close(tracker);
+
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        EXPECT_EQ(0, wrongSvc.load());
+        celix_serviceTracker_destroy(tracker);
+    }
+}
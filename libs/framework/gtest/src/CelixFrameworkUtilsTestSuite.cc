@@ -117,6 +117,142 @@ TEST_F(CelixFrameworkUtilsTestSuite, ExtractBundlePathTest) {
     celix_utils_deleteDirectory(testExtractDir, nullptr);
 }
 
+TEST_F(CelixFrameworkUtilsTestSuite, ExtractBundleWithSharedBundleCacheTest) {
+    const char* sharedCacheDir = "sharedBundleCacheTestDir";
+    const char* testExtractDir1 = "extractBundleTestDir1";
+    const char* testExtractDir2 = "extractBundleTestDir2";
+    celix_utils_deleteDirectory(sharedCacheDir, nullptr);
+    auto fw = celix::createFramework({
+        {"CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "trace"},
+        {CELIX_FRAMEWORK_SHARED_BUNDLE_CACHE_DIR, sharedCacheDir}
+    });
+
+    //When a bundle is extracted twice
+    auto status = celix_framework_utils_extractBundle(fw->getCFramework(), SIMPLE_TEST_BUNDLE1_LOCATION, testExtractDir1);
+    EXPECT_EQ(status, CELIX_SUCCESS);
+    status = celix_framework_utils_extractBundle(fw->getCFramework(), SIMPLE_TEST_BUNDLE1_LOCATION, testExtractDir2);
+    EXPECT_EQ(status, CELIX_SUCCESS);
+
+    //Then the shared bundle cache contains a single entry
+    int nrOfEntries = 0;
+    DIR* dir = opendir(sharedCacheDir);
+    ASSERT_TRUE(dir != nullptr);
+    for (struct dirent* dent = readdir(dir); dent != nullptr; dent = readdir(dir)) {
+        if (dent->d_name[0] != '.') {
+            nrOfEntries += 1;
+        }
+    }
+    closedir(dir);
+    EXPECT_EQ(1, nrOfEntries);
+
+    //And the extracted manifests are hard links to the same file
+    auto manifest1 = std::string{testExtractDir1} + "/META-INF/MANIFEST.MF";
+    auto manifest2 = std::string{testExtractDir2} + "/META-INF/MANIFEST.MF";
+    struct stat st1{};
+    struct stat st2{};
+    ASSERT_EQ(0, stat(manifest1.c_str(), &st1));
+    ASSERT_EQ(0, stat(manifest2.c_str(), &st2));
+    EXPECT_EQ(st1.st_ino, st2.st_ino);
+    EXPECT_GE(st1.st_nlink, 3u);
+
+    //And deleting an extracted bundle does not affect the other extracted bundle
+    celix_utils_deleteDirectory(testExtractDir1, nullptr);
+    EXPECT_TRUE(celix_utils_fileExists(manifest2.c_str()));
+
+    celix_utils_deleteDirectory(testExtractDir2, nullptr);
+    celix_utils_deleteDirectory(sharedCacheDir, nullptr);
+}
+
+TEST_F(CelixFrameworkUtilsTestSuite, SharedBundleCacheCopiesLibrariesTest) {
+    const char* sharedCacheDir = "sharedBundleCacheLibTestDir";
+    const char* testExtractDir1 = "extractBundleLibTestDir1";
+    const char* testExtractDir2 = "extractBundleLibTestDir2";
+    celix_utils_deleteDirectory(sharedCacheDir, nullptr);
+    auto fw = celix::createFramework({
+        {"CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "trace"},
+        {CELIX_FRAMEWORK_SHARED_BUNDLE_CACHE_DIR, sharedCacheDir}
+    });
+
+    //When a bundle with an activator library is extracted twice
+    auto status = celix_framework_utils_extractBundle(fw->getCFramework(), TEST_BUNDLE_WITH_EXCEPTION_LOCATION, testExtractDir1);
+    EXPECT_EQ(status, CELIX_SUCCESS);
+    status = celix_framework_utils_extractBundle(fw->getCFramework(), TEST_BUNDLE_WITH_EXCEPTION_LOCATION, testExtractDir2);
+    EXPECT_EQ(status, CELIX_SUCCESS);
+
+    //Then the extracted libraries are copies and not hard links, so in-process frameworks never share a library
+    int nrOfLibs = 0;
+    DIR* dir = opendir(testExtractDir1);
+    ASSERT_TRUE(dir != nullptr);
+    for (struct dirent* dent = readdir(dir); dent != nullptr; dent = readdir(dir)) {
+        if (strstr(dent->d_name, ".so") == nullptr && strstr(dent->d_name, ".dylib") == nullptr) {
+            continue;
+        }
+        auto lib1 = std::string{testExtractDir1} + "/" + dent->d_name;
+        auto lib2 = std::string{testExtractDir2} + "/" + dent->d_name;
+        struct stat st1{};
+        struct stat st2{};
+        ASSERT_EQ(0, stat(lib1.c_str(), &st1));
+        ASSERT_EQ(0, stat(lib2.c_str(), &st2));
+        EXPECT_NE(st1.st_ino, st2.st_ino);
+        EXPECT_EQ(st1.st_size, st2.st_size);
+        EXPECT_EQ(1u, st1.st_nlink);
+        nrOfLibs += 1;
+    }
+    closedir(dir);
+    EXPECT_GE(nrOfLibs, 1);
+
+    celix_utils_deleteDirectory(testExtractDir1, nullptr);
+    celix_utils_deleteDirectory(testExtractDir2, nullptr);
+    celix_utils_deleteDirectory(sharedCacheDir, nullptr);
+}
+
+TEST_F(CelixFrameworkUtilsTestSuite, SharedBundleCacheEntryMismatchTest) {
+    const char* sharedCacheDir = "sharedBundleCacheMismatchTestDir";
+    const char* testExtractDir1 = "extractBundleMismatchTestDir1";
+    const char* testExtractDir2 = "extractBundleMismatchTestDir2";
+    celix_utils_deleteDirectory(sharedCacheDir, nullptr);
+    auto fw = celix::createFramework({
+        {"CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "trace"},
+        {CELIX_FRAMEWORK_SHARED_BUNDLE_CACHE_DIR, sharedCacheDir}
+    });
+
+    //Given a shared bundle cache entry for a bundle
+    auto status = celix_framework_utils_extractBundle(fw->getCFramework(), SIMPLE_TEST_BUNDLE1_LOCATION, testExtractDir1);
+    EXPECT_EQ(status, CELIX_SUCCESS);
+    std::string entryZip{};
+    DIR* dir = opendir(sharedCacheDir);
+    ASSERT_TRUE(dir != nullptr);
+    for (struct dirent* dent = readdir(dir); dent != nullptr; dent = readdir(dir)) {
+        if (dent->d_name[0] != '.') {
+            entryZip = std::string{sharedCacheDir} + "/" + dent->d_name + "/bundle.zip";
+        }
+    }
+    closedir(dir);
+    ASSERT_TRUE(celix_utils_fileExists(entryZip.c_str()));
+
+    //When the bundle zip of the entry does not match the bundle zip anymore (e.g. a hash collision)
+    FILE* file = fopen(entryZip.c_str(), "r+");
+    ASSERT_TRUE(file != nullptr);
+    fputs("no zip", file);
+    fclose(file);
+
+    //Then the bundle is extracted without using the shared bundle cache entry
+    status = celix_framework_utils_extractBundle(fw->getCFramework(), SIMPLE_TEST_BUNDLE1_LOCATION, testExtractDir2);
+    EXPECT_EQ(status, CELIX_SUCCESS);
+    auto manifest1 = std::string{testExtractDir1} + "/META-INF/MANIFEST.MF";
+    auto manifest2 = std::string{testExtractDir2} + "/META-INF/MANIFEST.MF";
+    struct stat st1{};
+    struct stat st2{};
+    ASSERT_EQ(0, stat(manifest1.c_str(), &st1));
+    ASSERT_EQ(0, stat(manifest2.c_str(), &st2));
+    EXPECT_NE(st1.st_ino, st2.st_ino);
+    EXPECT_EQ(1u, st2.st_nlink);
+
+    celix_utils_deleteDirectory(testExtractDir1, nullptr);
+    celix_utils_deleteDirectory(testExtractDir2, nullptr);
+    celix_utils_deleteDirectory(sharedCacheDir, nullptr);
+}
+
 TEST_F(CelixFrameworkUtilsTestSuite, ExtractUncompressedBundleTest) {
     const char* testExtractDir = "extractBundleTestDir";
     const char* testLinkDir = "linkBundleTestDir";
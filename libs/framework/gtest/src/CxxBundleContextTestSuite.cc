@@ -215,7 +215,7 @@ TEST_F(CxxBundleContextTestSuite, TrackServicesTest) {
     auto tracker = ctx->trackServices<CInterface>().build();
     tracker->wait();
     EXPECT_TRUE(tracker->isOpen());
-    EXPECT_EQ(0, tracker->getServiceCount());
+    EXPECT_EQ(0u, tracker->getServiceCount());
 
     celix::Properties props{};
     props["key1"] = "value1";
@@ -784,3 +784,130 @@ TEST_F(CxxBundleContextTestSuite, TestOldCStyleTrackerWithCxxMetaTracker) {
     serviceTracker_close(tracker);
     serviceTracker_destroy(tracker);
 }
+
+TEST_F(CxxBundleContextTestSuite, RegisterServicesBatchTest) {
+    std::vector<TestImplementation> impls{10};
+    std::vector<TestImplementation*> svcs{};
+    std::vector<celix::Properties> props{};
+    for (size_t i = 0; i < impls.size(); ++i) {
+        svcs.push_back(&impls[i]);
+        props.emplace_back(celix::Properties{{"index", std::to_string(i)}});
+    }
+
+    auto svcIds = ctx->registerServicesBatch<TestInterface>(svcs, props);
+    ASSERT_EQ(10u, svcIds.size());
+    EXPECT_EQ(10u, ctx->findServices<TestInterface>().size());
+    EXPECT_EQ(svcIds[3], ctx->findService<TestInterface>("(index=3)"));
+
+    ctx->unregisterServicesBatch(svcIds);
+    EXPECT_TRUE(ctx->findServices<TestInterface>().empty());
+
+    EXPECT_ANY_THROW(ctx->registerServicesBatch<TestInterface>(svcs, {celix::Properties{}}));
+}
+
+TEST_F(CxxBundleContextTestSuite, TrackServicesWithLockFreeServiceAccessTest) {
+    auto tracker = ctx->trackServices<CInterface>()
+            .enableLockFreeServiceAccess()
+            .build();
+    EXPECT_TRUE(tracker->isLockFreeServiceAccessEnabled());
+    EXPECT_EQ(nullptr, tracker->getHighestRankingService());
+    EXPECT_FALSE(tracker->useHighestRankingService([](CInterface&) { FAIL() << "Unexpected call"; }));
+
+    auto svc1 = std::make_shared<CInterface>(CInterface{nullptr, nullptr});
+    auto svcReg1 = ctx->registerService<CInterface>(svc1).build();
+    auto svc2 = std::make_shared<CInterface>(CInterface{nullptr, nullptr});
+    auto svcReg2 = ctx->registerService<CInterface>(svc2)
+            .addProperty(celix::SERVICE_RANKING, 100)
+            .build();
+    ctx->waitForEvents();
+
+    auto trackedServices = tracker->getServices();
+    ASSERT_EQ(trackedServices.size(), 2u);
+    EXPECT_EQ(trackedServices[0].get(), svc2.get());
+    EXPECT_EQ(trackedServices[1].get(), svc1.get());
+    trackedServices.clear();
+    EXPECT_EQ(tracker->getHighestRankingService().get(), svc2.get());
+
+    CInterface* used = nullptr;
+    EXPECT_TRUE(tracker->useHighestRankingService([&used](CInterface& svc) { used = &svc; }));
+    EXPECT_EQ(used, svc2.get());
+    EXPECT_EQ(2u, tracker->useServices([](CInterface&) {/*nop*/}));
+
+    //concurrent readers while the tracked services change
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> readers{};
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&tracker, &stop] {
+            while (!stop) {
+                tracker->useHighestRankingService([](CInterface& svc) { EXPECT_EQ(nullptr, svc.handle); });
+                tracker->useServices([](CInterface& svc) { EXPECT_EQ(nullptr, svc.handle); });
+            }
+        });
+    }
+    for (int i = 0; i < 10; ++i) {
+        auto svc = std::make_shared<CInterface>(CInterface{nullptr, nullptr});
+        auto reg = ctx->registerService<CInterface>(svc).build();
+        reg->unregister();
+        reg->wait();
+    }
+    stop = true;
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    svcReg2->unregister();
+    ctx->waitForEvents();
+    EXPECT_EQ(tracker->getHighestRankingService().get(), svc1.get());
+    EXPECT_EQ(1u, tracker->useServices([](CInterface&) {/*nop*/}));
+}
+
+TEST_F(CxxBundleContextTestSuite, UnregisterTrackedServiceInUseCallbackTest) {
+    auto fw = ctx->getFramework();
+    for (bool lockFree : {true, false}) {
+        auto builder = ctx->trackServices<CInterface>();
+        if (lockFree) {
+            builder.enableLockFreeServiceAccess();
+        }
+        auto tracker = builder.build();
+        tracker->wait();
+        auto svc = std::make_shared<CInterface>(CInterface{nullptr, nullptr});
+
+        //When a service is unregistered synchronously from inside a use callback on the event thread
+        auto reg = ctx->registerService<CInterface>(svc).setUnregisterAsync(false).build();
+        ctx->waitForEvents();
+        bool called = false;
+        auto eventId = fw->fireGenericEvent(ctx->getBundleId(), "use and unregister", [&] {
+            called = tracker->useHighestRankingService([&](CInterface&) {
+                reg->unregister();
+                //Then the service is already removed from the tracker
+                EXPECT_EQ(0u, tracker->getServiceCount());
+            });
+        });
+        fw->waitForEvent(eventId);
+        EXPECT_TRUE(called);
+        EXPECT_EQ(nullptr, tracker->getHighestRankingService());
+
+        //When a service is unregistered synchronously from inside a use services callback on the event thread
+        reg = ctx->registerService<CInterface>(svc).setUnregisterAsync(false).build();
+        ctx->waitForEvents();
+        std::size_t count = 0;
+        eventId = fw->fireGenericEvent(ctx->getBundleId(), "use and unregister", [&] {
+            count = tracker->useServices([&](CInterface&) {
+                reg->unregister();
+            });
+        });
+        fw->waitForEvent(eventId);
+        EXPECT_EQ(1u, count);
+        EXPECT_TRUE(tracker->getServices().empty());
+
+        //When a service is unregistered asynchronously from inside a use callback on another thread
+        reg = ctx->registerService<CInterface>(svc).build();
+        ctx->waitForEvents();
+        EXPECT_TRUE(tracker->useHighestRankingService([&reg](CInterface&) {
+            reg->unregister();
+        }));
+        ctx->waitForEvents();
+        //Then the service is removed once the use callback returned
+        EXPECT_EQ(0u, tracker->getServiceCount());
+    }
+}
@@ -21,6 +21,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <thread>
 
 #include "celix/dm/DependencyManager.h"
 #include "celix_framework_factory.h"
@@ -225,6 +226,347 @@ TEST_F(DependencyManagerTestSuite, TestCheckActive) {
     ASSERT_FALSE(celix_dependencyManager_areComponentsActive(mng));
 }
 
+TEST_F(DependencyManagerTestSuite, TestNrOfInactiveComponentsAndAllActiveListener) {
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+    std::atomic<int> allActiveCount{0};
+    long listenerId = celix_dependencyManager_addAllComponentsActiveListener(mng, &allActiveCount, [](void* data) {
+        static_cast<std::atomic<int>*>(data)->fetch_add(1);
+    });
+    EXPECT_GE(listenerId, 0);
+    EXPECT_EQ(0u, celix_dependencyManager_nrOfInactiveComponents(mng));
+
+    auto *cmp = celix_dmComponent_create(ctx, "test1");
+    auto *dep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(dep, "svcname", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(dep, true);
+    celix_dmComponent_addServiceDependency(cmp, dep); //required dep -> cmp not active
+    EXPECT_EQ(0u, celix_dependencyManager_nrOfInactiveComponents(mng)); //not yet added to the dependency manager
+
+    celix_dependencyManager_add(mng, cmp);
+    EXPECT_EQ(1u, celix_dependencyManager_nrOfInactiveComponents(mng));
+    EXPECT_EQ(0, allActiveCount.load());
+
+    //register required service -> last inactive component becomes active
+    void* dummySvc = (void*)0x42;
+    long svcId = celix_bundleContext_registerService(ctx, dummySvc, "svcname", nullptr);
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_EQ(0u, celix_dependencyManager_nrOfInactiveComponents(mng));
+    EXPECT_EQ(1, allActiveCount.load());
+
+    celix_bundleContext_unregisterService(ctx, svcId);
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_EQ(1u, celix_dependencyManager_nrOfInactiveComponents(mng));
+
+    //removing the inactive component -> no inactive components left
+    celix_dependencyManager_remove(mng, cmp);
+    EXPECT_EQ(0u, celix_dependencyManager_nrOfInactiveComponents(mng));
+    EXPECT_EQ(2, allActiveCount.load());
+
+    celix_dependencyManager_removeAllComponentsActiveListener(mng, listenerId);
+}
+
+TEST_F(DependencyManagerTestSuite, TestAllActiveListenerCalledWithoutDependencyManagerLock) {
+    //Given a listener which adds another listener (and therefore needs the dependency manager listener lock)
+    struct ListenerData {
+        celix_dependency_manager_t* mng;
+        std::atomic<long> addedListenerId;
+    };
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+    ListenerData data{mng, -1L};
+    long listenerId = celix_dependencyManager_addAllComponentsActiveListener(mng, &data, [](void* handle) {
+        auto* d = static_cast<ListenerData*>(handle);
+        if (d->addedListenerId.load() < 0) {
+            d->addedListenerId = celix_dependencyManager_addAllComponentsActiveListener(d->mng, nullptr, [](void*) {});
+        }
+    });
+    EXPECT_GE(listenerId, 0);
+
+    //When the last inactive component becomes active
+    auto *cmp = celix_dmComponent_create(ctx, "test1");
+    auto *dep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(dep, "svcname", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(dep, true);
+    celix_dmComponent_addServiceDependency(cmp, dep);
+    celix_dependencyManager_add(mng, cmp);
+    long svcId = celix_bundleContext_registerService(ctx, (void*)0x42, "svcname", nullptr);
+    celix_bundleContext_waitForEvents(ctx);
+
+    //Then the listener is called without the listener lock held and can add a listener
+    EXPECT_GE(data.addedListenerId.load(), 0);
+
+    celix_bundleContext_unregisterService(ctx, svcId);
+    celix_dependencyManager_remove(mng, cmp);
+    celix_dependencyManager_removeAllComponentsActiveListener(mng, data.addedListenerId.load());
+    celix_dependencyManager_removeAllComponentsActiveListener(mng, listenerId);
+}
+
+TEST_F(DependencyManagerTestSuite, CallbacksOnWorkerThreadTest) {
+    struct SlowStartCmp {
+        std::atomic<bool> startCalled{false};
+        std::atomic<bool> releaseStart{false};
+        std::atomic<bool> startOnEventThread{true};
+        celix_framework_t* fw{nullptr};
+    } impl;
+    impl.fw = fw;
+
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+    auto *cmp = celix_dmComponent_create(ctx, "slowStart");
+    celix_dmComponent_setImplementation(cmp, &impl);
+    auto start = [](void* handle) -> int {
+        auto* i = static_cast<SlowStartCmp*>(handle);
+        i->startOnEventThread = celix_framework_isCurrentThreadTheEventLoop(i->fw);
+        i->startCalled = true;
+        while (!i->releaseStart) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return CELIX_SUCCESS;
+    };
+    celix_dmComponent_setCallbacks(cmp, nullptr, start, nullptr, nullptr);
+    celix_dmComponent_setCallbacksOnWorkerThread(cmp, true);
+    void* dummySvc = (void*)0x42;
+    celix_dmComponent_addInterface(cmp, "SlowStartService", nullptr, dummySvc, nullptr);
+    celix_dependencyManager_add(mng, cmp);
+
+    //start callback is blocked on a worker thread, but the event thread is not
+    while (!impl.startCalled) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_FALSE(impl.startOnEventThread.load());
+    EXPECT_EQ(CELIX_DM_CMP_STATE_STARTING, celix_dmComponent_currentState(cmp));
+    EXPECT_EQ(1u, celix_dependencyManager_nrOfInactiveComponents(mng)); //start in progress -> not yet active
+    EXPECT_LT(celix_bundleContext_findService(ctx, "SlowStartService"), 0);
+
+    impl.releaseStart = true;
+    for (int i = 0; i < 1000 && celix_dmComponent_currentState(cmp) != CELIX_DM_CMP_STATE_TRACKING_OPTIONAL; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_EQ(CELIX_DM_CMP_STATE_TRACKING_OPTIONAL, celix_dmComponent_currentState(cmp));
+    EXPECT_EQ(0u, celix_dependencyManager_nrOfInactiveComponents(mng));
+    EXPECT_GE(celix_bundleContext_findService(ctx, "SlowStartService"), 0);
+
+    celix_dependencyManager_remove(mng, cmp);
+}
+
+TEST_F(DependencyManagerTestSuite, InitAndStopCallbacksOnWorkerThreadTest) {
+    struct SlowCmp {
+        std::atomic<int> initCalled{0};
+        std::atomic<int> stopCalled{0};
+        std::atomic<bool> release{false};
+        std::atomic<bool> callbackOnEventThread{false};
+        celix_framework_t* fw{nullptr};
+    } impl;
+    impl.fw = fw;
+
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+    auto *cmp = celix_dmComponent_create(ctx, "slowInitAndStop");
+    celix_dmComponent_setImplementation(cmp, &impl);
+    auto init = [](void* handle) -> int {
+        auto* i = static_cast<SlowCmp*>(handle);
+        i->callbackOnEventThread = i->callbackOnEventThread || celix_framework_isCurrentThreadTheEventLoop(i->fw);
+        i->initCalled += 1;
+        while (!i->release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return CELIX_SUCCESS;
+    };
+    auto stop = [](void* handle) -> int {
+        auto* i = static_cast<SlowCmp*>(handle);
+        i->callbackOnEventThread = i->callbackOnEventThread || celix_framework_isCurrentThreadTheEventLoop(i->fw);
+        i->stopCalled += 1;
+        while (!i->release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return CELIX_SUCCESS;
+    };
+    celix_dmComponent_setCallbacks(cmp, init, nullptr, stop, nullptr);
+    celix_dmComponent_setCallbacksOnWorkerThread(cmp, true);
+    void* dummySvc = (void*)0x42;
+    celix_dmComponent_addInterface(cmp, "SlowService", nullptr, dummySvc, nullptr);
+    celix_dependencyManager_add(mng, cmp);
+
+    //init callback is blocked on a worker thread, but the event thread is not
+    while (impl.initCalled == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_EQ(CELIX_DM_CMP_STATE_INITIALIZING, celix_dmComponent_currentState(cmp));
+    EXPECT_EQ(1u, celix_dependencyManager_nrOfInactiveComponents(mng));
+
+    impl.release = true;
+    for (int i = 0; i < 1000 && celix_dmComponent_currentState(cmp) != CELIX_DM_CMP_STATE_TRACKING_OPTIONAL; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_EQ(CELIX_DM_CMP_STATE_TRACKING_OPTIONAL, celix_dmComponent_currentState(cmp));
+    EXPECT_GE(celix_bundleContext_findService(ctx, "SlowService"), 0);
+
+    //stop callback is blocked on a worker thread, services are already unregistered
+    impl.release = false;
+    std::atomic<bool> removed{false};
+    celix_dependencyManager_removeAsync(mng, cmp, &removed, [](void* data) {
+        static_cast<std::atomic<bool>*>(data)->store(true);
+    });
+    while (impl.stopCalled == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(CELIX_DM_CMP_STATE_STOPPING, celix_dmComponent_currentState(cmp));
+    EXPECT_LT(celix_bundleContext_findService(ctx, "SlowService"), 0);
+
+    impl.release = true;
+    for (int i = 0; i < 1000 && !removed; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_TRUE(removed.load());
+    EXPECT_EQ(1, impl.initCalled.load());
+    EXPECT_EQ(1, impl.stopCalled.load());
+    EXPECT_FALSE(impl.callbackOnEventThread.load());
+}
+
+TEST_F(DependencyManagerTestSuite, DependencyEventsDeferredDuringWorkerThreadCallbacksTest) {
+    struct SlowStartCmp {
+        std::atomic<bool> inStart{false};
+        std::atomic<bool> releaseStart{false};
+        std::atomic<bool> overlappingCallbacks{false};
+        std::atomic<int> addCount{0};
+        std::atomic<int> removeCount{0};
+    } impl;
+
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+    auto *cmp = celix_dmComponent_create(ctx, "slowStart");
+    celix_dmComponent_setImplementation(cmp, &impl);
+    auto start = [](void* handle) -> int {
+        auto* i = static_cast<SlowStartCmp*>(handle);
+        i->inStart = true;
+        while (!i->releaseStart) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        i->inStart = false;
+        return CELIX_SUCCESS;
+    };
+    celix_dmComponent_setCallbacks(cmp, nullptr, start, nullptr, nullptr);
+    celix_dmComponent_setCallbacksOnWorkerThread(cmp, true);
+
+    celix_dm_service_dependency_callback_options_t opts{};
+    opts.add = [](void* handle, void*) -> int {
+        auto* i = static_cast<SlowStartCmp*>(handle);
+        i->overlappingCallbacks = i->overlappingCallbacks || i->inStart;
+        i->addCount += 1;
+        return CELIX_SUCCESS;
+    };
+    opts.remove = [](void* handle, void*) -> int {
+        auto* i = static_cast<SlowStartCmp*>(handle);
+        i->overlappingCallbacks = i->overlappingCallbacks || i->inStart;
+        i->removeCount += 1;
+        return CELIX_SUCCESS;
+    };
+    auto* requiredDep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(requiredDep, "RequiredService", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(requiredDep, true);
+    celix_dmServiceDependency_setCallbacksWithOptions(requiredDep, &opts);
+    celix_dmComponent_addServiceDependency(cmp, requiredDep);
+    auto* optionalDep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(optionalDep, "OptionalService", nullptr, nullptr);
+    celix_dmServiceDependency_setCallbacksWithOptions(optionalDep, &opts);
+    celix_dmComponent_addServiceDependency(cmp, optionalDep);
+
+    void* dummySvc = (void*)0x42;
+    long requiredSvcId = celix_bundleContext_registerService(ctx, dummySvc, "RequiredService", nullptr);
+    celix_dependencyManager_add(mng, cmp);
+    while (!impl.inStart) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(1, impl.addCount.load());
+
+    //an added service is deferred until the start callback is done
+    long optionalSvcId1 = celix_bundleContext_registerService(ctx, dummySvc, "OptionalService", nullptr);
+    EXPECT_EQ(1, impl.addCount.load());
+
+    //a service added and removed during the start callback is never seen by the component
+    long optionalSvcId2 = celix_bundleContext_registerService(ctx, dummySvc, "OptionalService", nullptr);
+    celix_bundleContext_unregisterService(ctx, optionalSvcId2);
+    EXPECT_EQ(1, impl.addCount.load());
+    EXPECT_EQ(0, impl.removeCount.load());
+
+    //removing a required service waits until the start callback is done
+    std::thread unregisterThread{[this, requiredSvcId] {
+        celix_bundleContext_unregisterService(ctx, requiredSvcId);
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_EQ(0, impl.removeCount.load());
+    EXPECT_EQ(CELIX_DM_CMP_STATE_STARTING, celix_dmComponent_currentState(cmp));
+
+    impl.releaseStart = true;
+    unregisterThread.join();
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_FALSE(impl.overlappingCallbacks.load());
+    EXPECT_EQ(2, impl.addCount.load()); //required svc and optional svc 1
+    EXPECT_EQ(1, impl.removeCount.load()); //required svc
+    EXPECT_EQ(CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED, celix_dmComponent_currentState(cmp));
+
+    celix_bundleContext_unregisterService(ctx, optionalSvcId1);
+    celix_dependencyManager_remove(mng, cmp);
+}
+
+TEST_F(DependencyManagerTestSuite, WorkerThreadCallbackDoesNotWaitOnEventThreadTest) {
+    struct SlowStartCmp {
+        std::atomic<bool> inStart{false};
+        std::atomic<bool> removing{false};
+        std::atomic<bool> startReturned{false};
+        std::atomic<long> registeredSvcId{-1};
+        celix_bundle_context_t* ctx{nullptr};
+    } impl;
+    impl.ctx = ctx;
+
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+    auto *cmp = celix_dmComponent_create(ctx, "slowStart");
+    celix_dmComponent_setImplementation(cmp, &impl);
+    auto start = [](void* handle) -> int {
+        auto* i = static_cast<SlowStartCmp*>(handle);
+        i->inStart = true;
+        while (!i->removing) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{20}); //note the event thread now waits for this callback
+        //calls which wait on the event thread do not wait on a dm worker thread
+        celix_bundleContext_waitForEvents(i->ctx);
+        i->registeredSvcId = celix_bundleContext_registerService(i->ctx, (void*)0x42, "WorkerService", nullptr);
+        i->startReturned = true;
+        return CELIX_SUCCESS;
+    };
+    celix_dmComponent_setCallbacks(cmp, nullptr, start, nullptr, nullptr);
+    celix_dmComponent_setCallbacksOnWorkerThread(cmp, true);
+    auto* requiredDep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(requiredDep, "RequiredService", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(requiredDep, true);
+    celix_dmComponent_addServiceDependency(cmp, requiredDep);
+
+    void* dummySvc = (void*)0x42;
+    long requiredSvcId = celix_bundleContext_registerService(ctx, dummySvc, "RequiredService", nullptr);
+    celix_dependencyManager_add(mng, cmp);
+    while (!impl.inStart) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    //When a required service is removed during the start callback, the event thread waits for the start callback
+    std::thread unregisterThread{[this, requiredSvcId] {
+        celix_bundleContext_unregisterService(ctx, requiredSvcId);
+    }};
+    impl.removing = true;
+
+    //Then the start callback - which waits on the event thread - does not deadlock
+    unregisterThread.join();
+    EXPECT_TRUE(impl.startReturned.load());
+    EXPECT_GE(impl.registeredSvcId.load(), 0);
+    celix_bundleContext_waitForEvents(ctx);
+    EXPECT_EQ(impl.registeredSvcId.load(), celix_bundleContext_findService(ctx, "WorkerService"));
+    EXPECT_EQ(CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED, celix_dmComponent_currentState(cmp));
+
+    celix_bundleContext_unregisterService(ctx, impl.registeredSvcId);
+    celix_dependencyManager_remove(mng, cmp);
+}
+
 class TestComponent {
 
 };
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -101,6 +102,66 @@ namespace celix {
             return ServiceRegistrationBuilder<I>{cCtx, std::move(unmanagedSvc), celix::typeName<I>(name), true, false};
         }
 
+        /**
+         * @brief Register a batch of (unmanaged) services in the Celix framework.
+         *
+         * All services are registered in a single call, which is considerable cheaper than registering the services
+         * one by one when a large number of services is registered in a burst (see
+         * celix_bundleContext_registerServicesBatch).
+         *
+         * Same as for registerUnmanagedService, the user is responsible for ensuring that the service pointers are
+         * valid as long as the services are registered in the Celix framework. The services are registered sync and
+         * should be unregistered using unregisterServicesBatch (or celix_bundleContext_unregisterService).
+         *
+         * @tparam I The service type (Note should be the abstract interface, not the interface implementer)
+         * @tparam Implementer The service implementer.
+         * @param services The service implementers.
+         * @param properties The optional service properties. If not empty, the size should match the number of services.
+         * @param name The optional name of the services. If not provided celix::typeName<I> will be used to defer the service name.
+         * @return The service ids of the registered services, in the same order as the provided services.
+         * @throws celix::ServiceRegistrationException if one or more services could not be registered.
+         */
+        template<typename I, typename Implementer>
+        std::vector<long> registerServicesBatch(const std::vector<Implementer*>& services,
+                                                const std::vector<celix::Properties>& properties = {},
+                                                const std::string& name = {}) {
+            if (!properties.empty() && properties.size() != services.size()) {
+                throw celix::ServiceRegistrationException{"Number of service properties does not match the number of services"};
+            }
+            if (std::find(services.begin(), services.end(), nullptr) != services.end()) {
+                throw celix::ServiceRegistrationException{"Cannot register a nullptr service"};
+            }
+            auto svcName = celix::typeName<I>(name);
+            auto svcVersion = celix::typeVersion<I>();
+            std::vector<celix_service_registration_options_t> opts{services.size()};
+            for (size_t i = 0; i < services.size(); ++i) {
+                I* svc = services[i]; //note Implement should be derived from I
+                opts[i].svc = static_cast<void*>(svc);
+                opts[i].serviceName = svcName.c_str();
+                opts[i].properties = properties.empty() ? nullptr : celix_properties_copy(properties[i].getCProperties());
+                if (!svcVersion.empty()) {
+                    opts[i].serviceVersion = svcVersion.c_str();
+                }
+            }
+            std::vector<long> svcIds(services.size(), -1L);
+            auto status = celix_bundleContext_registerServicesBatch(cCtx.get(), opts.data(), opts.size(), svcIds.data());
+            if (status != CELIX_SUCCESS) {
+                unregisterServicesBatch(svcIds);
+                throw celix::ServiceRegistrationException{"Cannot register services batch"};
+            }
+            return svcIds;
+        }
+
+        /**
+         * @brief Unregister a batch of services in the Celix framework.
+         *
+         * The services will only be unregistered if the bundle of this bundle context is the owner of the services.
+         * Service ids < 0 are silently ignored.
+         */
+        void unregisterServicesBatch(const std::vector<long>& svcIds) {
+            celix_bundleContext_unregisterServicesBatch(cCtx.get(), svcIds.data(), svcIds.size());
+        }
+
         //TODO registerServiceFactory<I>()
 
         /**
@@ -206,19 +206,39 @@ namespace celix {
             return *this;
         }
 
+        /**
+         * @brief Enables lock-free service access for the service tracker.
+         *
+         * With lock-free service access the tracked services are published as an immutable snapshot on every
+         * service addition/removal. ServiceTracker::getHighestRankingService, ServiceTracker::getServices,
+         * ServiceTracker::useHighestRankingService and ServiceTracker::useServices then read the snapshot without
+         * locking the tracker, which lets concurrent readers scale with the number of cores.
+         *
+         * This makes service additions/removals more expensive, because a new snapshot is created and the
+         * service addition/removal waits until readers of the previous snapshot are done. The use functions take a
+         * counted copy of the snapshot and call the user function after the snapshot read section.
+         *
+         * @return The ServiceTrackerBuilder reference for chaining (Fluent API).
+         */
+        ServiceTrackerBuilder& enableLockFreeServiceAccess() {
+            lockFreeServiceAccess = true;
+            return *this;
+        }
+
         /**
          * @brief "Builds" the service tracker and returns a ServiceTracker.
          *
          * The ServiceTracker will be started async.
          */
         std::shared_ptr<ServiceTracker<I>> build() {
-            return ServiceTracker<I>::create(cCtx, std::move(name), std::move(versionRange), std::move(filter), std::move(setCallbacks), std::move(addCallbacks), std::move(remCallbacks));
+            return ServiceTracker<I>::create(cCtx, std::move(name), std::move(versionRange), std::move(filter), std::move(setCallbacks), std::move(addCallbacks), std::move(remCallbacks), lockFreeServiceAccess);
         }
     private:
         const std::shared_ptr<celix_bundle_context_t> cCtx;
         std::string name;
         celix::Filter filter{};
         std::string versionRange{};
+        bool lockFreeServiceAccess{false};
         std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> setCallbacks{};
         std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> addCallbacks{};
         std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> remCallbacks{};
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -28,6 +29,7 @@
 #include <unordered_map>
 #include <functional>
 #include <thread>
+#include <vector>
 
 #include "celix_utils.h"
 #include "celix_bundle_context.h"
@@ -52,6 +54,117 @@ namespace celix {
         CLOSED
     };
 
+namespace impl {
+
+    /**
+     * @brief Publishes immutable snapshots which can be read without locking (RCU-style).
+     *
+     * Readers announce themselves in a reader counter of the current phase. The reader counters are striped over
+     * separate cache lines, so that readers on different cores do not contend on a single counter.
+     * A writer publishes a new snapshot, flips the phase twice and waits until the readers of the previous phase
+     * have left. After that no reader can reference the previous snapshot anymore and the publisher releases it.
+     *
+     * Readers can take a counted copy of the snapshot with acquire(), so that the snapshot can be used after the read
+     * section (e.g. to call user code which could trigger a new publish).
+     *
+     * @note Publishing must be serialized by the caller.
+     */
+    template<typename T>
+    class SnapshotPublisher {
+    public:
+        SnapshotPublisher() = default;
+
+        ~SnapshotPublisher() noexcept {
+            delete current.load(std::memory_order_relaxed);
+        }
+
+        SnapshotPublisher(SnapshotPublisher&&) = delete;
+        SnapshotPublisher(const SnapshotPublisher&) = delete;
+        SnapshotPublisher& operator=(SnapshotPublisher&&) = delete;
+        SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+        /**
+         * @brief Calls the provided function with the current snapshot (can be a nullptr).
+         *
+         * The snapshot is only valid during the function call.
+         */
+        template<typename F>
+        auto read(F&& f) const -> decltype(f(static_cast<const T*>(nullptr))) {
+            unsigned int p = phase.load(std::memory_order_seq_cst);
+            ReadGuard guard{readers[p][slotIndex()].count};
+            const Holder* holder = current.load(std::memory_order_seq_cst);
+            return f(holder ? holder->snapshot.get() : nullptr);
+        }
+
+        /**
+         * @brief Returns a counted copy of the current snapshot (can be a nullptr).
+         *
+         * The snapshot stays valid as long as the returned shared ptr is kept, also if a new snapshot is published.
+         */
+        std::shared_ptr<const T> acquire() const {
+            unsigned int p = phase.load(std::memory_order_seq_cst);
+            ReadGuard guard{readers[p][slotIndex()].count};
+            const Holder* holder = current.load(std::memory_order_seq_cst);
+            return holder ? holder->snapshot : std::shared_ptr<const T>{};
+        }
+
+        /**
+         * @brief Publishes a new snapshot and releases the previous snapshot once no reader can reference it anymore.
+         */
+        void publish(std::shared_ptr<const T> snapshot) {
+            const Holder* old = current.exchange(new Holder{std::move(snapshot)}, std::memory_order_seq_cst);
+            for (int i = 0; i < 2; ++i) {
+                unsigned int p = phase.load(std::memory_order_seq_cst);
+                phase.store(p ^ 1u, std::memory_order_seq_cst);
+                for (auto& slot : readers[p]) {
+                    while (slot.count.load(std::memory_order_seq_cst) != 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            delete old;
+        }
+    private:
+        static constexpr std::size_t NR_OF_READER_SLOTS = 16;
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+        struct Holder {
+            std::shared_ptr<const T> snapshot;
+        };
+
+        struct ReaderSlot {
+            std::atomic<unsigned int> count{0};
+            char padding[CACHE_LINE_SIZE - sizeof(std::atomic<unsigned int>)]{};
+        };
+
+        class ReadGuard {
+        public:
+            explicit ReadGuard(std::atomic<unsigned int>& _count) : count{_count} {
+                count.fetch_add(1, std::memory_order_seq_cst);
+            }
+            ~ReadGuard() noexcept {
+                count.fetch_sub(1, std::memory_order_release);
+            }
+            ReadGuard(ReadGuard&&) = delete;
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(ReadGuard&&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+        private:
+            std::atomic<unsigned int>& count;
+        };
+
+        static std::size_t slotIndex() {
+            static thread_local const std::size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % NR_OF_READER_SLOTS;
+            return index;
+        }
+
+        std::atomic<const Holder*> current{nullptr};
+        std::atomic<unsigned int> phase{0};
+        mutable ReaderSlot readers[2][NR_OF_READER_SLOTS]{};
+    };
+
+} //end namespace impl
+
     /**
      * @brief The AbstractTracker class is the base of all C++ Celix trackers.
      *
@@ -232,6 +345,7 @@ namespace celix {
             std::lock_guard<std::mutex> lck{mutex};
             if (state == TrackerState::CLOSED || state == TrackerState::CLOSING) {
                 state = TrackerState::OPENING;
+                opened.store(false, std::memory_order_release);
 
                 //NOTE assuming the opts already configured the callbacks
                 trkId = celix_bundleContext_trackServicesWithOptionsAsync(cCtx.get(), &opts);
@@ -271,6 +385,7 @@ namespace celix {
         const celix::Filter filter;
         celix_service_tracking_options opts{}; //note only set in the ctor
         std::atomic<size_t> svcCount{0};
+        std::atomic<bool> opened{false}; //set when the tracker is OPEN, reset on (re)open
 
     private:
         void setupServiceTrackerOptions() {
@@ -281,6 +396,7 @@ namespace celix {
                     std::lock_guard<std::mutex> callbackLock{trk->mutex};
                     trk->state = TrackerState::OPEN;
                 }
+                trk->opened.store(true, std::memory_order_release);
             };
         }
     };
@@ -309,6 +425,8 @@ namespace celix {
          * @param setCallbacks The callback which is called when a new service needs te be set which matches the trackers filter.
          * @param addCallbacks The callback which is called when a new service is added to the Celix framework which matches the trackers filter.
          * @param remCallbacks The callback which is called when a service is removed from the Celix framework which matches the trackers filter.
+         * @param lockFreeServiceAccess Whether the tracked services are published as immutable snapshot, so that
+         *                              the service access methods do not need to lock the tracker.
          * @return The new service tracker as shared ptr.
          * @throws celix::Exception
          */
@@ -319,7 +437,8 @@ namespace celix {
                 celix::Filter filter,
                 std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> setCallbacks,
                 std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> addCallbacks,
-                std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> remCallbacks) {
+                std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> remCallbacks,
+                bool lockFreeServiceAccess = false) {
             auto tracker = std::shared_ptr<ServiceTracker<I>>{
                 new ServiceTracker<I>{
                     std::move(cCtx),
@@ -328,7 +447,8 @@ namespace celix {
                     std::move(filter),
                     std::move(setCallbacks),
                     std::move(addCallbacks),
-                    std::move(remCallbacks)},
+                    std::move(remCallbacks),
+                    lockFreeServiceAccess},
                 AbstractTracker::delCallback<ServiceTracker<I>>()};
             tracker->open();
             return tracker;
@@ -343,6 +463,12 @@ namespace celix {
          * framework can hangs during service un-registrations.
          */
         std::shared_ptr<I> getHighestRankingService() {
+            if (lockFreeServiceAccess) {
+                waitIfNotOpened();
+                return snapshot.read([](const Snapshot* s) {
+                    return s && !s->empty() ? s->front().svc : std::shared_ptr<I>{};
+                });
+            }
             waitIfAble();
             std::shared_ptr<I> result{};
             std::lock_guard<std::mutex> lck{mutex};
@@ -362,8 +488,20 @@ namespace celix {
          * framework can hangs during service un-registrations.
          */
         std::vector<std::shared_ptr<I>> getServices() {
-            waitIfAble();
             std::vector<std::shared_ptr<I>> result{};
+            if (lockFreeServiceAccess) {
+                waitIfNotOpened();
+                snapshot.read([&result](const Snapshot* s) {
+                    if (s) {
+                        result.reserve(s->size());
+                        for (const auto& e : *s) {
+                            result.push_back(e.svc);
+                        }
+                    }
+                });
+                return result;
+            }
+            waitIfAble();
             std::lock_guard<std::mutex> lck{mutex};
             result.reserve(entries.size());
             for (auto& e : entries) {
@@ -371,6 +509,60 @@ namespace celix {
             }
             return result;
         }
+
+        /**
+         * @brief Calls the provided function with the current highest ranking service tracked by this tracker.
+         *
+         * If lock-free service access is enabled, the service is taken from the published snapshot without locking the
+         * tracker. The function is called outside the tracker lock and snapshot read section, so the function can
+         * (synchronously) unregister the service it uses. A removal of the service on another thread waits until the
+         * function returns.
+         *
+         * @tparam F The function type. Signature should be compatible with std::function<void(I&)>.
+         * @return True if a service was found and the function was called.
+         */
+        template<typename F>
+        bool useHighestRankingService(F&& use) {
+            auto s = acquireSnapshot();
+            if (s && !s->empty()) {
+                UseScope scope{this, s.get()};
+                use(*s->front().svc);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Calls the provided function for all the services tracked by this tracker,
+         * ordered by service ranking (descending, highest ranking service first).
+         *
+         * If lock-free service access is enabled, the services are taken from the published snapshot without locking
+         * the tracker. The functions are called outside the tracker lock and snapshot read section, so a function can
+         * (synchronously) unregister a service it uses. A removal of a service on another thread waits until all
+         * function calls are done.
+         *
+         * @tparam F The function type. Signature should be compatible with std::function<void(I&)>.
+         * @return The number of services for which the function was called.
+         */
+        template<typename F>
+        std::size_t useServices(F&& use) {
+            auto s = acquireSnapshot();
+            if (!s) {
+                return 0;
+            }
+            UseScope scope{this, s.get()};
+            for (const auto& e : *s) {
+                use(*e.svc);
+            }
+            return s->size();
+        }
+
+        /**
+         * @brief Whether the tracked services are published as immutable snapshot for lock-free service access.
+         */
+        bool isLockFreeServiceAccessEnabled() const {
+            return lockFreeServiceAccess;
+        }
     protected:
         struct SvcEntry {
             SvcEntry(long _svcId, long _svcRanking, std::shared_ptr<I> _svc,
@@ -391,14 +583,129 @@ namespace celix {
                        std::string _svcVersionRange, celix::Filter _filter,
                        std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> _setCallbacks,
                        std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> _addCallbacks,
-                       std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> _remCallbacks) :
+                       std::vector<std::function<void(const std::shared_ptr<I>&, const std::shared_ptr<const celix::Properties>&, const std::shared_ptr<const celix::Bundle>&)>> _remCallbacks,
+                       bool _lockFreeServiceAccess = false) :
                 GenericServiceTracker{std::move(_cCtx), std::move(_svcName), std::move(_svcVersionRange), std::move(_filter)},
                 setCallbacks{std::move(_setCallbacks)},
                 addCallbacks{std::move(_addCallbacks)},
-                remCallbacks{std::move(_remCallbacks)} {
+                remCallbacks{std::move(_remCallbacks)},
+                lockFreeServiceAccess{_lockFreeServiceAccess} {
             setupServiceTrackerOptions();
         }
 
+        /**
+         * @brief Snapshot entry with copies of the tracked service, properties and owner shared ptrs.
+         *
+         * A snapshot does not reference the SvcEntry objects, because these are reset when a service is removed.
+         */
+        struct SnapshotEntry {
+            long svcId;
+            std::shared_ptr<I> svc;
+            std::shared_ptr<const celix::Properties> properties;
+            std::shared_ptr<const celix::Bundle> owner;
+        };
+        using Snapshot = std::vector<SnapshotEntry>;
+
+        /**
+         * @brief Publishes the currently tracked services as a new immutable snapshot, if lock-free service access is enabled.
+         *
+         * Returns when the previous snapshot is no longer in use, so that a removed service is no longer
+         * referenced by the snapshot.
+         */
+        void updateSnapshot() {
+            if (!lockFreeServiceAccess) {
+                return;
+            }
+            std::lock_guard<std::mutex> snapshotLck{snapshotMutex};
+            std::shared_ptr<const Snapshot> newSnapshot{};
+            {
+                std::lock_guard<std::mutex> lck{mutex};
+                newSnapshot = createSnapshot();
+            }
+            snapshot.publish(std::move(newSnapshot));
+        }
+
+        /**
+         * @brief Creates a snapshot of the currently tracked services. Should be called with the tracker mutex locked.
+         */
+        std::shared_ptr<const Snapshot> createSnapshot() const {
+            auto result = std::make_shared<Snapshot>();
+            result->reserve(entries.size());
+            for (const auto& entry : entries) {
+                result->push_back(SnapshotEntry{entry->svcId, entry->svc, entry->properties, entry->owner});
+            }
+            return result;
+        }
+
+        /**
+         * @brief Returns a counted snapshot of the tracked services for the use methods.
+         */
+        std::shared_ptr<const Snapshot> acquireSnapshot() {
+            if (lockFreeServiceAccess) {
+                waitIfNotOpened();
+                return snapshot.acquire();
+            }
+            waitIfAble();
+            std::lock_guard<std::mutex> lck{mutex};
+            return createSnapshot();
+        }
+
+        /**
+         * @brief Registers - for the current thread - the snapshot used during a use call.
+         *
+         * A service removal on the same thread (i.e. a use function which unregisters the service it uses) does not
+         * wait for the service references held by the snapshots in use on that thread, because that would never end.
+         */
+        class UseScope {
+        public:
+            UseScope(const ServiceTracker<I>* tracker, const Snapshot* s) {
+                activeUses().emplace_back(tracker, s);
+            }
+            ~UseScope() noexcept {
+                activeUses().pop_back();
+            }
+            UseScope(UseScope&&) = delete;
+            UseScope(const UseScope&) = delete;
+            UseScope& operator=(UseScope&&) = delete;
+            UseScope& operator=(const UseScope&) = delete;
+
+            /**
+             * @brief Returns the number of snapshots in use on the current thread for the tracker which reference
+             * the service with the provided service id.
+             */
+            static long nrOfReferencesOnCurrentThread(const ServiceTracker<I>* tracker, long svcId) {
+                std::vector<const Snapshot*> counted{};
+                for (const auto& use : activeUses()) {
+                    if (use.first != tracker || std::find(counted.begin(), counted.end(), use.second) != counted.end()) {
+                        continue;
+                    }
+                    for (const auto& e : *use.second) {
+                        if (e.svcId == svcId) {
+                            counted.push_back(use.second);
+                            break;
+                        }
+                    }
+                }
+                return static_cast<long>(counted.size());
+            }
+        private:
+            static std::vector<std::pair<const ServiceTracker<I>*, const Snapshot*>>& activeUses() {
+                static thread_local std::vector<std::pair<const ServiceTracker<I>*, const Snapshot*>> uses{};
+                return uses;
+            }
+        };
+
+        /**
+         * @brief Wait (if able) for the tracker to be OPEN or CLOSED, unless the tracker is already opened.
+         *
+         * Prevents locking the tracker state mutex for lock-free service access.
+         */
+        void waitIfNotOpened() const {
+            if (!opened.load(std::memory_order_acquire)) {
+                waitIfAble();
+            }
+        }
+
         static std::shared_ptr<SvcEntry> createEntry(void* voidSvc, const celix_properties_t* cProps, const celix_bundle_t* cBnd) {
             long svcId = celix_properties_getAsLong(cProps, CELIX_FRAMEWORK_SERVICE_ID, -1L);
             long svcRanking = celix_properties_getAsLong(cProps, CELIX_FRAMEWORK_SERVICE_RANKING, 0);
@@ -416,16 +723,21 @@ namespace celix {
                 entry->svc = nullptr;
                 entry->properties = nullptr;
                 entry->owner = nullptr;
-                waitForExpired(svcObserve, entry->svcId, "service");
-                waitForExpired(propsObserve, entry->svcId, "service properties");
-                waitForExpired(ownerObserve, entry->svcId, "service bundle (owner)");
+                long ownRefs = UseScope::nrOfReferencesOnCurrentThread(this, entry->svcId);
+                waitForExpired(svcObserve, entry->svcId, "service", ownRefs);
+                waitForExpired(propsObserve, entry->svcId, "service properties", ownRefs);
+                waitForExpired(ownerObserve, entry->svcId, "service bundle (owner)", ownRefs);
             }
         }
 
+        /**
+         * @brief Waits until the observed object is only referenced by the provided number of own references
+         * (references held by snapshots in use on the current thread).
+         */
         template<typename U>
-        void waitForExpired(std::weak_ptr<U> observe, long svcId, const char* objName) {
+        void waitForExpired(std::weak_ptr<U> observe, long svcId, const char* objName, long ownRefs = 0) {
             auto start = std::chrono::steady_clock::now();
-            while (!observe.expired()) {
+            while (observe.use_count() > ownRefs) {
                 auto now = std::chrono::steady_clock::now();
                 auto durationInMilli = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
                 if (durationInMilli > warningTimoutForNonExpiredSvcObject) {
@@ -501,6 +813,10 @@ namespace celix {
         std::unordered_map<long, std::shared_ptr<SvcEntry>> cachedEntries{};
         std::shared_ptr<SvcEntry> highestRankingServiceEntry{};
 
+        const bool lockFreeServiceAccess;
+        std::mutex snapshotMutex{}; //serializes snapshot updates
+        celix::impl::SnapshotPublisher<Snapshot> snapshot{};
+
     private:
         void setupServiceTrackerOptions() {
             opts.filter.serviceName = svcName.empty() ? nullptr : svcName.c_str();
@@ -515,6 +831,7 @@ namespace celix {
                     tracker->entries.insert(entry);
                     tracker->cachedEntries[entry->svcId] = entry;
                 }
+                tracker->updateSnapshot();
                 tracker->svcCount.fetch_add(1, std::memory_order_relaxed);
                 for (const auto& cb : tracker->addCallbacks) {
                     cb(entry->svc, entry->properties, entry->owner);
@@ -533,6 +850,7 @@ namespace celix {
                     tracker->cachedEntries.erase(it);
                     tracker->entries.erase(entry);
                 }
+                tracker->updateSnapshot();
                 for (const auto& cb : tracker->remCallbacks) {
                     cb(entry->svc, entry->properties, entry->owner);
                 }
@@ -385,6 +385,14 @@ namespace celix { namespace dm {
          */
         Component<T>& removeCallbacks();
 
+        /**
+         * @brief Configure whether the init, start and stop callbacks are called on a dependency manager worker thread.
+         *
+         * @see celix_dmComponent_setCallbacksOnWorkerThread
+         * @return the DM Component reference for chaining (fluent API)
+         */
+        Component<T>& setCallbacksOnWorkerThread(bool onWorkerThread);
+
 
         /**
          * @brief Add context to the component. This can be used to ensure a object lifespan at least
@@ -382,6 +382,12 @@ Component<T>& Component<T>::removeCallbacks() {
     return *this;
 }
 
+template<class T>
+Component<T>& Component<T>::setCallbacksOnWorkerThread(bool onWorkerThread) {
+    celix_dmComponent_setCallbacksOnWorkerThread(this->cComponent(), onWorkerThread);
+    return *this;
+}
+
 template<class T>
 Component<T>& Component<T>::addContext(std::shared_ptr<void> context) {
     std::lock_guard<std::mutex> lock{mutex};
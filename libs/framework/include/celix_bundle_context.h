@@ -235,6 +235,29 @@ CELIX_FRAMEWORK_EXPORT long celix_bundleContext_registerServiceWithOptionsAsync(
  */
 CELIX_FRAMEWORK_EXPORT long celix_bundleContext_registerServiceWithOptions(celix_bundle_context_t *ctx, const celix_service_registration_options_t *opts);
 
+/**
+ * @brief Register a batch of services to the Celix framework using the provided service registration options.
+ *
+ * All services are added to the service registry in one go and the service listeners are called per listener
+ * for all matching services of the batch. This is considerable cheaper than registering the services one by one
+ * when a large number of services is registered in a burst.
+ *
+ * The services are registered synchronously; the async data and callback of the options are ignored.
+ * The ownership of the properties is handled the same as for celix_bundleContext_registerServiceWithOptions.
+ *
+ * @param ctx The bundle context
+ * @param opts Array of registration options. The options are only used during the registration call.
+ * @param nrOfServices The number of registration options.
+ * @param serviceIds Output array (of size nrOfServices) for the service ids. For an invalid registration option
+ *                   the service id will be -1.
+ * @return CELIX_SUCCESS if all services are registered, CELIX_ILLEGAL_ARGUMENT if one or more registration options
+ *         are invalid or CELIX_ENOMEM if the batch could not be registered.
+ */
+CELIX_FRAMEWORK_EXPORT celix_status_t celix_bundleContext_registerServicesBatch(celix_bundle_context_t *ctx,
+                                                                                const celix_service_registration_options_t *opts,
+                                                                                size_t nrOfServices,
+                                                                                long *serviceIds);
+
 /**
  * @brief Waits til the async service registration for the provided serviceId is done.
  *
@@ -266,6 +289,21 @@ CELIX_FRAMEWORK_EXPORT bool celix_bundleContext_isServiceRegistered(celix_bundle
  */
 CELIX_FRAMEWORK_EXPORT void celix_bundleContext_unregisterService(celix_bundle_context_t *ctx, long serviceId);
 
+/**
+ * @brief Unregister a batch of services or service factories.
+ *
+ * The services will only be unregistered if the bundle of the bundle context is the owner of the services.
+ * All services are removed from the service registry in one go and the service listeners are called per listener
+ * for all matching services of the batch.
+ *
+ * Will log an error for every unknown service id. Will silently ignore services ids < 0.
+ *
+ * @param ctx The bundle context
+ * @param serviceIds The service ids
+ * @param nrOfServices The number of service ids
+ */
+CELIX_FRAMEWORK_EXPORT void celix_bundleContext_unregisterServicesBatch(celix_bundle_context_t *ctx, const long *serviceIds, size_t nrOfServices);
+
 /**
  * @brief Service registration guard.
  */
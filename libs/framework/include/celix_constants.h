@@ -268,6 +268,71 @@ extern "C" {
  */
 #define CELIX_AUTO_INSTALL "CELIX_AUTO_INSTALL"
 
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_SHARED_BUNDLE_CACHE_DIR") which configures a
+ * bundle cache directory which can be shared between Celix frameworks (processes).
+ *
+ * If configured, a bundle zip is extracted only once in the shared bundle cache directory, in an entry keyed on the
+ * content hash of the bundle zip. An entry also contains a copy of the bundle zip, which is compared with the bundle
+ * zip before the entry is reused. The bundle archives of a framework are populated with hard links to the files of the
+ * shared entry. If the entry does not match the bundle zip or if hard links cannot be created (e.g. the shared
+ * directory is on a different file system), the bundle zip is extracted in the bundle archive as usual.
+ *
+ * Shared libraries (*.so, *.so.<version> and *.dylib) are always copied into the bundle archive, so frameworks in the
+ * same process never share a bundle library (and its static state): dlopen would return the already loaded library
+ * for a hard link. On file systems with reflink support (e.g. btrfs, xfs) the copy shares the data blocks with the
+ * shared entry. Otherwise only the other bundle files (resources, manifest) save disk space, but the bundle zip is
+ * still not decompressed again.
+ *
+ * Note that extracted bundle files must be treated as read-only, because they are shared between frameworks and
+ * that the shared bundle cache directory is never cleaned by the framework.
+ * Default is not set, which means no shared bundle cache directory is used.
+ */
+#define CELIX_FRAMEWORK_SHARED_BUNDLE_CACHE_DIR "CELIX_FRAMEWORK_SHARED_BUNDLE_CACHE_DIR"
+
+/**
+ * @brief Celix framework environment property (named "CELIX_AUTO_INSTALL_NR_OF_THREADS") which configures the number
+ * of threads used to create the bundle archives (extract the bundle zips and parse the bundle manifests) of the
+ * bundles configured in CELIX_AUTO_START_0 till CELIX_AUTO_START_6 and CELIX_AUTO_INSTALL.
+ *
+ * The bundles are still installed and started in the configured order.
+ * Default is 0, which means the number of online processors (with a maximum of
+ * CELIX_AUTO_INSTALL_MAX_NR_OF_THREADS). A value of 1 creates the bundle archives sequentially.
+ */
+#define CELIX_AUTO_INSTALL_NR_OF_THREADS "CELIX_AUTO_INSTALL_NR_OF_THREADS"
+
+/**
+ * @brief The default value for the CELIX_AUTO_INSTALL_NR_OF_THREADS property.
+ */
+#define CELIX_AUTO_INSTALL_NR_OF_THREADS_DEFAULT 0
+
+/**
+ * @brief The maximum number of threads used to create bundle archives if CELIX_AUTO_INSTALL_NR_OF_THREADS is 0.
+ */
+#define CELIX_AUTO_INSTALL_MAX_NR_OF_THREADS 8
+
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS") which configures the
+ * number of dependency manager worker threads.
+ *
+ * The worker threads are used to call the init, start and stop callbacks of components which are configured to
+ * call their lifecycle callbacks on a worker thread (see celix_dmComponent_setCallbacksOnWorkerThread).
+ * The worker threads are created on first use.
+ * Default is 0, which means the number of online processors (with a maximum of
+ * CELIX_FRAMEWORK_DM_MAX_NR_OF_WORKER_THREADS).
+ */
+#define CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS "CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS"
+
+/**
+ * @brief The default value for the CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS property.
+ */
+#define CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS_DEFAULT 0
+
+/**
+ * @brief The maximum number of dependency manager worker threads if CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS is 0.
+ */
+#define CELIX_FRAMEWORK_DM_MAX_NR_OF_WORKER_THREADS 8
+
 /*!
  * @brief Celix framework environment property (named "CELIX_ALLOWED_PROCESSING_TIME_FOR_SCHEDULED_EVENT_IN_SECONDS")
  * to configure the allowed processing time for a scheduled event callback or a remove callback before a warning
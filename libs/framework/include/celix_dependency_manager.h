@@ -116,6 +116,37 @@ CELIX_FRAMEWORK_EXPORT bool celix_dependencyManager_areComponentsActive(celix_de
  */
 CELIX_FRAMEWORK_EXPORT bool celix_dependencyManager_allComponentsActive(celix_dependency_manager_t *manager);
 
+/**
+ * @brief Return the nr of inactive components - for all bundles.
+ *
+ * The nr of inactive components is maintained on component state transitions, so this does not visit the components.
+ */
+CELIX_FRAMEWORK_EXPORT size_t celix_dependencyManager_nrOfInactiveComponents(celix_dependency_manager_t *manager);
+
+/**
+ * @brief Add a listener which is called when the last inactive component - for all bundles - becomes active
+ * (or is removed).
+ *
+ * The callback is called on the thread performing the component transition (normally the Celix event thread) and
+ * while the component is locked. The callback should therefore return quickly and should not use the dependency
+ * manager. The callback is called without internal dependency manager locks, so the callback can take locks which
+ * are also held while adding a listener.
+ *
+ * @param manager The dependency manager.
+ * @param callbackData The data passed to the callback.
+ * @param callback The callback.
+ * @return The listener id or -1 if the listener could not be added.
+ */
+CELIX_FRAMEWORK_EXPORT long celix_dependencyManager_addAllComponentsActiveListener(celix_dependency_manager_t *manager, void *callbackData, void (*callback)(void *data));
+
+/**
+ * @brief Remove a all components active listener.
+ *
+ * After this call the listener callback will not be called anymore. If the listener callback is in progress, this
+ * call waits until the callback is done; it should therefore not be called from the listener callback itself.
+ */
+CELIX_FRAMEWORK_EXPORT void celix_dependencyManager_removeAllComponentsActiveListener(celix_dependency_manager_t *manager, long listenerId);
+
 /**
  * @brief Return the nr of components for this dependency manager
  */
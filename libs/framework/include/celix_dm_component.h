@@ -187,6 +187,25 @@ CELIX_FRAMEWORK_EXPORT celix_bundle_context_t* celix_dmComponent_getBundleContex
  */
 CELIX_FRAMEWORK_EXPORT celix_status_t celix_dmComponent_setCallbacks(celix_dm_component_t *component, celix_dm_cmp_lifecycle_fpt init, celix_dm_cmp_lifecycle_fpt start, celix_dm_cmp_lifecycle_fpt stop, celix_dm_cmp_lifecycle_fpt deinit);
 
+/**
+ * @brief Configure whether the init, start and stop life cycle callbacks are called on a dependency manager worker
+ * thread instead of the Celix event thread.
+ *
+ * This can be used for components with slow init/start/stop callbacks, so that these do not delay the activation of
+ * other components. The transition is completed on the event thread when the callback returns; until then the
+ * component is not considered active. Service dependency events during such a callback are deferred: added and set
+ * services are handled when the transition is completed and removing a service waits until the callback returns.
+ * As result a life cycle callback running on a worker thread must not wait on the Celix event thread: framework calls
+ * which wait on the event thread (e.g. celix_bundleContext_registerService, celix_bundleContext_stopTracker and
+ * celix_bundleContext_waitForEvents) log an error and return without waiting when called on a dm worker thread.
+ * Use the async variants (e.g. celix_bundleContext_registerServiceAsync) instead.
+ * Note that suspend/resume and the deinit callback are still called on the event thread.
+ *
+ * If no dependency manager worker thread can be used (see CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS) the callbacks are
+ * called on the Celix event thread.
+ */
+CELIX_FRAMEWORK_EXPORT celix_status_t celix_dmComponent_setCallbacksOnWorkerThread(celix_dm_component_t *component, bool onWorkerThread);
+
 /**
  * Set the component life cycle callbacks using a MACRO for improving the type safety.
  */
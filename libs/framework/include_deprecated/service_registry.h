@@ -99,6 +99,31 @@ celix_serviceRegistry_registerServiceFactory(
         long reserveId,
         service_registration_t **registration);
 
+/**
+ * Entry for a batch service registration, see celix_serviceRegistry_registerServices.
+ */
+typedef struct celix_service_registry_batch_entry {
+    const char* serviceName;
+    void* svc;                          //the service, ignored if factory is not NULL
+    celix_service_factory_t* factory;   //the optional service factory
+    celix_properties_t* properties;     //the service properties, the registry takes ownership
+    long svcId;                         //out: the service id of the registered service
+} celix_service_registry_batch_entry_t;
+
+/**
+ * Register multiple services (or service factories) for the provided bundle.
+ *
+ * All registrations are added to the registry under a single lock acquisition and the REGISTERED events are
+ * grouped per service listener: every matching service listener is called for all matching services before the
+ * next service listener is called.
+ * The service ids of the registered services are consecutive and set in the provided entries.
+ */
+CELIX_FRAMEWORK_EXPORT celix_status_t celix_serviceRegistry_registerServices(
+        celix_service_registry_t* reg,
+        const celix_bundle_t* bnd,
+        celix_service_registry_batch_entry_t* entries,
+        size_t nrOfEntries);
+
 /**
  * List the registered service for the provided bundle.
  * @return A list of service ids. Caller is owner of the array list.
@@ -134,6 +159,15 @@ CELIX_FRAMEWORK_EXPORT long celix_serviceRegistry_nextSvcId(celix_service_regist
  */
 CELIX_FRAMEWORK_EXPORT void celix_serviceRegistry_unregisterService(celix_service_registry_t* registry, celix_bundle_t* bnd, long serviceId);
 
+/**
+ * Unregister the services for the provided service ids (owned by bnd).
+ *
+ * The registrations are removed from the registry under a single lock acquisition and the UNREGISTERING events are
+ * grouped per service listener.
+ * Will print an error for every invalid service id.
+ */
+CELIX_FRAMEWORK_EXPORT void celix_serviceRegistry_unregisterServices(celix_service_registry_t* registry, celix_bundle_t* bnd, const long* serviceIds, size_t nrOfServiceIds);
+
 
 /**
  * Create a LDAP filter for the provided filter parts.
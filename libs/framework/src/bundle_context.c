@@ -42,6 +42,8 @@
 #include "service_reference_private.h"
 #include "celix_array_list.h"
 #include "celix_convert_utils.h"
+#include "celix_long_hash_map.h"
+#include "celix_stdlib_cleanup.h"
 
 static celix_status_t bundleContext_bundleChanged(void* listenerSvc, bundle_event_t* event);
 static void bundleContext_cleanupBundleTrackers(bundle_context_t *ct);
@@ -379,16 +381,20 @@ long celix_bundleContext_registerServiceFactory(celix_bundle_context_t *ctx, cel
     return celix_bundleContext_registerServiceWithOptions(ctx, &opts);
 }
 
-static long celix_bundleContext_registerServiceWithOptionsInternal(bundle_context_t *ctx, const celix_service_registration_options_t *opts, bool async) {
+/**
+ * Validates the registration options and creates the service properties for the registration.
+ * Returns NULL if the options are invalid.
+ */
+static celix_properties_t* celix_bundleContext_createServiceProperties(bundle_context_t *ctx, const celix_service_registration_options_t *opts) {
     bool valid = opts->serviceName != NULL && strncmp("", opts->serviceName, 1) != 0;
     if (!valid) {
         fw_log(ctx->framework->logger, CELIX_LOG_LEVEL_ERROR, "Required serviceName argument is NULL or empty");
-        return -1;
+        return NULL;
     }
     valid = opts->svc != NULL || opts->factory != NULL;
     if (!valid) {
         fw_log(ctx->framework->logger, CELIX_LOG_LEVEL_ERROR, "Required svc or factory argument is NULL");
-        return -1;
+        return NULL;
     }
 
     //set properties
@@ -403,16 +409,24 @@ static long celix_bundleContext_registerServiceWithOptionsInternal(bundle_contex
             celix_framework_logTssErrors(ctx->framework->logger, CELIX_LOG_LEVEL_ERROR);
             fw_log(
                 ctx->framework->logger, CELIX_LOG_LEVEL_ERROR, "Cannot parse service version %s", opts->serviceVersion);
-            return -1;
+            return NULL;
         }
         celix_status_t rc =
             celix_properties_setVersionWithoutCopy(props, CELIX_FRAMEWORK_SERVICE_VERSION, celix_steal_ptr(version));
         if (rc != CELIX_SUCCESS) {
             celix_framework_logTssErrors(ctx->framework->logger, CELIX_LOG_LEVEL_ERROR);
             fw_log(ctx->framework->logger, CELIX_LOG_LEVEL_ERROR, "Cannot set service version %s", opts->serviceVersion);
-            return -1;
+            return NULL;
         }
     }
+    return celix_steal_ptr(props);
+}
+
+static long celix_bundleContext_registerServiceWithOptionsInternal(bundle_context_t *ctx, const celix_service_registration_options_t *opts, bool async) {
+    celix_autoptr(celix_properties_t) props = celix_bundleContext_createServiceProperties(ctx, opts);
+    if (props == NULL) {
+        return -1;
+    }
 
     long svcId;
     if (!async && celix_framework_isCurrentThreadTheEventLoop(ctx->framework)) {
@@ -450,6 +464,58 @@ long celix_bundleContext_registerServiceWithOptionsAsync(celix_bundle_context_t
     return celix_bundleContext_registerServiceWithOptionsInternal(ctx, opts, true);
 }
 
+celix_status_t celix_bundleContext_registerServicesBatch(celix_bundle_context_t *ctx,
+                                                        const celix_service_registration_options_t *opts,
+                                                        size_t nrOfServices,
+                                                        long *serviceIds) {
+    if (nrOfServices == 0) {
+        return CELIX_SUCCESS;
+    }
+    celix_autofree celix_service_registry_batch_entry_t* entries = calloc(nrOfServices, sizeof(*entries));
+    celix_autofree size_t* indices = malloc(nrOfServices * sizeof(*indices)); //index of the registration options per entry
+    if (entries == NULL || indices == NULL) {
+        for (size_t i = 0; i < nrOfServices; ++i) {
+            celix_properties_destroy(opts[i].properties);
+            serviceIds[i] = -1L;
+        }
+        fw_log(ctx->framework->logger, CELIX_LOG_LEVEL_ERROR, "Cannot allocate batch for %zu services", nrOfServices);
+        return CELIX_ENOMEM;
+    }
+
+    celix_status_t status = CELIX_SUCCESS;
+    size_t nrOfEntries = 0;
+    for (size_t i = 0; i < nrOfServices; ++i) {
+        serviceIds[i] = -1L;
+        celix_properties_t* props = celix_bundleContext_createServiceProperties(ctx, &opts[i]);
+        if (props == NULL) {
+            status = CELIX_ILLEGAL_ARGUMENT;
+            continue;
+        }
+        entries[nrOfEntries].serviceName = opts[i].serviceName;
+        entries[nrOfEntries].svc = opts[i].svc;
+        entries[nrOfEntries].factory = opts[i].factory;
+        entries[nrOfEntries].properties = props;
+        indices[nrOfEntries] = i;
+        nrOfEntries += 1;
+    }
+    if (nrOfEntries == 0) {
+        return status;
+    }
+
+    celix_status_t rc = celix_framework_registerServices(ctx->framework, ctx->bundle, entries, nrOfEntries);
+    if (rc != CELIX_SUCCESS) {
+        return rc;
+    }
+
+    celixThreadMutex_lock(&ctx->mutex);
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        serviceIds[indices[i]] = entries[i].svcId;
+        celix_arrayList_addLong(ctx->svcRegistrations, entries[i].svcId);
+    }
+    celixThreadMutex_unlock(&ctx->mutex);
+    return status;
+}
+
 void celix_bundleContext_waitForAsyncRegistration(celix_bundle_context_t* ctx, long serviceId) {
     if (serviceId >= 0) {
         celix_framework_waitForAsyncRegistration(ctx->framework, serviceId);
@@ -511,6 +577,52 @@ void celix_bundleContext_unregisterService(bundle_context_t *ctx, long serviceId
     return celix_bundleContext_unregisterServiceInternal(ctx, serviceId, false, NULL, NULL);
 }
 
+void celix_bundleContext_unregisterServicesBatch(celix_bundle_context_t *ctx, const long *serviceIds, size_t nrOfServices) {
+    if (ctx == NULL || nrOfServices == 0) {
+        return;
+    }
+    celix_autoptr(celix_long_hash_map_t) requestedIds = celix_longHashMap_create();
+    for (size_t i = 0; i < nrOfServices; ++i) {
+        if (serviceIds[i] >= 0) {
+            celix_longHashMap_putBool(requestedIds, serviceIds[i], true);
+        }
+    }
+
+    celix_autofree long* found = malloc((celix_longHashMap_size(requestedIds) + 1) * sizeof(*found));
+    size_t nrFound = 0;
+    if (found == NULL) {
+        for (size_t i = 0; i < nrOfServices; ++i) {
+            celix_bundleContext_unregisterService(ctx, serviceIds[i]);
+        }
+        return;
+    }
+
+    //note compact the service registrations in a single pass, instead of a removeAt per service id
+    celix_array_list_t* remaining = celix_arrayList_create();
+    celixThreadMutex_lock(&ctx->mutex);
+    for (int i = 0; i < celix_arrayList_size(ctx->svcRegistrations); ++i) {
+        long entryId = celix_arrayList_getLong(ctx->svcRegistrations, i);
+        if (celix_longHashMap_remove(requestedIds, entryId)) {
+            found[nrFound++] = entryId;
+        } else {
+            celix_arrayList_addLong(remaining, entryId);
+        }
+    }
+    celix_arrayList_destroy(ctx->svcRegistrations);
+    ctx->svcRegistrations = remaining;
+    celixThreadMutex_unlock(&ctx->mutex);
+
+    CELIX_LONG_HASH_MAP_ITERATE(requestedIds, iter) {
+        framework_logIfError(ctx->framework->logger, CELIX_ILLEGAL_ARGUMENT, NULL,
+                             "No service registered with svc id %li for bundle %s (bundle id: %li)!", iter.key,
+                             celix_bundle_getSymbolicName(ctx->bundle), celix_bundle_getId(ctx->bundle));
+    }
+
+    if (nrFound > 0) {
+        celix_framework_unregisterServices(ctx->framework, ctx->bundle, found, nrFound);
+    }
+}
+
 void celix_bundleContext_waitForAsyncUnregistration(celix_bundle_context_t* ctx, long serviceId) {
     if (serviceId >= 0) {
         celix_framework_waitForAsyncUnregistration(ctx->framework, serviceId);
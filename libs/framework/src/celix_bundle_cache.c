@@ -51,11 +51,22 @@ struct celix_bundle_cache {
     bool deleteOnDestroy;
     bool deleteOnCreate;
 
+    celix_thread_rwlock_t dirLock; //read locked while creating archives, write locked while deleting the cache dir
     celix_thread_mutex_t mutex; //protects below and access to the cache dir
     celix_string_hash_map_t* locationToBundleIdLookupMap; //key = location, value = bundle id.
     bool locationToBundleIdLookupMapLoaded; //true if the locationToBundleIdLookupMap is loaded from disk
 };
 
+typedef struct celix_bundle_cache_create_archives_job {
+    celix_bundle_cache_t* cache;
+    size_t nrOfArchives;
+    const long* ids;
+    const char* const* locations;
+    bundle_archive_t** archives;
+    celix_status_t* statuses;
+    size_t nextIndex; //next archive to create, only accessed using atomics
+} celix_bundle_cache_create_archives_job_t;
+
 static const char* bundleCache_progamName() {
 #if defined(__APPLE__) || defined(__FreeBSD__)
     return getprogname();
@@ -106,6 +117,8 @@ celix_status_t celix_bundleCache_create(celix_framework_t* fw, celix_bundle_cach
     }
     celixThreadMutex_create(&cache->mutex, NULL);
     celix_autoptr(celix_thread_mutex_t) mutex = &cache->mutex;
+    celixThreadRwlock_create(&cache->dirLock, NULL);
+    celix_autoptr(celix_thread_rwlock_t) dirLock = &cache->dirLock;
 
     if (useTmpDir) {
         //Using /tmp dir for cache, so that multiple frameworks can be launched
@@ -139,6 +152,7 @@ celix_status_t celix_bundleCache_create(celix_framework_t* fw, celix_bundle_cach
     }
     cache->locationToBundleIdLookupMapLoaded = false;
     celix_steal_ptr(cacheDir);
+    celix_steal_ptr(dirLock);
     celix_steal_ptr(mutex);
     celix_steal_ptr(locationToBundleIdLookupMap);
     *out = celix_steal_ptr(cache);
@@ -153,18 +167,21 @@ celix_status_t celix_bundleCache_destroy(celix_bundle_cache_t* cache) {
     free(cache->cacheDir);
     celix_stringHashMap_destroy(cache->locationToBundleIdLookupMap);
     celixThreadMutex_destroy(&cache->mutex);
+    celixThreadRwlock_destroy(&cache->dirLock);
     free(cache);
     return status;
 }
 
 celix_status_t celix_bundleCache_deleteCacheDir(celix_bundle_cache_t* cache) {
     const char* err = NULL;
+    celixThreadRwlock_writeLock(&cache->dirLock);
     celixThreadMutex_lock(&cache->mutex);
     celix_status_t status = celix_utils_deleteDirectory(cache->cacheDir, &err);
     if (status == CELIX_SUCCESS) {
         celix_stringHashMap_clear(cache->locationToBundleIdLookupMap);
     }
     celixThreadMutex_unlock(&cache->mutex);
+    celixThreadRwlock_unlock(&cache->dirLock);
     if (status != CELIX_SUCCESS) {
         fw_logCode(cache->fw->logger, CELIX_LOG_LEVEL_ERROR, status, "Cannot delete bundle cache directory %s: %s",
                    cache->cacheDir, err);
@@ -181,12 +198,15 @@ celix_bundleCache_createArchive(celix_bundle_cache_t* cache, long id, const char
     char* archiveRoot = celix_utils_writeOrCreateString(archiveRootBuffer, sizeof(archiveRootBuffer),
                                                         CELIX_BUNDLE_ARCHIVE_ROOT_FORMAT, cache->cacheDir, id);
     if (archiveRoot) {
-        celixThreadMutex_lock(&cache->mutex);
+        //note archives use a bundle id specific archive root, so archives can be created concurrently
+        celixThreadRwlock_readLock(&cache->dirLock);
         status = celix_bundleArchive_create(cache->fw, archiveRoot, id, location, &archive);
+        celixThreadRwlock_unlock(&cache->dirLock);
         if (status == CELIX_SUCCESS) {
+            celixThreadMutex_lock(&cache->mutex);
             celix_stringHashMap_put(cache->locationToBundleIdLookupMap, location, (void*) id);
+            celixThreadMutex_unlock(&cache->mutex);
         }
-        celixThreadMutex_unlock(&cache->mutex);
         celix_utils_freeStringIfNotEqual(archiveRootBuffer, archiveRoot);
     } else {
         status = CELIX_ENOMEM;
@@ -199,6 +219,52 @@ celix_bundleCache_createArchive(celix_bundle_cache_t* cache, long id, const char
     return status;
 }
 
+static void* celix_bundleCache_createArchivesWorker(void* data) {
+    celix_bundle_cache_create_archives_job_t* job = data;
+    size_t i = __atomic_fetch_add(&job->nextIndex, 1, __ATOMIC_RELAXED);
+    while (i < job->nrOfArchives) {
+        job->archives[i] = NULL;
+        job->statuses[i] = celix_bundleCache_createArchive(job->cache, job->ids[i], job->locations[i], &job->archives[i]);
+        i = __atomic_fetch_add(&job->nextIndex, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+celix_status_t celix_bundleCache_createArchives(celix_bundle_cache_t* cache,
+                                                size_t nrOfArchives,
+                                                const long* ids,
+                                                const char* const* locations,
+                                                size_t nrOfThreads,
+                                                bundle_archive_t** archivesOut) {
+    celix_autofree celix_status_t* statuses = calloc(nrOfArchives > 0 ? nrOfArchives : 1, sizeof(*statuses));
+    celix_autofree celix_thread_t* threads = calloc(nrOfThreads > 1 ? nrOfThreads - 1 : 1, sizeof(*threads));
+    if (!statuses || !threads) {
+        return CELIX_ENOMEM;
+    }
+    celix_bundle_cache_create_archives_job_t job = {cache, nrOfArchives, ids, locations, archivesOut, statuses, 0};
+
+    //note the calling thread also creates archives
+    size_t nrOfWorkers = 0;
+    for (size_t i = 0; i + 1 < nrOfThreads && i + 1 < nrOfArchives; ++i) {
+        if (celixThread_create(&threads[nrOfWorkers], NULL, celix_bundleCache_createArchivesWorker, &job) ==
+            CELIX_SUCCESS) {
+            celixThread_setName(&threads[nrOfWorkers], "CelixBndCache");
+            nrOfWorkers += 1;
+        }
+    }
+    celix_bundleCache_createArchivesWorker(&job);
+    for (size_t i = 0; i < nrOfWorkers; ++i) {
+        celixThread_join(threads[i], NULL);
+    }
+
+    for (size_t i = 0; i < nrOfArchives; ++i) {
+        if (statuses[i] != CELIX_SUCCESS) {
+            return statuses[i];
+        }
+    }
+    return CELIX_SUCCESS;
+}
+
 celix_status_t celix_bundleCache_createSystemArchive(celix_framework_t* fw, bundle_archive_pt* archive) {
     return celix_bundleCache_createArchive(fw->cache, CELIX_FRAMEWORK_BUNDLE_ID, NULL, archive);
 }
@@ -278,35 +344,32 @@ bool celix_bundleCache_isBundleIdAlreadyUsed(celix_bundle_cache_t* cache, long b
 }
 
 
+/**
+ * Adds the locations of the space separated list, which are not already added, to the locations list.
+ */
 static celix_status_t
-celix_bundleCache_createBundleArchivesForSpaceSeparatedList(celix_framework_t* fw, long* bndId, const char* list,
-                                                            bool logProgress) {
-    celix_status_t status = CELIX_SUCCESS;
+celix_bundleCache_addLocationsForSpaceSeparatedList(celix_framework_t* fw, const char* list,
+                                                    celix_array_list_t* locations, celix_string_hash_map_t* added) {
     char delims[] = " ";
     char* savePtr = NULL;
     char zipFileListBuffer[CELIX_DEFAULT_STRING_CREATE_BUFFER_SIZE];
     char* zipFileList = celix_utils_writeOrCreateString(zipFileListBuffer, sizeof(zipFileListBuffer), "%s", list);
-    if (zipFileList) {
-        char* location = strtok_r(zipFileList, delims, &savePtr);
-        while (location != NULL) {
-            bundle_archive_t* archive = NULL;
-            status = celix_bundleCache_createArchive(fw->cache, (*bndId)++, location, &archive);
+    if (!zipFileList) {
+        fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, CELIX_ENOMEM, "Failed to create zip file list.");
+        return CELIX_ENOMEM;
+    }
+    celix_status_t status = CELIX_SUCCESS;
+    char* location = strtok_r(zipFileList, delims, &savePtr);
+    while (status == CELIX_SUCCESS && location != NULL) {
+        if (!celix_stringHashMap_hasKey(added, location)) {
+            char* loc = celix_utils_strdup(location);
+            status = loc ? celix_arrayList_add(locations, loc) : CELIX_ENOMEM;
             if (status != CELIX_SUCCESS) {
-                fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, status,
-                           "Cannot create bundle archive for %s", location);
-                break;
-            } else {
-                celix_log_level_e lvl = logProgress ? CELIX_LOG_LEVEL_INFO : CELIX_LOG_LEVEL_DEBUG;
-                fw_log(fw->logger, lvl, "Created bundle cache '%s' for bundle archive %s (bndId=%li).",
-                       celix_bundleArchive_getCurrentRevisionRoot(archive),
-                       celix_bundleArchive_getSymbolicName(archive), celix_bundleArchive_getId(archive));
-                bundleArchive_destroy(archive);
+                free(loc);
             }
-            location = strtok_r(NULL, delims, &savePtr);
+            status = CELIX_DO_IF(status, celix_stringHashMap_put(added, location, NULL));
         }
-    } else {
-        status = CELIX_ENOMEM;
-        fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, status, "Failed to create zip file list.");
+        location = strtok_r(NULL, delims, &savePtr);
     }
     celix_utils_freeStringIfNotEqual(zipFileListBuffer, zipFileList);
     return status;
@@ -316,8 +379,10 @@ celix_status_t celix_bundleCache_createBundleArchivesCache(celix_framework_t* fw
     celix_status_t status = CELIX_SUCCESS;
 
     const char* const celixKeys[] = {CELIX_AUTO_START_0, CELIX_AUTO_START_1, CELIX_AUTO_START_2, CELIX_AUTO_START_3,
-                                     CELIX_AUTO_START_4, CELIX_AUTO_START_5, CELIX_AUTO_START_6, NULL};
+                                     CELIX_AUTO_START_4, CELIX_AUTO_START_5, CELIX_AUTO_START_6, CELIX_AUTO_INSTALL,
+                                     NULL};
     long bndId = CELIX_FRAMEWORK_BUNDLE_ID + 1; //note cleaning cache, so starting bundle id at 1
+    celix_log_level_e lvl = logProgress ? CELIX_LOG_LEVEL_INFO : CELIX_LOG_LEVEL_DEBUG;
 
     const char* errorStr = NULL;
     status = celix_utils_deleteDirectory(fw->cache->cacheDir, &errorStr);
@@ -326,29 +391,62 @@ celix_status_t celix_bundleCache_createBundleArchivesCache(celix_framework_t* fw
                    fw->cache->cacheDir, errorStr);
         return status;
     } else {
-        celix_log_level_e lvl = logProgress ? CELIX_LOG_LEVEL_INFO : CELIX_LOG_LEVEL_DEBUG;
         fw_log(fw->logger, lvl, "Deleted bundle cache directory %s", fw->cache->cacheDir);
     }
 
+    celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = free;
+    celix_autoptr(celix_array_list_t) locations = celix_arrayList_createWithOptions(&opts);
+    celix_autoptr(celix_string_hash_map_t) added = celix_stringHashMap_create();
+    if (!locations || !added) {
+        return CELIX_ENOMEM;
+    }
     for (int i = 0; celixKeys[i] != NULL; ++i) {
-        const char* autoStart = celix_framework_getConfigProperty(fw, celixKeys[i], NULL, NULL);
-        if (autoStart) {
-            status = celix_bundleCache_createBundleArchivesForSpaceSeparatedList(fw, &bndId, autoStart, logProgress);
+        const char* list = celix_framework_getConfigProperty(fw, celixKeys[i], NULL, NULL);
+        if (list) {
+            status = celix_bundleCache_addLocationsForSpaceSeparatedList(fw, list, locations, added);
             if (status != CELIX_SUCCESS) {
                 fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, status,
-                           "Failed to create bundle archives for auto start list %s", autoStart);
+                           "Failed to create bundle archives for %s list %s", celixKeys[i], list);
                 return status;
             }
         }
     }
-    const char* autoInstall = celix_framework_getConfigProperty(fw, CELIX_AUTO_INSTALL, NULL, NULL);
-    if (autoInstall) {
-        status = celix_bundleCache_createBundleArchivesForSpaceSeparatedList(fw, &bndId, autoInstall, logProgress);
-        if (status != CELIX_SUCCESS) {
-            fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, status,
-                       "Failed to create bundle archives for auto install list %s", autoInstall);
-            return status;
+
+    size_t nrOfArchives = celix_arrayList_size(locations);
+    celix_autofree long* ids = calloc(nrOfArchives + 1, sizeof(*ids));
+    celix_autofree const char** locs = calloc(nrOfArchives + 1, sizeof(*locs));
+    celix_autofree bundle_archive_t** archives = calloc(nrOfArchives + 1, sizeof(*archives));
+    if (!ids || !locs || !archives) {
+        return CELIX_ENOMEM;
+    }
+    for (size_t i = 0; i < nrOfArchives; ++i) {
+        ids[i] = bndId++;
+        locs[i] = celix_arrayList_get(locations, (int)i);
+    }
+
+    struct timespec start = celix_gettime(CLOCK_MONOTONIC);
+    status = celix_bundleCache_createArchives(fw->cache, nrOfArchives, ids, locs,
+                                              celix_framework_getNrOfAutoInstallThreads(fw), archives);
+    //note archives after the first archive which could not be created are removed again, so that the bundle ids in
+    //the cache have no gaps and the result is the same as creating the archives one by one.
+    bool failed = false;
+    for (size_t i = 0; i < nrOfArchives; ++i) {
+        bundle_archive_t* archive = archives[i];
+        if (archive && !failed) {
+            fw_log(fw->logger, lvl, "Created bundle cache '%s' for bundle archive %s (bndId=%li).",
+                   celix_bundleArchive_getCurrentRevisionRoot(archive),
+                   celix_bundleArchive_getSymbolicName(archive), celix_bundleArchive_getId(archive));
+            bundleArchive_destroy(archive);
+        } else if (archive) {
+            celix_bundleArchive_invalidate(archive);
+            celix_bundleCache_destroyArchive(fw->cache, archive);
+        } else if (!failed) {
+            fw_log(fw->logger, CELIX_LOG_LEVEL_ERROR, "Cannot create bundle archive for %s", locs[i]);
+            failed = true;
         }
     }
+    fw_log(fw->logger, lvl, "Created %zu bundle archives in %.3f ms", nrOfArchives,
+           celix_elapsedtime(CLOCK_MONOTONIC, start) * 1000.0);
     return status;
 }
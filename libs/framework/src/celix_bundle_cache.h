@@ -76,6 +76,30 @@ celix_status_t celix_bundleCache_destroy(celix_bundle_cache_t* cache);
 celix_status_t
 celix_bundleCache_createArchive(celix_bundle_cache_t* cache, long id, const char* location, bundle_archive_pt* archive);
 
+/**
+ * @brief Creates new archives for the given bundles concurrently.
+ *
+ * Extracting the bundle zips and parsing the bundle manifests is done on up to nrOfThreads threads (incl. the calling
+ * thread). The created archives are returned in the order of the provided bundles.
+ * The locations (and ids) must be unique; the location -> bundle id lookup of the cache is updated concurrently.
+ *
+ * @param[in] cache The bundle cache to create the archives in.
+ * @param[in] nrOfArchives The number of archives to create.
+ * @param[in] ids The bundle ids of the archives to create.
+ * @param[in] locations The location identifiers of the archives to create.
+ * @param[in] nrOfThreads The maximum number of threads to use.
+ * @param[out] archivesOut Array of nrOfArchives entries to store the created archives in. Entries of archives which
+ *                         could not be created are set to NULL.
+ * @return CELIX_SUCCESS if all archives are created, otherwise the status of the first archive which could not be
+ * created or CELIX_ENOMEM.
+ */
+celix_status_t celix_bundleCache_createArchives(celix_bundle_cache_t* cache,
+                                                size_t nrOfArchives,
+                                                const long* ids,
+                                                const char* const* locations,
+                                                size_t nrOfThreads,
+                                                bundle_archive_t** archivesOut);
+
 /**
  * @@brief Creates a new system archive for framework bundle.
  * @param[in] fw The Celix framework to create an archive in
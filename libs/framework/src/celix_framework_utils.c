@@ -21,12 +21,22 @@
 #include "celix_framework_utils_private.h"
 
 #include <assert.h>
+#include <dirent.h>
 #include <dlfcn.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
 
 #include "bundle_archive.h"
 #include "celix_bundle_context.h"
@@ -34,6 +44,7 @@
 #include "celix_file_utils.h"
 #include "celix_log.h"
 #include "celix_properties.h"
+#include "celix_stdlib_cleanup.h"
 #include "celix_utils.h"
 #include "framework_private.h"
 
@@ -44,6 +55,12 @@ static const char * const EMBEDDED_BUNDLE_PREFIX = "celix_embedded_bundle_";
 static const char * const EMBEDDED_BUNDLE_START_POSTFIX = "_start";
 static const char * const EMBEDDED_BUNDLE_END_POSTFIX = "_end";
 
+#define FNV1A_64_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV1A_64_PRIME 0x100000001b3ULL
+#define FILE_READ_BUFFER_SIZE (64 * 1024)
+#define SHARED_BUNDLE_CACHE_ZIP_NAME "bundle.zip"
+#define SHARED_BUNDLE_CACHE_CONTENT_DIR "content"
+
 #define FW_LOG(level, ...) do {                                                                                                 \
     if (fw) {                                                                                                                   \
         celix_framework_log(fw->logger, (level), __FUNCTION__ , __FILE__, __LINE__, __VA_ARGS__);                               \
@@ -187,6 +204,333 @@ bool celix_framework_utils_isBundleUrlNewerThan(celix_framework_t* fw, const cha
     return newer;
 }
 
+/**
+ * @brief Calculates a 64-bit FNV-1a hash of the file content.
+ */
+static celix_status_t celix_framework_utils_hashFile(const char* path, uint64_t* hashOut, off_t* sizeOut) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    unsigned char* buffer = malloc(FILE_READ_BUFFER_SIZE);
+    if (buffer == NULL) {
+        close(fd);
+        return CELIX_ENOMEM;
+    }
+    celix_status_t status = CELIX_SUCCESS;
+    uint64_t hash = FNV1A_64_OFFSET_BASIS;
+    off_t size = 0;
+    ssize_t n;
+    while ((n = read(fd, buffer, FILE_READ_BUFFER_SIZE)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+            break;
+        }
+        for (ssize_t i = 0; i < n; ++i) {
+            hash = (hash ^ buffer[i]) * FNV1A_64_PRIME;
+        }
+        size += n;
+    }
+    free(buffer);
+    close(fd);
+    *hashOut = hash;
+    *sizeOut = size;
+    return status;
+}
+
+/**
+ * @brief Reads up to size bytes, only returns less than size bytes at the end of the file.
+ */
+static ssize_t celix_framework_utils_readFully(int fd, unsigned char* buffer, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t n = read(fd, buffer + total, size - total);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0) {
+            return -1;
+        } else if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+    return (ssize_t)total;
+}
+
+/**
+ * @brief Compares the content of two files.
+ */
+static celix_status_t celix_framework_utils_compareFiles(const char* path1, const char* path2, bool* equalOut) {
+    *equalOut = false;
+    struct stat st1;
+    struct stat st2;
+    if (stat(path1, &st1) == -1 || stat(path2, &st2) == -1) {
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    if (st1.st_size != st2.st_size) {
+        return CELIX_SUCCESS;
+    }
+    int fd1 = open(path1, O_RDONLY);
+    int fd2 = fd1 == -1 ? -1 : open(path2, O_RDONLY);
+    unsigned char* buffer = fd2 == -1 ? NULL : malloc(2 * FILE_READ_BUFFER_SIZE);
+    celix_status_t status = CELIX_SUCCESS;
+    if (fd1 == -1 || fd2 == -1) {
+        status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    } else if (buffer == NULL) {
+        status = CELIX_ENOMEM;
+    }
+    while (status == CELIX_SUCCESS) {
+        ssize_t n1 = celix_framework_utils_readFully(fd1, buffer, FILE_READ_BUFFER_SIZE);
+        ssize_t n2 = celix_framework_utils_readFully(fd2, buffer + FILE_READ_BUFFER_SIZE, FILE_READ_BUFFER_SIZE);
+        if (n1 < 0 || n2 < 0) {
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+        } else if (n1 != n2 || memcmp(buffer, buffer + FILE_READ_BUFFER_SIZE, n1) != 0) {
+            break;
+        } else if (n1 == 0) {
+            *equalOut = true;
+            break;
+        }
+    }
+    free(buffer);
+    if (fd2 != -1) {
+        close(fd2);
+    }
+    if (fd1 != -1) {
+        close(fd1);
+    }
+    return status;
+}
+
+/**
+ * @brief Returns whether the file name is the name of a shared library (*.so, *.so.<version> or *.dylib).
+ */
+static bool celix_framework_utils_isSharedLibraryName(const char* name) {
+    const char* so = strstr(name, ".so");
+    while (so != NULL) {
+        if (so[3] == '\0' || so[3] == '.') {
+            return true;
+        }
+        so = strstr(so + 1, ".so");
+    }
+    size_t len = strlen(name);
+    return len > 6 && strcmp(name + len - 6, ".dylib") == 0;
+}
+
+/**
+ * @brief Copies the content and permissions of the src file to a new dst file.
+ *
+ * If supported by the file system (e.g. btrfs, xfs) the dst file is created as a reflink: a new inode which shares the
+ * data blocks of the src file until one of them is modified, so no data is copied.
+ */
+static celix_status_t celix_framework_utils_copyFile(const char* src, const char* dst, mode_t mode) {
+    int in = open(src, O_RDONLY);
+    if (in == -1) {
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    int out = open(dst, O_WRONLY | O_CREAT | O_EXCL, mode & 07777);
+    if (out == -1) {
+        celix_status_t status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+        close(in);
+        return status;
+    }
+#ifdef FICLONE
+    if (ioctl(out, FICLONE, in) == 0) {
+        close(in);
+        return close(out) == -1 ? CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno) : CELIX_SUCCESS;
+    }
+#endif
+    unsigned char* buffer = malloc(FILE_READ_BUFFER_SIZE);
+    celix_status_t status = buffer == NULL ? CELIX_ENOMEM : CELIX_SUCCESS;
+    ssize_t n;
+    while (status == CELIX_SUCCESS && (n = read(in, buffer, FILE_READ_BUFFER_SIZE)) != 0) {
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        for (ssize_t written = 0; n > 0 && written < n;) {
+            ssize_t w = write(out, buffer + written, n - written);
+            if (w < 0 && errno != EINTR) {
+                n = -1;
+            } else if (w > 0) {
+                written += w;
+            }
+        }
+        if (n < 0) {
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+        }
+    }
+    free(buffer);
+    close(in);
+    if (close(out) == -1 && status == CELIX_SUCCESS) {
+        status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    return status;
+}
+
+/**
+ * @brief Recreates the directory tree of src in dst, with hard links to the files of src.
+ *
+ * Shared libraries are copied instead of linked. dlopen returns the already loaded library for a file with the
+ * same inode, so hard linked libraries would make frameworks in the same process share the static state of a bundle.
+ * Where possible the copy is a reflink, so it shares the data blocks with the shared bundle cache entry.
+ */
+static celix_status_t celix_framework_utils_linkDirectory(const char* src, const char* dst, const char** errorOut) {
+    if (mkdir(dst, S_IRWXU) == -1 && errno != EEXIST) {
+        *errorOut = "Could not create directory";
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    DIR* dir = opendir(src);
+    if (dir == NULL) {
+        *errorOut = "Could not open shared bundle cache directory";
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    celix_status_t status = CELIX_SUCCESS;
+    struct dirent* dent;
+    while (status == CELIX_SUCCESS && (dent = readdir(dir)) != NULL) {
+        if (strcmp(dent->d_name, ".") == 0 || strcmp(dent->d_name, "..") == 0) {
+            continue;
+        }
+        char* srcPath = NULL;
+        char* dstPath = NULL;
+        if (asprintf(&srcPath, "%s/%s", src, dent->d_name) < 0 || asprintf(&dstPath, "%s/%s", dst, dent->d_name) < 0) {
+            free(srcPath);
+            closedir(dir);
+            return CELIX_ENOMEM;
+        }
+        struct stat st;
+        if (lstat(srcPath, &st) == -1) {
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+            *errorOut = "Could not stat shared bundle cache entry";
+        } else if (S_ISDIR(st.st_mode)) {
+            status = celix_framework_utils_linkDirectory(srcPath, dstPath, errorOut);
+        } else if (S_ISLNK(st.st_mode)) {
+            char target[PATH_MAX];
+            ssize_t len = readlink(srcPath, target, sizeof(target) - 1);
+            if (len < 0 || (target[len] = '\0', symlink(target, dstPath) == -1)) {
+                status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+                *errorOut = "Could not create symbolic link";
+            }
+        } else if (celix_framework_utils_isSharedLibraryName(dent->d_name)) {
+            status = celix_framework_utils_copyFile(srcPath, dstPath, st.st_mode);
+            if (status != CELIX_SUCCESS) {
+                *errorOut = "Could not copy shared library";
+            }
+        } else if (link(srcPath, dstPath) == -1) {
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+            *errorOut = "Could not create hard link";
+        }
+        free(srcPath);
+        free(dstPath);
+    }
+    closedir(dir);
+    return status;
+}
+
+/**
+ * @brief Adds the bundle zip to the shared bundle cache as entry dir, containing the extracted bundle zip
+ * (SHARED_BUNDLE_CACHE_CONTENT_DIR) and a copy of the bundle zip (SHARED_BUNDLE_CACHE_ZIP_NAME).
+ *
+ * The entry is prepared in a tmp dir and renamed, so that other frameworks never see a partially added entry.
+ */
+static celix_status_t celix_framework_utils_addSharedCacheEntry(const char* zipPath,
+                                                                const char* sharedCacheDir,
+                                                                const char* entry,
+                                                                const char** errorOut) {
+    static unsigned long tmpCounter = 0;
+    unsigned long tmpId = __atomic_fetch_add(&tmpCounter, 1, __ATOMIC_RELAXED);
+    celix_autofree char* tmpEntry = NULL;
+    celix_autofree char* tmpContent = NULL;
+    celix_autofree char* tmpZip = NULL;
+    if (asprintf(&tmpEntry, "%s.tmp-%d-%lu", entry, (int)getpid(), tmpId) < 0 ||
+        asprintf(&tmpContent, "%s/" SHARED_BUNDLE_CACHE_CONTENT_DIR, tmpEntry) < 0 ||
+        asprintf(&tmpZip, "%s/" SHARED_BUNDLE_CACHE_ZIP_NAME, tmpEntry) < 0) {
+        return CELIX_ENOMEM;
+    }
+
+    celix_status_t status = celix_utils_createDirectory(sharedCacheDir, false, errorOut);
+    status = CELIX_DO_IF(status, celix_utils_extractZipFile(zipPath, tmpContent, errorOut));
+    if (status == CELIX_SUCCESS) {
+        status = celix_framework_utils_copyFile(zipPath, tmpZip, S_IRUSR | S_IWUSR);
+        if (status != CELIX_SUCCESS) {
+            *errorOut = "Could not copy bundle zip to shared bundle cache";
+        }
+    }
+    if (status == CELIX_SUCCESS && rename(tmpEntry, entry) == -1 && !celix_utils_directoryExists(entry)) {
+        status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+        *errorOut = "Could not add entry to shared bundle cache";
+    }
+    celix_utils_deleteDirectory(tmpEntry, NULL); //note no-op if rename succeeded
+    return status;
+}
+
+/**
+ * @brief Extracts the bundle zip once in the shared bundle cache dir - keyed on the content hash of the zip - and
+ * populates the extract path with hard links to the shared bundle cache entry (shared libraries are copied).
+ *
+ * The content hash is only used to find the entry. Before an entry is reused, the bundle zip is compared with the
+ * copy of the bundle zip in the entry, so a hash collision or a corrupt entry never results in the wrong bundle
+ * content.
+ * If the entry does not match or hard links cannot be created (e.g. the shared bundle cache dir is on another file
+ * system), the bundle zip is extracted directly to the extract path.
+ */
+static celix_status_t celix_framework_utils_extractZipFileShared(celix_framework_t* fw,
+                                                                 const char* zipPath,
+                                                                 const char* sharedCacheDir,
+                                                                 const char* extractPath,
+                                                                 const char** errorOut) {
+    uint64_t hash = 0;
+    off_t size = 0;
+    celix_status_t status = celix_framework_utils_hashFile(zipPath, &hash, &size);
+    if (status != CELIX_SUCCESS) {
+        *errorOut = "Could not calculate bundle zip hash";
+        return status;
+    }
+
+    celix_autofree char* entry = NULL;
+    celix_autofree char* entryContent = NULL;
+    celix_autofree char* entryZip = NULL;
+    if (asprintf(&entry, "%s/%016" PRIx64 "-%lld", sharedCacheDir, hash, (long long)size) < 0 ||
+        asprintf(&entryContent, "%s/" SHARED_BUNDLE_CACHE_CONTENT_DIR, entry) < 0 ||
+        asprintf(&entryZip, "%s/" SHARED_BUNDLE_CACHE_ZIP_NAME, entry) < 0) {
+        return CELIX_ENOMEM;
+    }
+
+    bool added = false;
+    if (!celix_utils_directoryExists(entry)) {
+        status = celix_framework_utils_addSharedCacheEntry(zipPath, sharedCacheDir, entry, errorOut);
+        added = status == CELIX_SUCCESS;
+        if (added) {
+            FW_LOG(CELIX_LOG_LEVEL_DEBUG, "Added bundle zip `%s` to shared bundle cache entry `%s`", zipPath, entry);
+        }
+    }
+
+    if (status == CELIX_SUCCESS && !added) {
+        //note the entry can also be added by another framework, so always compare an entry which was not added here
+        bool equal = false;
+        celix_status_t cmpStatus = celix_framework_utils_compareFiles(zipPath, entryZip, &equal);
+        if (!equal) {
+            FW_LOG(CELIX_LOG_LEVEL_WARNING,
+                   "Shared bundle cache entry `%s` does not match bundle zip `%s`%s. Extracting bundle zip instead.",
+                   entry, zipPath, cmpStatus == CELIX_SUCCESS ? "" : " (cannot compare bundle zip)");
+            return celix_utils_extractZipFile(zipPath, extractPath, errorOut);
+        }
+    }
+
+    if (status == CELIX_SUCCESS) {
+        status = celix_framework_utils_linkDirectory(entryContent, extractPath, errorOut);
+        if (status != CELIX_SUCCESS) {
+            FW_LOG(CELIX_LOG_LEVEL_WARNING,
+                   "Cannot link shared bundle cache entry `%s` to `%s`: %s. Extracting bundle zip instead.",
+                   entry, extractPath, *errorOut);
+            celix_utils_deleteDirectory(extractPath, NULL);
+            status = celix_utils_extractZipFile(zipPath, extractPath, errorOut);
+        }
+    }
+    return status;
+}
+
 static celix_status_t celix_framework_utils_extractBundlePath(celix_framework_t *fw, const char* bundlePath, const char* extractPath) {
     FW_LOG(CELIX_LOG_LEVEL_TRACE, "Extracting bundle url `%s` to dir `%s`", bundlePath, extractPath);
     const char* err = NULL;
@@ -212,7 +556,12 @@ static celix_status_t celix_framework_utils_extractBundlePath(celix_framework_t
         }
         free(abs);
     } else {
-        status = celix_utils_extractZipFile(resolvedPath, extractPath, &err);
+        const char* sharedCacheDir = celix_framework_getConfigProperty(fw, CELIX_FRAMEWORK_SHARED_BUNDLE_CACHE_DIR, NULL, NULL);
+        if (!celix_utils_isStringNullOrEmpty(sharedCacheDir)) {
+            status = celix_framework_utils_extractZipFileShared(fw, resolvedPath, sharedCacheDir, extractPath, &err);
+        } else {
+            status = celix_utils_extractZipFile(resolvedPath, extractPath, &err);
+        }
     }
     framework_logIfError(fw->logger, status, err, "Could not extract bundle zip file `%s` to `%s`", resolvedPath, extractPath);
     celix_utils_freeStringIfNotEqual(buffer, resolvedPath);
@@ -28,6 +28,7 @@
 #include "celix_constants.h"
 #include "celix_filter.h"
 #include "dm_component_impl.h"
+#include "dm_dependency_manager_impl.h"
 #include "celix_framework.h"
 
 static const char * const CELIX_DM_PRINT_OK_COLOR = "\033[92m";
@@ -35,6 +36,20 @@ static const char * const CELIX_DM_PRINT_WARNING_COLOR = "\033[93m";
 static const char * const CELIX_DM_PRINT_NOK_COLOR = "\033[91m";
 static const char * const CELIX_DM_PRINT_END_COLOR = "\033[m";
 
+typedef struct celix_dm_component_worker_transition {
+    celix_dm_component_t* cmp;
+    celix_dm_cmp_lifecycle_fpt callback;
+    celix_dm_component_state_t currentState;
+    celix_dm_component_state_t desiredState;
+    bool done; //whether the lifecycle callback returned, protected by the component mutex
+    celix_status_t status; //the lifecycle callback result, protected by the component mutex
+} celix_dm_component_worker_transition_t;
+
+typedef struct celix_dm_deferred_event {
+    celix_dm_event_t event;
+    long svcId;
+} celix_dm_deferred_event_t;
+
 struct celix_dm_component_struct {
     char uuid[DM_COMPONENT_MAX_ID_LENGTH];
     char name[DM_COMPONENT_MAX_NAME_LENGTH];
@@ -64,6 +79,16 @@ struct celix_dm_component_struct {
 
     bool isEnabled;
 
+    bool isManaged; //whether the component is added to a dependency manager
+    bool countedAsInactive; //whether the component is counted in the framework wide nr of inactive components
+
+    bool callbacksOnWorkerThread; //whether the init, start and stop callbacks are called on a dm worker thread
+    bool asyncTransitionInProgress; //whether the component is in a transition with a lifecycle callback on a dm worker thread
+    celix_dm_component_worker_transition_t* workerTransition; //the in progress worker transition, NULL if none
+    size_t pendingWorkerContinuations; //nr of fired, but not yet handled, worker transition done events
+    celix_array_list_t* deferredEvents; //type = celix_dm_deferred_event_t*, events deferred until the worker transition is done
+    celix_thread_cond_t cond; //broadcasted when a worker transition lifecycle callback returns or the transition is done
+
     /**
      * Whether the component is an a transition (active performTransition call).
      * Should only be used inside the Celix event Thread -> no locking needed.
@@ -98,6 +123,12 @@ static void celix_dmComponent_cleanupRemovedDependencies(celix_dm_component_t* c
 static bool celix_dmComponent_isActiveInternal(celix_dm_component_t *component);
 static void celix_dmComponent_setCurrentState(celix_dm_component_t* cmp, celix_dm_component_state_t s);
 static void celix_dmComponent_logTransition(celix_dm_component_t* cmp, celix_dm_component_state_t currentState, celix_dm_component_state_t desiredState);
+static bool celix_dmComponent_performTransitionOnWorkerThread(celix_dm_component_t *component, celix_dm_component_state_t currentState, celix_dm_component_state_t desiredState);
+static bool celix_dmComponent_deferEventDuringWorkerTransition(celix_dm_component_t* component, const celix_dm_event_t* event);
+static void celix_dmComponent_waitForWorkerTransition(celix_dm_component_t* component);
+static void celix_dmComponent_completeWorkerTransition(celix_dm_component_t* component);
+static void celix_dmComponent_handleDeferredEvents(celix_dm_component_t* component);
+
 
 celix_dm_component_t* celix_dmComponent_create(bundle_context_t *context, const char* name) {
     return celix_dmComponent_createWithUUID(context, name, NULL);
@@ -146,7 +177,9 @@ celix_dm_component_t* celix_dmComponent_createWithUUID(bundle_context_t *context
     component->providedInterfaces = celix_arrayList_create();
     component->dependencies = celix_arrayList_create();
     component->removedDependencies = celix_arrayList_create();
+    component->deferredEvents = celix_arrayList_create();
     celixThreadMutex_create(&component->mutex, NULL);
+    celixThreadCondition_init(&component->cond, NULL);
     component->isEnabled = false;
     component->inTransition = false;
     return component;
@@ -228,6 +261,12 @@ static void celix_dmComponent_destroyCallback(void *voidData) {
         }
         celix_arrayList_destroy(component->removedDependencies);
 
+        for (int i = 0; i < celix_arrayList_size(component->deferredEvents); ++i) {
+            free(celix_arrayList_get(component->deferredEvents, i));
+        }
+        celix_arrayList_destroy(component->deferredEvents);
+
+        celixThreadCondition_destroy(&component->cond);
         celixThreadMutex_destroy(&component->mutex);
         free(component);
 
@@ -314,8 +353,31 @@ celix_dm_component_state_t component_currentState(celix_dm_component_t *cmp) {
     return celix_dmComponent_currentState(cmp);
 }
 
+/**
+ * Updates the framework wide nr of inactive components if the (in)active state of the component changed.
+ *
+ * Should be called with component mutex locked.
+ */
+static void celix_dmComponent_updateInactiveCount(celix_dm_component_t* cmp) {
+    //note a lifecycle callback in progress on a dm worker thread is not yet active
+    bool inactive = cmp->isManaged && (!celix_dmComponent_isActiveInternal(cmp) || cmp->asyncTransitionInProgress);
+    if (inactive != cmp->countedAsInactive) {
+        cmp->countedAsInactive = inactive;
+        celix_private_dependencyManager_updateInactiveComponentCount(
+            celix_bundleContext_getFramework(cmp->context), inactive);
+    }
+}
+
 static void celix_dmComponent_setCurrentState(celix_dm_component_t* cmp, celix_dm_component_state_t s) {
     __atomic_store_n(&cmp->state, s, __ATOMIC_RELEASE);
+    celix_dmComponent_updateInactiveCount(cmp);
+}
+
+void celix_private_dmComponent_setManaged(celix_dm_component_t *component, bool managed) {
+    celixThreadMutex_lock(&component->mutex);
+    component->isManaged = managed;
+    celix_dmComponent_updateInactiveCount(component);
+    celixThreadMutex_unlock(&component->mutex);
 }
 
 celix_dm_component_state_t celix_dmComponent_currentState(celix_dm_component_t *cmp) {
@@ -426,6 +488,8 @@ static bool celix_dmComponent_isDisabled(celix_dm_component_t *component) {
     celixThreadMutex_lock(&component->mutex);
     isStopped =
             !component->isEnabled &&
+            !component->asyncTransitionInProgress &&
+            component->pendingWorkerContinuations == 0 &&
             celix_dmComponent_currentState(component) == CELIX_DM_CMP_STATE_INACTIVE &&
             celix_dmComponent_areAllDependenciesDisabled(component);
     celixThreadMutex_unlock(&component->mutex);
@@ -640,6 +704,9 @@ static celix_status_t celix_dmComponent_handleEvent(celix_dm_component_t *compon
                             component->uuid,
                             event->dep->serviceName);
 
+    if (celix_dmComponent_deferEventDuringWorkerTransition(component, event)) {
+        return CELIX_SUCCESS;
+    }
 
     if (component->inTransition) {
         /* Note if the component is already in transition (stopping, starting, etc) then only remove the svc
@@ -668,6 +735,11 @@ static celix_status_t celix_dmComponent_handleEvent(celix_dm_component_t *compon
     celix_dmComponent_handleChange(component);
 
     if (!eventHandled /*remove or set null*/) {
+        //note the svc can still be in use by a stop callback on a dm worker thread -> wait till the stop is done
+        celixThreadMutex_lock(&component->mutex);
+        celix_dmComponent_waitForWorkerTransition(component);
+        celixThreadMutex_unlock(&component->mutex);
+
         //removing svc or set svc to null -> if still active check if suspend is needed before invoking
         bool needSuspend = celix_dmComponent_needsSuspend(component, event);
         if (needSuspend) {
@@ -725,6 +797,11 @@ static void celix_dmComponent_handleChangeOnEventThread(void *data) {
     assert(celix_framework_isCurrentThreadTheEventLoop(celix_bundleContext_getFramework(component->context)));
 
     celixThreadMutex_lock(&component->mutex);
+    if (component->asyncTransitionInProgress) {
+        //note the state change will be handled when the worker thread transition is done
+        celixThreadMutex_unlock(&component->mutex);
+        return;
+    }
     celix_dm_component_state_t oldState;
     celix_dm_component_state_t newState;
     bool transition = false;
@@ -833,6 +910,12 @@ static bool celix_dmComponent_performTransition(celix_dm_component_t *component,
 
     celix_dmComponent_logTransition(component, currentState, desiredState);
 
+    if (component->callbacksOnWorkerThread &&
+        celix_dmComponent_performTransitionOnWorkerThread(component, currentState, desiredState)) {
+        component->inTransition = false;
+        return false; //note transition continues after the lifecycle callback is called on a dm worker thread
+    }
+
     celix_status_t status = CELIX_SUCCESS;
     if (currentState == CELIX_DM_CMP_STATE_INACTIVE && desiredState == CELIX_DM_CMP_STATE_WAITING_FOR_REQUIRED) {
         celix_dmComponent_enableDependencies(component);
@@ -890,6 +973,218 @@ static bool celix_dmComponent_performTransition(celix_dm_component_t *component,
     return transition;
 }
 
+/**
+ * Defers a service dependency event if a lifecycle callback of the component is called on a dm worker thread, so that
+ * service dependency callbacks are not called concurrently with the lifecycle callback.
+ *
+ * Add and set events are queued and handled when the worker transition is done. A remove event for a service with a
+ * queued add event cancels the queued events for that service. Other remove events are for a service the lifecycle
+ * callback can be using and therefore wait until the lifecycle callback is done.
+ *
+ * Returns true if the event is queued or cancelled and should not be handled further.
+ */
+static bool celix_dmComponent_deferEventDuringWorkerTransition(celix_dm_component_t* component, const celix_dm_event_t* event) {
+    celixThreadMutex_lock(&component->mutex);
+    if (!component->asyncTransitionInProgress) {
+        celixThreadMutex_unlock(&component->mutex);
+        return false;
+    }
+
+    long svcId = celix_properties_getAsLong(event->props, CELIX_FRAMEWORK_SERVICE_ID, -1L);
+    if (event->eventType == CELIX_DM_EVENT_SVC_REM) {
+        bool addDeferred = false;
+        for (int i = celix_arrayList_size(component->deferredEvents) - 1; i >= 0; --i) {
+            celix_dm_deferred_event_t* deferred = celix_arrayList_get(component->deferredEvents, i);
+            if (deferred->event.dep == event->dep && deferred->svcId == svcId) {
+                addDeferred = addDeferred || deferred->event.eventType == CELIX_DM_EVENT_SVC_ADD;
+                celix_arrayList_removeAt(component->deferredEvents, i);
+                free(deferred);
+            }
+        }
+        if (addDeferred) {
+            //note the service was never handed to the component
+            celixThreadMutex_unlock(&component->mutex);
+            return true;
+        }
+    } else {
+        celix_dm_deferred_event_t* deferred = malloc(sizeof(*deferred));
+        if (deferred != NULL) {
+            deferred->event = *event;
+            deferred->svcId = svcId;
+            celix_arrayList_add(component->deferredEvents, deferred);
+            celixThreadMutex_unlock(&component->mutex);
+            return true;
+        }
+    }
+
+    celix_dmComponent_waitForWorkerTransition(component);
+    celixThreadMutex_unlock(&component->mutex);
+    celix_dmComponent_handleDeferredEvents(component);
+    return false;
+}
+
+/**
+ * Waits until the lifecycle callback of the in progress worker transition is done. On the event thread the
+ * transition is also completed, otherwise this waits until the transition is completed on the event thread.
+ *
+ * Should be called with the component mutex locked.
+ */
+static void celix_dmComponent_waitForWorkerTransition(celix_dm_component_t* component) {
+    if (celix_framework_isCurrentThreadTheEventLoop(celix_bundleContext_getFramework(component->context))) {
+        if (component->asyncTransitionInProgress) {
+            while (!component->workerTransition->done) {
+                celixThreadCondition_wait(&component->cond, &component->mutex);
+            }
+            celix_dmComponent_completeWorkerTransition(component);
+        }
+    } else {
+        while (component->asyncTransitionInProgress) {
+            celixThreadCondition_wait(&component->cond, &component->mutex);
+        }
+    }
+}
+
+/**
+ * Handles the deferred service dependency events, until a new worker transition is started.
+ */
+static void celix_dmComponent_handleDeferredEvents(celix_dm_component_t* component) {
+    while (true) {
+        celixThreadMutex_lock(&component->mutex);
+        if (component->asyncTransitionInProgress || celix_arrayList_size(component->deferredEvents) == 0) {
+            celixThreadMutex_unlock(&component->mutex);
+            break;
+        }
+        celix_dm_deferred_event_t* deferred = celix_arrayList_get(component->deferredEvents, 0);
+        celix_arrayList_removeAt(component->deferredEvents, 0);
+        celixThreadMutex_unlock(&component->mutex);
+
+        celix_private_dmComponent_handleEvent(component, &deferred->event);
+        free(deferred);
+    }
+}
+
+/**
+ * Completes the worker transition on the event thread: registers the component services for a start transition and
+ * updates the component state, or disables the component if the lifecycle callback failed.
+ *
+ * Should be called on the event thread, with the component mutex locked and after the lifecycle callback returned.
+ */
+static void celix_dmComponent_completeWorkerTransition(celix_dm_component_t* component) {
+    celix_dm_component_worker_transition_t* job = component->workerTransition;
+    component->workerTransition = NULL;
+    component->asyncTransitionInProgress = false;
+
+    component->inTransition = true;
+    if (job->status == CELIX_SUCCESS) {
+        if (job->desiredState == CELIX_DM_CMP_STATE_TRACKING_OPTIONAL) {
+            celix_dmComponent_registerServices(component, false);
+            component->nrOfTimesStarted += 1;
+        }
+        celix_dmComponent_setCurrentState(component, job->desiredState);
+    } else {
+        celix_bundleContext_log(component->context, CELIX_LOG_LEVEL_ERROR,
+                                "Error in component %s (uuid=%s) transition from %s to %s. Disabling component.",
+                                component->name,
+                                component->uuid,
+                                celix_dmComponent_stateToString(job->currentState),
+                                celix_dmComponent_stateToString(job->desiredState));
+        celix_dmComponent_disableDirectly(component);
+    }
+    component->inTransition = false;
+    celix_dmComponent_updateInactiveCount(component);
+    celixThreadCondition_broadcast(&component->cond);
+    free(job);
+}
+
+static void celix_dmComponent_workerTransitionDone(void* data) {
+    celix_dm_component_t* component = data;
+    celixThreadMutex_lock(&component->mutex);
+    if (component->workerTransition != NULL && component->workerTransition->done) {
+        celix_dmComponent_completeWorkerTransition(component);
+    }
+    component->pendingWorkerContinuations -= 1;
+    celixThreadMutex_unlock(&component->mutex);
+    celix_dmComponent_handleDeferredEvents(component);
+    celix_dmComponent_handleChangeOnEventThread(component);
+}
+
+static void celix_dmComponent_workerTransition(void* data) {
+    celix_dm_component_worker_transition_t* job = data;
+    celix_dm_component_t* component = job->cmp;
+
+    //note lifecycle callback is called without the component lock, so that the event thread is not blocked
+    celix_status_t status = job->callback(component->implementation);
+
+    //note the transition is completed on the event thread, the job is freed when the transition is completed
+    celixThreadMutex_lock(&component->mutex);
+    job->status = status;
+    job->done = true;
+    component->pendingWorkerContinuations += 1;
+    celixThreadCondition_broadcast(&component->cond);
+    celix_framework_fireGenericEvent(celix_bundleContext_getFramework(component->context),
+                                     -1,
+                                     celix_bundleContext_getBundleId(component->context),
+                                     "dm component worker transition done",
+                                     component,
+                                     celix_dmComponent_workerTransitionDone,
+                                     NULL,
+                                     NULL);
+    celixThreadMutex_unlock(&component->mutex);
+}
+
+/**
+ * Try to perform the init, start or stop transition by calling the lifecycle callback on a dm worker thread.
+ * This function should be called with the component->mutex locked.
+ *
+ * Returns true if the transition is handed over to a dm worker thread. The transition is completed - and state changes
+ * are handled - on the event thread when the lifecycle callback is done.
+ */
+static bool celix_dmComponent_performTransitionOnWorkerThread(celix_dm_component_t *component, celix_dm_component_state_t currentState, celix_dm_component_state_t desiredState) {
+    celix_dm_cmp_lifecycle_fpt callback = NULL;
+    if (currentState == CELIX_DM_CMP_STATE_INITIALIZING && desiredState == CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED) {
+        callback = component->callbackInit;
+    } else if (currentState == CELIX_DM_CMP_STATE_STARTING && desiredState == CELIX_DM_CMP_STATE_TRACKING_OPTIONAL) {
+        callback = component->callbackStart;
+    } else if (currentState == CELIX_DM_CMP_STATE_STOPPING && desiredState == CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED) {
+        callback = component->callbackStop;
+    }
+    if (callback == NULL) {
+        return false;
+    }
+
+    celix_dm_component_worker_transition_t* job = malloc(sizeof(*job));
+    if (job == NULL) {
+        return false;
+    }
+    job->cmp = component;
+    job->callback = callback;
+    job->currentState = currentState;
+    job->desiredState = desiredState;
+    job->done = false;
+    job->status = CELIX_SUCCESS;
+
+    if (currentState == CELIX_DM_CMP_STATE_STOPPING) {
+        celix_dmComponent_unregisterServices(component, false);
+    }
+    component->workerTransition = job;
+    component->asyncTransitionInProgress = true;
+    celix_dmComponent_updateInactiveCount(component);
+    celix_status_t status = celix_private_dependencyManager_submitWork(
+            celix_bundleContext_getFramework(component->context), job, celix_dmComponent_workerTransition);
+    if (status != CELIX_SUCCESS) {
+        celix_bundleContext_log(component->context, CELIX_LOG_LEVEL_WARNING,
+                                "Cannot use a dm worker thread for component %s (uuid=%s), calling lifecycle callback on the event thread.",
+                                component->name,
+                                component->uuid);
+        component->workerTransition = NULL;
+        component->asyncTransitionInProgress = false;
+        celix_dmComponent_updateInactiveCount(component);
+        free(job);
+        return false;
+    }
+    return true;
+}
+
 /**
  * Check if all required dependencies are resolved. This function should be called with the component->mutex locked.
  */
@@ -1004,6 +1299,13 @@ celix_status_t celix_dmComponent_setCallbacks(celix_dm_component_t *component, c
 	return CELIX_SUCCESS;
 }
 
+celix_status_t celix_dmComponent_setCallbacksOnWorkerThread(celix_dm_component_t *component, bool onWorkerThread) {
+    celixThreadMutex_lock(&component->mutex);
+    component->callbacksOnWorkerThread = onWorkerThread;
+    celixThreadMutex_unlock(&component->mutex);
+    return CELIX_SUCCESS;
+}
+
 celix_status_t component_setImplementation(celix_dm_component_t *component, void *implementation) {
     return celix_dmComponent_setImplementation(component, implementation);
 }
@@ -1084,10 +1386,8 @@ static void celix_dmComponent_printFullInfo(FILE *out, bool colors, celix_dm_com
         dm_interface_info_pt intfInfo = celix_arrayList_get(compInfo->interfaces, interfCnt);
         fprintf(out, "   |- %sInterface %i: %s%s\n", startColors, (interfCnt+1), intfInfo->name, endColors);
 
-        hash_map_iterator_t iter = hashMapIterator_construct((hash_map_pt) intfInfo->properties);
-        char *key = NULL;
-        while ((key = hashMapIterator_nextKey(&iter)) != NULL) {
-            fprintf(out, "      | %15s = %s\n", key, celix_properties_get(intfInfo->properties, key, "!ERROR!"));
+        CELIX_PROPERTIES_ITERATE(intfInfo->properties, iter) {
+            fprintf(out, "      | %15s = %s\n", iter.key, iter.entry.value);
         }
     }
 
@@ -38,6 +38,13 @@ extern "C" {
 celix_status_t celix_private_dmComponent_enable(celix_dm_component_t *component);
 celix_status_t celix_private_dmComponent_handleEvent(celix_dm_component_t *component, const celix_dm_event_t* event);
 
+/**
+ * @brief Sets whether the component is managed by (added to) a dependency manager.
+ *
+ * Only managed components are counted in the framework wide nr of inactive components.
+ */
+void celix_private_dmComponent_setManaged(celix_dm_component_t *component, bool managed);
+
 #ifdef __cplusplus
 }
 #endif
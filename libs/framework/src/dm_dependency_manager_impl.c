@@ -30,6 +30,19 @@
 #include "celix_bundle.h"
 #include "celix_compiler.h"
 #include "celix_framework.h"
+#include "framework_private.h"
+
+typedef struct celix_dm_all_components_active_listener {
+    long id;
+    void* callbackData;
+    void (*callback)(void* data);
+    size_t useCount; //protected by fw->dmComponents.mutex
+} celix_dm_all_components_active_listener_t;
+
+typedef struct celix_dm_work {
+    void* data;
+    void (*work)(void* data);
+} celix_dm_work_t;
 
 celix_dependency_manager_t* celix_private_dependencyManager_create(celix_bundle_context_t *context) {
 	celix_dependency_manager_t *manager = calloc(1, sizeof(*manager));
@@ -62,6 +75,7 @@ celix_status_t celix_dependencyManager_addAsync(celix_dependency_manager_t *mana
     celixThreadMutex_lock(&manager->mutex);
 	celix_arrayList_add(manager->components, component);
     celixThreadMutex_unlock(&manager->mutex);
+    celix_private_dmComponent_setManaged(component, true);
 
 	return celix_private_dmComponent_enable(component);
 }
@@ -81,6 +95,10 @@ static celix_status_t celix_dependencyManager_removeWithoutDestroy(celix_depende
     }
     celixThreadMutex_unlock(&manager->mutex);
 
+    if (found) {
+        celix_private_dmComponent_setManaged(component, false);
+    }
+
     if (!found) {
         celix_bundleContext_log(
                 manager->ctx,
@@ -167,6 +185,7 @@ celix_status_t celix_dependencyManager_removeAllComponentsAsync(celix_dependency
     }
     for (int i = 0; i < celix_arrayList_size(manager->components); ++i) {
         celix_dm_component_t *cmp = celix_arrayList_get(manager->components, i);
+        celix_private_dmComponent_setManaged(cmp, false);
         if (doneCallback != NULL) {
             celix_dmComponent_destroyAsync(cmp, callbackData, celix_dependencyManager_removeAllComponentsAsyncCallback);
         } else {
@@ -312,6 +331,199 @@ bool celix_dependencyManager_areComponentsActive(celix_dependency_manager_t *mng
     return allActive;
 }
 
+size_t celix_dependencyManager_nrOfInactiveComponents(celix_dependency_manager_t *manager) {
+    celix_framework_t* fw = celix_bundleContext_getFramework(manager->ctx);
+    long nr = __atomic_load_n(&fw->dmComponents.nrOfInactiveComponents, __ATOMIC_ACQUIRE);
+    return nr > 0 ? (size_t)nr : 0;
+}
+
+long celix_dependencyManager_addAllComponentsActiveListener(celix_dependency_manager_t *manager, void *callbackData, void (*callback)(void *data)) {
+    if (callback == NULL) {
+        return -1L;
+    }
+    celix_dm_all_components_active_listener_t* listener = malloc(sizeof(*listener));
+    if (listener == NULL) {
+        celix_bundleContext_log(manager->ctx, CELIX_LOG_LEVEL_ERROR, "Cannot add all components active listener. ENOMEM");
+        return -1L;
+    }
+    listener->callbackData = callbackData;
+    listener->callback = callback;
+    listener->useCount = 0;
+
+    celix_framework_t* fw = celix_bundleContext_getFramework(manager->ctx);
+    celixThreadMutex_lock(&fw->dmComponents.mutex);
+    listener->id = fw->dmComponents.nextListenerId++;
+    celix_status_t status = celix_arrayList_add(fw->dmComponents.allActiveListeners, listener);
+    celixThreadMutex_unlock(&fw->dmComponents.mutex);
+    if (status != CELIX_SUCCESS) {
+        celix_bundleContext_log(manager->ctx, CELIX_LOG_LEVEL_ERROR, "Cannot add all components active listener. Got status %d", status);
+        free(listener);
+        return -1L;
+    }
+    return listener->id;
+}
+
+void celix_dependencyManager_removeAllComponentsActiveListener(celix_dependency_manager_t *manager, long listenerId) {
+    if (listenerId < 0) {
+        return;
+    }
+    celix_framework_t* fw = celix_bundleContext_getFramework(manager->ctx);
+    celix_dm_all_components_active_listener_t* removed = NULL;
+    celixThreadMutex_lock(&fw->dmComponents.mutex);
+    for (int i = 0; i < celix_arrayList_size(fw->dmComponents.allActiveListeners); ++i) {
+        celix_dm_all_components_active_listener_t* listener = celix_arrayList_get(fw->dmComponents.allActiveListeners, i);
+        if (listener->id == listenerId) {
+            celix_arrayList_removeAt(fw->dmComponents.allActiveListeners, i);
+            removed = listener;
+            break;
+        }
+    }
+    //note wait till the listener is not in use, so that the callback is not called after this function returns
+    while (removed != NULL && removed->useCount > 0) {
+        celixThreadCondition_wait(&fw->dmComponents.cond, &fw->dmComponents.mutex);
+    }
+    celixThreadMutex_unlock(&fw->dmComponents.mutex);
+    if (removed == NULL) {
+        celix_bundleContext_log(manager->ctx, CELIX_LOG_LEVEL_ERROR, "Cannot find all components active listener with id %li", listenerId);
+    }
+    free(removed);
+}
+
+void celix_private_dependencyManager_updateInactiveComponentCount(celix_framework_t* fw, bool inactive) {
+    if (inactive) {
+        __atomic_add_fetch(&fw->dmComponents.nrOfInactiveComponents, 1, __ATOMIC_ACQ_REL);
+        return;
+    }
+    long nr = __atomic_sub_fetch(&fw->dmComponents.nrOfInactiveComponents, 1, __ATOMIC_ACQ_REL);
+    if (nr != 0) {
+        return;
+    }
+
+    //last inactive component became active (or was removed) -> notify listeners.
+    //note listeners are called without the dmComponents mutex locked, because listeners can take their own locks and
+    //the same locks can be held when a listener is added.
+    celix_autoptr(celix_array_list_t) listeners = celix_arrayList_create();
+    if (listeners == NULL) {
+        fw_log(fw->logger, CELIX_LOG_LEVEL_ERROR, "Cannot notify all components active listeners. ENOMEM");
+        return;
+    }
+    celixThreadMutex_lock(&fw->dmComponents.mutex);
+    for (int i = 0; i < celix_arrayList_size(fw->dmComponents.allActiveListeners); ++i) {
+        celix_dm_all_components_active_listener_t* listener = celix_arrayList_get(fw->dmComponents.allActiveListeners, i);
+        if (celix_arrayList_add(listeners, listener) == CELIX_SUCCESS) {
+            listener->useCount += 1;
+        }
+    }
+    celixThreadMutex_unlock(&fw->dmComponents.mutex);
+
+    for (int i = 0; i < celix_arrayList_size(listeners); ++i) {
+        celix_dm_all_components_active_listener_t* listener = celix_arrayList_get(listeners, i);
+        listener->callback(listener->callbackData);
+    }
+
+    celixThreadMutex_lock(&fw->dmComponents.mutex);
+    for (int i = 0; i < celix_arrayList_size(listeners); ++i) {
+        celix_dm_all_components_active_listener_t* listener = celix_arrayList_get(listeners, i);
+        listener->useCount -= 1;
+    }
+    celixThreadCondition_broadcast(&fw->dmComponents.cond);
+    celixThreadMutex_unlock(&fw->dmComponents.mutex);
+}
+
+static void* celix_dependencyManager_worker(void* data) {
+    celix_framework_t* fw = data;
+    celixThreadMutex_lock(&fw->dmWorkers.mutex);
+    while (fw->dmWorkers.active || celix_arrayList_size(fw->dmWorkers.queue) > 0) {
+        if (celix_arrayList_size(fw->dmWorkers.queue) == 0) {
+            celixThreadCondition_wait(&fw->dmWorkers.cond, &fw->dmWorkers.mutex);
+            continue;
+        }
+        celix_dm_work_t work = *(celix_dm_work_t*)celix_arrayList_get(fw->dmWorkers.queue, 0);
+        celix_arrayList_removeAt(fw->dmWorkers.queue, 0);
+        celixThreadMutex_unlock(&fw->dmWorkers.mutex);
+        work.work(work.data);
+        celixThreadMutex_lock(&fw->dmWorkers.mutex);
+    }
+    celixThreadMutex_unlock(&fw->dmWorkers.mutex);
+    return NULL;
+}
+
+static void celix_dependencyManager_startWorkers(celix_framework_t* fw) {
+    //precondition fw->dmWorkers.mutex locked
+    fw->dmWorkers.threads = calloc(fw->dmWorkers.nrOfThreads, sizeof(*fw->dmWorkers.threads));
+    if (fw->dmWorkers.threads == NULL) {
+        fw_log(fw->logger, CELIX_LOG_LEVEL_ERROR, "Cannot create dependency manager worker threads. ENOMEM");
+        return;
+    }
+    for (size_t i = 0; i < fw->dmWorkers.nrOfThreads; ++i) {
+        celix_status_t status = celixThread_create(&fw->dmWorkers.threads[fw->dmWorkers.nrOfStartedThreads], NULL, celix_dependencyManager_worker, fw);
+        if (status != CELIX_SUCCESS) {
+            fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, status, "Cannot create dependency manager worker thread");
+            break;
+        }
+        celixThread_setName(&fw->dmWorkers.threads[fw->dmWorkers.nrOfStartedThreads], "CelixDmWorker");
+        fw->dmWorkers.nrOfStartedThreads += 1;
+    }
+    fw_log(fw->logger, CELIX_LOG_LEVEL_DEBUG, "Started %zu dependency manager worker threads", fw->dmWorkers.nrOfStartedThreads);
+}
+
+celix_status_t celix_private_dependencyManager_submitWork(celix_framework_t* fw, void* data, void (*work)(void* data)) {
+    celix_status_t status = CELIX_SUCCESS;
+    celixThreadMutex_lock(&fw->dmWorkers.mutex);
+    if (!fw->dmWorkers.active) {
+        status = CELIX_ILLEGAL_STATE;
+    }
+    if (status == CELIX_SUCCESS && fw->dmWorkers.threads == NULL) {
+        celix_dependencyManager_startWorkers(fw);
+    }
+    if (status == CELIX_SUCCESS && fw->dmWorkers.nrOfStartedThreads == 0) {
+        status = CELIX_ENOMEM;
+    }
+    celix_dm_work_t* entry = NULL;
+    if (status == CELIX_SUCCESS) {
+        entry = malloc(sizeof(*entry));
+        status = entry == NULL ? CELIX_ENOMEM : CELIX_SUCCESS;
+    }
+    if (status == CELIX_SUCCESS) {
+        entry->data = data;
+        entry->work = work;
+        status = celix_arrayList_add(fw->dmWorkers.queue, entry);
+        if (status != CELIX_SUCCESS) {
+            free(entry);
+        }
+    }
+    if (status == CELIX_SUCCESS) {
+        celixThreadCondition_signal(&fw->dmWorkers.cond);
+    }
+    celixThreadMutex_unlock(&fw->dmWorkers.mutex);
+    return status;
+}
+
+bool celix_private_dependencyManager_isCurrentThreadAWorker(celix_framework_t* fw) {
+    bool isWorker = false;
+    celix_thread_t self = celixThread_self();
+    celixThreadMutex_lock(&fw->dmWorkers.mutex);
+    for (size_t i = 0; !isWorker && i < fw->dmWorkers.nrOfStartedThreads; ++i) {
+        isWorker = celixThread_equals(self, fw->dmWorkers.threads[i]);
+    }
+    celixThreadMutex_unlock(&fw->dmWorkers.mutex);
+    return isWorker;
+}
+
+void celix_private_dependencyManager_stopWorkers(celix_framework_t* fw) {
+    celixThreadMutex_lock(&fw->dmWorkers.mutex);
+    fw->dmWorkers.active = false;
+    celixThreadCondition_broadcast(&fw->dmWorkers.cond);
+    celixThreadMutex_unlock(&fw->dmWorkers.mutex);
+
+    for (size_t i = 0; i < fw->dmWorkers.nrOfStartedThreads; ++i) {
+        celixThread_join(fw->dmWorkers.threads[i], NULL);
+    }
+    free(fw->dmWorkers.threads);
+    fw->dmWorkers.threads = NULL;
+    fw->dmWorkers.nrOfStartedThreads = 0;
+}
+
 void celix_dependencyManager_destroyInfo(celix_dependency_manager_t *manager CELIX_UNUSED, celix_dependency_manager_info_t *info) {
     if (info != NULL) {
         celix_arrayList_destroy(info->components);
@@ -23,6 +23,7 @@
 #include "celix_array_list.h"
 #include "celix_bundle_context.h"
 #include <pthread.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,34 @@ struct celix_dependency_manager {
 celix_dependency_manager_t* celix_private_dependencyManager_create(celix_bundle_context_t *context);
 void celix_private_dependencyManager_destroy(celix_dependency_manager_t *manager);
 
+/**
+ * @brief Updates the framework wide nr of inactive components.
+ *
+ * Called when a component added to a dependency manager becomes inactive (inactive is true) or active (inactive is
+ * false) and when an inactive component is added to or removed from a dependency manager.
+ * If the last inactive component becomes active, the all components active listeners are called.
+ */
+void celix_private_dependencyManager_updateInactiveComponentCount(celix_framework_t* fw, bool inactive);
+
+/**
+ * @brief Submit work to the dependency manager worker threads.
+ *
+ * The worker threads are created on first use.
+ * @return CELIX_SUCCESS if the work is submitted, CELIX_ILLEGAL_STATE if the workers are stopped or
+ * CELIX_ENOMEM if the work cannot be queued or no worker thread can be created.
+ */
+celix_status_t celix_private_dependencyManager_submitWork(celix_framework_t* fw, void* data, void (*work)(void* data));
+
+/**
+ * @brief Returns whether the current thread is a dependency manager worker thread of the framework.
+ */
+bool celix_private_dependencyManager_isCurrentThreadAWorker(celix_framework_t* fw);
+
+/**
+ * @brief Stop and join the dependency manager worker threads. Already submitted work is still processed.
+ */
+void celix_private_dependencyManager_stopWorkers(celix_framework_t* fw);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,7 @@
 #include "celix_constants.h"
 #include "celix_convert_utils.h"
 #include "celix_dependency_manager.h"
+#include "dm_dependency_manager_impl.h"
 #include "celix_file_utils.h"
 #include "celix_framework_utils_private.h"
 #include "celix_libloader.h"
@@ -46,6 +47,8 @@
 #include "service_reference_private.h"
 #include "service_registration_private.h"
 #include "celix_scheduled_event.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_string_hash_map.h"
 #include "celix_err.h"
 #include "utils.h"
 
@@ -160,7 +163,10 @@ celix_status_t fw_invokeFrameworkListener(framework_pt framework, framework_list
 
 static celix_status_t framework_autoStartConfiguredBundles(celix_framework_t *fw);
 static celix_status_t framework_autoInstallConfiguredBundles(celix_framework_t *fw);
-static celix_status_t framework_autoInstallConfiguredBundlesForList(celix_framework_t *fw, const char *autoStart, celix_array_list_t *installedBundles);
+static celix_status_t framework_autoInstallConfiguredBundlesForList(celix_framework_t *fw, const char *autoStart, celix_array_list_t *installedBundles, celix_string_hash_map_t* preparedArchives);
+static celix_string_hash_map_t* framework_prepareConfiguredBundleArchives(celix_framework_t* fw, const char* const* lists);
+static void framework_destroyPreparedBundleArchives(celix_framework_t* fw, celix_string_hash_map_t* preparedArchives);
+static celix_status_t celix_framework_installBundleInternalImpl(celix_framework_t* framework, const char* bndLoc, long* bndId, bundle_archive_t* preparedArchive);
 static celix_status_t framework_autoStartConfiguredBundlesForList(celix_framework_t* fw, const celix_array_list_t *installedBundles);
 static void celix_framework_addToEventQueue(celix_framework_t *fw, const celix_framework_event_t* event);
 static void celix_framework_stopAndJoinEventQueue(celix_framework_t* fw);
@@ -280,6 +286,18 @@ celix_status_t framework_create(framework_pt *out, celix_properties_t* config) {
     celixThreadMutex_create(&framework->bundleLifecycleHandling.mutex, NULL);
     framework->bundleLifecycleHandling.bundleLifecycleHandlers = celix_arrayList_create();
 
+    //setup dependency manager component bookkeeping
+    celixThreadMutex_create(&framework->dmComponents.mutex, NULL);
+    celixThreadCondition_init(&framework->dmComponents.cond, NULL);
+    framework->dmComponents.allActiveListeners = celix_arrayList_create();
+    celixThreadMutex_create(&framework->dmWorkers.mutex, NULL);
+    celixThreadCondition_init(&framework->dmWorkers.cond, NULL);
+    framework->dmWorkers.active = true;
+    framework->dmWorkers.nrOfThreads = celix_framework_getNrOfDmWorkerThreads(framework);
+    celix_array_list_create_options_t queueOpts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
+    queueOpts.simpleRemovedCallback = free;
+    framework->dmWorkers.queue = celix_arrayList_createWithOptions(&queueOpts);
+
     *out = framework;
     return status;
 }
@@ -345,6 +363,18 @@ celix_status_t framework_destroy(framework_pt framework) {
     celixThreadMutex_destroy(&framework->bundleLifecycleHandling.mutex);
     celixThreadCondition_destroy(&framework->bundleLifecycleHandling.cond);
 
+    //teardown dependency manager component bookkeeping and workers
+    celix_private_dependencyManager_stopWorkers(framework);
+    celix_arrayList_destroy(framework->dmWorkers.queue);
+    celixThreadCondition_destroy(&framework->dmWorkers.cond);
+    celixThreadMutex_destroy(&framework->dmWorkers.mutex);
+    for (int i = 0; i < celix_arrayList_size(framework->dmComponents.allActiveListeners); ++i) {
+        free(celix_arrayList_get(framework->dmComponents.allActiveListeners, i));
+    }
+    celix_arrayList_destroy(framework->dmComponents.allActiveListeners);
+    celixThreadCondition_destroy(&framework->dmComponents.cond);
+    celixThreadMutex_destroy(&framework->dmComponents.mutex);
+
     hashMap_destroy(framework->installRequestMap, false, false);
 
     if (framework->bundleListeners) {
@@ -486,19 +516,39 @@ celix_status_t framework_start(celix_framework_t* framework) {
 static celix_status_t framework_autoStartConfiguredBundles(celix_framework_t* fw) {
     celix_status_t status = CELIX_SUCCESS;
     const char* const celixKeys[] = {CELIX_AUTO_START_0, CELIX_AUTO_START_1, CELIX_AUTO_START_2, CELIX_AUTO_START_3, CELIX_AUTO_START_4, CELIX_AUTO_START_5, CELIX_AUTO_START_6, NULL};
-    celix_array_list_t *installedBundles = celix_arrayList_create();
+    const char* autoStartLists[sizeof(celixKeys) / sizeof(celixKeys[0])] = {NULL};
+    int nrOfLists = 0;
     for (int i = 0; celixKeys[i] != NULL; ++i) {
         const char *autoStart = celix_framework_getConfigProperty(fw, celixKeys[i], NULL, NULL);
         if (autoStart != NULL) {
-            if (framework_autoInstallConfiguredBundlesForList(fw, autoStart, installedBundles) != CELIX_SUCCESS) {
-                status = CELIX_BUNDLE_EXCEPTION;
-            }
+            autoStartLists[nrOfLists++] = autoStart;
+        }
+    }
+    if (nrOfLists == 0) {
+        return CELIX_SUCCESS;
+    }
+
+    struct timespec prepareStart = celix_gettime(CLOCK_MONOTONIC);
+    celix_string_hash_map_t* preparedArchives = framework_prepareConfiguredBundleArchives(fw, autoStartLists);
+    struct timespec installStart = celix_gettime(CLOCK_MONOTONIC);
+    celix_array_list_t *installedBundles = celix_arrayList_create();
+    for (int i = 0; i < nrOfLists; ++i) {
+        if (framework_autoInstallConfiguredBundlesForList(fw, autoStartLists[i], installedBundles, preparedArchives) != CELIX_SUCCESS) {
+            status = CELIX_BUNDLE_EXCEPTION;
         }
     }
+    framework_destroyPreparedBundleArchives(fw, preparedArchives);
+    struct timespec startStart = celix_gettime(CLOCK_MONOTONIC);
     celix_status_t startStatus = framework_autoStartConfiguredBundlesForList(fw, installedBundles);
     if (status == CELIX_SUCCESS) {
         status = startStatus;
     }
+    fw_log(fw->logger, CELIX_LOG_LEVEL_DEBUG,
+           "Auto started %i bundles: creating bundle archives took %.3f ms, installing %.3f ms and starting %.3f ms.",
+           celix_arrayList_size(installedBundles),
+           celix_difftime(&prepareStart, &installStart) * 1000.0,
+           celix_difftime(&installStart, &startStart) * 1000.0,
+           celix_elapsedtime(CLOCK_MONOTONIC, startStart) * 1000.0);
     celix_arrayList_destroy(installedBundles);
     return status;
 }
@@ -506,13 +556,149 @@ static celix_status_t framework_autoStartConfiguredBundles(celix_framework_t* fw
 static celix_status_t framework_autoInstallConfiguredBundles(celix_framework_t* fw) {
     const char* autoInstall = celix_framework_getConfigProperty(fw, CELIX_AUTO_INSTALL, NULL, NULL);
     if (autoInstall != NULL) {
-        return framework_autoInstallConfiguredBundlesForList(fw, autoInstall, NULL);
+        const char* autoInstallLists[] = {autoInstall, NULL};
+        struct timespec prepareStart = celix_gettime(CLOCK_MONOTONIC);
+        celix_string_hash_map_t* preparedArchives = framework_prepareConfiguredBundleArchives(fw, autoInstallLists);
+        struct timespec installStart = celix_gettime(CLOCK_MONOTONIC);
+        celix_status_t status = framework_autoInstallConfiguredBundlesForList(fw, autoInstall, NULL, preparedArchives);
+        framework_destroyPreparedBundleArchives(fw, preparedArchives);
+        fw_log(fw->logger, CELIX_LOG_LEVEL_DEBUG,
+               "Auto installed bundles: creating bundle archives took %.3f ms and installing %.3f ms.",
+               celix_difftime(&prepareStart, &installStart) * 1000.0,
+               celix_elapsedtime(CLOCK_MONOTONIC, installStart) * 1000.0);
+        return status;
     }
     return CELIX_SUCCESS;
 }
 
+size_t celix_framework_getNrOfAutoInstallThreads(celix_framework_t* fw) {
+    long nrOfThreads = celix_framework_getConfigPropertyAsLong(fw, CELIX_AUTO_INSTALL_NR_OF_THREADS, CELIX_AUTO_INSTALL_NR_OF_THREADS_DEFAULT, NULL);
+    if (nrOfThreads <= 0) {
+        nrOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+        nrOfThreads = nrOfThreads < 1 ? 1 : nrOfThreads;
+        nrOfThreads = nrOfThreads > CELIX_AUTO_INSTALL_MAX_NR_OF_THREADS ? CELIX_AUTO_INSTALL_MAX_NR_OF_THREADS : nrOfThreads;
+    }
+    return (size_t)nrOfThreads;
+}
+
+size_t celix_framework_getNrOfDmWorkerThreads(celix_framework_t* fw) {
+    long nrOfThreads = celix_framework_getConfigPropertyAsLong(fw, CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS, CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS_DEFAULT, NULL);
+    if (nrOfThreads <= 0) {
+        nrOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+        nrOfThreads = nrOfThreads < 1 ? 1 : nrOfThreads;
+        nrOfThreads = nrOfThreads > CELIX_FRAMEWORK_DM_MAX_NR_OF_WORKER_THREADS ? CELIX_FRAMEWORK_DM_MAX_NR_OF_WORKER_THREADS : nrOfThreads;
+    }
+    return (size_t)nrOfThreads;
+}
 
-static celix_status_t framework_autoInstallConfiguredBundlesForList(celix_framework_t* fw, const char *autoStartIn, celix_array_list_t *installedBundles) {
+/**
+ * Creates the bundle archives - extracting the bundle zips and parsing the manifests - for the bundles in the
+ * provided (NULL terminated) space separated lists concurrently.
+ * Locations are deduplicated (first occurrence wins) and bundle ids are assigned in list order, so the result is the
+ * same as installing the bundles one by one.
+ * Returns a location -> bundle archive map or NULL if no archives are created.
+ */
+static celix_string_hash_map_t* framework_prepareConfiguredBundleArchives(celix_framework_t* fw, const char* const* lists) {
+    size_t nrOfThreads = celix_framework_getNrOfAutoInstallThreads(fw);
+    if (nrOfThreads <= 1) {
+        return NULL; //note archives will be created during installation
+    }
+
+    celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = free;
+    celix_autoptr(celix_array_list_t) locations = celix_arrayList_createWithOptions(&opts);
+    celix_autoptr(celix_array_list_t) ids = celix_arrayList_create();
+    celix_autoptr(celix_string_hash_map_t) seen = celix_stringHashMap_create();
+    celix_autoptr(celix_string_hash_map_t) result = celix_stringHashMap_create();
+    if (!locations || !ids || !seen || !result) {
+        return NULL;
+    }
+
+    //note the install lock is kept during the creation of the archives, so that no bundle id is reserved in between
+    celixThreadMutex_lock(&fw->installLock);
+    long firstNewId = -1L;
+    for (int i = 0; lists[i] != NULL; ++i) {
+        char* savePtr = NULL;
+        char buffer[CELIX_DEFAULT_STRING_CREATE_BUFFER_SIZE];
+        char* list = celix_utils_writeOrCreateString(buffer, sizeof(buffer), "%s", lists[i]);
+        char* location = list ? strtok_r(list, " ", &savePtr) : NULL;
+        while (location != NULL) {
+            if (!celix_stringHashMap_hasKey(seen, location) &&
+                framework_getBundle(fw, location) == -1L &&
+                celix_framework_utils_isBundleUrlValid(fw, location, true)) {
+                long id = celix_bundleCache_findBundleIdForLocation(fw->cache, location);
+                if (id == -1L) {
+                    id = framework_getNextBundleId(fw);
+                    firstNewId = firstNewId == -1L ? id : firstNewId;
+                }
+                char* loc = celix_utils_strdup(location);
+                if (loc == NULL || celix_arrayList_add(locations, loc) != CELIX_SUCCESS) {
+                    free(loc);
+                    break;
+                }
+                celix_arrayList_addLong(ids, id);
+                celix_stringHashMap_put(seen, location, NULL);
+            }
+            location = strtok_r(NULL, " ", &savePtr);
+        }
+        celix_utils_freeStringIfNotEqual(buffer, list);
+    }
+
+    size_t nrOfArchives = celix_arrayList_size(ids);
+    celix_autofree long* bndIds = calloc(nrOfArchives + 1, sizeof(*bndIds));
+    celix_autofree const char** locs = calloc(nrOfArchives + 1, sizeof(*locs));
+    celix_autofree bundle_archive_t** archives = calloc(nrOfArchives + 1, sizeof(*archives));
+    if (nrOfArchives == 0 || !bndIds || !locs || !archives) {
+        if (firstNewId != -1L) {
+            __atomic_store_n(&fw->currentBundleId, firstNewId, __ATOMIC_SEQ_CST);
+        }
+        celixThreadMutex_unlock(&fw->installLock);
+        return NULL;
+    }
+    for (size_t i = 0; i < nrOfArchives; ++i) {
+        bndIds[i] = celix_arrayList_getLong(ids, (int)i);
+        locs[i] = celix_arrayList_get(locations, (int)i);
+    }
+
+    (void)celix_bundleCache_createArchives(fw->cache, nrOfArchives, bndIds, locs, nrOfThreads, archives);
+
+    //note bundles for which no archive could be created, are installed (and reported) the regular way. To keep the
+    //bundle ids in list order without gaps, the archives with a new bundle id after the first failure are removed
+    //again and their bundle ids are released.
+    long releaseFromId = -1L;
+    for (size_t i = 0; i < nrOfArchives; ++i) {
+        bool newId = firstNewId != -1L && bndIds[i] >= firstNewId;
+        if (archives[i] == NULL) {
+            releaseFromId = newId && releaseFromId == -1L ? bndIds[i] : releaseFromId;
+        } else if (newId && releaseFromId != -1L) {
+            celix_bundleArchive_invalidate(archives[i]);
+            celix_bundleCache_destroyArchive(fw->cache, archives[i]);
+        } else if (celix_stringHashMap_put(result, locs[i], archives[i]) != CELIX_SUCCESS) {
+            celix_bundleCache_destroyArchive(fw->cache, archives[i]);
+        }
+    }
+    if (releaseFromId != -1L) {
+        __atomic_store_n(&fw->currentBundleId, releaseFromId, __ATOMIC_SEQ_CST);
+    }
+    celixThreadMutex_unlock(&fw->installLock);
+    fw_log(fw->logger, CELIX_LOG_LEVEL_DEBUG, "Created %zu of %zu bundle archives using %zu threads.",
+           celix_stringHashMap_size(result), nrOfArchives, nrOfThreads);
+    return celix_steal_ptr(result);
+}
+
+/**
+ * Destroys the prepared archives which are not used for installing a bundle.
+ */
+static void framework_destroyPreparedBundleArchives(celix_framework_t* fw, celix_string_hash_map_t* preparedArchives) {
+    if (preparedArchives != NULL) {
+        CELIX_STRING_HASH_MAP_ITERATE(preparedArchives, iter) {
+            celix_bundleCache_destroyArchive(fw->cache, iter.value.ptrValue);
+        }
+        celix_stringHashMap_destroy(preparedArchives);
+    }
+}
+
+static celix_status_t framework_autoInstallConfiguredBundlesForList(celix_framework_t* fw, const char *autoStartIn, celix_array_list_t *installedBundles, celix_string_hash_map_t* preparedArchives) {
     celix_status_t status = CELIX_SUCCESS;
     char delims[] = " ";
     char *save_ptr = NULL;
@@ -523,7 +709,17 @@ static celix_status_t framework_autoInstallConfiguredBundlesForList(celix_framew
         while (location != NULL) {
             //first install
             long id = -1L;
-            if (celix_framework_installBundleInternal(fw, location, &id) == CELIX_SUCCESS) {
+            bundle_archive_t* archive = preparedArchives ? celix_stringHashMap_get(preparedArchives, location) : NULL;
+            celix_status_t installStatus;
+            if (archive != NULL) {
+                celix_stringHashMap_remove(preparedArchives, location);
+                celixThreadMutex_lock(&fw->installLock);
+                installStatus = celix_framework_installBundleInternalImpl(fw, location, &id, archive);
+                celixThreadMutex_unlock(&fw->installLock);
+            } else {
+                installStatus = celix_framework_installBundleInternal(fw, location, &id);
+            }
+            if (installStatus == CELIX_SUCCESS) {
                 if (installedBundles) {
                     celix_arrayList_addLong(installedBundles, id);
                 }
@@ -622,15 +818,19 @@ bool celix_framework_getConfigPropertyAsBool(celix_framework_t* framework, const
     return result;
 }
 
+/**
+ * Installs a bundle. If a prepared archive is provided, the archive is used for the bundle (ownership is transferred)
+ * instead of creating a new archive.
+ */
 static celix_status_t
-celix_framework_installBundleInternalImpl(celix_framework_t* framework, const char* bndLoc, long* bndId) {
+celix_framework_installBundleInternalImpl(celix_framework_t* framework, const char* bndLoc, long* bndId, bundle_archive_t* preparedArchive) {
     celix_status_t status = CELIX_SUCCESS;
     celix_bundle_t* bundle = NULL;
     long id = -1L;
 
     bundle_state_e state = CELIX_BUNDLE_STATE_UNKNOWN;
 
-    bool valid = celix_framework_utils_isBundleUrlValid(framework, bndLoc, false);
+    bool valid = preparedArchive != NULL || celix_framework_utils_isBundleUrlValid(framework, bndLoc, false);
     if (!valid) {
         return CELIX_FILE_IO_EXCEPTION;
     }
@@ -646,21 +846,36 @@ celix_framework_installBundleInternalImpl(celix_framework_t* framework, const ch
         }
     }
 
-    if (status == CELIX_SUCCESS) {
+    if (status != CELIX_SUCCESS && preparedArchive != NULL) {
+        celix_bundleCache_destroyArchive(framework->cache, preparedArchive);
+    } else if (status == CELIX_SUCCESS) {
         if (*bndId == -1L) {
             id = framework_getBundle(framework, bndLoc);
             if (id != -1L) {
+                if (preparedArchive != NULL) {
+                    //note bundle installed after the archive was prepared, the prepared archive uses the same dir.
+                    celix_bundleCache_destroyArchive(framework->cache, preparedArchive);
+                }
                 celix_framework_bundleEntry_decreaseUseCount(fwBundleEntry);
                 *bndId = id;
                 return CELIX_SUCCESS;
             }
+        }
+        if (preparedArchive != NULL) {
+            id = celix_bundleArchive_getId(preparedArchive);
+        } else if (*bndId == -1L) {
             long alreadyExistingBndId = celix_bundleCache_findBundleIdForLocation(framework->cache, bndLoc);
             id = alreadyExistingBndId == -1 ? framework_getNextBundleId(framework) : alreadyExistingBndId;
         } else {
             id = *bndId;
         }
-        bundle_archive_t* archive = NULL;
-        status = CELIX_DO_IF(status, celix_bundleCache_createArchive(framework->cache, id, bndLoc, &archive));
+    }
+
+    if (status == CELIX_SUCCESS) {
+        bundle_archive_t* archive = preparedArchive;
+        if (archive == NULL) {
+            status = celix_bundleCache_createArchive(framework->cache, id, bndLoc, &archive);
+        }
         status = CELIX_DO_IF(status, celix_bundle_createFromArchive(framework, archive, &bundle));
         if (status == CELIX_SUCCESS) {
             celix_framework_bundle_entry_t *bEntry = fw_bundleEntry_create(bundle);
@@ -687,7 +902,7 @@ celix_status_t
 celix_framework_installBundleInternal(celix_framework_t* framework, const char* bndLoc, long* bndId) {
     celix_status_t status = CELIX_SUCCESS;
     celixThreadMutex_lock(&framework->installLock);
-    status = celix_framework_installBundleInternalImpl(framework, bndLoc, bndId);
+    status = celix_framework_installBundleInternalImpl(framework, bndLoc, bndId, NULL);
     celixThreadMutex_unlock(&framework->installLock);
     return status;
 }
@@ -1736,8 +1951,96 @@ void celix_framework_unregister(celix_framework_t* fw, celix_bundle_t* bnd, long
     }
 }
 
+typedef struct celix_framework_register_services_data {
+    celix_framework_t* fw;
+    celix_bundle_t* bnd;
+    celix_service_registry_batch_entry_t* entries;
+    size_t nrOfEntries;
+    celix_status_t status;
+} celix_framework_register_services_data_t;
+
+static void celix_framework_registerServicesOnEventLoop(void* data) {
+    celix_framework_register_services_data_t* d = data;
+    d->status = celix_serviceRegistry_registerServices(d->fw->registry, d->bnd, d->entries, d->nrOfEntries);
+}
+
+celix_status_t celix_framework_registerServices(celix_framework_t* fw, celix_bundle_t* bnd, celix_service_registry_batch_entry_t* entries, size_t nrOfEntries) {
+    celix_framework_register_services_data_t data = {fw, bnd, entries, nrOfEntries, CELIX_SUCCESS};
+    long bndId = celix_bundle_getId(bnd);
+    if (celix_framework_isCurrentThreadTheEventLoop(fw)) {
+        celix_framework_bundle_entry_t *entry = celix_framework_bundleEntry_getBundleEntryAndIncreaseUseCount(fw, bndId);
+        celix_framework_registerServicesOnEventLoop(&data);
+        celix_framework_bundleEntry_decreaseUseCount(entry);
+    } else {
+        //note the batch is handled as a single event, so that it is ordered with the other (un)registration events
+        long eventId = celix_framework_fireGenericEvent(fw, -1, bndId, "register services batch", &data, celix_framework_registerServicesOnEventLoop, NULL, NULL);
+        celix_framework_waitForGenericEvent(fw, eventId);
+    }
+    framework_logIfError(fw->logger, data.status, NULL, "Cannot register batch of %zu services", nrOfEntries);
+    return data.status;
+}
+
+typedef struct celix_framework_unregister_services_data {
+    celix_framework_t* fw;
+    celix_bundle_t* bnd;
+    const long* serviceIds;
+    size_t nrOfServiceIds;
+} celix_framework_unregister_services_data_t;
+
+static void celix_framework_unregisterServicesOnEventLoop(void* data) {
+    celix_framework_unregister_services_data_t* d = data;
+    celix_serviceRegistry_unregisterServices(d->fw->registry, d->bnd, d->serviceIds, d->nrOfServiceIds);
+}
+
+void celix_framework_unregisterServices(celix_framework_t* fw, celix_bundle_t* bnd, const long* serviceIds, size_t nrOfServiceIds) {
+    celix_autofree long* ids = malloc(nrOfServiceIds * sizeof(*ids));
+    if (ids == NULL) {
+        for (size_t i = 0; i < nrOfServiceIds; ++i) {
+            celix_framework_unregister(fw, bnd, serviceIds[i]);
+        }
+        return;
+    }
+    size_t nrOfIds = 0;
+    for (size_t i = 0; i < nrOfServiceIds; ++i) {
+        if (!celix_framework_cancelServiceRegistrationIfPending(fw, bnd, serviceIds[i])) {
+            ids[nrOfIds++] = serviceIds[i];
+        }
+    }
+
+    celix_framework_unregister_services_data_t data = {fw, bnd, ids, nrOfIds};
+    if (celix_framework_isCurrentThreadTheEventLoop(fw)) {
+        celix_framework_unregisterServicesOnEventLoop(&data);
+    } else {
+        long eventId = celix_framework_fireGenericEvent(fw, -1, celix_bundle_getId(bnd), "unregister services batch", &data, celix_framework_unregisterServicesOnEventLoop, NULL, NULL);
+        celix_framework_waitForGenericEvent(fw, eventId);
+    }
+}
+
+/**
+ * @brief Returns true - and logs an error - if the current thread is a dm worker thread and therefore must not wait for
+ * the Celix event thread.
+ *
+ * A dm component life cycle callback on a dm worker thread can run while the event thread waits for the callback to
+ * return (e.g. to remove a service dependency the callback can be using), so waiting on the event thread from a dm
+ * worker thread can deadlock.
+ */
+static bool celix_framework_isWaitFromDmWorkerThread(celix_framework_t* fw, const char* waitFunction) {
+    if (!celix_private_dependencyManager_isCurrentThreadAWorker(fw)) {
+        return false;
+    }
+    fw_log(fw->logger,
+           CELIX_LOG_LEVEL_ERROR,
+           "%s called from a dm component life cycle callback on a dm worker thread. Waiting on the Celix event "
+           "thread from a dm worker thread is not supported, returning without waiting. Use the async variants.",
+           waitFunction);
+    return true;
+}
+
 void celix_framework_waitForAsyncRegistration(framework_t *fw, long svcId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (celix_framework_isWaitFromDmWorkerThread(fw, __FUNCTION__)) {
+        return;
+    }
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     bool registrationsInProgress = true;
@@ -1768,6 +2071,9 @@ void celix_framework_waitForAsyncRegistration(framework_t *fw, long svcId) {
 
 void celix_framework_waitForAsyncUnregistration(framework_t *fw, long svcId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (celix_framework_isWaitFromDmWorkerThread(fw, __FUNCTION__)) {
+        return;
+    }
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     bool registrationsInProgress = true;
@@ -1798,6 +2104,9 @@ void celix_framework_waitForAsyncUnregistration(framework_t *fw, long svcId) {
 
 void celix_framework_waitForAsyncRegistrations(framework_t *fw, long bndId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (celix_framework_isWaitFromDmWorkerThread(fw, __FUNCTION__)) {
+        return;
+    }
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     bool registrationsInProgress = true;
@@ -2378,7 +2687,7 @@ celix_status_t celix_framework_updateBundleEntry(celix_framework_t* framework,
             break;
         }
         // bndEntry is now invalid
-        status = celix_framework_installBundleInternalImpl(framework, updatedBundleUrl, &bundleId);
+        status = celix_framework_installBundleInternalImpl(framework, updatedBundleUrl, &bundleId, NULL);
         if (status != CELIX_SUCCESS) {
             errMsg = "reinstall failure";
             celixThreadMutex_unlock(&framework->installLock);
@@ -2439,6 +2748,9 @@ celix_array_list_t* celix_framework_listInstalledBundles(celix_framework_t* fram
 
 celix_status_t celix_framework_waitForEmptyEventQueueFor(celix_framework_t *fw, double periodInSeconds) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (celix_framework_isWaitFromDmWorkerThread(fw, __FUNCTION__)) {
+        return CELIX_ILLEGAL_STATE;
+    }
     celix_status_t status = CELIX_SUCCESS;
 
     struct timespec absTimeout = {0, 0};
@@ -2465,6 +2777,9 @@ void celix_framework_waitForEmptyEventQueue(celix_framework_t *fw) {
 
 void celix_framework_waitUntilNoEventsForBnd(celix_framework_t* fw, long bndId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (celix_framework_isWaitFromDmWorkerThread(fw, __FUNCTION__)) {
+        return;
+    }
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     bool eventInProgress = true;
@@ -2495,6 +2810,9 @@ void celix_framework_waitUntilNoEventsForBnd(celix_framework_t* fw, long bndId)
 void celix_framework_waitUntilNoPendingRegistration(celix_framework_t* fw)
 {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (celix_framework_isWaitFromDmWorkerThread(fw, __FUNCTION__)) {
+        return;
+    }
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     while (__atomic_load_n(&fw->dispatcher.stats.nbRegister, __ATOMIC_RELAXED) > 0) {
         celixThreadCondition_wait(&fw->dispatcher.cond, &fw->dispatcher.mutex);
@@ -2698,6 +3016,9 @@ static bool celix_framework_isGenericEventInProgress(celix_framework_t* fw, long
 
 void celix_framework_waitForGenericEvent(celix_framework_t* fw, long eventId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (celix_framework_isWaitFromDmWorkerThread(fw, __FUNCTION__)) {
+        return;
+    }
     struct timespec logAbsTime = celixThreadCondition_getDelayedTime(5);
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     while (celix_framework_isGenericEventInProgress(fw, eventId)) {
@@ -197,6 +197,24 @@ struct celix_framework {
         celix_thread_mutex_t mutex; //protects below
         celix_array_list_t* bundleLifecycleHandlers; //entry = celix_framework_bundle_lifecycle_handler_t*
     } bundleLifecycleHandling;
+
+    struct {
+        long nrOfInactiveComponents; //atomic, nr of inactive components added to a dependency manager (for all bundles)
+        celix_thread_mutex_t mutex; //protects below
+        celix_thread_cond_t cond; //signals when a all components active listener is no longer in use
+        long nextListenerId;
+        celix_array_list_t* allActiveListeners; //entry = celix_dm_all_components_active_listener_t*
+    } dmComponents;
+
+    struct {
+        celix_thread_mutex_t mutex; //protects below
+        celix_thread_cond_t cond;
+        bool active;
+        size_t nrOfThreads;
+        celix_thread_t* threads; //note created on first use
+        size_t nrOfStartedThreads;
+        celix_array_list_t* queue; //entry = celix_dm_work_t*
+    } dmWorkers;
 };
 
 /**
@@ -329,6 +347,18 @@ void celix_framework_unregisterAsync(celix_framework_t* fw, celix_bundle_t* bnd,
  */
 void celix_framework_unregister(celix_framework_t* fw, celix_bundle_t* bnd, long serviceId);
 
+/**
+ * Register a batch of services or service factories and wait until the registrations are done.
+ * The batch is registered on the event loop thread, as a single event.
+ */
+celix_status_t celix_framework_registerServices(celix_framework_t* fw, celix_bundle_t* bnd, celix_service_registry_batch_entry_t* entries, size_t nrOfEntries);
+
+/**
+ * Unregister a batch of services and wait until the unregistrations are done.
+ * The batch is unregistered on the event loop thread, as a single event.
+ */
+void celix_framework_unregisterServices(celix_framework_t* fw, celix_bundle_t* bnd, const long* serviceIds, size_t nrOfServiceIds);
+
 /**
  * Wait til all service registration or unregistration events for a specific bundle are no longer present in the event queue.
  */
@@ -373,6 +403,18 @@ celix_framework_bundle_entry_t* celix_framework_bundleEntry_getBundleEntryAndInc
  */
 bool celix_framework_isBundleIdAlreadyUsed(celix_framework_t *fw, long bndId);
 
+/**
+ * @brief Returns the number of threads to use for creating the bundle archives of auto installed bundles.
+ * @see CELIX_AUTO_INSTALL_NR_OF_THREADS
+ */
+size_t celix_framework_getNrOfAutoInstallThreads(celix_framework_t* fw);
+
+/**
+ * @brief Returns the number of dependency manager worker threads.
+ * @see CELIX_FRAMEWORK_DM_NR_OF_WORKER_THREADS
+ */
+size_t celix_framework_getNrOfDmWorkerThreads(celix_framework_t* fw);
+
 /**
  * @brief Check if a bundle with the provided bundle symbolic name is already installed.
  */
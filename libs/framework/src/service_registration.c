@@ -24,6 +24,7 @@
 #include "celix_build_assert.h"
 #include "celix_constants.h"
 #include "celix_err.h"
+#include "celix_string_intern.h"
 #include "service_registration_private.h"
 
 static bool serviceRegistration_destroy(struct celix_ref *);
@@ -65,7 +66,12 @@ static celix_status_t serviceRegistration_createInternal(registry_callback_t cal
         celix_ref_init(&reg->refCount);
         reg->callback = callback;
         reg->svcType = svcType;
-        reg->className = strndup(serviceName, 1024 * 10);
+        reg->classNameInterned = celix_stringIntern_isEnabled();
+        if (reg->classNameInterned) {
+            reg->className = (char*)celix_stringIntern_acquire(serviceName);
+        } else {
+            reg->className = strndup(serviceName, 1024 * 10);
+        }
         reg->bundle = bundle;
         reg->serviceId = serviceId;
         reg->svcObj = serviceObject;
@@ -96,7 +102,11 @@ static bool serviceRegistration_destroy(struct celix_ref *refCount) {
     CELIX_BUILD_ASSERT(offsetof(service_registration_t, refCount) == 0);
 
     //fw_log(logger, CELIX_LOG_LEVEL_DEBUG, "Destroying service registration %p\n", registration);
-    free(registration->className);
+    if (registration->classNameInterned) {
+        celix_stringIntern_release(registration->className);
+    } else {
+        free(registration->className);
+    }
     registration->className = NULL;
     registration->callback.unregister = NULL;
     properties_destroy(registration->properties);
@@ -118,6 +128,8 @@ static celix_status_t serviceRegistration_initializeProperties(service_registrat
     CELIX_DO_IF(status, status = celix_properties_set(props, CELIX_FRAMEWORK_SERVICE_NAME, registration->className));
 
     if (status == CELIX_SUCCESS) {
+        //note registration properties are immutable, freezing them allows cheap lazy copies (e.g. for service infos)
+        celix_properties_freeze(props);
         registration->properties = props;
     } else {
         celix_err_push("Cannot initialize service registration properties");
@@ -36,6 +36,7 @@ struct serviceRegistration {
     registry_callback_t callback; // read-only
 
     char* className;          // read-only
+    bool classNameInterned;   // read-only, whether className is interned (see celix_string_intern.h)
     bundle_pt bundle;         // read-only
     properties_pt properties; // read-only
     long serviceId;           // read-only
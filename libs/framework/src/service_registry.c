@@ -41,6 +41,7 @@ static void serviceRegistry_logWarningServiceReferenceUsageCount(service_registr
 static celix_status_t serviceRegistry_getUsingBundles(service_registry_pt registry, service_registration_pt reg, array_list_pt *bundles);
 static celix_status_t serviceRegistry_getServiceReference_internal(service_registry_pt registry, bundle_pt owner, service_registration_pt registration, service_reference_pt *out);
 static void celix_serviceRegistry_serviceChanged(celix_service_registry_t *registry, celix_service_event_type_t eventType, service_registration_pt registration);
+static void celix_serviceRegistry_servicesChanged(celix_service_registry_t *registry, celix_service_event_type_t eventType, service_registration_t** registrations, size_t nrOfRegistrations);
 static void serviceRegistry_callHooksForListenerFilter(service_registry_pt registry, celix_bundle_t *owner, const celix_filter_t *filter, bool removed);
 
     static celix_service_registry_listener_hook_entry_t* celix_createHookEntry(long svcId, celix_listener_hook_service_t*);
@@ -177,28 +178,34 @@ celix_status_t serviceRegistry_registerServiceFactory(service_registry_pt regist
     return serviceRegistry_registerServiceInternal(registry, bundle, serviceName, (const void *) factory, dictionary, 0 /*TODO*/, CELIX_DEPRECATED_FACTORY_SERVICE, registration);
 }
 
-static celix_status_t serviceRegistry_registerServiceInternal(service_registry_pt registry, bundle_pt bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, long reservedId, enum celix_service_type svcType, service_registration_pt *registration) {
-    array_list_pt regs;
-    long svcId = reservedId > 0 ? reservedId : celix_serviceRegistry_nextSvcId(registry);
-
+static service_registration_t* serviceRegistry_createRegistration(service_registry_pt registry, bundle_pt bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, long svcId, enum celix_service_type svcType) {
+    service_registration_t* registration;
     celix_properties_setLong(dictionary, CELIX_FRAMEWORK_SERVICE_BUNDLE_ID, celix_bundle_getId(bundle));
 
     if (svcType == CELIX_DEPRECATED_FACTORY_SERVICE) {
         celix_properties_set(dictionary, CELIX_FRAMEWORK_SERVICE_SCOPE, CELIX_FRAMEWORK_SERVICE_SCOPE_BUNDLE);
-        *registration = serviceRegistration_createServiceFactory(registry->callback, bundle, serviceName,
+        registration = serviceRegistration_createServiceFactory(registry->callback, bundle, serviceName,
                                                                  svcId, serviceObject,
                                                                  dictionary);
     } else if (svcType == CELIX_FACTORY_SERVICE) {
         celix_properties_set(dictionary, CELIX_FRAMEWORK_SERVICE_SCOPE, CELIX_FRAMEWORK_SERVICE_SCOPE_BUNDLE);
-        *registration = celix_serviceRegistration_createServiceFactory(registry->callback, bundle, serviceName, svcId, (celix_service_factory_t*)serviceObject, dictionary);
+        registration = celix_serviceRegistration_createServiceFactory(registry->callback, bundle, serviceName, svcId, (celix_service_factory_t*)serviceObject, dictionary);
     } else { //plain
         celix_properties_set(dictionary, CELIX_FRAMEWORK_SERVICE_SCOPE, CELIX_FRAMEWORK_SERVICE_SCOPE_SINGLETON);
-        *registration = serviceRegistration_create(registry->callback, bundle, serviceName, svcId, serviceObject, dictionary);
+        registration = serviceRegistration_create(registry->callback, bundle, serviceName, svcId, serviceObject, dictionary);
     }
     //printf("Registering service %li with name %s\n", svcId, serviceName);
     if (strcmp(OSGI_FRAMEWORK_LISTENER_HOOK_SERVICE_NAME, serviceName) == 0) {
-        serviceRegistry_addHooks(registry, serviceName, serviceObject, *registration);
+        serviceRegistry_addHooks(registry, serviceName, serviceObject, registration);
     }
+    return registration;
+}
+
+static celix_status_t serviceRegistry_registerServiceInternal(service_registry_pt registry, bundle_pt bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, long reservedId, enum celix_service_type svcType, service_registration_pt *registration) {
+    array_list_pt regs;
+    long svcId = reservedId > 0 ? reservedId : celix_serviceRegistry_nextSvcId(registry);
+
+    *registration = serviceRegistry_createRegistration(registry, bundle, serviceName, serviceObject, dictionary, svcId, svcType);
 
 	celixThreadRwlock_writeLock(&registry->lock);
 	regs = (array_list_pt) hashMap_get(registry->serviceRegistrations, bundle);
@@ -736,6 +743,61 @@ celix_serviceRegistry_registerService(
     return serviceRegistry_registerServiceInternal(reg, (celix_bundle_t*)bnd, serviceName, (const void *) service, props, reserveId, CELIX_PLAIN_SERVICE, registration);
 }
 
+celix_status_t celix_serviceRegistry_registerServices(
+        celix_service_registry_t* registry,
+        const celix_bundle_t* bnd,
+        celix_service_registry_batch_entry_t* entries,
+        size_t nrOfEntries) {
+    if (nrOfEntries == 0) {
+        return CELIX_SUCCESS;
+    }
+    celix_bundle_t* bundle = (celix_bundle_t*)bnd;
+    celix_autofree service_registration_t** registrations = malloc(nrOfEntries * sizeof(*registrations));
+    if (registrations == NULL) {
+        for (size_t i = 0; i < nrOfEntries; ++i) {
+            celix_properties_destroy(entries[i].properties);
+            entries[i].svcId = -1L;
+        }
+        return CELIX_ENOMEM;
+    }
+
+    //reserve a consecutive range of service ids for the batch
+    long firstSvcId = __atomic_fetch_add(&registry->nextServiceId, (long)nrOfEntries, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        celix_service_registry_batch_entry_t* entry = &entries[i];
+        entry->svcId = firstSvcId + (long)i;
+        if (entry->factory != NULL) {
+            registrations[i] = serviceRegistry_createRegistration(registry, bundle, entry->serviceName, entry->factory, entry->properties, entry->svcId, CELIX_FACTORY_SERVICE);
+        } else {
+            registrations[i] = serviceRegistry_createRegistration(registry, bundle, entry->serviceName, entry->svc, entry->properties, entry->svcId, CELIX_PLAIN_SERVICE);
+        }
+        entry->properties = NULL; //ownership is transferred to the registration
+    }
+
+    celixThreadRwlock_writeLock(&registry->lock);
+    celix_array_list_t* regs = hashMap_get(registry->serviceRegistrations, bundle);
+    if (regs == NULL) {
+        regs = celix_arrayList_create();
+        hashMap_put(registry->serviceRegistrations, bundle, regs);
+    }
+    celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        celix_arrayList_add(regs, registrations[i]);
+        //note pending register events are increased while holding the registry lock, same as for a single registration
+        long count = (long)hashMap_get(registry->pendingRegisterEvents.map, (void*)entries[i].svcId);
+        hashMap_put(registry->pendingRegisterEvents.map, (void*)entries[i].svcId, (void*)(count + 1));
+    }
+    celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+    celixThreadRwlock_unlock(&registry->lock);
+
+    celix_serviceRegistry_servicesChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED, registrations, nrOfEntries);
+
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        celix_decreasePendingRegisteredEvent(registry, entries[i].svcId);
+    }
+    return CELIX_SUCCESS;
+}
+
 static celix_service_registry_listener_hook_entry_t* celix_createHookEntry(long svcId, celix_listener_hook_service_t *hook) {
     celix_service_registry_listener_hook_entry_t* entry = calloc(1, sizeof(*entry));
     entry->svcId = svcId;
@@ -955,7 +1017,7 @@ bool celix_serviceRegistry_getServiceInfo(
                 if (outServiceProperties != NULL) {
                     celix_properties_t *p = NULL;
                     serviceRegistration_getProperties(reg, &p);
-                    *outServiceProperties = celix_properties_copy(p);
+                    *outServiceProperties = celix_properties_lazyCopy(p);
                 }
                 if (outIsFactory != NULL) {
                     *outIsFactory = serviceRegistration_isFactoryService(reg);
@@ -1118,6 +1180,66 @@ static void celix_serviceRegistry_serviceChanged(celix_service_registry_t *regis
 }
 
 
+/**
+ * Same as celix_serviceRegistry_serviceChanged, but for multiple registrations. The events are grouped per service
+ * listener: a service listener is called for all its matching registrations before the next service listener is
+ * called.
+ */
+static void celix_serviceRegistry_servicesChanged(celix_service_registry_t *registry, celix_service_event_type_t eventType, service_registration_t** registrations, size_t nrOfRegistrations) {
+    celix_autoptr(celix_array_list_t) retainedEntries = celix_arrayList_create();
+    celix_autoptr(celix_array_list_t) matchedEntries = celix_arrayList_create();
+    celix_autoptr(celix_array_list_t) matchOffsets = celix_arrayList_create(); //start index in matches, per matched entry
+    celix_autoptr(celix_array_list_t) matches = celix_arrayList_create(); //registration indices
+
+    celixThreadRwlock_readLock(&registry->lock);
+    for (int i = 0; i < celix_arrayList_size(registry->serviceListeners); ++i) {
+        celix_service_registry_service_listener_entry_t* entry = celix_arrayList_get(registry->serviceListeners, i);
+        celix_arrayList_add(retainedEntries, entry);
+        celix_increaseCountServiceListener(entry);
+    }
+    celixThreadRwlock_unlock(&registry->lock);
+
+    //note first match all entries, so that not matching entries are released before any listener is called.
+    for (int i = 0; i < celix_arrayList_size(retainedEntries); ++i) {
+        celix_service_registry_service_listener_entry_t* entry = celix_arrayList_get(retainedEntries, i);
+        int offset = celix_arrayList_size(matches);
+        for (size_t r = 0; r < nrOfRegistrations; ++r) {
+            bool matchResult = entry->filter == NULL;
+            if (!matchResult) {
+                celix_properties_t* props = NULL;
+                serviceRegistration_getProperties(registrations[r], &props);
+                filter_match(entry->filter, props, &matchResult);
+            }
+            if (matchResult) {
+                celix_arrayList_addLong(matches, (long)r);
+            }
+        }
+        if (celix_arrayList_size(matches) > offset) {
+            celix_arrayList_add(matchedEntries, entry);
+            celix_arrayList_addLong(matchOffsets, offset);
+        } else {
+            celix_decreaseCountServiceListener(entry); //Not a match -> release entry
+        }
+    }
+
+    for (int i = 0; i < celix_arrayList_size(matchedEntries); ++i) {
+        celix_service_registry_service_listener_entry_t* entry = celix_arrayList_get(matchedEntries, i);
+        int begin = (int)celix_arrayList_getLong(matchOffsets, i);
+        int end = i + 1 < celix_arrayList_size(matchOffsets) ? (int)celix_arrayList_getLong(matchOffsets, i + 1) : celix_arrayList_size(matches);
+        for (int m = begin; m < end; ++m) {
+            service_registration_t* registration = registrations[celix_arrayList_getLong(matches, m)];
+            service_reference_pt reference = NULL;
+            celix_service_event_t event;
+            serviceRegistry_getServiceReference(registry, entry->bundle, registration, &reference);
+            event.type = eventType;
+            event.reference = reference;
+            entry->listener->serviceChanged(entry->listener->handle, &event);
+            serviceReference_release(reference, NULL);
+        }
+        celix_decreaseCountServiceListener(entry);
+    }
+}
+
 static void celix_increasePendingRegisteredEvent(celix_service_registry_t *registry, long svcId) {
     celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
     long count = (long)hashMap_get(registry->pendingRegisterEvents.map, (void*)svcId);
@@ -1198,3 +1320,108 @@ void celix_serviceRegistry_unregisterService(celix_service_registry_t* registry,
         fw_log(registry->framework->logger, CELIX_LOG_LEVEL_ERROR, "Cannot unregister service for service id %li. This id is not present or owned by the provided bundle (bnd id %li)", serviceId, celix_bundle_getId(bnd));
     }
 }
+
+void celix_serviceRegistry_unregisterServices(celix_service_registry_t* registry, celix_bundle_t* bnd, const long* serviceIds, size_t nrOfServiceIds) {
+    if (nrOfServiceIds == 0) {
+        return;
+    }
+    celix_autoptr(celix_long_hash_map_t) requestedIds = celix_longHashMap_create();
+    for (size_t i = 0; i < nrOfServiceIds; ++i) {
+        celix_longHashMap_putBool(requestedIds, serviceIds[i], true);
+    }
+
+    celix_autoptr(celix_array_list_t) registrations = celix_arrayList_create();
+    celixThreadRwlock_readLock(&registry->lock);
+    celix_array_list_t* regs = hashMap_get(registry->serviceRegistrations, (void*)bnd);
+    for (int i = 0; regs != NULL && i < celix_arrayList_size(regs); ++i) {
+        service_registration_t* entry = celix_arrayList_get(regs, i);
+        if (celix_longHashMap_remove(requestedIds, serviceRegistration_getServiceId(entry))) {
+            //note same as serviceRegistration_unregister, ensure a registration is only unregistered once.
+            bool unregistering = false;
+            if (__atomic_compare_exchange_n(&entry->isUnregistering, &unregistering, true, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                serviceRegistration_retain(entry);
+                celix_arrayList_add(registrations, entry);
+            }
+        }
+    }
+    celixThreadRwlock_unlock(&registry->lock);
+
+    CELIX_LONG_HASH_MAP_ITERATE(requestedIds, iter) {
+        fw_log(registry->framework->logger, CELIX_LOG_LEVEL_ERROR, "Cannot unregister service for service id %li. This id is not present or owned by the provided bundle (bnd id %li)", iter.key, celix_bundle_getId(bnd));
+    }
+
+    int size = celix_arrayList_size(registrations);
+    if (size == 0) {
+        return;
+    }
+    celix_autofree service_registration_t** unregistering = malloc(size * sizeof(*unregistering));
+    if (unregistering == NULL) {
+        //fallback to unregistering one by one
+        for (int i = 0; i < size; ++i) {
+            service_registration_t* reg = celix_arrayList_get(registrations, i);
+            serviceRegistry_unregisterService(registry, bnd, reg);
+            serviceRegistration_release(reg);
+        }
+        return;
+    }
+    celix_autoptr(celix_long_hash_map_t) unregisteringIds = celix_longHashMap_create();
+    for (int i = 0; i < size; ++i) {
+        unregistering[i] = celix_arrayList_get(registrations, i);
+        celix_longHashMap_putBool(unregisteringIds, serviceRegistration_getServiceId(unregistering[i]), true);
+        const char* svcName = NULL;
+        serviceRegistration_getServiceName(unregistering[i], &svcName);
+        if (strcmp(OSGI_FRAMEWORK_LISTENER_HOOK_SERVICE_NAME, svcName) == 0) {
+            serviceRegistry_removeHook(registry, unregistering[i]);
+        }
+    }
+
+    celixThreadRwlock_writeLock(&registry->lock);
+    regs = hashMap_get(registry->serviceRegistrations, (void*)bnd);
+    if (regs != NULL) {
+        //compact the registrations list in a single pass, instead of a removeElement call per registration
+        celix_array_list_t* remaining = celix_arrayList_create();
+        for (int i = 0; i < celix_arrayList_size(regs); ++i) {
+            service_registration_t* entry = celix_arrayList_get(regs, i);
+            if (!celix_longHashMap_hasKey(unregisteringIds, serviceRegistration_getServiceId(entry))) {
+                celix_arrayList_add(remaining, entry);
+            }
+        }
+        celix_arrayList_destroy(regs);
+        if (celix_arrayList_size(remaining) == 0) {
+            celix_arrayList_destroy(remaining);
+            hashMap_remove(registry->serviceRegistrations, bnd);
+        } else {
+            hashMap_put(registry->serviceRegistrations, bnd, remaining);
+        }
+    }
+    celixThreadRwlock_unlock(&registry->lock);
+
+    //check and wait for pending register events
+    for (int i = 0; i < size; ++i) {
+        celix_waitForPendingRegisteredEvents(registry, serviceRegistration_getServiceId(unregistering[i]));
+    }
+
+    celix_serviceRegistry_servicesChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING, unregistering, size);
+
+    celixThreadRwlock_readLock(&registry->lock);
+    //invalidate service references
+    hash_map_iterator_t iter = hashMapIterator_construct(registry->serviceReferences);
+    while (hashMapIterator_hasNext(&iter)) {
+        hash_map_pt refsMap = hashMapIterator_nextValue(&iter);
+        for (int i = 0; refsMap != NULL && i < size; ++i) {
+            service_reference_pt ref = hashMap_get(refsMap, (void*)unregistering[i]->serviceId);
+            if (ref != NULL) {
+                serviceReference_invalidateCache(ref);
+            }
+        }
+    }
+    for (int i = 0; i < size; ++i) {
+        serviceRegistration_invalidate(unregistering[i]);
+    }
+    celixThreadRwlock_unlock(&registry->lock);
+
+    for (int i = 0; i < size; ++i) {
+        serviceRegistration_release(unregistering[i]); //registry ownership
+        serviceRegistration_release(unregistering[i]); //retained for this call
+    }
+}
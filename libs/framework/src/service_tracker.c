@@ -34,6 +34,7 @@
 #include "celix_log.h"
 #include "bundle_context_private.h"
 #include "celix_array_list.h"
+#include "celix_stdlib_cleanup.h"
 
 static celix_status_t serviceTracker_track(service_tracker_t *tracker, service_reference_pt reference, celix_service_event_t *event);
 static celix_status_t serviceTracker_untrack(service_tracker_t *tracker, service_reference_pt reference);
@@ -45,6 +46,8 @@ static void serviceTracker_checkAndInvokeSetService(void *handle, void *highestS
 
 static void serviceTracker_serviceChanged(void *handle, celix_service_event_t *event);
 
+#define CELIX_SERVICE_TRACKER_USE_SERVICES_STACK_SIZE 16
+
 
 static inline celix_tracked_entry_t* tracked_create(service_reference_pt ref, void *svc, celix_properties_t *props, celix_bundle_t *bnd) {
     celix_tracked_entry_t *tracked = calloc(1, sizeof(*tracked));
@@ -63,22 +66,29 @@ static inline celix_tracked_entry_t* tracked_create(service_reference_pt ref, vo
 }
 
 static inline void tracked_retain(celix_tracked_entry_t *tracked) {
-    celixThreadMutex_lock(&tracked->mutex);
-    tracked->useCount += 1;
-    celixThreadMutex_unlock(&tracked->mutex);
+    __atomic_add_fetch(&tracked->useCount, 1, __ATOMIC_ACQ_REL);
 }
 
 static inline void tracked_release(celix_tracked_entry_t *tracked) {
+    size_t count = __atomic_load_n(&tracked->useCount, __ATOMIC_ACQUIRE);
+    while (count > 1) {
+        //not the last use, release without locking
+        if (__atomic_compare_exchange_n(&tracked->useCount, &count, count - 1, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+    }
+    //(probably) the last use, release while holding the mutex so that tracked_waitAndDestroy cannot miss the signal
     celixThreadMutex_lock(&tracked->mutex);
-    assert(tracked->useCount > 0);
-    tracked->useCount -= 1;
-    celixThreadCondition_signal(&tracked->useCond);
+    assert(__atomic_load_n(&tracked->useCount, __ATOMIC_ACQUIRE) > 0);
+    if (__atomic_sub_fetch(&tracked->useCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        celixThreadCondition_signal(&tracked->useCond);
+    }
     celixThreadMutex_unlock(&tracked->mutex);
 }
 
 static inline void tracked_waitAndDestroy(celix_tracked_entry_t *tracked) {
     celixThreadMutex_lock(&tracked->mutex);
-    while (tracked->useCount != 0) {
+    while (__atomic_load_n(&tracked->useCount, __ATOMIC_ACQUIRE) != 0) {
         celixThreadCondition_wait(&tracked->useCond, &tracked->mutex);
     }
     celixThreadMutex_unlock(&tracked->mutex);
@@ -89,6 +99,69 @@ static inline void tracked_waitAndDestroy(celix_tracked_entry_t *tracked) {
     free(tracked);
 }
 
+static inline bool tracked_isHigherRanking(celix_tracked_entry_t* tracked, celix_tracked_entry_t* highest, const char* serviceName) {
+    if (serviceName != NULL && (tracked->serviceName == NULL || !celix_utils_stringEquals(tracked->serviceName, serviceName))) {
+        return false;
+    }
+    return highest == NULL ||
+           celix_utils_compareServiceIdsAndRanking(tracked->serviceId, tracked->serviceRanking,
+                                                   highest->serviceId, highest->serviceRanking) < 0;
+}
+
+/**
+ * Starts a lock-free read of the tracked services snapshot.
+ * The returned snapshot (can be NULL) and its entries are valid until serviceTracker_snapshotReadEnd is called.
+ * Readers must not block between serviceTracker_snapshotReadBegin and serviceTracker_snapshotReadEnd.
+ */
+static celix_tracked_snapshot_t* serviceTracker_snapshotReadBegin(service_tracker_t* tracker, unsigned int* phase) {
+    *phase = celix_gracePeriod_readBegin(tracker->snapshot.gracePeriod);
+    return __atomic_load_n(&tracker->snapshot.current, __ATOMIC_SEQ_CST);
+}
+
+static void serviceTracker_snapshotReadEnd(service_tracker_t* tracker, unsigned int phase) {
+    celix_gracePeriod_readEnd(tracker->snapshot.gracePeriod, phase);
+}
+
+/**
+ * Creates and publishes a new snapshot of the tracked services.
+ * Precondition: tracker->mutex is locked.
+ * Returns the replaced snapshot, which must be retired (after unlocking the mutex) with serviceTracker_retireSnapshot.
+ */
+static celix_tracked_snapshot_t* serviceTracker_publishSnapshot(service_tracker_t* tracker) {
+    int size = celix_arrayList_size(tracker->trackedServices);
+    celix_tracked_snapshot_t* snapshot = malloc(sizeof(*snapshot) + size * sizeof(celix_tracked_entry_t*));
+    if (snapshot != NULL) {
+        snapshot->highest = NULL;
+        snapshot->size = (size_t)size;
+        for (int i = 0; i < size; ++i) {
+            snapshot->entries[i] = celix_arrayList_get(tracker->trackedServices, i);
+            if (tracked_isHigherRanking(snapshot->entries[i], snapshot->highest, NULL)) {
+                snapshot->highest = snapshot->entries[i];
+            }
+        }
+    } else {
+        //note no snapshot, readers fallback to the tracker mutex
+        celix_bundleContext_log(tracker->context, CELIX_LOG_LEVEL_ERROR, "Cannot create tracked services snapshot");
+    }
+    return __atomic_exchange_n(&tracker->snapshot.current, snapshot, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Frees the replaced snapshot after a grace period, without waiting for the grace period.
+ * If the replaced snapshot does not contain a removed entry, readers can safely keep using it.
+ */
+static void serviceTracker_retireSnapshot(service_tracker_t* tracker, celix_tracked_snapshot_t* replaced) {
+    celix_gracePeriod_retire(tracker->snapshot.gracePeriod, replaced, free);
+}
+
+/**
+ * Waits for a grace period, after this call no reader can use (or retain an entry of) a replaced snapshot anymore.
+ * Must be called before a removed entry is untracked.
+ */
+static void serviceTracker_waitForSnapshotReaders(service_tracker_t* tracker) {
+    celix_gracePeriod_synchronize(tracker->snapshot.gracePeriod);
+}
+
 celix_status_t serviceTracker_create(bundle_context_pt context, const char * service, service_tracker_customizer_pt customizer, service_tracker_pt *tracker) {
 	celix_status_t status = CELIX_SUCCESS;
 
@@ -108,7 +181,17 @@ celix_status_t serviceTracker_create(bundle_context_pt context, const char * ser
 
 celix_status_t serviceTracker_createWithFilter(bundle_context_pt context, const char * filter, service_tracker_customizer_pt customizer, service_tracker_pt *out) {
 	service_tracker_t* tracker = calloc(1, sizeof(*tracker));
+    celix_grace_period_t* gracePeriod = celix_gracePeriod_create();
+    if (tracker == NULL || gracePeriod == NULL) {
+        free(tracker);
+        celix_gracePeriod_destroy(gracePeriod);
+        free(customizer);
+        *out = NULL;
+        framework_logIfError(context->framework->logger, CELIX_ENOMEM, NULL, "Cannot create service tracker");
+        return CELIX_ENOMEM;
+    }
 	*out = tracker;
+    tracker->snapshot.gracePeriod = gracePeriod;
 	tracker->state = CELIX_SERVICE_TRACKER_CLOSED;
     tracker->context = context;
     tracker->filter = celix_utils_strdup(filter);
@@ -141,6 +224,8 @@ celix_status_t serviceTracker_destroy(service_tracker_pt tracker) {
     celixThreadCondition_destroy(&tracker->condTracked);
     celixThreadCondition_destroy(&tracker->condUntracking);
     celix_arrayList_destroy(tracker->trackedServices);
+    celix_gracePeriod_destroy(tracker->snapshot.gracePeriod);
+    free(tracker->snapshot.current);
     free(tracker);
 	return CELIX_SUCCESS;
 }
@@ -219,14 +304,18 @@ celix_status_t serviceTracker_close(service_tracker_t* tracker) {
             celixThreadMutex_lock(&tracker->mutex);
             celix_tracked_entry_t *tracked = NULL;
             nrOfTrackedEntries = celix_arrayList_size(tracker->trackedServices);
+            celix_tracked_snapshot_t* replaced = NULL;
             if (nrOfTrackedEntries > 0) {
                 tracked = celix_arrayList_get(tracker->trackedServices, 0);
                 celix_arrayList_removeAt(tracker->trackedServices, 0);
                 tracker->untrackedServiceCount++;
+                replaced = serviceTracker_publishSnapshot(tracker);
             }
             celixThreadMutex_unlock(&tracker->mutex);
 
             if (tracked != NULL) {
+                serviceTracker_retireSnapshot(tracker, replaced);
+                serviceTracker_waitForSnapshotReaders(tracker);
                 int currentSize = nrOfTrackedEntries - 1;
                 serviceTracker_untrackTracked(tracker, tracked, currentSize, currentSize == 0);
                 celixThreadMutex_lock(&tracker->mutex);
@@ -413,8 +502,10 @@ static celix_status_t serviceTracker_track(service_tracker_t* tracker, service_r
 
             celixThreadMutex_lock(&tracker->mutex);
             arrayList_add(tracker->trackedServices, tracked);
+            celix_tracked_snapshot_t* replaced = serviceTracker_publishSnapshot(tracker);
             celixThreadCondition_broadcast(&tracker->condTracked);
             celixThreadMutex_unlock(&tracker->mutex);
+            serviceTracker_retireSnapshot(tracker, replaced);
 
             if (tracker->set != NULL || tracker->setWithProperties != NULL || tracker->setWithOwner != NULL) {
                 celix_serviceTracker_useHighestRankingService(tracker, NULL, 0, tracker, NULL, NULL,
@@ -517,6 +608,7 @@ static celix_status_t serviceTracker_invokeAddingService(service_tracker_t *trac
 static celix_status_t serviceTracker_untrack(service_tracker_t* tracker, service_reference_pt reference) {
     celix_status_t status = CELIX_SUCCESS;
     celix_tracked_entry_t *remove = NULL;
+    celix_tracked_snapshot_t* replaced = NULL;
 
     celixThreadMutex_lock(&tracker->mutex);
     for (int i = 0; i < celix_arrayList_size(tracker->trackedServices); i++) {
@@ -528,6 +620,7 @@ static celix_status_t serviceTracker_untrack(service_tracker_t* tracker, service
             //remove from trackedServices to prevent getting this service, but don't destroy yet, can be in use
             celix_arrayList_removeAt(tracker->trackedServices, i);
             tracker->untrackedServiceCount++;
+            replaced = serviceTracker_publishSnapshot(tracker);
             break;
         }
     }
@@ -536,6 +629,9 @@ static celix_status_t serviceTracker_untrack(service_tracker_t* tracker, service
 
     //note also syncing on untracking entries, to ensure no untrack is parallel in progress
     if (remove != NULL) {
+        //ensure no reader can retain the removed entry anymore
+        serviceTracker_retireSnapshot(tracker, replaced);
+        serviceTracker_waitForSnapshotReaders(tracker);
         serviceTracker_untrackTracked(tracker, remove, size, true);
         celixThreadMutex_lock(&tracker->mutex);
         tracker->untrackedServiceCount--;
@@ -652,8 +748,11 @@ celix_service_tracker_t* celix_serviceTracker_createClosedWithOptions(celix_bund
         return NULL;
     }
     tracker = calloc(1, sizeof(*tracker));
-    if (tracker == NULL) {
+    celix_grace_period_t* gracePeriod = celix_gracePeriod_create();
+    if (tracker == NULL || gracePeriod == NULL) {
         free(filter);
+        free(tracker);
+        celix_gracePeriod_destroy(gracePeriod);
         celix_framework_log(ctx->framework->logger,
                             CELIX_LOG_LEVEL_ERROR,
                             __FUNCTION__,
@@ -662,6 +761,7 @@ celix_service_tracker_t* celix_serviceTracker_createClosedWithOptions(celix_bund
                             "No memory for tracker.");
         return NULL;
     }
+    tracker->snapshot.gracePeriod = gracePeriod;
 
     tracker->context = ctx;
     tracker->serviceName = celix_utils_strdup(serviceName);
@@ -719,22 +819,40 @@ static celix_tracked_entry_t* celix_serviceTracker_findHighestRankingService(ser
     celix_tracked_entry_t* highest = NULL;
     for (int i = 0; i < celix_arrayList_size(tracker->trackedServices); ++i) {
         celix_tracked_entry_t* tracked = (celix_tracked_entry_t *) arrayList_get(tracker->trackedServices, i);
-        if (serviceName == NULL || (serviceName != NULL && tracked->serviceName != NULL &&
-                                    celix_utils_stringEquals(tracked->serviceName, serviceName))) {
-            if (highest == NULL) {
-                highest = tracked;
-            } else {
-                int compare = celix_utils_compareServiceIdsAndRanking(
-                        tracked->serviceId, tracked->serviceRanking,
-                        highest->serviceId, highest->serviceRanking
-                );
-                if (compare < 0) {
-                    highest = tracked;
+        if (tracked_isHigherRanking(tracked, highest, serviceName)) {
+            highest = tracked;
+        }
+    }
+    return highest;
+}
+
+/**
+ * Finds and retains the highest ranking entry using the lock-free tracked services snapshot.
+ * Returns false if there is no snapshot.
+ */
+static bool celix_serviceTracker_retainHighestRankingServiceFromSnapshot(service_tracker_t *tracker, const char* serviceName, celix_tracked_entry_t** highestOut) {
+    unsigned int phase;
+    celix_tracked_snapshot_t* snapshot = serviceTracker_snapshotReadBegin(tracker, &phase);
+    celix_tracked_entry_t* highest = NULL;
+    if (snapshot != NULL) {
+        highest = snapshot->highest;
+        if (highest != NULL && serviceName != NULL &&
+            (highest->serviceName == NULL || !celix_utils_stringEquals(highest->serviceName, serviceName))) {
+            //note service name does not match the overall highest ranking entry, scan the snapshot
+            highest = NULL;
+            for (size_t i = 0; i < snapshot->size; ++i) {
+                if (tracked_isHigherRanking(snapshot->entries[i], highest, serviceName)) {
+                    highest = snapshot->entries[i];
                 }
             }
         }
+        if (highest != NULL) {
+            tracked_retain(highest);
+        }
     }
-    return highest;
+    serviceTracker_snapshotReadEnd(tracker, phase);
+    *highestOut = highest;
+    return snapshot != NULL;
 }
 
 bool celix_serviceTracker_useHighestRankingService(service_tracker_t *tracker,
@@ -744,23 +862,29 @@ bool celix_serviceTracker_useHighestRankingService(service_tracker_t *tracker,
                                                    void (*use)(void *handle, void *svc),
                                                    void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
                                                    void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)) {
-    //first lock tracker and get highest ranking tracked entry
-    celixThreadMutex_lock(&tracker->mutex);
-    struct timespec absTime = celixThreadCondition_getDelayedTime(waitTimeoutInSeconds);
-    celix_tracked_entry_t* highest = celix_serviceTracker_findHighestRankingService(tracker, serviceName);
-    while (highest == NULL && waitTimeoutInSeconds > 0) {
-        celix_status_t waitStatus = celixThreadCondition_waitUntil(&tracker->condTracked, &tracker->mutex, &absTime);
-        if (waitStatus == ETIMEDOUT) {
-            break;
-        }
+    //first try to get (and retain) the highest ranking tracked entry without locking
+    celix_tracked_entry_t* highest = NULL;
+    bool snapshotUsed = celix_serviceTracker_retainHighestRankingServiceFromSnapshot(tracker, serviceName, &highest);
+
+    if (highest == NULL && (!snapshotUsed || waitTimeoutInSeconds > 0)) {
+        //lock tracker and get (or wait for) highest ranking tracked entry
+        celixThreadMutex_lock(&tracker->mutex);
+        struct timespec absTime = celixThreadCondition_getDelayedTime(waitTimeoutInSeconds);
         highest = celix_serviceTracker_findHighestRankingService(tracker, serviceName);
+        while (highest == NULL && waitTimeoutInSeconds > 0) {
+            celix_status_t waitStatus = celixThreadCondition_waitUntil(&tracker->condTracked, &tracker->mutex, &absTime);
+            if (waitStatus == ETIMEDOUT) {
+                break;
+            }
+            highest = celix_serviceTracker_findHighestRankingService(tracker, serviceName);
+        }
+        if (highest) {
+            // highest found, increase use count
+            tracked_retain(highest);
+        }
+        // unlock tracker so that the tracked entry can be removed from the trackedServices list if unregistered.
+        celixThreadMutex_unlock(&tracker->mutex);
     }
-    if (highest) {
-        // highest found, increase use count
-        tracked_retain(highest);
-    }
-    // unlock tracker so that the tracked entry can be removed from the trackedServices list if unregistered.
-    celixThreadMutex_unlock(&tracker->mutex);
 
     bool called = false;
     if (highest) {
@@ -789,21 +913,52 @@ size_t celix_serviceTracker_useServices(
         void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
         void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)) {
     size_t count = 0;
-    //first lock tracker, get tracked entries and increase use count
-    celixThreadMutex_lock(&tracker->mutex);
-    int size = celix_arrayList_size(tracker->trackedServices);
-    count = (size_t)size;
-    celix_tracked_entry_t *entries[size];
-    for (int i = 0; i < size; i++) {
-        celix_tracked_entry_t *tracked = (celix_tracked_entry_t *) arrayList_get(tracker->trackedServices, i);
-        tracked_retain(tracked);
-        entries[i] = tracked;
-    }
-    //unlock tracker so that the tracked entry can be removed from the trackedServices list if unregistered.
-    celixThreadMutex_unlock(&tracker->mutex);
+    celix_tracked_entry_t* stackEntries[CELIX_SERVICE_TRACKER_USE_SERVICES_STACK_SIZE];
+    celix_tracked_entry_t** entries = NULL;
+    celix_autofree celix_tracked_entry_t** allocatedEntries = NULL;
+
+    //first get tracked entries from the snapshot (without locking) and increase use count
+    unsigned int phase;
+    celix_tracked_snapshot_t* snapshot = serviceTracker_snapshotReadBegin(tracker, &phase);
+    if (snapshot != NULL) {
+        count = snapshot->size;
+        if (count <= CELIX_SERVICE_TRACKER_USE_SERVICES_STACK_SIZE) {
+            entries = stackEntries;
+        } else {
+            allocatedEntries = malloc(count * sizeof(*allocatedEntries));
+            entries = allocatedEntries;
+        }
+        if (entries != NULL) {
+            for (size_t i = 0; i < count; i++) {
+                tracked_retain(snapshot->entries[i]);
+                entries[i] = snapshot->entries[i];
+            }
+        }
+    }
+    serviceTracker_snapshotReadEnd(tracker, phase);
+
+    if (entries == NULL) {
+        //no snapshot, lock tracker, get tracked entries and increase use count
+        celixThreadMutex_lock(&tracker->mutex);
+        count = (size_t)celix_arrayList_size(tracker->trackedServices);
+        allocatedEntries = malloc((count + 1) * sizeof(*allocatedEntries));
+        if (allocatedEntries == NULL) {
+            celixThreadMutex_unlock(&tracker->mutex);
+            celix_bundleContext_log(tracker->context, CELIX_LOG_LEVEL_ERROR, "Cannot allocate tracked entries");
+            return 0;
+        }
+        entries = allocatedEntries;
+        for (size_t i = 0; i < count; i++) {
+            celix_tracked_entry_t *tracked = (celix_tracked_entry_t *) arrayList_get(tracker->trackedServices, (int)i);
+            tracked_retain(tracked);
+            entries[i] = tracked;
+        }
+        //unlock tracker so that the tracked entry can be removed from the trackedServices list if unregistered.
+        celixThreadMutex_unlock(&tracker->mutex);
+    }
 
     //then use entries and decrease use count
-    for (int i = 0; i < size; i++) {
+    for (size_t i = 0; i < count; i++) {
         celix_tracked_entry_t *entry = entries[i];
         //got service, call, decrease use count an signal useCond after.
         if (use != NULL) {
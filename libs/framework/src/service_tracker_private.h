@@ -20,6 +20,7 @@
 #ifndef SERVICE_TRACKER_PRIVATE_H_
 #define SERVICE_TRACKER_PRIVATE_H_
 
+#include "celix_grace_period.h"
 #include "service_tracker.h"
 #include "celix_types.h"
 
@@ -70,6 +71,16 @@ struct celix_serviceTracker {
     size_t untrackedServiceCount;
     enum celix_service_tracker_state state;
     long currentHighestServiceId;
+
+    /**
+     * Immutable snapshot of the tracked services, used for lock-free use of the tracked services.
+     * The snapshot is replaced (while holding the tracker mutex) if the tracked services change. A replaced snapshot
+     * is freed after a grace period: when all readers that could have seen the replaced snapshot are done.
+     */
+    struct {
+        struct celix_tracked_snapshot* current; //atomic, NULL if there is no snapshot (readers use the tracker mutex)
+        celix_grace_period_t* gracePeriod;      //grace period for the snapshot readers
+    } snapshot;
 };
 
 typedef struct celix_tracked_entry {
@@ -81,10 +92,16 @@ typedef struct celix_tracked_entry {
 	properties_t *properties;
 	bundle_t *serviceOwner;
 
-    celix_thread_mutex_t mutex; //protects useCount
+    celix_thread_mutex_t mutex; //used to signal useCond if the last use is released
 	celix_thread_cond_t useCond;
-    size_t useCount;
+    size_t useCount; //atomic
 } celix_tracked_entry_t;
 
+typedef struct celix_tracked_snapshot {
+    celix_tracked_entry_t* highest; //the highest ranking entry or NULL if there are no entries
+    size_t size;
+    celix_tracked_entry_t* entries[]; //the tracked entries, in tracking order
+} celix_tracked_snapshot_t;
+
 
 #endif /* SERVICE_TRACKER_PRIVATE_H_ */
@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "celix_properties.h"
+
+/**
+ * Benchmarks for getting, setting and iterating over properties with a different number of entries. Small properties
+ * (nr of entries <= CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE) use a small array map, larger properties use a
+ * hash map.
+ */
+class PropertiesBenchmark {
+public:
+    explicit PropertiesBenchmark(benchmark::State& state) : props{celix_properties_create()} {
+        auto nrOfEntries = state.range(0);
+        for (int64_t i = 0; i < nrOfEntries; ++i) {
+            keys.emplace_back(std::string{"service.property.key"} + std::to_string(i));
+            celix_properties_setLong(props, keys.back().c_str(), i);
+        }
+    }
+
+    ~PropertiesBenchmark() noexcept {
+        celix_properties_destroy(props);
+    }
+
+    PropertiesBenchmark(PropertiesBenchmark&&) = delete;
+    PropertiesBenchmark(const PropertiesBenchmark&) = delete;
+    PropertiesBenchmark& operator=(PropertiesBenchmark&&) = delete;
+    PropertiesBenchmark& operator=(const PropertiesBenchmark&) = delete;
+
+    celix_properties_t* props;
+    std::vector<std::string> keys{};
+};
+
+static void PropertiesBenchmark_get(benchmark::State& state) {
+    PropertiesBenchmark benchmark{state};
+    size_t index = 0;
+    for (auto _ : state) {
+        // This code gets timed
+        const auto& key = benchmark.keys[index++ % benchmark.keys.size()];
+        auto val = celix_properties_getAsLong(benchmark.props, key.c_str(), -1);
+        benchmark::DoNotOptimize(val);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void PropertiesBenchmark_getMissingKey(benchmark::State& state) {
+    PropertiesBenchmark benchmark{state};
+    for (auto _ : state) {
+        // This code gets timed
+        auto* val = celix_properties_get(benchmark.props, "missing.key", nullptr);
+        benchmark::DoNotOptimize(val);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void PropertiesBenchmark_setExistingKey(benchmark::State& state) {
+    PropertiesBenchmark benchmark{state};
+    size_t index = 0;
+    for (auto _ : state) {
+        // This code gets timed
+        const auto& key = benchmark.keys[index % benchmark.keys.size()];
+        auto status = celix_properties_setLong(benchmark.props, key.c_str(), (long)index++);
+        if (status != CELIX_SUCCESS) {
+            std::cerr << "ERROR: unexpected set result" << std::endl;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void PropertiesBenchmark_createAndFill(benchmark::State& state) {
+    PropertiesBenchmark benchmark{state};
+    for (auto _ : state) {
+        // This code gets timed
+        auto* props = celix_properties_create();
+        for (const auto& key : benchmark.keys) {
+            celix_properties_set(props, key.c_str(), "value");
+        }
+        celix_properties_destroy(props);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void PropertiesBenchmark_iterate(benchmark::State& state) {
+    PropertiesBenchmark benchmark{state};
+    for (auto _ : state) {
+        // This code gets timed
+        long sum = 0;
+        CELIX_PROPERTIES_ITERATE(benchmark.props, iter) {
+            sum += iter.entry.typed.longValue;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void PropertiesBenchmark_copy(benchmark::State& state) {
+    PropertiesBenchmark benchmark{state};
+    for (auto _ : state) {
+        // This code gets timed
+        auto* copy = celix_properties_copy(benchmark.props);
+        celix_properties_destroy(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Creates the content of a generated properties (config) file with the provided nr of entries.
+ */
+static std::string PropertiesBenchmark_createPropertiesFileContent(int64_t nrOfEntries) {
+    std::string content{"# generated properties file\n"};
+    for (int64_t i = 0; i < nrOfEntries; ++i) {
+        content += "CELIX_GENERATED_CONFIG_KEY_" + std::to_string(i) + " = generated config value " +
+                   std::to_string(i) + "\n";
+        if (i % 10 == 0) {
+            content += "escaped\\:key" + std::to_string(i) + "=http\\://localhost\\:8080\n";
+        }
+    }
+    return content;
+}
+
+static void PropertiesBenchmark_loadFromString(benchmark::State& state) {
+    auto content = PropertiesBenchmark_createPropertiesFileContent(state.range(0));
+    for (auto _ : state) {
+        // This code gets timed
+        auto* props = celix_properties_loadFromString(content.c_str());
+        if (props == nullptr) {
+            std::cerr << "ERROR: unexpected load result" << std::endl;
+        }
+        celix_properties_destroy(props);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)content.size());
+}
+
+static void PropertiesBenchmark_load(benchmark::State& state) {
+    auto content = PropertiesBenchmark_createPropertiesFileContent(state.range(0));
+    std::string path = "celix_properties_benchmark_" + std::to_string(state.range(0)) + ".properties";
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        state.SkipWithError("Cannot create properties file");
+        return;
+    }
+    fwrite(content.c_str(), 1, content.size(), file);
+    fclose(file);
+
+    for (auto _ : state) {
+        // This code gets timed
+        auto* props = celix_properties_load(path.c_str());
+        if (props == nullptr) {
+            std::cerr << "ERROR: unexpected load result" << std::endl;
+        }
+        celix_properties_destroy(props);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)content.size());
+    remove(path.c_str());
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kNanosecond) \
+        ->Arg(1)->Arg(4)->Arg(8)->Arg(16)->Arg(17)->Arg(32)->Arg(128)
+
+CELIX_BENCHMARK(PropertiesBenchmark_get);
+CELIX_BENCHMARK(PropertiesBenchmark_getMissingKey);
+CELIX_BENCHMARK(PropertiesBenchmark_setExistingKey);
+CELIX_BENCHMARK(PropertiesBenchmark_createAndFill);
+CELIX_BENCHMARK(PropertiesBenchmark_iterate);
+CELIX_BENCHMARK(PropertiesBenchmark_copy);
+
+BENCHMARK(PropertiesBenchmark_loadFromString)->Unit(benchmark::kMicrosecond)->Arg(100)->Arg(10000);
+BENCHMARK(PropertiesBenchmark_load)->Unit(benchmark::kMicrosecond)->Arg(100)->Arg(10000);
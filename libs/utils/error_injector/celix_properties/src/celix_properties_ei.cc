@@ -34,4 +34,11 @@ celix_properties_t *__wrap_celix_properties_copy(const celix_properties_t *prope
     return __real_celix_properties_copy(properties);
 }
 
+celix_properties_t *__real_celix_properties_lazyCopy(const celix_properties_t *properties);
+CELIX_EI_DEFINE(celix_properties_lazyCopy, celix_properties_t*)
+celix_properties_t *__wrap_celix_properties_lazyCopy(const celix_properties_t *properties) {
+    CELIX_EI_IMPL(celix_properties_lazyCopy);
+    return __real_celix_properties_lazyCopy(properties);
+}
+
 }
\ No newline at end of file
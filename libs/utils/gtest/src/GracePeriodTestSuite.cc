@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "celix_grace_period.h"
+
+class GracePeriodTestSuite : public ::testing::Test {
+  public:
+    struct TestObject {
+        long magic{TEST_OBJECT_MAGIC};
+        std::atomic<int>* destroyCount{nullptr};
+    };
+
+    static constexpr long TEST_OBJECT_MAGIC = 0x5eed;
+
+    static void destroyTestObject(void* obj) {
+        auto* testObj = static_cast<TestObject*>(obj);
+        testObj->magic = 0;
+        if (testObj->destroyCount != nullptr) {
+            testObj->destroyCount->fetch_add(1);
+        }
+        delete testObj;
+    }
+};
+
+TEST_F(GracePeriodTestSuite, CreateAndDestroyTest) {
+    celix_autoptr(celix_grace_period_t) gracePeriod = celix_gracePeriod_create();
+    ASSERT_NE(nullptr, gracePeriod);
+    celix_gracePeriod_retire(gracePeriod, nullptr, destroyTestObject); //no-op
+    celix_gracePeriod_synchronize(gracePeriod); //no readers, returns directly
+}
+
+TEST_F(GracePeriodTestSuite, RetireWithoutReadersTest) {
+    celix_autoptr(celix_grace_period_t) gracePeriod = celix_gracePeriod_create();
+    std::atomic<int> destroyCount{0};
+    celix_gracePeriod_retire(gracePeriod, new TestObject{TEST_OBJECT_MAGIC, &destroyCount}, destroyTestObject);
+    EXPECT_EQ(1, destroyCount.load());
+}
+
+TEST_F(GracePeriodTestSuite, RetireIsDeferredUntilReadEndTest) {
+    celix_autoptr(celix_grace_period_t) gracePeriod = celix_gracePeriod_create();
+    std::atomic<int> destroyCount{0};
+
+    unsigned int phase1 = celix_gracePeriod_readBegin(gracePeriod);
+    //retire does not wait for the active reader
+    celix_gracePeriod_retire(gracePeriod, new TestObject{TEST_OBJECT_MAGIC, &destroyCount}, destroyTestObject);
+    EXPECT_EQ(0, destroyCount.load());
+
+    //a reader starting after the first phase flip is waited for by the second phase flip
+    unsigned int phase2 = celix_gracePeriod_readBegin(gracePeriod);
+    EXPECT_NE(phase1, phase2);
+    celix_gracePeriod_retire(gracePeriod, new TestObject{TEST_OBJECT_MAGIC, &destroyCount}, destroyTestObject);
+    celix_gracePeriod_readEnd(gracePeriod, phase1);
+    EXPECT_EQ(0, destroyCount.load());
+
+    //a reader starting after the second phase flip does not delay the grace period
+    unsigned int phase3 = celix_gracePeriod_readBegin(gracePeriod);
+    EXPECT_EQ(phase1, phase3);
+
+    //the last reader of the phase the grace period waits for, completes the grace period.
+    //The second object was retired during the first grace period and waits for the next grace period.
+    celix_gracePeriod_readEnd(gracePeriod, phase2);
+    EXPECT_EQ(1, destroyCount.load());
+    celix_gracePeriod_readEnd(gracePeriod, phase3);
+    EXPECT_EQ(2, destroyCount.load());
+}
+
+TEST_F(GracePeriodTestSuite, DestroyDestroysRetiredObjectsTest) {
+    std::atomic<int> destroyCount{0};
+    auto* gracePeriod = celix_gracePeriod_create();
+    unsigned int phase = celix_gracePeriod_readBegin(gracePeriod);
+    celix_gracePeriod_retire(gracePeriod, new TestObject{TEST_OBJECT_MAGIC, &destroyCount}, destroyTestObject);
+    //note a reader which ends in a phase without a pending grace period does not destroy anything
+    unsigned int otherPhase = celix_gracePeriod_readBegin(gracePeriod);
+    celix_gracePeriod_readEnd(gracePeriod, otherPhase);
+    EXPECT_EQ(0, destroyCount.load());
+    celix_gracePeriod_readEnd(gracePeriod, phase);
+    celix_gracePeriod_destroy(gracePeriod);
+    EXPECT_EQ(1, destroyCount.load());
+}
+
+TEST_F(GracePeriodTestSuite, SynchronizeWaitsForActiveReadersTest) {
+    celix_autoptr(celix_grace_period_t) gracePeriod = celix_gracePeriod_create();
+
+    unsigned int phase1 = celix_gracePeriod_readBegin(gracePeriod);
+    auto sync = std::async(std::launch::async, [&]{ celix_gracePeriod_synchronize(gracePeriod); });
+    EXPECT_EQ(std::future_status::timeout, sync.wait_for(std::chrono::milliseconds{50}));
+
+    unsigned int phase2 = celix_gracePeriod_readBegin(gracePeriod);
+    celix_gracePeriod_readEnd(gracePeriod, phase1);
+    EXPECT_EQ(std::future_status::timeout, sync.wait_for(std::chrono::milliseconds{50}));
+
+    //readers starting after the second phase flip do not delay the synchronize
+    unsigned int phase3 = celix_gracePeriod_readBegin(gracePeriod);
+    celix_gracePeriod_readEnd(gracePeriod, phase2);
+    EXPECT_EQ(std::future_status::ready, sync.wait_for(std::chrono::seconds{5}));
+    celix_gracePeriod_readEnd(gracePeriod, phase3);
+}
+
+TEST_F(GracePeriodTestSuite, ConcurrentWritersAndReadersTest) {
+    //Several writers replace and retire the published object while readers use it.
+    //A reader that uses a destroyed object sees a cleared magic (or triggers a use-after-free in sanitizer builds).
+    celix_autoptr(celix_grace_period_t) gracePeriod = celix_gracePeriod_create();
+    std::atomic<int> destroyCount{0};
+    TestObject* published = new TestObject{TEST_OBJECT_MAGIC, &destroyCount};
+    std::atomic<bool> stop{false};
+    std::atomic<long> badReads{0};
+
+    std::vector<std::thread> readers{};
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]{
+            while (!stop.load()) {
+                unsigned int phase = celix_gracePeriod_readBegin(gracePeriod);
+                auto* obj = __atomic_load_n(&published, __ATOMIC_SEQ_CST);
+                if (obj->magic != TEST_OBJECT_MAGIC) {
+                    badReads.fetch_add(1);
+                }
+                std::this_thread::yield();
+                if (obj->magic != TEST_OBJECT_MAGIC) {
+                    badReads.fetch_add(1);
+                }
+                celix_gracePeriod_readEnd(gracePeriod, phase);
+            }
+        });
+    }
+
+    const int nrOfWriters = 4;
+    const int nrOfReplacements = 2000;
+    std::vector<std::thread> writers{};
+    for (int i = 0; i < nrOfWriters; ++i) {
+        writers.emplace_back([&, i]{
+            for (int j = 0; j < nrOfReplacements; ++j) {
+                auto* replaced = __atomic_exchange_n(&published, new TestObject{TEST_OBJECT_MAGIC, &destroyCount}, __ATOMIC_SEQ_CST);
+                if ((i + j) % 2 == 0) {
+                    celix_gracePeriod_retire(gracePeriod, replaced, destroyTestObject);
+                } else {
+                    celix_gracePeriod_synchronize(gracePeriod);
+                    destroyTestObject(replaced);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    celix_gracePeriod_synchronize(gracePeriod);
+    EXPECT_EQ(nrOfWriters * nrOfReplacements, destroyCount.load());
+    EXPECT_EQ(0, badReads.load());
+    destroyTestObject(published);
+}
@@ -20,11 +20,14 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 #include "celix/Properties.h"
 #include "celix_cleanup.h"
 #include "celix_err.h"
 #include "celix_properties.h"
 #include "celix_properties_private.h"
+#include "celix_string_intern.h"
 #include "celix_utils_private_constants.h"
 #include "celix_version.h"
 
@@ -89,8 +92,8 @@ TEST_F(PropertiesErrorInjectionTestSuite, CopyFailureTest) {
     fillOptimizationCache(prop);
     celix_properties_set(prop, "additionalKey", "value");
 
-    // When a hash map create error injection is set for celix_properties_create
-    celix_ei_expect_celix_stringHashMap_createWithOptions((void*)celix_properties_create, 0, nullptr);
+    // When a hash map create error injection is set for celix_properties_convertToHashMap
+    celix_ei_expect_celix_stringHashMap_createWithOptions((void*)celix_properties_convertToHashMap, 0, nullptr);
     // Then the celix_properties_copy call fails
     ASSERT_EQ(nullptr, celix_properties_copy(prop));
     ASSERT_EQ(1, celix_err_getErrorCount());
@@ -105,10 +108,105 @@ TEST_F(PropertiesErrorInjectionTestSuite, CopyFailureTest) {
 
     // C++ API
     const celix::Properties cxxProp{};
-    celix_ei_expect_celix_stringHashMap_createWithOptions((void*)celix_properties_create, 0, nullptr);
+    celix_ei_expect_malloc((void*)celix_properties_create, 0, nullptr);
     ASSERT_THROW(celix::Properties{cxxProp}, std::bad_alloc);
 }
 
+TEST_F(PropertiesErrorInjectionTestSuite, LazyCopyFailureTest) {
+    //Given a celix properties object
+    celix_autoptr(celix_properties_t) prop = celix_properties_create();
+    ASSERT_NE(nullptr, prop);
+    celix_properties_set(prop, "key", "value");
+    celix_properties_freeze(prop);
+
+    // When a malloc error injection is set for celix_properties_lazyCopy
+    celix_ei_expect_malloc((void*)celix_properties_lazyCopy, 0, nullptr);
+    // Then the celix_properties_lazyCopy call fails
+    ASSERT_EQ(nullptr, celix_properties_lazyCopy(prop));
+    ASSERT_EQ(1, celix_err_getErrorCount());
+}
+
+TEST_F(PropertiesErrorInjectionTestSuite, CopyOnWriteFailureTest) {
+    //Given a celix properties object with more entries than the optimization cache
+    celix_autoptr(celix_properties_t) prop = celix_properties_create();
+    ASSERT_NE(nullptr, prop);
+    fillOptimizationCache(prop);
+    long size = (long)celix_properties_size(prop);
+    celix_properties_freeze(prop);
+
+    //And a lazy copy of the frozen properties object
+    celix_autoptr(celix_properties_t) copy = celix_properties_lazyCopy(prop);
+    ASSERT_NE(nullptr, copy);
+
+    // When a hash map create error injection is set for celix_properties_convertToHashMap (during copy-on-write)
+    celix_ei_expect_celix_stringHashMap_createWithOptions((void*)celix_properties_convertToHashMap, 0, nullptr);
+    // Then modifying the lazy copy fails
+    EXPECT_EQ(CELIX_ENOMEM, celix_properties_set(copy, "additionalKey", "value"));
+    EXPECT_GE(celix_err_getErrorCount(), 1);
+    celix_err_resetErrors();
+
+    celix_ei_expect_celix_stringHashMap_createWithOptions((void*)celix_properties_convertToHashMap, 0, nullptr);
+    EXPECT_EQ(CELIX_ENOMEM,
+              celix_properties_setWithoutCopy(copy, celix_utils_strdup("additionalKey"), celix_utils_strdup("value")));
+    celix_err_resetErrors();
+
+    celix_ei_expect_celix_stringHashMap_createWithOptions((void*)celix_properties_convertToHashMap, 0, nullptr);
+    celix_properties_unset(copy, "key1");
+    celix_err_resetErrors();
+
+    // And both properties objects are unchanged
+    EXPECT_EQ(size, celix_properties_size(copy));
+    EXPECT_EQ(size, celix_properties_size(prop));
+    EXPECT_NE(nullptr, celix_properties_get(copy, "key1", nullptr));
+    EXPECT_EQ(nullptr, celix_properties_get(copy, "additionalKey", nullptr));
+}
+
+TEST_F(PropertiesErrorInjectionTestSuite, ConvertToHashMapFailureTest) {
+    //Given a celix properties object with a full small map
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    for (int i = 0; i < CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE; ++i) {
+        char key[10];
+        snprintf(key, sizeof(key), "key%i", i);
+        ASSERT_EQ(CELIX_SUCCESS, celix_properties_set(props, key, "value"));
+    }
+
+    // When a hash map create error injection is set for celix_properties_convertToHashMap
+    celix_ei_expect_celix_stringHashMap_createWithOptions((void*)celix_properties_convertToHashMap, 0, nullptr);
+    // Then adding a new entry fails
+    EXPECT_EQ(CELIX_ENOMEM, celix_properties_set(props, "additionalKey", "value"));
+
+    // When a hash map put error injection is set for celix_properties_convertToHashMap
+    celix_ei_expect_celix_stringHashMap_put((void*)celix_properties_convertToHashMap, 0, CELIX_ENOMEM);
+    // Then adding a new entry without copy fails
+    EXPECT_EQ(CELIX_ENOMEM,
+              celix_properties_setWithoutCopy(props, celix_utils_strdup("additionalKey"), celix_utils_strdup("value")));
+    celix_err_resetErrors();
+
+    // And the properties object is unchanged and can still be updated
+    EXPECT_EQ(CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE, celix_properties_size(props));
+    EXPECT_EQ(nullptr, celix_properties_get(props, "additionalKey", nullptr));
+    EXPECT_STREQ("value", celix_properties_get(props, "key0", nullptr));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(props, "key0", "updated"));
+    EXPECT_STREQ("updated", celix_properties_get(props, "key0", nullptr));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(props, "additionalKey", "value"));
+    EXPECT_EQ(CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE + 1, celix_properties_size(props));
+}
+
+TEST_F(PropertiesErrorInjectionTestSuite, SetWithInternedKeysFailureTest) {
+    //Given a celix properties object created with string interning enabled
+    celix_stringIntern_setEnabled(true);
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_stringIntern_setEnabled(false);
+
+    // When a malloc error injection is set for celix_stringIntern_acquire (during interning of the key)
+    celix_ei_expect_malloc((void*)celix_stringIntern_acquire, 0, nullptr);
+    // Then the celix_properties_set call fails
+    EXPECT_EQ(CELIX_ENOMEM, celix_properties_set(props, "key", "value"));
+    EXPECT_GE(celix_err_getErrorCount(), 1);
+    EXPECT_EQ(0, celix_properties_size(props));
+    celix_err_resetErrors();
+}
+
 TEST_F(PropertiesErrorInjectionTestSuite, SetFailureTest) {
     // C API
     // Given a celix properties object with a filled optimization cache
@@ -199,6 +297,15 @@ TEST_F(PropertiesErrorInjectionTestSuite, LoadFailureTest) {
     ASSERT_EQ(1, celix_err_getErrorCount());
     celix_err_resetErrors();
 
+    // When a malloc error injection is set for celix_properties_load (during properties create)
+    celix_ei_expect_malloc((void*)celix_properties_create, 0, nullptr);
+    // Then the celix_properties_load call for a regular file fails
+    props = celix_properties_load("resources-test/properties.txt");
+    ASSERT_EQ(nullptr, props);
+    // And a celix err msg is set
+    ASSERT_EQ(1, celix_err_getErrorCount());
+    celix_err_resetErrors();
+
     // When a malloc error injection is set for celix_properties_loadWithStream (during properties create)
     celix_ei_expect_malloc((void*)celix_properties_create, 0, nullptr);
     // Then the celix_properties_loadWithStream call fails
@@ -286,14 +393,24 @@ TEST_F(PropertiesErrorInjectionTestSuite, SetWithoutCopyFailureTest) {
 }
 
 TEST_F(PropertiesErrorInjectionTestSuite, LoadFromStringFailureTest) {
-    // When a strdup error injection is set for celix_properties_loadFromString (during strdup)
-    celix_ei_expect_celix_utils_strdup((void*)celix_properties_loadFromString, 0, nullptr);
+    // When a malloc error injection is set for celix_properties_loadFromString (during properties create)
+    celix_ei_expect_malloc((void*)celix_properties_create, 0, nullptr);
     // Then the celix_properties_loadFromString call fails
     auto props = celix_properties_loadFromString("key=value");
     ASSERT_EQ(nullptr, props);
     // And a celix err msg is set
     ASSERT_EQ(1, celix_err_getErrorCount());
     celix_err_resetErrors();
+
+    // When a malloc error injection is set for celix_properties_parseLines (during line buffer allocation)
+    celix_ei_expect_malloc((void*)celix_properties_parseLines, 0, nullptr);
+    // Then the celix_properties_loadFromString call fails for a line which does not fit in the stack line buffer
+    std::string longLine = "key=" + std::string(1024, 'v');
+    props = celix_properties_loadFromString(longLine.c_str());
+    ASSERT_EQ(nullptr, props);
+    // And a celix err msg is set
+    ASSERT_EQ(1, celix_err_getErrorCount());
+    celix_err_resetErrors();
 }
 
 TEST_F(PropertiesErrorInjectionTestSuite, LoadSetVersionFailureTest) {
@@ -20,6 +20,8 @@
 #include <gtest/gtest.h>
 
 #include <climits>
+#include <string>
+#include <vector>
 
 #include "celix_err.h"
 #include "celix_properties.h"
@@ -86,6 +88,61 @@ TEST_F(PropertiesTestSuite, LoadFromStringTest) {
     celix_properties_destroy(props);
 }
 
+TEST_F(PropertiesTestSuite, LoadWithEscapesAndCommentsTest) {
+    const char* string = "# comment\n"
+                         "  ! another comment\n"
+                         "\n"
+                         "  key1 = value1  \n"
+                         "key2:value2\r\n"
+                         "key\\=3=value\\:3\n"
+                         "key4=value=4\n"
+                         "key5\n";
+    celix_autoptr(celix_properties_t) props = celix_properties_loadFromString(string);
+    ASSERT_NE(nullptr, props);
+    EXPECT_EQ(5, celix_properties_size(props));
+    EXPECT_STREQ("value1", celix_properties_get(props, "key1", nullptr));
+    EXPECT_STREQ("value2", celix_properties_get(props, "key2", nullptr));
+    EXPECT_STREQ("value:3", celix_properties_get(props, "key=3", nullptr));
+    EXPECT_STREQ("value=4", celix_properties_get(props, "key4", nullptr));
+    EXPECT_STREQ("", celix_properties_get(props, "key5", nullptr));
+}
+
+TEST_F(PropertiesTestSuite, LoadLargeFileTest) {
+    const char* propertiesFile = "resources-test/properties_large_out.txt";
+    const int nrOfEntries = 10000;
+    std::string longValue(2000, 'v');
+    FILE* file = fopen(propertiesFile, "w");
+    ASSERT_NE(nullptr, file);
+    for (int i = 0; i < nrOfEntries; ++i) {
+        fprintf(file, "key%i=value%i\n", i, i);
+    }
+    fprintf(file, "long.key=%s\n", longValue.c_str());
+    fprintf(file, "long.escaped.key=\\#%s", longValue.c_str()); // no newline at the end of the file
+    fclose(file);
+
+    celix_autoptr(celix_properties_t) props = celix_properties_load(propertiesFile);
+    ASSERT_NE(nullptr, props);
+    EXPECT_EQ(nrOfEntries + 2, celix_properties_size(props));
+    EXPECT_STREQ("value0", celix_properties_get(props, "key0", nullptr));
+    EXPECT_STREQ("value9999", celix_properties_get(props, "key9999", nullptr));
+    EXPECT_EQ(longValue, celix_properties_get(props, "long.key", nullptr));
+    EXPECT_EQ("#" + longValue, celix_properties_get(props, "long.escaped.key", nullptr));
+
+    //And loading the same file with a stream gives the same result
+    file = fopen(propertiesFile, "r");
+    ASSERT_NE(nullptr, file);
+    celix_autoptr(celix_properties_t) props2 = celix_properties_loadWithStream(file);
+    fclose(file);
+    EXPECT_TRUE(celix_properties_equals(props, props2));
+
+    //And an empty file results in empty properties
+    file = fopen(propertiesFile, "w");
+    fclose(file);
+    celix_autoptr(celix_properties_t) props3 = celix_properties_load(propertiesFile);
+    ASSERT_NE(nullptr, props3);
+    EXPECT_EQ(0, celix_properties_size(props3));
+}
+
 
 TEST_F(PropertiesTestSuite, StoreTest) {
     const char* propertiesFile = "resources-test/properties_out.txt";
@@ -394,6 +451,212 @@ TEST_F(PropertiesTestSuite, GetTypeAndCopyTest) {
     celix_properties_destroy(copy);
 }
 
+TEST_F(PropertiesTestSuite, FreezeTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_set(props, "key", "value");
+    EXPECT_FALSE(celix_properties_isFrozen(props));
+
+    //When a properties set is frozen
+    celix_properties_freeze(props);
+    EXPECT_TRUE(celix_properties_isFrozen(props));
+    const char* value = celix_properties_get(props, "key", nullptr);
+
+    //Then it can no longer be modified
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, celix_properties_set(props, "key", "other value"));
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, celix_properties_setLong(props, "long", 42));
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, celix_properties_setVersionWithoutCopy(props, "version", celix_version_create(1, 2, 3, nullptr)));
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, celix_properties_setWithoutCopy(props, celix_utils_strdup("key2"), celix_utils_strdup("value2")));
+    celix_properties_unset(props, "key");
+    EXPECT_GE(celix_err_getErrorCount(), 5);
+    celix_err_resetErrors();
+    EXPECT_EQ(1, celix_properties_size(props));
+    EXPECT_EQ(value, celix_properties_get(props, "key", nullptr));
+
+    //And a (deep) copy of a frozen properties set is not frozen
+    celix_autoptr(celix_properties_t) copy = celix_properties_copy(props);
+    EXPECT_FALSE(celix_properties_isFrozen(copy));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(copy, "key", "other value"));
+
+    //And freezing or checking nullptr is a no-op
+    celix_properties_freeze(nullptr);
+    EXPECT_FALSE(celix_properties_isFrozen(nullptr));
+}
+
+TEST_F(PropertiesTestSuite, LazyCopyTest) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "string", "value");
+    celix_properties_setLong(props, "long", 42);
+    celix_properties_setVersionWithoutCopy(props, "version", celix_version_create(1, 2, 3, nullptr));
+    celix_properties_freeze(props);
+    const char* value = celix_properties_get(props, "string", nullptr);
+
+    //When a lazy copy is made of a frozen properties set, it shares the entries with the original
+    auto* copy = celix_properties_lazyCopy(props);
+    ASSERT_NE(nullptr, copy);
+    EXPECT_FALSE(celix_properties_isFrozen(copy));
+    EXPECT_TRUE(celix_properties_equals(props, copy));
+    EXPECT_EQ(value, celix_properties_get(copy, "string", nullptr));
+
+    //When the lazy copy is modified, the original is not changed and pointers retrieved from the original stay valid
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(copy, "string", "other value"));
+    EXPECT_NE(celix_properties_get(props, "string", nullptr), celix_properties_get(copy, "string", nullptr));
+    EXPECT_EQ(value, celix_properties_get(props, "string", nullptr));
+    EXPECT_STREQ("value", value);
+    EXPECT_STREQ("other value", celix_properties_get(copy, "string", nullptr));
+    EXPECT_EQ(42, celix_properties_getAsLong(copy, "long", 0));
+
+    //When a lazy copy is modified with a value of its shared entries and the original is destroyed
+    auto* copy2 = celix_properties_lazyCopy(props);
+    celix_properties_unset(copy2, "long");
+    EXPECT_EQ(3, celix_properties_size(props));
+    EXPECT_EQ(2, celix_properties_size(copy2));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(copy2, "string2", celix_properties_get(copy2, "string", nullptr)));
+    celix_properties_destroy(props);
+
+    //Then the lazy copies are still valid
+    EXPECT_STREQ("value", celix_properties_get(copy2, "string2", nullptr));
+    EXPECT_EQ(3, celix_properties_size(copy2));
+    celix_autoptr(celix_version_t) expectedVersion = celix_version_create(1, 2, 3, nullptr);
+    EXPECT_EQ(0, celix_version_compareTo(expectedVersion, celix_properties_getVersion(copy, "version", nullptr)));
+    EXPECT_EQ(0, celix_version_compareTo(expectedVersion, celix_properties_getVersion(copy2, "version", nullptr)));
+
+    celix_properties_destroy(copy);
+    celix_properties_destroy(copy2);
+
+    //A lazy copy of nullptr is an empty properties set
+    celix_autoptr(celix_properties_t) emptyCopy = celix_properties_lazyCopy(nullptr);
+    ASSERT_NE(nullptr, emptyCopy);
+    EXPECT_EQ(0, celix_properties_size(emptyCopy));
+}
+
+TEST_F(PropertiesTestSuite, LazyCopyOfNotFrozenPropertiesTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_set(props, "key", "value");
+    const char* value = celix_properties_get(props, "key", nullptr);
+
+    //When a lazy copy is made of a not frozen properties set, it is a deep copy
+    celix_autoptr(celix_properties_t) copy = celix_properties_lazyCopy(props);
+    ASSERT_NE(nullptr, copy);
+    EXPECT_TRUE(celix_properties_equals(props, copy));
+    EXPECT_NE(value, celix_properties_get(copy, "key", nullptr));
+
+    //And modifying the original does not change the copy or invalidate pointers of other keys
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(props, "key2", "value2"));
+    EXPECT_EQ(value, celix_properties_get(props, "key", nullptr));
+    EXPECT_EQ(1, celix_properties_size(copy));
+}
+
+TEST_F(PropertiesTestSuite, LazyCopySetWithoutCopyTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_set(props, "key", "value");
+    celix_properties_freeze(props);
+    celix_autoptr(celix_properties_t) copy = celix_properties_lazyCopy(props);
+
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_setWithoutCopy(copy, celix_utils_strdup("key2"), celix_utils_strdup("value2")));
+    EXPECT_EQ(1, celix_properties_size(props));
+    EXPECT_EQ(2, celix_properties_size(copy));
+
+    //unset of a missing key does not copy the entries
+    auto* copy2 = celix_properties_lazyCopy(props);
+    celix_properties_unset(copy2, "missing");
+    EXPECT_EQ(celix_properties_get(props, "key", nullptr), celix_properties_get(copy2, "key", nullptr));
+    celix_properties_destroy(copy2);
+}
+
+TEST_F(PropertiesTestSuite, LazyCopyDestroyOrderTest) {
+    //Given a frozen properties set and a lazy copy
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "key", "value");
+    celix_properties_freeze(props);
+    auto* copy = celix_properties_lazyCopy(props);
+
+    //When the lazy copy is destroyed first, the properties set is still valid
+    celix_properties_destroy(copy);
+    EXPECT_EQ(1, celix_properties_size(props));
+    EXPECT_STREQ("value", celix_properties_get(props, "key", nullptr));
+
+    //When the properties set is destroyed first, the lazy copy is still valid
+    copy = celix_properties_lazyCopy(props);
+    celix_properties_destroy(props);
+    EXPECT_EQ(1, celix_properties_size(copy));
+    EXPECT_STREQ("value", celix_properties_get(copy, "key", nullptr));
+
+    //And a frozen lazy copy can be lazy copied and modified after the lazy copy is destroyed
+    celix_properties_freeze(copy);
+    auto* copy2 = celix_properties_lazyCopy(copy);
+    celix_properties_destroy(copy);
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(copy2, "key3", "value3"));
+    EXPECT_EQ(2, celix_properties_size(copy2));
+    celix_properties_destroy(copy2);
+}
+
+TEST_F(PropertiesTestSuite, SmallPropertiesTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_set(props, "a", "1");
+    celix_properties_set(props, "b", "2");
+    celix_properties_set(props, "c", "3");
+    celix_properties_set(props, "b", "4");
+
+    //Small properties do not use a hash map
+    auto stats = celix_properties_getStatistics(props);
+    EXPECT_EQ(3, stats.mapStatistics.nrOfEntries);
+    EXPECT_EQ(0, stats.mapStatistics.nrOfBuckets);
+
+    //And are iterated in insertion order
+    celix_properties_unset(props, "a");
+    celix_properties_set(props, "d", "5");
+    std::vector<std::string> keys{};
+    CELIX_PROPERTIES_ITERATE(props, iter) {
+        keys.emplace_back(iter.key);
+    }
+    EXPECT_EQ((std::vector<std::string>{"b", "c", "d"}), keys);
+    EXPECT_STREQ("4", celix_properties_get(props, "b", nullptr));
+    EXPECT_EQ(nullptr, celix_properties_get(props, "a", nullptr));
+}
+
+TEST_F(PropertiesTestSuite, SmallPropertiesToLargePropertiesTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    const int nrOfEntries = 100;
+
+    //When entries are added, the entries stay accessible while the properties grows
+    for (int i = 0; i < nrOfEntries; ++i) {
+        auto key = std::string{"key"} + std::to_string(i);
+        if (i % 2 == 0) {
+            EXPECT_EQ(CELIX_SUCCESS, celix_properties_setLong(props, key.c_str(), i));
+        } else {
+            EXPECT_EQ(CELIX_SUCCESS, celix_properties_setWithoutCopy(props, celix_utils_strdup(key.c_str()),
+                                                                      celix_utils_strdup(std::to_string(i).c_str())));
+        }
+        EXPECT_EQ(i + 1, celix_properties_size(props));
+        for (int j = 0; j <= i; ++j) {
+            auto k = std::string{"key"} + std::to_string(j);
+            EXPECT_EQ(j, celix_properties_getAsLong(props, k.c_str(), -1));
+        }
+    }
+    auto stats = celix_properties_getStatistics(props);
+    EXPECT_EQ(nrOfEntries, stats.mapStatistics.nrOfEntries);
+    EXPECT_GT(stats.mapStatistics.nrOfBuckets, 0);
+
+    //And a copy and an iteration contain all entries
+    celix_autoptr(celix_properties_t) copy = celix_properties_copy(props);
+    EXPECT_TRUE(celix_properties_equals(props, copy));
+    int count = 0;
+    CELIX_PROPERTIES_ITERATE(props, iter) {
+        EXPECT_STREQ(iter.entry.value, celix_properties_get(copy, iter.key, nullptr));
+        ++count;
+    }
+    EXPECT_EQ(nrOfEntries, count);
+
+    //When entries are removed, the remaining entries stay accessible
+    for (int i = 0; i < nrOfEntries; ++i) {
+        auto key = std::string{"key"} + std::to_string(i);
+        celix_properties_unset(props, key.c_str());
+        EXPECT_EQ(nrOfEntries - i - 1, celix_properties_size(props));
+        EXPECT_EQ(-1, celix_properties_getAsLong(props, key.c_str(), -1));
+    }
+    EXPECT_EQ(nrOfEntries, celix_properties_size(copy));
+}
+
 TEST_F(PropertiesTestSuite, GetEntryTest) {
     auto* props = celix_properties_create();
     celix_properties_set(props, "key1", "value1");
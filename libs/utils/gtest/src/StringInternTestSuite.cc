@@ -0,0 +1,259 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "celix_filter.h"
+#include "celix_properties.h"
+#include "celix_properties_internal.h"
+#include "celix_string_intern.h"
+#include "celix_utils.h"
+
+class StringInternTestSuite : public ::testing::Test {
+  public:
+    StringInternTestSuite() {
+        enabledBefore = celix_stringIntern_isEnabled();
+        celix_stringIntern_setEnabled(true);
+    }
+
+    ~StringInternTestSuite() override {
+        celix_stringIntern_setEnabled(enabledBefore);
+    }
+
+    static const char* findKey(const celix_properties_t* props, const char* key) {
+        CELIX_PROPERTIES_ITERATE(props, iter) {
+            if (strcmp(iter.key, key) == 0) {
+                return iter.key;
+            }
+        }
+        return nullptr;
+    }
+
+    bool enabledBefore{false};
+};
+
+TEST_F(StringInternTestSuite, AcquireAndReleaseTest) {
+    size_t initialSize = celix_stringIntern_size();
+    EXPECT_EQ(nullptr, celix_stringIntern_acquire(nullptr));
+    celix_stringIntern_release(nullptr); // no-op
+
+    std::string str1 = "test.key";
+    std::string str2 = "test.key";
+    const char* interned1 = celix_stringIntern_acquire(str1.c_str());
+    const char* interned2 = celix_stringIntern_acquire(str2.c_str());
+    ASSERT_NE(nullptr, interned1);
+    EXPECT_NE(str1.c_str(), interned1);
+    EXPECT_STREQ("test.key", interned1);
+    EXPECT_EQ(interned1, interned2);
+    EXPECT_EQ(celix_utils_stringHash("test.key"), celix_stringIntern_hash(interned1));
+    EXPECT_EQ(initialSize + 1, celix_stringIntern_size());
+
+    const char* interned3 = celix_stringIntern_acquire("test.other.key");
+    EXPECT_NE(interned1, interned3);
+    EXPECT_EQ(initialSize + 2, celix_stringIntern_size());
+
+    celix_stringIntern_release(interned1);
+    EXPECT_EQ(initialSize + 2, celix_stringIntern_size());
+    celix_stringIntern_release(interned2);
+    EXPECT_EQ(initialSize + 1, celix_stringIntern_size());
+    celix_stringIntern_release(interned3);
+    EXPECT_EQ(initialSize, celix_stringIntern_size());
+}
+
+TEST_F(StringInternTestSuite, ConcurrentAcquireAndReleaseTest) {
+    size_t initialSize = celix_stringIntern_size();
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 1000; ++i) {
+                auto key = std::string{"key"} + std::to_string(i % 10);
+                const char* interned = celix_stringIntern_acquire(key.c_str());
+                EXPECT_STREQ(key.c_str(), interned);
+                celix_stringIntern_release(interned);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(initialSize, celix_stringIntern_size());
+}
+
+TEST_F(StringInternTestSuite, PropertiesWithInternedKeysTest) {
+    size_t initialSize = celix_stringIntern_size();
+
+    celix_autoptr(celix_properties_t) props1 = celix_properties_create();
+    celix_autoptr(celix_properties_t) props2 = celix_properties_create();
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(props1, "service.name", "svc1"));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_setLong(props1, "service.id", 1));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(props2, "service.name", "svc2"));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_setWithoutCopy(props2, celix_utils_strdup("service.id"),
+                                                              celix_utils_strdup("2")));
+
+    //Then the properties share the interned keys
+    EXPECT_EQ(findKey(props1, "service.name"), findKey(props2, "service.name"));
+    EXPECT_EQ(initialSize + 2, celix_stringIntern_size());
+
+    //And a key set without copy is used as-is and not interned
+    EXPECT_NE(findKey(props1, "service.id"), findKey(props2, "service.id"));
+
+    //And updating existing entries keeps the interned keys
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_set(props1, "service.name", "svc3"));
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_setWithoutCopy(props2, celix_utils_strdup("service.id"),
+                                                              celix_utils_strdup("3")));
+    EXPECT_EQ(findKey(props1, "service.name"), findKey(props2, "service.name"));
+    EXPECT_STREQ("svc3", celix_properties_get(props1, "service.name", nullptr));
+    EXPECT_STREQ("3", celix_properties_get(props2, "service.id", nullptr));
+
+    //And a copy also uses the interned keys
+    celix_autoptr(celix_properties_t) copy = celix_properties_copy(props1);
+    EXPECT_EQ(findKey(props1, "service.name"), findKey(copy, "service.name"));
+    EXPECT_TRUE(celix_properties_equals(props1, copy));
+
+    //When the keys are removed, the interned keys are released
+    celix_properties_unset(props1, "service.name");
+    celix_properties_unset(props2, "service.name");
+    celix_properties_unset(copy, "service.name");
+    EXPECT_EQ(initialSize + 1, celix_stringIntern_size());
+    celix_properties_destroy(celix_steal_ptr(props1));
+    celix_properties_destroy(celix_steal_ptr(props2));
+    celix_properties_destroy(celix_steal_ptr(copy));
+    EXPECT_EQ(initialSize, celix_stringIntern_size());
+}
+
+TEST_F(StringInternTestSuite, GetEntryForInternedKeyTest) {
+    const char* interned = celix_stringIntern_acquire("key5");
+    ASSERT_NE(nullptr, interned);
+
+    //Given properties with interned keys, small enough for the small map
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    for (int i = 0; i < 8; ++i) {
+        auto key = std::string{"key"} + std::to_string(i);
+        celix_properties_setLong(props, key.c_str(), i);
+    }
+
+    //Then the entry for an interned key is found
+    auto* entry = celix_properties_getEntryForInternedKey(props, interned);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(5, entry->typed.longValue);
+    EXPECT_EQ(celix_properties_getEntry(props, "key5"), entry);
+
+    //And a key set without copy is also found
+    celix_properties_setWithoutCopy(props, celix_utils_strdup("key5"), celix_utils_strdup("15"));
+    entry = celix_properties_getEntryForInternedKey(props, interned);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_STREQ("15", entry->value);
+
+    //When the properties no longer fit in the small map
+    for (int i = 8; i < 1000; ++i) {
+        auto key = std::string{"key"} + std::to_string(i);
+        celix_properties_setLong(props, key.c_str(), i);
+    }
+
+    //Then the entry for an interned key is still found
+    entry = celix_properties_getEntryForInternedKey(props, interned);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_STREQ("15", entry->value);
+
+    //And a missing key, NULL properties or a NULL key result in a NULL entry
+    const char* missing = celix_stringIntern_acquire("missing");
+    EXPECT_EQ(nullptr, celix_properties_getEntryForInternedKey(props, missing));
+    EXPECT_EQ(nullptr, celix_properties_getEntryForInternedKey(nullptr, interned));
+    EXPECT_EQ(nullptr, celix_properties_getEntryForInternedKey(props, nullptr));
+    celix_stringIntern_release(missing);
+
+    celix_stringIntern_release(interned);
+}
+
+TEST_F(StringInternTestSuite, PropertiesCreatedWithInterningDisabledTest) {
+    size_t initialSize = celix_stringIntern_size();
+    celix_stringIntern_setEnabled(false);
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_stringIntern_setEnabled(true);
+
+    //When interning is enabled after the properties are created, the keys of the properties are not interned
+    celix_properties_set(props, "key", "value");
+    EXPECT_EQ(initialSize, celix_stringIntern_size());
+    EXPECT_STREQ("value", celix_properties_get(props, "key", nullptr));
+}
+
+TEST_F(StringInternTestSuite, FilterWithInternedAttributesTest) {
+    size_t initialSize = celix_stringIntern_size();
+
+    celix_autoptr(celix_filter_t) filter1 = celix_filter_create("(service.name=svc1)");
+    celix_autoptr(celix_filter_t) filter2 = celix_filter_create("(&(service.name=*)(service.ranking>=1))");
+    ASSERT_NE(nullptr, filter1);
+    ASSERT_NE(nullptr, filter2);
+    auto* child = static_cast<celix_filter_t*>(celix_arrayList_get(filter2->children, 0));
+    EXPECT_EQ(filter1->attribute, child->attribute);
+    EXPECT_EQ(initialSize + 2, celix_stringIntern_size());
+
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_set(props, "service.name", "svc1");
+    celix_properties_setLong(props, "service.ranking", 2);
+    EXPECT_TRUE(celix_filter_match(filter1, props));
+    EXPECT_TRUE(celix_filter_match(filter2, props));
+    EXPECT_EQ(filter1->attribute, findKey(props, "service.name"));
+
+    celix_properties_destroy(celix_steal_ptr(props));
+    celix_filter_destroy(celix_steal_ptr(filter1));
+    celix_filter_destroy(celix_steal_ptr(filter2));
+    EXPECT_EQ(initialSize, celix_stringIntern_size());
+}
+
+TEST_F(StringInternTestSuite, FilterWithInternedServiceNameTest) {
+    size_t initialSize = celix_stringIntern_size();
+
+    //Given filters for the same service name
+    celix_autoptr(celix_filter_t) filter1 = celix_filter_create("(objectClass=example.Service)");
+    celix_autoptr(celix_filter_t) filter2 =
+        celix_filter_create("(&(objectClass=example.Service)(service.ranking>=1))");
+    ASSERT_NE(nullptr, filter1);
+    ASSERT_NE(nullptr, filter2);
+
+    //Then the service names in the filters are interned and shared
+    auto* child = static_cast<celix_filter_t*>(celix_arrayList_get(filter2->children, 0));
+    EXPECT_EQ(filter1->value, child->value);
+    EXPECT_EQ(initialSize + 3, celix_stringIntern_size()); // objectClass, example.Service and service.ranking
+
+    //And other filter values are not interned
+    auto* rankingChild = static_cast<celix_filter_t*>(celix_arrayList_get(filter2->children, 1));
+    celix_autoptr(celix_filter_t) filter3 = celix_filter_create("(service.ranking>=1)");
+    EXPECT_NE(rankingChild->value, filter3->value);
+
+    //And the filters still match
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_set(props, "objectClass", "example.Service");
+    celix_properties_setLong(props, "service.ranking", 2);
+    EXPECT_TRUE(celix_filter_match(filter1, props));
+    EXPECT_TRUE(celix_filter_match(filter2, props));
+    celix_properties_set(props, "objectClass", "example.OtherService");
+    EXPECT_FALSE(celix_filter_match(filter1, props));
+
+    //When the filters are destroyed, the interned service name is released
+    celix_properties_destroy(celix_steal_ptr(props));
+    celix_filter_destroy(celix_steal_ptr(filter1));
+    celix_filter_destroy(celix_steal_ptr(filter2));
+    celix_filter_destroy(celix_steal_ptr(filter3));
+    EXPECT_EQ(initialSize, celix_stringIntern_size());
+}
@@ -181,6 +181,8 @@ CELIX_UTILS_EXPORT celix_status_t celix_properties_store(celix_properties_t* pro
 /**
  * @brief Get the entry for a given key in a property set.
  *
+ * The entry of a frozen property set or of a lazy copy (see celix_properties_lazyCopy) must not be modified.
+ *
  * @param[in] properties The property set to search.
  * @param[in] key The key to search for.
  * @return The entry for the given key, or a NULL if the key is not found.
@@ -432,6 +434,46 @@ CELIX_UTILS_EXPORT void celix_properties_unset(celix_properties_t* properties, c
  */
 CELIX_UTILS_EXPORT celix_properties_t* celix_properties_copy(const celix_properties_t* properties);
 
+/**
+ * @brief Freeze a property set, after which the property set can no longer be modified.
+ *
+ * A frozen property set can be shared with lazy copies (see celix_properties_lazyCopy). Setting or unsetting a
+ * property of a frozen property set fails with CELIX_ILLEGAL_STATE and logs an error message to celix_err.
+ * A property set cannot be unfrozen. Freezing a property set does not make it thread-safe, so a property set should
+ * be frozen before it is shared with other threads.
+ *
+ * @param[in] properties The property set to freeze. Can be NULL.
+ */
+CELIX_UTILS_EXPORT void celix_properties_freeze(celix_properties_t* properties);
+
+/**
+ * @brief Check whether a property set is frozen (see celix_properties_freeze).
+ */
+CELIX_UTILS_EXPORT bool celix_properties_isFrozen(const celix_properties_t* properties);
+
+/**
+ * @brief Make a lazy (copy-on-write) copy of a properties set.
+ *
+ * If the given property set is frozen, the lazy copy shares the entries with the given property set, using an atomic
+ * reference count, until the lazy copy is modified. The lazy copy then first makes its own copy of the entries.
+ * This makes copying frozen properties, like service properties, cheap.
+ * If the given property set is not frozen, this is the same as celix_properties_copy.
+ *
+ * A lazy copy is not frozen and can be used and destroyed independently of the given property set, also from
+ * another thread.
+ *
+ * @warning The first modification (set or unset) of a lazy copy of a frozen property set invalidates all pointers -
+ * keys, values, versions and entries - retrieved before from the lazy copy, not only the pointers for the modified
+ * key. Retrieve the pointers again after modifying a lazy copy. Pointers retrieved from the frozen property set
+ * are not affected.
+ *
+ * If the return status is an error, an error message is logged to celix_err.
+ *
+ * @param[in] properties The property set to copy.
+ * @return A lazy copy of the given property set.
+ */
+CELIX_UTILS_EXPORT celix_properties_t* celix_properties_lazyCopy(const celix_properties_t* properties);
+
 /**
  * @brief Get the number of properties in a property set.
  *
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @file celix_grace_period.h
+ * @brief Header file for the Apache Celix internal grace period (read-copy-update) API.
+ * The internal API is only meant to be used inside the Apache Celix project, so this is not part of the public API.
+ *
+ * A grace period object protects objects which are read lock-free and replaced by a writer.
+ * Readers enter a read-side section with celix_gracePeriod_readBegin and leave it with celix_gracePeriod_readEnd;
+ * this never blocks and never allocates.
+ * A writer first unpublishes an object (e.g. by atomically exchanging a pointer) and then hands it over with
+ * celix_gracePeriod_retire. The object is destroyed after a grace period: when all read-side sections which could
+ * still observe the object have ended. Retiring never waits, the destroy is done by the retiring thread if there are
+ * no readers, otherwise by the last reader leaving its read-side section.
+ * A writer which must know that no reader uses an unpublished object anymore, uses celix_gracePeriod_synchronize.
+ *
+ * Grace periods are serialized per grace period object, so concurrent writers are supported.
+ */
+
+#ifndef CELIX_CELIX_GRACE_PERIOD_H
+#define CELIX_CELIX_GRACE_PERIOD_H
+
+#include "celix_cleanup.h"
+#include "celix_utils_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct celix_grace_period celix_grace_period_t;
+
+/**
+ * @brief Creates a grace period object.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @return The new grace period object or NULL if it could not be created (ENOMEM).
+ */
+CELIX_UTILS_EXPORT celix_grace_period_t* celix_gracePeriod_create(void);
+
+/**
+ * @brief Destroys the grace period object and destroys all still retired objects.
+ *
+ * Must not be called while read-side sections are active.
+ */
+CELIX_UTILS_EXPORT void celix_gracePeriod_destroy(celix_grace_period_t* gracePeriod);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_grace_period_t, celix_gracePeriod_destroy)
+
+/**
+ * @brief Enters a read-side section.
+ *
+ * Objects loaded after this call stay valid until celix_gracePeriod_readEnd is called with the returned phase.
+ * Read-side sections should be short, because they delay the destroy of retired objects.
+ *
+ * @return The phase which must be provided to celix_gracePeriod_readEnd.
+ */
+CELIX_UTILS_EXPORT unsigned int celix_gracePeriod_readBegin(celix_grace_period_t* gracePeriod);
+
+/**
+ * @brief Leaves a read-side section started with celix_gracePeriod_readBegin.
+ *
+ * If this is the last reader a pending grace period waits for, the grace period is completed and the retired objects
+ * are destroyed by the calling thread.
+ */
+CELIX_UTILS_EXPORT void celix_gracePeriod_readEnd(celix_grace_period_t* gracePeriod, unsigned int phase);
+
+/**
+ * @brief Retires an unpublished object, which is destroyed after a grace period.
+ *
+ * Does not wait for the grace period. Can be called from any thread, but not from within a read-side section
+ * on the same grace period object if the caller expects the object to be destroyed before the read-side section
+ * ends.
+ * If no memory is available to queue the object, this call falls back to celix_gracePeriod_synchronize and destroys
+ * the object directly.
+ *
+ * @param[in] gracePeriod The grace period object.
+ * @param[in] obj The unpublished object, can be NULL (then nothing is retired).
+ * @param[in] destroy The destroy function for the object.
+ */
+CELIX_UTILS_EXPORT void celix_gracePeriod_retire(celix_grace_period_t* gracePeriod, void* obj, void (*destroy)(void* obj));
+
+/**
+ * @brief Waits until all read-side sections which started before this call have ended.
+ *
+ * Also ensures that all objects retired before this call are no longer used by readers.
+ * Waits on a condition and does not spin. Must not be called from within a read-side section on the same grace
+ * period object.
+ */
+CELIX_UTILS_EXPORT void celix_gracePeriod_synchronize(celix_grace_period_t* gracePeriod);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_CELIX_GRACE_PERIOD_H
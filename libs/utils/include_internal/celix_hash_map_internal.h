@@ -55,6 +55,17 @@ CELIX_UTILS_EXPORT celix_hash_map_statistics_t celix_longHashMap_getStatistics(c
  */
 CELIX_UTILS_EXPORT celix_hash_map_statistics_t celix_stringHashMap_getStatistics(const celix_string_hash_map_t* map);
 
+/**
+ * @brief Returns the value for the provided key using an already calculated hash of the key, e.g. the cached hash of
+ * an interned string (see celix_string_intern.h).
+ *
+ * @param[in] map The hashmap.
+ * @param[in] key The key to find. Cannot be NULL.
+ * @param[in] hash The hash of the key, as returned by celix_utils_stringHash.
+ * @return Return the pointer value for the provided key or NULL if the key is not found.
+ */
+CELIX_UTILS_EXPORT void* celix_stringHashMap_getWithHash(const celix_string_hash_map_t* map, const char* key, unsigned int hash);
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +47,19 @@ typedef struct celix_properties_statistics_t {
  */
 CELIX_UTILS_EXPORT celix_properties_statistics_t celix_properties_getStatistics(const celix_properties_t* properties);
 
+/**
+ * @brief Get the entry for an interned key (see celix_string_intern.h).
+ *
+ * Same as celix_properties_getEntry, but uses the cached hash of the interned key instead of calculating the hash of
+ * the key. If the properties also uses interned keys, the key comparison is a pointer comparison.
+ *
+ * @param[in] properties The property set to search.
+ * @param[in] internedKey The interned key to search for, as returned by celix_stringIntern_acquire.
+ * @return The entry for the given key, or a NULL if the key is not found.
+ */
+CELIX_UTILS_EXPORT const celix_properties_entry_t*
+celix_properties_getEntryForInternedKey(const celix_properties_t* properties, const char* internedKey);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,112 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @file celix_string_intern.h
+ * @brief Header file for the Apache Celix internal process-wide string intern table.
+ * The internal API is only meant to be used inside the Apache Celix project, so this is not part of the public API.
+ *
+ * The string intern table stores a single, reference counted, copy of a string. Interning the same string value
+ * results in the same pointer, so interned strings can be compared by pointer and need to be stored only once.
+ * The string intern table is thread-safe.
+ *
+ * If string interning is enabled, celix_properties interns the keys of properties, celix_filter interns the
+ * attribute names of filters and the framework service registry interns the service names of service registrations.
+ * String interning is disabled by default and can be enabled by setting the CMake cache variable
+ * CELIX_UTILS_STRING_INTERNING (Conan option celix_utils_string_interning) or by calling
+ * celix_stringIntern_setEnabled.
+ */
+
+#ifndef CELIX_CELIX_STRING_INTERN_H
+#define CELIX_CELIX_STRING_INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "celix_utils_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Returns whether string interning is enabled for the users of the string intern table
+ * (properties keys, filter attributes and service registration names).
+ */
+CELIX_UTILS_EXPORT bool celix_stringIntern_isEnabled(void);
+
+/**
+ * @brief Enable or disable string interning for the users of the string intern table.
+ *
+ * Enabling or disabling string interning only affects properties, filters and service registrations created after
+ * this call; already created objects keep their (interned or not interned) strings.
+ */
+CELIX_UTILS_EXPORT void celix_stringIntern_setEnabled(bool enabled);
+
+/**
+ * @brief Intern the provided string.
+ *
+ * Increases the reference count of the interned string if the string is already interned, otherwise adds a copy of
+ * the string to the string intern table. Interning can be used regardless if string interning is enabled.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @param[in] str The string to intern.
+ * @return The interned string or NULL if str is NULL or the string could not be interned (ENOMEM).
+ * The interned string should be released with celix_stringIntern_release.
+ */
+CELIX_UTILS_EXPORT const char* celix_stringIntern_acquire(const char* str);
+
+/**
+ * @brief Release an interned string.
+ *
+ * Decreases the reference count of the interned string and removes the string from the string intern table if the
+ * reference count drops to 0.
+ *
+ * @param[in] interned The interned string, as returned by celix_stringIntern_acquire. Can be NULL.
+ */
+CELIX_UTILS_EXPORT void celix_stringIntern_release(const char* interned);
+
+/**
+ * @brief Release the provided string if it is an interned string.
+ *
+ * Unlike celix_stringIntern_release, this can be called for strings that are possibly not interned. Only the string
+ * pointer returned by celix_stringIntern_acquire is released, not another string with the same value.
+ *
+ * @param[in] str The string to release. Can be NULL.
+ * @return true if the string was an interned string and is released, false otherwise.
+ */
+CELIX_UTILS_EXPORT bool celix_stringIntern_releaseIfInterned(const char* str);
+
+/**
+ * @brief Returns the cached hash (celix_utils_stringHash) of an interned string.
+ * @param[in] interned The interned string, as returned by celix_stringIntern_acquire.
+ */
+CELIX_UTILS_EXPORT unsigned int celix_stringIntern_hash(const char* interned);
+
+/**
+ * @brief Returns the number of strings in the string intern table.
+ */
+CELIX_UTILS_EXPORT size_t celix_stringIntern_size(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CELIX_CELIX_STRING_INTERN_H
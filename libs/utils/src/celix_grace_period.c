@@ -0,0 +1,195 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "celix_grace_period.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "celix_err.h"
+#include "celix_threads.h"
+
+typedef struct celix_grace_period_retired {
+    struct celix_grace_period_retired* next;
+    void* obj;
+    void (*destroy)(void* obj);
+} celix_grace_period_retired_t;
+
+/**
+ * A grace period flips the reader phase and waits until the readers of the left phase are done, twice.
+ * New readers always start in the current phase, so a grace period cannot starve on a continuous stream of readers.
+ * Two flips are needed, because a reader which loaded the phase just before a flip can still increment the reader
+ * count of the left phase after the flip.
+ *
+ * Grace periods are serialized with the mutex: retires and synchronize requests are queued and all queued requests
+ * are handled by the next grace period. The grace period is advanced by the thread which retires or synchronizes
+ * and by the last reader leaving the phase the grace period waits for, so no thread waits for readers while
+ * holding the mutex.
+ */
+struct celix_grace_period {
+    unsigned int phase;                     //atomic, the current reader phase (only the lowest bit is used)
+    unsigned int readers[2];                //atomic, the number of active readers per phase
+    bool pending;                           //atomic, whether there are queued or in flight requests
+    celix_thread_mutex_t mutex;             //protects below
+    celix_thread_cond_t cond;               //broadcast when a grace period completes
+    celix_grace_period_retired_t* queued;   //retired objects waiting for the next grace period
+    size_t queuedCount;                     //nr of queued retires and synchronize requests
+    celix_grace_period_retired_t* inFlight; //retired objects waiting for the current grace period
+    size_t inFlightCount;                   //nr of retires and synchronize requests handled by the current grace period
+    bool firstPhaseDrained;                 //whether the first left phase of the current grace period is drained
+    unsigned int waitPhase;                 //the reader phase the current grace period waits for
+    unsigned long requested;                //total nr of retires and synchronize requests
+    unsigned long completed;                //total nr of retires and synchronize requests with a completed grace period
+};
+
+celix_grace_period_t* celix_gracePeriod_create(void) {
+    celix_grace_period_t* gracePeriod = calloc(1, sizeof(*gracePeriod));
+    if (gracePeriod == NULL) {
+        celix_err_push("Failed to allocate grace period");
+        return NULL;
+    }
+    if (celixThreadMutex_create(&gracePeriod->mutex, NULL) != CELIX_SUCCESS) {
+        celix_err_push("Failed to create grace period mutex");
+        free(gracePeriod);
+        return NULL;
+    }
+    if (celixThreadCondition_init(&gracePeriod->cond, NULL) != CELIX_SUCCESS) {
+        celix_err_push("Failed to create grace period condition");
+        celixThreadMutex_destroy(&gracePeriod->mutex);
+        free(gracePeriod);
+        return NULL;
+    }
+    return gracePeriod;
+}
+
+void celix_gracePeriod_destroy(celix_grace_period_t* gracePeriod) {
+    if (gracePeriod == NULL) {
+        return;
+    }
+    assert(__atomic_load_n(&gracePeriod->readers[0], __ATOMIC_SEQ_CST) == 0);
+    assert(__atomic_load_n(&gracePeriod->readers[1], __ATOMIC_SEQ_CST) == 0);
+    //note without readers, the synchronize completes all pending grace periods and destroys all retired objects
+    celix_gracePeriod_synchronize(gracePeriod);
+    assert(gracePeriod->queued == NULL && gracePeriod->inFlight == NULL);
+    celixThreadCondition_destroy(&gracePeriod->cond);
+    celixThreadMutex_destroy(&gracePeriod->mutex);
+    free(gracePeriod);
+}
+
+/**
+ * Advances the grace periods as far as possible and destroys the retired objects of the completed grace periods.
+ */
+static void celix_gracePeriod_advance(celix_grace_period_t* gracePeriod) {
+    celix_grace_period_retired_t* done = NULL;
+    celixThreadMutex_lock(&gracePeriod->mutex);
+    while (true) {
+        if (gracePeriod->inFlightCount > 0) {
+            if (__atomic_load_n(&gracePeriod->readers[gracePeriod->waitPhase], __ATOMIC_SEQ_CST) > 0) {
+                //note the last reader leaving the phase advances the grace period
+                break;
+            }
+            if (!gracePeriod->firstPhaseDrained) {
+                gracePeriod->firstPhaseDrained = true;
+                gracePeriod->waitPhase = __atomic_fetch_add(&gracePeriod->phase, 1, __ATOMIC_SEQ_CST) & 1u;
+                continue;
+            }
+            while (gracePeriod->inFlight != NULL) {
+                celix_grace_period_retired_t* retired = gracePeriod->inFlight;
+                gracePeriod->inFlight = retired->next;
+                retired->next = done;
+                done = retired;
+            }
+            gracePeriod->completed += gracePeriod->inFlightCount;
+            gracePeriod->inFlightCount = 0;
+            celixThreadCondition_broadcast(&gracePeriod->cond);
+        } else if (gracePeriod->queuedCount > 0) {
+            gracePeriod->inFlight = gracePeriod->queued;
+            gracePeriod->inFlightCount = gracePeriod->queuedCount;
+            gracePeriod->queued = NULL;
+            gracePeriod->queuedCount = 0;
+            gracePeriod->firstPhaseDrained = false;
+            gracePeriod->waitPhase = __atomic_fetch_add(&gracePeriod->phase, 1, __ATOMIC_SEQ_CST) & 1u;
+        } else {
+            __atomic_store_n(&gracePeriod->pending, false, __ATOMIC_SEQ_CST);
+            break;
+        }
+    }
+    celixThreadMutex_unlock(&gracePeriod->mutex);
+
+    while (done != NULL) {
+        celix_grace_period_retired_t* retired = done;
+        done = retired->next;
+        retired->destroy(retired->obj);
+        free(retired);
+    }
+}
+
+unsigned int celix_gracePeriod_readBegin(celix_grace_period_t* gracePeriod) {
+    unsigned int phase = __atomic_load_n(&gracePeriod->phase, __ATOMIC_SEQ_CST) & 1u;
+    __atomic_fetch_add(&gracePeriod->readers[phase], 1, __ATOMIC_SEQ_CST);
+    return phase;
+}
+
+void celix_gracePeriod_readEnd(celix_grace_period_t* gracePeriod, unsigned int phase) {
+    if (__atomic_sub_fetch(&gracePeriod->readers[phase], 1, __ATOMIC_SEQ_CST) == 0 &&
+        __atomic_load_n(&gracePeriod->pending, __ATOMIC_SEQ_CST)) {
+        celix_gracePeriod_advance(gracePeriod);
+    }
+}
+
+void celix_gracePeriod_retire(celix_grace_period_t* gracePeriod, void* obj, void (*destroy)(void* obj)) {
+    if (obj == NULL) {
+        return;
+    }
+    celix_grace_period_retired_t* retired = malloc(sizeof(*retired));
+    if (retired == NULL) {
+        celix_gracePeriod_synchronize(gracePeriod);
+        destroy(obj);
+        return;
+    }
+    retired->obj = obj;
+    retired->destroy = destroy;
+
+    celixThreadMutex_lock(&gracePeriod->mutex);
+    retired->next = gracePeriod->queued;
+    gracePeriod->queued = retired;
+    gracePeriod->queuedCount += 1;
+    gracePeriod->requested += 1;
+    __atomic_store_n(&gracePeriod->pending, true, __ATOMIC_SEQ_CST);
+    celixThreadMutex_unlock(&gracePeriod->mutex);
+
+    celix_gracePeriod_advance(gracePeriod);
+}
+
+void celix_gracePeriod_synchronize(celix_grace_period_t* gracePeriod) {
+    celixThreadMutex_lock(&gracePeriod->mutex);
+    gracePeriod->queuedCount += 1;
+    unsigned long ticket = ++gracePeriod->requested;
+    __atomic_store_n(&gracePeriod->pending, true, __ATOMIC_SEQ_CST);
+    celixThreadMutex_unlock(&gracePeriod->mutex);
+
+    celix_gracePeriod_advance(gracePeriod);
+
+    celixThreadMutex_lock(&gracePeriod->mutex);
+    while (gracePeriod->completed < ticket) {
+        celixThreadCondition_wait(&gracePeriod->cond, &gracePeriod->mutex);
+    }
+    celixThreadMutex_unlock(&gracePeriod->mutex);
+}
@@ -109,10 +109,10 @@ static unsigned int celix_hashMap_indexFor(unsigned int h, unsigned int length)
 }
 
 /**
- * @brief get entry from hash map. Long key is used if strKey is NULL.
+ * @brief get entry from hash map using an already calculated hash. Long key is used if strKey is NULL.
  */
-static celix_hash_map_entry_t* celix_hashMap_getEntry(const celix_hash_map_t* map, const char* strKey, long longKey) {
-    unsigned int hash = strKey ? celix_utils_stringHash(strKey) : celix_longHashMap_hash(longKey);
+static celix_hash_map_entry_t*
+celix_hashMap_getEntryWithHash(const celix_hash_map_t* map, const char* strKey, long longKey, unsigned int hash) {
     unsigned int index = celix_hashMap_indexFor(hash, map->bucketsSize);
     if (strKey) {
         for (celix_hash_map_entry_t* entry = map->buckets[index]; entry != NULL; entry = entry->next) {
@@ -130,6 +130,14 @@ static celix_hash_map_entry_t* celix_hashMap_getEntry(const celix_hash_map_t* ma
     return NULL;
 }
 
+/**
+ * @brief get entry from hash map. Long key is used if strKey is NULL.
+ */
+static celix_hash_map_entry_t* celix_hashMap_getEntry(const celix_hash_map_t* map, const char* strKey, long longKey) {
+    unsigned int hash = strKey ? celix_utils_stringHash(strKey) : celix_longHashMap_hash(longKey);
+    return celix_hashMap_getEntryWithHash(map, strKey, longKey, hash);
+}
+
 static void* celix_hashMap_get(const celix_hash_map_t* map, const char* strKey, long longKey) {
     celix_hash_map_entry_t* entry = celix_hashMap_getEntry(map, strKey, longKey);
     if (entry != NULL) {
@@ -808,3 +816,8 @@ celix_hash_map_statistics_t celix_longHashMap_getStatistics(const celix_long_has
 celix_hash_map_statistics_t celix_stringHashMap_getStatistics(const celix_string_hash_map_t* map) {
     return celix_hashMap_getStatistics(&map->genericMap);
 }
+
+void* celix_stringHashMap_getWithHash(const celix_string_hash_map_t* map, const char* key, unsigned int hash) {
+    celix_hash_map_entry_t* entry = celix_hashMap_getEntryWithHash(&map->genericMap, key, 0, hash);
+    return entry != NULL ? entry->value.ptrValue : NULL;
+}
@@ -41,6 +41,20 @@ celix_properties_entry_t* celix_properties_allocEntry(celix_properties_t* proper
  */
 char* celix_properties_createString(celix_properties_t* properties, const char* str);
 
+/**
+ * @brief Convert the small map of the provided properties to a hash map. Nop if the properties already uses a hash map.
+ */
+celix_status_t celix_properties_convertToHashMap(celix_properties_t* properties);
+
+/**
+ * @brief Parse the properties lines of the provided input and set the parsed properties.
+ * @param[in] props The properties to set the parsed properties in.
+ * @param[in] input The input, which does not need to be '\0' terminated.
+ * @param[in] inputLen The length of the input.
+ * @return CELIX_SUCCESS if the input is parsed successfully, CELIX_ENOMEM if memory could not be allocated.
+ */
+celix_status_t celix_properties_parseLines(celix_properties_t* props, const char* input, size_t inputLen);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "celix_string_intern.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "celix_err.h"
+#include "celix_string_hash_map.h"
+#include "celix_threads.h"
+#include "celix_utils.h"
+#include "celix_utils_private_constants.h"
+
+/**
+ * An interned string. The interned string (str) is also used as the (weakly stored) key of the string intern table,
+ * so that the entry can be found back from an interned string pointer.
+ */
+typedef struct celix_interned_string {
+    size_t refCount;   // protected by celix_stringIntern_mutex
+    unsigned int hash; // read-only
+    char str[];        // read-only
+} celix_interned_string_t;
+
+static celix_thread_mutex_t celix_stringIntern_mutex = CELIX_THREAD_MUTEX_INITIALIZER;
+static celix_string_hash_map_t* celix_stringIntern_table = NULL; // protected by celix_stringIntern_mutex, created lazily
+static bool celix_stringIntern_enabled = CELIX_UTILS_STRING_INTERNING;
+
+static celix_interned_string_t* celix_stringIntern_entry(const char* interned) {
+    return (celix_interned_string_t*)(interned - offsetof(celix_interned_string_t, str));
+}
+
+bool celix_stringIntern_isEnabled(void) {
+    return __atomic_load_n(&celix_stringIntern_enabled, __ATOMIC_RELAXED);
+}
+
+void celix_stringIntern_setEnabled(bool enabled) {
+    __atomic_store_n(&celix_stringIntern_enabled, enabled, __ATOMIC_RELAXED);
+}
+
+const char* celix_stringIntern_acquire(const char* str) {
+    if (str == NULL) {
+        return NULL;
+    }
+
+    celixThreadMutex_lock(&celix_stringIntern_mutex);
+    if (celix_stringIntern_table == NULL) {
+        celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+        opts.storeKeysWeakly = true;
+        celix_stringIntern_table = celix_stringHashMap_createWithOptions(&opts);
+        if (celix_stringIntern_table == NULL) {
+            celixThreadMutex_unlock(&celix_stringIntern_mutex);
+            celix_err_push("Failed to create string intern table");
+            return NULL;
+        }
+    }
+
+    celix_interned_string_t* entry = celix_stringHashMap_get(celix_stringIntern_table, str);
+    if (entry != NULL) {
+        entry->refCount += 1;
+        celixThreadMutex_unlock(&celix_stringIntern_mutex);
+        return entry->str;
+    }
+
+    size_t len = strnlen(str, CELIX_UTILS_MAX_STRLEN);
+    entry = malloc(sizeof(*entry) + len + 1);
+    if (entry == NULL) {
+        celixThreadMutex_unlock(&celix_stringIntern_mutex);
+        celix_err_push("Failed to allocate interned string");
+        return NULL;
+    }
+    entry->refCount = 1;
+    entry->hash = celix_utils_stringHash(str);
+    memcpy(entry->str, str, len);
+    entry->str[len] = '\0';
+    if (celix_stringHashMap_put(celix_stringIntern_table, entry->str, entry) != CELIX_SUCCESS) {
+        celixThreadMutex_unlock(&celix_stringIntern_mutex);
+        free(entry);
+        celix_err_push("Failed to add interned string");
+        return NULL;
+    }
+    celixThreadMutex_unlock(&celix_stringIntern_mutex);
+    return entry->str;
+}
+
+/**
+ * Decrease the reference count of the interned string entry. Should be called with celix_stringIntern_mutex locked.
+ */
+static void celix_stringIntern_releaseEntry(celix_interned_string_t* entry) {
+    entry->refCount -= 1;
+    if (entry->refCount == 0) {
+        celix_stringHashMap_remove(celix_stringIntern_table, entry->str);
+        free(entry);
+        if (celix_stringHashMap_size(celix_stringIntern_table) == 0) {
+            celix_stringHashMap_destroy(celix_stringIntern_table);
+            celix_stringIntern_table = NULL;
+        }
+    }
+}
+
+void celix_stringIntern_release(const char* interned) {
+    if (interned == NULL) {
+        return;
+    }
+    celixThreadMutex_lock(&celix_stringIntern_mutex);
+    celix_stringIntern_releaseEntry(celix_stringIntern_entry(interned));
+    celixThreadMutex_unlock(&celix_stringIntern_mutex);
+}
+
+bool celix_stringIntern_releaseIfInterned(const char* str) {
+    if (str == NULL) {
+        return false;
+    }
+    celixThreadMutex_lock(&celix_stringIntern_mutex);
+    celix_interned_string_t* entry =
+        celix_stringIntern_table == NULL ? NULL : celix_stringHashMap_get(celix_stringIntern_table, str);
+    bool interned = entry != NULL && entry->str == str;
+    if (interned) {
+        celix_stringIntern_releaseEntry(entry);
+    }
+    celixThreadMutex_unlock(&celix_stringIntern_mutex);
+    return interned;
+}
+
+unsigned int celix_stringIntern_hash(const char* interned) {
+    return celix_stringIntern_entry(interned)->hash;
+}
+
+size_t celix_stringIntern_size(void) {
+    celixThreadMutex_lock(&celix_stringIntern_mutex);
+    size_t size = celix_stringIntern_table == NULL ? 0 : celix_stringHashMap_size(celix_stringIntern_table);
+    celixThreadMutex_unlock(&celix_stringIntern_mutex);
+    return size;
+}
@@ -28,14 +28,22 @@
 #include "celix_err.h"
 #include "celix_errno.h"
 #include "celix_filter.h"
+#include "celix_properties_internal.h"
 #include "celix_stdio_cleanup.h"
 #include "celix_stdlib_cleanup.h"
+#include "celix_string_intern.h"
 #include "celix_version.h"
 #include "filter.h"
 
 // ignoring clang-tidy recursion warnings for this file, because filter uses recursion
 // NOLINTBEGIN(misc-no-recursion)
 
+/**
+ * The service name attribute (CELIX_FRAMEWORK_SERVICE_NAME). Equal filter values for this attribute are interned,
+ * because the same service names are used in many service tracker filters.
+ */
+#define CELIX_FILTER_SERVICE_NAME_ATTRIBUTE "objectClass"
+
 struct celix_filter_internal {
     bool convertedToLong;
     long longValue;
@@ -48,6 +56,9 @@ struct celix_filter_internal {
 
     bool convertedToVersion;
     celix_version_t* versionValue;
+
+    bool attributeInterned;
+    bool valueInterned;
 };
 
 static void celix_filter_skipWhiteSpace(const char* filterString, int* pos);
@@ -516,7 +527,8 @@ static bool celix_filter_hasFilterChildren(celix_filter_t* filter) {
 }
 
 /**
- * Compiles the filter, so that the attribute values are converted to the typed values if possible.
+ * Compiles the filter, so that the attribute values are converted to the typed values if possible and the attribute
+ * names are interned if string interning is enabled.
  */
 static celix_status_t celix_filter_compile(celix_filter_t* filter) {
     if (celix_filter_isCompareOperand(filter->operand)) {
@@ -546,6 +558,36 @@ static celix_status_t celix_filter_compile(celix_filter_t* filter) {
         } while(false);
     }
 
+    if (filter->attribute != NULL && celix_stringIntern_isEnabled()) {
+        if (filter->internal == NULL) {
+            filter->internal = calloc(1, sizeof(*filter->internal));
+            if (filter->internal == NULL) {
+                celix_err_push("Filter Error: Failed to allocate memory.");
+                return CELIX_ENOMEM;
+            }
+        }
+        const char* internedAttribute = celix_stringIntern_acquire(filter->attribute);
+        if (internedAttribute == NULL) {
+            celix_err_push("Filter Error: Failed to intern attribute.");
+            return CELIX_ENOMEM;
+        }
+        free((char*)filter->attribute);
+        filter->attribute = internedAttribute;
+        filter->internal->attributeInterned = true;
+
+        if (filter->operand == CELIX_FILTER_OPERAND_EQUAL && filter->value != NULL &&
+            strcmp(filter->attribute, CELIX_FILTER_SERVICE_NAME_ATTRIBUTE) == 0) {
+            const char* internedValue = celix_stringIntern_acquire(filter->value);
+            if (internedValue == NULL) {
+                celix_err_push("Filter Error: Failed to intern value.");
+                return CELIX_ENOMEM;
+            }
+            free((char*)filter->value);
+            filter->value = internedValue;
+            filter->internal->valueInterned = true;
+        }
+    }
+
     if (celix_filter_hasFilterChildren(filter)) {
         for (int i = 0; i < celix_arrayList_size(filter->children); i++) {
             celix_filter_t* child = celix_arrayList_get(filter->children, i);
@@ -752,9 +794,17 @@ void celix_filter_destroy(celix_filter_t* filter) {
         celix_arrayList_destroy(filter->children);
         filter->children = NULL;
     }
-    free((char*)filter->value);
+    if (filter->internal != NULL && filter->internal->valueInterned) {
+        celix_stringIntern_release(filter->value);
+    } else {
+        free((char*)filter->value);
+    }
     filter->value = NULL;
-    free((char*)filter->attribute);
+    if (filter->internal != NULL && filter->internal->attributeInterned) {
+        celix_stringIntern_release(filter->attribute);
+    } else {
+        free((char*)filter->attribute);
+    }
     filter->attribute = NULL;
     free((char*)filter->filterStr);
     filter->filterStr = NULL;
@@ -802,7 +852,12 @@ bool celix_filter_match(const celix_filter_t* filter, const celix_properties_t*
     }
 
     // substring, equal, greater, greaterEqual, less, lessEqual, approx done with matchPropertyEntry
-    const celix_properties_entry_t* entry = celix_properties_getEntry(properties, filter->attribute);
+    const celix_properties_entry_t* entry;
+    if (filter->internal != NULL && filter->internal->attributeInterned) {
+        entry = celix_properties_getEntryForInternedKey(properties, filter->attribute);
+    } else {
+        entry = celix_properties_getEntry(properties, filter->attribute);
+    }
     if (!entry) {
             return false;
     }
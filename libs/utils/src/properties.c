@@ -23,11 +23,15 @@
 #include "celix_properties_internal.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "celix_build_assert.h"
 #include "celix_err.h"
@@ -35,15 +39,47 @@
 #include "celix_utils.h"
 #include "celix_stdlib_cleanup.h"
 #include "celix_convert_utils.h"
+#include "celix_ref.h"
+#include "celix_string_intern.h"
 #include "celix_utils_private_constants.h"
 
 static const char* const CELIX_PROPERTIES_BOOL_TRUE_STRVAL = "true";
 static const char* const CELIX_PROPERTIES_BOOL_FALSE_STRVAL = "false";
 static const char* const CELIX_PROPERTIES_EMPTY_STRVAL = "";
 
-struct celix_properties {
+/**
+ * The max number of entries stored in the small map of a properties object, before switching to a hash map.
+ */
+#define CELIX_PROPERTIES_SMALL_MAP_SIZE CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE
+
+/**
+ * The data of a properties object. The data is shared between a frozen properties object and its lazy copies and is
+ * copied when a sharing lazy copy is modified (copy-on-write).
+ *
+ * The data is always allocated together with the properties object that created it (see
+ * celix_properties_with_data_t), so that creating a properties object needs a single allocation.
+ */
+typedef struct celix_properties_data {
+    struct celix_ref ref;
+
+    /**
+     * The hash map with the entries, NULL as long as the entries fit in the small map.
+     */
     celix_string_hash_map_t* map;
 
+    /**
+     * Small map used to store the entries - as long as there are no more than CELIX_PROPERTIES_SMALL_MAP_SIZE
+     * entries - instead of the hash map, so that for most service properties no hash map (buckets and entry nodes)
+     * is needed.
+     *
+     * The small map is an insertion ordered array with the hashes of the keys stored separately, so that a lookup
+     * mostly only needs to scan a single cache line.
+     */
+    unsigned int smallHashes[CELIX_PROPERTIES_SMALL_MAP_SIZE];
+    const char* smallKeys[CELIX_PROPERTIES_SMALL_MAP_SIZE];
+    celix_properties_entry_t* smallEntries[CELIX_PROPERTIES_SMALL_MAP_SIZE];
+    int smallSize;
+
     /**
      * String buffer used to store the first key/value entries,
      * so that in many cases - for usage in service properties - additional memory allocations are not needed.
@@ -73,11 +109,91 @@ struct celix_properties {
      * The current string buffer index.
      */
     int currentEntriesBufferIndex;
+
+    /**
+     * Whether the keys are interned (see celix_string_intern.h). Determined when the properties is created.
+     */
+    bool internKeys;
+} celix_properties_data_t;
+
+struct celix_properties {
+    celix_properties_data_t* data;
+
+    /**
+     * The data allocated together with this properties object, NULL for a lazy copy.
+     * Because the properties object is part of the allocation of its embedded data, it keeps its reference to the
+     * embedded data when it switches to a copy of the data (copy-on-write) and only releases it when destroyed.
+     */
+    celix_properties_data_t* embeddedData;
+
+    /**
+     * Whether the properties object can no longer be modified, only the data of a frozen properties object is shared
+     * with lazy copies.
+     */
+    bool frozen;
 };
 
-#define MALLOC_BLOCK_SIZE 5
+/**
+ * A properties object and its embedded data, allocated with a single allocation.
+ */
+typedef struct celix_properties_with_data {
+    celix_properties_t props;
+    celix_properties_data_t data;
+} celix_properties_with_data_t;
+
+/**
+ * The size of the (stack) line buffer used when parsing properties lines. Longer lines use an allocated buffer.
+ */
+#define CELIX_PROPERTIES_LINE_BUFFER_SIZE 512
+
+static void celix_properties_destroySmallMap(celix_properties_data_t* data);
+static void celix_properties_destroyEntry(celix_properties_data_t* data, celix_properties_entry_t* entry);
 
-static celix_status_t celix_properties_parseLine(const char* line, celix_properties_t* props);
+static bool celix_properties_releaseDataCallback(struct celix_ref* ref) {
+    celix_properties_data_t* data = (celix_properties_data_t*)ref;
+    if (data->map != NULL) {
+        celix_stringHashMap_destroy(data->map);
+    } else {
+        celix_properties_destroySmallMap(data);
+    }
+    free((char*)data - offsetof(celix_properties_with_data_t, data));
+    return true;
+}
+
+static void celix_properties_releaseData(celix_properties_data_t* data) {
+    if (data != NULL) {
+        celix_ref_put(&data->ref, celix_properties_releaseDataCallback);
+    }
+}
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_properties_data_t, celix_properties_releaseData)
+
+/**
+ * Ensure that the data of the properties is not shared with lazy copies, before the properties is modified.
+ * If the data is shared, the properties gets its own copy of the data and the reference to the shared data is
+ * returned, so that the caller can release it when arguments pointing into the shared data are no longer used.
+ */
+static celix_status_t celix_properties_prepareWrite(celix_properties_t* properties,
+                                                    celix_properties_data_t** sharedDataOut) {
+    *sharedDataOut = NULL;
+    if (properties->frozen) {
+        celix_err_push("Cannot modify frozen properties");
+        return CELIX_ILLEGAL_STATE;
+    }
+    if (__atomic_load_n(&properties->data->ref.count, __ATOMIC_ACQUIRE) == 1) {
+        return CELIX_SUCCESS;
+    }
+    celix_properties_t* copy = celix_properties_copy(properties);
+    if (copy == NULL) {
+        return CELIX_ENOMEM;
+    }
+    if (properties->data != properties->embeddedData) {
+        *sharedDataOut = properties->data;
+    } // else the reference to the embedded data is kept until the properties is destroyed
+    // take over the (reference to the) data of the copy, the copy object itself is freed together with its data
+    properties->data = copy->data;
+    return CELIX_SUCCESS;
+}
 
 properties_pt properties_create(void) { return celix_properties_create(); }
 
@@ -116,22 +232,6 @@ void properties_set(properties_pt properties, const char* key, const char* value
 
 void properties_unset(properties_pt properties, const char* key) { celix_properties_unset(properties, key); }
 
-static void updateBuffers(char** key, char** value, char** output, int outputPos, int* key_len, int* value_len) {
-    if (*output == *key) {
-        if (outputPos == (*key_len) - 1) {
-            (*key_len) += MALLOC_BLOCK_SIZE;
-            *key = realloc(*key, *key_len);
-            *output = *key;
-        }
-    } else {
-        if (outputPos == (*value_len) - 1) {
-            (*value_len) += MALLOC_BLOCK_SIZE;
-            *value = realloc(*value, *value_len);
-            *output = *value;
-        }
-    }
-}
-
 /**
  * Create a new string from the provided str by either using strdup or storing the string the short properties
  * optimization string buffer.
@@ -141,12 +241,13 @@ char* celix_properties_createString(celix_properties_t* properties, const char*
         return (char*)CELIX_PROPERTIES_EMPTY_STRVAL;
     }
     size_t len = strnlen(str, CELIX_UTILS_MAX_STRLEN) + 1;
-    size_t left = CELIX_PROPERTIES_OPTIMIZATION_STRING_BUFFER_SIZE - properties->currentStringBufferIndex;
+    celix_properties_data_t* data = properties->data;
+    size_t left = CELIX_PROPERTIES_OPTIMIZATION_STRING_BUFFER_SIZE - data->currentStringBufferIndex;
     char* result;
     if (len < left) {
-        memcpy(&properties->stringBuffer[properties->currentStringBufferIndex], str, len);
-        result = &properties->stringBuffer[properties->currentStringBufferIndex];
-        properties->currentStringBufferIndex += (int)len;
+        memcpy(&data->stringBuffer[data->currentStringBufferIndex], str, len);
+        result = &data->stringBuffer[data->currentStringBufferIndex];
+        data->currentStringBufferIndex += (int)len;
     } else {
         result = celix_utils_strdup(str);
     }
@@ -156,18 +257,133 @@ char* celix_properties_createString(celix_properties_t* properties, const char*
  * Free string, but first check if it a static const char* const string or part of the short properties
  * optimization.
  */
-static void celix_properties_freeString(celix_properties_t* properties, char* str) {
+static void celix_properties_freeString(celix_properties_data_t* data, char* str) {
     if (str == CELIX_PROPERTIES_BOOL_TRUE_STRVAL || str == CELIX_PROPERTIES_BOOL_FALSE_STRVAL ||
         str == CELIX_PROPERTIES_EMPTY_STRVAL) {
         // str is static const char* const -> nop
-    } else if (str >= properties->stringBuffer &&
-               str < (properties->stringBuffer + CELIX_PROPERTIES_OPTIMIZATION_STRING_BUFFER_SIZE)) {
+    } else if (str >= data->stringBuffer &&
+               str < (data->stringBuffer + CELIX_PROPERTIES_OPTIMIZATION_STRING_BUFFER_SIZE)) {
         // str is part of the properties string buffer -> nop
     } else {
         free(str);
     }
 }
 
+/**
+ * Create a new key string from the provided key by either interning the key (if string interning is enabled for the
+ * properties) or using celix_properties_createString.
+ */
+static char* celix_properties_createKey(celix_properties_t* properties, const char* key) {
+    if (properties->data->internKeys) {
+        return (char*)celix_stringIntern_acquire(key);
+    }
+    return celix_properties_createString(properties, key);
+}
+
+/**
+ * Free a key string created with celix_properties_createKey or provided to celix_properties_setWithoutCopy.
+ * Note that keys provided to celix_properties_setWithoutCopy are used as-is and are therefore never interned.
+ */
+static void celix_properties_freeKey(celix_properties_data_t* data, char* key) {
+    if (!data->internKeys || !celix_stringIntern_releaseIfInterned(key)) {
+        celix_properties_freeString(data, key);
+    }
+}
+
+/**
+ * Find the index of the key in the small map or -1 if the key is not in the small map.
+ */
+static int celix_properties_findSmallMapIndex(const celix_properties_data_t* data, const char* key, unsigned int hash) {
+    for (int i = 0; i < data->smallSize; ++i) {
+        if (data->smallHashes[i] == hash && celix_utils_stringEquals(data->smallKeys[i], key)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Returns the entry for the key with the provided (celix_utils_stringHash) hash, using either the small map or the
+ * hash map.
+ */
+static celix_properties_entry_t*
+celix_properties_findEntryWithHash(const celix_properties_data_t* data, const char* key, unsigned int hash) {
+    if (data->map != NULL) {
+        return celix_stringHashMap_getWithHash(data->map, key, hash);
+    }
+    int index = celix_properties_findSmallMapIndex(data, key, hash);
+    return index >= 0 ? data->smallEntries[index] : NULL;
+}
+
+/**
+ * Returns the entry for the key, using either the small map or the hash map.
+ */
+static celix_properties_entry_t* celix_properties_findEntry(const celix_properties_data_t* data, const char* key) {
+    if (data->map != NULL) {
+        return celix_stringHashMap_get(data->map, key);
+    }
+    if (key == NULL) {
+        return NULL;
+    }
+    return celix_properties_findEntryWithHash(data, key, celix_utils_stringHash(key));
+}
+
+/**
+ * Returns whether a new key can be added to the small map. If not, the properties should be converted to a hash map.
+ */
+static bool celix_properties_isSmallMapFull(const celix_properties_data_t* data) {
+    return data->map == NULL && data->smallSize >= CELIX_PROPERTIES_SMALL_MAP_SIZE;
+}
+
+/**
+ * Put the entry in the small map. Like celix_stringHashMap_put, if the key already exists the existing entry is
+ * destroyed and the existing key is kept.
+ * Note that if the key does not exist, the small map should not be full.
+ */
+static void celix_properties_putSmallMapEntry(celix_properties_data_t* data,
+                                              const char* key,
+                                              celix_properties_entry_t* entry) {
+    unsigned int hash = celix_utils_stringHash(key);
+    int index = celix_properties_findSmallMapIndex(data, key, hash);
+    if (index >= 0) {
+        celix_properties_destroyEntry(data, data->smallEntries[index]);
+        data->smallEntries[index] = entry;
+        return;
+    }
+    assert(data->smallSize < CELIX_PROPERTIES_SMALL_MAP_SIZE);
+    data->smallHashes[data->smallSize] = hash;
+    data->smallKeys[data->smallSize] = key;
+    data->smallEntries[data->smallSize] = entry;
+    data->smallSize += 1;
+}
+
+/**
+ * Remove the entry from the small map and destroy the entry and key.
+ */
+static void celix_properties_removeSmallMapEntry(celix_properties_data_t* data, const char* key) {
+    int index = celix_properties_findSmallMapIndex(data, key, celix_utils_stringHash(key));
+    if (index < 0) {
+        return;
+    }
+    char* removedKey = (char*)data->smallKeys[index];
+    celix_properties_entry_t* removedEntry = data->smallEntries[index];
+    int nrOfMoved = data->smallSize - index - 1;
+    memmove(&data->smallHashes[index], &data->smallHashes[index + 1], nrOfMoved * sizeof(data->smallHashes[0]));
+    memmove(&data->smallKeys[index], &data->smallKeys[index + 1], nrOfMoved * sizeof(data->smallKeys[0]));
+    memmove(&data->smallEntries[index], &data->smallEntries[index + 1], nrOfMoved * sizeof(data->smallEntries[0]));
+    data->smallSize -= 1;
+    celix_properties_destroyEntry(data, removedEntry);
+    celix_properties_freeKey(data, removedKey);
+}
+
+static void celix_properties_destroySmallMap(celix_properties_data_t* data) {
+    for (int i = 0; i < data->smallSize; ++i) {
+        celix_properties_destroyEntry(data, data->smallEntries[i]);
+        celix_properties_freeKey(data, (char*)data->smallKeys[i]);
+    }
+    data->smallSize = 0;
+}
+
 /**
  * Fill entry and optional use the short properties optimization string buffer.
  */
@@ -214,9 +430,10 @@ static celix_status_t celix_properties_fillEntry(celix_properties_t* properties,
  * Allocate entry and optionally use the short properties optimization entries buffer.
  */
 celix_properties_entry_t* celix_properties_allocEntry(celix_properties_t* properties) {
+    celix_properties_data_t* data = properties->data;
     celix_properties_entry_t* entry;
-    if (properties->currentEntriesBufferIndex < CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE) {
-        entry = &properties->entriesBuffer[properties->currentEntriesBufferIndex++];
+    if (data->currentEntriesBufferIndex < CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE) {
+        entry = &data->entriesBuffer[data->currentEntriesBufferIndex++];
     } else {
         entry = malloc(sizeof(*entry));
     }
@@ -239,17 +456,17 @@ static celix_properties_entry_t* celix_properties_createEntryWithNoCopy(celix_pr
     return entry;
 }
 
-static void celix_properties_destroyEntry(celix_properties_t* properties, celix_properties_entry_t* entry) {
-    celix_properties_freeString(properties, (char*)entry->value);
+static void celix_properties_destroyEntry(celix_properties_data_t* data, celix_properties_entry_t* entry) {
+    celix_properties_freeString(data, (char*)entry->value);
     if (entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
         celix_version_destroy((celix_version_t*)entry->typed.versionValue);
     }
 
-    if (entry >= properties->entriesBuffer &&
-        entry <= (properties->entriesBuffer + CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE)) {
-        if (entry == (properties->entriesBuffer + properties->currentEntriesBufferIndex - 1)) {
+    if (entry >= data->entriesBuffer &&
+        entry <= (data->entriesBuffer + CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE)) {
+        if (entry == (data->entriesBuffer + data->currentEntriesBufferIndex - 1)) {
             // entry is part of the properties entries buffer -> decrease the currentEntriesBufferIndex
-            properties->currentEntriesBufferIndex -= 1;
+            data->currentEntriesBufferIndex -= 1;
         } else {
             // entry is part of the properties entries buffer, but not the last entry -> nop
         }
@@ -278,7 +495,7 @@ static celix_properties_entry_t* celix_properties_createEntry(celix_properties_t
     celix_status_t status = celix_properties_fillEntry(properties, entry, prototype);
     if (status != CELIX_SUCCESS) {
         celix_err_pushf("Cannot fill property entry");
-        celix_properties_destroyEntry(properties, entry);
+        celix_properties_destroyEntry(properties->data, entry);
         return NULL;
     }
     return entry;
@@ -306,69 +523,131 @@ static celix_status_t celix_properties_createAndSetEntry(celix_properties_t* pro
         return CELIX_ILLEGAL_ARGUMENT;
     }
 
+    // the key and prototype can point into the shared data, so keep the shared data until the entry is set.
+    celix_autoptr(celix_properties_data_t) sharedData = NULL;
+    celix_status_t status = celix_properties_prepareWrite(properties, &sharedData);
+    if (status != CELIX_SUCCESS) {
+        if (prototype->valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
+            celix_version_destroy((celix_version_t*)prototype->typed.versionValue);
+        }
+        return status;
+    }
+
     celix_properties_entry_t* entry = celix_properties_createEntry(properties, prototype);
     if (!entry) {
         return CELIX_ENOMEM;
     }
 
     const char* mapKey = key;
-    if (!celix_stringHashMap_hasKey(properties->map, key)) {
-        // new entry, needs new allocated key;
-        mapKey = celix_properties_createString(properties, key);
+    bool isNewKey = celix_properties_findEntry(properties->data, key) == NULL;
+    if (isNewKey) {
+        // new entry, needs new allocated key and possibly a hash map;
+        mapKey = celix_properties_createKey(properties, key);
         if (!mapKey) {
-            celix_properties_destroyEntry(properties, entry);
+            celix_properties_destroyEntry(properties->data, entry);
             return CELIX_ENOMEM;
         }
     }
 
-    celix_status_t status = celix_stringHashMap_put(properties->map, mapKey, entry);
+    if (isNewKey && celix_properties_isSmallMapFull(properties->data)) {
+        status = celix_properties_convertToHashMap(properties);
+    }
+    if (status == CELIX_SUCCESS && properties->data->map == NULL) {
+        celix_properties_putSmallMapEntry(properties->data, mapKey, entry);
+    } else if (status == CELIX_SUCCESS) {
+        status = celix_stringHashMap_put(properties->data->map, mapKey, entry);
+    }
     if (status != CELIX_SUCCESS) {
-        celix_properties_destroyEntry(properties, entry);
-        if (mapKey != key) {
-            celix_properties_freeString(properties, (char*)mapKey);
+        celix_properties_destroyEntry(properties->data, entry);
+        if (isNewKey) {
+            celix_properties_freeKey(properties->data, (char*)mapKey);
         }
     }
     return status;
 }
 
+/**
+ * Note that the hash map callbacks are a nop if the hash map is not (yet) used by the properties data. This is the
+ * case if converting the small map to a hash map fails and the entries and keys are still owned by the small map.
+ */
 static void celix_properties_removeKeyCallback(void* handle, char* key) {
-    celix_properties_t* properties = handle;
-    celix_properties_freeString(properties, key);
+    celix_properties_data_t* data = handle;
+    if (data->map != NULL) {
+        celix_properties_freeKey(data, key);
+    }
 }
 
 static void celix_properties_removeEntryCallback(void* handle,
                                                  const char* key __attribute__((unused)),
                                                  celix_hash_map_value_t val) {
-    celix_properties_t* properties = handle;
-    celix_properties_entry_t* entry = val.ptrValue;
-    celix_properties_destroyEntry(properties, entry);
+    celix_properties_data_t* data = handle;
+    if (data->map != NULL) {
+        celix_properties_entry_t* entry = val.ptrValue;
+        celix_properties_destroyEntry(data, entry);
+    }
 }
 
-celix_properties_t* celix_properties_create() {
-    celix_properties_t* props = malloc(sizeof(*props));
-    if (props != NULL) {
-        celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
-        opts.storeKeysWeakly = true;
-        opts.initialCapacity = CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE;
-        opts.removedCallbackData = props;
-        opts.removedCallback = celix_properties_removeEntryCallback;
-        opts.removedKeyCallback = celix_properties_removeKeyCallback;
-        props->map = celix_stringHashMap_createWithOptions(&opts);
-        props->currentStringBufferIndex = 0;
-        props->currentEntriesBufferIndex = 0;
-        if (props->map == NULL) {
-            free(props);
-            props = NULL;
+celix_status_t celix_properties_convertToHashMap(celix_properties_t* properties) {
+    celix_properties_data_t* data = properties->data;
+    if (data->map != NULL) {
+        return CELIX_SUCCESS;
+    }
+    celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+    opts.storeKeysWeakly = true;
+    opts.initialCapacity = CELIX_PROPERTIES_SMALL_MAP_SIZE * 2;
+    opts.removedCallbackData = data;
+    opts.removedCallback = celix_properties_removeEntryCallback;
+    opts.removedKeyCallback = celix_properties_removeKeyCallback;
+    celix_string_hash_map_t* map = celix_stringHashMap_createWithOptions(&opts);
+    if (map == NULL) {
+        return CELIX_ENOMEM;
+    }
+    for (int i = 0; i < data->smallSize; ++i) {
+        celix_status_t status = celix_stringHashMap_put(map, data->smallKeys[i], data->smallEntries[i]);
+        if (status != CELIX_SUCCESS) {
+            celix_stringHashMap_destroy(map); // note data->map is still NULL, so the entries are not destroyed
+            return status;
         }
     }
+    data->map = map;
+    data->smallSize = 0;
+    return CELIX_SUCCESS;
+}
+
+celix_properties_t* celix_properties_create() {
+    celix_properties_with_data_t* propsWithData = malloc(sizeof(*propsWithData));
+    if (propsWithData == NULL) {
+        return NULL;
+    }
+    celix_properties_t* props = &propsWithData->props;
+    celix_properties_data_t* data = &propsWithData->data;
+    celix_ref_init(&data->ref);
+    data->map = NULL;
+    data->smallSize = 0;
+    data->currentStringBufferIndex = 0;
+    data->currentEntriesBufferIndex = 0;
+    data->internKeys = celix_stringIntern_isEnabled();
+    props->data = data;
+    props->embeddedData = data;
+    props->frozen = false;
     return props;
 }
 
 void celix_properties_destroy(celix_properties_t* props) {
-    if (props != NULL) {
-        celix_stringHashMap_destroy(props->map);
+    if (props == NULL) {
+        return;
+    }
+    if (props->embeddedData == NULL) {
+        // lazy copy
+        celix_properties_releaseData(props->data);
         free(props);
+        return;
     }
+    if (props->data != props->embeddedData) {
+        celix_properties_releaseData(props->data);
+    }
+    // note releasing the embedded data can free the props
+    celix_properties_releaseData(props->embeddedData);
 }
 
 celix_properties_t* celix_properties_load(const char* filename) {
@@ -377,96 +656,185 @@ celix_properties_t* celix_properties_load(const char* filename) {
         celix_err_pushf("Cannot open file '%s'", filename);
         return NULL;
     }
+
+    // For regular files, parse the file content directly from a read-only memory mapping of the file
+    struct stat st;
+    if (fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        size_t size = (size_t)st.st_size;
+        void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (mapped != MAP_FAILED) {
+            (void)madvise(mapped, size, MADV_SEQUENTIAL);
+            celix_autoptr(celix_properties_t) props = celix_properties_create();
+            celix_status_t status = CELIX_ENOMEM;
+            if (props) {
+                status = celix_properties_parseLines(props, mapped, strnlen(mapped, size));
+            } else {
+                celix_err_push("Failed to create properties");
+            }
+            munmap(mapped, size);
+            fclose(file);
+            return status == CELIX_SUCCESS ? celix_steal_ptr(props) : NULL;
+        }
+    }
+
+    // Fallback for files which cannot be mapped
     celix_properties_t* props = celix_properties_loadWithStream(file);
     fclose(file);
     return props;
 }
 
-static celix_status_t celix_properties_parseLine(const char* line, celix_properties_t* props) {
-    int linePos;
-    int outputPos;
+static bool celix_properties_isCommentChar(char c) { return c == '#' || c == '!'; }
 
-    bool precedingCharIsBackslash = false;
-    char* output = NULL;
-    int key_len = MALLOC_BLOCK_SIZE;
-    int value_len = MALLOC_BLOCK_SIZE;
-    linePos = 0;
-    precedingCharIsBackslash = false;
-    output = NULL;
-    outputPos = 0;
-
-    // Ignore empty lines
-    if (line[0] == '\n' && line[1] == '\0') {
-        return CELIX_SUCCESS;
-    }
+static bool celix_properties_isSeparatorChar(char c) { return c == '=' || c == ':'; }
 
-    celix_autofree char* key = calloc(1, key_len);
-    celix_autofree char* value = calloc(1, value_len);
-    if (!key || !value) {
-        celix_err_pushf("Cannot allocate memory for key or value. Got error %i", errno);
-        return CELIX_ENOMEM;
+/**
+ * Copy the provided string slice, without leading and trailing whitespace, as '\0' terminated string to output.
+ * Returns the number of written chars, including the '\0' terminator.
+ */
+static size_t celix_properties_copyTrimmed(const char* str, size_t len, char* output) {
+    size_t begin = 0;
+    while (begin < len && isspace((unsigned char)str[begin])) {
+        begin += 1;
+    }
+    while (len > begin && isspace((unsigned char)str[len - 1])) {
+        len -= 1;
     }
+    memcpy(output, str + begin, len - begin);
+    output[len - begin] = '\0';
+    return len - begin + 1;
+}
 
-    key[0] = '\0';
-    value[0] = '\0';
+/**
+ * Parse a properties line with escape characters in a single pass. The key and value are written as '\0' terminated
+ * strings to the provided buffer, which should have a size of at least len + 2.
+ * Returns false if the line is a comment line.
+ */
+static bool celix_properties_parseEscapedLine(const char* line, size_t len, char* buffer, char** keyOut, char** valueOut) {
+    char* key = buffer;
+    char* value = NULL;
+    char* output = key;
+    size_t outputPos = 0;
+    bool precedingCharIsBackslash = false;
 
-    while (line[linePos] != '\0') {
-        if (line[linePos] == ' ' || line[linePos] == '\t') {
-            if (output == NULL) {
-                // ignore
-                linePos += 1;
-                continue;
-            }
-        } else {
-            if (output == NULL) {
-                output = key;
-            }
-        }
-        if (line[linePos] == '=' || line[linePos] == ':' || line[linePos] == '#' || line[linePos] == '!') {
+    size_t linePos = 0;
+    while (linePos < len && (line[linePos] == ' ' || line[linePos] == '\t')) {
+        linePos += 1; // ignore leading whitespace
+    }
+
+    for (; linePos < len; ++linePos) {
+        char c = line[linePos];
+        if (celix_properties_isSeparatorChar(c) || celix_properties_isCommentChar(c)) {
             if (precedingCharIsBackslash) {
                 // escaped special character
-                output[outputPos++] = line[linePos];
-                updateBuffers(&key, &value, &output, outputPos, &key_len, &value_len);
+                output[outputPos++] = c;
                 precedingCharIsBackslash = false;
+            } else if (celix_properties_isCommentChar(c) && outputPos == 0) {
+                // comment line, ignore
+                return false;
+            } else if (celix_properties_isSeparatorChar(c) && value == NULL) {
+                output[outputPos++] = '\0';
+                value = output + outputPos;
+                output = value;
+                outputPos = 0;
             } else {
-                if (line[linePos] == '#' || line[linePos] == '!') {
-                    if (outputPos == 0) {
-                        // comment line, ignore
-                        return CELIX_SUCCESS;
-                    } else {
-                        output[outputPos++] = line[linePos];
-                        updateBuffers(&key, &value, &output, outputPos, &key_len, &value_len);
-                    }
-                } else {                   // = or :
-                    if (output == value) { // already have a seperator
-                        output[outputPos++] = line[linePos];
-                        updateBuffers(&key, &value, &output, outputPos, &key_len, &value_len);
-                    } else {
-                        output[outputPos++] = '\0';
-                        updateBuffers(&key, &value, &output, outputPos, &key_len, &value_len);
-                        output = value;
-                        outputPos = 0;
-                    }
-                }
+                output[outputPos++] = c;
             }
-        } else if (line[linePos] == '\\') {
+        } else if (c == '\\') {
             if (precedingCharIsBackslash) { // double backslash -> backslash
                 output[outputPos++] = '\\';
-                updateBuffers(&key, &value, &output, outputPos, &key_len, &value_len);
             }
             precedingCharIsBackslash = true;
         } else { // normal character
             precedingCharIsBackslash = false;
-            output[outputPos++] = line[linePos];
-            updateBuffers(&key, &value, &output, outputPos, &key_len, &value_len);
+            output[outputPos++] = c;
         }
-        linePos += 1;
     }
-    if (output != NULL) {
-        output[outputPos] = '\0';
+    output[outputPos++] = '\0';
+    if (value == NULL) {
+        value = output + outputPos;
+        value[0] = '\0';
     }
 
-    return celix_properties_set(props, celix_utils_trimInPlace(key), celix_utils_trimInPlace(value));
+    *keyOut = celix_utils_trimInPlace(key);
+    *valueOut = celix_utils_trimInPlace(value);
+    return true;
+}
+
+/**
+ * Parse a properties line (without newline) and set the parsed property.
+ *
+ * Lines without escape characters are parsed by directly using the key and value slices of the line, lines with
+ * escape characters are parsed in a single pass to the provided buffer. The buffer should have a size of at least
+ * len + 2.
+ */
+static celix_status_t
+celix_properties_parseLine(celix_properties_t* props, const char* line, size_t len, char* buffer) {
+    char* key;
+    char* value;
+    if (memchr(line, '\\', len) != NULL) {
+        if (!celix_properties_parseEscapedLine(line, len, buffer, &key, &value)) {
+            return CELIX_SUCCESS;
+        }
+    } else {
+        size_t keyBegin = 0;
+        while (keyBegin < len && (line[keyBegin] == ' ' || line[keyBegin] == '\t')) {
+            keyBegin += 1; // ignore leading whitespace
+        }
+        if (keyBegin < len && celix_properties_isCommentChar(line[keyBegin])) {
+            return CELIX_SUCCESS; // comment line, ignore
+        }
+        size_t keyEnd = keyBegin;
+        while (keyEnd < len && !celix_properties_isSeparatorChar(line[keyEnd])) {
+            keyEnd += 1;
+        }
+        size_t valueBegin = keyEnd < len ? keyEnd + 1 : len;
+        if (valueBegin < len && celix_properties_isCommentChar(line[valueBegin])) {
+            return CELIX_SUCCESS; // comment directly after the separator, ignore
+        }
+        key = buffer;
+        value = buffer + celix_properties_copyTrimmed(line + keyBegin, keyEnd - keyBegin, key);
+        celix_properties_copyTrimmed(line + valueBegin, len - valueBegin, value);
+    }
+    return celix_properties_set(props, key, value);
+}
+
+celix_status_t celix_properties_parseLines(celix_properties_t* props, const char* input, size_t inputLen) {
+    char lineBuffer[CELIX_PROPERTIES_LINE_BUFFER_SIZE];
+    celix_autofree char* allocatedLineBuffer = NULL;
+    size_t allocatedLineBufferSize = 0;
+
+    size_t lineBegin = 0;
+    while (lineBegin < inputLen) {
+        const char* newline = memchr(input + lineBegin, '\n', inputLen - lineBegin);
+        size_t lineEnd = newline != NULL ? (size_t)(newline - input) : inputLen;
+        size_t lineLen = lineEnd - lineBegin;
+        if (lineLen == 0) {
+            lineBegin = lineEnd + 1; // ignore empty lines
+            continue;
+        }
+
+        char* buffer = lineBuffer;
+        if (lineLen + 2 > sizeof(lineBuffer)) {
+            if (lineLen + 2 > allocatedLineBufferSize) {
+                free(allocatedLineBuffer);
+                allocatedLineBufferSize = lineLen + 2;
+                allocatedLineBuffer = malloc(allocatedLineBufferSize);
+                if (!allocatedLineBuffer) {
+                    celix_err_pushf("Cannot allocate memory for line buffer of size %zu", lineLen + 2);
+                    return CELIX_ENOMEM;
+                }
+            }
+            buffer = allocatedLineBuffer;
+        }
+
+        celix_status_t status = celix_properties_parseLine(props, input + lineBegin, lineLen, buffer);
+        if (status != CELIX_SUCCESS) {
+            celix_err_pushf("Failed to parse line '%.*s'", (int)lineLen, input + lineBegin);
+            return status;
+        }
+        lineBegin = lineEnd + 1;
+    }
+    return CELIX_SUCCESS;
 }
 
 celix_properties_t* celix_properties_loadWithStream(FILE* file) {
@@ -512,40 +880,22 @@ celix_properties_t* celix_properties_loadWithStream(FILE* file) {
     }
     fileBuffer[fileSize] = '\0'; // ensure a '\0' at the end of the fileBuffer
 
-    char* savePtr = NULL;
-    char* line = strtok_r(fileBuffer, "\n", &savePtr);
-    while (line != NULL) {
-        celix_status_t status = celix_properties_parseLine(line, props);
-        if (status != CELIX_SUCCESS) {
-            celix_err_pushf("Failed to parse line '%s'", line);
-            return NULL;
-        }
-        line = strtok_r(NULL, "\n", &savePtr);
-    }
-
-    return celix_steal_ptr(props);
+    celix_status_t status = celix_properties_parseLines(props, fileBuffer, strlen(fileBuffer));
+    return status == CELIX_SUCCESS ? celix_steal_ptr(props) : NULL;
 }
 
 celix_properties_t* celix_properties_loadFromString(const char* input) {
-    celix_autoptr(celix_properties_t) props = celix_properties_create();
-    celix_autofree char* in = celix_utils_strdup(input);
-    if (!props || !in) {
-        celix_err_push("Failed to create properties or duplicate input string");
+    if (!input) {
+        celix_err_push("Failed to load properties from a NULL string");
         return NULL;
     }
-
-    char* line = NULL;
-    char* saveLinePointer = NULL;
-    line = strtok_r(in, "\n", &saveLinePointer);
-    while (line != NULL) {
-        celix_status_t status = celix_properties_parseLine(line, props);
-        if (status != CELIX_SUCCESS) {
-            celix_err_pushf("Failed to parse line '%s'", line);
-            return NULL;
-        }
-        line = strtok_r(NULL, "\n", &saveLinePointer);
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    if (!props) {
+        celix_err_push("Failed to create properties");
+        return NULL;
     }
-    return celix_steal_ptr(props);
+    celix_status_t status = celix_properties_parseLines(props, input, strlen(input));
+    return status == CELIX_SUCCESS ? celix_steal_ptr(props) : NULL;
 }
 
 /**
@@ -627,6 +977,13 @@ celix_properties_t* celix_properties_copy(const celix_properties_t* properties)
         return copy;
     }
 
+    if (celix_properties_size(properties) > CELIX_PROPERTIES_SMALL_MAP_SIZE &&
+        celix_properties_convertToHashMap(copy) != CELIX_SUCCESS) {
+        celix_err_push("Failed to create properties copy");
+        celix_properties_destroy(copy);
+        return NULL;
+    }
+
     CELIX_PROPERTIES_ITERATE(properties, iter) {
         celix_status_t status;
         if (iter.entry.valueType == CELIX_PROPERTIES_VALUE_TYPE_STRING) {
@@ -650,13 +1007,39 @@ celix_properties_t* celix_properties_copy(const celix_properties_t* properties)
     return copy;
 }
 
+void celix_properties_freeze(celix_properties_t* properties) {
+    if (properties) {
+        properties->frozen = true;
+    }
+}
+
+bool celix_properties_isFrozen(const celix_properties_t* properties) {
+    return properties != NULL && properties->frozen;
+}
+
+celix_properties_t* celix_properties_lazyCopy(const celix_properties_t* properties) {
+    if (!properties || !properties->frozen) {
+        return celix_properties_copy(properties);
+    }
+    celix_properties_t* copy = malloc(sizeof(*copy));
+    if (!copy) {
+        celix_err_push("Failed to create properties lazy copy");
+        return NULL;
+    }
+    celix_ref_get(&properties->data->ref);
+    copy->data = properties->data;
+    copy->embeddedData = NULL;
+    copy->frozen = false;
+    return copy;
+}
+
 celix_properties_value_type_e celix_properties_getType(const celix_properties_t* properties, const char* key) {
-    celix_properties_entry_t* entry = celix_stringHashMap_get(properties->map, key);
+    celix_properties_entry_t* entry = celix_properties_findEntry(properties->data, key);
     return entry == NULL ? CELIX_PROPERTIES_VALUE_TYPE_UNSET : entry->valueType;
 }
 
 const char* celix_properties_get(const celix_properties_t* properties, const char* key, const char* defaultValue) {
-    celix_properties_entry_t* entry = celix_properties_getEntry(properties, key);
+    const celix_properties_entry_t* entry = celix_properties_getEntry(properties, key);
     if (entry != NULL) {
         return entry->value;
     }
@@ -666,7 +1049,16 @@ const char* celix_properties_get(const celix_properties_t* properties, const cha
 celix_properties_entry_t* celix_properties_getEntry(const celix_properties_t* properties, const char* key) {
     celix_properties_entry_t* entry = NULL;
     if (properties) {
-        entry = celix_stringHashMap_get(properties->map, key);
+        entry = celix_properties_findEntry(properties->data, key);
+    }
+    return entry;
+}
+
+const celix_properties_entry_t* celix_properties_getEntryForInternedKey(const celix_properties_t* properties,
+                                                                        const char* internedKey) {
+    celix_properties_entry_t* entry = NULL;
+    if (properties && internedKey) {
+        entry = celix_properties_findEntryWithHash(properties->data, internedKey, celix_stringIntern_hash(internedKey));
     }
     return entry;
 }
@@ -686,6 +1078,13 @@ celix_status_t celix_properties_setWithoutCopy(celix_properties_t* properties, c
             free(value);
             return CELIX_ILLEGAL_ARGUMENT;
         }
+        celix_autoptr(celix_properties_data_t) sharedData = NULL;
+        celix_status_t status = celix_properties_prepareWrite(properties, &sharedData);
+        if (status != CELIX_SUCCESS) {
+            free(key);
+            free(value);
+            return status;
+        }
         celix_properties_entry_t* entry = celix_properties_createEntryWithNoCopy(properties, value);
         if (!entry) {
             celix_err_push("Failed to create entry for property.");
@@ -694,12 +1093,19 @@ celix_status_t celix_properties_setWithoutCopy(celix_properties_t* properties, c
             return CELIX_ENOMEM;
         }
 
-        bool alreadyExist = celix_stringHashMap_hasKey(properties->map, key);
-        celix_status_t status = celix_stringHashMap_put(properties->map, key, entry);
+        bool alreadyExist = celix_properties_findEntry(properties->data, key) != NULL;
+        if (!alreadyExist && celix_properties_isSmallMapFull(properties->data)) {
+            status = celix_properties_convertToHashMap(properties);
+        }
+        if (status == CELIX_SUCCESS && properties->data->map == NULL) {
+            celix_properties_putSmallMapEntry(properties->data, key, entry);
+        } else if (status == CELIX_SUCCESS) {
+            status = celix_stringHashMap_put(properties->data->map, key, entry);
+        }
         if (status != CELIX_SUCCESS) {
             celix_err_pushf("Failed to put entry for key %s in map.", key);
             free(key);
-            celix_properties_destroyEntry(properties, entry);
+            celix_properties_destroyEntry(properties->data, entry);
         } else if (alreadyExist) {
             free(key);
         }
@@ -748,13 +1154,22 @@ static bool celix_properties_entryEquals(const celix_properties_entry_t* entry1,
 }
 
 void celix_properties_unset(celix_properties_t* properties, const char* key) {
-    if (properties != NULL) {
-        celix_stringHashMap_remove(properties->map, key);
+    if (properties != NULL && celix_properties_findEntry(properties->data, key) != NULL) {
+        // the key can point into the shared data, so keep the shared data until the entry is removed.
+        celix_autoptr(celix_properties_data_t) sharedData = NULL;
+        if (celix_properties_prepareWrite(properties, &sharedData) != CELIX_SUCCESS) {
+            return;
+        }
+        if (properties->data->map != NULL) {
+            celix_stringHashMap_remove(properties->data->map, key);
+        } else {
+            celix_properties_removeSmallMapEntry(properties->data, key);
+        }
     }
 }
 
 long celix_properties_getAsLong(const celix_properties_t* props, const char* key, long defaultValue) {
-    celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
+    const celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
     if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_LONG) {
         return entry->typed.longValue;
     } else if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_DOUBLE) {
@@ -773,7 +1188,7 @@ celix_status_t celix_properties_setLong(celix_properties_t* props, const char* k
 }
 
 double celix_properties_getAsDouble(const celix_properties_t* props, const char* key, double defaultValue) {
-    celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
+    const celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
     if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_DOUBLE) {
         return entry->typed.doubleValue;
     } else if (entry != NULL) {
@@ -790,7 +1205,7 @@ celix_status_t celix_properties_setDouble(celix_properties_t* props, const char*
 }
 
 bool celix_properties_getAsBool(const celix_properties_t* props, const char* key, bool defaultValue) {
-    celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
+    const celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
     if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_BOOL) {
         return entry->typed.boolValue;
     } else if (entry != NULL) {
@@ -809,7 +1224,7 @@ celix_status_t celix_properties_setBool(celix_properties_t* props, const char* k
 const celix_version_t* celix_properties_getVersion(const celix_properties_t* properties,
                                                    const char* key,
                                                    const celix_version_t* defaultValue) {
-    celix_properties_entry_t* entry = celix_properties_getEntry(properties, key);
+    const celix_properties_entry_t* entry = celix_properties_getEntry(properties, key);
     if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
         return entry->typed.versionValue;
     }
@@ -819,7 +1234,7 @@ const celix_version_t* celix_properties_getVersion(const celix_properties_t* pro
 celix_version_t* celix_properties_getAsVersion(const celix_properties_t* properties,
                                                const char* key,
                                                const celix_version_t* defaultValue) {
-    celix_properties_entry_t* entry = celix_properties_getEntry(properties, key);
+    const celix_properties_entry_t* entry = celix_properties_getEntry(properties, key);
     if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
         return celix_version_copy(entry->typed.versionValue);
     }
@@ -854,7 +1269,10 @@ celix_status_t celix_properties_setVersionWithoutCopy(celix_properties_t* props,
 }
 
 size_t celix_properties_size(const celix_properties_t* properties) {
-    return celix_stringHashMap_size(properties->map);
+    if (properties->data->map != NULL) {
+        return celix_stringHashMap_size(properties->data->map);
+    }
+    return (size_t)properties->data->smallSize;
 }
 
 bool celix_properties_equals(const celix_properties_t* props1, const celix_properties_t* props2) {
@@ -871,7 +1289,7 @@ bool celix_properties_equals(const celix_properties_t* props1, const celix_prope
         return false;
     }
     CELIX_PROPERTIES_ITERATE(props1, iter) {
-        celix_properties_entry_t* entry2 = celix_properties_getEntry(props2, iter.key);
+        const celix_properties_entry_t* entry2 = celix_properties_getEntry(props2, iter.key);
         if (entry2 == NULL || !celix_properties_entryEquals(&iter.entry, entry2)) {
             return false;
         }
@@ -880,26 +1298,42 @@ bool celix_properties_equals(const celix_properties_t* props1, const celix_prope
 }
 
 typedef struct {
-    celix_string_hash_map_iterator_t mapIter;
+    celix_string_hash_map_iterator_t mapIter; // used if the properties uses a hash map
+    int smallMapIndex; // used if the properties uses the small map
     const celix_properties_t* props;
 } celix_properties_iterator_internal_t;
 
+/**
+ * Update the key and entry of the iterator to the current position of the internal iterator.
+ */
+static void celix_properties_updateIterator(celix_properties_iterator_t* iter,
+                                            const celix_properties_iterator_internal_t* internalIter) {
+    const celix_properties_data_t* data = internalIter->props->data;
+    if (data->map != NULL && !celix_stringHashMapIterator_isEnd(&internalIter->mapIter)) {
+        iter->key = internalIter->mapIter.key;
+        memcpy(&iter->entry, internalIter->mapIter.value.ptrValue, sizeof(iter->entry));
+    } else if (data->map == NULL && internalIter->smallMapIndex < data->smallSize) {
+        iter->key = data->smallKeys[internalIter->smallMapIndex];
+        memcpy(&iter->entry, data->smallEntries[internalIter->smallMapIndex], sizeof(iter->entry));
+    } else {
+        iter->key = NULL;
+        memset(&iter->entry, 0, sizeof(iter->entry));
+    }
+}
+
 celix_properties_iterator_t celix_properties_begin(const celix_properties_t* properties) {
     celix_properties_iterator_t iter;
     celix_properties_iterator_internal_t internalIter;
 
     CELIX_BUILD_ASSERT(sizeof(celix_properties_iterator_internal_t) <= sizeof(iter._data));
 
-    internalIter.mapIter = celix_stringHashMap_begin(properties->map);
-    internalIter.props = properties;
-
-    if (celix_stringHashMapIterator_isEnd(&internalIter.mapIter)) {
-        iter.key = NULL;
-        memset(&iter.entry, 0, sizeof(iter.entry));
-    } else {
-        iter.key = internalIter.mapIter.key;
-        memcpy(&iter.entry, internalIter.mapIter.value.ptrValue, sizeof(iter.entry));
+    memset(&internalIter, 0, sizeof(internalIter));
+    if (properties->data->map != NULL) {
+        internalIter.mapIter = celix_stringHashMap_begin(properties->data->map);
     }
+    internalIter.smallMapIndex = 0;
+    internalIter.props = properties;
+    celix_properties_updateIterator(&iter, &internalIter);
 
     memset(&iter._data, 0, sizeof(iter._data));
     memcpy(iter._data, &internalIter, sizeof(internalIter));
@@ -908,7 +1342,11 @@ celix_properties_iterator_t celix_properties_begin(const celix_properties_t* pro
 
 celix_properties_iterator_t celix_properties_end(const celix_properties_t* properties) {
     celix_properties_iterator_internal_t internalIter;
-    internalIter.mapIter = celix_stringHashMap_end(properties->map);
+    memset(&internalIter, 0, sizeof(internalIter));
+    if (properties->data->map != NULL) {
+        internalIter.mapIter = celix_stringHashMap_end(properties->data->map);
+    }
+    internalIter.smallMapIndex = properties->data->smallSize;
     internalIter.props = properties;
 
     celix_properties_iterator_t iter;
@@ -920,21 +1358,22 @@ celix_properties_iterator_t celix_properties_end(const celix_properties_t* prope
 void celix_propertiesIterator_next(celix_properties_iterator_t* iter) {
     celix_properties_iterator_internal_t internalIter;
     memcpy(&internalIter, iter->_data, sizeof(internalIter));
-    celix_stringHashMapIterator_next(&internalIter.mapIter);
-    memcpy(iter->_data, &internalIter, sizeof(internalIter));
-    if (celix_stringHashMapIterator_isEnd(&internalIter.mapIter)) {
-        iter->key = NULL;
-        memset(&iter->entry, 0, sizeof(iter->entry));
+    if (internalIter.props->data->map != NULL) {
+        celix_stringHashMapIterator_next(&internalIter.mapIter);
     } else {
-        iter->key = internalIter.mapIter.key;
-        memcpy(&iter->entry, internalIter.mapIter.value.ptrValue, sizeof(iter->entry));
+        internalIter.smallMapIndex += 1;
     }
+    memcpy(iter->_data, &internalIter, sizeof(internalIter));
+    celix_properties_updateIterator(iter, &internalIter);
 }
 
 bool celix_propertiesIterator_isEnd(const celix_properties_iterator_t* iter) {
     celix_properties_iterator_internal_t internalIter;
     memcpy(&internalIter, iter->_data, sizeof(internalIter));
-    return celix_stringHashMapIterator_isEnd(&internalIter.mapIter);
+    if (internalIter.props->data->map != NULL) {
+        return celix_stringHashMapIterator_isEnd(&internalIter.mapIter);
+    }
+    return internalIter.smallMapIndex >= internalIter.props->data->smallSize;
 }
 
 bool celix_propertiesIterator_equals(const celix_properties_iterator_t* a, const celix_properties_iterator_t* b) {
@@ -942,7 +1381,13 @@ bool celix_propertiesIterator_equals(const celix_properties_iterator_t* a, const
     memcpy(&internalIterA, a->_data, sizeof(internalIterA));
     celix_properties_iterator_internal_t internalIterB;
     memcpy(&internalIterB, b->_data, sizeof(internalIterB));
-    return celix_stringHashMapIterator_equals(&internalIterA.mapIter, &internalIterB.mapIter);
+    if (internalIterA.props != internalIterB.props) {
+        return false;
+    }
+    if (internalIterA.props->data->map != NULL) {
+        return celix_stringHashMapIterator_equals(&internalIterA.mapIter, &internalIterB.mapIter);
+    }
+    return internalIterA.smallMapIndex == internalIterB.smallMapIndex;
 }
 
 celix_properties_statistics_t celix_properties_getStatistics(const celix_properties_t* properties) {
@@ -955,8 +1400,13 @@ celix_properties_statistics_t celix_properties_getStatistics(const celix_propert
     celix_properties_statistics_t stats;
     stats.sizeOfKeysAndStringValues = sizeOfKeysAndStringValues;
     stats.averageSizeOfKeysAndStringValues = (double)sizeOfKeysAndStringValues / (double)celix_properties_size(properties) * 2;
-    stats.fillStringOptimizationBufferPercentage = (double)properties->currentStringBufferIndex / CELIX_PROPERTIES_OPTIMIZATION_STRING_BUFFER_SIZE;
-    stats.fillEntriesOptimizationBufferPercentage = (double)properties->currentEntriesBufferIndex / CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE;
-    stats.mapStatistics = celix_stringHashMap_getStatistics(properties->map);
+    stats.fillStringOptimizationBufferPercentage = (double)properties->data->currentStringBufferIndex / CELIX_PROPERTIES_OPTIMIZATION_STRING_BUFFER_SIZE;
+    stats.fillEntriesOptimizationBufferPercentage = (double)properties->data->currentEntriesBufferIndex / CELIX_PROPERTIES_OPTIMIZATION_ENTRIES_BUFFER_SIZE;
+    if (properties->data->map != NULL) {
+        stats.mapStatistics = celix_stringHashMap_getStatistics(properties->data->map);
+    } else {
+        memset(&stats.mapStatistics, 0, sizeof(stats.mapStatistics));
+        stats.mapStatistics.nrOfEntries = (size_t)properties->data->smallSize;
+    }
     return stats;
 }